@@ -0,0 +1,1301 @@
+﻿#ifdef _MSC_VER
+#define _SCL_SECURE_NO_WARNINGS
+#endif
+
+// mystl_bench：与 std 对照的基准测试
+// 名字的格式为 组/实现[/分布]/规模，例如 sort/mystl/random/1000000
+// 用法见 bench.h 中的 print_usage，例如 mystl_bench --filter=sort --format=json
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/numeric.h"
+#include "../MyTinySTL/order_statistic.h"
+#include "../MyTinySTL/persistent_map.h"
+#include "../MyTinySTL/persistent_vector.h"
+#include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/set.h"
+#include "../MyTinySTL/snapshot.h"
+#if MYSTL_HAS_CONSTEXPR14
+#include "../MyTinySTL/static_map.h"
+#endif
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "bench.h"
+
+namespace mystl
+{
+namespace bench
+{
+
+// 节点布局对照用的键：compact_int 使用颜色保存在父节点指针中的红黑树节点，
+// plain_string 的哈希表节点不保存哈希值，其它与 mystl::string 相同
+struct compact_int
+{
+  int v;
+  compact_int(int x = 0) :v(x) {}
+  bool operator<(const compact_int& rhs) const { return v < rhs.v; }
+};
+
+struct plain_string
+{
+  mystl::string s;
+  bool operator==(const plain_string& rhs) const { return s == rhs.s; }
+};
+
+struct plain_string_hash
+{
+  size_t operator()(const plain_string& x) const { return mystl::hash<mystl::string>()(x.s); }
+};
+
+} // namespace bench
+
+template <>
+struct rb_tree_compact_node<bench::compact_int> :public m_true_type {};
+
+template <>
+struct ht_cache_hash<bench::plain_string> :public m_false_type {};
+
+namespace bench
+{
+
+// 算法的实现
+struct std_algo
+{
+  static void sort(int* first, int* last)        { std::sort(first, last); }
+  static void stable_sort(int* first, int* last) { std::stable_sort(first, last); }
+  static bool binary_search(const int* first, const int* last, int value)
+  { return std::binary_search(first, last, value); }
+  static const int** lower_bound_many(const int* first, const int* last,
+                                      const int* keys_first, const int* keys_last,
+                                      const int** result)
+  {
+    for (; keys_first != keys_last; ++keys_first, ++result)
+      *result = std::lower_bound(first, last, *keys_first);
+    return result;
+  }
+  template <class T>
+  static T* set_intersection(const T* first1, const T* last1,
+                             const T* first2, const T* last2, T* result)
+  { return std::set_intersection(first1, last1, first2, last2, result); }
+  template <class T>
+  static T* set_intersection_unique(const T* first1, const T* last1,
+                                    const T* first2, const T* last2, T* result)
+  { return std::set_intersection(first1, last1, first2, last2, result); }
+  template <class T>
+  static const T* find(const T* first, const T* last, T value)
+  { return std::find(first, last, value); }
+  template <class T>
+  static size_t count(const T* first, const T* last, T value)
+  { return static_cast<size_t>(std::count(first, last, value)); }
+  template <class T>
+  static bool equal(const T* first1, const T* last1, const T* first2)
+  { return std::equal(first1, last1, first2); }
+  template <class T>
+  static const T* mismatch(const T* first1, const T* last1, const T* first2)
+  { return std::mismatch(first1, last1, first2).first; }
+  template <class T>
+  static T accumulate(const T* first, const T* last, T init)
+  { return std::accumulate(first, last, init); }
+  template <class T>
+  static T reduce(const T* first, const T* last, T init)
+  { return std::accumulate(first, last, init); }
+  template <class T>
+  static T inner_product(const T* first1, const T* last1, const T* first2, T init)
+  { return std::inner_product(first1, last1, first2, init); }
+  template <class T>
+  static T* partial_sum(const T* first, const T* last, T* result)
+  { return std::partial_sum(first, last, result); }
+  template <class T>
+  static T* adjacent_difference(const T* first, const T* last, T* result)
+  { return std::adjacent_difference(first, last, result); }
+  // deque 上的算法
+  typedef std::deque<int> deque_type;
+  template <class InputIter, class OutputIter>
+  static OutputIter copy(InputIter first, InputIter last, OutputIter result)
+  { return std::copy(first, last, result); }
+  template <class Iter>
+  static void fill(Iter first, Iter last, int value)
+  { std::fill(first, last, value); }
+  template <class Iter>
+  static Iter find_in(Iter first, Iter last, int value)
+  { return std::find(first, last, value); }
+};
+
+struct mystl_algo
+{
+  static void sort(int* first, int* last)        { mystl::sort(first, last); }
+  static void stable_sort(int* first, int* last) { mystl::stable_sort(first, last); }
+  static bool binary_search(const int* first, const int* last, int value)
+  { return mystl::binary_search(first, last, value); }
+  static const int** lower_bound_many(const int* first, const int* last,
+                                      const int* keys_first, const int* keys_last,
+                                      const int** result)
+  { return mystl::lower_bound_many(first, last, keys_first, keys_last, result); }
+  template <class T>
+  static T* set_intersection(const T* first1, const T* last1,
+                             const T* first2, const T* last2, T* result)
+  { return mystl::set_intersection(first1, last1, first2, last2, result); }
+  template <class T>
+  static T* set_intersection_unique(const T* first1, const T* last1,
+                                    const T* first2, const T* last2, T* result)
+  { return mystl::set_intersection_unique(first1, last1, first2, last2, result); }
+  template <class T>
+  static const T* find(const T* first, const T* last, T value)
+  { return mystl::find(first, last, value); }
+  template <class T>
+  static size_t count(const T* first, const T* last, T value)
+  { return mystl::count(first, last, value); }
+  template <class T>
+  static bool equal(const T* first1, const T* last1, const T* first2)
+  { return mystl::equal(first1, last1, first2); }
+  template <class T>
+  static const T* mismatch(const T* first1, const T* last1, const T* first2)
+  { return mystl::mismatch(first1, last1, first2).first; }
+  template <class T>
+  static T accumulate(const T* first, const T* last, T init)
+  { return mystl::accumulate(first, last, init); }
+  template <class T>
+  static T reduce(const T* first, const T* last, T init)
+  { return mystl::reduce(first, last, init); }
+  template <class T>
+  static T inner_product(const T* first1, const T* last1, const T* first2, T init)
+  { return mystl::transform_reduce(first1, last1, first2, init); }
+  template <class T>
+  static T* partial_sum(const T* first, const T* last, T* result)
+  { return mystl::inclusive_scan(first, last, result); }
+  template <class T>
+  static T* adjacent_difference(const T* first, const T* last, T* result)
+  { return mystl::adjacent_difference(first, last, result); }
+  typedef mystl::deque<int> deque_type;
+  template <class InputIter, class OutputIter>
+  static OutputIter copy(InputIter first, InputIter last, OutputIter result)
+  { return mystl::copy(first, last, result); }
+  template <class Iter>
+  static void fill(Iter first, Iter last, int value)
+  { mystl::fill(first, last, value); }
+  template <class Iter>
+  static Iter find_in(Iter first, Iter last, int value)
+  { return mystl::find(first, last, value); }
+};
+
+/*****************************************************************************************/
+// 算法
+
+// 每次迭代对同一份输入的副本排序，复制不计时
+template <class Algo>
+void bm_sort(state& st)
+{
+  const auto input = make_input(st.dist(), st.range(), st.seed());
+  std::vector<int> work(input.size());
+  while (st.keep_running())
+  {
+    st.pause_timing();
+    std::copy(input.begin(), input.end(), work.begin());
+    st.resume_timing();
+    Algo::sort(work.data(), work.data() + work.size());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * st.range()));
+}
+
+template <class Algo>
+void bm_stable_sort(state& st)
+{
+  const auto input = make_input(st.dist(), st.range(), st.seed());
+  std::vector<int> work(input.size());
+  while (st.keep_running())
+  {
+    st.pause_timing();
+    std::copy(input.begin(), input.end(), work.begin());
+    st.resume_timing();
+    Algo::stable_sort(work.data(), work.data() + work.size());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * st.range()));
+}
+
+// 每次迭代在有序区间中查找 range 个随机值，一半命中
+template <class Algo>
+void bm_binary_search(state& st)
+{
+  const size_t n = st.range();
+  std::vector<int> sorted(n);
+  for (size_t i = 0; i < n; ++i)
+    sorted[i] = static_cast<int>(i * 2);
+  const auto keys = make_input(distribution::random, n, st.seed());
+  const int* first = sorted.data();
+  const int* last = first + n;
+  while (st.keep_running())
+  {
+    size_t found = 0;
+    for (size_t i = 0; i < n; ++i)
+      found += Algo::binary_search(first, last, keys[i] % static_cast<int>(2 * n));
+    do_not_optimize(found);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 每次迭代在有序区间中批量查找至多 100000 个随机值
+template <class Algo>
+void bm_lower_bound_many(state& st)
+{
+  const size_t n = st.range();
+  std::vector<int> sorted(n);
+  for (size_t i = 0; i < n; ++i)
+    sorted[i] = static_cast<int>(i * 2);
+  auto keys = make_input(distribution::random, n < 100000 ? n : 100000, st.seed());
+  for (auto& k : keys)
+    k %= static_cast<int>(2 * n);
+  std::vector<const int*> result(keys.size());
+  while (st.keep_running())
+  {
+    Algo::lower_bound_many(sorted.data(), sorted.data() + n,
+                           keys.data(), keys.data() + keys.size(), result.data());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * keys.size()));
+}
+
+// range 个元素与 100 个元素的有序区间求交集，长度相差悬殊
+template <class Algo>
+void bm_set_intersection_skewed(state& st)
+{
+  const size_t n = st.range();
+  std::vector<uint32_t> large(n), small(100), out(100);
+  for (size_t i = 0; i < n; ++i)
+    large[i] = static_cast<uint32_t>(i * 2);
+  for (size_t i = 0; i < small.size(); ++i)
+    small[i] = static_cast<uint32_t>(i * (2 * n / small.size()) + (i & 1));
+  while (st.keep_running())
+  {
+    auto r = Algo::set_intersection(small.data(), small.data() + small.size(),
+                                    large.data(), large.data() + n, out.data());
+    do_not_optimize(r);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * (n + small.size())));
+}
+
+// 两个长度相同的严格递增区间求交集，相邻元素的间隔随机取 1 到 4
+template <class Algo>
+void bm_set_intersection_unique(state& st)
+{
+  const size_t n = st.range();
+  const auto gaps = make_input(distribution::random, 2 * n, st.seed());
+  std::vector<uint32_t> a(n), b(n), out(n);
+  uint32_t x = 0, y = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    a[i] = x += static_cast<uint32_t>(gaps[i] & 3) + 1;
+    b[i] = y += static_cast<uint32_t>(gaps[n + i] & 3) + 1;
+  }
+  while (st.keep_running())
+  {
+    auto r = Algo::set_intersection_unique(a.data(), a.data() + n, b.data(), b.data() + n,
+                                           out.data());
+    do_not_optimize(r);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * 2 * n));
+}
+
+// 查找不存在的值，扫描整个区间
+template <class Algo, class T>
+void bm_find(state& st)
+{
+  const size_t n = st.range();
+  std::vector<T> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = static_cast<T>(i % 100 + 1);
+  while (st.keep_running())
+    do_not_optimize(Algo::find(v.data(), v.data() + n, T(0)));
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// deque 与数组之间来回复制
+template <class Algo>
+void bm_deque_copy(state& st)
+{
+  const size_t n = st.range();
+  typename Algo::deque_type d(n, 1);
+  std::vector<int> v(n, 2);
+  while (st.keep_running())
+  {
+    Algo::copy(v.data(), v.data() + n, d.begin());
+    Algo::copy(d.begin(), d.end(), v.data());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n * 2));
+}
+
+template <class Algo>
+void bm_deque_fill(state& st)
+{
+  const size_t n = st.range();
+  typename Algo::deque_type d(n, 1);
+  int value = 0;
+  while (st.keep_running())
+  {
+    Algo::fill(d.begin(), d.end(), ++value);
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 查找不存在的值，遍历整个 deque
+template <class Algo>
+void bm_deque_find(state& st)
+{
+  const size_t n = st.range();
+  typename Algo::deque_type d;
+  for (size_t i = 0; i < n; ++i)
+    d.push_back(static_cast<int>(i % 100 + 1));
+  while (st.keep_running())
+    do_not_optimize(Algo::find_in(d.begin(), d.end(), 0));
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+template <class Algo, class T>
+void bm_count(state& st)
+{
+  const size_t n = st.range();
+  std::vector<T> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = static_cast<T>(i % 100);
+  while (st.keep_running())
+    do_not_optimize(Algo::count(v.data(), v.data() + n, T(7)));
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 比较两个相同的区间，mismatch 在最后一个元素处失配
+template <class Algo, class T>
+void bm_equal(state& st)
+{
+  const size_t n = st.range();
+  std::vector<T> a(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<T>(i % 100);
+  const std::vector<T> b(a);
+  while (st.keep_running())
+    do_not_optimize(Algo::equal(a.data(), a.data() + n, b.data()));
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+template <class Algo, class T>
+void bm_mismatch(state& st)
+{
+  const size_t n = st.range();
+  std::vector<T> a(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<T>(i % 100);
+  std::vector<T> b(a);
+  b.back() = T(100);
+  while (st.keep_running())
+    do_not_optimize(Algo::mismatch(a.data(), a.data() + n, b.data()));
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+/*****************************************************************************************/
+// 数值算法
+// std 没有 C++11 的 reduce 等，以对应的顺序版本对照：reduce 对照 accumulate，
+// transform_reduce 对照 inner_product，inclusive_scan 对照 partial_sum
+
+template <class T>
+std::vector<T> make_numeric_input(size_t n, unsigned seed)
+{
+  const auto ints = make_input(distribution::random, n, seed);
+  std::vector<T> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = static_cast<T>(ints[i] % 1000);
+  return v;
+}
+
+template <class Algo, class T>
+void bm_accumulate(state& st)
+{
+  const auto v = make_numeric_input<T>(st.range(), st.seed());
+  while (st.keep_running())
+    do_not_optimize(Algo::accumulate(v.data(), v.data() + v.size(), T()));
+  st.set_items_processed(static_cast<double>(st.iterations() * v.size()));
+}
+
+template <class Algo, class T>
+void bm_reduce(state& st)
+{
+  const auto v = make_numeric_input<T>(st.range(), st.seed());
+  while (st.keep_running())
+    do_not_optimize(Algo::reduce(v.data(), v.data() + v.size(), T()));
+  st.set_items_processed(static_cast<double>(st.iterations() * v.size()));
+}
+
+template <class Algo, class T>
+void bm_inner_product(state& st)
+{
+  const auto a = make_numeric_input<T>(st.range(), st.seed());
+  const auto b = make_numeric_input<T>(st.range(), st.seed() + 1);
+  while (st.keep_running())
+    do_not_optimize(Algo::inner_product(a.data(), a.data() + a.size(), b.data(), T()));
+  st.set_items_processed(static_cast<double>(st.iterations() * a.size()));
+}
+
+template <class Algo, class T>
+void bm_partial_sum(state& st)
+{
+  const auto v = make_numeric_input<T>(st.range(), st.seed());
+  std::vector<T> out(v.size());
+  while (st.keep_running())
+  {
+    Algo::partial_sum(v.data(), v.data() + v.size(), out.data());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * v.size()));
+}
+
+template <class Algo, class T>
+void bm_adjacent_difference(state& st)
+{
+  const auto v = make_numeric_input<T>(st.range(), st.seed());
+  std::vector<T> out(v.size());
+  while (st.keep_running())
+  {
+    Algo::adjacent_difference(v.data(), v.data() + v.size(), out.data());
+    clobber_memory();
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * v.size()));
+}
+
+/*****************************************************************************************/
+// 容器
+
+template <class Vec>
+void bm_vector_push_back(state& st)
+{
+  const size_t n = st.range();
+  while (st.keep_running())
+  {
+    Vec v;
+    for (size_t i = 0; i < n; ++i)
+      v.push_back(static_cast<int>(i));
+    do_not_optimize(v.data());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+template <class List>
+void bm_list_push_back(state& st)
+{
+  const size_t n = st.range();
+  while (st.keep_running())
+  {
+    List l;
+    for (size_t i = 0; i < n; ++i)
+      l.push_back(static_cast<int>(i));
+    do_not_optimize(l.back());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 在 deque 的前三分之一处插入一段元素再删除，前部的元素随之整体搬动
+template <class Deque>
+void bm_deque_insert_range(state& st)
+{
+  const size_t n = st.range();
+  const size_t pos = n / 3;
+  typedef typename Deque::value_type value_type;
+  const std::vector<value_type> src(n / 8 + 1, value_type(16, 'x'));
+  Deque d(n, value_type(16, 'y'));
+  while (st.keep_running())
+  {
+    d.insert(d.begin() + pos, src.data(), src.data() + src.size());
+    d.erase(d.begin() + pos, d.begin() + pos + src.size());
+    do_not_optimize(d.front());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * (pos + src.size()) * 2));
+}
+
+template <class Deque>
+void bm_deque_push_front(state& st)
+{
+  const size_t n = st.range();
+  while (st.keep_running())
+  {
+    Deque d;
+    for (size_t i = 0; i < n; ++i)
+      d.push_front(static_cast<int>(i));
+    do_not_optimize(d.front());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 按分布生成的键插入 map
+template <class Map>
+void bm_map_insert(state& st)
+{
+  const auto keys = make_input(st.dist(), st.range(), st.seed());
+  while (st.keep_running())
+  {
+    Map m;
+    for (auto k : keys)
+      m.emplace(k, k);
+    do_not_optimize(m.size());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * keys.size()));
+}
+
+// 取第 k 小的键：普通的红黑树只能逐个前进，order statistic 树沿子树大小下降
+template <class Set>
+typename Set::const_iterator select_nth(const Set& s, size_t k)
+{
+  auto it = s.begin();
+  for (; k != 0; --k)
+    ++it;
+  return it;
+}
+
+template <class Key>
+typename mystl::order_statistic_multiset<Key>::const_iterator
+select_nth(const mystl::order_statistic_multiset<Key>& s, size_t k)
+{
+  return s.nth(k);
+}
+
+// 在 range 个随机键中按步长取 64 个第 k 小的键
+template <class Set>
+void bm_set_select(state& st)
+{
+  const auto keys = make_input(distribution::random, st.range(), st.seed());
+  const Set s(keys.data(), keys.data() + keys.size());
+  const size_t step = s.size() / 64 + 1;
+  while (st.keep_running())
+  {
+    long long sum = 0;
+    for (size_t k = 0; k < s.size(); k += step)
+      sum += *select_nth(s, k);
+    do_not_optimize(sum);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * ((s.size() + step - 1) / step)));
+}
+
+template <class Map>
+void bm_unordered_map_insert(state& st)
+{
+  const auto keys = make_input(st.dist(), st.range(), st.seed());
+  while (st.keep_running())
+  {
+    Map m;
+    for (auto k : keys)
+      m.emplace(k, k);
+    do_not_optimize(m.size());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * keys.size()));
+}
+
+// 由整数生成各种类型的键，字符串键有一段公共前缀，超出短字符串的长度
+template <class Key>
+struct key_maker
+{
+  static Key make(int k) { return Key(k); }
+};
+
+template <>
+struct key_maker<std::string>
+{
+  static std::string make(int k) { return "bench/node/layout/" + std::to_string(k); }
+};
+
+template <>
+struct key_maker<mystl::string>
+{
+  static mystl::string make(int k) { return key_maker<std::string>::make(k).c_str(); }
+};
+
+template <>
+struct key_maker<plain_string>
+{
+  static plain_string make(int k) { return plain_string{ key_maker<mystl::string>::make(k) }; }
+};
+
+// 记下 mystl 容器每个节点占用的字节数，std 的节点布局不公开，不记录
+template <class Map>
+void set_node_bytes(state&, const Map&)
+{
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void set_node_bytes(state& st, const mystl::map<Key, T, Compare, Alloc>&)
+{
+  st.set_counter("node_bytes",
+                 static_cast<double>(sizeof(mystl::rb_tree_node<mystl::pair<const Key, T>>)));
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void set_node_bytes(state& st, const mystl::unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>&)
+{
+  st.set_counter("node_bytes",
+                 static_cast<double>(sizeof(mystl::hashtable_node<mystl::pair<const Key, T>>)));
+}
+
+template <class Map>
+std::vector<typename Map::key_type> make_keys(const std::vector<int>& keys)
+{
+  std::vector<typename Map::key_type> result;
+  result.reserve(keys.size());
+  for (auto k : keys)
+    result.push_back(key_maker<typename Map::key_type>::make(k));
+  return result;
+}
+
+// 在 range 个随机键中查找同样多的键，一半命中，node_bytes 为每个节点占用的字节数
+template <class Map>
+void bm_map_find(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_keys<Map>(make_input(distribution::random, 2 * n, st.seed()));
+  Map m;
+  for (size_t i = 0; i < n; ++i)
+    m.emplace(keys[i], 0);
+  while (st.keep_running())
+  {
+    size_t found = 0;
+    for (size_t i = n / 2; i < n + n / 2; ++i)
+      found += m.find(keys[i]) != m.end();
+    do_not_optimize(found);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+  set_node_bytes(st, m);
+}
+
+// 从头到尾遍历 range 个随机键，红黑树每次上溯都要读取父节点
+template <class Map>
+void bm_map_iterate(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_keys<Map>(make_input(distribution::random, n, st.seed()));
+  Map m;
+  for (size_t i = 0; i < n; ++i)
+    m.emplace(keys[i], static_cast<int>(i));
+  while (st.keep_running())
+  {
+    long long sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it)
+      sum += it->second;
+    do_not_optimize(sum);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * m.size()));
+  set_node_bytes(st, m);
+}
+
+// 在 range 个随机键中查找同样多的键，一半命中
+template <class Map>
+void bm_unordered_map_find(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_keys<Map>(make_input(distribution::random, 2 * n, st.seed()));
+  Map m;
+  for (size_t i = 0; i < n; ++i)
+    m.emplace(keys[i], 0);
+  while (st.keep_running())
+  {
+    size_t found = 0;
+    for (size_t i = n / 2; i < n + n / 2; ++i)
+      found += m.find(keys[i]) != m.end();
+    do_not_optimize(found);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+  set_node_bytes(st, m);
+}
+
+// 快照使用的临时文件
+const char* const snapshot_path = "mystl_bench_snapshot.bin";
+
+// 写出 range 个随机键的 Map 快照，再从快照重新构造 Map，与逐个插入的 *_insert 对照
+template <class Map>
+void bm_snapshot_load(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_input(distribution::random, n, st.seed());
+  Map src;
+  for (size_t i = 0; i < n; ++i)
+    src.emplace(keys[i], static_cast<int>(i));
+  mystl::save_snapshot(snapshot_path, src);
+  while (st.keep_running())
+  {
+    Map m;
+    mystl::load_snapshot(snapshot_path, m);
+    do_not_optimize(m.size());
+  }
+  std::remove(snapshot_path);
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 打开 Map 的快照并查找一次，不做反序列化，只有被访问的页会读入
+template <class Map, class View>
+void bm_snapshot_open(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_input(distribution::random, n, st.seed());
+  Map src;
+  for (size_t i = 0; i < n; ++i)
+    src.emplace(keys[i], static_cast<int>(i));
+  mystl::save_snapshot(snapshot_path, src);
+  while (st.keep_running())
+  {
+    View view(snapshot_path);
+    do_not_optimize(view.find(keys[0]) != view.end());
+  }
+  std::remove(snapshot_path);
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// 在映射的快照上做与 unordered_map_find 相同的查找
+template <class Map, class View>
+void bm_snapshot_find(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_input(distribution::random, 2 * n, st.seed());
+  Map src;
+  for (size_t i = 0; i < n; ++i)
+    src.emplace(keys[i], 0);
+  mystl::save_snapshot(snapshot_path, src);
+  View view(snapshot_path);
+  while (st.keep_running())
+  {
+    size_t found = 0;
+    for (size_t i = n / 2; i < n + n / 2; ++i)
+      found += view.find(keys[i]) != view.end();
+    do_not_optimize(found);
+  }
+  std::remove(snapshot_path);
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+// range 个键在两种桶数之间来回 rehash，节点不保存哈希值时每次都要重新计算
+template <class Map>
+void bm_unordered_map_rehash(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_keys<Map>(make_input(distribution::random, n, st.seed()));
+  Map m;
+  for (size_t i = 0; i < n; ++i)
+    m.emplace(keys[i], 0);
+  bool grow = true;
+  while (st.keep_running())
+  {
+    m.rehash(grow ? 4 * n : 2 * n);
+    grow = !grow;
+    do_not_optimize(m.bucket_count());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+  set_node_bytes(st, m);
+}
+
+// 逐个追加长度为 1~16 的片段
+template <class Str>
+void bm_string_append(state& st)
+{
+  const size_t n = st.range();
+  const char piece[] = "0123456789abcdef";
+  while (st.keep_running())
+  {
+    Str s;
+    for (size_t i = 0; i < n; ++i)
+      s.append(piece, i % 16 + 1);
+    do_not_optimize(s.data());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+#if MYSTL_HAS_CONSTEXPR14
+/*****************************************************************************************/
+// 编译期的查找表
+// HTTP 头部名称到编号的表：static_map / static_sorted_map 在编译期构建，
+// unordered_map 在运行期由同一张表构建，查询约四分之三命中
+
+constexpr mystl::pair<mystl::string_view, int> header_items[] = {
+  { "Accept", 0 }, { "Accept-Charset", 1 }, { "Accept-Encoding", 2 }, { "Accept-Language", 3 },
+  { "Authorization", 4 }, { "Cache-Control", 5 }, { "Connection", 6 }, { "Content-Encoding", 7 },
+  { "Content-Length", 8 }, { "Content-Type", 9 }, { "Cookie", 10 }, { "Date", 11 },
+  { "ETag", 12 }, { "Expect", 13 }, { "Expires", 14 }, { "Forwarded", 15 },
+  { "Host", 16 }, { "If-Match", 17 }, { "If-Modified-Since", 18 }, { "If-None-Match", 19 },
+  { "If-Range", 20 }, { "Last-Modified", 21 }, { "Location", 22 }, { "Origin", 23 },
+  { "Pragma", 24 }, { "Range", 25 }, { "Referer", 26 }, { "Server", 27 },
+  { "Set-Cookie", 28 }, { "Transfer-Encoding", 29 }, { "Upgrade", 30 }, { "User-Agent", 31 } };
+
+typedef mystl::static_map<mystl::string_view, int, 32>        header_static_map;
+typedef mystl::static_sorted_map<mystl::string_view, int, 32> header_sorted_map;
+
+constexpr header_static_map header_table(header_items);
+constexpr header_sorted_map header_sorted(header_items);
+
+// 运行期构建的表与查询用的键
+template <class Map>
+struct header_lookup
+{
+  typedef typename Map::key_type key_type;
+  Map map;
+  header_lookup()
+  {
+    for (auto& e : header_items)
+      map.emplace(key_type(e.first.data(), e.first.size()), e.second);
+  }
+  static key_type key(mystl::string_view s) { return key_type(s.data(), s.size()); }
+};
+
+template <>
+struct header_lookup<header_static_map>
+{
+  typedef mystl::string_view key_type;
+  const header_static_map& map = header_table;
+  static key_type key(mystl::string_view s) { return s; }
+};
+
+template <>
+struct header_lookup<header_sorted_map>
+{
+  typedef mystl::string_view key_type;
+  const header_sorted_map& map = header_sorted;
+  static key_type key(mystl::string_view s) { return s; }
+};
+
+// 在头部名称表中查找 range 次
+template <class Map>
+void bm_header_find(state& st)
+{
+  const size_t n = st.range();
+  static const char* const misses[] = { "X-Request-Id", "Accept-Ranges", "Content", "Via",
+                                        "Keep-Alive", "Hostname", "Vary", "Age",
+                                        "DNT", "TE", "Set-Cookie2" };
+  header_lookup<Map> table;
+  const auto in = make_input(distribution::random, n, st.seed());
+  std::vector<typename header_lookup<Map>::key_type> queries;
+  queries.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t k = static_cast<size_t>(in[i]) % (32 + 11);
+    queries.push_back(header_lookup<Map>::key(k < 32
+      ? header_items[k].first : mystl::string_view(misses[k - 32])));
+  }
+  while (st.keep_running())
+  {
+    int sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      auto it = table.map.find(queries[i]);
+      sum += it != table.map.end() ? it->second : -1;
+    }
+    do_not_optimize(sum);
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+#endif // MYSTL_HAS_CONSTEXPR14
+
+/*****************************************************************************************/
+// 快照与更新交替
+// 每次先为读者保留一份当前版本，再修改一个元素：map / vector 需要深复制，
+// persistent_* 的复制只增加引用计数，修改只复制一条路径
+
+inline void snapshot_assign(mystl::map<int, int>& m, int key, int value) { m[key] = value; }
+inline void snapshot_assign(mystl::persistent_map<int, int>& m, int key, int value)
+{ m.insert_or_assign(key, value); }
+inline void snapshot_assign(mystl::vector<int>& v, int index, int value) { v[index] = value; }
+inline void snapshot_assign(mystl::persistent_vector<int>& v, int index, int value)
+{ v.set(index, value); }
+
+template <class Map>
+void bm_snapshot_update_map(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_input(distribution::random, n, st.seed());
+  Map cur;
+  for (size_t i = 0; i < n; ++i)
+    snapshot_assign(cur, keys[i], static_cast<int>(i));
+  size_t i = 0;
+  while (st.keep_running())
+  {
+    Map snapshot(cur);
+    snapshot_assign(cur, keys[i], static_cast<int>(i));
+    do_not_optimize(snapshot.size());
+    i = i + 1 == n ? 0 : i + 1;
+  }
+  st.set_items_processed(static_cast<double>(st.iterations()));
+}
+
+template <class Vector>
+void bm_snapshot_update_vector(state& st)
+{
+  const size_t n = st.range();
+  const auto in = make_input(distribution::random, n, st.seed());
+  Vector cur;
+  for (size_t i = 0; i < n; ++i)
+    cur.push_back(in[i]);
+  size_t i = 0;
+  while (st.keep_running())
+  {
+    Vector snapshot(cur);
+    snapshot_assign(cur, static_cast<int>(static_cast<size_t>(in[i]) % n), static_cast<int>(i));
+    do_not_optimize(snapshot.size());
+    i = i + 1 == n ? 0 : i + 1;
+  }
+  st.set_items_processed(static_cast<double>(st.iterations()));
+}
+
+// 只有一个版本时逐个插入，路径上的节点都可以就地修改
+template <class Map>
+void bm_persistent_insert(state& st)
+{
+  const size_t n = st.range();
+  const auto keys = make_input(distribution::random, n, st.seed());
+  while (st.keep_running())
+  {
+    Map m;
+    for (size_t i = 0; i < n; ++i)
+      snapshot_assign(m, keys[i], static_cast<int>(i));
+    do_not_optimize(m.size());
+  }
+  st.set_items_processed(static_cast<double>(st.iterations() * n));
+}
+
+/*****************************************************************************************/
+// 复制与移动的审计
+// counted<Payload> 统计复制与移动的次数，结果以每次操作的 copies / moves 计数给出，
+// 以右值或 emplace 插入时 copies 应为 0
+
+template <class Payload>
+struct counted
+{
+  static size_t copies;
+  static size_t moves;
+
+  int     key;
+  Payload payload;
+
+  counted(int k, Payload p) :key(k), payload(mystl::move(p)) {}
+  counted(const counted& rhs) :key(rhs.key), payload(rhs.payload) { ++copies; }
+  counted(counted&& rhs) noexcept :key(rhs.key), payload(mystl::move(rhs.payload)) { ++moves; }
+  counted& operator=(const counted& rhs)
+  {
+    key = rhs.key;
+    payload = rhs.payload;
+    ++copies;
+    return *this;
+  }
+  counted& operator=(counted&& rhs) noexcept
+  {
+    key = rhs.key;
+    payload = mystl::move(rhs.payload);
+    ++moves;
+    return *this;
+  }
+
+  bool operator<(const counted& rhs) const { return key < rhs.key; }
+
+  static void reset() { copies = moves = 0; }
+};
+
+template <class Payload> size_t counted<Payload>::copies = 0;
+template <class Payload> size_t counted<Payload>::moves = 0;
+
+inline void make_payload(mystl::string& p) { p = mystl::string(64, 'x'); }
+inline void make_payload(mystl::vector<int>& p) { p.assign(16, 1); }
+
+template <class Payload>
+Payload payload_of()
+{
+  Payload p;
+  make_payload(p);
+  return p;
+}
+
+// 以 ops 次操作的计数设置 copies / moves
+template <class Payload>
+void set_move_counters(state& st, size_t ops)
+{
+  const double n = static_cast<double>(ops);
+  st.set_counter("copies", static_cast<double>(counted<Payload>::copies) / n);
+  st.set_counter("moves", static_cast<double>(counted<Payload>::moves) / n);
+  st.set_items_processed(n);
+}
+
+// priority_queue 的 push 与 pop_value
+template <class Payload>
+void bm_move_audit_priority_queue(state& st)
+{
+  typedef counted<Payload> value_type;
+  const auto keys = make_input(distribution::random, st.range(), st.seed());
+  size_t ops = 0;
+  value_type::reset();
+  while (st.keep_running())
+  {
+    mystl::priority_queue<value_type> q;
+    for (auto k : keys)
+      q.push(value_type(k, payload_of<Payload>()));
+    while (!q.empty())
+      do_not_optimize(q.pop_value().key);
+    ops += 2 * keys.size();
+  }
+  set_move_counters<Payload>(st, ops);
+}
+
+// map 类容器以 emplace(key, value) 插入，键值重复时再插入一次
+template <class Map, class Payload>
+void bm_move_audit_map(state& st)
+{
+  typedef counted<Payload> value_type;
+  const auto keys = make_input(distribution::few_unique, st.range(), st.seed());
+  size_t ops = 0;
+  value_type::reset();
+  while (st.keep_running())
+  {
+    Map m;
+    for (auto k : keys)
+      m.emplace(k, value_type(k, payload_of<Payload>()));
+    do_not_optimize(m.size());
+    ops += keys.size();
+  }
+  set_move_counters<Payload>(st, ops);
+}
+
+// deque 在中间插入右值
+template <class Payload>
+void bm_move_audit_deque_insert(state& st)
+{
+  typedef counted<Payload> value_type;
+  const size_t n = st.range();
+  size_t ops = 0;
+  value_type::reset();
+  while (st.keep_running())
+  {
+    mystl::deque<value_type> d;
+    for (size_t i = 0; i < n; ++i)
+      d.insert(d.begin() + d.size() / 2, value_type(static_cast<int>(i), payload_of<Payload>()));
+    do_not_optimize(d.size());
+    ops += n;
+  }
+  set_move_counters<Payload>(st, ops);
+}
+
+/*****************************************************************************************/
+
+void register_algorithm_benchmarks()
+{
+  add("sort/std", bm_sort<std_algo>)
+    .ranges({ 1000, 100000, 1000000 }).dists(all_distributions());
+  add("sort/mystl", bm_sort<mystl_algo>)
+    .ranges({ 1000, 100000, 1000000 }).dists(all_distributions());
+  add("stable_sort/std", bm_stable_sort<std_algo>)
+    .ranges({ 1000, 1000000 }).dists(all_distributions());
+  add("stable_sort/mystl", bm_stable_sort<mystl_algo>)
+    .ranges({ 1000, 1000000 }).dists(all_distributions());
+  add("binary_search/std", bm_binary_search<std_algo>)
+    .ranges({ 1000, 1000000 });
+  add("binary_search/mystl", bm_binary_search<mystl_algo>)
+    .ranges({ 1000, 1000000 });
+  add("lower_bound_many/std", bm_lower_bound_many<std_algo>)
+    .ranges({ 1000, 1000000, 16000000 });
+  add("lower_bound_many/mystl", bm_lower_bound_many<mystl_algo>)
+    .ranges({ 1000, 1000000, 16000000 });
+  add("set_intersection_skewed/std", bm_set_intersection_skewed<std_algo>)
+    .ranges({ 10000, 10000000 });
+  add("set_intersection_skewed/mystl", bm_set_intersection_skewed<mystl_algo>)
+    .ranges({ 10000, 10000000 });
+  add("set_intersection_unique/std", bm_set_intersection_unique<std_algo>)
+    .ranges({ 1000, 1000000 });
+  add("set_intersection_unique/mystl", bm_set_intersection_unique<mystl_algo>)
+    .ranges({ 1000, 1000000 });
+  add("find_int/std", bm_find<std_algo, int>).ranges({ 1000, 1000000 });
+  add("find_int/mystl", bm_find<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("find_short/std", bm_find<std_algo, short>).ranges({ 1000, 1000000 });
+  add("find_short/mystl", bm_find<mystl_algo, short>).ranges({ 1000, 1000000 });
+  add("count_int/std", bm_count<std_algo, int>).ranges({ 1000, 1000000 });
+  add("count_int/mystl", bm_count<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("equal_int/std", bm_equal<std_algo, int>).ranges({ 1000, 1000000 });
+  add("equal_int/mystl", bm_equal<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("mismatch_double/std", bm_mismatch<std_algo, double>).ranges({ 1000, 1000000 });
+  add("mismatch_double/mystl", bm_mismatch<mystl_algo, double>).ranges({ 1000, 1000000 });
+  add("deque_copy/std", bm_deque_copy<std_algo>).ranges({ 1000, 1000000 });
+  add("deque_copy/mystl", bm_deque_copy<mystl_algo>).ranges({ 1000, 1000000 });
+  add("deque_fill/std", bm_deque_fill<std_algo>).ranges({ 1000, 1000000 });
+  add("deque_fill/mystl", bm_deque_fill<mystl_algo>).ranges({ 1000, 1000000 });
+  add("deque_find/std", bm_deque_find<std_algo>).ranges({ 1000, 1000000 });
+  add("deque_find/mystl", bm_deque_find<mystl_algo>).ranges({ 1000, 1000000 });
+}
+
+void register_numeric_benchmarks()
+{
+  add("accumulate_int/std", bm_accumulate<std_algo, int>).ranges({ 1000, 1000000 });
+  add("accumulate_int/mystl", bm_accumulate<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("reduce_float/std", bm_reduce<std_algo, float>).ranges({ 1000, 1000000 });
+  add("reduce_float/mystl", bm_reduce<mystl_algo, float>).ranges({ 1000, 1000000 });
+  add("reduce_double/std", bm_reduce<std_algo, double>).ranges({ 1000, 1000000 });
+  add("reduce_double/mystl", bm_reduce<mystl_algo, double>).ranges({ 1000, 1000000 });
+  add("dot_int/std", bm_inner_product<std_algo, int>).ranges({ 1000, 1000000 });
+  add("dot_int/mystl", bm_inner_product<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("dot_float/std", bm_inner_product<std_algo, float>).ranges({ 1000, 1000000 });
+  add("dot_float/mystl", bm_inner_product<mystl_algo, float>).ranges({ 1000, 1000000 });
+  add("scan_int/std", bm_partial_sum<std_algo, int>).ranges({ 1000, 1000000 });
+  add("scan_int/mystl", bm_partial_sum<mystl_algo, int>).ranges({ 1000, 1000000 });
+  add("scan_float/std", bm_partial_sum<std_algo, float>).ranges({ 1000, 1000000 });
+  add("scan_float/mystl", bm_partial_sum<mystl_algo, float>).ranges({ 1000, 1000000 });
+  add("adjacent_difference_int/std", bm_adjacent_difference<std_algo, int>)
+    .ranges({ 1000, 1000000 });
+  add("adjacent_difference_int/mystl", bm_adjacent_difference<mystl_algo, int>)
+    .ranges({ 1000, 1000000 });
+}
+
+void register_container_benchmarks()
+{
+  add("vector_push_back/std", bm_vector_push_back<std::vector<int>>)
+    .ranges({ 1000, 1000000 });
+  add("vector_push_back/mystl", bm_vector_push_back<mystl::vector<int>>)
+    .ranges({ 1000, 1000000 });
+  add("list_push_back/std", bm_list_push_back<std::list<int>>)
+    .ranges({ 1000, 100000 });
+  add("list_push_back/mystl", bm_list_push_back<mystl::list<int>>)
+    .ranges({ 1000, 100000 });
+  add("deque_push_front/std", bm_deque_push_front<std::deque<int>>)
+    .ranges({ 1000, 1000000 });
+  add("deque_push_front/mystl", bm_deque_push_front<mystl::deque<int>>)
+    .ranges({ 1000, 1000000 });
+  add("deque_insert_range/std", bm_deque_insert_range<std::deque<std::string>>)
+    .ranges({ 1000, 100000 });
+  add("deque_insert_range/mystl", bm_deque_insert_range<mystl::deque<mystl::string>>)
+    .ranges({ 1000, 100000 });
+  add("map_insert/std", bm_map_insert<std::map<int, int>>)
+    .ranges({ 1000, 100000 }).dist(distribution::random).dist(distribution::sorted);
+  add("map_insert/mystl", bm_map_insert<mystl::map<int, int>>)
+    .ranges({ 1000, 100000 }).dist(distribution::random).dist(distribution::sorted);
+  add("order_statistic_map_insert/mystl", bm_map_insert<mystl::order_statistic_map<int, int>>)
+    .ranges({ 1000, 100000 }).dist(distribution::random).dist(distribution::sorted);
+  add("set_select/std", bm_set_select<std::multiset<int>>)
+    .ranges({ 1000, 100000 });
+  add("set_select/mystl", bm_set_select<mystl::multiset<int>>)
+    .ranges({ 1000, 100000 });
+  add("set_select/order_statistic", bm_set_select<mystl::order_statistic_multiset<int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_insert/std", bm_unordered_map_insert<std::unordered_map<int, int>>)
+    .ranges({ 1000, 100000 }).dist(distribution::random).dist(distribution::few_unique);
+  add("unordered_map_insert/mystl", bm_unordered_map_insert<mystl::unordered_map<int, int>>)
+    .ranges({ 1000, 100000 }).dist(distribution::random).dist(distribution::few_unique);
+  add("unordered_map_find/std", bm_unordered_map_find<std::unordered_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_find/mystl", bm_unordered_map_find<mystl::unordered_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("map_find/std", bm_map_find<std::map<int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("map_find/mystl", bm_map_find<mystl::map<int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("map_find/compact", bm_map_find<mystl::map<compact_int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("map_iterate/std", bm_map_iterate<std::map<int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("map_iterate/mystl", bm_map_iterate<mystl::map<int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("map_iterate/compact", bm_map_iterate<mystl::map<compact_int, int>>)
+    .ranges({ 1000, 1000000 });
+  add("unordered_map_find_string/std", bm_unordered_map_find<std::unordered_map<std::string, int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_find_string/mystl",
+      bm_unordered_map_find<mystl::unordered_map<mystl::string, int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_find_string/uncached",
+      bm_unordered_map_find<mystl::unordered_map<plain_string, int, plain_string_hash>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_rehash_string/std",
+      bm_unordered_map_rehash<std::unordered_map<std::string, int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_rehash_string/mystl",
+      bm_unordered_map_rehash<mystl::unordered_map<mystl::string, int>>)
+    .ranges({ 1000, 100000 });
+  add("unordered_map_rehash_string/uncached",
+      bm_unordered_map_rehash<mystl::unordered_map<plain_string, int, plain_string_hash>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_load/unordered_map", bm_snapshot_load<mystl::unordered_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_load/map", bm_snapshot_load<mystl::map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_open/mapped_unordered_map",
+      bm_snapshot_open<mystl::unordered_map<int, int>, mystl::mapped_unordered_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_open/mapped_flat_map",
+      bm_snapshot_open<mystl::map<int, int>, mystl::mapped_flat_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_find/mapped_unordered_map",
+      bm_snapshot_find<mystl::unordered_map<int, int>, mystl::mapped_unordered_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_find/mapped_flat_map",
+      bm_snapshot_find<mystl::map<int, int>, mystl::mapped_flat_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("string_append/std", bm_string_append<std::string>)
+    .ranges({ 1000, 100000 });
+  add("string_append/mystl", bm_string_append<mystl::string>)
+    .ranges({ 1000, 100000 });
+#if MYSTL_HAS_CONSTEXPR14
+  add("header_find/std", bm_header_find<std::unordered_map<std::string, int>>)
+    .ranges({ 10000 });
+  add("header_find/mystl", bm_header_find<mystl::unordered_map<mystl::string, int>>)
+    .ranges({ 10000 });
+  add("header_find/static_map", bm_header_find<header_static_map>)
+    .ranges({ 10000 });
+  add("header_find/static_sorted_map", bm_header_find<header_sorted_map>)
+    .ranges({ 10000 });
+#endif
+  add("snapshot_update/map", bm_snapshot_update_map<mystl::map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_update/persistent_map",
+      bm_snapshot_update_map<mystl::persistent_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_update/vector", bm_snapshot_update_vector<mystl::vector<int>>)
+    .ranges({ 1000, 100000 });
+  add("snapshot_update/persistent_vector",
+      bm_snapshot_update_vector<mystl::persistent_vector<int>>)
+    .ranges({ 1000, 100000 });
+  add("persistent_insert/map", bm_persistent_insert<mystl::map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("persistent_insert/persistent_map", bm_persistent_insert<mystl::persistent_map<int, int>>)
+    .ranges({ 1000, 100000 });
+  add("move_audit_priority_queue/string", bm_move_audit_priority_queue<mystl::string>)
+    .ranges({ 1000 });
+  add("move_audit_priority_queue/vector", bm_move_audit_priority_queue<mystl::vector<int>>)
+    .ranges({ 1000 });
+  add("move_audit_map/string",
+      bm_move_audit_map<mystl::map<int, counted<mystl::string>>, mystl::string>)
+    .ranges({ 1000 });
+  add("move_audit_map/vector",
+      bm_move_audit_map<mystl::map<int, counted<mystl::vector<int>>>, mystl::vector<int>>)
+    .ranges({ 1000 });
+  add("move_audit_unordered_map/string",
+      bm_move_audit_map<mystl::unordered_map<int, counted<mystl::string>>, mystl::string>)
+    .ranges({ 1000 });
+  add("move_audit_unordered_map/vector",
+      bm_move_audit_map<mystl::unordered_map<int, counted<mystl::vector<int>>>,
+                        mystl::vector<int>>)
+    .ranges({ 1000 });
+  add("move_audit_deque_insert/string", bm_move_audit_deque_insert<mystl::string>)
+    .ranges({ 1000 });
+  add("move_audit_deque_insert/vector", bm_move_audit_deque_insert<mystl::vector<int>>)
+    .ranges({ 1000 });
+}
+
+} // namespace bench
+} // namespace mystl
+
+int main(int argc, char** argv)
+{
+  using namespace mystl::bench;
+
+  register_algorithm_benchmarks();
+  register_numeric_benchmarks();
+  register_container_benchmarks();
+  return run_all(argc, argv);
+}
@@ -0,0 +1,716 @@
+﻿#ifndef MYTINYSTL_BENCH_H_
+#define MYTINYSTL_BENCH_H_
+
+// 这个头文件是 mystl_bench 使用的基准测试框架
+//
+// benchmark : 一个基准测试，由名字、被测函数、若干输入规模与输入分布组成
+// state     : 传给被测函数的运行状态，提供计时循环、暂停计时、吞吐量与自定义计数
+// run_all   : 解析命令行，逐个运行注册的基准测试并按 console / csv / json 格式输出
+
+// notes:
+//
+// 1. 计时使用 std::chrono::steady_clock，x86 平台上同时用 rdtsc 记录周期数
+// 2. 每个用例先校准迭代次数，使一次重复的耗时不少于 --min-time 秒，
+//    然后丢弃 --warmup 次预热，再重复 --reps 次，报告每次迭代耗时的中位数、p99、最小值、均值与变异系数
+// 3. p99 取最近秩（nearest rank），重复次数少于 100 时它等于最大值
+// 4. 输入由 make_input 按分布生成，种子固定（--seed），不同的运行之间可以直接比较
+// 5. 被测函数用 do_not_optimize 与 clobber_memory 阻止编译器删去没有使用的结果
+// 6. 以 MYSTL_INSTRUMENT=1 编译时，计时循环中 instrument 计数的变化按每次迭代平均后作为自定义计数输出
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include "../MyTinySTL/instrument.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MYSTL_BENCH_HAS_RDTSC 1
+#if !defined(_MSC_VER)
+#include <x86intrin.h>
+#endif
+#else
+#define MYSTL_BENCH_HAS_RDTSC 0
+#endif
+
+namespace mystl
+{
+namespace bench
+{
+
+/*****************************************************************************************/
+// 优化屏障
+
+// 让编译器认为 value 被读取，不能删去计算它的代码
+template <class T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+  _ReadWriteBarrier();
+#endif
+}
+
+// 让编译器认为所有内存都可能被读写，写入内存的结果不能被删去
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#else
+  _ReadWriteBarrier();
+#endif
+}
+
+/*****************************************************************************************/
+// 计时
+
+typedef std::chrono::steady_clock clock_type;
+
+inline uint64_t now_ns()
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    clock_type::now().time_since_epoch()).count());
+}
+
+inline uint64_t now_cycles()
+{
+#if MYSTL_BENCH_HAS_RDTSC
+  return static_cast<uint64_t>(__rdtsc());
+#else
+  return 0;
+#endif
+}
+
+/*****************************************************************************************/
+// 输入分布
+
+enum class distribution
+{
+  random,         // 均匀随机
+  sorted,         // 升序
+  reversed,       // 降序
+  organ_pipe,     // 先升后降
+  few_unique,     // 只有 16 种取值
+  nearly_sorted   // 升序，其中 1% 的位置被随机交换
+};
+
+inline const char* distribution_name(distribution d)
+{
+  switch (d)
+  {
+  case distribution::random:        return "random";
+  case distribution::sorted:        return "sorted";
+  case distribution::reversed:      return "reversed";
+  case distribution::organ_pipe:    return "organ_pipe";
+  case distribution::few_unique:    return "few_unique";
+  case distribution::nearly_sorted: return "nearly_sorted";
+  }
+  return "unknown";
+}
+
+inline std::vector<distribution> all_distributions()
+{
+  return { distribution::random, distribution::sorted, distribution::reversed,
+           distribution::organ_pipe, distribution::few_unique, distribution::nearly_sorted };
+}
+
+// 生成 n 个按分布 d 排列的整数，相同的参数总是得到相同的结果
+inline std::vector<int> make_input(distribution d, size_t n, uint32_t seed)
+{
+  std::vector<int> v(n);
+  std::mt19937 gen(seed);
+  const int count = static_cast<int>(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const int x = static_cast<int>(i);
+    switch (d)
+    {
+    case distribution::sorted:
+    case distribution::nearly_sorted: v[i] = x; break;
+    case distribution::reversed:      v[i] = count - x; break;
+    case distribution::organ_pipe:    v[i] = i < n / 2 ? x : count - x; break;
+    case distribution::few_unique:    v[i] = static_cast<int>(gen() % 16); break;
+    default:                          v[i] = static_cast<int>(gen() >> 1); break;
+    }
+  }
+  if (d == distribution::nearly_sorted && n > 1)
+  {
+    for (size_t i = 0; i < n / 100; ++i)
+      std::swap(v[gen() % n], v[gen() % n]);
+  }
+  return v;
+}
+
+/*****************************************************************************************/
+// state
+
+class state
+{
+  friend class runner;
+
+private:
+  size_t       range_;
+  distribution dist_;
+  uint32_t     seed_;
+  size_t       max_iters_;
+  size_t       iters_;
+  bool         running_;
+  uint64_t     start_ns_;
+  uint64_t     start_cycles_;
+  uint64_t     elapsed_ns_;
+  uint64_t     elapsed_cycles_;
+  double       items_;
+  std::vector<std::pair<std::string, double>> counters_;
+  instrument_snapshot                         instrument_start_;
+
+public:
+  state(size_t range, distribution dist, uint32_t seed, size_t max_iters)
+    :range_(range), dist_(dist), seed_(seed), max_iters_(max_iters), iters_(0),
+    running_(false), start_ns_(0), start_cycles_(0), elapsed_ns_(0), elapsed_cycles_(0),
+    items_(0), instrument_start_()
+  {
+  }
+
+  state(const state&) = delete;
+  state& operator=(const state&) = delete;
+
+  // 计时循环：while (st.keep_running()) { ... }
+  // 第一次调用时开始计时，循环结束时停止
+  bool keep_running()
+  {
+    if (iters_ == 0 && !running_)
+    {
+      if (instrument::enabled())
+      { // 清零使 hashtable_max_chain 只反映这次重复
+        instrument::reset();
+        instrument_start_ = instrument::snapshot();
+      }
+      resume_timing();
+    }
+    if (iters_ < max_iters_)
+    {
+      ++iters_;
+      return true;
+    }
+    pause_timing();
+    if (instrument::enabled())
+      record_instrument();
+    return false;
+  }
+
+  // 暂停与恢复计时，用于在循环内准备输入
+  void pause_timing()
+  {
+    if (!running_)
+      return;
+    elapsed_cycles_ += now_cycles() - start_cycles_;
+    elapsed_ns_ += now_ns() - start_ns_;
+    running_ = false;
+  }
+
+  void resume_timing()
+  {
+    if (running_)
+      return;
+    running_ = true;
+    start_ns_ = now_ns();
+    start_cycles_ = now_cycles();
+  }
+
+  size_t       range()      const noexcept { return range_; }
+  distribution dist()       const noexcept { return dist_; }
+  uint32_t     seed()       const noexcept { return seed_; }
+  size_t       iterations() const noexcept { return max_iters_; }
+
+  // 所有迭代共处理的元素个数，用于计算吞吐量
+  void set_items_processed(double items) { items_ = items; }
+
+  // 自定义计数，取最后一次重复的值输出
+  void set_counter(const std::string& name, double value)
+  {
+    for (auto& c : counters_)
+    {
+      if (c.first == name)
+      {
+        c.second = value;
+        return;
+      }
+    }
+    counters_.emplace_back(name, value);
+  }
+
+private:
+  void record_instrument()
+  {
+    const auto end = instrument::snapshot();
+    for (size_t i = 0; i < instrument_counter_count; ++i)
+    {
+      const auto id = static_cast<instrument_counter>(i);
+      // hashtable_max_chain 不是累计值，直接取这次重复中的最大值
+      const double value = id == hashtable_max_chain ? static_cast<double>(end[id]) :
+        static_cast<double>(end[id] - instrument_start_[id]) / static_cast<double>(max_iters_);
+      if (value != 0)
+        set_counter(instrument::name(id), value);
+    }
+  }
+};
+
+/*****************************************************************************************/
+// benchmark 与注册表
+
+typedef std::function<void(state&)> bench_function;
+
+class benchmark
+{
+  friend class runner;
+
+private:
+  std::string               name_;
+  bench_function            fun_;
+  std::vector<size_t>       ranges_;
+  std::vector<distribution> dists_;
+
+public:
+  benchmark(std::string name, bench_function fun)
+    :name_(std::move(name)), fun_(std::move(fun))
+  {
+  }
+
+  // 输入规模，缺省只有 1
+  benchmark& range(size_t n)
+  {
+    ranges_.push_back(n);
+    return *this;
+  }
+  benchmark& ranges(std::initializer_list<size_t> ilist)
+  {
+    ranges_.insert(ranges_.end(), ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 输入分布，缺省时名字中不出现分布，state::dist() 为 random
+  benchmark& dist(distribution d)
+  {
+    dists_.push_back(d);
+    return *this;
+  }
+  benchmark& dists(const std::vector<distribution>& ds)
+  {
+    dists_.insert(dists_.end(), ds.begin(), ds.end());
+    return *this;
+  }
+
+  const std::string& name() const noexcept { return name_; }
+};
+
+inline std::vector<benchmark>& registry()
+{
+  static std::vector<benchmark> benchmarks;
+  return benchmarks;
+}
+
+// 注册一个基准测试，返回它以便继续设置规模与分布，返回的引用在下一次注册前有效
+inline benchmark& add(const std::string& name, bench_function fun)
+{
+  registry().emplace_back(name, std::move(fun));
+  return registry().back();
+}
+
+/*****************************************************************************************/
+// 统计与输出
+
+// 一个用例（基准测试 × 规模 × 分布）的结果，时间单位为每次迭代的纳秒
+struct result
+{
+  std::string name;
+  size_t      range;
+  size_t      iterations;
+  size_t      reps;
+  double      median;
+  double      p99;
+  double      min;
+  double      mean;
+  double      cv;             // 变异系数 stddev / mean
+  double      median_cycles;  // 不支持 rdtsc 时为 0
+  double      items_per_sec;  // 没有设置 items 时为 0
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+struct options
+{
+  enum format_type { console, csv, json };
+
+  format_type format   = console;
+  std::string filter;
+  size_t      reps     = 15;
+  size_t      warmup   = 2;
+  double      min_time = 0.05;
+  uint32_t    seed     = 20240601u;
+  bool        list     = false;
+};
+
+// 最近秩百分位数，v 已经排好序
+inline double percentile(const std::vector<double>& v, double p)
+{
+  if (v.empty())
+    return 0.0;
+  size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(v.size())));
+  if (rank == 0)
+    rank = 1;
+  return v[std::min(rank, v.size()) - 1];
+}
+
+inline double median(std::vector<double> v)
+{
+  if (v.empty())
+    return 0.0;
+  std::sort(v.begin(), v.end());
+  const size_t mid = v.size() / 2;
+  return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2;
+}
+
+// 把纳秒转换为合适的单位，写入 buf
+inline const char* format_time(double ns, char* buf, size_t size)
+{
+  if (ns < 1e3)
+    std::snprintf(buf, size, "%.2fns", ns);
+  else if (ns < 1e6)
+    std::snprintf(buf, size, "%.2fus", ns / 1e3);
+  else if (ns < 1e9)
+    std::snprintf(buf, size, "%.2fms", ns / 1e6);
+  else
+    std::snprintf(buf, size, "%.2fs", ns / 1e9);
+  return buf;
+}
+
+inline std::string json_escape(const std::string& s)
+{
+  std::string r;
+  for (char c : s)
+  {
+    if (c == '"' || c == '\\')
+      r += '\\';
+    r += c;
+  }
+  return r;
+}
+
+inline const char* compiler_name()
+{
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc";
+#else
+  return "unknown";
+#endif
+}
+
+/*****************************************************************************************/
+// runner
+
+class runner
+{
+private:
+  options             opt_;
+  std::vector<result> results_;
+
+public:
+  explicit runner(const options& opt) :opt_(opt) {}
+
+  int run();
+
+private:
+  void   run_case(const benchmark& b, size_t range, distribution d, const std::string& name);
+  size_t calibrate(const benchmark& b, size_t range, distribution d);
+
+  void   print_header() const;
+  void   print_row(const result& r) const;
+  void   print_footer() const;
+};
+
+/*****************************************************************************************/
+
+inline int runner::run()
+{
+  print_header();
+  for (const auto& b : registry())
+  {
+    std::vector<size_t> ranges = b.ranges_;
+    if (ranges.empty())
+      ranges.push_back(1);
+    std::vector<distribution> dists = b.dists_;
+    const bool show_dist = !dists.empty();
+    if (!show_dist)
+      dists.push_back(distribution::random);
+    for (auto d : dists)
+    {
+      for (auto n : ranges)
+      {
+        std::string name = b.name_;
+        if (show_dist)
+          name += std::string("/") + distribution_name(d);
+        name += "/" + std::to_string(n);
+        if (!opt_.filter.empty() && name.find(opt_.filter) == std::string::npos)
+          continue;
+        if (opt_.list)
+        {
+          std::cout << name << "\n";
+          continue;
+        }
+        run_case(b, n, d, name);
+      }
+    }
+  }
+  print_footer();
+  return 0;
+}
+
+// 从 1 次迭代开始，按耗时估计放大，直到一次重复不少于 min_time 秒
+inline size_t runner::calibrate(const benchmark& b, size_t range, distribution d)
+{
+  const double target = opt_.min_time * 1e9;
+  size_t iters = 1;
+  while (true)
+  {
+    state st(range, d, opt_.seed, iters);
+    b.fun_(st);
+    const double elapsed = static_cast<double>(st.elapsed_ns_);
+    if (elapsed >= target || iters >= (static_cast<size_t>(1) << 40))
+      return iters;
+    double factor = elapsed > 0 ? target * 1.4 / elapsed : 10.0;
+    factor = std::max(1.5, std::min(10.0, factor));
+    iters = static_cast<size_t>(static_cast<double>(iters) * factor) + 1;
+  }
+}
+
+inline void runner::run_case(const benchmark& b, size_t range, distribution d,
+                             const std::string& name)
+{
+  const size_t iters = calibrate(b, range, d);
+  for (size_t i = 0; i < opt_.warmup; ++i)
+  {
+    state st(range, d, opt_.seed, iters);
+    b.fun_(st);
+  }
+
+  std::vector<double> times, cycles;
+  result r;
+  r.name = name;
+  r.range = range;
+  r.iterations = iters;
+  r.reps = std::max<size_t>(opt_.reps, 1);
+  r.items_per_sec = 0.0;
+  double items_per_iter = 0.0;
+  for (size_t i = 0; i < r.reps; ++i)
+  {
+    state st(range, d, opt_.seed, iters);
+    b.fun_(st);
+    const double it = static_cast<double>(iters);
+    times.push_back(static_cast<double>(st.elapsed_ns_) / it);
+    cycles.push_back(static_cast<double>(st.elapsed_cycles_) / it);
+    items_per_iter = st.items_ / it;
+    r.counters = st.counters_;
+  }
+
+  r.median = median(times);
+  r.median_cycles = median(cycles);
+  std::sort(times.begin(), times.end());
+  r.p99 = percentile(times, 0.99);
+  r.min = times.front();
+  double sum = 0.0;
+  for (auto t : times)
+    sum += t;
+  r.mean = sum / static_cast<double>(times.size());
+  double var = 0.0;
+  for (auto t : times)
+    var += (t - r.mean) * (t - r.mean);
+  r.cv = r.mean > 0 ? std::sqrt(var / static_cast<double>(times.size())) / r.mean : 0.0;
+  // 吞吐量按中位数耗时换算
+  if (items_per_iter > 0 && r.median > 0)
+    r.items_per_sec = items_per_iter * 1e9 / r.median;
+
+  results_.push_back(r);
+  print_row(r);
+}
+
+inline void runner::print_header() const
+{
+  if (opt_.list)
+    return;
+  switch (opt_.format)
+  {
+  case options::console:
+    std::printf("%-48s %12s %12s %12s %8s %12s %12s %14s\n", "benchmark", "median", "p99",
+                "min", "cv", "cycles", "iterations", "items/s");
+    std::printf("%s\n", std::string(136, '-').c_str());
+    break;
+  case options::csv:
+    std::printf("name,range,iterations,reps,median_ns,p99_ns,min_ns,mean_ns,cv,"
+                "median_cycles,items_per_second,counters\n");
+    break;
+  case options::json:
+    std::printf("{\n  \"context\": {\n");
+    std::printf("    \"compiler\": \"%s\",\n", json_escape(compiler_name()).c_str());
+    std::printf("    \"rdtsc\": %s,\n", MYSTL_BENCH_HAS_RDTSC ? "true" : "false");
+    std::printf("    \"reps\": %zu,\n    \"warmup\": %zu,\n", opt_.reps, opt_.warmup);
+    std::printf("    \"min_time\": %g,\n    \"seed\": %u\n  },\n", opt_.min_time,
+                static_cast<unsigned>(opt_.seed));
+    std::printf("  \"benchmarks\": [");
+    break;
+  }
+  std::fflush(stdout);
+}
+
+inline void runner::print_row(const result& r) const
+{
+  char m[32], p[32], lo[32];
+  switch (opt_.format)
+  {
+  case options::console:
+  {
+    std::string items = "-";
+    if (r.items_per_sec > 0)
+    {
+      char buf[32];
+      if (r.items_per_sec >= 1e9)
+        std::snprintf(buf, sizeof(buf), "%.2fG", r.items_per_sec / 1e9);
+      else if (r.items_per_sec >= 1e6)
+        std::snprintf(buf, sizeof(buf), "%.2fM", r.items_per_sec / 1e6);
+      else
+        std::snprintf(buf, sizeof(buf), "%.2fk", r.items_per_sec / 1e3);
+      items = buf;
+    }
+    std::printf("%-48s %12s %12s %12s %7.2f%% %12.0f %12zu %14s", r.name.c_str(),
+                format_time(r.median, m, sizeof(m)), format_time(r.p99, p, sizeof(p)),
+                format_time(r.min, lo, sizeof(lo)), r.cv * 100, r.median_cycles,
+                r.iterations, items.c_str());
+    for (const auto& c : r.counters)
+      std::printf(" %s=%g", c.first.c_str(), c.second);
+    std::printf("\n");
+    break;
+  }
+  case options::csv:
+  {
+    std::printf("%s,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.5f,%.1f,%.1f,", r.name.c_str(), r.range,
+                r.iterations, r.reps, r.median, r.p99, r.min, r.mean, r.cv, r.median_cycles,
+                r.items_per_sec);
+    for (size_t i = 0; i < r.counters.size(); ++i)
+      std::printf("%s%s=%g", i ? ";" : "", r.counters[i].first.c_str(), r.counters[i].second);
+    std::printf("\n");
+    break;
+  }
+  case options::json:
+  {
+    std::printf("%s\n    {\n", results_.size() > 1 ? "," : "");
+    std::printf("      \"name\": \"%s\",\n", json_escape(r.name).c_str());
+    std::printf("      \"range\": %zu,\n      \"iterations\": %zu,\n      \"reps\": %zu,\n",
+                r.range, r.iterations, r.reps);
+    std::printf("      \"median_ns\": %.3f,\n      \"p99_ns\": %.3f,\n"
+                "      \"min_ns\": %.3f,\n      \"mean_ns\": %.3f,\n      \"cv\": %.5f,\n",
+                r.median, r.p99, r.min, r.mean, r.cv);
+    std::printf("      \"median_cycles\": %.1f,\n      \"items_per_second\": %.1f,\n",
+                r.median_cycles, r.items_per_sec);
+    std::printf("      \"counters\": {");
+    for (size_t i = 0; i < r.counters.size(); ++i)
+      std::printf("%s\"%s\": %g", i ? ", " : "", json_escape(r.counters[i].first).c_str(),
+                  r.counters[i].second);
+    std::printf("}\n    }");
+    break;
+  }
+  }
+  std::fflush(stdout);
+}
+
+inline void runner::print_footer() const
+{
+  if (!opt_.list && opt_.format == options::json)
+    std::printf("\n  ]\n}\n");
+  std::fflush(stdout);
+}
+
+/*****************************************************************************************/
+// 命令行
+
+inline void print_usage(const char* prog)
+{
+  std::printf(
+    "usage: %s [options]\n"
+    "  --format=console|csv|json  output format (default console)\n"
+    "  --filter=SUBSTR            run only benchmarks whose name contains SUBSTR\n"
+    "  --reps=N                   measured repetitions per case (default 15)\n"
+    "  --warmup=N                 discarded repetitions per case (default 2)\n"
+    "  --min-time=SECONDS         minimum time of one repetition (default 0.05)\n"
+    "  --seed=N                   seed of the generated inputs\n"
+    "  --list                     list benchmark names and exit\n", prog);
+}
+
+// 解析命令行，成功时返回 true
+inline bool parse_options(int argc, char** argv, options& opt)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const auto eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+    if (key == "--format" && value == "console")
+      opt.format = options::console;
+    else if (key == "--format" && value == "csv")
+      opt.format = options::csv;
+    else if (key == "--format" && value == "json")
+      opt.format = options::json;
+    else if (key == "--filter")
+      opt.filter = value;
+    else if (key == "--reps" && !value.empty())
+      opt.reps = static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10));
+    else if (key == "--warmup" && !value.empty())
+      opt.warmup = static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10));
+    else if (key == "--min-time" && !value.empty())
+      opt.min_time = std::strtod(value.c_str(), nullptr);
+    else if (key == "--seed" && !value.empty())
+      opt.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    else if (key == "--list")
+      opt.list = true;
+    else
+      return false;
+  }
+  return true;
+}
+
+// 解析命令行并运行所有注册的基准测试
+inline int run_all(int argc, char** argv)
+{
+  options opt;
+  if (!parse_options(argc, argv, opt))
+  {
+    print_usage(argv[0]);
+    return 1;
+  }
+  runner r(opt);
+  return r.run();
+}
+
+} // namespace bench
+} // namespace mystl
+#endif // !MYTINYSTL_BENCH_H_
+
@@ -9,6 +9,8 @@
 // 这个头文件包含了 mystl 的一系列算法
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 
 #include "algobase.h"
@@ -67,9 +69,10 @@ bool none_of(InputIter first, InputIter last, UnaryPredicate unary_pred)
 /*****************************************************************************************/
 // count
 // 对[first, last)区间内的元素与给定值进行比较，缺省使用 operator==，返回元素相等的个数
+// 整数或浮点数的数组使用 simd.h 中的 count_elem，分段迭代器逐段计数
 /*****************************************************************************************/
 template <class InputIter, class T>
-size_t count(InputIter first, InputIter last, const T& value)
+size_t count_dispatch(InputIter first, InputIter last, const T& value, m_false_type)
 {
   size_t n = 0;
   for (; first != last; ++first)
@@ -80,6 +83,45 @@ size_t count(InputIter first, InputIter last, const T& value)
   return n;
 }
 
+template <class E, class T>
+size_t count_dispatch(E* first, E* last, const T& value, m_true_type)
+{
+  typedef typename std::remove_cv<E>::type elem_type;
+  if (!simd::exact_value<elem_type>(value))
+    return 0;
+  return simd::count_elem<elem_type>(first, static_cast<size_t>(last - first),
+                                     static_cast<elem_type>(value));
+}
+
+template <class InputIter, class T>
+size_t count_segment(InputIter first, InputIter last, const T& value, m_false_type)
+{
+  return mystl::count_dispatch(first, last, value,
+                               m_bool_constant<simd::is_find_range<InputIter, T>::value>());
+}
+
+template <class SegIter, class T>
+size_t count_segment(SegIter first, SegIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+    return mystl::count_segment(traits::local(first), traits::local(last), value, m_false_type());
+  size_t n = mystl::count_segment(traits::local(first), traits::end(sfirst), value, m_false_type());
+  for (++sfirst; sfirst != slast; ++sfirst)
+  {
+    n += mystl::count_segment(traits::begin(sfirst), traits::end(sfirst), value, m_false_type());
+  }
+  return n + mystl::count_segment(traits::begin(slast), traits::local(last), value, m_false_type());
+}
+
+template <class InputIter, class T>
+size_t count(InputIter first, InputIter last, const T& value)
+{
+  return mystl::count_segment(first, last, value, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // count_if
 // 对[first, last)区间内的每个元素都进行一元 unary_pred 操作，返回结果为 true 的个数
@@ -99,29 +141,104 @@ size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
 /*****************************************************************************************/
 // find
 // 在[first, last)区间内找到等于 value 的元素，返回指向该元素的迭代器
+// 整数或浮点数的数组使用 simd.h 中的 find_elem，分段迭代器逐段查找
 /*****************************************************************************************/
 template <class InputIter, class T>
 InputIter
-find(InputIter first, InputIter last, const T& value)
+find_dispatch(InputIter first, InputIter last, const T& value, m_false_type)
 {
   while (first != last && *first != value)
     ++first;
   return first;
 }
 
+template <class E, class T>
+E* find_dispatch(E* first, E* last, const T& value, m_true_type)
+{
+  typedef typename std::remove_cv<E>::type elem_type;
+  // value 不能表示为元素的类型时，不会与任何元素相等
+  if (!simd::exact_value<elem_type>(value))
+    return last;
+  return first + simd::find_elem<elem_type>(first, static_cast<size_t>(last - first),
+                                            static_cast<elem_type>(value));
+}
+
+template <class InputIter, class T>
+InputIter
+find_segment(InputIter first, InputIter last, const T& value, m_false_type)
+{
+  return mystl::find_dispatch(first, last, value,
+                              m_bool_constant<simd::is_find_range<InputIter, T>::value>());
+}
+
+template <class SegIter, class T>
+SegIter
+find_segment(SegIter first, SegIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto seg = traits::segment(first);
+  const auto slast = traits::segment(last);
+  auto lfirst = traits::local(first);
+  while (true)
+  {
+    const auto llast = seg == slast ? traits::local(last) : traits::end(seg);
+    const auto pos = mystl::find_segment(lfirst, llast, value, m_false_type());
+    if (pos != llast)
+      return traits::compose(seg, pos);
+    if (seg == slast)
+      return last;
+    lfirst = traits::begin(++seg);
+  }
+}
+
+template <class InputIter, class T>
+InputIter
+find(InputIter first, InputIter last, const T& value)
+{
+  return mystl::find_segment(first, last, value, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // find_if
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 true 的元素并返回指向该元素的迭代器
+// 分段迭代器逐段查找
 /*****************************************************************************************/
 template <class InputIter, class UnaryPredicate>
 InputIter
-find_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
+find_if_segment(InputIter first, InputIter last, UnaryPredicate& unary_pred, m_false_type)
 {
   while (first != last && !unary_pred(*first))
     ++first;
   return first;
 }
 
+template <class SegIter, class UnaryPredicate>
+SegIter
+find_if_segment(SegIter first, SegIter last, UnaryPredicate& unary_pred, m_true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto seg = traits::segment(first);
+  const auto slast = traits::segment(last);
+  auto lfirst = traits::local(first);
+  while (true)
+  {
+    const auto llast = seg == slast ? traits::local(last) : traits::end(seg);
+    const auto pos = mystl::find_if_segment(lfirst, llast, unary_pred, m_false_type());
+    if (pos != llast)
+      return traits::compose(seg, pos);
+    if (seg == slast)
+      return last;
+    lfirst = traits::begin(++seg);
+  }
+}
+
+template <class InputIter, class UnaryPredicate>
+InputIter
+find_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::find_if_segment(first, last, unary_pred, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // find_if_not
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 false 的元素并返回指向该元素的迭代器
@@ -472,24 +589,48 @@ find_first_of(InputIter first1, InputIter last1,
 /*****************************************************************************************/
 // for_each
 // 使用一个函数对象 f 对[first, last)区间内的每个元素执行一个 operator() 操作，但不能改变元素内容
-// f() 可返回一个值，但该值会被忽略
+// f() 可返回一个值，但该值会被忽略，分段迭代器逐段进行
 /*****************************************************************************************/
 template <class InputIter, class Function>
-Function for_each(InputIter first, InputIter last, Function f)
+void for_each_segment(InputIter first, InputIter last, Function& f, m_false_type)
 {
   for (; first != last; ++first)
   {
     f(*first);
   }
+}
+
+template <class SegIter, class Function>
+void for_each_segment(SegIter first, SegIter last, Function& f, m_true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    mystl::for_each_segment(traits::local(first), traits::local(last), f, m_false_type());
+    return;
+  }
+  mystl::for_each_segment(traits::local(first), traits::end(sfirst), f, m_false_type());
+  for (++sfirst; sfirst != slast; ++sfirst)
+    mystl::for_each_segment(traits::begin(sfirst), traits::end(sfirst), f, m_false_type());
+  mystl::for_each_segment(traits::begin(slast), traits::local(last), f, m_false_type());
+}
+
+template <class InputIter, class Function>
+Function for_each(InputIter first, InputIter last, Function f)
+{
+  mystl::for_each_segment(first, last, f, is_segmented_iterator<InputIter>());
   return f;
 }
 
 /*****************************************************************************************/
 // adjacent_find
 // 找出第一对匹配的相邻元素，缺省使用 operator== 比较，如果找到返回一个迭代器，指向这对元素的第一个元素
+// 整数或浮点数的数组使用 simd.h 中的 adjacent_eq
 /*****************************************************************************************/
 template <class ForwardIter>
-ForwardIter adjacent_find(ForwardIter first, ForwardIter last)
+ForwardIter adjacent_find_dispatch(ForwardIter first, ForwardIter last, m_false_type)
 {
   if (first == last)  return last;
   auto next = first;
@@ -501,6 +642,21 @@ ForwardIter adjacent_find(ForwardIter first, ForwardIter last)
   return last;
 }
 
+template <class T>
+T* adjacent_find_dispatch(T* first, T* last, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t i = simd::adjacent_eq<typename std::remove_cv<T>::type>(first, n);
+  return i == n ? last : first + i;
+}
+
+template <class ForwardIter>
+ForwardIter adjacent_find(ForwardIter first, ForwardIter last)
+{
+  return mystl::adjacent_find_dispatch(first, last,
+    m_bool_constant<simd::is_compare_range<ForwardIter, ForwardIter>::value>());
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class ForwardIter, class Compared>
 ForwardIter adjacent_find(ForwardIter first, ForwardIter last, Compared comp)
@@ -515,6 +671,90 @@ ForwardIter adjacent_find(ForwardIter first, ForwardIter last, Compared comp)
   return last;
 }
 
+/*****************************************************************************************/
+// bound_search
+// lower_bound、upper_bound、equal_range 与 lower_bound_many 的随机访问迭代器版本使用的二分查找
+// 每次比较后以条件传送把区间缩小为后一半或前一半，循环中没有难以预测的分支；
+// 区间超过 MYSTL_BOUND_PREFETCH_BYTES 字节时，预取下一次可能比较的两个元素
+/*****************************************************************************************/
+
+#ifndef MYSTL_BOUND_PREFETCH_BYTES
+#define MYSTL_BOUND_PREFETCH_BYTES (256 * 1024)
+#endif
+
+// 预取指针指向的元素，其它迭代器不预取
+template <class T>
+void bound_prefetch(T* p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+template <class Iter>
+void bound_prefetch(const Iter&) noexcept
+{
+}
+
+// 缺省使用 operator< 比较
+struct bound_op_less
+{
+  template <class T1, class T2>
+  bool operator()(const T1& lhs, const T2& rhs) const { return lhs < rhs; }
+};
+
+// 元素小于 value，lower_bound 使用
+template <class T, class Compared>
+struct bound_less_pred
+{
+  const T& value;
+  Compared comp;
+  template <class U>
+  bool operator()(const U& x) const { return static_cast<bool>(comp(x, value)); }
+};
+
+// 元素不大于 value，upper_bound 使用
+template <class T, class Compared>
+struct bound_not_greater_pred
+{
+  const T& value;
+  Compared comp;
+  template <class U>
+  bool operator()(const U& x) const { return !comp(value, x); }
+};
+
+// 返回 [first, last) 中第一个令 pred 为 false 的位置，令 pred 为 true 的元素都在它之前
+// 区间 [first, first + len] 始终包含结果：pred(first[half]) 为 true 时结果在 first + half 之后
+template <class RandomIter, class Predicate>
+RandomIter bound_search(RandomIter first, RandomIter last, Predicate pred)
+{
+  typedef typename iterator_traits<RandomIter>::value_type      value_type;
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+  difference_type len = last - first;
+  if (len <= 0)
+    return first;
+  const difference_type prefetch_len =
+    static_cast<difference_type>(MYSTL_BOUND_PREFETCH_BYTES / sizeof(value_type));
+  while (len > prefetch_len)
+  {
+    const difference_type half = len >> 1;
+    const difference_type next = len - half;
+    mystl::bound_prefetch(first + (next >> 1));
+    mystl::bound_prefetch(first + half + (next >> 1));
+    first += pred(*(first + half)) ? half : 0;
+    len = next;
+  }
+  while (len > 1)
+  {
+    const difference_type half = len >> 1;
+    first += pred(*(first + half)) ? half : 0;
+    len -= half;
+  }
+  return first + (pred(*first) ? 1 : 0);
+}
+
 /*****************************************************************************************/
 // lower_bound
 // 在[first, last)中查找第一个不小于 value 的元素，并返回指向它的迭代器，若没有则返回 last
@@ -553,24 +793,8 @@ RandomIter
 lbound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (*middle < value)
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else
-    {
-      len = half;
-    }
-  }
-  return first;
+  return mystl::bound_search(first, last,
+                             bound_less_pred<T, bound_op_less>{ value, bound_op_less() });
 }
 
 template <class ForwardIter, class T>
@@ -615,24 +839,7 @@ RandomIter
 lbound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag, Compared comp)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(*middle, value))
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else
-    {
-      len = half;
-    }
-  }
-  return first;
+  return mystl::bound_search(first, last, bound_less_pred<T, Compared>{ value, comp });
 }
 
 template <class ForwardIter, class T, class Compared>
@@ -680,24 +887,8 @@ RandomIter
 ubound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (value < *middle)
-    {
-      len = half;
-    }
-    else
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-  }
-  return first;
+  return mystl::bound_search(first, last,
+                             bound_not_greater_pred<T, bound_op_less>{ value, bound_op_less() });
 }
 
 template <class ForwardIter, class T>
@@ -742,24 +933,7 @@ RandomIter
 ubound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag, Compared comp)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(value, *middle))
-    {
-      len = half;
-    }
-    else
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-  }
-  return first;
+  return mystl::bound_search(first, last, bound_not_greater_pred<T, Compared>{ value, comp });
 }
 
 template <class ForwardIter, class T, class Compared>
@@ -784,10 +958,67 @@ bool binary_search(ForwardIter first, ForwardIter last, const T& value)
 template <class ForwardIter, class T, class Compared>
 bool binary_search(ForwardIter first, ForwardIter last, const T& value, Compared comp)
 {
-  auto i = mystl::lower_bound(first, last, value);
+  auto i = mystl::lower_bound(first, last, value, comp);
   return i != last && !comp(value, *i);
 }
 
+/*****************************************************************************************/
+// lower_bound_many
+// 对 [keys_first, keys_last) 中的每个键在有序区间 [first, last) 中做 lower_bound，结果依次写入 result
+// 每次同时查找 lower_bound_batch 个键：长度相同的区间二分的步数相同，逐层交替推进各个查找，
+// 并在推进后预取它下一次比较的元素，多个查找的访存延迟可以相互重叠
+/*****************************************************************************************/
+enum { lower_bound_batch = 16 };
+
+template <class RandomIter, class ForwardIter, class OutputIter, class Compared>
+OutputIter lower_bound_many(RandomIter first, RandomIter last,
+                            ForwardIter keys_first, ForwardIter keys_last,
+                            OutputIter result, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+  const difference_type n = last - first;
+  RandomIter  base[lower_bound_batch];
+  ForwardIter key[lower_bound_batch];
+  while (keys_first != keys_last)
+  {
+    size_t m = 0;
+    for (; m < lower_bound_batch && keys_first != keys_last; ++m, ++keys_first)
+    {
+      base[m] = first;
+      key[m] = keys_first;
+    }
+    if (n <= 0)
+    {
+      for (size_t i = 0; i < m; ++i, ++result)
+        *result = first;
+      continue;
+    }
+    difference_type len = n;
+    while (len > 1)
+    {
+      const difference_type half = len >> 1;
+      const difference_type next_half = (len - half) >> 1;
+      for (size_t i = 0; i < m; ++i)
+      {
+        base[i] += comp(*(base[i] + half), *key[i]) ? half : 0;
+        mystl::bound_prefetch(base[i] + next_half);
+      }
+      len -= half;
+    }
+    for (size_t i = 0; i < m; ++i, ++result)
+      *result = base[i] + (comp(*base[i], *key[i]) ? 1 : 0);
+  }
+  return result;
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter>
+OutputIter lower_bound_many(RandomIter first, RandomIter last,
+                            ForwardIter keys_first, ForwardIter keys_last,
+                            OutputIter result)
+{
+  return mystl::lower_bound_many(first, last, keys_first, keys_last, result, bound_op_less());
+}
+
 /*****************************************************************************************/
 // equal_range
 // 查找[first,last)区间中与 value 相等的元素所形成的区间，返回一对迭代器指向区间首尾
@@ -829,35 +1060,17 @@ erange_dispatch(ForwardIter first, ForwardIter last,
 }
 
 // erange_dispatch 的 random_access_iterator_tag 版本
+// 先求 lower_bound，再在它之后求 upper_bound，找不到时两者都是 lower_bound
 template <class RandomIter, class T>
 mystl::pair<RandomIter, RandomIter>
 erange_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle, left, right;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (*middle < value)
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else if (value < *middle)
-    {
-      len = half;
-    }
-    else
-    {
-      left = mystl::lower_bound(first, middle, value);
-      right = mystl::upper_bound(++middle, first + len, value);
-      return mystl::pair<RandomIter, RandomIter>(left, right);
-    }
-  }
-  return mystl::pair<RandomIter, RandomIter>(last, last);
+  auto left = mystl::bound_search(first, last,
+                                  bound_less_pred<T, bound_op_less>{ value, bound_op_less() });
+  auto right = mystl::bound_search(left, last,
+                                   bound_not_greater_pred<T, bound_op_less>{ value, bound_op_less() });
+  return mystl::pair<RandomIter, RandomIter>(left, right);
 }
 
 template <class ForwardIter, class T>
@@ -909,30 +1122,9 @@ mystl::pair<RandomIter, RandomIter>
 erange_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag, Compared comp)
 {
-  auto len = last - first;
-  auto half = len;
-  RandomIter middle, left, right;
-  while (len > 0)
-  {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(*middle, value))
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else if (comp(value, *middle))
-    {
-      len = half;
-    }
-    else
-    {
-      left = mystl::lower_bound(first, middle, value, comp);
-      right = mystl::upper_bound(++middle, first + len, value, comp);
-      return mystl::pair<RandomIter, RandomIter>(left, right);
-    }
-  }
-  return mystl::pair<RandomIter, RandomIter>(last, last);
+  auto left = mystl::bound_search(first, last, bound_less_pred<T, Compared>{ value, comp });
+  auto right = mystl::bound_search(left, last, bound_not_greater_pred<T, Compared>{ value, comp });
+  return mystl::pair<RandomIter, RandomIter>(left, right);
 }
 
 template <class ForwardIter, class T, class Compared>
@@ -2180,7 +2372,7 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (*i < *first)
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first));
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i), distance_type(first));
     }
   }
   mystl::sort_heap(first, middle);
@@ -2196,7 +2388,7 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (comp(*i, *first))
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first), comp);
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i), distance_type(first), comp);
     }
   }
   mystl::sort_heap(first, middle, comp);
@@ -2314,6 +2506,61 @@ partition(BidirectionalIter first, BidirectionalIter last,
   return first;
 }
 
+/*****************************************************************************************/
+// stable_partition
+// 对区间内的元素重排，被一元条件运算判定为 true 的元素会放到区间的前段
+// 保持元素的原始相对位置，缓冲区足够时线性时间完成，否则分治后旋转合并
+/*****************************************************************************************/
+template <class ForwardIter, class Pointer, class UnaryPredicate, class Distance>
+ForwardIter
+stable_partition_adaptive(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred,
+                          Distance len, Pointer buffer, Distance buffer_size)
+{
+  if (len == 0)
+    return first;
+  if (len == 1)
+    return unary_pred(*first) ? last : first;
+  if (len <= buffer_size)
+  { // 判定为 true 的元素前移，其余的暂存到缓冲区
+    ForwardIter result1 = first;
+    Pointer result2 = buffer;
+    for (; first != last; ++first)
+    {
+      if (unary_pred(*first))
+        *result1++ = mystl::move(*first);
+      else
+        *result2++ = mystl::move(*first);
+    }
+    mystl::move(buffer, result2, result1);
+    return result1;
+  }
+  auto middle = first;
+  const Distance half = len / 2;
+  mystl::advance(middle, half);
+  auto left_split = mystl::stable_partition_adaptive(first, middle, unary_pred,
+                                                     half, buffer, buffer_size);
+  auto right_split = mystl::stable_partition_adaptive(middle, last, unary_pred,
+                                                      len - half, buffer, buffer_size);
+  // 把左半段的 false 部分与右半段的 true 部分交换位置
+  return mystl::rotate(left_split, middle, right_split);
+}
+
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter
+stable_partition(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  // 跳过开头已经在正确位置上的元素
+  while (first != last && unary_pred(*first))
+    ++first;
+  if (first == last)
+    return first;
+  const auto len = mystl::distance(first, last);
+  temporary_buffer<ForwardIter, value_type> buf(first, last);
+  return mystl::stable_partition_adaptive(first, last, unary_pred, len, buf.begin(),
+                                          static_cast<decltype(len)>(buf.size()));
+}
+
 /*****************************************************************************************/
 // partition_copy
 // 行为与 partition 类似，不同的是，将被一元操作符判定为 true 的放到 result_true 的输出区间
@@ -2343,9 +2590,7 @@ partition_copy(InputIter first, InputIter last,
 // sort
 // 将[first, last)内的元素以递增的方式排序
 /*****************************************************************************************/
-constexpr static size_t kSmallSectionSize = 128;  // 小型区间的大小，在这个大小内采用插入排序
-
-                                                  // 用于控制分割恶化的情况
+// 用于控制分割恶化的情况
 template <class Size>
 Size slg2(Size n)
 { // 找出 lgk <= n 的 k 的最大值
@@ -2374,25 +2619,6 @@ unchecked_partition(RandomIter first, RandomIter last, const T& pivot)
   }
 }
 
-// 内省式排序，先进行 quick sort，当分割行为有恶化倾向时，改用 heap sort
-template <class RandomIter, class Size>
-void intro_sort(RandomIter first, RandomIter last, Size depth_limit)
-{
-  while (static_cast<size_t>(last - first) > kSmallSectionSize)
-  {
-    if (depth_limit == 0)
-    {                      // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last);  // 改用 heap_sort
-      return;
-    }
-    --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
-    auto cut = mystl::unchecked_partition(first, last, mid);
-    mystl::intro_sort(cut, last, depth_limit);
-    last = cut;
-  }
-}
-
 // 插入排序辅助函数 unchecked_linear_insert
 template <class RandomIter, class T>
 void unchecked_linear_insert(RandomIter last, const T& value)
@@ -2408,16 +2634,6 @@ void unchecked_linear_insert(RandomIter last, const T& value)
   *last = value;
 }
 
-// 插入排序函数 unchecked_insertion_sort
-template <class RandomIter>
-void unchecked_insertion_sort(RandomIter first, RandomIter last)
-{
-  for (auto i = first; i != last; ++i)
-  {
-    mystl::unchecked_linear_insert(i, *i);
-  }
-}
-
 // 插入排序函数 insertion_sort
 template <class RandomIter>
 void insertion_sort(RandomIter first, RandomIter last)
@@ -2439,40 +2655,14 @@ void insertion_sort(RandomIter first, RandomIter last)
   }
 }
 
-// 最终插入排序函数 final_insertion_sort
-template <class RandomIter>
-void final_insertion_sort(RandomIter first, RandomIter last)
+// 重载版本使用函数对象 comp 代替比较操作
+// 分割函数 unchecked_partition
+template <class RandomIter, class T, class Compared>
+RandomIter
+unchecked_partition(RandomIter first, RandomIter last,
+                    const T& pivot, Compared comp)
 {
-  if (static_cast<size_t>(last - first) > kSmallSectionSize)
-  {
-    mystl::insertion_sort(first, first + kSmallSectionSize);
-    mystl::unchecked_insertion_sort(first + kSmallSectionSize, last);
-  }
-  else
-  {
-    mystl::insertion_sort(first, last);
-  }
-}
-
-template <class RandomIter>
-void sort(RandomIter first, RandomIter last)
-{
-  if (first != last)
-  {
-    // 内省式排序，将区间分为一个个小区间，然后对整体进行插入排序
-    mystl::intro_sort(first, last, slg2(last - first) * 2);
-    mystl::final_insertion_sort(first, last);
-  }
-}
-
-// 重载版本使用函数对象 comp 代替比较操作
-// 分割函数 unchecked_partition
-template <class RandomIter, class T, class Compared>
-RandomIter
-unchecked_partition(RandomIter first, RandomIter last,
-                    const T& pivot, Compared comp)
-{
-  while (true)
+  while (true)
   {
     while (comp(*first, pivot))
       ++first;
@@ -2486,26 +2676,6 @@ unchecked_partition(RandomIter first, RandomIter last,
   }
 }
 
-// 内省式排序，先进行 quick sort，当分割行为有恶化倾向时，改用 heap sort
-template <class RandomIter, class Size, class Compared>
-void intro_sort(RandomIter first, RandomIter last,
-                Size depth_limit, Compared comp)
-{
-  while (static_cast<size_t>(last - first) > kSmallSectionSize)
-  {
-    if (depth_limit == 0)
-    {                            // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last, comp);  // 改用 heap_sort
-      return;
-    }
-    --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
-    auto cut = mystl::unchecked_partition(first, last, mid, comp);
-    mystl::intro_sort(cut, last, depth_limit, comp);
-    last = cut;
-  }
-}
-
 // 插入排序辅助函数 unchecked_linear_insert
 template <class RandomIter, class T, class Compared>
 void unchecked_linear_insert(RandomIter last, const T& value, Compared comp)
@@ -2521,17 +2691,6 @@ void unchecked_linear_insert(RandomIter last, const T& value, Compared comp)
   *last = value;
 }
 
-// 插入排序函数 unchecked_insertion_sort
-template <class RandomIter, class Compared>
-void unchecked_insertion_sort(RandomIter first, RandomIter last,
-                              Compared comp)
-{
-  for (auto i = first; i != last; ++i)
-  {
-    mystl::unchecked_linear_insert(i, *i, comp);
-  }
-}
-
 // 插入排序函数 insertion_sort
 template <class RandomIter, class Compared>
 void insertion_sort(RandomIter first, RandomIter last, Compared comp)
@@ -2553,30 +2712,968 @@ void insertion_sort(RandomIter first, RandomIter last, Compared comp)
   }
 }
 
-// 最终插入排序函数 final_insertion_sort
+/*****************************************************************************************/
+// sort 的实现采用 pattern-defeating quicksort :
+// 1. 长度大于 kNintherThreshold 的区间用九数取中 (ninther) 选取枢轴，否则用三数取中
+// 2. 算术类型使用默认比较时，采用分块的无分支分割，减少分支预测失败
+// 3. 分割前已经有序的区间尝试用有限次数的插入排序直接完成
+// 4. 枢轴与左侧相邻的元素相等时，把相等的元素一次分到左侧，应对大量重复元素
+// 5. 分割严重不均衡时打乱部分元素，次数过多时改用 heap sort，保证 O(NlogN)
+/*****************************************************************************************/
+constexpr static size_t kInsertionSortThreshold    = 24;   // 小于这个长度的区间采用插入排序
+constexpr static size_t kNintherThreshold          = 128;  // 大于这个长度的区间用九数取中选取枢轴
+constexpr static size_t kPartialInsertionSortLimit = 8;    // 尝试插入排序时最多移动的元素数
+constexpr static size_t kPartitionBlockSize        = 64;   // 无分支分割每次处理的元素数
+
+// 是否为默认的比较方式
+template <class Compared, class T>
+struct pdq_is_default_compare : m_false_type {};
+
+template <class T>
+struct pdq_is_default_compare<mystl::less<T>, T> : m_true_type {};
+
+template <class T>
+struct pdq_is_default_compare<mystl::greater<T>, T> : m_true_type {};
+
+// 插入排序，first 左侧的元素不大于区间内的任何元素，可以省去边界检查
 template <class RandomIter, class Compared>
-void final_insertion_sort(RandomIter first, RandomIter last, Compared comp)
+void pdq_unguarded_insertion_sort(RandomIter first, RandomIter last, Compared comp)
 {
-  if (static_cast<size_t>(last - first) > kSmallSectionSize)
+  if (first == last)
+    return;
+  for (auto cur = first + 1; cur != last; ++cur)
   {
-    mystl::insertion_sort(first, first + kSmallSectionSize, comp);
-    mystl::unchecked_insertion_sort(first + kSmallSectionSize, last, comp);
+    auto sift = cur;
+    auto prev = cur - 1;
+    if (comp(*sift, *prev))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*prev);
+      } while (comp(tmp, *--prev));
+      *sift = mystl::move(tmp);
+    }
   }
+}
+
+template <class RandomIter, class Compared>
+void pdq_insertion_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (first == last)
+    return;
+  for (auto cur = first + 1; cur != last; ++cur)
+  {
+    auto sift = cur;
+    auto prev = cur - 1;
+    if (comp(*sift, *prev))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*prev);
+      } while (sift != first && comp(tmp, *--prev));
+      *sift = mystl::move(tmp);
+    }
+  }
+}
+
+// 尝试用插入排序完成排序，移动的元素超过 kPartialInsertionSortLimit 时放弃并返回 false
+template <class RandomIter, class Compared>
+bool pdq_partial_insertion_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (first == last)
+    return true;
+  size_t moved = 0;
+  for (auto cur = first + 1; cur != last; ++cur)
+  {
+    auto sift = cur;
+    auto prev = cur - 1;
+    if (comp(*sift, *prev))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*prev);
+      } while (sift != first && comp(tmp, *--prev));
+      *sift = mystl::move(tmp);
+      moved += static_cast<size_t>(cur - sift);
+    }
+    if (moved > kPartialInsertionSortLimit)
+      return false;
+  }
+  return true;
+}
+
+// 使 *a <= *b <= *c
+template <class RandomIter, class Compared>
+void pdq_sort3(RandomIter a, RandomIter b, RandomIter c, Compared comp)
+{
+  if (comp(*b, *a))
+    mystl::iter_swap(a, b);
+  if (comp(*c, *b))
+  {
+    mystl::iter_swap(b, c);
+    if (comp(*b, *a))
+      mystl::iter_swap(a, b);
+  }
+}
+
+// 以 *first 为枢轴分割，小于枢轴的元素在左侧，返回枢轴的最终位置，以及分割前区间是否已经分割好
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool>
+pdq_partition_right(RandomIter begin, RandomIter end, Compared comp, m_false_type)
+{
+  auto pivot = mystl::move(*begin);
+  auto first = begin;
+  auto last = end;
+  // 枢轴由三数取中得到，左侧一定能找到不小于枢轴的元素
+  while (comp(*++first, pivot));
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot));
   else
+    while (!comp(*--last, pivot));
+  const bool already_partitioned = first >= last;
+  while (first < last)
+  {
+    mystl::iter_swap(first, last);
+    while (comp(*++first, pivot));
+    while (!comp(*--last, pivot));
+  }
+  auto pivot_pos = first - 1;
+  *begin = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 交换 first + offsets_l[i] 与 last - offsets_r[i]
+// 两侧个数相同时逐对交换，否则用轮换减少一半的移动
+template <class RandomIter>
+void pdq_swap_offsets(RandomIter first, RandomIter last,
+                      const unsigned char* offsets_l, const unsigned char* offsets_r,
+                      size_t num, bool use_swaps)
+{
+  if (use_swaps)
   {
-    mystl::insertion_sort(first, last, comp);
+    for (size_t i = 0; i < num; ++i)
+      mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+  }
+  else if (num > 0)
+  {
+    auto l = first + offsets_l[0];
+    auto r = last - offsets_r[0];
+    auto tmp = mystl::move(*l);
+    *l = mystl::move(*r);
+    for (size_t i = 1; i < num; ++i)
+    {
+      l = first + offsets_l[i];
+      *r = mystl::move(*l);
+      r = last - offsets_r[i];
+      *l = mystl::move(*r);
+    }
+    *r = mystl::move(tmp);
+  }
+}
+
+// 无分支的分块分割：先记录两侧各一块中位置错误的元素的偏移，再成对交换
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool>
+pdq_partition_right(RandomIter begin, RandomIter end, Compared comp, m_true_type)
+{
+  auto pivot = mystl::move(*begin);
+  auto first = begin;
+  auto last = end;
+  while (comp(*++first, pivot));
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot));
+  else
+    while (!comp(*--last, pivot));
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned)
+  {
+    mystl::iter_swap(first, last);
+    ++first;
+
+    alignas(64) unsigned char offsets_l[kPartitionBlockSize];
+    alignas(64) unsigned char offsets_r[kPartitionBlockSize];
+    auto offsets_l_base = first;
+    auto offsets_r_base = last;
+    size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+    while (first < last)
+    {
+      // 决定这一轮两侧各检查多少个元素
+      const size_t num_unknown = static_cast<size_t>(last - first);
+      const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+      const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+      const size_t left_count = left_split < kPartitionBlockSize ? left_split : kPartitionBlockSize;
+      for (size_t i = 0; i < left_count; ++i)
+      {
+        offsets_l[num_l] = static_cast<unsigned char>(i);
+        num_l += !comp(*first, pivot);
+        ++first;
+      }
+      const size_t right_count = right_split < kPartitionBlockSize ? right_split : kPartitionBlockSize;
+      for (size_t i = 0; i < right_count; ++i)
+      {
+        offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+        num_r += comp(*--last, pivot);
+      }
+
+      const size_t num = num_l < num_r ? num_l : num_r;
+      mystl::pdq_swap_offsets(offsets_l_base, offsets_r_base,
+                              offsets_l + start_l, offsets_r + start_r,
+                              num, num_l == num_r);
+      num_l -= num;
+      num_r -= num;
+      start_l += num;
+      start_r += num;
+      if (num_l == 0)
+      {
+        start_l = 0;
+        offsets_l_base = first;
+      }
+      if (num_r == 0)
+      {
+        start_r = 0;
+        offsets_r_base = last;
+      }
+    }
+    // 处理剩余的一侧
+    if (num_l)
+    {
+      const unsigned char* offsets = offsets_l + start_l;
+      while (num_l--)
+        mystl::iter_swap(offsets_l_base + offsets[num_l], --last);
+      first = last;
+    }
+    if (num_r)
+    {
+      const unsigned char* offsets = offsets_r + start_r;
+      while (num_r--)
+      {
+        mystl::iter_swap(offsets_r_base - offsets[num_r], first);
+        ++first;
+      }
+      last = first;
+    }
+  }
+  auto pivot_pos = first - 1;
+  *begin = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 以 *first 为枢轴分割，不大于枢轴的元素在左侧，返回枢轴的最终位置
+// 用于枢轴与区间左侧相邻元素相等的情况，此时左侧的元素全部与枢轴相等
+template <class RandomIter, class Compared>
+RandomIter pdq_partition_left(RandomIter begin, RandomIter end, Compared comp)
+{
+  auto pivot = mystl::move(*begin);
+  auto first = begin;
+  auto last = end;
+  while (comp(pivot, *--last));
+  if (last + 1 == end)
+    while (first < last && !comp(pivot, *++first));
+  else
+    while (!comp(pivot, *++first));
+  while (first < last)
+  {
+    mystl::iter_swap(first, last);
+    while (comp(pivot, *--last));
+    while (!comp(pivot, *++first));
+  }
+  auto pivot_pos = last;
+  *begin = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return pivot_pos;
+}
+
+// 分割不均衡时交换部分元素，打破导致分割恶化的模式
+template <class RandomIter>
+void pdq_break_patterns(RandomIter first, RandomIter last)
+{
+  const size_t size = static_cast<size_t>(last - first);
+  if (size < kInsertionSortThreshold)
+    return;
+  const size_t q = size / 4;
+  mystl::iter_swap(first, first + q);
+  mystl::iter_swap(last - 1, last - q);
+  if (size > kNintherThreshold)
+  {
+    mystl::iter_swap(first + 1, first + (q + 1));
+    mystl::iter_swap(first + 2, first + (q + 2));
+    mystl::iter_swap(last - 2, last - (q + 1));
+    mystl::iter_swap(last - 3, last - (q + 2));
+  }
+}
+
+// 内省式排序的主循环，bad_allowed 为允许的不均衡分割次数，leftmost 表示区间左侧没有其它元素
+template <class RandomIter, class Compared, class Branchless>
+void intro_sort(RandomIter first, RandomIter last, Compared comp,
+                size_t bad_allowed, bool leftmost, Branchless branchless)
+{
+  while (true)
+  {
+    const size_t size = static_cast<size_t>(last - first);
+    if (size < kInsertionSortThreshold)
+    {
+      if (leftmost)
+        mystl::pdq_insertion_sort(first, last, comp);
+      else
+        mystl::pdq_unguarded_insertion_sort(first, last, comp);
+      return;
+    }
+
+    // 选取枢轴并放到 *first
+    const size_t half = size / 2;
+    if (size > kNintherThreshold)
+    {
+      mystl::pdq_sort3(first, first + half, last - 1, comp);
+      mystl::pdq_sort3(first + 1, first + (half - 1), last - 2, comp);
+      mystl::pdq_sort3(first + 2, first + (half + 1), last - 3, comp);
+      mystl::pdq_sort3(first + (half - 1), first + half, first + (half + 1), comp);
+      mystl::iter_swap(first, first + half);
+    }
+    else
+    {
+      mystl::pdq_sort3(first + half, first, last - 1, comp);
+    }
+
+    // *(first - 1) 不大于区间内的任何元素，如果它与枢轴相等，左侧分出的元素都与枢轴相等，不需要再排序
+    if (!leftmost && !comp(*(first - 1), *first))
+    {
+      first = mystl::pdq_partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    auto result = mystl::pdq_partition_right(first, last, comp, branchless);
+    auto pivot_pos = result.first;
+    const size_t l_size = static_cast<size_t>(pivot_pos - first);
+    const size_t r_size = static_cast<size_t>(last - (pivot_pos + 1));
+    if (l_size < size / 8 || r_size < size / 8)
+    {
+      if (--bad_allowed == 0)
+      { // 不均衡的分割太多，改用 heap sort
+        mystl::partial_sort(first, last, last, comp);
+        return;
+      }
+      mystl::pdq_break_patterns(first, pivot_pos);
+      mystl::pdq_break_patterns(pivot_pos + 1, last);
+    }
+    else if (result.second &&
+             mystl::pdq_partial_insertion_sort(first, pivot_pos, comp) &&
+             mystl::pdq_partial_insertion_sort(pivot_pos + 1, last, comp))
+    { // 分割前已经分割好，且两侧都接近有序
+      return;
+    }
+
+    // 递归排序左侧，循环处理右侧
+    mystl::intro_sort(first, pivot_pos, comp, bad_allowed, leftmost, branchless);
+    first = pivot_pos + 1;
+    leftmost = false;
   }
 }
 
 template <class RandomIter, class Compared>
 void sort(RandomIter first, RandomIter last, Compared comp)
 {
-  if (first != last)
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  if (last - first > 1)
+  {
+    mystl::intro_sort(first, last, comp, slg2(static_cast<size_t>(last - first)), true,
+                      m_bool_constant<std::is_arithmetic<value_type>::value &&
+                                      pdq_is_default_compare<Compared, value_type>::value>());
+  }
+}
+
+#ifdef MYSTL_SORT_USE_RADIX
+template <class RandomIter>
+bool radix_sort_dispatch(RandomIter first, RandomIter last);
+#endif
+
+// 定义 MYSTL_SORT_USE_RADIX 后，较长的整数、浮点数区间使用基数排序
+template <class RandomIter>
+void sort(RandomIter first, RandomIter last)
+{
+#ifdef MYSTL_SORT_USE_RADIX
+  if (mystl::radix_sort_dispatch(first, last))
+    return;
+#endif
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::sort(first, last, mystl::less<value_type>());
+}
+
+/*****************************************************************************************/
+// stable_sort
+// 将[first, last)内的元素以递增的方式排序，相等元素的相对位置不变
+// 采用类似 TimSort 的归并排序：
+// 1. 找出已经有序的段 (严格递减的段先反转)，不足 min_run 的用二分插入排序补齐
+// 2. 按照段长度的约束合并相邻的段，合并前先跳过两端已经在最终位置上的元素
+// 3. 合并时某一侧连续胜出 min_gallop 次后改用指数查找成块移动 (galloping)
+// 4. 缓冲区不足时改用 merge_adaptive 分割合并，没有缓冲区时原地合并
+/*****************************************************************************************/
+constexpr static ptrdiff_t kStableMinMerge  = 64;  // 短于这个长度的区间直接用二分插入排序
+constexpr static size_t    kStableMinGallop = 7;   // 进入 galloping 模式的初始阈值
+constexpr static size_t    kStableMaxRuns   = 85;  // 待合并段的最大数目，足以容纳 2^64 个元素
+
+// 二分插入排序，[first, sorted) 已经有序
+template <class RandomIter, class Compared>
+void binary_insertion_sort(RandomIter first, RandomIter sorted, RandomIter last, Compared comp)
+{
+  for (; sorted != last; ++sorted)
+  {
+    auto pos = mystl::upper_bound(first, sorted, *sorted, comp);
+    if (pos != sorted)
+    {
+      auto tmp = mystl::move(*sorted);
+      mystl::move_backward(pos, sorted, sorted + 1);
+      *pos = mystl::move(tmp);
+    }
+  }
+}
+
+// 返回从 first 开始的有序段的尾部，严格递减的段会被反转
+template <class RandomIter, class Compared>
+RandomIter stable_count_run(RandomIter first, RandomIter last, Compared comp)
+{
+  auto run_end = first + 1;
+  if (run_end == last)
+    return run_end;
+  if (comp(*run_end, *first))
+  {
+    ++run_end;
+    while (run_end != last && comp(*run_end, *(run_end - 1)))
+      ++run_end;
+    mystl::reverse(first, run_end);
+  }
+  else
+  {
+    ++run_end;
+    while (run_end != last && !comp(*run_end, *(run_end - 1)))
+      ++run_end;
+  }
+  return run_end;
+}
+
+// 计算有序段的最短长度，使段的数目接近 2 的幂
+inline ptrdiff_t stable_min_run(ptrdiff_t n)
+{
+  ptrdiff_t r = 0;
+  while (n >= kStableMinMerge)
+  {
+    r |= n & 1;
+    n >>= 1;
+  }
+  return n + r;
+}
+
+// 从前向后指数查找，返回 upper_bound / lower_bound
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_upper(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  const ptrdiff_t len = last - first;
+  ptrdiff_t lo = 0, hi = 1;
+  while (hi <= len && !comp(value, first[hi - 1]))
   {
-    // 内省式排序，将区间分为一个个小区间，然后对整体进行插入排序
-    mystl::intro_sort(first, last, slg2(last - first) * 2, comp);
-    mystl::final_insertion_sort(first, last, comp);
+    lo = hi;
+    hi = hi * 2 + 1;
   }
+  return mystl::upper_bound(first + lo, first + (hi < len ? hi : len), value, comp);
+}
+
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_lower(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  const ptrdiff_t len = last - first;
+  ptrdiff_t lo = 0, hi = 1;
+  while (hi <= len && comp(first[hi - 1], value))
+  {
+    lo = hi;
+    hi = hi * 2 + 1;
+  }
+  return mystl::lower_bound(first + lo, first + (hi < len ? hi : len), value, comp);
+}
+
+// 从后向前指数查找，返回 upper_bound / lower_bound
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_upper_back(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  const ptrdiff_t len = last - first;
+  ptrdiff_t lo = 0, hi = 1;
+  while (hi <= len && comp(value, *(last - hi)))
+  {
+    lo = hi;
+    hi = hi * 2 + 1;
+  }
+  return mystl::upper_bound(last - (hi < len ? hi : len), last - lo, value, comp);
+}
+
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_lower_back(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  const ptrdiff_t len = last - first;
+  ptrdiff_t lo = 0, hi = 1;
+  while (hi <= len && !comp(*(last - hi), value))
+  {
+    lo = hi;
+    hi = hi * 2 + 1;
+  }
+  return mystl::lower_bound(last - (hi < len ? hi : len), last - lo, value, comp);
+}
+
+// [first, middle) 较短，把它移到缓冲区后从前向后合并
+template <class RandomIter, class Pointer, class Compared>
+void stable_merge_lo(RandomIter first, RandomIter middle, RandomIter last,
+                     Pointer buffer, size_t& min_gallop, Compared comp)
+{
+  Pointer cur1 = buffer;
+  Pointer last1 = mystl::move(first, middle, buffer);
+  RandomIter cur2 = middle;
+  RandomIter result = first;
+  bool done = false;
+  while (!done)
+  {
+    size_t count1 = 0, count2 = 0;
+    // 逐个比较，直到某一侧连续胜出 min_gallop 次
+    while (true)
+    {
+      if (comp(*cur2, *cur1))
+      {
+        *result++ = mystl::move(*cur2++);
+        count1 = 0;
+        if (cur2 == last)
+        {
+          done = true;
+          break;
+        }
+        if (++count2 >= min_gallop)
+          break;
+      }
+      else
+      {
+        *result++ = mystl::move(*cur1++);
+        count2 = 0;
+        if (cur1 == last1)
+        {
+          done = true;
+          break;
+        }
+        if (++count1 >= min_gallop)
+          break;
+      }
+    }
+    // galloping 模式，成块移动不大于 *cur2 的左侧元素 和 小于 *cur1 的右侧元素
+    while (!done)
+    {
+      auto pos1 = mystl::gallop_upper(cur1, last1, *cur2, comp);
+      count1 = static_cast<size_t>(pos1 - cur1);
+      result = mystl::move(cur1, pos1, result);
+      cur1 = pos1;
+      if (cur1 == last1)
+        break;
+      *result++ = mystl::move(*cur2++);
+      if (cur2 == last)
+        break;
+      auto pos2 = mystl::gallop_lower(cur2, last, *cur1, comp);
+      count2 = static_cast<size_t>(pos2 - cur2);
+      result = mystl::move(cur2, pos2, result);
+      cur2 = pos2;
+      if (cur2 == last)
+        break;
+      *result++ = mystl::move(*cur1++);
+      if (cur1 == last1)
+        break;
+      if (min_gallop > 1)
+        --min_gallop;
+      if (count1 < kStableMinGallop && count2 < kStableMinGallop)
+      { // galloping 收益不大，回到逐个比较
+        min_gallop += 2;
+        break;
+      }
+    }
+    done = done || cur1 == last1 || cur2 == last;
+  }
+  // 右侧剩余的元素已经在最终位置上
+  mystl::move(cur1, last1, result);
+}
+
+// [middle, last) 较短，把它移到缓冲区后从后向前合并
+template <class RandomIter, class Pointer, class Compared>
+void stable_merge_hi(RandomIter first, RandomIter middle, RandomIter last,
+                     Pointer buffer, size_t& min_gallop, Compared comp)
+{
+  Pointer first2 = buffer;
+  Pointer cur2 = mystl::move(middle, last, buffer);
+  RandomIter cur1 = middle;
+  RandomIter result = last;
+  bool done = false;
+  while (!done)
+  {
+    size_t count1 = 0, count2 = 0;
+    while (true)
+    {
+      if (comp(*(cur2 - 1), *(cur1 - 1)))
+      {
+        *--result = mystl::move(*--cur1);
+        count2 = 0;
+        if (cur1 == first)
+        {
+          done = true;
+          break;
+        }
+        if (++count1 >= min_gallop)
+          break;
+      }
+      else
+      {
+        *--result = mystl::move(*--cur2);
+        count1 = 0;
+        if (cur2 == first2)
+        {
+          done = true;
+          break;
+        }
+        if (++count2 >= min_gallop)
+          break;
+      }
+    }
+    // galloping 模式，成块移动大于右侧末尾的左侧元素 和 不小于左侧末尾的右侧元素
+    while (!done)
+    {
+      auto pos1 = mystl::gallop_upper_back(first, cur1, *(cur2 - 1), comp);
+      count1 = static_cast<size_t>(cur1 - pos1);
+      result = mystl::move_backward(pos1, cur1, result);
+      cur1 = pos1;
+      if (cur1 == first)
+        break;
+      *--result = mystl::move(*--cur2);
+      if (cur2 == first2)
+        break;
+      auto pos2 = mystl::gallop_lower_back(first2, cur2, *(cur1 - 1), comp);
+      count2 = static_cast<size_t>(cur2 - pos2);
+      result = mystl::move_backward(pos2, cur2, result);
+      cur2 = pos2;
+      if (cur2 == first2)
+        break;
+      *--result = mystl::move(*--cur1);
+      if (cur1 == first)
+        break;
+      if (min_gallop > 1)
+        --min_gallop;
+      if (count1 < kStableMinGallop && count2 < kStableMinGallop)
+      {
+        min_gallop += 2;
+        break;
+      }
+    }
+    done = done || cur1 == first || cur2 == first2;
+  }
+  // 左侧剩余的元素已经在最终位置上
+  mystl::move_backward(first2, cur2, result);
+}
+
+// 合并相邻的有序段 [first, middle) 与 [middle, last)
+template <class RandomIter, class Pointer, class Compared>
+void stable_merge(RandomIter first, RandomIter middle, RandomIter last,
+                  Pointer buffer, ptrdiff_t buffer_size, size_t& min_gallop, Compared comp)
+{
+  // 左侧不大于 *middle 的元素与右侧不小于 *(middle - 1) 的元素已经在最终位置上
+  first = mystl::gallop_upper(first, middle, *middle, comp);
+  if (first == middle)
+    return;
+  last = mystl::gallop_lower_back(middle, last, *(middle - 1), comp);
+  if (middle == last)
+    return;
+  const ptrdiff_t len1 = middle - first;
+  const ptrdiff_t len2 = last - middle;
+  if (len1 <= len2 && len1 <= buffer_size)
+    mystl::stable_merge_lo(first, middle, last, buffer, min_gallop, comp);
+  else if (len2 <= buffer_size)
+    mystl::stable_merge_hi(first, middle, last, buffer, min_gallop, comp);
+  else if (buffer_size > 0)
+    mystl::merge_adaptive(first, middle, last, len1, len2, buffer, buffer_size, comp);
+  else
+    mystl::merge_without_buffer(first, middle, last, len1, len2, comp);
+}
+
+template <class RandomIter, class Pointer, class Compared>
+void stable_sort_aux(RandomIter first, RandomIter last,
+                     Pointer buffer, ptrdiff_t buffer_size, Compared comp)
+{
+  const ptrdiff_t n = last - first;
+  if (n < kStableMinMerge)
+  {
+    mystl::binary_insertion_sort(first, mystl::stable_count_run(first, last, comp), last, comp);
+    return;
+  }
+  const ptrdiff_t min_run = mystl::stable_min_run(n);
+  ptrdiff_t run_base[kStableMaxRuns];
+  ptrdiff_t run_len[kStableMaxRuns];
+  size_t runs = 0;
+  size_t min_gallop = kStableMinGallop;
+
+  // 合并栈中第 i 与第 i + 1 个段
+  auto merge_at = [&](size_t i)
+  {
+    mystl::stable_merge(first + run_base[i], first + run_base[i + 1],
+                        first + run_base[i + 1] + run_len[i + 1],
+                        buffer, buffer_size, min_gallop, comp);
+    run_len[i] += run_len[i + 1];
+    if (i + 3 == runs)
+    {
+      run_base[i + 1] = run_base[i + 2];
+      run_len[i + 1] = run_len[i + 2];
+    }
+    --runs;
+  };
+
+  auto cur = first;
+  while (cur != last)
+  {
+    auto run_end = mystl::stable_count_run(cur, last, comp);
+    if (run_end - cur < min_run)
+    { // 用二分插入排序把有序段延长到 min_run
+      auto force_end = last - cur < min_run ? last : cur + min_run;
+      mystl::binary_insertion_sort(cur, run_end, force_end, comp);
+      run_end = force_end;
+    }
+    run_base[runs] = cur - first;
+    run_len[runs] = run_end - cur;
+    ++runs;
+    cur = run_end;
+
+    // 保持 len[i - 2] > len[i - 1] + len[i], len[i - 1] > len[i]
+    while (runs > 1)
+    {
+      size_t k = runs - 2;
+      if ((k > 0 && run_len[k - 1] <= run_len[k] + run_len[k + 1]) ||
+          (k > 1 && run_len[k - 2] <= run_len[k - 1] + run_len[k]))
+      {
+        if (run_len[k - 1] < run_len[k + 1])
+          --k;
+      }
+      else if (run_len[k] > run_len[k + 1])
+      {
+        break;
+      }
+      merge_at(k);
+    }
+  }
+  while (runs > 1)
+  {
+    size_t k = runs - 2;
+    if (k > 0 && run_len[k - 1] < run_len[k + 1])
+      --k;
+    merge_at(k);
+  }
+}
+
+template <class RandomIter, class Compared>
+void stable_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  const ptrdiff_t n = last - first;
+  if (n < 2)
+    return;
+  if (n < kStableMinMerge)
+  {
+    mystl::stable_sort_aux(first, last, static_cast<value_type*>(nullptr), 0, comp);
+    return;
+  }
+  // 合并时缓冲区只需要容纳较短的一侧
+  temporary_buffer<RandomIter, value_type> buf(first, first + (n + 1) / 2);
+  mystl::stable_sort_aux(first, last, buf.begin(), buf.size(), comp);
+}
+
+template <class RandomIter>
+void stable_sort(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::stable_sort(first, last, mystl::less<value_type>());
+}
+
+/*****************************************************************************************/
+// radix_sort
+// 以 8 位为一个数位的 LSD 基数排序，按 key 递增排序，适用于整数与浮点数键
+// 重载版本使用 key 从元素中提取键，并可以提供与区间等长的缓冲区 [buffer, buffer + n)
+// 缓冲区中的元素需要已经构造，排序结束后处于有效但未指定的状态
+// 排序是稳定的，无法取得足够大的临时缓冲区时退化为 stable_sort
+/*****************************************************************************************/
+constexpr static size_t kRadixSortThreshold = 1024;  // sort 对不小于这个长度的区间改用基数排序
+
+// radix_key_traits : 把键映射为无符号整数，使无符号整数的大小顺序与键的大小顺序一致
+template <class T,
+  bool = std::is_integral<T>::value,
+  bool = std::is_floating_point<T>::value &&
+         (sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t))>
+struct radix_key_traits : m_false_type {};
+
+// 整数：有符号数翻转符号位
+template <class T>
+struct radix_key_traits<T, true, false> : m_true_type
+{
+  typedef typename std::make_unsigned<typename std::conditional<
+    std::is_same<T, bool>::value, unsigned char, T>::type>::type unsigned_type;
+
+  static unsigned_type encode(T value) noexcept
+  {
+    return std::is_signed<T>::value
+      ? static_cast<unsigned_type>(static_cast<unsigned_type>(value) ^
+                                   (static_cast<unsigned_type>(1) << (sizeof(T) * 8 - 1)))
+      : static_cast<unsigned_type>(value);
+  }
+};
+
+// 浮点数：正数翻转符号位，负数翻转所有位
+template <class T>
+struct radix_key_traits<T, false, true> : m_true_type
+{
+  typedef typename std::conditional<sizeof(T) == sizeof(uint32_t),
+    uint32_t, uint64_t>::type unsigned_type;
+
+  static unsigned_type encode(T value) noexcept
+  {
+    unsigned_type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const unsigned_type sign = static_cast<unsigned_type>(1) << (sizeof(bits) * 8 - 1);
+    return bits & sign ? ~bits : bits ^ sign;
+  }
+};
+
+// 提取元素本身作为键
+struct radix_identity
+{
+  template <class T>
+  const T& operator()(const T& value) const noexcept { return value; }
+};
+
+// 按 offset 把 [first, last) 分配到 result 中
+template <class InputIter, class OutputIter, class KeyFn>
+void radix_scatter(InputIter first, InputIter last, OutputIter result,
+                   size_t* offset, size_t shift, KeyFn& key)
+{
+  typedef typename std::decay<decltype(key(*first))>::type key_type;
+  for (; first != last; ++first)
+  {
+    const size_t digit = static_cast<size_t>(
+      radix_key_traits<key_type>::encode(key(*first)) >> shift) & 0xff;
+    result[offset[digit]++] = mystl::move(*first);
+  }
+}
+
+template <class RandomIter, class T, class KeyFn>
+void radix_sort_aux(RandomIter first, RandomIter last, T* buffer, KeyFn key)
+{
+  typedef typename std::decay<decltype(key(*first))>::type key_type;
+  typedef radix_key_traits<key_type>                       traits;
+  typedef typename traits::unsigned_type                   unsigned_type;
+  static_assert(traits::value, "radix_sort requires integral or floating point keys");
+  constexpr size_t digits = sizeof(unsigned_type);
+
+  const size_t n = static_cast<size_t>(last - first);
+  // 一次遍历统计所有数位的分布
+  size_t count[digits][256] = {};
+  for (auto it = first; it != last; ++it)
+  {
+    unsigned_type u = traits::encode(key(*it));
+    for (size_t d = 0; d < digits; ++d)
+    {
+      ++count[d][u & 0xff];
+      u = static_cast<unsigned_type>(u >> 8);
+    }
+  }
+  bool in_buffer = false;
+  for (size_t d = 0; d < digits; ++d)
+  {
+    size_t* offset = count[d];
+    size_t sum = 0;
+    bool skip = false;
+    for (size_t i = 0; i < 256; ++i)
+    {
+      if (offset[i] == n)
+      { // 所有元素在这一位上相同
+        skip = true;
+        break;
+      }
+      const size_t c = offset[i];
+      offset[i] = sum;
+      sum += c;
+    }
+    if (skip)
+      continue;
+    if (in_buffer)
+      mystl::radix_scatter(buffer, buffer + n, first, offset, d * 8, key);
+    else
+      mystl::radix_scatter(first, last, buffer, offset, d * 8, key);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer)
+    mystl::move(buffer, buffer + n, first);
+}
+
+template <class RandomIter, class KeyFn>
+void radix_sort(RandomIter first, RandomIter last, KeyFn key)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  if (last - first < 2)
+    return;
+  temporary_buffer<RandomIter, value_type> buf(first, last);
+  if (buf.size() == last - first)
+  {
+    mystl::radix_sort_aux(first, last, buf.begin(), key);
+  }
+  else
+  {
+    mystl::stable_sort(first, last, [&key](const value_type& a, const value_type& b)
+    {
+      typedef typename std::decay<decltype(key(a))>::type key_type;
+      return radix_key_traits<key_type>::encode(key(a)) < radix_key_traits<key_type>::encode(key(b));
+    });
+  }
+}
+
+template <class RandomIter, class KeyFn>
+void radix_sort(RandomIter first, RandomIter last,
+                typename iterator_traits<RandomIter>::value_type* buffer, KeyFn key)
+{
+  if (last - first < 2)
+    return;
+  mystl::radix_sort_aux(first, last, buffer, key);
+}
+
+template <class RandomIter>
+void radix_sort(RandomIter first, RandomIter last)
+{
+  mystl::radix_sort(first, last, radix_identity());
+}
+
+// sort 的基数排序分派，只处理算术类型的元素
+template <class RandomIter>
+bool radix_sort_dispatch(RandomIter first, RandomIter last, m_true_type)
+{
+  if (static_cast<size_t>(last - first) < kRadixSortThreshold)
+    return false;
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  temporary_buffer<RandomIter, value_type> buf(first, last);
+  if (buf.size() != last - first)
+    return false;
+  mystl::radix_sort_aux(first, last, buf.begin(), radix_identity());
+  return true;
+}
+
+template <class RandomIter>
+bool radix_sort_dispatch(RandomIter, RandomIter, m_false_type)
+{
+  return false;
+}
+
+template <class RandomIter>
+bool radix_sort_dispatch(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  return mystl::radix_sort_dispatch(first, last,
+    m_bool_constant<radix_key_traits<value_type>::value>());
 }
 
 /*****************************************************************************************/
@@ -2613,7 +3710,7 @@ void nth_element(RandomIter first, RandomIter nth,
   {
     auto cut = mystl::unchecked_partition(first, last, mystl::median(*first, 
 										  *(first + (last - first) / 2),
-										  *(last - 1)), comp);
+										  *(last - 1), comp), comp);
     if (cut <= nth)  // 如果 nth 位于右段
       first = cut;   // 对右段进行分割
     else
@@ -7,6 +7,7 @@
 
 #include "iterator.h"
 #include "util.h"
+#include "simd.h"
 
 namespace mystl
 {
@@ -65,6 +66,181 @@ void iter_swap(FIter1 lhs, FIter2 rhs)
   mystl::swap(*lhs, *rhs);
 }
 
+/*****************************************************************************************/
+// segmented_copy / segmented_copy_backward
+// 以 op 在 [first, last) 与 result 之间按段复制，op 为 unchecked_copy 等逐元素版本的包装
+// 源或目的为分段迭代器（如 deque 的迭代器）时，把区间切成若干个段内的指针区间交给 op，
+// 平凡类型由此在每段上退化为一次 memmove，而不是逐个元素地跨缓冲区前进
+/*****************************************************************************************/
+// 源与目的都不分段
+template <class InputIter, class OutputIter, class Op>
+OutputIter
+segmented_copy_dispatch(InputIter first, InputIter last, OutputIter result, Op op,
+                        m_false_type, m_false_type)
+{
+  return op(first, last, result);
+}
+
+// 目的分段：源不能随机访问时无法预先切段，逐个元素进行
+template <class InputIter, class OutputIter, class Op>
+OutputIter
+segmented_copy_out(InputIter first, InputIter last, OutputIter result, Op op,
+                   mystl::input_iterator_tag)
+{
+  return op(first, last, result);
+}
+
+// 目的分段：按目的段的剩余空间切分源区间
+template <class RandomIter, class OutputIter, class Op>
+OutputIter
+segmented_copy_out(RandomIter first, RandomIter last, OutputIter result, Op op,
+                   mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<OutputIter> traits;
+  typedef typename iterator_traits<RandomIter>::difference_type diff_type;
+  for (diff_type n = last - first; n > 0;)
+  {
+    const auto local = traits::local(result);
+    const auto m = mystl::min(n, static_cast<diff_type>(traits::end(traits::segment(result)) - local));
+    op(first, first + m, local);
+    first += m;
+    n -= m;
+    result += m;
+  }
+  return result;
+}
+
+template <class InputIter, class OutputIter, class Op>
+OutputIter
+segmented_copy_dispatch(InputIter first, InputIter last, OutputIter result, Op op,
+                        m_false_type, m_true_type)
+{
+  return mystl::segmented_copy_out(first, last, result, op, iterator_category(first));
+}
+
+// 源分段：逐段取出指针区间，再按目的是否分段处理
+template <class SegIter, class OutputIter, class Op, class OutSegmented>
+OutputIter
+segmented_copy_dispatch(SegIter first, SegIter last, OutputIter result, Op op,
+                        m_true_type, OutSegmented out)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    return mystl::segmented_copy_dispatch(traits::local(first), traits::local(last),
+                                          result, op, m_false_type(), out);
+  }
+  result = mystl::segmented_copy_dispatch(traits::local(first), traits::end(sfirst),
+                                          result, op, m_false_type(), out);
+  for (++sfirst; sfirst != slast; ++sfirst)
+  {
+    result = mystl::segmented_copy_dispatch(traits::begin(sfirst), traits::end(sfirst),
+                                            result, op, m_false_type(), out);
+  }
+  return mystl::segmented_copy_dispatch(traits::begin(slast), traits::local(last),
+                                        result, op, m_false_type(), out);
+}
+
+template <class InputIter, class OutputIter, class Op>
+OutputIter segmented_copy(InputIter first, InputIter last, OutputIter result, Op op)
+{
+  return mystl::segmented_copy_dispatch(first, last, result, op,
+                                        is_segmented_iterator<InputIter>(),
+                                        is_segmented_iterator<OutputIter>());
+}
+
+// 以下为 segmented_copy_backward，result 指向目的区间的尾部，按从后往前的顺序进行
+template <class BidirectionalIter1, class BidirectionalIter2, class Op>
+BidirectionalIter2
+segmented_copy_backward_dispatch(BidirectionalIter1 first, BidirectionalIter1 last,
+                                 BidirectionalIter2 result, Op op,
+                                 m_false_type, m_false_type)
+{
+  return op(first, last, result);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2, class Op>
+BidirectionalIter2
+segmented_copy_backward_out(BidirectionalIter1 first, BidirectionalIter1 last,
+                            BidirectionalIter2 result, Op op,
+                            mystl::bidirectional_iterator_tag)
+{
+  return op(first, last, result);
+}
+
+template <class RandomIter, class BidirectionalIter2, class Op>
+BidirectionalIter2
+segmented_copy_backward_out(RandomIter first, RandomIter last,
+                            BidirectionalIter2 result, Op op,
+                            mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<BidirectionalIter2> traits;
+  typedef typename iterator_traits<RandomIter>::difference_type diff_type;
+  for (diff_type n = last - first; n > 0;)
+  {
+    auto seg = traits::segment(result);
+    auto local = traits::local(result);
+    if (local == traits::begin(seg))
+    { // result 位于段首时，写入的是前一段的尾部
+      --seg;
+      local = traits::end(seg);
+    }
+    const auto m = mystl::min(n, static_cast<diff_type>(local - traits::begin(seg)));
+    op(last - m, last, local);
+    last -= m;
+    n -= m;
+    result = traits::compose(seg, local - m);
+  }
+  return result;
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2, class Op>
+BidirectionalIter2
+segmented_copy_backward_dispatch(BidirectionalIter1 first, BidirectionalIter1 last,
+                                 BidirectionalIter2 result, Op op,
+                                 m_false_type, m_true_type)
+{
+  return mystl::segmented_copy_backward_out(first, last, result, op,
+                                            iterator_category(first));
+}
+
+template <class SegIter, class BidirectionalIter2, class Op, class OutSegmented>
+BidirectionalIter2
+segmented_copy_backward_dispatch(SegIter first, SegIter last,
+                                 BidirectionalIter2 result, Op op,
+                                 m_true_type, OutSegmented out)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  const auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    return mystl::segmented_copy_backward_dispatch(traits::local(first), traits::local(last),
+                                                   result, op, m_false_type(), out);
+  }
+  result = mystl::segmented_copy_backward_dispatch(traits::begin(slast), traits::local(last),
+                                                   result, op, m_false_type(), out);
+  for (--slast; slast != sfirst; --slast)
+  {
+    result = mystl::segmented_copy_backward_dispatch(traits::begin(slast), traits::end(slast),
+                                                     result, op, m_false_type(), out);
+  }
+  return mystl::segmented_copy_backward_dispatch(traits::local(first), traits::end(sfirst),
+                                                 result, op, m_false_type(), out);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2, class Op>
+BidirectionalIter2
+segmented_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                        BidirectionalIter2 result, Op op)
+{
+  return mystl::segmented_copy_backward_dispatch(first, last, result, op,
+                                                 is_segmented_iterator<BidirectionalIter1>(),
+                                                 is_segmented_iterator<BidirectionalIter2>());
+}
+
 /*****************************************************************************************/
 // copy
 // 把 [first, last)区间内的元素拷贝到 [result, result + (last - first))内
@@ -118,10 +294,19 @@ unchecked_copy(Tp* first, Tp* last, Up* result)
   return result + n;
 }
 
+struct unchecked_copy_fn
+{
+  template <class InputIter, class OutputIter>
+  OutputIter operator()(InputIter first, InputIter last, OutputIter result) const
+  {
+    return mystl::unchecked_copy(first, last, result);
+  }
+};
+
 template <class InputIter, class OutputIter>
 OutputIter copy(InputIter first, InputIter last, OutputIter result)
 {
-  return unchecked_copy(first, last, result);
+  return mystl::segmented_copy(first, last, result, unchecked_copy_fn());
 }
 
 /*****************************************************************************************/
@@ -176,11 +361,21 @@ unchecked_copy_backward(Tp* first, Tp* last, Up* result)
   return result;
 }
 
+struct unchecked_copy_backward_fn
+{
+  template <class BidirectionalIter1, class BidirectionalIter2>
+  BidirectionalIter2
+  operator()(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result) const
+  {
+    return mystl::unchecked_copy_backward(first, last, result);
+  }
+};
+
 template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2 
 copy_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result)
 {
-  return unchecked_copy_backward(first, last, result);
+  return mystl::segmented_copy_backward(first, last, result, unchecked_copy_backward_fn());
 }
 
 /*****************************************************************************************/
@@ -283,10 +478,19 @@ unchecked_move(Tp* first, Tp* last, Up* result)
   return result + n;
 }
 
+struct unchecked_move_fn
+{
+  template <class InputIter, class OutputIter>
+  OutputIter operator()(InputIter first, InputIter last, OutputIter result) const
+  {
+    return mystl::unchecked_move(first, last, result);
+  }
+};
+
 template <class InputIter, class OutputIter>
 OutputIter move(InputIter first, InputIter last, OutputIter result)
 {
-  return unchecked_move(first, last, result);
+  return mystl::segmented_copy(first, last, result, unchecked_move_fn());
 }
 
 /*****************************************************************************************/
@@ -341,19 +545,30 @@ unchecked_move_backward(Tp* first, Tp* last, Up* result)
   return result;
 }
 
+struct unchecked_move_backward_fn
+{
+  template <class BidirectionalIter1, class BidirectionalIter2>
+  BidirectionalIter2
+  operator()(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result) const
+  {
+    return mystl::unchecked_move_backward(first, last, result);
+  }
+};
+
 template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2
 move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result)
 {
-  return unchecked_move_backward(first, last, result);
+  return mystl::segmented_copy_backward(first, last, result, unchecked_move_backward_fn());
 }
 
 /*****************************************************************************************/
 // equal
 // 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
+// 两个序列都是同一种整数或浮点数的数组时，使用 simd.h 中的 equal_elems
 /*****************************************************************************************/
 template <class InputIter1, class InputIter2>
-bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+bool equal_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, m_false_type)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
@@ -363,6 +578,20 @@ bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
   return true;
 }
 
+template <class T, class U>
+bool equal_dispatch(T* first1, T* last1, U* first2, m_true_type)
+{
+  return simd::equal_elems<typename std::remove_cv<T>::type>(
+    first1, first2, static_cast<size_t>(last1 - first1));
+}
+
+template <class InputIter1, class InputIter2>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+  return mystl::equal_dispatch(first1, last1, first2,
+    m_bool_constant<simd::is_compare_range<InputIter1, InputIter2>::value>());
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compared>
 bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compared comp)
@@ -405,10 +634,33 @@ unchecked_fill_n(Tp* first, Size n, Up value)
   return first + n;
 }
 
+template <class OutputIter, class Size, class T>
+OutputIter fill_n_dispatch(OutputIter first, Size n, const T& value, m_false_type)
+{
+  return mystl::unchecked_fill_n(first, n, value);
+}
+
+// 分段迭代器逐段填充，每段是一个指针区间
+template <class SegIter, class Size, class T>
+SegIter fill_n_dispatch(SegIter first, Size n, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  typedef typename iterator_traits<SegIter>::difference_type diff_type;
+  for (auto len = static_cast<diff_type>(n); len > 0;)
+  {
+    const auto local = traits::local(first);
+    const auto m = mystl::min(len, static_cast<diff_type>(traits::end(traits::segment(first)) - local));
+    mystl::unchecked_fill_n(local, m, value);
+    len -= m;
+    first += m;
+  }
+  return first;
+}
+
 template <class OutputIter, class Size, class T>
 OutputIter fill_n(OutputIter first, Size n, const T& value)
 {
-  return unchecked_fill_n(first, n, value);
+  return mystl::fill_n_dispatch(first, n, value, is_segmented_iterator<OutputIter>());
 }
 
 /*****************************************************************************************/
@@ -429,7 +681,7 @@ template <class RandomIter, class T>
 void fill_cat(RandomIter first, RandomIter last, const T& value,
               mystl::random_access_iterator_tag)
 {
-  fill_n(first, last - first, value);
+  mystl::fill_n(first, last - first, value);
 }
 
 template <class ForwardIter, class T>
@@ -445,10 +697,11 @@ void fill(ForwardIter first, ForwardIter last, const T& value)
 // (2)如果到达 last1 而尚未到达 last2 返回 true
 // (3)如果到达 last2 而尚未到达 last1 返回 false
 // (4)如果同时到达 last1 和 last2 返回 false
+// 两个序列都是同一种整数或浮点数的数组时，以 simd.h 中的 mismatch 跳过相等的部分
 /*****************************************************************************************/
 template <class InputIter1, class InputIter2>
-bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
-                             InputIter2 first2, InputIter2 last2)
+bool lexicographical_compare_dispatch(InputIter1 first1, InputIter1 last1,
+                                      InputIter2 first2, InputIter2 last2, m_false_type)
 {
   for (; first1 != last1 && first2 != last2; ++first1, ++first2)
   {
@@ -460,6 +713,35 @@ bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
   return first1 == last1 && first2 != last2;
 }
 
+template <class T, class U>
+bool lexicographical_compare_dispatch(T* first1, T* last1, U* first2, U* last2, m_true_type)
+{
+  typedef typename std::remove_cv<T>::type value_type;
+  const size_t len1 = static_cast<size_t>(last1 - first1);
+  const size_t len2 = static_cast<size_t>(last2 - first2);
+  const size_t n = len1 < len2 ? len1 : len2;
+  // 浮点数的 NaN 与任何值都不相等，也不比较小，此时继续比较下一个元素
+  for (size_t i = 0; ; ++i)
+  {
+    i += simd::mismatch<value_type>(first1 + i, first2 + i, n - i);
+    if (i == n)
+      break;
+    if (first1[i] < first2[i])
+      return true;
+    if (first2[i] < first1[i])
+      return false;
+  }
+  return len1 < len2;
+}
+
+template <class InputIter1, class InputIter2>
+bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
+                             InputIter2 first2, InputIter2 last2)
+{
+  return mystl::lexicographical_compare_dispatch(first1, last1, first2, last2,
+    m_bool_constant<simd::is_compare_range<InputIter1, InputIter2>::value>());
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compred>
 bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
@@ -492,10 +774,11 @@ bool lexicographical_compare(const unsigned char* first1,
 /*****************************************************************************************/
 // mismatch
 // 平行比较两个序列，找到第一处失配的元素，返回一对迭代器，分别指向两个序列中失配的元素
+// 两个序列都是同一种整数或浮点数的数组时，使用 simd.h 中的 mismatch
 /*****************************************************************************************/
 template <class InputIter1, class InputIter2>
 mystl::pair<InputIter1, InputIter2> 
-mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+mismatch_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, m_false_type)
 {
   while (first1 != last1 && *first1 == *first2)
   {
@@ -505,6 +788,23 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
   return mystl::pair<InputIter1, InputIter2>(first1, first2);
 }
 
+template <class T, class U>
+mystl::pair<T*, U*>
+mismatch_dispatch(T* first1, T* last1, U* first2, m_true_type)
+{
+  const size_t i = simd::mismatch<typename std::remove_cv<T>::type>(
+    first1, first2, static_cast<size_t>(last1 - first1));
+  return mystl::pair<T*, U*>(first1 + i, first2 + i);
+}
+
+template <class InputIter1, class InputIter2>
+mystl::pair<InputIter1, InputIter2> 
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+  return mystl::mismatch_dispatch(first1, last1, first2,
+    m_bool_constant<simd::is_compare_range<InputIter1, InputIter2>::value>());
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compred>
 mystl::pair<InputIter1, InputIter2> 
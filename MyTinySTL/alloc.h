@@ -1,22 +1,30 @@
-#ifndef MYTINYSTL_ALLOC_H_
+﻿#ifndef MYTINYSTL_ALLOC_H_
 #define MYTINYSTL_ALLOC_H_
 
-// 这个头文件包含一个类 alloc，用于分配和回收内存，以内存池的方式实现
+// 这个头文件包含一个类 alloc 与一个模板类 pool_allocator，以分级内存池的方式分配与回收小内存
 //
-// 从 v2.0.0 版本开始，将不再使用内存池，这个文件将被弃用，但暂时保留
+// alloc          : 按大小分级的内存池，每个线程有自己的缓存，线程之间通过中心池交换空闲区块
+// pool_allocator : 接口与 mystl::allocator 相同，内存来自 alloc，可作为 list、rb_tree、hashtable 的节点分配器
+
+// notes:
 //
-// 注意！！！
-// 我知道这个文件里很多实现是错的，这是很久很久前写的了，后面已经不用这个东西了，
-// 所以我也没再维护，有诸多问题，已经有人在issue中都提了，free_list的修改，
-// 指针作为参数时没实际修改到原指针，等等。相信会看这么仔细的，大部分都是
-// 初学C++的朋友，大佬都不会看这些玩具了，所以其中的错误，就留给对内存池实现
-// 感兴趣的朋友去修改啦！
+// 1. 不超过 4096 bytes 的请求按大小上调到 56 个等级之一，每个等级有一条自由链表
+// 2. 分配与回收优先在线程缓存中完成，不需要加锁；线程缓存为空时从中心池批量取出区块，
+//    缓存过多时批量归还，线程退出时把缓存全部归还，因此一个线程释放的内存可以被其他线程复用
+// 3. 中心池向系统申请的大块内存不再归还，超过 4096 bytes 的请求直接调用 std::malloc, std::free
+// 4. 释放时必须给出与分配时相同的大小
 
 #include <new>
+#include <atomic>
+#include <mutex>
 
 #include <cstddef>
-#include <cstdio>
-#include <stdlib.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
 
 namespace mystl
 {
@@ -32,10 +40,10 @@ union FreeList
 // 不同内存范围的上调大小
 enum
 {
-  EAlign128 = 8, 
-  EAlign256 = 16, 
+  EAlign128 = 8,
+  EAlign256 = 16,
   EAlign512 = 32,
-  EAlign1024 = 64, 
+  EAlign1024 = 64,
   EAlign2048 = 128,
   EAlign4096 = 256
 };
@@ -46,114 +54,252 @@ enum { ESmallObjectBytes = 4096 };
 // free lists 个数
 enum { EFreeListsNumber = 56 };
 
+// 中心池每次向系统申请的内存大小
+enum { EChunkBytes = 64 * 1024 };
+
+// 内存池的统计信息，由 alloc::stats() 返回
+struct alloc_stats
+{
+  size_t reserved_bytes;      // 中心池向系统申请的总字节数
+  size_t central_free_bytes;  // 中心池中空闲区块的总字节数
+  size_t large_bytes;         // 当前直接由 malloc 分配、尚未释放的字节数
+  size_t large_count;         // 累计直接由 malloc 分配的次数
+  size_t fetch_count;         // 线程缓存从中心池取区块的次数
+  size_t release_count;       // 线程缓存向中心池归还区块的次数
+};
+
+// 当前线程缓存的统计信息，由 alloc::thread_stats() 返回
+struct alloc_thread_stats
+{
+  size_t allocate_count;      // 本线程从内存池分配小区块的次数
+  size_t deallocate_count;    // 本线程向内存池释放小区块的次数
+  size_t cached_bytes;        // 本线程缓存中空闲区块的总字节数
+};
+
 // 空间配置类 alloc
 // 如果内存较大，超过 4096 bytes，直接调用 std::malloc, std::free
-// 当内存较小时，以内存池管理，每次配置一大块内存，并维护对应的自由链表
+// 当内存较小时，以线程缓存 + 中心池管理
 class alloc
 {
 private:
-  static char*  start_free;                      // 内存池起始位置
-  static char*  end_free;                        // 内存池结束位置
-  static size_t heap_size;                       // 申请 heap 空间附加值大小
-  
-  static FreeList* free_list[EFreeListsNumber];  // 自由链表
+  // 线程缓存中的一条自由链表
+  struct cache_list
+  {
+    FreeList* head;
+    size_t    count;
+  };
+
+  // 线程缓存
+  struct thread_cache
+  {
+    cache_list lists[EFreeListsNumber];
+    size_t     allocate_count;
+    size_t     deallocate_count;
+  };
+
+  // 中心池中的一条自由链表，每条链表各有一把锁
+  struct central_list
+  {
+    std::mutex mtx;
+    FreeList*  head;
+    size_t     count;
+  };
+
+  // 中心池，所有线程共享
+  struct central_pool
+  {
+    central_list        lists[EFreeListsNumber];
+    std::mutex          chunk_mtx;   // 保护 start_free, end_free
+    char*               start_free;  // 当前大块内存中未划分部分的起始位置
+    char*               end_free;    // 当前大块内存的结束位置
+    std::atomic<size_t> reserved_bytes;
+    std::atomic<size_t> large_bytes;
+    std::atomic<size_t> large_count;
+    std::atomic<size_t> fetch_count;
+    std::atomic<size_t> release_count;
+  };
+
+  // 线程退出时归还线程缓存
+  struct cache_guard
+  {
+    ~cache_guard() { alloc::M_destroy_cache(); }
+  };
 
 public:
   static void* allocate(size_t n);
   static void  deallocate(void* p, size_t n);
   static void* reallocate(void* p, size_t old_size, size_t new_size);
 
+  // 把当前线程缓存的空闲区块全部归还中心池
+  static void  release_thread_cache();
+
+  static alloc_stats        stats();
+  static alloc_thread_stats thread_stats();
+
 private:
   static size_t M_align(size_t bytes);
   static size_t M_round_up(size_t bytes);
   static size_t M_freelist_index(size_t bytes);
-  static void*  M_refill(size_t n);
-  static char*  M_chunk_alloc(size_t size, size_t &nobj);
-};
+  static size_t M_class_size(size_t index);
+  static size_t M_batch(size_t index);
 
-// 静态成员变量初始化
+  static central_pool&  M_central();
+  static thread_cache*& M_tls();
+  static bool&          M_tls_dead();
+  static thread_cache*  M_cache();
+  static void           M_destroy_cache();
 
-char*  alloc::start_free = nullptr;
-char*  alloc::end_free = nullptr;
-size_t alloc::heap_size = 0;
+  static void* M_fetch(thread_cache* cache, size_t index);
+  static void  M_release(cache_list& list, size_t index, size_t nblock);
+  static char* M_chunk_alloc(size_t bytes);
+};
 
-FreeList* alloc::free_list[EFreeListsNumber] = {
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr
-  };
+/*****************************************************************************************/
 
-// 分配大小为 n 的空间， n > 0
+// 分配大小为 n 的空间
 inline void* alloc::allocate(size_t n)
 {
-  FreeList* my_free_list;
-  FreeList* result;
   if (n > static_cast<size_t>(ESmallObjectBytes))
-    return std::malloc(n);
-  my_free_list = free_list[M_freelist_index(n)];
-  result = my_free_list;
-  if (result == nullptr)
   {
-    void* r = M_refill(M_round_up(n));
-    return r;
+    void* p = std::malloc(n);
+    if (p == nullptr)
+      throw std::bad_alloc();
+    central_pool& central = M_central();
+    central.large_bytes += n;
+    ++central.large_count;
+    return p;
   }
-  my_free_list = result->next;
+  if (n == 0)
+    n = 1;
+  const size_t index = M_freelist_index(n);
+  thread_cache* cache = M_cache();
+  if (cache == nullptr)
+  { // 线程缓存已经销毁（线程退出过程中），直接从中心池取一个区块
+    central_list& list = M_central().lists[index];
+    {
+      std::lock_guard<std::mutex> lock(list.mtx);
+      if (list.head != nullptr)
+      {
+        FreeList* result = list.head;
+        list.head = result->next;
+        --list.count;
+        return result;
+      }
+    }
+    return M_chunk_alloc(M_class_size(index));
+  }
+  ++cache->allocate_count;
+  cache_list& list = cache->lists[index];
+  FreeList* result = list.head;
+  if (result == nullptr)
+    return M_fetch(cache, index);
+  list.head = result->next;
+  --list.count;
   return result;
 }
 
-// 释放 p 指向的大小为 n 的空间, p 不能为 0
+// 释放 p 指向的大小为 n 的空间, n 必须与分配时相同
 inline void alloc::deallocate(void* p, size_t n)
 {
+  if (p == nullptr)
+    return;
   if (n > static_cast<size_t>(ESmallObjectBytes))
   {
+    M_central().large_bytes -= n;
     std::free(p);
     return;
   }
+  if (n == 0)
+    n = 1;
+  const size_t index = M_freelist_index(n);
   FreeList* q = reinterpret_cast<FreeList*>(p);
-  FreeList* my_free_list;
-  my_free_list = free_list[M_freelist_index(n)];
-  q->next = my_free_list;
-  my_free_list = q;
+  thread_cache* cache = M_cache();
+  if (cache == nullptr)
+  {
+    central_list& list = M_central().lists[index];
+    std::lock_guard<std::mutex> lock(list.mtx);
+    q->next = list.head;
+    list.head = q;
+    ++list.count;
+    return;
+  }
+  ++cache->deallocate_count;
+  cache_list& list = cache->lists[index];
+  q->next = list.head;
+  list.head = q;
+  ++list.count;
+  // 缓存的区块过多时，归还一批给中心池
+  const size_t batch = M_batch(index);
+  if (list.count > batch * 2)
+    M_release(list, index, batch);
+}
+
+// 重新分配空间，接受三个参数，参数一为指向原空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
+// 与 realloc 相同，会保留原空间中的内容
+inline void* alloc::reallocate(void* p, size_t old_size, size_t new_size)
+{
+  if (p == nullptr)
+    return allocate(new_size);
+  if (old_size <= static_cast<size_t>(ESmallObjectBytes) &&
+      new_size <= static_cast<size_t>(ESmallObjectBytes) &&
+      M_round_up(old_size == 0 ? 1 : old_size) == M_round_up(new_size == 0 ? 1 : new_size))
+    return p;  // 属于同一等级，不需要移动
+  void* result = allocate(new_size);
+  std::memcpy(result, p, old_size < new_size ? old_size : new_size);
+  deallocate(p, old_size);
+  return result;
 }
 
-#if 0
-  inline void alloc::deallocate(void* p, size_t n)
+// 把当前线程缓存的空闲区块全部归还中心池
+inline void alloc::release_thread_cache()
+{
+  thread_cache* cache = M_tls();
+  if (cache == nullptr)
+    return;
+  for (size_t i = 0; i < EFreeListsNumber; ++i)
   {
-    if (n > static_cast<size_t>(ESmallObjectBytes))
-    {
-      std::free(p);
-      return;
-    }
-    
-    FreeList* q = reinterpret_cast<FreeList*>(p);
-    FreeList* my_free_list;
-    
-    // 更新自由链表头指针
-    size_t index = M_freelist_index(n);
-    my_free_list = free_list[index];
-    q->next = my_free_list;
-    free_list[index] = q;
+    if (cache->lists[i].count != 0)
+      M_release(cache->lists[i], i, cache->lists[i].count);
   }
-#endif
+}
 
+// 中心池的统计信息
+inline alloc_stats alloc::stats()
+{
+  central_pool& central = M_central();
+  alloc_stats result;
+  result.reserved_bytes = central.reserved_bytes;
+  result.central_free_bytes = 0;
+  for (size_t i = 0; i < EFreeListsNumber; ++i)
+  {
+    std::lock_guard<std::mutex> lock(central.lists[i].mtx);
+    result.central_free_bytes += central.lists[i].count * M_class_size(i);
+  }
+  result.large_bytes = central.large_bytes;
+  result.large_count = central.large_count;
+  result.fetch_count = central.fetch_count;
+  result.release_count = central.release_count;
+  return result;
+}
 
-// 重新分配空间，接受三个参数，参数一为指向新空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
-inline void* alloc::reallocate(void* p, size_t old_size, size_t new_size)
+// 当前线程缓存的统计信息
+inline alloc_thread_stats alloc::thread_stats()
 {
-  deallocate(p, old_size);
-  p = allocate(new_size);
-  return p;
+  alloc_thread_stats result = { 0, 0, 0 };
+  thread_cache* cache = M_tls();
+  if (cache == nullptr)
+    return result;
+  result.allocate_count = cache->allocate_count;
+  result.deallocate_count = cache->deallocate_count;
+  for (size_t i = 0; i < EFreeListsNumber; ++i)
+    result.cached_bytes += cache->lists[i].count * M_class_size(i);
+  return result;
 }
 
 // bytes 对应上调大小
 // 确保了内存块的起始地址符合特定的对齐要求，以提高内存访问效率和避免潜在的对齐错误。
 inline size_t alloc::M_align(size_t bytes)
 {
-  
   if (bytes <= 512)
   {
     return bytes <= 256
@@ -165,24 +311,6 @@ inline size_t alloc::M_align(size_t bytes)
     : EAlign4096;
 }
 
-#if 0
-  inline size_t alloc::M_align(size_t bytes){
-    if (bytes >= 0 && bytes <= 128) {  
-          return EAlign128;  
-      } else if (bytes > 128 && bytes <= 256) {  
-          return EAlign256;  
-      } else if (bytes > 256 && bytes <= 512) {  
-          return EAlign512;  
-      } else if (bytes > 512 && bytes <= 1024) {  
-          return EAlign1024;  
-      } else if (bytes > 1024 && bytes <= 2048) {  
-          return EAlign2048;  
-      } else {  
-          return EAlign4096;  
-      }   
-  }
-#endif
-
 // 将 bytes 上调至对应区间大小
 inline size_t alloc::M_round_up(size_t bytes)
 {
@@ -195,113 +323,290 @@ inline size_t alloc::M_freelist_index(size_t bytes)
   if (bytes <= 512)
   {
     return bytes <= 256
-      ? bytes <= 128 
-        ? ((bytes + EAlign128 - 1) / EAlign128 - 1) 
+      ? bytes <= 128
+        ? ((bytes + EAlign128 - 1) / EAlign128 - 1)
         : (15 + (bytes + EAlign256 - 129) / EAlign256)
       : (23 + (bytes + EAlign512 - 257) / EAlign512);
   }
   return bytes <= 2048
-    ? bytes <= 1024 
+    ? bytes <= 1024
       ? (31 + (bytes + EAlign1024 - 513) / EAlign1024)
       : (39 + (bytes + EAlign2048 - 1025) / EAlign2048)
     : (47 + (bytes + EAlign4096 - 2049) / EAlign4096);
 }
 
-// 重新填充 free list
-void* alloc::M_refill(size_t n)  // 内存块大小
-{
-  size_t nblock = 10;
-  char* c = M_chunk_alloc(n, nblock);
-  FreeList* my_free_list;
-  FreeList* result, *cur, *next;
-  // 如果只有一个区块，就把这个区块返回给调用者，free list 没有增加新节点
-  if (nblock == 1)
-    return c;
-    
-  // 否则把一个区块给调用者，剩下的纳入 free list 作为新节点
-  my_free_list = free_list[M_freelist_index(n)];
-  result = (FreeList*)c;
-  my_free_list = next = (FreeList*)(c + n);
-  for (size_t i = 1; ; ++i)
+// 第 index 个 free list 的区块大小，M_freelist_index 的逆运算
+inline size_t alloc::M_class_size(size_t index)
+{
+  if (index < 16)  return (index + 1) * EAlign128;
+  if (index < 24)  return 128 + (index - 15) * EAlign256;
+  if (index < 32)  return 256 + (index - 23) * EAlign512;
+  if (index < 40)  return 512 + (index - 31) * EAlign1024;
+  if (index < 48)  return 1024 + (index - 39) * EAlign2048;
+  return 2048 + (index - 47) * EAlign4096;
+}
+
+// 线程缓存与中心池之间每次交换的区块数，每批约 8K，至少 2 块，至多 64 块
+inline size_t alloc::M_batch(size_t index)
+{
+  const size_t n = 8192 / M_class_size(index);
+  return n < 2 ? 2 : (n > 64 ? 64 : n);
+}
+
+// 中心池不会被析构，保证其他静态对象析构时仍可以释放内存
+inline alloc::central_pool& alloc::M_central()
+{
+  static central_pool* central = new central_pool();
+  return *central;
+}
+
+inline alloc::thread_cache*& alloc::M_tls()
+{
+  static thread_local thread_cache* cache = nullptr;
+  return cache;
+}
+
+inline bool& alloc::M_tls_dead()
+{
+  static thread_local bool dead = false;
+  return dead;
+}
+
+// 返回当前线程的缓存，第一次使用时创建，线程退出后返回 nullptr
+inline alloc::thread_cache* alloc::M_cache()
+{
+  thread_cache*& cache = M_tls();
+  if (cache != nullptr || M_tls_dead())
+    return cache;
+  cache = static_cast<thread_cache*>(std::calloc(1, sizeof(thread_cache)));
+  if (cache == nullptr)
+    throw std::bad_alloc();
+  static thread_local cache_guard guard;
+  (void)guard;
+  return cache;
+}
+
+// 线程退出时，把缓存归还中心池并销毁
+inline void alloc::M_destroy_cache()
+{
+  release_thread_cache();
+  std::free(M_tls());
+  M_tls() = nullptr;
+  M_tls_dead() = true;
+}
+
+// 线程缓存为空时，从中心池取一批区块，返回其中一块，其余放入线程缓存
+inline void* alloc::M_fetch(thread_cache* cache, size_t index)
+{
+  central_pool& central = M_central();
+  central_list& clist = central.lists[index];
+  cache_list& list = cache->lists[index];
+  const size_t batch = M_batch(index);
+  ++central.fetch_count;
   {
-    cur = next;
-    next = (FreeList*)((char*)next + n);
-    if (nblock - 1 == i)
-    {
-      cur->next = nullptr;
-      break;
-    }
-    else
+    std::lock_guard<std::mutex> lock(clist.mtx);
+    if (clist.head != nullptr)
     {
-      cur->next = next;
+      FreeList* result = clist.head;
+      FreeList* last = result;
+      size_t n = 1;
+      for (; n < batch && last->next != nullptr; ++n)
+        last = last->next;
+      clist.head = last->next;
+      clist.count -= n;
+      last->next = list.head;
+      list.head = result->next;
+      list.count += n - 1;
+      return result;
     }
   }
-  return result;
+  // 中心池也没有空闲区块，从大块内存中划分一批
+  const size_t size = M_class_size(index);
+  char* c = M_chunk_alloc(size * batch);
+  for (size_t i = 1; i < batch; ++i)
+  {
+    FreeList* q = reinterpret_cast<FreeList*>(c + i * size);
+    q->next = list.head;
+    list.head = q;
+  }
+  list.count += batch - 1;
+  return c;
 }
 
-// 从内存池中取空间给 free list 使用，条件不允许时，会调整 nblock
-char* alloc::M_chunk_alloc(size_t size, size_t& nblock)
+// 从线程缓存的链表头部取出 nblock 个区块归还中心池
+inline void alloc::M_release(cache_list& list, size_t index, size_t nblock)
 {
-  char* result;
-  size_t need_bytes = size * nblock;
-  size_t pool_bytes = end_free - start_free;
+  FreeList* first = list.head;
+  FreeList* last = first;
+  for (size_t n = 1; n < nblock; ++n)
+    last = last->next;
+  list.head = last->next;
+  list.count -= nblock;
+  central_pool& central = M_central();
+  central_list& clist = central.lists[index];
+  ++central.release_count;
+  std::lock_guard<std::mutex> lock(clist.mtx);
+  last->next = clist.head;
+  clist.head = first;
+  clist.count += nblock;
+}
 
-  // 如果内存池剩余大小完全满足需求量，返回它
-  if (pool_bytes >= need_bytes)
+// 从中心池的大块内存中取出 bytes 字节，不够时向系统申请新的大块内存，剩余部分直接丢弃
+inline char* alloc::M_chunk_alloc(size_t bytes)
+{
+  central_pool& central = M_central();
+  std::lock_guard<std::mutex> lock(central.chunk_mtx);
+  if (static_cast<size_t>(central.end_free - central.start_free) < bytes)
   {
-    result = start_free;
-    start_free += need_bytes;
-    return result;
+    const size_t bytes_to_get = bytes > EChunkBytes ? bytes : static_cast<size_t>(EChunkBytes);
+    char* chunk = static_cast<char*>(std::malloc(bytes_to_get));
+    if (chunk == nullptr)
+      throw std::bad_alloc();
+    central.start_free = chunk;
+    central.end_free = chunk + bytes_to_get;
+    central.reserved_bytes += bytes_to_get;
   }
+  char* result = central.start_free;
+  central.start_free += bytes;
+  return result;
+}
 
-  // 如果内存池剩余大小不能完全满足需求量，但至少可以分配一个或一个以上的区块，就返回它
-  else if (pool_bytes >= size)
-  {
-    nblock = pool_bytes / size;
-    need_bytes = size * nblock;
-    result = start_free;
-    start_free += need_bytes;
-    return result;
-  }
+/*****************************************************************************************/
+
+// 模板类：pool_allocator
+// 接口与 mystl::allocator 相同，内存来自 alloc
+// 对齐要求超过 8 bytes 的类型退回使用 ::operator new
+template <class T>
+class pool_allocator
+{
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  template <class U>
+  struct rebind { typedef pool_allocator<U> other; };
+
+public:
+  pool_allocator() noexcept = default;
+  template <class U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  static T*   allocate();
+  static T*   allocate(size_type n);
 
-  // 如果内存池剩余大小连一个区块都无法满足
+  static void deallocate(T* ptr);
+  static void deallocate(T* ptr, size_type n);
+
+  static void construct(T* ptr);
+  static void construct(T* ptr, const T& value);
+  static void construct(T* ptr, T&& value);
+
+  template <class... Args>
+  static void construct(T* ptr, Args&& ...args);
+
+  static void destroy(T* ptr);
+  static void destroy(T* first, T* last);
+
+private:
+  static constexpr bool use_pool = alignof(T) <= EAlign128;
+};
+
+// 分配一个 T 类型对象的内存
+template <class T>
+T* pool_allocator<T>::allocate()
+{
+  return allocate(1);
+}
+
+// 分配 n 个 T 类型对象的内存
+template <class T>
+T* pool_allocator<T>::allocate(size_type n)
+{
+  if (n == 0)
+    return nullptr;
+  if (!use_pool)
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  return static_cast<T*>(alloc::allocate(n * sizeof(T)));
+}
+
+// 释放一个 T 类型对象的内存
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr)
+{
+  deallocate(ptr, 1);
+}
+
+// 释放 n 个 T 类型对象的内存，n 必须与分配时相同
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr, size_type n)
+{
+  if (ptr == nullptr)
+    return;
+  if (!use_pool)
+    ::operator delete(ptr);
   else
-  {
-    if (pool_bytes > 0)
-    { // 如果内存池还有剩余，把剩余的空间加入到 free list 中
-      FreeList* my_free_list = free_list[M_freelist_index(pool_bytes)];
-      ((FreeList*)start_free)->next = my_free_list;
-      my_free_list = (FreeList*)start_free;
-    }
-    // 申请 heap 空间
-    size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4);
-    start_free = (char*)std::malloc(bytes_to_get);
-    if (!start_free)
-    { // heap 空间也不够
-      FreeList* my_free_list, *p;
-      // 试着查找有无未用区块，且区块足够大的 free list
-      for (size_t i = size; i <= ESmallObjectBytes; i += M_align(i))
-      {
-        my_free_list = free_list[M_freelist_index(i)];
-        p = my_free_list;
-        if (p)
-        {
-          my_free_list = p->next;
-          start_free = (char*)p;
-          end_free = start_free + i;
-          return M_chunk_alloc(size, nblock);
-        }
-      }
-      std::printf("out of memory");
-      end_free = nullptr;
-      throw std::bad_alloc();
-    }
-    end_free = start_free + bytes_to_get;
-    heap_size += bytes_to_get;
-    return M_chunk_alloc(size, nblock);
-  }
+    alloc::deallocate(ptr, n * sizeof(T));
+}
+
+// 构造一个 T 类型对象
+template <class T>
+void pool_allocator<T>::construct(T* ptr)
+{
+  mystl::construct(ptr);
 }
 
+// 构造一个 T 类型对象，并初始化为 value
+template <class T>
+void pool_allocator<T>::construct(T* ptr, const T& value)
+{
+  mystl::construct(ptr, value);
+}
+
+// 构造一个 T 类型对象，并初始化为 value，使用 move 语义
+template <class T>
+void pool_allocator<T>::construct(T* ptr, T&& value)
+{
+  mystl::construct(ptr, mystl::move(value));
+}
+
+// 使用参数包构造对象，完美转发参数
+template <class T>
+template <class ...Args>
+void pool_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+  mystl::construct(ptr, mystl::forward<Args>(args)...);
+}
+
+// 析构一个 T 类型对象
+template <class T>
+void pool_allocator<T>::destroy(T* ptr)
+{
+  mystl::destroy(ptr);
+}
+
+// 析构多个对象
+template <class T>
+void pool_allocator<T>::destroy(T* first, T* last)
+{
+  mystl::destroy(first, last);
+}
+
+// 所有 pool_allocator 共用同一个 alloc，任意两个都相等
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept { return true; }
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept { return false; }
+
+// pool_allocator::construct 只是 placement new，容器可以使用 uninitialized 函数的快速路径
+template <class T>
+struct alloc_plain_construct<pool_allocator<T>> :public m_true_type {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_ALLOC_H_
 
@@ -2,8 +2,13 @@
 #define MYTINYSTL_ALLOCATOR_H_
 
 // 这个头文件包含一个模板类 allocator，用于管理内存的分配、释放，对象的构造、析构
+// 以及 allocator_traits 与 alloc_holder，容器通过它们使用任意（包括有状态的）分配器
+
+#include <cstddef>
+#include <utility>
 
 #include "construct.h"
+#include "uninitialized.h"
 #include "util.h"
 
 namespace mystl
@@ -23,7 +28,14 @@ public:
   typedef size_t       size_type;
   typedef ptrdiff_t    difference_type;
 
+  template <class U>
+  struct rebind { typedef allocator<U> other; };
+
 public:
+  allocator() noexcept = default;
+  template <class U>
+  allocator(const allocator<U>&) noexcept {}
+
   static T*   allocate();
   static T*   allocate(size_type n);
 
@@ -118,6 +130,415 @@ void allocator<T>::destroy(T* first, T* last)
   mystl::destroy(first, last);
 }
 
+// allocator 没有状态，任意两个 allocator 都相等
+template <class T, class U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept { return true; }
+
+template <class T, class U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept { return false; }
+
+/*****************************************************************************************/
+// allocator_traits
+// 为分配器提供统一的接口，分配器缺少的成员由这里给出缺省实现
+
+// 把分配器模板 A<T, Args...> 的第一个参数替换为 U
+template <class A, class U>
+struct alloc_rebind_first;
+
+template <template <class, class...> class A, class T, class... Args, class U>
+struct alloc_rebind_first<A<T, Args...>, U>
+{
+  typedef A<U, Args...> type;
+};
+
+// 优先使用 A::rebind<U>::other
+template <class A, class U, class = void>
+struct alloc_rebind
+{
+  typedef typename alloc_rebind_first<A, U>::type type;
+};
+
+template <class A, class U>
+struct alloc_rebind<A, U, typename m_void<typename A::template rebind<U>::other>::type>
+{
+  typedef typename A::template rebind<U>::other type;
+};
+
+// 读取 propagate_on_container_* 与 is_always_equal，不存在时使用缺省值
+template <class A, class = void>
+struct alloc_pocca :public m_false_type {};
+template <class A>
+struct alloc_pocca<A, typename m_void<typename A::propagate_on_container_copy_assignment>::type>
+  :public m_bool_constant<A::propagate_on_container_copy_assignment::value> {};
+
+template <class A, class = void>
+struct alloc_pocma :public m_false_type {};
+template <class A>
+struct alloc_pocma<A, typename m_void<typename A::propagate_on_container_move_assignment>::type>
+  :public m_bool_constant<A::propagate_on_container_move_assignment::value> {};
+
+template <class A, class = void>
+struct alloc_pocs :public m_false_type {};
+template <class A>
+struct alloc_pocs<A, typename m_void<typename A::propagate_on_container_swap>::type>
+  :public m_bool_constant<A::propagate_on_container_swap::value> {};
+
+template <class A, class = void>
+struct alloc_always_equal :public m_bool_constant<std::is_empty<A>::value> {};
+template <class A>
+struct alloc_always_equal<A, typename m_void<typename A::is_always_equal>::type>
+  :public m_bool_constant<A::is_always_equal::value> {};
+
+// 检测分配器是否提供 construct, destroy, max_size, select_on_container_copy_construction
+template <class A, class P, class... Args>
+struct alloc_has_construct
+{
+  template <class B>
+  static auto test(int)
+    -> decltype(std::declval<B&>().construct(std::declval<P>(), std::declval<Args>()...), m_true_type());
+  template <class B>
+  static m_false_type test(...);
+  typedef decltype(test<A>(0)) type;
+};
+
+template <class A, class P>
+struct alloc_has_destroy
+{
+  template <class B>
+  static auto test(int) -> decltype(std::declval<B&>().destroy(std::declval<P>()), m_true_type());
+  template <class B>
+  static m_false_type test(...);
+  typedef decltype(test<A>(0)) type;
+};
+
+template <class A>
+struct alloc_has_max_size
+{
+  template <class B>
+  static auto test(int) -> decltype(std::declval<const B&>().max_size(), m_true_type());
+  template <class B>
+  static m_false_type test(...);
+  typedef decltype(test<A>(0)) type;
+};
+
+template <class A>
+struct alloc_has_select
+{
+  template <class B>
+  static auto test(int)
+    -> decltype(std::declval<const B&>().select_on_container_copy_construction(), m_true_type());
+  template <class B>
+  static m_false_type test(...);
+  typedef decltype(test<A>(0)) type;
+};
+
+template <class Alloc>
+struct allocator_traits
+{
+  typedef Alloc                                       allocator_type;
+  typedef typename Alloc::value_type                  value_type;
+  typedef value_type*                                 pointer;
+  typedef const value_type*                           const_pointer;
+  typedef size_t                                      size_type;
+  typedef ptrdiff_t                                   difference_type;
+
+  typedef m_bool_constant<alloc_pocca<Alloc>::value>  propagate_on_container_copy_assignment;
+  typedef m_bool_constant<alloc_pocma<Alloc>::value>  propagate_on_container_move_assignment;
+  typedef m_bool_constant<alloc_pocs<Alloc>::value>   propagate_on_container_swap;
+  typedef m_bool_constant<alloc_always_equal<Alloc>::value> is_always_equal;
+
+  template <class U>
+  using rebind_alloc = typename alloc_rebind<Alloc, U>::type;
+  template <class U>
+  using rebind_traits = allocator_traits<rebind_alloc<U>>;
+
+  static pointer allocate(Alloc& a, size_type n)
+  { return a.allocate(n); }
+
+  static void    deallocate(Alloc& a, pointer p, size_type n)
+  { a.deallocate(p, n); }
+
+  template <class U, class... Args>
+  static void    construct(Alloc& a, U* p, Args&& ...args)
+  { construct_aux(typename alloc_has_construct<Alloc, U*, Args...>::type(), a, p,
+                  mystl::forward<Args>(args)...); }
+
+  template <class U>
+  static void    destroy(Alloc& a, U* p)
+  { destroy_aux(typename alloc_has_destroy<Alloc, U*>::type(), a, p); }
+
+  // 析构 [first, last) 内的对象，分配器没有 destroy 时交给 mystl::destroy，平凡析构的类型什么也不做
+  template <class U>
+  static void    destroy(Alloc& a, U* first, U* last)
+  { destroy_range_aux(typename alloc_has_destroy<Alloc, U*>::type(), a, first, last); }
+
+  static size_type max_size(const Alloc& a) noexcept
+  { return max_size_aux(typename alloc_has_max_size<Alloc>::type(), a); }
+
+  static Alloc   select_on_container_copy_construction(const Alloc& a)
+  { return select_aux(typename alloc_has_select<Alloc>::type(), a); }
+
+  static bool    equal(const Alloc& a, const Alloc& b) noexcept
+  { return is_always_equal::value || a == b; }
+
+private:
+  template <class U, class... Args>
+  static void construct_aux(m_true_type, Alloc& a, U* p, Args&& ...args)
+  { a.construct(p, mystl::forward<Args>(args)...); }
+  template <class U, class... Args>
+  static void construct_aux(m_false_type, Alloc&, U* p, Args&& ...args)
+  { mystl::construct(p, mystl::forward<Args>(args)...); }
+
+  template <class U>
+  static void destroy_aux(m_true_type, Alloc& a, U* p)
+  { a.destroy(p); }
+  template <class U>
+  static void destroy_aux(m_false_type, Alloc&, U* p)
+  { mystl::destroy(p); }
+
+  template <class U>
+  static void destroy_range_aux(m_true_type, Alloc& a, U* first, U* last)
+  {
+    for (; first != last; ++first)
+      a.destroy(first);
+  }
+  template <class U>
+  static void destroy_range_aux(m_false_type, Alloc&, U* first, U* last)
+  { mystl::destroy(first, last); }
+
+  static size_type max_size_aux(m_true_type, const Alloc& a) noexcept
+  { return a.max_size(); }
+  static size_type max_size_aux(m_false_type, const Alloc&) noexcept
+  { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+  static Alloc select_aux(m_true_type, const Alloc& a)
+  { return a.select_on_container_copy_construction(); }
+  static Alloc select_aux(m_false_type, const Alloc& a)
+  { return a; }
+};
+
+/*****************************************************************************************/
+// alloc_holder
+// 容器以私有继承的方式保存分配器，空的分配器借助空基类优化不占空间
+
+template <class Alloc, bool = std::is_empty<Alloc>::value>
+class alloc_holder
+{
+private:
+  Alloc alloc_;
+
+public:
+  alloc_holder() = default;
+  explicit alloc_holder(const Alloc& a) :alloc_(a) {}
+  explicit alloc_holder(Alloc&& a) :alloc_(mystl::move(a)) {}
+
+  Alloc&       M_alloc()       noexcept { return alloc_; }
+  const Alloc& M_alloc() const noexcept { return alloc_; }
+};
+
+template <class Alloc>
+class alloc_holder<Alloc, true> :private Alloc
+{
+public:
+  alloc_holder() = default;
+  explicit alloc_holder(const Alloc& a) :Alloc(a) {}
+  explicit alloc_holder(Alloc&& a) :Alloc(mystl::move(a)) {}
+
+  Alloc&       M_alloc()       noexcept { return *this; }
+  const Alloc& M_alloc() const noexcept { return *this; }
+};
+
+// 按 propagate_on_container_* 的设置复制、移动、交换分配器
+
+template <class Alloc>
+void alloc_copy_assign(Alloc& lhs, const Alloc& rhs, m_true_type) { lhs = rhs; }
+template <class Alloc>
+void alloc_copy_assign(Alloc&, const Alloc&, m_false_type) {}
+
+template <class Alloc>
+void alloc_move_assign(Alloc& lhs, Alloc& rhs, m_true_type) { lhs = mystl::move(rhs); }
+template <class Alloc>
+void alloc_move_assign(Alloc&, Alloc&, m_false_type) {}
+
+template <class Alloc>
+void alloc_swap(Alloc& lhs, Alloc& rhs, m_true_type)
+{
+  Alloc tmp(mystl::move(lhs));
+  lhs = mystl::move(rhs);
+  rhs = mystl::move(tmp);
+}
+template <class Alloc>
+void alloc_swap(Alloc&, Alloc&, m_false_type) {}
+
+/*****************************************************************************************/
+// 通过分配器构造元素的 uninitialized 函数
+// 分配器的 construct 只是 placement new（或者没有 construct）时直接使用 uninitialized.h 中的版本，
+// 保留 memmove 等快速路径；否则逐个调用 allocator_traits::construct，异常时析构已构造的元素
+
+template <class A>
+struct alloc_plain_construct :public m_false_type {};
+template <class T>
+struct alloc_plain_construct<mystl::allocator<T>> :public m_true_type {};
+
+template <class A, class T, class... Args>
+struct alloc_custom_construct
+  :public m_bool_constant<alloc_has_construct<A, T*, Args...>::type::value &&
+                          !alloc_plain_construct<A>::value> {};
+
+// 容器能否按字节搬移元素：元素满足 is_trivially_relocatable，且分配器没有自定义的 construct
+template <class A, class T>
+struct alloc_can_relocate
+  :public m_bool_constant<is_trivially_relocatable<T>::value &&
+                          !alloc_custom_construct<A, T, T&&>::value> {};
+
+// 分配器能否一次归还它分配过的全部节点
+// 能够时 release_if_unique 在没有其他使用者时归还全部节点并返回 true，容器借此跳过逐个释放节点
+template <class A>
+struct alloc_release_traits
+{
+  static bool release_if_unique(A&) noexcept { return false; }
+};
+
+template <class Alloc, class ForwardIter>
+void uninit_destroy_a(Alloc& alloc, ForwardIter first, ForwardIter last)
+{
+  for (; first != last; ++first)
+    allocator_traits<Alloc>::destroy(alloc, &*first);
+}
+
+// uninitialized_copy_a
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter
+unchecked_uninit_copy_a(InputIter first, InputIter last, ForwardIter result, Alloc&, m_false_type)
+{
+  return mystl::uninitialized_copy(first, last, result);
+}
+
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter
+unchecked_uninit_copy_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc, m_true_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; first != last; ++first, ++cur)
+      allocator_traits<Alloc>::construct(alloc, &*cur, *first);
+  }
+  catch (...)
+  {
+    uninit_destroy_a(alloc, result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter uninitialized_copy_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  return mystl::unchecked_uninit_copy_a(first, last, result, alloc,
+    alloc_custom_construct<Alloc, value_type, decltype(*first)>());
+}
+
+// uninitialized_fill_a
+template <class ForwardIter, class T, class Alloc>
+void unchecked_uninit_fill_a(ForwardIter first, ForwardIter last, const T& value, Alloc&, m_false_type)
+{
+  mystl::uninitialized_fill(first, last, value);
+}
+
+template <class ForwardIter, class T, class Alloc>
+void unchecked_uninit_fill_a(ForwardIter first, ForwardIter last, const T& value, Alloc& alloc, m_true_type)
+{
+  auto cur = first;
+  try
+  {
+    for (; cur != last; ++cur)
+      allocator_traits<Alloc>::construct(alloc, &*cur, value);
+  }
+  catch (...)
+  {
+    uninit_destroy_a(alloc, first, cur);
+    throw;
+  }
+}
+
+template <class ForwardIter, class T, class Alloc>
+void uninitialized_fill_a(ForwardIter first, ForwardIter last, const T& value, Alloc& alloc)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  mystl::unchecked_uninit_fill_a(first, last, value, alloc,
+    alloc_custom_construct<Alloc, value_type, const T&>());
+}
+
+// uninitialized_fill_n_a
+template <class ForwardIter, class Size, class T, class Alloc>
+ForwardIter
+unchecked_uninit_fill_n_a(ForwardIter first, Size n, const T& value, Alloc&, m_false_type)
+{
+  return mystl::uninitialized_fill_n(first, n, value);
+}
+
+template <class ForwardIter, class Size, class T, class Alloc>
+ForwardIter
+unchecked_uninit_fill_n_a(ForwardIter first, Size n, const T& value, Alloc& alloc, m_true_type)
+{
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+      allocator_traits<Alloc>::construct(alloc, &*cur, value);
+  }
+  catch (...)
+  {
+    uninit_destroy_a(alloc, first, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class ForwardIter, class Size, class T, class Alloc>
+ForwardIter uninitialized_fill_n_a(ForwardIter first, Size n, const T& value, Alloc& alloc)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  return mystl::unchecked_uninit_fill_n_a(first, n, value, alloc,
+    alloc_custom_construct<Alloc, value_type, const T&>());
+}
+
+// uninitialized_move_a
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter
+unchecked_uninit_move_a(InputIter first, InputIter last, ForwardIter result, Alloc&, m_false_type)
+{
+  return mystl::uninitialized_move(first, last, result);
+}
+
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter
+unchecked_uninit_move_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc, m_true_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; first != last; ++first, ++cur)
+      allocator_traits<Alloc>::construct(alloc, &*cur, mystl::move(*first));
+  }
+  catch (...)
+  {
+    uninit_destroy_a(alloc, result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class InputIter, class ForwardIter, class Alloc>
+ForwardIter uninitialized_move_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  return mystl::unchecked_uninit_move_a(first, last, result, alloc,
+    alloc_custom_construct<Alloc, value_type, decltype(mystl::move(*first))>());
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_ALLOCATOR_H_
 
@@ -1,7 +1,8 @@
 ﻿#ifndef MYTINYSTL_ASTRING_H_
 #define MYTINYSTL_ASTRING_H_
 
-// 定义了 string, wstring, u16string, u32string 类型
+// 定义了 string, wstring, u16string, u32string 类型、对应的 string_view 等视图类型，
+// 以及 mystl::pmr 下使用 polymorphic_allocator 的版本
 
 #include "basic_string.h"
 
@@ -13,6 +14,26 @@ using wstring   = mystl::basic_string<wchar_t>;
 using u16string = mystl::basic_string<char16_t>;
 using u32string = mystl::basic_string<char32_t>;
 
+using string_view    = mystl::basic_string_view<char>;
+using wstring_view   = mystl::basic_string_view<wchar_t>;
+using u16string_view = mystl::basic_string_view<char16_t>;
+using u32string_view = mystl::basic_string_view<char32_t>;
+
+// 透明的哈希函数，配合 mystl::equal_to<> 可以用 const char* 查找以 string 为键的 unordered 容器
+using string_hash  = mystl::basic_string_hash<char>;
+using wstring_hash = mystl::basic_string_hash<wchar_t>;
+
+namespace pmr
+{
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+using basic_string = mystl::basic_string<CharType, CharTraits, polymorphic_allocator<CharType>>;
+
+using string    = pmr::basic_string<char>;
+using wstring   = pmr::basic_string<wchar_t>;
+using u16string = pmr::basic_string<char16_t>;
+using u32string = pmr::basic_string<char32_t>;
+}
+
 }
 #endif // !MYTINYSTL_ASTRING_H_
 
@@ -1,8 +1,9 @@
 ﻿#ifndef MYTINYSTL_BASIC_STRING_H_
 #define MYTINYSTL_BASIC_STRING_H_
 
-// 这个头文件包含一个模板类 basic_string
-// 用于表示字符串类型
+// 这个头文件包含两个模板类 basic_string 与 basic_string_view
+// basic_string      : 用于表示字符串类型
+// basic_string_view : 不拥有字符的字符串视图
 
 #include <iostream>
 
@@ -10,6 +11,9 @@
 #include "memory.h"
 #include "functional.h"
 #include "exceptdef.h"
+#include "simd.h"
+#include "type_traits.h"
+#include "instrument.h"
 
 namespace mystl
 {
@@ -21,7 +25,7 @@ struct char_traits
 {
   typedef CharType char_type;
   
-  static size_t length(const char_type* str)
+  static MYSTL_CONSTEXPR14 size_t length(const char_type* str)
   {
     size_t len = 0;
     for (; *str != char_type(0); ++str)
@@ -87,8 +91,14 @@ struct char_traits<char>
 {
   typedef char char_type;
 
+#if defined(__GNUC__) || defined(__clang__)
+  // __builtin_strlen 可以在编译期求值，字符串字面量构造的 string_view 因此可以是 constexpr
+  static constexpr size_t length(const char_type* str) noexcept
+  { return __builtin_strlen(str); }
+#else
   static size_t length(const char_type* str) noexcept
   { return std::strlen(str); }
+#endif
 
   static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
   { return std::memcmp(s1, s2, n); }
@@ -159,14 +169,10 @@ struct char_traits<char16_t>
 
   static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
   {
-    for (; n != 0; --n, ++s1, ++s2)
-    {
-      if (*s1 < *s2)
-        return -1;
-      if (*s2 < *s1)
-        return 1;
-    }
-    return 0;
+    const size_t i = simd::mismatch(s1, s2, n);
+    if (i == n)
+      return 0;
+    return s1[i] < s2[i] ? -1 : 1;
   }
 
   static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
@@ -221,14 +227,10 @@ struct char_traits<char32_t>
 
   static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
   {
-    for (; n != 0; --n, ++s1, ++s2)
-    {
-      if (*s1 < *s2)
-        return -1;
-      if (*s2 < *s1)
-        return 1;
-    }
-    return 0;
+    const size_t i = simd::mismatch(s1, s2, n);
+    if (i == n)
+      return 0;
+    return s1[i] < s2[i] ? -1 : 1;
   }
 
   static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
@@ -267,35 +269,708 @@ struct char_traits<char32_t>
   }
 };
 
-// 初始化 basic_string 尝试分配的最小 buffer 大小，可能被忽略
-#define STRING_INIT_SIZE 32
+// string_search
+// basic_string 的查找函数使用的算法，都在 [first, last) 中查找，找不到时返回 last
+// 单字节字符使用 simd.h 中的向量化版本，其余整数类型的字符在 find 与 equal 中使用 simd.h 中按元素比较的版本
+template <class CharType, bool = sizeof(CharType) == 1>
+struct string_search
+{
+  typedef CharType char_type;
 
-// 模板类 basic_string
+  static bool in_set(char_type ch, const char_type* s, size_t n) noexcept
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (s[i] == ch)
+        return true;
+    }
+    return false;
+  }
+
+  static bool equal(const char_type* s1, const char_type* s2, size_t n) noexcept
+  {
+    return mystl::equal(s1, s1 + n, s2);
+  }
+
+  static const char_type* find(const char_type* first, const char_type* last, char_type ch,
+                               m_false_type) noexcept
+  {
+    for (; first != last; ++first)
+    {
+      if (*first == ch)
+        return first;
+    }
+    return last;
+  }
+
+  static const char_type* find(const char_type* first, const char_type* last, char_type ch,
+                               m_true_type) noexcept
+  {
+    return first + simd::find_elem(first, static_cast<size_t>(last - first), ch);
+  }
+
+  static const char_type* find(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    return find(first, last, ch, m_bool_constant<simd::is_find_range<const char_type*, char_type>::value>());
+  }
+
+  static const char_type* rfind(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    for (auto p = last; p != first; )
+    {
+      if (*--p == ch)
+        return p;
+    }
+    return last;
+  }
+
+  // 查找长度为 n 的 s，n 不能为 0
+  static const char_type* search(const char_type* first, const char_type* last,
+                                 const char_type* s, size_t n) noexcept
+  {
+    if (static_cast<size_t>(last - first) < n)
+      return last;
+    const auto stop = last - n + 1;
+    for (auto p = first; p != stop; ++p)
+    {
+      if (*p == *s && equal(p + 1, s + 1, n - 1))
+        return p;
+    }
+    return last;
+  }
+
+  static const char_type* rsearch(const char_type* first, const char_type* last,
+                                  const char_type* s, size_t n) noexcept
+  {
+    if (static_cast<size_t>(last - first) < n)
+      return last;
+    for (auto p = last - n + 1; p != first; )
+    {
+      --p;
+      if (*p == *s && equal(p + 1, s + 1, n - 1))
+        return p;
+    }
+    return last;
+  }
+
+  // 查找第一个属于（not_in 为 true 时为不属于）s 的前 n 个字符的字符
+  static const char_type* find_of(const char_type* first, const char_type* last,
+                                  const char_type* s, size_t n, bool not_in) noexcept
+  {
+    for (; first != last; ++first)
+    {
+      if (in_set(*first, s, n) != not_in)
+        return first;
+    }
+    return last;
+  }
+
+  static const char_type* rfind_of(const char_type* first, const char_type* last,
+                                   const char_type* s, size_t n, bool not_in) noexcept
+  {
+    for (auto p = last; p != first; )
+    {
+      if (in_set(*--p, s, n) != not_in)
+        return p;
+    }
+    return last;
+  }
+
+  static size_t count(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    size_t n = 0;
+    for (; first != last; ++first)
+    {
+      if (*first == ch)
+        ++n;
+    }
+    return n;
+  }
+};
+
+template <class CharType>
+struct string_search<CharType, true>
+{
+  typedef CharType char_type;
+
+  static const char* cast(const char_type* p) noexcept
+  { return reinterpret_cast<const char*>(p); }
+  static const char_type* back(const char* p) noexcept
+  { return reinterpret_cast<const char_type*>(p); }
+
+  static const char_type* find(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    return back(simd::find_char(cast(first), cast(last), static_cast<char>(ch)));
+  }
+
+  static const char_type* rfind(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    return back(simd::rfind_char(cast(first), cast(last), static_cast<char>(ch)));
+  }
+
+  static const char_type* search(const char_type* first, const char_type* last,
+                                 const char_type* s, size_t n) noexcept
+  {
+    return back(simd::search(cast(first), cast(last), cast(s), n));
+  }
+
+  static const char_type* rsearch(const char_type* first, const char_type* last,
+                                  const char_type* s, size_t n) noexcept
+  {
+    return back(simd::rsearch(cast(first), cast(last), cast(s), n));
+  }
+
+  static const char_type* find_of(const char_type* first, const char_type* last,
+                                  const char_type* s, size_t n, bool not_in) noexcept
+  {
+    if (n == 1 && !not_in)
+      return find(first, last, *s);
+    const simd::byte_set set(cast(s), n);
+    return back(simd::find_of(cast(first), cast(last), set, not_in));
+  }
+
+  static const char_type* rfind_of(const char_type* first, const char_type* last,
+                                   const char_type* s, size_t n, bool not_in) noexcept
+  {
+    if (n == 1 && !not_in)
+      return rfind(first, last, *s);
+    const simd::byte_set set(cast(s), n);
+    return back(simd::rfind_of(cast(first), cast(last), set, not_in));
+  }
+
+  static size_t count(const char_type* first, const char_type* last, char_type ch) noexcept
+  {
+    return simd::count_char(cast(first), cast(last), static_cast<char>(ch));
+  }
+};
+
+// 模板类 basic_string_view
 // 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
+// 不拥有字符的只读视图，只保存起始位置与长度，复制与 substr 都不分配内存
+// 查找函数与 basic_string 共用 string_search，规则也与 basic_string 相同
 template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+class basic_string_view
+{
+public:
+  typedef CharTraits                               traits_type;
+  typedef CharType                                 value_type;
+  typedef const CharType*                          pointer;
+  typedef const CharType*                          const_pointer;
+  typedef const CharType&                          reference;
+  typedef const CharType&                          const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef const CharType*                          iterator;
+  typedef const CharType*                          const_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  static_assert(std::is_same<CharType, typename traits_type::char_type>::value,
+                "CharType must be same as traits_type::char_type");
+
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  typedef mystl::string_search<CharType> search_type;
+
+  const_pointer data_;  // 起始位置
+  size_type     size_;  // 长度
+
+public:
+  // 构造、复制函数
+  constexpr basic_string_view() noexcept
+    :data_(nullptr), size_(0) {}
+
+  constexpr basic_string_view(const_pointer str, size_type count) noexcept
+    :data_(str), size_(count) {}
+
+  constexpr basic_string_view(const_pointer str) noexcept
+    :data_(str), size_(traits_type::length(str)) {}
+
+  constexpr basic_string_view(const basic_string_view&) noexcept = default;
+  basic_string_view& operator=(const basic_string_view&) noexcept = default;
+
+public:
+  // 迭代器相关操作
+  constexpr const_iterator         begin()   const noexcept
+  { return data_; }
+  constexpr const_iterator         end()     const noexcept
+  { return data_ + size_; }
+  constexpr const_iterator         cbegin()  const noexcept
+  { return data_; }
+  constexpr const_iterator         cend()    const noexcept
+  { return data_ + size_; }
+
+  const_reverse_iterator           rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  const_reverse_iterator           rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+  const_reverse_iterator           crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator           crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  constexpr bool      empty()    const noexcept
+  { return size_ == 0; }
+  constexpr size_type size()     const noexcept
+  { return size_; }
+  constexpr size_type length()   const noexcept
+  { return size_; }
+  constexpr size_type max_size() const noexcept
+  { return static_cast<size_type>(-1) / sizeof(CharType); }
+
+  // 访问元素相关操作
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return data_[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(n >= size_, "basic_string_view<Char, Traits>::at()"
+                          "subscript out of range");
+    return data_[n];
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return data_[0];
+  }
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return data_[size_ - 1];
+  }
+  constexpr const_pointer data() const noexcept
+  { return data_; }
+
+  // 修改视图相关操作
+  void remove_prefix(size_type n) noexcept
+  {
+    MYSTL_DEBUG(n <= size_);
+    data_ += n;
+    size_ -= n;
+  }
+  void remove_suffix(size_type n) noexcept
+  {
+    MYSTL_DEBUG(n <= size_);
+    size_ -= n;
+  }
+  void swap(basic_string_view& rhs) noexcept
+  {
+    mystl::swap(data_, rhs.data_);
+    mystl::swap(size_, rhs.size_);
+  }
+
+  // basic_string_view 相关操作
+
+  // 把 [pos, pos + count) 复制到 dst，返回复制的字符数
+  size_type copy(CharType* dst, size_type count, size_type pos = 0) const
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string_view<Char, Traits>::copy's pos out of range");
+    count = mystl::min(count, size_ - pos);
+    if (count != 0)
+      traits_type::copy(dst, data_ + pos, count);
+    return count;
+  }
+
+  // substr，返回的仍然是视图，不分配内存
+  basic_string_view substr(size_type pos = 0, size_type count = npos) const
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string_view<Char, Traits>::substr's pos out of range");
+    return basic_string_view(data_ + pos, mystl::min(count, size_ - pos));
+  }
+
+  // compare
+  int compare(basic_string_view sv) const noexcept
+  {
+    const auto rlen = mystl::min(size_, sv.size_);
+    const int res = rlen == 0 ? 0 : traits_type::compare(data_, sv.data_, rlen);
+    if (res != 0) return res;
+    if (size_ < sv.size_) return -1;
+    if (size_ > sv.size_) return 1;
+    return 0;
+  }
+  int compare(size_type pos1, size_type count1, basic_string_view sv) const
+  { return substr(pos1, count1).compare(sv); }
+  int compare(size_type pos1, size_type count1, basic_string_view sv,
+              size_type pos2, size_type count2 = npos) const
+  { return substr(pos1, count1).compare(sv.substr(pos2, count2)); }
+  int compare(const_pointer s) const
+  { return compare(basic_string_view(s)); }
+  int compare(size_type pos1, size_type count1, const_pointer s) const
+  { return substr(pos1, count1).compare(basic_string_view(s)); }
+  int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
+  { return substr(pos1, count1).compare(basic_string_view(s, count2)); }
+
+  // starts_with / ends_with
+  bool starts_with(basic_string_view sv) const noexcept
+  { return size_ >= sv.size_ && substr(0, sv.size_).compare(sv) == 0; }
+  bool starts_with(value_type ch) const noexcept
+  { return !empty() && front() == ch; }
+  bool starts_with(const_pointer s) const
+  { return starts_with(basic_string_view(s)); }
+
+  bool ends_with(basic_string_view sv) const noexcept
+  { return size_ >= sv.size_ && substr(size_ - sv.size_).compare(sv) == 0; }
+  bool ends_with(value_type ch) const noexcept
+  { return !empty() && back() == ch; }
+  bool ends_with(const_pointer s) const
+  { return ends_with(basic_string_view(s)); }
+
+  // 查找相关操作
+
+  // find
+  size_type find(value_type ch, size_type pos = 0)                              const noexcept;
+  size_type find(const_pointer str, size_type pos = 0)                          const noexcept;
+  size_type find(const_pointer str, size_type pos, size_type count)             const noexcept;
+  size_type find(basic_string_view str, size_type pos = 0)                      const noexcept;
+
+  // rfind
+  size_type rfind(value_type ch, size_type pos = npos)                          const noexcept;
+  size_type rfind(const_pointer str, size_type pos = npos)                      const noexcept;
+  size_type rfind(const_pointer str, size_type pos, size_type count)            const noexcept;
+  size_type rfind(basic_string_view str, size_type pos = npos)                  const noexcept;
+
+  // find_first_of
+  size_type find_first_of(value_type ch, size_type pos = 0)                     const noexcept;
+  size_type find_first_of(const_pointer s, size_type pos = 0)                   const noexcept;
+  size_type find_first_of(const_pointer s, size_type pos, size_type count)      const noexcept;
+  size_type find_first_of(basic_string_view str, size_type pos = 0)             const noexcept;
+
+  // find_first_not_of
+  size_type find_first_not_of(value_type ch, size_type pos = 0)                 const noexcept;
+  size_type find_first_not_of(const_pointer s, size_type pos = 0)               const noexcept;
+  size_type find_first_not_of(const_pointer s, size_type pos, size_type count)  const noexcept;
+  size_type find_first_not_of(basic_string_view str, size_type pos = 0)         const noexcept;
+
+  // find_last_of
+  size_type find_last_of(value_type ch, size_type pos = 0)                      const noexcept;
+  size_type find_last_of(const_pointer s, size_type pos = 0)                    const noexcept;
+  size_type find_last_of(const_pointer s, size_type pos, size_type count)       const noexcept;
+  size_type find_last_of(basic_string_view str, size_type pos = 0)              const noexcept;
+
+  // find_last_not_of
+  size_type find_last_not_of(value_type ch, size_type pos = 0)                  const noexcept;
+  size_type find_last_not_of(const_pointer s, size_type pos = 0)                const noexcept;
+  size_type find_last_not_of(const_pointer s, size_type pos, size_type count)   const noexcept;
+  size_type find_last_not_of(basic_string_view str, size_type pos = 0)          const noexcept;
+
+  // count
+  size_type count(value_type ch, size_type pos = 0)                             const noexcept;
+
+  // 重载 operator<<
+  friend std::ostream& operator<<(std::ostream& os, basic_string_view sv)
+  {
+    for (size_type i = 0; i < sv.size_; ++i)
+      os << sv.data_[i];
+    return os;
+  }
+};
+
+template <class CharType, class CharTraits>
+constexpr typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::npos;
+
+/*****************************************************************************************/
+
+// 从下标 pos 开始查找字符为 ch 的元素，若找到返回其下标，否则返回 npos
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find(value_type ch, size_type pos) const noexcept
+{
+  if (pos >= size_)
+    return npos;
+  const auto p = search_type::find(data_ + pos, data_ + size_, ch);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find(const_pointer str, size_type pos) const noexcept
+{
+  return find(str, pos, traits_type::length(str));
+}
+
+// 从下标 pos 开始查找字符串 str 的前 count 个字符，若找到返回起始位置的下标，否则返回 npos
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find(const_pointer str, size_type pos, size_type count) const noexcept
+{
+  if (pos > size_ || size_ - pos < count)
+    return npos;
+  if (count == 0)
+    return pos;
+  const auto p = search_type::search(data_ + pos, data_ + size_, str, count);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find(basic_string_view str, size_type pos) const noexcept
+{
+  return find(str.data_, pos, str.size_);
+}
+
+// 从下标 pos 开始反向查找值为 ch 的元素，与 find 类似
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+rfind(value_type ch, size_type pos) const noexcept
+{
+  if (size_ == 0)
+    return npos;
+  const auto last = data_ + (pos < size_ ? pos + 1 : size_);
+  const auto p = search_type::rfind(data_, last, ch);
+  return p == last ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始反向查找字符串 str，与 find 类似
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+rfind(const_pointer str, size_type pos) const noexcept
+{
+  return rfind(str, pos, traits_type::length(str));
+}
+
+// 从下标 pos 开始反向查找字符串 str 前 count 个字符，与 find 类似
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+rfind(const_pointer str, size_type pos, size_type count) const noexcept
+{
+  if (count > size_)
+    return npos;
+  const size_type start = pos < size_ - count ? pos : size_ - count;
+  if (count == 0)
+    return start;
+  const auto last = data_ + start + count;
+  const auto p = search_type::rsearch(data_, last, str, count);
+  return p == last ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始反向查找字符串 str，与 find 类似
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+rfind(basic_string_view str, size_type pos) const noexcept
+{
+  return rfind(str.data_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找 ch 出现的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_of(value_type ch, size_type pos) const noexcept
+{
+  return find(ch, pos);
+}
+
+// 从下标 pos 开始查找字符串 s 其中的一个字符出现的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_of(const_pointer s, size_type pos) const noexcept
+{
+  return find_first_of(s, pos, traits_type::length(s));
+}
+
+// 从下标 pos 开始查找字符串 s 前 count 个字符中的一个字符出现的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+  if (pos >= size_ || count == 0)
+    return npos;
+  const auto p = search_type::find_of(data_ + pos, data_ + size_, s, count, false);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找字符串 str 其中一个字符出现的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_of(basic_string_view str, size_type pos) const noexcept
+{
+  return find_first_of(str.data_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找与 ch 不相等的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_not_of(value_type ch, size_type pos) const noexcept
+{
+  return find_first_not_of(&ch, pos, 1);
+}
+
+// 从下标 pos 开始查找不属于字符串 s 的字符的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_not_of(const_pointer s, size_type pos) const noexcept
+{
+  return find_first_not_of(s, pos, traits_type::length(s));
+}
+
+// 从下标 pos 开始查找不属于字符串 s 前 count 个字符的字符的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+  if (pos >= size_)
+    return npos;
+  const auto p = search_type::find_of(data_ + pos, data_ + size_, s, count, true);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找不属于字符串 str 的字符的第一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_first_not_of(basic_string_view str, size_type pos) const noexcept
+{
+  return find_first_not_of(str.data_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找与 ch 相等的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_of(value_type ch, size_type pos) const noexcept
+{
+  if (pos >= size_)
+    return npos;
+  const auto p = search_type::rfind(data_ + pos, data_ + size_, ch);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找与字符串 s 其中一个字符相等的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_of(const_pointer s, size_type pos) const noexcept
+{
+  return find_last_of(s, pos, traits_type::length(s));
+}
+
+// 从下标 pos 开始查找与字符串 s 前 count 个字符中相等的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+  if (pos >= size_ || count == 0)
+    return npos;
+  const auto p = search_type::rfind_of(data_ + pos, data_ + size_, s, count, false);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找与字符串 str 字符中相等的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_of(basic_string_view str, size_type pos) const noexcept
+{
+  return find_last_of(str.data_, pos, str.size_);
+}
+
+// 从下标 pos 开始查找与 ch 字符不相等的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_not_of(value_type ch, size_type pos) const noexcept
+{
+  return find_last_not_of(&ch, pos, 1);
+}
+
+// 从下标 pos 开始查找不属于字符串 s 的字符的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_not_of(const_pointer s, size_type pos) const noexcept
+{
+  return find_last_not_of(s, pos, traits_type::length(s));
+}
+
+// 从下标 pos 开始查找不属于字符串 s 前 count 个字符的字符的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+{
+  if (pos >= size_)
+    return npos;
+  const auto p = search_type::rfind_of(data_ + pos, data_ + size_, s, count, true);
+  return p == data_ + size_ ? npos : static_cast<size_type>(p - data_);
+}
+
+// 从下标 pos 开始查找不属于字符串 str 的字符的最后一个位置
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find_last_not_of(basic_string_view str, size_type pos) const noexcept
+{
+  return find_last_not_of(str.data_, pos, str.size_);
+}
+
+// 返回从下标 pos 开始字符为 ch 的元素出现的次数
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+count(value_type ch, size_type pos) const noexcept
+{
+  if (pos >= size_)
+    return 0;
+  return search_type::count(data_ + pos, data_ + size_, ch);
+}
+
+/*****************************************************************************************/
+
+// 模板类 basic_string
+// 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class CharType, class CharTraits = mystl::char_traits<CharType>,
+          class Alloc = mystl::allocator<CharType>>
 class basic_string
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<CharType>>
 {
 public:
   typedef CharTraits                               traits_type;
   typedef CharTraits                               char_traits;
 
-  typedef mystl::allocator<CharType>               allocator_type;
-  typedef mystl::allocator<CharType>               data_allocator;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<CharType> data_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
 
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef CharType                                 value_type;
+  typedef typename data_traits::pointer            pointer;
+  typedef typename data_traits::const_pointer      const_pointer;
+  typedef value_type&                              reference;
+  typedef const value_type&                        const_reference;
+  typedef typename data_traits::size_type          size_type;
+  typedef typename data_traits::difference_type    difference_type;
 
   typedef value_type*                              iterator;
   typedef const value_type*                        const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return allocator_type(); }
+  typedef basic_string_view<CharType, CharTraits>  view_type;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
 
   static_assert(std::is_pod<CharType>::value, "Character type of basic_string must be a POD");
   static_assert(std::is_same<CharType, typename traits_type::char_type>::value,
@@ -307,9 +982,25 @@ public:
   static constexpr size_type npos = static_cast<size_type>(-1);
 
 private:
-  iterator  buffer_;  // 储存字符串的起始位置
-  size_type size_;    // 大小
-  size_type cap_;     // 容量
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  typedef mystl::string_search<CharType>           search_type;
+  using alloc_base::M_alloc;
+
+  // 对象内可以直接存放的字符数（不含末尾的空字符），char 为 15 个
+  enum { sso_capacity = (16 / sizeof(CharType) > 2 ? 16 / sizeof(CharType) : 2) - 1 };
+
+  // 短字符串直接存放在 local 中，长字符串存放在 heap 指向的堆上
+  // 对象内不保存指向自身的指针，因此仍然可以按字节搬移
+  union storage
+  {
+    pointer    heap;
+    value_type local[sso_capacity + 1];
+  };
+
+  // c_str() 等 const 函数需要在末尾写入空字符，因此声明为 mutable
+  mutable storage buf_;  // 储存字符串的空间
+  size_type       size_; // 大小
+  size_type       cap_;  // 容量，不含末尾的空字符；等于 sso_capacity 时字符串存放在 local 中
 
 public:
   // 构造、复制、移动、析构函数
@@ -317,56 +1008,86 @@ public:
   basic_string() noexcept
   { try_init(); }
 
-  basic_string(size_type n, value_type ch)
-    :buffer_(nullptr), size_(0), cap_(0)
+  explicit basic_string(const allocator_type& alloc) noexcept
+    :alloc_base(data_allocator(alloc))
+  { try_init(); }
+
+  basic_string(size_type n, value_type ch, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
     fill_init(n, ch);
   }
 
-  basic_string(const basic_string& other, size_type pos)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const basic_string& other, size_type pos,
+               const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
-    init_from(other.buffer_, pos, other.size_ - pos);
+    init_from(other.buffer(), pos, other.size_ - pos);
   }
-  basic_string(const basic_string& other, size_type pos, size_type count)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const basic_string& other, size_type pos, size_type count,
+               const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
-    init_from(other.buffer_, pos, count);
+    init_from(other.buffer(), pos, count);
   }
 
-  basic_string(const_pointer str)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const_pointer str, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
     init_from(str, 0, char_traits::length(str));
   }
-  basic_string(const_pointer str, size_type count)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const_pointer str, size_type count, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
     init_from(str, 0, count);
   }
 
+  explicit basic_string(view_type sv, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
+  {
+    init_from(sv.data(), 0, sv.size());
+  }
+  basic_string(view_type sv, size_type pos, size_type count,
+               const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
+  {
+    sv = sv.substr(pos, count);
+    init_from(sv.data(), 0, sv.size());
+  }
+
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
-  basic_string(Iter first, Iter last)
+  basic_string(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { copy_init(first, last, iterator_category(first)); }
 
   basic_string(const basic_string& rhs) 
-    :buffer_(nullptr), size_(0), cap_(0)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc())),
+     size_(0), cap_(sso_capacity)
+  {
+    init_from(rhs.buffer(), 0, rhs.size_);
+  }
+  basic_string(const basic_string& rhs, const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
   {
-    init_from(rhs.buffer_, 0, rhs.size_);
+    init_from(rhs.buffer(), 0, rhs.size_);
   }
   basic_string(basic_string&& rhs) noexcept
-    :buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_)
+    :alloc_base(mystl::move(rhs.M_alloc())),
+     buf_(rhs.buf_), size_(rhs.size_), cap_(rhs.cap_)
   {
-    rhs.buffer_ = nullptr;
-    rhs.size_ = 0;
-    rhs.cap_ = 0;
+    rhs.try_init();
   }
+  basic_string(basic_string&& rhs, const allocator_type& alloc);
 
   basic_string& operator=(const basic_string& rhs);
-  basic_string& operator=(basic_string&& rhs) noexcept;
+  basic_string& operator=(basic_string&& rhs)
+    noexcept(data_traits::propagate_on_container_move_assignment::value ||
+             data_traits::is_always_equal::value);
 
-  basic_string& operator=(const_pointer str);
+  basic_string& operator=(view_type sv);
+  basic_string& operator=(const_pointer str)
+  { return *this = view_type(str); }
   basic_string& operator=(value_type ch);
 
   ~basic_string() { destroy_buffer(); }
@@ -374,13 +1095,13 @@ public:
 public:
   // 迭代器相关操作
   iterator               begin()         noexcept
-  { return buffer_; }
+  { return buffer(); }
   const_iterator         begin()   const noexcept
-  { return buffer_; }
+  { return buffer(); }
   iterator               end()           noexcept
-  { return buffer_ + size_; }
+  { return buffer() + size_; }
   const_iterator         end()     const noexcept
-  { return buffer_ + size_; }
+  { return buffer() + size_; }
 
   reverse_iterator       rbegin()        noexcept
   { return reverse_iterator(end()); }
@@ -421,15 +1142,15 @@ public:
   {
     MYSTL_DEBUG(n <= size_);
     if (n == size_)
-      *(buffer_ + n) = value_type();
-    return *(buffer_ + n); 
+      *(buffer() + n) = value_type();
+    return *(buffer() + n); 
   }
   const_reference operator[](size_type n) const
   { 
     MYSTL_DEBUG(n <= size_);
     if (n == size_)
-      *(buffer_ + n) = value_type();
-    return *(buffer_ + n);
+      *(buffer() + n) = value_type();
+    return *(buffer() + n);
   }
 
   reference       at(size_type n) 
@@ -472,6 +1193,10 @@ public:
   const_pointer   c_str() const noexcept
   { return to_raw_pointer(); }
 
+  // 转换为 basic_string_view，视图在字符串被修改或销毁后失效
+  operator view_type() const noexcept
+  { return as_view(); }
+
   // 添加删除相关操作
 
   // insert
@@ -504,6 +1229,9 @@ public:
   { return append(s, char_traits::length(s)); }
   basic_string& append(const_pointer s, size_type count);
 
+  basic_string& append(view_type sv)
+  { return sv.empty() ? *this : append(sv.data(), sv.size()); }
+
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
   basic_string& append(Iter first, Iter last)
@@ -518,6 +1246,11 @@ public:
   { resize(count, value_type()); }
   void resize(size_type count, value_type ch);
 
+  // 把大小调整为 op(p, count) 的返回值，op 直接向缓冲区 [p, p + count) 写入字符，返回值不能超过 count
+  // 原有的前 min(size(), count) 个字符保留，容量不足时恰好分配 count 个字符的空间
+  template <class Operation>
+  void resize_and_overwrite(size_type count, Operation op);
+
   void     clear() noexcept
   { size_ = 0; }
 
@@ -531,30 +1264,38 @@ public:
   int compare(const_pointer s) const;
   int compare(size_type pos1, size_type count1, const_pointer s) const;
   int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const;
+  int compare(view_type sv) const noexcept
+  { return as_view().compare(sv); }
+  int compare(size_type pos1, size_type count1, view_type sv) const
+  { return as_view().compare(pos1, count1, sv); }
 
   // substr
-  basic_string substr(size_type index, size_type count = npos)
+  basic_string substr(size_type index, size_type count = npos) const
   {
     count = mystl::min(count, size_ - index);
-    return basic_string(buffer_ + index, buffer_ + index + count);
+    return basic_string(buffer() + index, buffer() + index + count, M_alloc());
   }
 
+  // 返回 [index, index + count) 的视图，不分配内存
+  view_type    substr_view(size_type index = 0, size_type count = npos) const
+  { return as_view().substr(index, count); }
+
   // replace
   basic_string& replace(size_type pos, size_type count, const basic_string& str)
   {
     THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
-    return replace_cstr(buffer_ + pos, count, str.buffer_, str.size_);
+    return replace_cstr(buffer() + pos, count, str.buffer(), str.size_);
   }
   basic_string& replace(const_iterator first, const_iterator last, const basic_string& str)
   {
     MYSTL_DEBUG(begin() <= first && last <= end() && first <= last);
-    return replace_cstr(first, static_cast<size_type>(last - first), str.buffer_, str.size_);
+    return replace_cstr(first, static_cast<size_type>(last - first), str.buffer(), str.size_);
   }
 
   basic_string& replace(size_type pos, size_type count, const_pointer str)
   {
     THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
-    return replace_cstr(buffer_ + pos, count, str, char_traits::length(str));
+    return replace_cstr(buffer() + pos, count, str, char_traits::length(str));
   }
   basic_string& replace(const_iterator first, const_iterator last, const_pointer str)
   {
@@ -565,7 +1306,7 @@ public:
   basic_string& replace(size_type pos, size_type count, const_pointer str, size_type count2)
   {
     THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
-    return replace_cstr(buffer_ + pos, count, str, count2);
+    return replace_cstr(buffer() + pos, count, str, count2);
   }
   basic_string& replace(const_iterator first, const_iterator last, const_pointer str, size_type count)
   {
@@ -577,7 +1318,7 @@ public:
   basic_string& replace(size_type pos, size_type count, size_type count2, value_type ch)
   {
     THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string<Char, Traits>::replace's pos out of range");
-    return replace_fill(buffer_ + pos, count, count2, ch);
+    return replace_fill(buffer() + pos, count, count2, ch);
   }
   basic_string& replace(const_iterator first, const_iterator last, size_type count, value_type ch)
   {
@@ -590,7 +1331,7 @@ public:
   {
     THROW_OUT_OF_RANGE_IF(pos1 > size_ || pos2 > str.size_,
                           "basic_string<Char, Traits>::replace's pos out of range");
-    return replace_cstr(buffer_ + pos1, count1, str.buffer_ + pos2, count2);
+    return replace_cstr(buffer() + pos1, count1, str.buffer() + pos2, count2);
   }
 
   template <class Iter, typename std::enable_if<
@@ -607,46 +1348,71 @@ public:
   // swap
   void swap(basic_string& rhs) noexcept;
 
-  // 查找相关操作
+  // 查找相关操作，规则与 basic_string_view 的同名函数相同
 
   // find
-  size_type find(value_type ch, size_type pos = 0)                             const noexcept;
-  size_type find(const_pointer str, size_type pos = 0)                         const noexcept;
-  size_type find(const_pointer str, size_type pos, size_type count)            const noexcept;
-  size_type find(const basic_string& str, size_type pos = 0)                   const noexcept;
+  size_type find(value_type ch, size_type pos = 0)                              const noexcept
+  { return as_view().find(ch, pos); }
+  size_type find(const_pointer str, size_type pos = 0)                          const noexcept
+  { return as_view().find(str, pos); }
+  size_type find(const_pointer str, size_type pos, size_type count)             const noexcept
+  { return as_view().find(str, pos, count); }
+  size_type find(view_type str, size_type pos = 0)                              const noexcept
+  { return as_view().find(str, pos); }
 
   // rfind
-  size_type rfind(value_type ch, size_type pos = npos)                         const noexcept;
-  size_type rfind(const_pointer str, size_type pos = npos)                     const noexcept;
-  size_type rfind(const_pointer str, size_type pos, size_type count)           const noexcept;
-  size_type rfind(const basic_string& str, size_type pos = npos)               const noexcept;
+  size_type rfind(value_type ch, size_type pos = npos)                          const noexcept
+  { return as_view().rfind(ch, pos); }
+  size_type rfind(const_pointer str, size_type pos = npos)                      const noexcept
+  { return as_view().rfind(str, pos); }
+  size_type rfind(const_pointer str, size_type pos, size_type count)            const noexcept
+  { return as_view().rfind(str, pos, count); }
+  size_type rfind(view_type str, size_type pos = npos)                          const noexcept
+  { return as_view().rfind(str, pos); }
 
   // find_first_of
-  size_type find_first_of(value_type ch, size_type pos = 0)                    const noexcept;
-  size_type find_first_of(const_pointer s, size_type pos = 0)                  const noexcept;
-  size_type find_first_of(const_pointer s, size_type pos, size_type count)     const noexcept;
-  size_type find_first_of(const basic_string& str, size_type pos = 0)          const noexcept;
+  size_type find_first_of(value_type ch, size_type pos = 0)                     const noexcept
+  { return as_view().find_first_of(ch, pos); }
+  size_type find_first_of(const_pointer s, size_type pos = 0)                   const noexcept
+  { return as_view().find_first_of(s, pos); }
+  size_type find_first_of(const_pointer s, size_type pos, size_type count)      const noexcept
+  { return as_view().find_first_of(s, pos, count); }
+  size_type find_first_of(view_type str, size_type pos = 0)                     const noexcept
+  { return as_view().find_first_of(str, pos); }
 
   // find_first_not_of
-  size_type find_first_not_of(value_type ch, size_type pos = 0)                const noexcept;
-  size_type find_first_not_of(const_pointer s, size_type pos = 0)              const noexcept;
-  size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept;
-  size_type find_first_not_of(const basic_string& str, size_type pos = 0)      const noexcept;
+  size_type find_first_not_of(value_type ch, size_type pos = 0)                 const noexcept
+  { return as_view().find_first_not_of(ch, pos); }
+  size_type find_first_not_of(const_pointer s, size_type pos = 0)               const noexcept
+  { return as_view().find_first_not_of(s, pos); }
+  size_type find_first_not_of(const_pointer s, size_type pos, size_type count)  const noexcept
+  { return as_view().find_first_not_of(s, pos, count); }
+  size_type find_first_not_of(view_type str, size_type pos = 0)                 const noexcept
+  { return as_view().find_first_not_of(str, pos); }
 
   // find_last_of
-  size_type find_last_of(value_type ch, size_type pos = 0)                     const noexcept;
-  size_type find_last_of(const_pointer s, size_type pos = 0)                   const noexcept;
-  size_type find_last_of(const_pointer s, size_type pos, size_type count)      const noexcept;
-  size_type find_last_of(const basic_string& str, size_type pos = 0)           const noexcept;
+  size_type find_last_of(value_type ch, size_type pos = 0)                      const noexcept
+  { return as_view().find_last_of(ch, pos); }
+  size_type find_last_of(const_pointer s, size_type pos = 0)                    const noexcept
+  { return as_view().find_last_of(s, pos); }
+  size_type find_last_of(const_pointer s, size_type pos, size_type count)       const noexcept
+  { return as_view().find_last_of(s, pos, count); }
+  size_type find_last_of(view_type str, size_type pos = 0)                      const noexcept
+  { return as_view().find_last_of(str, pos); }
 
   // find_last_not_of
-  size_type find_last_not_of(value_type ch, size_type pos = 0)                 const noexcept;
-  size_type find_last_not_of(const_pointer s, size_type pos = 0)               const noexcept;
-  size_type find_last_not_of(const_pointer s, size_type pos, size_type count)  const noexcept;
-  size_type find_last_not_of(const basic_string& str, size_type pos = 0)       const noexcept;
+  size_type find_last_not_of(value_type ch, size_type pos = 0)                  const noexcept
+  { return as_view().find_last_not_of(ch, pos); }
+  size_type find_last_not_of(const_pointer s, size_type pos = 0)                const noexcept
+  { return as_view().find_last_not_of(s, pos); }
+  size_type find_last_not_of(const_pointer s, size_type pos, size_type count)   const noexcept
+  { return as_view().find_last_not_of(s, pos, count); }
+  size_type find_last_not_of(view_type str, size_type pos = 0)                  const noexcept
+  { return as_view().find_last_not_of(str, pos); }
 
   // count
-  size_type count(value_type ch, size_type pos = 0) const noexcept;
+  size_type count(value_type ch, size_type pos = 0)                             const noexcept
+  { return as_view().count(ch, pos); }
 
 public:
   // 重载 operator+= 
@@ -655,7 +1421,9 @@ public:
   basic_string& operator+=(value_type ch)
   { return append(1, ch); }
   basic_string& operator+=(const_pointer str)
-  { return append(str, str + char_traits::length(str)); }
+  { return append(str, char_traits::length(str)); }
+  basic_string& operator+=(view_type sv)
+  { return append(sv); }
 
   // 重载 operator >> / operatror <<
 
@@ -663,7 +1431,7 @@ public:
   {
     value_type* buf = new value_type[4096];
     is >> buf;
-    basic_string tmp(buf);
+    basic_string tmp(buf, str.M_alloc());
     str = std::move(tmp);
     delete[]buf;
     return is;
@@ -672,13 +1440,30 @@ public:
   friend std::ostream& operator << (std::ostream& os, const basic_string& str)
   {
     for (size_type i = 0; i < str.size_; ++i)
-      os << *(str.buffer_ + i);
+      os << *(str.buffer() + i);
     return os;
   }
 
 private:
   // helper functions
 
+  // storage
+  bool          is_local() const noexcept
+  { return cap_ == static_cast<size_type>(sso_capacity); }
+  pointer       buffer()   const noexcept
+  { return is_local() ? buf_.local : buf_.heap; }
+  view_type     as_view()  const noexcept
+  { return view_type(buffer(), size_); }
+  void          set_heap(pointer p, size_type cap) noexcept
+  {
+    buf_.heap = p;
+    cap_ = cap;
+  }
+  pointer       allocate_buffer(size_type cap);
+  void          free_buffer() noexcept;
+  void          swap_storage(basic_string& rhs) noexcept;
+  pointer       init_space(size_type n);
+
   // init / destroy 
   void          try_init() noexcept;
 
@@ -692,6 +1477,8 @@ private:
   void          init_from(const_pointer src, size_type pos, size_type n);
 
   void          destroy_buffer();
+  void          move_assign(basic_string& rhs, m_true_type) noexcept;
+  void          move_assign(basic_string& rhs, m_false_type);
 
   // get raw pointer
   const_pointer to_raw_pointer() const;
@@ -716,108 +1503,130 @@ private:
   void          reallocate(size_type need);
   iterator      reallocate_and_fill(iterator pos, size_type n, value_type ch);
   iterator      reallocate_and_copy(iterator pos, const_iterator first, const_iterator last);
+
+  void          record_reallocation() const noexcept
+  { instrument::relocation(string_reallocation, string_bytes_moved, size_ * sizeof(CharType)); }
 };
 
 /*****************************************************************************************/
 
 // 复制赋值操作符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
 operator=(const basic_string& rhs)
 {
   if (this != &rhs)
   {
-    basic_string tmp(rhs);
-    swap(tmp);
+    if (data_traits::propagate_on_container_copy_assignment::value &&
+        !data_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 新的分配器无法释放旧的空间，先用旧的分配器释放
+      destroy_buffer();
+    }
+    mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(),
+                             typename data_traits::propagate_on_container_copy_assignment());
+    basic_string tmp(rhs, M_alloc());
+    swap_storage(tmp);
   }
   return *this;
 }
 
 // 移动赋值操作符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
-operator=(basic_string&& rhs) noexcept
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
+operator=(basic_string&& rhs)
+noexcept(data_traits::propagate_on_container_move_assignment::value ||
+         data_traits::is_always_equal::value)
 {
-  destroy_buffer();
-  buffer_ = rhs.buffer_;
-  size_ = rhs.size_;
-  cap_ = rhs.cap_;
-  rhs.buffer_ = nullptr;
-  rhs.size_ = 0;
-  rhs.cap_ = 0;
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                data_traits::propagate_on_container_move_assignment::value ||
+                data_traits::is_always_equal::value>());
+  }
   return *this;
 }
 
-// 用一个字符串赋值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
-operator=(const_pointer str)
+// 使用指定分配器的移动构造函数，分配器不相等时逐个复制字符
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>::
+basic_string(basic_string&& rhs, const allocator_type& alloc)
+  :alloc_base(data_allocator(alloc)), size_(0), cap_(sso_capacity)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    swap_storage(rhs);
+  }
+  else
+  {
+    init_from(rhs.buffer(), 0, rhs.size_);
+    rhs.size_ = 0;
+  }
+}
+
+// 用一个字符串视图赋值，视图可以指向自身
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
+operator=(view_type sv)
 {
-  const size_type len = char_traits::length(str);
+  const size_type len = sv.size();
   if (cap_ < len)
   {
-    auto new_buffer = data_allocator::allocate(len + 1);
-    data_allocator::deallocate(buffer_);
-    buffer_ = new_buffer;
-    cap_ = len + 1;
+    auto new_buffer = allocate_buffer(len);
+    free_buffer();
+    set_heap(new_buffer, len);
   }
-  char_traits::copy(buffer_, str, len);
+  if (len != 0)
+    char_traits::move(buffer(), sv.data(), len);
   size_ = len;
   return *this;
 }
 
 // 用一个字符赋值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
 operator=(value_type ch)
 {
-  if (cap_ < 1)
-  {
-    auto new_buffer = data_allocator::allocate(2);
-    data_allocator::deallocate(buffer_);
-    buffer_ = new_buffer;
-    cap_ = 2;
-  }
-  *buffer_ = ch;
+  *buffer() = ch;  // 容量总是不小于 sso_capacity
   size_ = 1;
   return *this;
 }
 
 // 预留储存空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 reserve(size_type n)
 {
   if (cap_ < n)
   {
     THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size()"
                           "in basic_string<Char,Traits>::reserve(n)");
-    auto new_buffer = data_allocator::allocate(n);
-    char_traits::move(new_buffer, buffer_, size_);
-    buffer_ = new_buffer;
-    cap_ = n;
+    auto new_buffer = allocate_buffer(n);
+    record_reallocation();
+    char_traits::copy(new_buffer, buffer(), size_);
+    free_buffer();
+    set_heap(new_buffer, n);
   }
 }
 
 // 减少不用的空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 shrink_to_fit()
 {
-  if (size_ != cap_)
+  if (!is_local() && size_ != cap_)
   {
     reinsert(size_);
   }
 }
 
 // 在 pos 处插入一个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 insert(const_iterator pos, value_type ch)
 {
   iterator r = const_cast<iterator>(pos);
@@ -832,9 +1641,9 @@ insert(const_iterator pos, value_type ch)
 }
 
 // 在 pos 处插入 n 个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 insert(const_iterator pos, size_type count, value_type ch)
 {
   iterator r = const_cast<iterator>(pos);
@@ -850,17 +1659,17 @@ insert(const_iterator pos, size_type count, value_type ch)
     size_ += count;
     return r;
   }
-  char_traits::move(r + count, r, count);
+  char_traits::move(r + count, r, end() - r);
   char_traits::fill(r, ch, count);
   size_ += count;
   return r;
 }
 
 // 在 pos 处插入 [first, last) 内的元素
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 insert(const_iterator pos, Iter first, Iter last)
 {
   iterator r = const_cast<iterator>(pos);
@@ -877,33 +1686,34 @@ insert(const_iterator pos, Iter first, Iter last)
     size_ += len;
     return r;
   }
-  char_traits::move(r + len, r, len);
+  char_traits::move(r + len, r, end() - r);
   mystl::uninitialized_copy(first, last, r);
   size_ += len;
   return r;
 }
 
 // 在末尾添加 count 个 ch
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& 
+basic_string<CharType, CharTraits, Alloc>::
 append(size_type count, value_type ch)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                         "basic_string<Char, Tratis>'s size too big");
   if (cap_ - size_ < count)
   {
-    reallocate(count);
+    reallocate_and_fill(end(), count, ch);
+    return *this;
   }
-  char_traits::fill(buffer_ + size_, ch, count);
+  char_traits::fill(buffer() + size_, ch, count);
   size_ += count;
   return *this;
 }
 
 // 在末尾添加 [str[pos] str[pos+count]) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& 
+basic_string<CharType, CharTraits, Alloc>::
 append(const basic_string& str, size_type pos, size_type count)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
@@ -912,34 +1722,48 @@ append(const basic_string& str, size_type pos, size_type count)
     return *this;
   if (cap_ - size_ < count)
   {
-    reallocate(count);
+    reallocate_and_copy(end(), str.buffer() + pos, str.buffer() + pos + count);
+    return *this;
   }
-  char_traits::copy(buffer_ + size_, str.buffer_ + pos, count);
+  char_traits::copy(buffer() + size_, str.buffer() + pos, count);
   size_ += count;
   return *this;
 }
 
 // 在末尾添加 [s, s+count) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& 
+basic_string<CharType, CharTraits, Alloc>::
 append(const_pointer s, size_type count)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                         "basic_string<Char, Tratis>'s size too big");
   if (cap_ - size_ < count)
-  {
-    reallocate(count);
+  { // s 可能指向自身，复制完成后才释放原空间
+    reallocate_and_copy(end(), s, s + count);
+    return *this;
   }
-  char_traits::copy(buffer_ + size_, s, count);
+  char_traits::copy(buffer() + size_, s, count);
   size_ += count;
   return *this;
 }
 
+// resize_and_overwrite 函数
+template <class CharType, class CharTraits, class Alloc>
+template <class Operation>
+void basic_string<CharType, CharTraits, Alloc>::
+resize_and_overwrite(size_type count, Operation op)
+{
+  reserve(count);
+  const auto n = static_cast<size_type>(op(buffer(), count));
+  MYSTL_DEBUG(n <= count);
+  size_ = n;
+}
+
 // 删除 pos 处的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos != end());
@@ -950,9 +1774,9 @@ erase(const_iterator pos)
 }
 
 // 删除 [first, last) 的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 erase(const_iterator first, const_iterator last)
 {
   if (first == begin() && last == end())
@@ -968,13 +1792,13 @@ erase(const_iterator first, const_iterator last)
 }
 
 // 重置容器大小
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 resize(size_type count, value_type ch)
 {
   if (count < size_)
   {
-    erase(buffer_ + count, buffer_ + size_);
+    erase(buffer() + count, buffer() + size_);
   }
   else
   {
@@ -983,64 +1807,64 @@ resize(size_type count, value_type ch)
 }
 
 // 比较两个 basic_string，小于返回 -1，大于返回 1，等于返回 0
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(const basic_string& other) const
 {
-  return compare_cstr(buffer_, size_, other.buffer_, other.size_);
+  return compare_cstr(buffer(), size_, other.buffer(), other.size_);
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(size_type pos1, size_type count1, const basic_string& other) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
-  return compare_cstr(buffer_ + pos1, n1, other.buffer_, other.size_);
+  return compare_cstr(buffer() + pos1, n1, other.buffer(), other.size_);
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 下标 pos2 开始的 count2 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(size_type pos1, size_type count1, const basic_string& other,
         size_type pos2, size_type count2) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
   auto n2 = mystl::min(count2, other.size_ - pos2);
-  return compare_cstr(buffer_, n1, other.buffer_, n2);
+  return compare_cstr(buffer() + pos1, n1, other.buffer() + pos2, n2);
 }
 
 // 跟一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(const_pointer s) const
 {
   auto n2 = char_traits::length(s);
-  return compare_cstr(buffer_, size_, s, n2);
+  return compare_cstr(buffer(), size_, s, n2);
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(size_type pos1, size_type count1, const_pointer s) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
   auto n2 = char_traits::length(s);
-  return compare_cstr(buffer_, n1, s, n2);
+  return compare_cstr(buffer() + pos1, n1, s, n2);
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串的前 count2 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
-  return compare_cstr(buffer_, n1, s, count2);
+  return compare_cstr(buffer() + pos1, n1, s, count2);
 }
 
 // 反转 basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 reverse() noexcept
 {
   for (auto i = begin(), j = end(); i < j;)
@@ -1050,673 +1874,215 @@ reverse() noexcept
 }
 
 // 交换两个 basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 swap(basic_string& rhs) noexcept
 {
   if (this != &rhs)
   {
-    mystl::swap(buffer_, rhs.buffer_);
-    mystl::swap(size_, rhs.size_);
-    mystl::swap(cap_, rhs.cap_);
-  }
-}
-
-// 从下标 pos 开始查找字符为 ch 的元素，若找到返回其下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find(value_type ch, size_type pos) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    if (*(buffer_ + i) == ch)
-      return i;
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find(const_pointer str, size_type pos) const noexcept
-{
-  const auto len = char_traits::length(str);
-  if (len == 0)
-    return pos;
-  if (size_ - pos < len)
-    return npos;
-  const auto left = size_ - len;
-  for (auto i = pos; i <= left; ++i)
-  {
-    if (*(buffer_ + i) == *str)
-    {
-      size_type j = 1;
-      for (; j < len; ++j)
-      {
-        if (*(buffer_ + i + j) != *(str + j))
-          break;
-      }
-      if (j == len)
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 str 的前 count 个字符，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find(const_pointer str, size_type pos, size_type count) const noexcept
-{
-  if (count == 0)
-    return pos;
-  if (size_ - pos < count)
-    return npos;
-  const auto left = size_ - count;
-  for (auto i = pos; i <= left; ++i)
-  {
-    if (*(buffer_ + i) == *str)
-    {
-      size_type j = 1;
-      for (; j < count; ++j)
-      {
-        if (*(buffer_ + i + j) != *(str + j))
-          break;
-      }
-      if (j == count)
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find(const basic_string& str, size_type pos) const noexcept
-{
-  const size_type count = str.size_;
-  if (count == 0)
-    return pos;
-  if (size_ - pos < count)
-    return npos;
-  const auto left = size_ - count;
-  for (auto i = pos; i <= left; ++i)
-  {
-    if (*(buffer_ + i) == str.front())
-    {
-      size_type j = 1;
-      for (; j < count; ++j)
-      {
-        if (*(buffer_ + i + j) != str[j])
-          break;
-      }
-      if (j == count)
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始反向查找值为 ch 的元素，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-rfind(value_type ch, size_type pos) const noexcept
-{
-  if (pos >= size_)
-    pos = size_ - 1;
-  for (auto i = pos; i != 0; --i)
-  {
-    if (*(buffer_ + i) == ch)
-      return i;
-  }
-  return front() == ch ? 0 : npos;
-}
-
-// 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-rfind(const_pointer str, size_type pos) const noexcept
-{
-  if (pos >= size_)
-    pos = size_ - 1;
-  const size_type len = char_traits::length(str);
-  switch (len)
-  {
-    case 0: 
-      return pos;
-    case 1: 
-    {
-      for (auto i = pos; i != 0; --i)
-      {
-        if (*(buffer_ + i) == *str)
-          return i;
-      }
-      return front() == *str ? 0 : npos;
-    }
-    default:
-    { // len >= 2
-      for (auto i = pos; i >= len - 1; --i)
-      {
-        if (*(buffer_ + i) == *(str + len - 1))
-        {
-          size_type j = 1;
-          for (; j < len; ++j)
-          {
-            if (*(buffer_ + i - j) != *(str + len - j - 1))
-              break;
-          }
-          if (j == len)
-            return i - len + 1;
-        }
-      }
-      break;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始反向查找字符串 str 前 count 个字符，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-rfind(const_pointer str, size_type pos, size_type count) const noexcept
-{
-  if (count == 0)
-    return pos;
-  if (pos >= size_)
-    pos = size_ - 1;
-  if (pos < count - 1)
-    return npos;
-  for (auto i = pos; i >= count - 1; --i)
-  {
-    if (*(buffer_ + i) == *(str + count - 1))
-    {
-      size_type j = 1;
-      for (; j < count; ++j)
-      {
-        if (*(buffer_ + i - j) != *(str + count - j - 1))
-          break;
-      }
-      if (j == count)
-        return i - count + 1;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-rfind(const basic_string& str, size_type pos) const noexcept
-{
-  const size_type count = str.size_;
-  if (pos >= size_)
-    pos = size_ - 1;
-  if (count == 0)
-    return pos;
-  if (pos < count - 1)
-    return npos;
-  for (auto i = pos; i >= count - 1; --i)
-  {
-    if (*(buffer_ + i) == str[count - 1])
-    {
-      size_type j = 1;
-      for (; j < count; ++j)
-      {
-        if (*(buffer_ + i - j) != str[count - j - 1])
-          break;
-      }
-      if (j == count)
-        return i - count + 1;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找 ch 出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_of(value_type ch, size_type pos) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    if (*(buffer_ + i) == ch)
-      return i;
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 s 其中的一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_of(const_pointer s, size_type pos) const noexcept
-{
-  const size_type len = char_traits::length(s);
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < len; ++j)
-    {
-      if (ch == *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 s 
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < count; ++j)
-    {
-      if (ch == *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找字符串 str 其中一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_of(const basic_string& str, size_type pos) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < str.size_; ++j)
-    {
-      if (ch == str[j])
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与 ch 不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_not_of(value_type ch, size_type pos) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    if (*(buffer_ + i) != ch)
-      return i;
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 s 其中一个字符不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_not_of(const_pointer s, size_type pos) const noexcept
-{
-  const size_type len = char_traits::length(s);
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < len; ++j)
-    {
-      if (ch != *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < count; ++j)
-    {
-      if (ch != *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 str 的字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_first_not_of(const basic_string& str, size_type pos) const noexcept
-{
-  for (auto i = pos; i < size_; ++i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < str.size_; ++j)
-    {
-      if (ch != str[j])
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与 ch 相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_of(value_type ch, size_type pos) const noexcept
-{
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    if (*(buffer_ + i) == ch)
-      return i;
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 s 其中一个字符相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_of(const_pointer s, size_type pos) const noexcept
-{
-  const size_type len = char_traits::length(s);
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < len; ++j)
-    {
-      if (ch == *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
-{
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < count; ++j)
-    {
-      if (ch == *(s + j))
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与字符串 str 字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_of(const basic_string& str, size_type pos) const noexcept
-{
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < str.size_; ++j)
-    {
-      if (ch == str[j])
-        return i;
-    }
-  }
-  return npos;
-}
-
-// 从下标 pos 开始查找与 ch 字符不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_not_of(value_type ch, size_type pos) const noexcept
-{
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    if (*(buffer_ + i) != ch)
-      return i;
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
+    swap_storage(rhs);
   }
-  return npos;
 }
 
-// 从下标 pos 开始查找与字符串 s 的字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_not_of(const_pointer s, size_type pos) const noexcept
+/*****************************************************************************************/
+// helper function
+
+// allocate_buffer 函数
+// 分配可以容纳 cap 个字符的堆空间，多分配一个位置存放末尾的空字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::pointer
+basic_string<CharType, CharTraits, Alloc>::
+allocate_buffer(size_type cap)
 {
-  const size_type len = char_traits::length(s);
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < len; ++j)
-    {
-      if (ch != *(s + j))
-        return i;
-    }
-  }
-  return npos;
+  THROW_LENGTH_ERROR_IF(cap >= max_size(), "basic_string<Char, Traits>'s size too big");
+  return data_traits::allocate(M_alloc(), cap + 1);
 }
 
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+// free_buffer 函数
+// 只释放堆空间，不改变 cap_，调用者随后需要重新设置存储方式
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+free_buffer() noexcept
 {
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < count; ++j)
-    {
-      if (ch != *(s + j))
-        return i;
-    }
-  }
-  return npos;
+  if (!is_local())
+    data_traits::deallocate(M_alloc(), buf_.heap, cap_ + 1);
 }
 
-// 从下标 pos 开始查找与字符串 str 字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-find_last_not_of(const basic_string& str, size_type pos) const noexcept
+// swap_storage 函数
+// 短字符串的内容与长字符串的指针都在 buf_ 中，按字节交换即可
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+swap_storage(basic_string& rhs) noexcept
 {
-  for (auto i = size_ - 1; i >= pos; --i)
-  {
-    value_type ch = *(buffer_ + i);
-    for (size_type j = 0; j < str.size_; ++j)
-    {
-      if (ch != str[j])
-        return i;
-    }
-  }
-  return npos;
+  mystl::swap(buf_, rhs.buf_);
+  mystl::swap(size_, rhs.size_);
+  mystl::swap(cap_, rhs.cap_);
 }
 
-// 返回从下标 pos 开始字符为 ch 的元素出现的次数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
-count(value_type ch, size_type pos) const noexcept
+// init_space 函数
+// 为 n 个字符准备空间并返回起始位置，不超过 sso_capacity 时不分配内存
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::pointer
+basic_string<CharType, CharTraits, Alloc>::
+init_space(size_type n)
 {
-  size_type n = 0;
-  for (auto i = pos; i < size_; ++i)
+  if (n <= static_cast<size_type>(sso_capacity))
   {
-    if (*(buffer_ + i) == ch)
-      ++n;
+    cap_ = static_cast<size_type>(sso_capacity);
+    return buf_.local;
   }
-  return n;
+  set_heap(allocate_buffer(n), n);
+  return buf_.heap;
 }
 
-/*****************************************************************************************/
-// helper function
-
-// 尝试初始化一段 buffer，若分配失败则忽略，不会抛出异常
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+// try_init 函数，初始化为空的短字符串，不会分配内存
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 try_init() noexcept
 {
-  try
-  {
-    buffer_ = data_allocator::allocate(static_cast<size_type>(STRING_INIT_SIZE));
-    size_ = 0;
-    cap_ = 0;
-  }
-  catch (...)
-  {
-    buffer_ = nullptr;
-    size_ = 0;
-    cap_ = 0;
-    // no throw
-  }
+  buf_.local[0] = value_type();
+  size_ = 0;
+  cap_ = static_cast<size_type>(sso_capacity);
 }
 
 // fill_init 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 fill_init(size_type n, value_type ch)
 {
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
-  buffer_ = data_allocator::allocate(init_size);
-  char_traits::fill(buffer_, ch, n);
+  char_traits::fill(init_space(n), ch, n);
   size_ = n;
-  cap_ = init_size;
 }
 
 // copy_init 函数
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-void basic_string<CharType, CharTraits>::
+void basic_string<CharType, CharTraits, Alloc>::
 copy_init(Iter first, Iter last, mystl::input_iterator_tag)
 {
-  size_type n = mystl::distance(first, last);
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+  try_init();
   try
   {
-    buffer_ = data_allocator::allocate(init_size);
-    size_ = n;
-    cap_ = init_size;
+    for (; first != last; ++first)
+      push_back(*first);
   }
   catch (...)
   {
-    buffer_ = nullptr;
-    size_ = 0;
-    cap_ = 0;
+    destroy_buffer();
     throw;
   }
-  for (; n > 0; --n, ++first)
-    append(*first);
 }
 
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-void basic_string<CharType, CharTraits>::
+void basic_string<CharType, CharTraits, Alloc>::
 copy_init(Iter first, Iter last, mystl::forward_iterator_tag)
 {
   const size_type n = mystl::distance(first, last);
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+  auto p = init_space(n);
   try
   {
-    buffer_ = data_allocator::allocate(init_size);
-    size_ = n;
-    cap_ = init_size;
-    mystl::uninitialized_copy(first, last, buffer_);
+    mystl::uninitialized_copy(first, last, p);
   }
   catch (...)
   {
-    buffer_ = nullptr;
-    size_ = 0;
-    cap_ = 0;
+    free_buffer();
+    try_init();
     throw;
   }
+  size_ = n;
 }
 
 // init_from 函数
 // 从源位置复制到目标位置
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 init_from(const_pointer src, size_type pos, size_type count)
 {
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), count + 1);
-  buffer_ = data_allocator::allocate(init_size);
-  char_traits::copy(buffer_, src + pos, count);
+  char_traits::copy(init_space(count), src + pos, count);
   size_ = count;
-  cap_ = init_size;
 }
 
 // destroy_buffer 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+// 释放堆空间，恢复为空的短字符串
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 destroy_buffer()
 {
-  if (buffer_ != nullptr)
+  free_buffer();
+  try_init();
+}
+
+// move_assign 函数
+// 可以接管 rhs 的空间时直接转移
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+move_assign(basic_string& rhs, m_true_type) noexcept
+{
+  destroy_buffer();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename data_traits::propagate_on_container_move_assignment());
+  swap_storage(rhs);
+}
+
+// 分配器不传播且不相等时，只能复制字符
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
+move_assign(basic_string& rhs, m_false_type)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
   {
-    data_allocator::deallocate(buffer_, cap_);
-    buffer_ = nullptr;
-    size_ = 0;
-    cap_ = 0;
+    move_assign(rhs, m_true_type());
+    return;
   }
+  basic_string tmp(rhs, M_alloc());
+  swap_storage(tmp);
+  rhs.size_ = 0;
 }
 
 // to_raw_pointer 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::const_pointer
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::const_pointer
+basic_string<CharType, CharTraits, Alloc>::
 to_raw_pointer() const
 {
-  *(buffer_ + size_) = value_type();
-  return buffer_;
+  auto p = buffer();
+  p[size_] = value_type();
+  return p;
 }
 
 // reinsert 函数
-// 重新分配空间并转移
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+// 重新分配恰好容纳 size 个字符的空间并转移，足够短时搬回对象内部
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 reinsert(size_type size)
 {
-  auto new_buffer = data_allocator::allocate(size);
-  try
+  const auto old_buffer = buf_.heap;
+  const auto old_cap = cap_;
+  if (size <= static_cast<size_type>(sso_capacity))
   {
-    char_traits::move(new_buffer, buffer_, size);
+    char_traits::copy(buf_.local, old_buffer, size);
+    cap_ = static_cast<size_type>(sso_capacity);
   }
-  catch (...)
+  else
   {
-    data_allocator::deallocate(new_buffer);
+    auto new_buffer = allocate_buffer(size);
+    char_traits::copy(new_buffer, old_buffer, size);
+    set_heap(new_buffer, size);
   }
-  buffer_ = new_buffer;
+  data_traits::deallocate(M_alloc(), old_buffer, old_cap + 1);
   size_ = size;
-  cap_ = size;
 }
 
 // append_range，末尾追加一段 [first, last) 内的字符
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
 append_range(Iter first, Iter last)
 {
   const size_type n = mystl::distance(first, last);
@@ -1726,13 +2092,13 @@ append_range(Iter first, Iter last)
   {
     reallocate(n);
   }
-  mystl::uninitialized_copy_n(first, n, buffer_ + size_);
+  mystl::uninitialized_copy_n(first, n, buffer() + size_);
   size_ += n;
   return *this;
 }
 
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::
 compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) const
 {
   auto rlen = mystl::min(n1, n2);
@@ -1744,9 +2110,9 @@ compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) con
 }
 
 // 把 first 开始的 count1 个字符替换成 str 开始的 count2 个字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& 
+basic_string<CharType, CharTraits, Alloc>::
 replace_cstr(const_iterator first, size_type count1, const_pointer str, size_type count2)
 {
   if (static_cast<size_type>(cend() - first) < count1)
@@ -1758,9 +2124,11 @@ replace_cstr(const_iterator first, size_type count1, const_pointer str, size_typ
     const size_type add = count2 - count1;
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
-    {
+    if (cap_ - size_ < add)
+    { // 重新分配后 first 失效，需要重新计算
+      const auto off = first - cbegin();
       reallocate(add);
+      first = cbegin() + off;
     }
     pointer r = const_cast<pointer>(first);
     char_traits::move(r + count2, first + count1, end() - (first + count1));
@@ -1778,9 +2146,9 @@ replace_cstr(const_iterator first, size_type count1, const_pointer str, size_typ
 }
 
 // 把 first 开始的 count1 个字符替换成 count2 个 ch 字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
 replace_fill(const_iterator first, size_type count1, size_type count2, value_type ch)
 {
   if (static_cast<size_type>(cend() - first) < count1)
@@ -1792,9 +2160,11 @@ replace_fill(const_iterator first, size_type count1, size_type count2, value_typ
     const size_type add = count2 - count1;
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
-    {
+    if (cap_ - size_ < add)
+    { // 重新分配后 first 失效，需要重新计算
+      const auto off = first - cbegin();
       reallocate(add);
+      first = cbegin() + off;
     }
     pointer r = const_cast<pointer>(first);
     char_traits::move(r + count2, first + count1, end() - (first + count1));
@@ -1812,10 +2182,10 @@ replace_fill(const_iterator first, size_type count1, size_type count2, value_typ
 }
 
 // 把 [first, last) 的字符替换成 [first2, last2)
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::
 replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
 {
   size_type len1 = last - first;
@@ -1825,9 +2195,11 @@ replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
     const size_type add = len2 - len1;
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
-    {
+    if (cap_ - size_ < add)
+    { // 重新分配后 first 失效，需要重新计算
+      const auto off = first - cbegin();
       reallocate(add);
+      first = cbegin() + off;
     }
     pointer r = const_cast<pointer>(first);
     char_traits::move(r + len2, first + len1, end() - (first + len1));
@@ -1845,237 +2217,616 @@ replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
 }
 
 // reallocate 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::
 reallocate(size_type need)
 {
   const auto new_cap = mystl::max(cap_ + need, cap_ + (cap_ >> 1));
-  auto new_buffer = data_allocator::allocate(new_cap);
-  char_traits::move(new_buffer, buffer_, size_);
-  data_allocator::deallocate(buffer_);
-  buffer_ = new_buffer;
-  cap_ = new_cap;
+  auto new_buffer = allocate_buffer(new_cap);
+  record_reallocation();
+  char_traits::copy(new_buffer, buffer(), size_);
+  free_buffer();
+  set_heap(new_buffer, new_cap);
 }
 
 // reallocate_and_fill 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 reallocate_and_fill(iterator pos, size_type n, value_type ch)
 {
-  const auto r = pos - buffer_;
+  const auto old_buffer = buffer();
+  const auto r = pos - old_buffer;
   const auto old_cap = cap_;
   const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));
-  auto new_buffer = data_allocator::allocate(new_cap);
-  auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
+  auto new_buffer = allocate_buffer(new_cap);
+  record_reallocation();
+  auto e1 = char_traits::copy(new_buffer, old_buffer, r) + r;
   auto e2 = char_traits::fill(e1, ch, n) + n;
-  char_traits::move(e2, buffer_ + r, size_ - r);
-  data_allocator::deallocate(buffer_, old_cap);
-  buffer_ = new_buffer;
+  char_traits::copy(e2, old_buffer + r, size_ - r);
+  free_buffer();
+  set_heap(new_buffer, new_cap);
   size_ += n;
-  cap_ = new_cap;
-  return buffer_ + r;
+  return new_buffer + r;
 }
 
 // reallocate_and_copy 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::
 reallocate_and_copy(iterator pos, const_iterator first, const_iterator last)
 {
-  const auto r = pos - buffer_;
+  const auto old_buffer = buffer();
+  const auto r = pos - old_buffer;
   const auto old_cap = cap_;
   const size_type n = mystl::distance(first, last);
   const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));
-  auto new_buffer = data_allocator::allocate(new_cap);
-  auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
-  auto e2 = mystl::uninitialized_copy_n(first, n, e1) + n;
-  char_traits::move(e2, buffer_ + r, size_ - r);
-  data_allocator::deallocate(buffer_, old_cap);
-  buffer_ = new_buffer;
+  auto new_buffer = allocate_buffer(new_cap);
+  record_reallocation();
+  auto e1 = char_traits::copy(new_buffer, old_buffer, r) + r;
+  auto e2 = mystl::uninitialized_copy_n(first, n, e1);
+  char_traits::copy(e2, old_buffer + r, size_ - r);
+  free_buffer();
+  set_heap(new_buffer, new_cap);
   size_ += n;
-  cap_ = new_cap;
-  return buffer_ + r;
+  return new_buffer + r;
 }
 
 /*****************************************************************************************/
 // 重载全局操作符
 
 // 重载 operator+
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs, 
-          const basic_string<CharType, CharTraits>& rhs)
+// 左右都是左值时先按总长度预留空间，只分配一次；有右值参数时复用它的空间
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs, 
+          const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  basic_string<CharType, CharTraits, Alloc> tmp(
+    mystl::allocator_traits<Alloc>::select_on_container_copy_construction(lhs.get_allocator()));
+  tmp.reserve(lhs.size() + rhs.size());
+  tmp.append(lhs).append(rhs);
+  return tmp;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);
-  tmp.append(rhs);
+  const auto len = CharTraits::length(lhs);
+  basic_string<CharType, CharTraits, Alloc> tmp(
+    mystl::allocator_traits<Alloc>::select_on_container_copy_construction(rhs.get_allocator()));
+  tmp.reserve(len + rhs.size());
+  tmp.append(lhs, len).append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(CharType ch, const basic_string<CharType, CharTraits, Alloc>& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);
-  tmp.append(rhs);
+  basic_string<CharType, CharTraits, Alloc> tmp(
+    mystl::allocator_traits<Alloc>::select_on_container_copy_construction(rhs.get_allocator()));
+  tmp.reserve(rhs.size() + 1);
+  tmp.append(1, ch).append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(CharType ch, const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
 {
-  basic_string<CharType, CharTraits> tmp(1, ch);
-  tmp.append(rhs);
+  const auto len = CharTraits::length(rhs);
+  basic_string<CharType, CharTraits, Alloc> tmp(
+    mystl::allocator_traits<Alloc>::select_on_container_copy_construction(lhs.get_allocator()));
+  tmp.reserve(lhs.size() + len);
+  tmp.append(lhs).append(rhs, len);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs, CharType ch)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);
-  tmp.append(rhs);
+  basic_string<CharType, CharTraits, Alloc> tmp(
+    mystl::allocator_traits<Alloc>::select_on_container_copy_construction(lhs.get_allocator()));
+  tmp.reserve(lhs.size() + 1);
+  tmp.append(lhs).append(1, ch);
   return tmp;
 }
 
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs,
+          const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+// rhs 的剩余空间足够时在它的头部插入，否则按总长度新建
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const basic_string<CharType, CharTraits, Alloc>& lhs,
+          basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+  if (rhs.capacity() - rhs.size() < lhs.size())
+    return lhs + static_cast<const basic_string<CharType, CharTraits, Alloc>&>(rhs);
+  rhs.insert(rhs.begin(), lhs.begin(), lhs.end());
+  return mystl::move(rhs);
+}
+
+// 优先追加到 lhs，只有 lhs 放不下而 rhs 放得下时才插入到 rhs 的头部
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs,
+          basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+  const auto len = lhs.size() + rhs.size();
+  if (len > lhs.capacity() && len <= rhs.capacity())
+  {
+    rhs.insert(rhs.begin(), lhs.begin(), lhs.end());
+    return mystl::move(rhs);
+  }
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(const CharType* lhs, basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+  rhs.insert(rhs.begin(), lhs, lhs + CharTraits::length(lhs));
+  return mystl::move(rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(CharType ch, basic_string<CharType, CharTraits, Alloc>&& rhs)
+{
+  rhs.insert(rhs.begin(), ch);
+  return mystl::move(rhs);
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs, const CharType* rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>
+operator+(basic_string<CharType, CharTraits, Alloc>&& lhs, CharType ch)
+{
+  return mystl::move(lhs.append(1, ch));
+}
+
+// 重载比较操作符
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.compare(rhs) <= 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+// 与 C 风格字符串比较，不构造临时的 basic_string
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) == 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) != 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) != 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<=(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) <= 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator<=(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) >= 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) < 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>=(const basic_string<CharType, CharTraits, Alloc>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+template <class CharType, class CharTraits, class Alloc>
+bool operator>=(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) <= 0;
+}
+
+// 重载 basic_string_view 的比较操作符
+// 后两种形式的一侧不参与推导，可以隐式转换为 basic_string_view 的 basic_string、C 风格字符串也能与视图比较
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs, CharType ch)
+bool operator==(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(lhs);
-  tmp.append(1, ch);
-  return tmp;
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs,
-          const basic_string<CharType, CharTraits>& rhs)
+bool operator==(basic_string_view<CharType, CharTraits> lhs,
+                typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
-  tmp.append(rhs);
-  return tmp;
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs,
-          basic_string<CharType, CharTraits>&& rhs)
+bool operator==(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
-  tmp.insert(tmp.begin(), lhs.begin(), lhs.end());
-  return tmp;
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs,
-          basic_string<CharType, CharTraits>&& rhs)
+bool operator!=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
-  tmp.append(rhs);
-  return tmp;
+  return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const CharType* lhs, basic_string<CharType, CharTraits>&& rhs)
+bool operator!=(basic_string_view<CharType, CharTraits> lhs,
+                typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
-  tmp.insert(tmp.begin(), lhs, lhs + char_traits<CharType>::length(lhs));
-  return tmp;
+  return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(CharType ch, basic_string<CharType, CharTraits>&& rhs)
+bool operator!=(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
-  tmp.insert(tmp.begin(), ch);
-  return tmp;
+  return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs, const CharType* rhs)
+bool operator<(basic_string_view<CharType, CharTraits> lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
-  tmp.append(rhs);
-  return tmp;
+  return lhs.compare(rhs) < 0;
 }
 
 template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs, CharType ch)
+bool operator<(basic_string_view<CharType, CharTraits> lhs,
+               typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
-  tmp.append(1, ch);
-  return tmp;
+  return lhs.compare(rhs) < 0;
 }
 
-// 重载比较操作符
 template <class CharType, class CharTraits>
-bool operator==(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+bool operator<(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+  return lhs.compare(rhs) < 0;
 }
 
 template <class CharType, class CharTraits>
-bool operator!=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+bool operator<=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
-  return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
+  return lhs.compare(rhs) <= 0;
 }
 
 template <class CharType, class CharTraits>
-bool operator<(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs)
+bool operator<=(basic_string_view<CharType, CharTraits> lhs,
+                typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
 {
-  return lhs.compare(rhs) < 0;
+  return lhs.compare(rhs) <= 0;
 }
 
 template <class CharType, class CharTraits>
-bool operator<=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+bool operator<=(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
 {
   return lhs.compare(rhs) <= 0;
 }
 
 template <class CharType, class CharTraits>
-bool operator>(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs)
+bool operator>(basic_string_view<CharType, CharTraits> lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>(basic_string_view<CharType, CharTraits> lhs,
+               typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
 {
   return lhs.compare(rhs) > 0;
 }
 
 template <class CharType, class CharTraits>
-bool operator>=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+bool operator>=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>=(basic_string_view<CharType, CharTraits> lhs,
+                typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type rhs) noexcept
 {
   return lhs.compare(rhs) >= 0;
 }
 
-// 重载 mystl 的 swap
 template <class CharType, class CharTraits>
-void swap(basic_string<CharType, CharTraits>& lhs,
-          basic_string<CharType, CharTraits>& rhs) noexcept
+bool operator>=(typename mystl::m_identity<basic_string_view<CharType, CharTraits>>::type lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+// 重载 mystl 的 swap
+template <class CharType, class CharTraits, class Alloc>
+void swap(basic_string<CharType, CharTraits, Alloc>& lhs,
+          basic_string<CharType, CharTraits, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
 // 特化 mystl::hash
+template <class CharType, class CharTraits, class Alloc>
+struct hash<basic_string<CharType, CharTraits, Alloc>>
+{
+  size_t operator()(const basic_string<CharType, CharTraits, Alloc>& str) const noexcept
+  {
+    return hash_bytes(str.data(), str.size() * sizeof(CharType));
+  }
+};
+
+// 透明的字符串哈希函数，basic_string、basic_string_view 与 C 风格字符串对相同内容给出相同的哈希值，
+// 与 mystl::equal_to<> 搭配作为 unordered 容器的 Hash，可以用 const CharType* 或视图直接查找
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+struct basic_string_hash
+{
+  typedef int is_transparent;
+
+  template <class Alloc>
+  size_t operator()(const basic_string<CharType, CharTraits, Alloc>& str) const noexcept
+  {
+    return hash_bytes(str.data(), str.size() * sizeof(CharType));
+  }
+  size_t operator()(const CharType* s) const noexcept
+  {
+    return hash_bytes(s, CharTraits::length(s) * sizeof(CharType));
+  }
+  size_t operator()(basic_string_view<CharType, CharTraits> sv) const noexcept
+  {
+    return hash_bytes(sv.data(), sv.size() * sizeof(CharType));
+  }
+};
+
+// 特化 mystl::hash，与内容相同的 basic_string 给出相同的哈希值
 template <class CharType, class CharTraits>
-struct hash<basic_string<CharType, CharTraits>>
+struct hash<basic_string_view<CharType, CharTraits>>
+{
+  size_t operator()(basic_string_view<CharType, CharTraits> sv) const noexcept
+  {
+    return hash_bytes(sv.data(), sv.size() * sizeof(CharType));
+  }
+};
+
+/*****************************************************************************************/
+// str_cat / str_append
+
+// str_cat、str_append 的一个参数：字符串、字符串视图、C 风格字符串、单个字符或整数
+// 字符与整数转换后存放在对象内部，只记录偏移，因此对象可以安全地复制
+template <class CharType>
+class str_cat_arg
 {
-  size_t operator()(const basic_string<CharType, CharTraits>& str)
+  const CharType* data_;       // 为 nullptr 时字符存放在 local_ 中
+  size_t          size_;
+  CharType        local_[24];  // 足够存放 64 位整数与符号
+
+public:
+  template <class CharTraits, class Alloc>
+  str_cat_arg(const basic_string<CharType, CharTraits, Alloc>& str) noexcept
+    :data_(str.data()), size_(str.size()) {}
+
+  template <class CharTraits>
+  str_cat_arg(basic_string_view<CharType, CharTraits> sv) noexcept
+    :data_(sv.data()), size_(sv.size()) {}
+
+  str_cat_arg(const CharType* str) noexcept
+    :data_(str), size_(mystl::char_traits<CharType>::length(str)) {}
+
+  str_cat_arg(CharType ch) noexcept
+    :data_(nullptr), size_(1)
   {
-    return bitwise_hash((const unsigned char*)str.c_str(),
-                        str.size() * sizeof(CharType));
+    local_[sizeof(local_) / sizeof(CharType) - 1] = ch;
   }
+
+  template <class Int, typename std::enable_if<
+    std::is_integral<Int>::value && !std::is_same<Int, CharType>::value &&
+    !std::is_same<Int, bool>::value, int>::type = 0>
+  str_cat_arg(Int value) noexcept
+    :data_(nullptr), size_(0)
+  {
+    typedef typename std::make_unsigned<Int>::type uint_type;
+    const bool neg = value < 0;
+    uint_type u = neg ? static_cast<uint_type>(0) - static_cast<uint_type>(value)
+                      : static_cast<uint_type>(value);
+    CharType* p = local_ + sizeof(local_) / sizeof(CharType);
+    do
+    {
+      *--p = static_cast<CharType>('0' + u % 10);
+      u /= 10;
+    } while (u != 0);
+    if (neg)
+      *--p = static_cast<CharType>('-');
+    size_ = static_cast<size_t>(local_ + sizeof(local_) / sizeof(CharType) - p);
+  }
+
+  const CharType* data() const noexcept
+  { return data_ != nullptr ? data_ : local_ + sizeof(local_) / sizeof(CharType) - size_; }
+  size_t          size() const noexcept { return size_; }
 };
 
+// 把所有参数依次拼接成一个新的字符串，先求出总长度，只分配一次
+// 例: mystl::string line = mystl::str_cat("GET ", path, ' ', status);
+template <class CharType = char>
+basic_string<CharType> str_cat()
+{
+  return basic_string<CharType>();
+}
+
+template <class CharType = char, class... Args>
+basic_string<CharType> str_cat(const Args& ...args)
+{
+  const str_cat_arg<CharType> pieces[] = { str_cat_arg<CharType>(args)... };
+  size_t len = 0;
+  for (auto& piece : pieces)
+    len += piece.size();
+  basic_string<CharType> result;
+  result.resize_and_overwrite(len, [&pieces, len](CharType* p, size_t)
+  {
+    for (auto& piece : pieces)
+    {
+      mystl::char_traits<CharType>::copy(p, piece.data(), piece.size());
+      p += piece.size();
+    }
+    return len;
+  });
+  return result;
+}
+
+// 把所有参数依次追加到 str 的末尾，至多分配一次
+// 参数可以引用 str 自身：需要扩容时在新的字符串中拼接后交换
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+str_append(basic_string<CharType, CharTraits, Alloc>& str)
+{
+  return str;
+}
+
+template <class CharType, class CharTraits, class Alloc, class... Args>
+basic_string<CharType, CharTraits, Alloc>&
+str_append(basic_string<CharType, CharTraits, Alloc>& str, const Args& ...args)
+{
+  const str_cat_arg<CharType> pieces[] = { str_cat_arg<CharType>(args)... };
+  size_t add = 0;
+  for (auto& piece : pieces)
+    add += piece.size();
+  const auto old_size = str.size();
+  THROW_LENGTH_ERROR_IF(old_size > str.max_size() - add,
+                        "basic_string<Char, Traits>'s size too big");
+  if (str.capacity() - old_size >= add)
+  {
+    str.resize_and_overwrite(old_size + add, [&pieces, old_size, add](CharType* p, size_t)
+    {
+      auto out = p + old_size;
+      for (auto& piece : pieces)
+      {
+        CharTraits::copy(out, piece.data(), piece.size());
+        out += piece.size();
+      }
+      return old_size + add;
+    });
+    return str;
+  }
+  const auto cap = str.capacity();
+  basic_string<CharType, CharTraits, Alloc> tmp(str.get_allocator());
+  tmp.reserve(mystl::max(old_size + add, cap + (cap >> 1)));
+  tmp.append(str);
+  for (auto& piece : pieces)
+    tmp.append(piece.data(), piece.size());
+  str.swap(tmp);
+  return str;
+}
+
+// basic_string 的短字符串存放在对象内部，但不保存指向自身的指针，可以按字节搬移
+template <class CharType, class CharTraits, class Alloc>
+struct is_trivially_relocatable<basic_string<CharType, CharTraits, Alloc>>
+  :is_trivially_relocatable<Alloc> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_BASIC_STRING_H_
 
@@ -0,0 +1,1883 @@
+﻿#ifndef MYTINYSTL_BTREE_H_
+#define MYTINYSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree
+// btree : B+ 树，元素按顺序存放在叶节点中，叶节点之间以双向链表相连，
+// 内部节点只保存分隔键与子节点指针，节点大小按缓存行调整
+
+// notes:
+//
+// 与 rb_tree 的取舍：
+// rb_tree 每个元素一个节点，元素地址在整个生命周期内不变，btree 一个叶节点存放多个元素，
+// 查找时访问的节点少，顺序遍历时连续读取同一个叶节点，缓存更友好，但：
+//   * 插入和删除会在节点内、节点间移动元素，所有迭代器、指针、引用都会失效，
+//     erase 返回指向下一个元素的有效迭代器
+//   * 元素通过移动构造搬到新位置，对 pair<const Key, T> 而言键会被复制，
+//     假定元素与键的移动构造不抛出异常
+//   * 内部节点保存键的副本作为分隔键，key_type 需要可以复制
+//
+// 节点结构：
+//   * 叶节点与内部节点的目标大小为 btree_node_bytes 个字节，由此算出每个节点容纳的元素数
+//   * 分隔键 key[i] 满足：children[i] 中的键 <= key[i] <= children[i + 1] 中的键
+//   * header_ 是叶节点链表的哨兵，begin() 为 header_ 的下一个叶节点，end() 为 header_ 本身
+//   * 在叶节点末尾插入导致分裂时，新叶节点只放新元素，顺序插入时叶节点几乎是满的
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "rb_tree.h"
+
+namespace mystl
+{
+
+// 节点的目标大小，四个缓存行
+static constexpr size_t btree_node_bytes = 256;
+
+// 树的最大高度，用于分裂时预先分配节点
+static constexpr size_t btree_max_height = 64;
+
+// forward declaration
+
+template <class T> struct btree_node_base;
+template <class T> struct btree_leaf_base;
+template <class T> struct btree_leaf;
+template <class T> struct btree_internal;
+
+template <class T> struct btree_iterator;
+template <class T> struct btree_const_iterator;
+
+// btree traits
+
+template <class T>
+struct btree_traits
+{
+  typedef rb_tree_value_traits<T>            value_traits;
+
+  typedef typename value_traits::key_type    key_type;
+  typedef typename value_traits::mapped_type mapped_type;
+  typedef typename value_traits::value_type  value_type;
+
+  typedef value_type*                        pointer;
+  typedef value_type&                        reference;
+  typedef const value_type*                  const_pointer;
+  typedef const value_type&                  const_reference;
+
+  typedef btree_node_base<T>                 node_base;
+  typedef btree_leaf_base<T>                 leaf_base;
+  typedef btree_leaf<T>                      leaf_type;
+  typedef btree_internal<T>                  internal_type;
+
+  typedef node_base*                         base_ptr;
+  typedef leaf_base*                         leaf_base_ptr;
+  typedef leaf_type*                         leaf_ptr;
+  typedef internal_type*                     internal_ptr;
+};
+
+// btree 的节点设计
+
+template <class T>
+struct btree_node_base
+{
+  btree_internal<T>* parent;    // 父节点，根节点为 nullptr
+  unsigned short     position;  // 在父节点 children 中的下标
+  unsigned short     count;     // 叶节点为元素个数，内部节点为分隔键个数
+  bool               leaf;      // 是否为叶节点
+};
+
+template <class T>
+struct btree_leaf_base :public btree_node_base<T>
+{
+  btree_leaf_base* prev;  // 前一个叶节点
+  btree_leaf_base* next;  // 后一个叶节点
+};
+
+// 每个节点容纳的元素数，至少为 4，保证分裂与合并可以进行
+
+template <class T>
+struct btree_node_size
+{
+  typedef typename btree_traits<T>::key_type key_type;
+
+  static constexpr size_t leaf_raw =
+    (btree_node_bytes - sizeof(btree_leaf_base<T>)) / sizeof(T);
+  static constexpr size_t internal_raw =
+    (btree_node_bytes - sizeof(btree_node_base<T>) - sizeof(void*)) /
+    (sizeof(key_type) + sizeof(void*));
+
+  static constexpr size_t leaf_slots = leaf_raw < 4 ? 4 : leaf_raw;
+  static constexpr size_t internal_slots = internal_raw < 4 ? 4 : internal_raw;
+
+  // 非根节点少于以下数目时与兄弟节点合并或者向兄弟节点借元素
+  static constexpr size_t leaf_min = leaf_slots / 2;
+  static constexpr size_t internal_min = internal_slots / 2;
+};
+
+template <class T>
+struct btree_leaf :public btree_leaf_base<T>
+{
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+
+  slot_type slots[btree_node_size<T>::leaf_slots];
+
+  T* value(size_t i) { return reinterpret_cast<T*>(slots + i); }
+};
+
+template <class T>
+struct btree_internal :public btree_node_base<T>
+{
+  typedef typename btree_traits<T>::key_type key_type;
+  typedef typename std::aligned_storage<sizeof(key_type), alignof(key_type)>::type slot_type;
+
+  slot_type           keys[btree_node_size<T>::internal_slots];
+  btree_node_base<T>* children[btree_node_size<T>::internal_slots + 1];
+
+  key_type* key(size_t i) { return reinterpret_cast<key_type*>(keys + i); }
+};
+
+// btree 的迭代器设计
+// 迭代器记录叶节点与节点内的下标，end() 为 (header, 0)
+
+template <class T>
+struct btree_iterator_base :public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+{
+  typedef typename btree_traits<T>::leaf_base_ptr leaf_base_ptr;
+
+  leaf_base_ptr node;  // 所在的叶节点
+  size_t        pos;   // 在叶节点中的下标
+
+  btree_iterator_base() :node(nullptr), pos(0) {}
+
+  // 使迭代器前进
+  void inc()
+  {
+    if (++pos == node->count)
+    {
+      node = node->next;
+      pos = 0;
+    }
+  }
+
+  // 使迭代器后退
+  void dec()
+  {
+    if (pos == 0)
+    {
+      node = node->prev;
+      pos = node->count;
+    }
+    --pos;
+  }
+
+  bool operator==(const btree_iterator_base& rhs) const
+  { return node == rhs.node && pos == rhs.pos; }
+  bool operator!=(const btree_iterator_base& rhs) const
+  { return !(*this == rhs); }
+};
+
+template <class T>
+struct btree_iterator :public btree_iterator_base<T>
+{
+  typedef btree_traits<T>                       tree_traits;
+
+  typedef typename tree_traits::value_type      value_type;
+  typedef typename tree_traits::pointer         pointer;
+  typedef typename tree_traits::reference       reference;
+  typedef typename tree_traits::leaf_base_ptr   leaf_base_ptr;
+  typedef typename tree_traits::leaf_ptr        leaf_ptr;
+
+  typedef btree_iterator<T>                     iterator;
+  typedef btree_const_iterator<T>               const_iterator;
+  typedef iterator                              self;
+
+  using btree_iterator_base<T>::node;
+  using btree_iterator_base<T>::pos;
+
+  // 构造函数
+  btree_iterator() {}
+  btree_iterator(leaf_base_ptr x, size_t i) { node = x; pos = i; }
+  btree_iterator(const const_iterator& rhs) { node = rhs.node; pos = rhs.pos; }
+  btree_iterator(const btree_iterator&) = default;
+  btree_iterator& operator=(const btree_iterator&) = default;
+
+  // 重载操作符
+  reference operator*()  const { return *static_cast<leaf_ptr>(node)->value(pos); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    this->inc();
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp(*this);
+    this->inc();
+    return tmp;
+  }
+  self& operator--()
+  {
+    this->dec();
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp(*this);
+    this->dec();
+    return tmp;
+  }
+};
+
+template <class T>
+struct btree_const_iterator :public btree_iterator_base<T>
+{
+  typedef btree_traits<T>                       tree_traits;
+
+  typedef typename tree_traits::value_type      value_type;
+  typedef typename tree_traits::const_pointer   pointer;
+  typedef typename tree_traits::const_reference reference;
+  typedef typename tree_traits::leaf_base_ptr   leaf_base_ptr;
+  typedef typename tree_traits::leaf_ptr        leaf_ptr;
+
+  typedef btree_iterator<T>                     iterator;
+  typedef btree_const_iterator<T>               const_iterator;
+  typedef const_iterator                        self;
+
+  using btree_iterator_base<T>::node;
+  using btree_iterator_base<T>::pos;
+
+  // 构造函数
+  btree_const_iterator() {}
+  btree_const_iterator(leaf_base_ptr x, size_t i) { node = x; pos = i; }
+  btree_const_iterator(const iterator& rhs) { node = rhs.node; pos = rhs.pos; }
+  btree_const_iterator(const btree_const_iterator&) = default;
+  btree_const_iterator& operator=(const btree_const_iterator&) = default;
+
+  // 重载操作符
+  reference operator*()  const { return *static_cast<leaf_ptr>(node)->value(pos); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    this->inc();
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp(*this);
+    this->inc();
+    return tmp;
+  }
+  self& operator--()
+  {
+    this->dec();
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp(*this);
+    this->dec();
+    return tmp;
+  }
+};
+
+// 模板类 btree
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表分配器类型
+template <class T, class Compare, class Alloc = mystl::allocator<T>>
+class btree
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template
+                               rebind_alloc<btree_leaf<T>>>
+{
+public:
+  // btree 的嵌套型别定义
+
+  typedef btree_traits<T>                          tree_traits;
+  typedef rb_tree_value_traits<T>                  value_traits;
+  typedef btree_node_size<T>                       node_size;
+
+  typedef typename tree_traits::base_ptr           base_ptr;
+  typedef typename tree_traits::leaf_base          leaf_base;
+  typedef typename tree_traits::leaf_base_ptr      leaf_base_ptr;
+  typedef typename tree_traits::leaf_type          leaf_type;
+  typedef typename tree_traits::leaf_ptr           leaf_ptr;
+  typedef typename tree_traits::internal_type      internal_type;
+  typedef typename tree_traits::internal_ptr       internal_ptr;
+  typedef typename tree_traits::key_type           key_type;
+  typedef typename tree_traits::mapped_type        mapped_type;
+  typedef typename tree_traits::value_type         value_type;
+  typedef Compare                                  key_compare;
+
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<leaf_type>
+                                                   leaf_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<internal_type>
+                                                   internal_allocator;
+  typedef mystl::allocator_traits<leaf_allocator>  leaf_traits;
+  typedef mystl::allocator_traits<internal_allocator> internal_traits;
+
+  typedef value_type*                              pointer;
+  typedef const value_type*                        const_pointer;
+  typedef value_type&                              reference;
+  typedef const value_type&                        const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef btree_iterator<T>                        iterator;
+  typedef btree_const_iterator<T>                  const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  static constexpr size_type leaf_slots     = node_size::leaf_slots;
+  static constexpr size_type internal_slots = node_size::internal_slots;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+  key_compare    key_comp()      const { return key_comp_; }
+
+private:
+  typedef mystl::alloc_holder<leaf_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  // 用以下四个数据表现 btree
+  base_ptr    root_;      // 根节点，空树时为 nullptr
+  leaf_base   header_;    // 叶节点链表的哨兵
+  size_type   size_;      // 元素个数
+  key_compare key_comp_;  // 键值比较的准则
+
+  // 分裂时预先分配好的内部节点，保证分裂过程中不会因为分配失败而中断
+  struct spare_nodes
+  {
+    internal_ptr nodes[btree_max_height];
+    size_type    n;
+
+    spare_nodes() :n(0) {}
+    internal_ptr take() { return nodes[--n]; }
+  };
+
+  // 通过分配器构造的临时元素，emplace 先构造元素才能得到键值
+  struct value_holder
+  {
+    typename leaf_type::slot_type storage;
+    leaf_allocator&               alloc;
+
+    template <class ...Args>
+    explicit value_holder(leaf_allocator& a, Args&& ...args)
+      :alloc(a)
+    {
+      leaf_traits::construct(alloc, value(), mystl::forward<Args>(args)...);
+    }
+    ~value_holder() { leaf_traits::destroy(alloc, value()); }
+
+    value_holder(const value_holder&) = delete;
+    value_holder& operator=(const value_holder&) = delete;
+
+    value_type* value() { return reinterpret_cast<value_type*>(&storage); }
+  };
+
+  leaf_base_ptr end_node() const { return const_cast<leaf_base_ptr>(&header_); }
+
+public:
+  // 构造、复制、析构函数
+  btree() :root_(nullptr), size_(0) { header_init(); }
+
+  explicit btree(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :alloc_base(leaf_allocator(alloc)), root_(nullptr), size_(0), key_comp_(comp)
+  { header_init(); }
+
+  btree(const btree& rhs);
+  btree(const btree& rhs, const allocator_type& alloc);
+  btree(btree&& rhs) noexcept;
+  // 分配器不相等时逐个移动元素
+  btree(btree&& rhs, const allocator_type& alloc);
+
+  btree& operator=(const btree& rhs);
+  btree& operator=(btree&& rhs)
+    noexcept(leaf_traits::propagate_on_container_move_assignment::value ||
+             leaf_traits::is_always_equal::value);
+
+  ~btree() { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept
+  { return iterator(header_.next, 0); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(header_.next, 0); }
+  iterator               end()           noexcept
+  { return iterator(end_node(), 0); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(end_node(), 0); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+  // 树的高度，空树为 0，只有一个叶节点时为 1
+  size_type height()   const noexcept;
+
+  // 插入删除相关操作
+
+  // emplace
+
+  template <class ...Args>
+  iterator  emplace_multi(Args&& ...args);
+
+  template <class ...Args>
+  mystl::pair<iterator, bool> emplace_unique(Args&& ...args);
+
+  template <class ...Args>
+  iterator  emplace_multi_use_hint(iterator hint, Args&& ...args);
+
+  template <class ...Args>
+  iterator  emplace_unique_use_hint(iterator hint, Args&& ...args);
+
+  // insert
+
+  iterator  insert_multi(const value_type& value)
+  {
+    return insert_multi_value(value);
+  }
+  iterator  insert_multi(value_type&& value)
+  {
+    return insert_multi_value(mystl::move(value));
+  }
+
+  iterator  insert_multi(iterator hint, const value_type& value)
+  {
+    return insert_multi_hint_value(hint, value);
+  }
+  iterator  insert_multi(iterator hint, value_type&& value)
+  {
+    return insert_multi_hint_value(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void      insert_multi(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      insert_multi(end(), *first);
+  }
+
+  mystl::pair<iterator, bool> insert_unique(const value_type& value)
+  {
+    return insert_unique_value(value);
+  }
+  mystl::pair<iterator, bool> insert_unique(value_type&& value)
+  {
+    return insert_unique_value(mystl::move(value));
+  }
+
+  iterator  insert_unique(iterator hint, const value_type& value)
+  {
+    return insert_unique_hint_value(hint, value);
+  }
+  iterator  insert_unique(iterator hint, value_type&& value)
+  {
+    return insert_unique_hint_value(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void      insert_unique(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      insert_unique(end(), *first);
+  }
+
+  // erase
+
+  iterator  erase(iterator position);
+
+  size_type erase_multi(const key_type& key);
+  size_type erase_unique(const key_type& key);
+
+  iterator  erase(iterator first, iterator last);
+
+  void      clear();
+
+  // btree 相关操作
+
+  iterator       find(const key_type& key)
+  { return find_node(key); }
+  const_iterator find(const key_type& key) const
+  { return find_node(key); }
+
+  size_type      count_multi(const key_type& key) const
+  {
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+  size_type      count_unique(const key_type& key) const
+  {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  iterator       lower_bound(const key_type& key)
+  { return lower_bound_node(key); }
+  const_iterator lower_bound(const key_type& key) const
+  { return lower_bound_node(key); }
+
+  iterator       upper_bound(const key_type& key)
+  { return upper_bound_node(key); }
+  const_iterator upper_bound(const key_type& key) const
+  { return upper_bound_node(key); }
+
+  // 查找 key 的范围
+  mystl::pair<iterator, iterator>
+  equal_range_multi(const key_type& key)
+  {
+    return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_multi(const key_type& key) const
+  {
+    return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  mystl::pair<iterator, iterator>
+  equal_range_unique(const key_type& key)
+  {
+    iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_unique(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+
+  // 异构查找：仅当 Compare 声明了 is_transparent 时（如 mystl::less<>）才启用
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return find_node(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key) const
+  { return find_node(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count_multi(const K& key) const
+  {
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count_unique(const K& key) const
+  {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)
+  { return lower_bound_node(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key) const
+  { return lower_bound_node(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)
+  { return upper_bound_node(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key) const
+  { return upper_bound_node(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<iterator, iterator>
+  equal_range_multi(const K& key)
+  {
+    return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_multi(const K& key) const
+  {
+    return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<iterator, iterator>
+  equal_range_unique(const K& key)
+  {
+    iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_unique(const K& key) const
+  {
+    const_iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+
+  void swap(btree& rhs) noexcept;
+
+private:
+
+  // node related
+  static leaf_ptr     as_leaf(base_ptr x)     { return static_cast<leaf_ptr>(x); }
+  static leaf_ptr     as_leaf(leaf_base_ptr x) { return static_cast<leaf_ptr>(x); }
+  static internal_ptr as_internal(base_ptr x) { return static_cast<internal_ptr>(x); }
+
+  leaf_ptr     create_leaf();
+  internal_ptr create_internal();
+  void         destroy_leaf(leaf_ptr x) noexcept;
+  void         destroy_internal(internal_ptr x) noexcept;
+  void         destroy_subtree(base_ptr x) noexcept;
+
+  // 元素与分隔键的构造、移动
+  void     move_value(leaf_ptr dst, size_type di, leaf_ptr src, size_type si);
+  void     move_key(internal_ptr dst, size_type di, internal_ptr src, size_type si);
+  void     set_child(internal_ptr p, size_type i, base_ptr child);
+
+  // init / reset
+  void     header_init() noexcept;
+  void     relink_header() noexcept;
+  void     take_from(btree& rhs) noexcept;
+  void     copy_from(const btree& rhs);
+
+  // move
+  void     move_assign(btree& rhs, m_true_type) noexcept;
+  void     move_assign(btree& rhs, m_false_type);
+  void     move_elements(btree& rhs);
+
+  // 节点内的二分查找
+  template <class K>
+  size_type leaf_lower(leaf_ptr x, const K& key) const;
+  template <class K>
+  size_type leaf_upper(leaf_ptr x, const K& key) const;
+  template <class K>
+  size_type internal_lower(internal_ptr x, const K& key) const;
+  template <class K>
+  size_type internal_upper(internal_ptr x, const K& key) const;
+
+  // find / lower_bound / upper_bound 的实现
+  iterator make_iter(leaf_ptr x, size_type pos) const
+  {
+    return pos == x->count ? iterator(x->next, 0) : iterator(x, pos);
+  }
+  template <class K>
+  iterator find_node(const K& key) const;
+  template <class K>
+  iterator lower_bound_node(const K& key) const;
+  template <class K>
+  iterator upper_bound_node(const K& key) const;
+
+  // get insert pos
+  leaf_ptr get_insert_multi_pos(const key_type& key, size_type& pos) const;
+  leaf_ptr get_insert_unique_pos(const key_type& key, size_type& pos, bool& exist) const;
+
+  // insert value
+  template <class V>
+  iterator insert_multi_value(V&& value);
+  template <class V>
+  mystl::pair<iterator, bool> insert_unique_value(V&& value);
+  template <class V>
+  iterator insert_multi_hint_value(iterator hint, V&& value);
+  template <class V>
+  iterator insert_unique_hint_value(iterator hint, V&& value);
+  leaf_ptr adjust_hint_pos(leaf_ptr x, size_type& pos, const key_type& key) const;
+  template <class V>
+  iterator insert_value_at(leaf_ptr x, size_type pos, const key_type& key, V&& value);
+
+  // split
+  void     reserve_spare(leaf_ptr x, spare_nodes& spare);
+  void     free_spare(spare_nodes& spare) noexcept;
+  leaf_ptr split_leaf(leaf_ptr x, size_type& pos, leaf_ptr y,
+                      key_type&& sep, spare_nodes& spare) noexcept;
+  void     insert_child(internal_ptr p, base_ptr left, key_type&& sep,
+                        base_ptr right, spare_nodes& spare) noexcept;
+  void     internal_insert(internal_ptr p, size_type i, key_type&& sep, base_ptr right) noexcept;
+
+  // erase
+  iterator rebalance_leaf(leaf_ptr x, size_type pos);
+  void     remove_child(internal_ptr p, size_type k) noexcept;
+  void     rebalance_internal(internal_ptr p) noexcept;
+  void     merge_internal(internal_ptr l, internal_ptr r) noexcept;
+};
+
+/*****************************************************************************************/
+
+// 复制构造函数
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::
+btree(const btree& rhs)
+  :alloc_base(leaf_traits::select_on_container_copy_construction(rhs.M_alloc())),
+  root_(nullptr), size_(0), key_comp_(rhs.key_comp_)
+{
+  header_init();
+  copy_from(rhs);
+}
+
+// 带分配器的复制构造函数
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::
+btree(const btree& rhs, const allocator_type& alloc)
+  :alloc_base(leaf_allocator(alloc)), root_(nullptr), size_(0), key_comp_(rhs.key_comp_)
+{
+  header_init();
+  copy_from(rhs);
+}
+
+// 移动构造函数
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::
+btree(btree&& rhs) noexcept
+  :alloc_base(mystl::move(rhs.M_alloc())), root_(nullptr), size_(0), key_comp_(rhs.key_comp_)
+{
+  header_init();
+  take_from(rhs);
+}
+
+// 带分配器的移动构造函数
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>::
+btree(btree&& rhs, const allocator_type& alloc)
+  :alloc_base(leaf_allocator(alloc)), root_(nullptr), size_(0), key_comp_(rhs.key_comp_)
+{
+  header_init();
+  if (leaf_traits::equal(M_alloc(), rhs.M_alloc()))
+    take_from(rhs);
+  else
+    move_elements(rhs);
+}
+
+// 复制赋值操作符
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>&
+btree<T, Compare, Alloc>::
+operator=(const btree& rhs)
+{
+  if (this != &rhs)
+  {
+    clear();
+    // 旧的节点已经由旧的分配器释放
+    mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(),
+                             typename leaf_traits::propagate_on_container_copy_assignment());
+    key_comp_ = rhs.key_comp_;
+    copy_from(rhs);
+  }
+  return *this;
+}
+
+// 移动赋值操作符
+template <class T, class Compare, class Alloc>
+btree<T, Compare, Alloc>&
+btree<T, Compare, Alloc>::
+operator=(btree&& rhs)
+  noexcept(leaf_traits::propagate_on_container_move_assignment::value ||
+           leaf_traits::is_always_equal::value)
+{
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                leaf_traits::propagate_on_container_move_assignment::value ||
+                leaf_traits::is_always_equal::value>());
+  }
+  return *this;
+}
+
+// 树的高度
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+height() const noexcept
+{
+  size_type h = 0;
+  for (base_ptr x = root_; x != nullptr; ++h)
+    x = x->leaf ? nullptr : as_internal(x)->children[0];
+  return h;
+}
+
+// 就地插入元素，键值允许重复
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+emplace_multi(Args&& ...args)
+{
+  value_holder tmp(M_alloc(), mystl::forward<Args>(args)...);
+  return insert_multi_value(mystl::move(*tmp.value()));
+}
+
+// 就地插入元素，键值不允许重复
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+mystl::pair<typename btree<T, Compare, Alloc>::iterator, bool>
+btree<T, Compare, Alloc>::
+emplace_unique(Args&& ...args)
+{
+  value_holder tmp(M_alloc(), mystl::forward<Args>(args)...);
+  return insert_unique_value(mystl::move(*tmp.value()));
+}
+
+// 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+emplace_multi_use_hint(iterator hint, Args&& ...args)
+{
+  value_holder tmp(M_alloc(), mystl::forward<Args>(args)...);
+  return insert_multi_hint_value(hint, mystl::move(*tmp.value()));
+}
+
+// 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+emplace_unique_use_hint(iterator hint, Args&& ...args)
+{
+  value_holder tmp(M_alloc(), mystl::forward<Args>(args)...);
+  return insert_unique_hint_value(hint, mystl::move(*tmp.value()));
+}
+
+// 删除 position 位置的元素，返回指向下一个元素的迭代器
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+erase(iterator position)
+{
+  leaf_ptr x = as_leaf(position.node);
+  const size_type pos = position.pos;
+  leaf_traits::destroy(M_alloc(), x->value(pos));
+  for (size_type i = pos + 1; i < x->count; ++i)
+    move_value(x, i - 1, x, i);
+  --x->count;
+  --size_;
+  if (x == root_)
+  {
+    if (x->count == 0)
+    {
+      destroy_leaf(x);
+      root_ = nullptr;
+      header_init();
+      return end();
+    }
+    return make_iter(x, pos);
+  }
+  if (x->count >= node_size::leaf_min)
+    return make_iter(x, pos);
+  return rebalance_leaf(x, pos);
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+erase_multi(const key_type& key)
+{
+  auto p = equal_range_multi(key);
+  size_type n = mystl::distance(p.first, p.second);
+  erase(p.first, p.second);
+  return n;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+erase_unique(const key_type& key)
+{
+  auto it = find(key);
+  if (it != end())
+  {
+    erase(it);
+    return 1;
+  }
+  return 0;
+}
+
+// 删除 [first, last) 区间内的元素
+// 删除会移动元素，last 在过程中可能失效，所以先求出要删除的个数
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+erase(iterator first, iterator last)
+{
+  if (first == begin() && last == end())
+  {
+    clear();
+    return end();
+  }
+  for (size_type n = mystl::distance(first, last); n > 0; --n)
+    first = erase(first);
+  return first;
+}
+
+// 清空 btree
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+clear()
+{
+  if (root_ != nullptr)
+  {
+    destroy_subtree(root_);
+    root_ = nullptr;
+    size_ = 0;
+    header_init();
+  }
+}
+
+// 交换 btree，两者的哨兵留在原处，只交换首尾叶节点的链接
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+swap(btree& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    MYSTL_DEBUG(leaf_traits::propagate_on_container_swap::value ||
+                leaf_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename leaf_traits::propagate_on_container_swap());
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(header_.prev, rhs.header_.prev);
+    mystl::swap(header_.next, rhs.header_.next);
+    mystl::swap(key_comp_, rhs.key_comp_);
+    relink_header();
+    rhs.relink_header();
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建一个叶节点
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::leaf_ptr
+btree<T, Compare, Alloc>::
+create_leaf()
+{
+  leaf_ptr x = leaf_traits::allocate(M_alloc(), 1);
+  x->parent = nullptr;
+  x->position = 0;
+  x->count = 0;
+  x->leaf = true;
+  x->prev = nullptr;
+  x->next = nullptr;
+  return x;
+}
+
+// 创建一个内部节点
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::internal_ptr
+btree<T, Compare, Alloc>::
+create_internal()
+{
+  internal_allocator ia(M_alloc());
+  internal_ptr x = internal_traits::allocate(ia, 1);
+  x->parent = nullptr;
+  x->position = 0;
+  x->count = 0;
+  x->leaf = false;
+  return x;
+}
+
+// 释放节点，节点中的元素或分隔键需要事先析构
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+destroy_leaf(leaf_ptr x) noexcept
+{
+  leaf_traits::deallocate(M_alloc(), x, 1);
+}
+
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+destroy_internal(internal_ptr x) noexcept
+{
+  internal_allocator ia(M_alloc());
+  internal_traits::deallocate(ia, x, 1);
+}
+
+// 析构并释放以 x 为根的子树
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+destroy_subtree(base_ptr x) noexcept
+{
+  if (x->leaf)
+  {
+    leaf_ptr l = as_leaf(x);
+    leaf_traits::destroy(M_alloc(), l->value(0), l->value(0) + l->count);
+    destroy_leaf(l);
+  }
+  else
+  {
+    internal_ptr p = as_internal(x);
+    internal_allocator ia(M_alloc());
+    for (size_type i = 0; i <= p->count; ++i)
+      destroy_subtree(p->children[i]);
+    internal_traits::destroy(ia, p->key(0), p->key(0) + p->count);
+    destroy_internal(p);
+  }
+}
+
+// 把 src 中的一个元素移动到 dst 的空位上
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+move_value(leaf_ptr dst, size_type di, leaf_ptr src, size_type si)
+{
+  leaf_traits::construct(M_alloc(), dst->value(di), mystl::move(*src->value(si)));
+  leaf_traits::destroy(M_alloc(), src->value(si));
+}
+
+// 把 src 中的一个分隔键移动到 dst 的空位上
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+move_key(internal_ptr dst, size_type di, internal_ptr src, size_type si)
+{
+  internal_allocator ia(M_alloc());
+  internal_traits::construct(ia, dst->key(di), mystl::move(*src->key(si)));
+  internal_traits::destroy(ia, src->key(si));
+}
+
+// 设置 p 的第 i 个子节点
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+set_child(internal_ptr p, size_type i, base_ptr child)
+{
+  p->children[i] = child;
+  child->parent = p;
+  child->position = static_cast<unsigned short>(i);
+}
+
+// 空树的哨兵指向自己
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+header_init() noexcept
+{
+  header_.parent = nullptr;
+  header_.position = 0;
+  header_.count = 0;
+  header_.leaf = true;
+  header_.prev = &header_;
+  header_.next = &header_;
+}
+
+// 首尾叶节点改为指向本树的哨兵
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+relink_header() noexcept
+{
+  if (root_ == nullptr)
+  {
+    header_init();
+  }
+  else
+  {
+    header_.next->prev = &header_;
+    header_.prev->next = &header_;
+  }
+}
+
+// 接管 rhs 的全部节点，本树需为空
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+take_from(btree& rhs) noexcept
+{
+  if (rhs.root_ == nullptr)
+    return;
+  root_ = rhs.root_;
+  size_ = rhs.size_;
+  header_.next = rhs.header_.next;
+  header_.prev = rhs.header_.prev;
+  relink_header();
+  rhs.root_ = nullptr;
+  rhs.size_ = 0;
+  rhs.header_init();
+}
+
+// 按顺序把 rhs 的元素追加到空树中，追加时叶节点是满的
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+copy_from(const btree& rhs)
+{
+  try
+  {
+    for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      insert_multi_hint_value(end(), *it);
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+// move_assign 函数
+// 可以接管 rhs 的节点：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+move_assign(btree& rhs, m_true_type) noexcept
+{
+  clear();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename leaf_traits::propagate_on_container_move_assignment());
+  key_comp_ = rhs.key_comp_;
+  take_from(rhs);
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+move_assign(btree& rhs, m_false_type)
+{
+  if (leaf_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  key_comp_ = rhs.key_comp_;
+  move_elements(rhs);
+}
+
+// move_elements 函数
+// 把 rhs 的元素按顺序移动到本树的末尾，rhs 随后被清空
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+move_elements(btree& rhs)
+{
+  for (auto it = rhs.begin(); it != rhs.end(); ++it)
+    insert_multi_hint_value(end(), mystl::move(*it));
+  rhs.clear();
+}
+
+// 叶节点中第一个不小于 key 的位置
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+leaf_lower(leaf_ptr x, const K& key) const
+{
+  size_type lo = 0, hi = x->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) >> 1;
+    if (key_comp_(value_traits::get_key(*x->value(mid)), key))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// 叶节点中第一个大于 key 的位置
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+leaf_upper(leaf_ptr x, const K& key) const
+{
+  size_type lo = 0, hi = x->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) >> 1;
+    if (key_comp_(key, value_traits::get_key(*x->value(mid))))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+// 内部节点中小于 key 的分隔键的个数，即 lower_bound 所在的子节点
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+internal_lower(internal_ptr x, const K& key) const
+{
+  size_type lo = 0, hi = x->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) >> 1;
+    if (key_comp_(*x->key(mid), key))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// 内部节点中不大于 key 的分隔键的个数，即 upper_bound 所在的子节点
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::size_type
+btree<T, Compare, Alloc>::
+internal_upper(internal_ptr x, const K& key) const
+{
+  size_type lo = 0, hi = x->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) >> 1;
+    if (key_comp_(key, *x->key(mid)))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+// 查找键值为 key 的元素，找不到时返回 end()
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+find_node(const K& key) const
+{
+  iterator it = lower_bound_node(key);
+  if (it.node != end_node() && !key_comp_(key, value_traits::get_key(*it)))
+    return it;
+  return iterator(end_node(), 0);
+}
+
+// 键值不小于 key 的第一个元素
+// 前面的子树中的键都小于 key，若本叶节点中没有，就是下一个叶节点的第一个元素
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+lower_bound_node(const K& key) const
+{
+  if (root_ == nullptr)
+    return iterator(end_node(), 0);
+  base_ptr x = root_;
+  while (!x->leaf)
+  {
+    internal_ptr p = as_internal(x);
+    x = p->children[internal_lower(p, key)];
+  }
+  leaf_ptr l = as_leaf(x);
+  return make_iter(l, leaf_lower(l, key));
+}
+
+// 键值大于 key 的第一个元素
+template <class T, class Compare, class Alloc>
+template <class K>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+upper_bound_node(const K& key) const
+{
+  if (root_ == nullptr)
+    return iterator(end_node(), 0);
+  base_ptr x = root_;
+  while (!x->leaf)
+  {
+    internal_ptr p = as_internal(x);
+    x = p->children[internal_upper(p, key)];
+  }
+  leaf_ptr l = as_leaf(x);
+  return make_iter(l, leaf_upper(l, key));
+}
+
+// 键值允许重复时的插入位置：等于 key 的元素之后
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::leaf_ptr
+btree<T, Compare, Alloc>::
+get_insert_multi_pos(const key_type& key, size_type& pos) const
+{
+  base_ptr x = root_;
+  while (!x->leaf)
+  {
+    internal_ptr p = as_internal(x);
+    x = p->children[internal_upper(p, key)];
+  }
+  leaf_ptr l = as_leaf(x);
+  pos = leaf_upper(l, key);
+  return l;
+}
+
+// 键值不允许重复时的插入位置，exist 表示是否已有相同的键值，此时 pos 指向该元素
+// 插入位置在叶节点末尾时，相同的键值可能是下一个叶节点的第一个元素
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::leaf_ptr
+btree<T, Compare, Alloc>::
+get_insert_unique_pos(const key_type& key, size_type& pos, bool& exist) const
+{
+  base_ptr x = root_;
+  while (!x->leaf)
+  {
+    internal_ptr p = as_internal(x);
+    x = p->children[internal_lower(p, key)];
+  }
+  leaf_ptr l = as_leaf(x);
+  pos = leaf_lower(l, key);
+  if (pos < l->count)
+  {
+    exist = !key_comp_(key, value_traits::get_key(*l->value(pos)));
+  }
+  else if (l->next != end_node())
+  {
+    leaf_ptr n = as_leaf(l->next);
+    exist = !key_comp_(key, value_traits::get_key(*n->value(0)));
+    if (exist)
+    {
+      pos = 0;
+      return n;
+    }
+  }
+  else
+  {
+    exist = false;
+  }
+  return l;
+}
+
+// 插入元素，键值允许重复
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+insert_multi_value(V&& value)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+  if (root_ == nullptr)
+    return insert_value_at(nullptr, 0, value_traits::get_key(value), mystl::forward<V>(value));
+  size_type pos = 0;
+  leaf_ptr x = get_insert_multi_pos(value_traits::get_key(value), pos);
+  return insert_value_at(x, pos, value_traits::get_key(value), mystl::forward<V>(value));
+}
+
+// 插入元素，键值不允许重复
+template <class T, class Compare, class Alloc>
+template <class V>
+mystl::pair<typename btree<T, Compare, Alloc>::iterator, bool>
+btree<T, Compare, Alloc>::
+insert_unique_value(V&& value)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+  if (root_ == nullptr)
+  {
+    return mystl::make_pair(insert_value_at(nullptr, 0, value_traits::get_key(value),
+                                            mystl::forward<V>(value)), true);
+  }
+  size_type pos = 0;
+  bool exist = false;
+  leaf_ptr x = get_insert_unique_pos(value_traits::get_key(value), pos, exist);
+  if (exist)
+    return mystl::make_pair(iterator(x, pos), false);
+  return mystl::make_pair(insert_value_at(x, pos, value_traits::get_key(value),
+                                          mystl::forward<V>(value)), true);
+}
+
+// 使用 hint 插入元素，键值允许重复
+// key 位于 hint 与它的前一个元素之间时直接插入到 hint 之前，hint 为 end() 时即为追加
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+insert_multi_hint_value(iterator hint, V&& value)
+{
+  if (root_ == nullptr)
+    return insert_multi_value(mystl::forward<V>(value));
+  const key_type& key = value_traits::get_key(value);
+  if (hint.node == end_node())
+  {
+    leaf_ptr last = as_leaf(header_.prev);
+    if (!key_comp_(key, value_traits::get_key(*last->value(last->count - 1))))
+    {
+      THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+      return insert_value_at(last, last->count, key, mystl::forward<V>(value));
+    }
+  }
+  else if (!key_comp_(value_traits::get_key(*hint), key))
+  {
+    leaf_ptr x = as_leaf(hint.node);
+    size_type pos = hint.pos;
+    if (pos > 0 ? !key_comp_(key, value_traits::get_key(*x->value(pos - 1)))
+                : (x->prev == end_node() ||
+                   !key_comp_(key, value_traits::get_key(*as_leaf(x->prev)->value(
+                     x->prev->count - 1)))))
+    {
+      THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+      x = adjust_hint_pos(x, pos, key);
+      return insert_value_at(x, pos, key, mystl::forward<V>(value));
+    }
+  }
+  return insert_multi_value(mystl::forward<V>(value));
+}
+
+// 使用 hint 插入元素，键值不允许重复
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+insert_unique_hint_value(iterator hint, V&& value)
+{
+  if (root_ == nullptr)
+    return insert_unique_value(mystl::forward<V>(value)).first;
+  const key_type& key = value_traits::get_key(value);
+  if (hint.node == end_node())
+  {
+    leaf_ptr last = as_leaf(header_.prev);
+    if (key_comp_(value_traits::get_key(*last->value(last->count - 1)), key))
+    {
+      THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+      return insert_value_at(last, last->count, key, mystl::forward<V>(value));
+    }
+  }
+  else if (key_comp_(key, value_traits::get_key(*hint)))
+  {
+    leaf_ptr x = as_leaf(hint.node);
+    size_type pos = hint.pos;
+    if (pos > 0 ? key_comp_(value_traits::get_key(*x->value(pos - 1)), key)
+                : (x->prev == end_node() ||
+                   key_comp_(value_traits::get_key(*as_leaf(x->prev)->value(
+                     x->prev->count - 1)), key)))
+    {
+      THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "btree<T, Comp>'s size too big");
+      x = adjust_hint_pos(x, pos, key);
+      return insert_value_at(x, pos, key, mystl::forward<V>(value));
+    }
+  }
+  return insert_unique_value(mystl::forward<V>(value)).first;
+}
+
+// 在叶节点 x 的开头插入时，新元素也可以放在前一个叶节点的末尾，
+// 两者之间的分隔键决定哪一个位置满足分隔键的约束
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::leaf_ptr
+btree<T, Compare, Alloc>::
+adjust_hint_pos(leaf_ptr x, size_type& pos, const key_type& key) const
+{
+  if (pos != 0 || x->prev == end_node())
+    return x;
+  base_ptr y = x;
+  while (y->position == 0)
+    y = y->parent;
+  if (key_comp_(*y->parent->key(y->position - 1), key))
+    return x;
+  leaf_ptr l = as_leaf(x->prev);
+  pos = l->count;
+  return l;
+}
+
+// 在叶节点 x 的 pos 处构造元素，x 为 nullptr 时树为空
+// 叶节点未满时先腾出位置再构造，构造失败时把元素移回原处；
+// 叶节点已满时先把元素构造在临时位置，分裂完成后再移动进去
+template <class T, class Compare, class Alloc>
+template <class V>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+insert_value_at(leaf_ptr x, size_type pos, const key_type& key, V&& value)
+{
+  if (x == nullptr)
+  {
+    x = create_leaf();
+    try
+    {
+      leaf_traits::construct(M_alloc(), x->value(0), mystl::forward<V>(value));
+    }
+    catch (...)
+    {
+      destroy_leaf(x);
+      throw;
+    }
+    x->count = 1;
+    x->prev = x->next = &header_;
+    header_.prev = header_.next = x;
+    root_ = x;
+    size_ = 1;
+    return iterator(x, 0);
+  }
+  if (x->count < leaf_slots)
+  {
+    for (size_type i = x->count; i > pos; --i)
+      move_value(x, i, x, i - 1);
+    try
+    {
+      leaf_traits::construct(M_alloc(), x->value(pos), mystl::forward<V>(value));
+    }
+    catch (...)
+    {
+      for (size_type i = pos; i < x->count; ++i)
+        move_value(x, i, x, i + 1);
+      throw;
+    }
+    ++x->count;
+    ++size_;
+    return iterator(x, pos);
+  }
+  // 需要分裂，先完成所有可能抛出异常的操作：复制分隔键，构造元素，分配节点
+  // key 可能引用 value 中的键，要在移动 value 之前复制
+  key_type sep(pos == x->count ? key : value_traits::get_key(*x->value(x->count / 2)));
+  value_holder tmp(M_alloc(), mystl::forward<V>(value));
+  spare_nodes spare;
+  reserve_spare(x, spare);
+  leaf_ptr y = nullptr;
+  try
+  {
+    y = create_leaf();
+  }
+  catch (...)
+  {
+    free_spare(spare);
+    throw;
+  }
+  x = split_leaf(x, pos, y, mystl::move(sep), spare);
+  for (size_type i = x->count; i > pos; --i)
+    move_value(x, i, x, i - 1);
+  leaf_traits::construct(M_alloc(), x->value(pos), mystl::move(*tmp.value()));
+  ++x->count;
+  ++size_;
+  return iterator(x, pos);
+}
+
+// 为叶节点 x 的分裂预先分配内部节点：每个已满的祖先需要一个，一路满到根时还需要一个新的根
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+reserve_spare(leaf_ptr x, spare_nodes& spare)
+{
+  size_type need = 0;
+  internal_ptr p = x->parent;
+  for (; p != nullptr && p->count == internal_slots; p = p->parent)
+    ++need;
+  if (p == nullptr)
+    ++need;
+  try
+  {
+    for (; spare.n < need; ++spare.n)
+      spare.nodes[spare.n] = create_internal();
+  }
+  catch (...)
+  {
+    free_spare(spare);
+    throw;
+  }
+}
+
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+free_spare(spare_nodes& spare) noexcept
+{
+  while (spare.n > 0)
+    destroy_internal(spare.take());
+}
+
+// 分裂叶节点 x，y 为新的空叶节点，sep 为分隔键
+// 在末尾插入时 x 保持不变，新元素放入 y；否则后一半元素移到 y
+// 返回新元素所在的叶节点，pos 同时调整为在该节点中的位置
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::leaf_ptr
+btree<T, Compare, Alloc>::
+split_leaf(leaf_ptr x, size_type& pos, leaf_ptr y, key_type&& sep, spare_nodes& spare) noexcept
+{
+  const size_type split = pos == x->count ? x->count : x->count / 2;
+  for (size_type i = split; i < x->count; ++i)
+    move_value(y, i - split, x, i);
+  y->count = static_cast<unsigned short>(x->count - split);
+  x->count = static_cast<unsigned short>(split);
+  // 链入叶节点链表
+  y->prev = x;
+  y->next = x->next;
+  x->next->prev = y;
+  x->next = y;
+  insert_child(x->parent, x, mystl::move(sep), y, spare);
+  free_spare(spare);
+  if (pos < split || (pos == split && split < leaf_slots))
+    return x;
+  pos -= split;
+  return y;
+}
+
+// 在 left 之后插入子节点 right 与分隔键 sep，p 为 left 的父节点，p 已满时先分裂 p
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+insert_child(internal_ptr p, base_ptr left, key_type&& sep,
+             base_ptr right, spare_nodes& spare) noexcept
+{
+  internal_allocator ia(M_alloc());
+  if (p == nullptr)
+  { // left 为根节点，树长高一层
+    internal_ptr r = spare.take();
+    internal_traits::construct(ia, r->key(0), mystl::move(sep));
+    r->count = 1;
+    set_child(r, 0, left);
+    set_child(r, 1, right);
+    root_ = r;
+    return;
+  }
+  const size_type i = left->position;
+  if (p->count < internal_slots)
+  {
+    internal_insert(p, i, mystl::move(sep), right);
+    return;
+  }
+  // p 已满：前 mid 个分隔键留在 p，第 mid 个上移，其余移到 q
+  internal_ptr q = spare.take();
+  const size_type mid = p->count / 2;
+  key_type up(mystl::move(*p->key(mid)));
+  internal_traits::destroy(ia, p->key(mid));
+  for (size_type k = mid + 1; k < p->count; ++k)
+    move_key(q, k - mid - 1, p, k);
+  for (size_type k = mid + 1; k <= p->count; ++k)
+    set_child(q, k - mid - 1, p->children[k]);
+  q->count = static_cast<unsigned short>(p->count - mid - 1);
+  p->count = static_cast<unsigned short>(mid);
+  if (i <= mid)
+    internal_insert(p, i, mystl::move(sep), right);
+  else
+    internal_insert(q, i - mid - 1, mystl::move(sep), right);
+  insert_child(p->parent, p, mystl::move(up), q, spare);
+}
+
+// 在未满的内部节点 p 中第 i 个子节点之后插入分隔键 sep 与子节点 right
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+internal_insert(internal_ptr p, size_type i, key_type&& sep, base_ptr right) noexcept
+{
+  internal_allocator ia(M_alloc());
+  for (size_type k = p->count; k > i; --k)
+    move_key(p, k, p, k - 1);
+  internal_traits::construct(ia, p->key(i), mystl::move(sep));
+  for (size_type k = p->count + 1; k > i + 1; --k)
+    set_child(p, k, p->children[k - 1]);
+  set_child(p, i + 1, right);
+  ++p->count;
+}
+
+// 叶节点 x 元素过少，与兄弟节点合并或者向兄弟节点借一个元素
+// pos 为删除位置，返回调整后指向原来 pos 处元素的迭代器
+template <class T, class Compare, class Alloc>
+typename btree<T, Compare, Alloc>::iterator
+btree<T, Compare, Alloc>::
+rebalance_leaf(leaf_ptr x, size_type pos)
+{
+  internal_ptr p = x->parent;
+  const size_type i = x->position;
+  if (i > 0)
+  {
+    leaf_ptr l = as_leaf(p->children[i - 1]);
+    if (l->count + x->count <= leaf_slots)
+    { // x 并入 l
+      const size_type off = l->count;
+      for (size_type k = 0; k < x->count; ++k)
+        move_value(l, off + k, x, k);
+      l->count = static_cast<unsigned short>(off + x->count);
+      l->next = x->next;
+      x->next->prev = l;
+      destroy_leaf(x);
+      remove_child(p, i - 1);
+      rebalance_internal(p);
+      return make_iter(l, off + pos);
+    }
+    // 借 l 的最后一个元素
+    for (size_type k = x->count; k > 0; --k)
+      move_value(x, k, x, k - 1);
+    move_value(x, 0, l, l->count - 1);
+    --l->count;
+    ++x->count;
+    *p->key(i - 1) = value_traits::get_key(*x->value(0));
+    return make_iter(x, pos + 1);
+  }
+  leaf_ptr r = as_leaf(p->children[1]);
+  if (x->count + r->count <= leaf_slots)
+  { // r 并入 x
+    const size_type off = x->count;
+    for (size_type k = 0; k < r->count; ++k)
+      move_value(x, off + k, r, k);
+    x->count = static_cast<unsigned short>(off + r->count);
+    x->next = r->next;
+    r->next->prev = x;
+    destroy_leaf(r);
+    remove_child(p, 0);
+    rebalance_internal(p);
+    return make_iter(x, pos);
+  }
+  // 借 r 的第一个元素
+  move_value(x, x->count, r, 0);
+  for (size_type k = 1; k < r->count; ++k)
+    move_value(r, k - 1, r, k);
+  --r->count;
+  ++x->count;
+  *p->key(0) = value_traits::get_key(*r->value(0));
+  return make_iter(x, pos);
+}
+
+// 删除 p 的第 k 个分隔键与第 k + 1 个子节点
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+remove_child(internal_ptr p, size_type k) noexcept
+{
+  internal_allocator ia(M_alloc());
+  internal_traits::destroy(ia, p->key(k));
+  for (size_type j = k + 1; j < p->count; ++j)
+    move_key(p, j - 1, p, j);
+  for (size_type j = k + 2; j <= p->count; ++j)
+    set_child(p, j - 1, p->children[j]);
+  --p->count;
+}
+
+// 内部节点 p 失去一个子节点之后的调整
+// 根节点只剩一个子节点时树降低一层，非根节点过少时与兄弟节点合并或者经由父节点旋转一个分隔键
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+rebalance_internal(internal_ptr p) noexcept
+{
+  internal_allocator ia(M_alloc());
+  while (true)
+  {
+    if (p == root_)
+    {
+      if (p->count == 0)
+      {
+        root_ = p->children[0];
+        root_->parent = nullptr;
+        root_->position = 0;
+        destroy_internal(p);
+      }
+      return;
+    }
+    if (p->count >= node_size::internal_min)
+      return;
+    internal_ptr g = p->parent;
+    const size_type i = p->position;
+    if (i > 0)
+    {
+      internal_ptr l = as_internal(g->children[i - 1]);
+      if (l->count + 1 + p->count <= internal_slots)
+      {
+        merge_internal(l, p);
+        p = g;
+        continue;
+      }
+      // 向右旋转：g 的分隔键下移到 p 的开头，l 的最后一个分隔键上移到 g
+      for (size_type k = p->count; k > 0; --k)
+        move_key(p, k, p, k - 1);
+      for (size_type k = p->count + 1; k > 0; --k)
+        set_child(p, k, p->children[k - 1]);
+      move_key(p, 0, g, i - 1);
+      set_child(p, 0, l->children[l->count]);
+      move_key(g, i - 1, l, l->count - 1);
+      --l->count;
+      ++p->count;
+      return;
+    }
+    internal_ptr r = as_internal(g->children[1]);
+    if (p->count + 1 + r->count <= internal_slots)
+    {
+      merge_internal(p, r);
+      p = g;
+      continue;
+    }
+    // 向左旋转：g 的分隔键下移到 p 的末尾，r 的第一个分隔键上移到 g
+    move_key(p, p->count, g, 0);
+    set_child(p, p->count + 1, r->children[0]);
+    move_key(g, 0, r, 0);
+    for (size_type k = 1; k < r->count; ++k)
+      move_key(r, k - 1, r, k);
+    for (size_type k = 1; k <= r->count; ++k)
+      set_child(r, k - 1, r->children[k]);
+    --r->count;
+    ++p->count;
+    return;
+  }
+}
+
+// 把相邻的内部节点 r 并入 l，两者之间的分隔键一同下移，r 被释放
+template <class T, class Compare, class Alloc>
+void btree<T, Compare, Alloc>::
+merge_internal(internal_ptr l, internal_ptr r) noexcept
+{
+  internal_ptr g = l->parent;
+  const size_type k = l->position;
+  const size_type off = l->count + 1;
+  move_key(l, l->count, g, k);
+  for (size_type j = 0; j < r->count; ++j)
+    move_key(l, off + j, r, j);
+  for (size_type j = 0; j <= r->count; ++j)
+    set_child(l, off + j, r->children[j]);
+  l->count = static_cast<unsigned short>(off + r->count);
+  destroy_internal(r);
+  // g 的第 k 个分隔键已经移走，只需要左移其余的分隔键与子节点
+  for (size_type j = k + 1; j < g->count; ++j)
+    move_key(g, j - 1, g, j);
+  for (size_type j = k + 2; j <= g->count; ++j)
+    set_child(g, j - 1, g->children[j]);
+  --g->count;
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+template <class T, class Compare, class Alloc>
+bool operator==(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare, class Alloc>
+bool operator<(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Compare, class Alloc>
+bool operator!=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Compare, class Alloc>
+bool operator>(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Compare, class Alloc>
+bool operator<=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Compare, class Alloc>
+bool operator>=(const btree<T, Compare, Alloc>& lhs, const btree<T, Compare, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare, class Alloc>
+void swap(btree<T, Compare, Alloc>& lhs, btree<T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_BTREE_H_
+
@@ -0,0 +1,375 @@
+﻿#ifndef MYTINYSTL_CONCURRENT_QUEUE_H_
+#define MYTINYSTL_CONCURRENT_QUEUE_H_
+
+// 这个头文件包含两个模板类 spsc_queue 和 mpmc_queue
+// spsc_queue : 单生产者单消费者的有界无锁队列
+// mpmc_queue : 多生产者多消费者的有界无锁队列
+
+// notes:
+//
+// 1. 两者的容量在构造时确定，向上取整为 2 的幂，之后不再分配内存
+// 2. 接口都是非阻塞的：队列已满时 try_push 返回 false，队列为空时 try_pop 返回 false，
+//    需要等待时由调用者自行重试或让出线程
+// 3. spsc_queue 的头尾下标分别只由一个线程写，不需要 CAS，
+//    生产者与消费者各自缓存对方的下标，只有缓存的值显示队列满或空时才读取对方的下标
+// 4. mpmc_queue 是 Dmitry Vyukov 的有界队列：每个槽位带有一个序号，
+//    线程以 CAS 抢占下标，再根据槽位的序号判断槽位是否可写或可读
+// 5. 生产者与消费者的下标放在不同的缓存行上，避免伪共享
+// 6. 元素的构造或移动抛出异常时，spsc_queue 保持不变；
+//    mpmc_queue 抢到槽位后不能放弃，构造可能抛出异常时先在槽位外构造好元素，
+//    并要求元素的移动构造与移动赋值不抛出异常
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "memory.h"
+#include "util.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 缓存行大小
+#ifndef MYSTL_CACHE_LINE_SIZE
+#define MYSTL_CACHE_LINE_SIZE 64
+#endif
+
+// 不小于 n 的最小的 2 的幂，n 不小于 lowest
+inline size_t concurrent_queue_round_up(size_t n, size_t lowest) noexcept
+{
+  size_t cap = lowest;
+  while (cap < n)
+    cap <<= 1;
+  return cap;
+}
+
+/*****************************************************************************************/
+
+// 模板类 spsc_queue
+// 模板参数 T 代表数据类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
+class spsc_queue
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+public:
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+
+  typedef T                                        value_type;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+
+private:
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  // 只读的部分，构造后不再修改
+  T*        buf_;
+  size_type mask_;
+
+  // 生产者独占的缓存行：尾部下标与缓存的头部下标
+  alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> tail_;
+  size_type head_cache_;
+
+  // 消费者独占的缓存行：头部下标与缓存的尾部下标
+  alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> head_;
+  size_type tail_cache_;
+
+public:
+  // 构造、析构函数
+
+  explicit spsc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), mask_(0),
+    tail_(0), head_cache_(0), head_(0), tail_cache_(0)
+  {
+    THROW_LENGTH_ERROR_IF(capacity > data_traits::max_size(M_alloc()),
+                          "spsc_queue<T>'s capacity too big");
+    const auto cap = mystl::concurrent_queue_round_up(capacity, 1);
+    buf_ = data_traits::allocate(M_alloc(), cap);
+    mask_ = cap - 1;
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  ~spsc_queue()
+  {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    for (auto i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+      data_traits::destroy(M_alloc(), buf_ + (i & mask_));
+    data_traits::deallocate(M_alloc(), buf_, mask_ + 1);
+  }
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+
+public:
+  // 容量相关操作，size 与 empty 在并发时只是近似值
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  size_type size() const noexcept
+  {
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    return tail - head <= capacity() ? tail - head : 0;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  // 生产者调用，队列已满时返回 false
+
+  template <class ...Args>
+  bool try_emplace(Args&& ...args)
+  {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == capacity())
+    {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == capacity())
+        return false;
+    }
+    data_traits::construct(M_alloc(), buf_ + (tail & mask_), mystl::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+  // 消费者调用，队列为空时返回 false
+
+  bool try_pop(value_type& value)
+  {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_)
+    {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_)
+        return false;
+    }
+    T* p = buf_ + (head & mask_);
+    value = mystl::move(*p);
+    data_traits::destroy(M_alloc(), p);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 取出至多 n 个元素写入 result，返回取出的个数，全部取出后才更新一次头部下标
+  template <class OutputIter>
+  size_type pop_n(OutputIter result, size_type n)
+  {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (tail_cache_ - head < n)
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+    const auto count = mystl::min(n, static_cast<size_type>(tail_cache_ - head));
+    size_type i = 0;
+    try
+    {
+      for (; i < count; ++i, ++result)
+      {
+        T* p = buf_ + ((head + i) & mask_);
+        *result = mystl::move(*p);
+        data_traits::destroy(M_alloc(), p);
+      }
+    }
+    catch (...)
+    {
+      head_.store(head + i, std::memory_order_release);
+      throw;
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+};
+
+/*****************************************************************************************/
+
+// 模板类 mpmc_queue
+// 模板参数 T 代表数据类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
+class mpmc_queue
+{
+public:
+  typedef Alloc                                    allocator_type;
+  typedef T                                        value_type;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+
+private:
+  // 槽位：seq 等于下标时可写，等于下标加一时可读
+  struct cell
+  {
+    std::atomic<size_type>                                      seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+  };
+
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>    data_allocator;
+  typedef mystl::allocator_traits<data_allocator>                             data_traits;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<cell> cell_allocator;
+  typedef mystl::allocator_traits<cell_allocator>                             cell_traits;
+
+  // 只读的部分，构造后不再修改
+  cell_allocator alloc_;
+  cell*          buf_;
+  size_type      mask_;
+
+  alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> enqueue_pos_;
+  alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> dequeue_pos_;
+
+public:
+  // 构造、析构函数，容量至少为 2
+
+  explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+    :alloc_(alloc), buf_(nullptr), mask_(0), enqueue_pos_(0), dequeue_pos_(0)
+  {
+    THROW_LENGTH_ERROR_IF(capacity > cell_traits::max_size(alloc_),
+                          "mpmc_queue<T>'s capacity too big");
+    const auto cap = mystl::concurrent_queue_round_up(capacity, 2);
+    buf_ = cell_traits::allocate(alloc_, cap);
+    for (size_type i = 0; i < cap; ++i)
+      ::new (static_cast<void*>(&buf_[i].seq)) std::atomic<size_type>(i);
+    mask_ = cap - 1;
+  }
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  ~mpmc_queue()
+  {
+    data_allocator data_alloc(alloc_);
+    const auto tail = enqueue_pos_.load(std::memory_order_relaxed);
+    for (auto i = dequeue_pos_.load(std::memory_order_relaxed); i != tail; ++i)
+      data_traits::destroy(data_alloc, buf_[i & mask_].value());
+    cell_traits::deallocate(alloc_, buf_, mask_ + 1);
+  }
+
+  allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+public:
+  // 容量相关操作，size 与 empty 在并发时只是近似值
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  size_type size() const noexcept
+  {
+    const auto head = dequeue_pos_.load(std::memory_order_acquire);
+    const auto tail = enqueue_pos_.load(std::memory_order_acquire);
+    return tail - head <= capacity() ? tail - head : 0;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  // 队列已满时返回 false
+  template <class ...Args>
+  bool try_emplace(Args&& ...args)
+  {
+    return emplace_aux(m_bool_constant<
+                       std::is_nothrow_constructible<value_type, Args...>::value>(),
+                       mystl::forward<Args>(args)...);
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+  // 队列为空时返回 false
+  bool try_pop(value_type& value)
+  {
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      cell* c = buf_ + (pos & mask_);
+      const auto seq = c->seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          data_allocator data_alloc(alloc_);
+          value = mystl::move(*c->value());
+          data_traits::destroy(data_alloc, c->value());
+          c->seq.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // 取出至多 n 个元素写入 result，返回取出的个数
+  // 其它消费者可能同时取出元素，取出的元素不一定连续
+  template <class OutputIter>
+  size_type pop_n(OutputIter result, size_type n)
+  {
+    size_type count = 0;
+    value_type value;
+    for (; count < n && try_pop(value); ++count, ++result)
+      *result = mystl::move(value);
+    return count;
+  }
+
+private:
+  // 抢占一个可写的槽位，队列已满时返回 nullptr
+  cell* acquire_push_cell(size_type& pos) noexcept
+  {
+    pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      cell* c = buf_ + (pos & mask_);
+      const auto seq = c->seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          return c;
+      }
+      else if (diff < 0)
+      {
+        return nullptr;
+      }
+      else
+      {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // 构造不抛出异常，直接在槽位上构造
+  template <class ...Args>
+  bool emplace_aux(m_true_type, Args&& ...args)
+  {
+    size_type pos;
+    cell* c = acquire_push_cell(pos);
+    if (c == nullptr)
+      return false;
+    data_allocator data_alloc(alloc_);
+    data_traits::construct(data_alloc, c->value(), mystl::forward<Args>(args)...);
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 否则先在槽位外构造，抢到槽位后再移动过去
+  template <class ...Args>
+  bool emplace_aux(m_false_type, Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return emplace_aux(m_true_type(), mystl::move(tmp));
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_QUEUE_H_
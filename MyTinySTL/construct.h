@@ -9,6 +9,7 @@
 
 #include "type_traits.h"
 #include "iterator.h"
+#include "util.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -52,6 +53,13 @@ void destroy_one(Ty* pointer, std::false_type)
   }
 }
 
+// std::is_trivially_destructible<Ty>{} 确定 Ty 是否平凡可析构
+template <class Ty>
+void destroy(Ty* pointer)
+{
+  destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+}
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter , ForwardIter , std::true_type) {}
 
@@ -62,13 +70,6 @@ void destroy_cat(ForwardIter first, ForwardIter last, std::false_type)
     destroy(&*first);
 }
 
-// std::is_trivially_destructible<Ty>{} 确定 Ty 是否平凡可析构
-template <class Ty>
-void destroy(Ty* pointer)
-{
-  destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-}
-
 template <class ForwardIter>
 void destroy(ForwardIter first, ForwardIter last)
 {
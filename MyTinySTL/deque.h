@@ -21,6 +21,7 @@
 #include "memory.h"
 #include "util.h"
 #include "exceptdef.h"
+#include "instrument.h"
 #include <deque>
 
 namespace mystl
@@ -47,13 +48,42 @@ struct deque_buf_size
   static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
 };
 
+// deque 的缓冲区策略，作为 deque 的第三个模板参数
+// buffer_size   : 每个缓冲区容纳的元素个数
+// map_init_size : map 初始化的大小
+// 缺省使用 deque_traits，可以为某个类型特化它，也可以换成下面两个模板
+template <class T>
+struct deque_traits
+{
+  static constexpr size_t buffer_size   = deque_buf_size<T>::value;
+  static constexpr size_t map_init_size = DEQUE_MAP_INIT_SIZE;
+};
+
+// 每个缓冲区固定容纳 N 个元素
+template <size_t N, size_t MapInitSize = DEQUE_MAP_INIT_SIZE>
+struct deque_block_traits
+{
+  static_assert(N > 0, "deque buffer size must be positive");
+  static_assert(MapInitSize > 2, "deque map size must be larger than 2");
+  static constexpr size_t buffer_size   = N;
+  static constexpr size_t map_init_size = MapInitSize;
+};
+
+// 每个缓冲区约占 Bytes 个字节，至少容纳一个元素
+template <class T, size_t Bytes, size_t MapInitSize = DEQUE_MAP_INIT_SIZE>
+struct deque_bytes_traits
+  :public deque_block_traits<(Bytes / sizeof(T) > 0 ? Bytes / sizeof(T) : 1), MapInitSize>
+{
+};
+
 // deque 的迭代器设计
-template <class T, class Ref, class Ptr>
+// 参数四为缓冲区容纳的元素个数
+template <class T, class Ref, class Ptr, size_t BufSize = deque_traits<T>::buffer_size>
 struct deque_iterator : public iterator<random_access_iterator_tag, T>
 {
-  typedef deque_iterator<T, T&, T*>             iterator;
-  typedef deque_iterator<T, const T&, const T*> const_iterator;
-  typedef deque_iterator                        self;
+  typedef deque_iterator<T, T&, T*, BufSize>             iterator;
+  typedef deque_iterator<T, const T&, const T*, BufSize> const_iterator;
+  typedef deque_iterator                                 self;
 
   typedef T            value_type;
   typedef Ptr          pointer;
@@ -63,7 +93,7 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
   typedef T*           value_pointer;
   typedef T**          map_pointer;
 
-  static const size_type buffer_size = deque_buf_size<T>::value;
+  static const size_type buffer_size = BufSize;
 
   // 迭代器所含成员数据
   value_pointer cur;    // 指向所在缓冲区的当前元素
@@ -204,37 +234,72 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
   bool operator>=(const self& rhs) const { return !(*this < rhs); }
 };
 
+// deque 的迭代器是分段迭代器，每个缓冲区为一段
+// 使 algobase.h / algo.h 中的 copy、move、fill、find、for_each 等算法逐个缓冲区处理
+template <class T, class Ref, class Ptr, size_t BufSize>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufSize>>
+{
+  typedef deque_iterator<T, Ref, Ptr, BufSize> iterator;
+  typedef T**                                  segment_iterator;
+  typedef Ptr                                  local_iterator;
+
+  static constexpr bool is_segmented = true;
+
+  static segment_iterator segment(const iterator& it) { return it.node; }
+  static local_iterator   local(const iterator& it)   { return it.cur; }
+  static local_iterator   begin(segment_iterator seg) { return *seg; }
+  static local_iterator   end(segment_iterator seg)   { return *seg + BufSize; }
+
+  static iterator compose(segment_iterator seg, local_iterator l)
+  {
+    return iterator(const_cast<T*>(l), seg);
+  }
+};
+
 // 模板类 deque
-// 模板参数代表数据类型
-template <class T>
+// 模板参数 T 代表数据类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+// Traits 代表缓冲区策略，缺省使用 mystl::deque_traits
+template <class T, class Alloc = mystl::allocator<T>, class Traits = mystl::deque_traits<T>>
 class deque
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
 {
 public:
   // deque 的型别定义
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<T*>                     map_allocator;
-
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T*>
+                                                   map_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+  typedef mystl::allocator_traits<map_allocator>   map_traits;
+
+  typedef T                                        value_type;
+  typedef typename data_traits::pointer            pointer;
+  typedef typename data_traits::const_pointer      const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef typename data_traits::size_type          size_type;
+  typedef typename data_traits::difference_type    difference_type;
   typedef pointer*                                 map_pointer;
   typedef const_pointer*                           const_map_pointer;
 
-  typedef deque_iterator<T, T&, T*>                iterator;
-  typedef deque_iterator<T, const T&, const T*>    const_iterator;
+  typedef Traits                                   traits_type;
+  typedef deque_iterator<T, T&, T*, Traits::buffer_size>             iterator;
+  typedef deque_iterator<T, const T&, const T*, Traits::buffer_size> const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return allocator_type(); }
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
 
-  static const size_type buffer_size = deque_buf_size<T>::value;
+  static const size_type buffer_size = Traits::buffer_size;
 
 private:
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  // 元素能否按字节搬移，决定在中间插入与删除时移动元素的方式
+  typedef mystl::alloc_can_relocate<data_allocator, T> relocate_type;
+
   // 用以下四个数据来表现一个 deque
   iterator       begin_;     // 指向第一个节点
   iterator       end_;       // 指向最后一个结点
@@ -244,31 +309,49 @@ private:
 public:
   // 构造、复制、移动、析构函数
 
+  // 空的 deque 不构造元素，T 可以没有缺省构造函数
   deque()
-  { fill_init(0, value_type()); }
+  { map_init(0); }
+
+  explicit deque(const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc))
+  { map_init(0); }
 
-  explicit deque(size_type n)
+  explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { fill_init(n, value_type()); }
 
-  deque(size_type n, const value_type& value)
+  deque(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { fill_init(n, value); }
 
   template <class IIter, typename std::enable_if<
     mystl::is_input_iterator<IIter>::value, int>::type = 0>
-  deque(IIter first, IIter last)
+  deque(IIter first, IIter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { copy_init(first, last, iterator_category(first)); }
 
-  deque(std::initializer_list<value_type> ilist)
+  deque(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   {
     copy_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
   }
 
   deque(const deque& rhs)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc()))
+  {
+    copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag());
+  }
+
+  deque(const deque& rhs, const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc))
   {
     copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag());
   }
+
   deque(deque&& rhs) noexcept
-    :begin_(mystl::move(rhs.begin_)),
+    :alloc_base(mystl::move(rhs.M_alloc())),
+    begin_(mystl::move(rhs.begin_)),
     end_(mystl::move(rhs.end_)),
     map_(rhs.map_),
     map_size_(rhs.map_size_)
@@ -277,27 +360,23 @@ public:
     rhs.map_size_ = 0;
   }
 
+  // 分配器不相等时逐个移动元素
+  deque(deque&& rhs, const allocator_type& alloc);
+
   deque& operator=(const deque& rhs);
-  deque& operator=(deque&& rhs);
+  deque& operator=(deque&& rhs)
+    noexcept(data_traits::propagate_on_container_move_assignment::value ||
+             data_traits::is_always_equal::value);
 
   deque& operator=(std::initializer_list<value_type> ilist)
   {
-    deque tmp(ilist);
+    deque tmp(ilist, M_alloc());
     swap(tmp);
     return *this;
   }
 
   ~deque()
-  {
-    if (map_ != nullptr)
-    {
-      clear();
-      data_allocator::deallocate(*begin_.node, buffer_size);
-      *begin_.node = nullptr;
-      map_allocator::deallocate(map_, map_size_);
-      map_ = nullptr;
-    }
-  }
+  { destroy_all(); }
 
 public:
   // 迭代器相关操作
@@ -333,7 +412,7 @@ public:
 
   bool      empty()    const noexcept  { return begin() == end(); }
   size_type size()     const noexcept  { return end_ - begin_; }
-  size_type max_size() const noexcept  { return static_cast<size_type>(-1); }
+  size_type max_size() const noexcept  { return data_traits::max_size(M_alloc()); }
   void      resize(size_type new_size) { resize(new_size, value_type()); }
   void      resize(size_type new_size, const value_type& value);
   void      shrink_to_fit() noexcept;
@@ -444,6 +523,14 @@ private:
 
   // create node / destroy node
   map_pointer create_map(size_type size);
+  void        destroy_map(map_pointer mp, size_type size);
+  void        destroy_all();
+  // 区间可能跨越多个缓冲区，需要通过迭代器逐个析构
+  void        destroy_range(iterator first, iterator last)
+  {
+    for (; first != last; ++first)
+      data_traits::destroy(M_alloc(), first.cur);
+  }
   void        create_buffer(map_pointer nstart, map_pointer nfinish);
   void        destroy_buffer(map_pointer nstart, map_pointer nfinish);
 
@@ -456,6 +543,8 @@ private:
   void        copy_init(FIter, FIter, forward_iterator_tag);
 
   // assign
+  void        move_assign(deque& rhs, m_true_type) noexcept;
+  void        move_assign(deque& rhs, m_false_type);
   void        fill_assign(size_type n, const value_type& value);
   template <class IIter>
   void        copy_assign(IIter first, IIter last, input_iterator_tag);
@@ -473,6 +562,10 @@ private:
   template <class FIter>
   void        insert_dispatch(iterator, FIter, FIter, forward_iterator_tag);
 
+  // relocate
+  iterator    relocate_forward(iterator first, iterator last, iterator result) noexcept;
+  iterator    relocate_backward(iterator first, iterator last, iterator result) noexcept;
+
   // reallocate
   void        require_capacity(size_type n, bool front);
   void        reallocate_map_at_front(size_type need);
@@ -483,11 +576,18 @@ private:
 /*****************************************************************************************/
 
 // 复制赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs)
+template <class T, class Alloc, class Traits>
+deque<T, Alloc, Traits>& deque<T, Alloc, Traits>::operator=(const deque& rhs)
 {
   if (this != &rhs)
   {
+    if (data_traits::propagate_on_container_copy_assignment::value &&
+        !data_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 旧的空间必须由旧的分配器释放
+      destroy_all();
+      mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(), m_true_type());
+      map_init(0);
+    }
     const auto len = size();
     if (len >= rhs.size())
     {
@@ -504,22 +604,44 @@ deque<T>& deque<T>::operator=(const deque& rhs)
 }
 
 // 移动赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(deque&& rhs)
+template <class T, class Alloc, class Traits>
+deque<T, Alloc, Traits>& deque<T, Alloc, Traits>::operator=(deque&& rhs)
+  noexcept(data_traits::propagate_on_container_move_assignment::value ||
+           data_traits::is_always_equal::value)
 {
-  clear();
-  begin_ = mystl::move(rhs.begin_);
-  end_ = mystl::move(rhs.end_);
-  map_ = rhs.map_;
-  map_size_ = rhs.map_size_;
-  rhs.map_ = nullptr;
-  rhs.map_size_ = 0;
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                data_traits::propagate_on_container_move_assignment::value ||
+                data_traits::is_always_equal::value>());
+  }
   return *this;
 }
 
+// 带分配器的移动构造函数
+template <class T, class Alloc, class Traits>
+deque<T, Alloc, Traits>::deque(deque&& rhs, const allocator_type& alloc)
+  :alloc_base(data_allocator(alloc))
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    map_ = rhs.map_;
+    map_size_ = rhs.map_size_;
+    rhs.map_ = nullptr;
+    rhs.map_size_ = 0;
+  }
+  else
+  {
+    map_init(rhs.size());
+    mystl::uninitialized_move_a(rhs.begin_, rhs.end_, begin_, M_alloc());
+  }
+}
+
 // 重置容器大小
-template <class T>
-void deque<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::resize(size_type new_size, const value_type& value)
 {
   const auto len = size();
   if (new_size < len)
@@ -533,30 +655,32 @@ void deque<T>::resize(size_type new_size, const value_type& value)
 }
 
 // 减小容器容量
-template <class T>
-void deque<T>::shrink_to_fit() noexcept
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::shrink_to_fit() noexcept
 {
   // 至少会留下头部缓冲区
   for (auto cur = map_; cur < begin_.node; ++cur)
   {
-    data_allocator::deallocate(*cur, buffer_size);
+    if (*cur != nullptr)
+      data_traits::deallocate(M_alloc(), *cur, buffer_size);
     *cur = nullptr;
   }
   for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
   {
-    data_allocator::deallocate(*cur, buffer_size);
+    if (*cur != nullptr)
+      data_traits::deallocate(M_alloc(), *cur, buffer_size);
     *cur = nullptr;
   }
 }
 
 // 在头部就地构建元素
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class ...Args>
-void deque<T>::emplace_front(Args&& ...args)
+void deque<T, Alloc, Traits>::emplace_front(Args&& ...args)
 {
   if (begin_.cur != begin_.first)
   {
-    data_allocator::construct(begin_.cur - 1, mystl::forward<Args>(args)...);
+    data_traits::construct(M_alloc(), begin_.cur - 1, mystl::forward<Args>(args)...);
     --begin_.cur;
   }
   else
@@ -565,7 +689,7 @@ void deque<T>::emplace_front(Args&& ...args)
     try
     {
       --begin_;
-      data_allocator::construct(begin_.cur, mystl::forward<Args>(args)...);
+      data_traits::construct(M_alloc(), begin_.cur, mystl::forward<Args>(args)...);
     }
     catch (...)
     {
@@ -576,27 +700,27 @@ void deque<T>::emplace_front(Args&& ...args)
 }
 
 // 在尾部就地构建元素
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class ...Args>
-void deque<T>::emplace_back(Args&& ...args)
+void deque<T, Alloc, Traits>::emplace_back(Args&& ...args)
 {
   if (end_.cur != end_.last - 1)
   {
-    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    data_traits::construct(M_alloc(), end_.cur, mystl::forward<Args>(args)...);
     ++end_.cur;
   }
   else
   {
     require_capacity(1, false);
-    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    data_traits::construct(M_alloc(), end_.cur, mystl::forward<Args>(args)...);
     ++end_;
   }
 }
 
 // 在 pos 位置就地构建元素
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class ...Args>
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
+typename deque<T, Alloc, Traits>::iterator deque<T, Alloc, Traits>::emplace(iterator pos, Args&& ...args)
 {
   if (pos.cur == begin_.cur)
   {
@@ -612,12 +736,12 @@ typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
 }
 
 // 在头部插入元素
-template <class T>
-void deque<T>::push_front(const value_type& value)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::push_front(const value_type& value)
 {
   if (begin_.cur != begin_.first)
   {
-    data_allocator::construct(begin_.cur - 1, value);
+    data_traits::construct(M_alloc(), begin_.cur - 1, value);
     --begin_.cur;
   }
   else
@@ -626,7 +750,7 @@ void deque<T>::push_front(const value_type& value)
     try
     {
       --begin_;
-      data_allocator::construct(begin_.cur, value);
+      data_traits::construct(M_alloc(), begin_.cur, value);
     }
     catch (...)
     {
@@ -637,62 +761,62 @@ void deque<T>::push_front(const value_type& value)
 }
 
 // 在尾部插入元素
-template <class T>
-void deque<T>::push_back(const value_type& value)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::push_back(const value_type& value)
 {
   if (end_.cur != end_.last - 1)
   {
-    data_allocator::construct(end_.cur, value);
+    data_traits::construct(M_alloc(), end_.cur, value);
     ++end_.cur;
   }
   else
   {
     require_capacity(1, false);
-    data_allocator::construct(end_.cur, value);
+    data_traits::construct(M_alloc(), end_.cur, value);
     ++end_;
   }
 }
 
 // 弹出头部元素
-template <class T>
-void deque<T>::pop_front()
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::pop_front()
 {
   MYSTL_DEBUG(!empty());
   if (begin_.cur != begin_.last - 1)
   {
-    data_allocator::destroy(begin_.cur);
+    data_traits::destroy(M_alloc(), begin_.cur);
     ++begin_.cur;
   }
   else
   {
-    data_allocator::destroy(begin_.cur);
+    data_traits::destroy(M_alloc(), begin_.cur);
     ++begin_;
     destroy_buffer(begin_.node - 1, begin_.node - 1);
   }
 }
 
 // 弹出尾部元素
-template <class T>
-void deque<T>::pop_back()
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::pop_back()
 {
   MYSTL_DEBUG(!empty());
   if (end_.cur != end_.first)
   {
     --end_.cur;
-    data_allocator::destroy(end_.cur);
+    data_traits::destroy(M_alloc(), end_.cur);
   }
   else
   {
     --end_;
-    data_allocator::destroy(end_.cur);
+    data_traits::destroy(M_alloc(), end_.cur);
     destroy_buffer(end_.node + 1, end_.node + 1);
   }
 }
 
 // 在 position 处插入元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, const value_type& value)
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::insert(iterator position, const value_type& value)
 {
   if (position.cur == begin_.cur)
   {
@@ -712,9 +836,9 @@ deque<T>::insert(iterator position, const value_type& value)
   }
 }
 
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, value_type&& value)
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::insert(iterator position, value_type&& value)
 {
   if (position.cur == begin_.cur)
   {
@@ -735,21 +859,21 @@ deque<T>::insert(iterator position, value_type&& value)
 }
 
 // 在 position 位置插入 n 个元素
-template <class T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::insert(iterator position, size_type n, const value_type& value)
 {
   if (position.cur == begin_.cur)
   {
     require_capacity(n, true);
     auto new_begin = begin_ - n;
-    mystl::uninitialized_fill_n(new_begin, n, value);
+    mystl::uninitialized_fill_n_a(new_begin, n, value, M_alloc());
     begin_ = new_begin;
   }
   else if (position.cur == end_.cur)
   {
     require_capacity(n, false);
     auto new_end = end_ + n;
-    mystl::uninitialized_fill_n(end_, n, value);
+    mystl::uninitialized_fill_n_a(end_, n, value, M_alloc());
     end_ = new_end;
   }
   else
@@ -759,30 +883,32 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value)
 }
 
 // 删除 position 处的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator position)
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::erase(iterator position)
 {
   auto next = position;
   ++next;
+  if (relocate_type::value)
+    return erase(position, next);
   const size_type elems_before = position - begin_;
   if (elems_before < (size() / 2))
   {
-    mystl::copy_backward(begin_, position, next);
+    mystl::move_backward(begin_, position, next);
     pop_front();
   }
   else
   {
-    mystl::copy(next, end_, position);
+    mystl::move(next, end_, position);
     pop_back();
   }
   return begin_ + elems_before;
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator first, iterator last)
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::erase(iterator first, iterator last)
 {
   if (first == begin_ && last == end_)
   {
@@ -793,18 +919,26 @@ deque<T>::erase(iterator first, iterator last)
   {
     const size_type len = last - first;
     const size_type elems_before = first - begin_;
-    if (elems_before < ((size() - len) / 2))
-    {
-      mystl::copy_backward(begin_, first, last);
+    if (relocate_type::value)
+    { // 元素可以按字节搬移时，析构被删除的元素后把较短的一侧整体搬移过来
+      destroy_range(first, last);
+      if (elems_before < ((size() - len) / 2))
+        begin_ = relocate_backward(begin_, first, last);
+      else
+        end_ = relocate_forward(last, end_, first);
+    }
+    else if (elems_before < ((size() - len) / 2))
+    { // 否则把较短的一侧整体移动过来，move 会逐个缓冲区地进行
+      mystl::move_backward(begin_, first, last);
       auto new_begin = begin_ + len;
-      data_allocator::destroy(begin_.cur, new_begin.cur);
+      destroy_range(begin_, new_begin);
       begin_ = new_begin;
     }
     else
     {
-      mystl::copy(last, end_, first);
+      mystl::move(last, end_, first);
       auto new_end = end_ - len;
-      data_allocator::destroy(new_end.cur, end_.cur);
+      destroy_range(new_end, end_);
       end_ = new_end;
     }
     return begin_ + elems_before;
@@ -812,33 +946,39 @@ deque<T>::erase(iterator first, iterator last)
 }
 
 // 清空 deque
-template <class T>
-void deque<T>::clear()
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::clear()
 {
   // clear 会保留头部的缓冲区
   for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur)
   {
-    data_allocator::destroy(*cur, *cur + buffer_size);
+    data_traits::destroy(M_alloc(), *cur, *cur + buffer_size);
   }
   if (begin_.node != end_.node)
   { // 有两个以上的缓冲区
-    mystl::destroy(begin_.cur, begin_.last);
-    mystl::destroy(end_.first, end_.cur);
+    data_traits::destroy(M_alloc(), begin_.cur, begin_.last);
+    data_traits::destroy(M_alloc(), end_.first, end_.cur);
   }
   else
   {
-    mystl::destroy(begin_.cur, end_.cur);
+    data_traits::destroy(M_alloc(), begin_.cur, end_.cur);
   }
-  shrink_to_fit();
+  // 先收缩 end_，shrink_to_fit 才会释放头部以外的缓冲区
   end_ = begin_;
+  shrink_to_fit();
 }
 
 // 交换两个 deque
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept
+// 分配器不随之交换时，两者的分配器必须相等
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::swap(deque& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
     mystl::swap(begin_, rhs.begin_);
     mystl::swap(end_, rhs.end_);
     mystl::swap(map_, rhs.map_);
@@ -849,29 +989,89 @@ void deque<T>::swap(deque& rhs) noexcept
 /*****************************************************************************************/
 // helper function
 
-template <class T>
-typename deque<T>::map_pointer
-deque<T>::create_map(size_type size)
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::map_pointer
+deque<T, Alloc, Traits>::create_map(size_type size)
 {
+  map_allocator ma(M_alloc());
   map_pointer mp = nullptr;
-  mp = map_allocator::allocate(size);
+  mp = map_traits::allocate(ma, size);
   for (size_type i = 0; i < size; ++i)
     *(mp + i) = nullptr;
   return mp;
 }
 
+// destroy_map 函数
+// map 由 data_allocator 重新绑定得到的分配器释放
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
+destroy_map(map_pointer mp, size_type size)
+{
+  map_allocator ma(M_alloc());
+  map_traits::deallocate(ma, mp, size);
+}
+
+// destroy_all 函数
+// 析构所有元素并释放所有缓冲区与 map
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
+destroy_all()
+{
+  if (map_ != nullptr)
+  {
+    clear();
+    data_traits::deallocate(M_alloc(), *begin_.node, buffer_size);
+    *begin_.node = nullptr;
+    destroy_map(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+  }
+}
+
+// move_assign 函数
+// 可以接管 rhs 的空间：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
+move_assign(deque& rhs, m_true_type) noexcept
+{
+  destroy_all();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename data_traits::propagate_on_container_move_assignment());
+  begin_ = rhs.begin_;
+  end_ = rhs.end_;
+  map_ = rhs.map_;
+  map_size_ = rhs.map_size_;
+  rhs.map_ = nullptr;
+  rhs.map_size_ = 0;
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
+move_assign(deque& rhs, m_false_type)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  deque tmp(mystl::move(rhs), M_alloc());
+  swap(tmp);
+}
+
 // create_buffer 函数
 // 为 map_ 下的 buffer 申请空间
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 create_buffer(map_pointer nstart, map_pointer nfinish)
 {
   map_pointer cur;
   try
   {
     for (cur = nstart; cur <= nfinish; ++cur)
-    {
-      *cur = data_allocator::allocate(buffer_size);
+    { // 已有的空闲缓冲区直接复用
+      if (*cur == nullptr)
+        *cur = data_traits::allocate(M_alloc(), buffer_size);
     }
   }
   catch (...)
@@ -879,7 +1079,7 @@ create_buffer(map_pointer nstart, map_pointer nfinish)
     while (cur != nstart)
     {
       --cur;
-      data_allocator::deallocate(*cur, buffer_size);
+      data_traits::deallocate(M_alloc(), *cur, buffer_size);
       *cur = nullptr;
     }
     throw;
@@ -887,24 +1087,25 @@ create_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 // destroy_buffer 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 destroy_buffer(map_pointer nstart, map_pointer nfinish)
 {
   for (map_pointer n = nstart; n <= nfinish; ++n)
   {
-    data_allocator::deallocate(*n, buffer_size);
+    if (*n != nullptr)
+      data_traits::deallocate(M_alloc(), *n, buffer_size);
     *n = nullptr;
   }
 }
 
 // map_init 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 map_init(size_type nElem)
 {
   const size_type nNode = nElem / buffer_size + 1;  // 需要分配的缓冲区个数
-  map_size_ = mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNode + 2);
+  map_size_ = mystl::max(static_cast<size_type>(Traits::map_init_size), nNode + 2);
   try
   {
     map_ = create_map(map_size_);
@@ -925,7 +1126,7 @@ map_init(size_type nElem)
   }
   catch (...)
   {
-    map_allocator::deallocate(map_, map_size_);
+    destroy_map(map_, map_size_);
     map_ = nullptr;
     map_size_ = 0;
     throw;
@@ -937,8 +1138,8 @@ map_init(size_type nElem)
 }
 
 // fill_init 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 fill_init(size_type n, const value_type& value)
 {
   map_init(n);
@@ -946,16 +1147,16 @@ fill_init(size_type n, const value_type& value)
   {
     for (auto cur = begin_.node; cur < end_.node; ++cur)
     {
-      mystl::uninitialized_fill(*cur, *cur + buffer_size, value);
+      mystl::uninitialized_fill_a(*cur, *cur + buffer_size, value, M_alloc());
     }
-    mystl::uninitialized_fill(end_.first, end_.cur, value);
+    mystl::uninitialized_fill_a(end_.first, end_.cur, value, M_alloc());
   }
 }
 
 // copy_init 函数
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 copy_init(IIter first, IIter last, input_iterator_tag)
 {
   const size_type n = mystl::distance(first, last);
@@ -964,9 +1165,9 @@ copy_init(IIter first, IIter last, input_iterator_tag)
     emplace_back(*first);
 }
 
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 copy_init(FIter first, FIter last, forward_iterator_tag)
 {
   const size_type n = mystl::distance(first, last);
@@ -975,15 +1176,15 @@ copy_init(FIter first, FIter last, forward_iterator_tag)
   {
     auto next = first;
     mystl::advance(next, buffer_size);
-    mystl::uninitialized_copy(first, next, *cur);
+    mystl::uninitialized_copy_a(first, next, *cur, M_alloc());
     first = next;
   }
-  mystl::uninitialized_copy(first, last, end_.first);
+  mystl::uninitialized_copy_a(first, last, end_.first, M_alloc());
 }
 
 // fill_assign 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 fill_assign(size_type n, const value_type& value)
 {
   if (n > size())
@@ -999,9 +1200,9 @@ fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 copy_assign(IIter first, IIter last, input_iterator_tag)
 {
   auto first1 = begin();
@@ -1020,9 +1221,9 @@ copy_assign(IIter first, IIter last, input_iterator_tag)
   }
 }
 
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 copy_assign(FIter first, FIter last, forward_iterator_tag)
 {  
   const size_type len1 = size();
@@ -1041,17 +1242,48 @@ copy_assign(FIter first, FIter last, forward_iterator_tag)
 }
 
 // insert_aux 函数
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class... Args>
-typename deque<T>::iterator
-deque<T>::
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::
 insert_aux(iterator position, Args&& ...args)
 {
   const size_type elems_before = position - begin_;
   value_type value_copy = value_type(mystl::forward<Args>(args)...);
+  if (relocate_type::value)
+  { // 元素可以按字节搬移时，把较短的一侧整体搬移一个位置，在空出的位置上构造
+    const bool front = elems_before < (size() / 2);
+    require_capacity(1, front);
+    position = begin_ + elems_before;
+    if (front)
+    {
+      auto new_begin = begin_ - 1;
+      relocate_forward(begin_, position, new_begin);
+      begin_ = new_begin;
+      --position;
+    }
+    else
+    {
+      relocate_backward(position, end_, end_ + 1);
+      ++end_;
+    }
+    try
+    {
+      data_traits::construct(M_alloc(), position.cur, mystl::move(value_copy));
+    }
+    catch (...)
+    {
+      if (front)
+        begin_ = relocate_backward(begin_, position, position + 1);
+      else
+        end_ = relocate_forward(position + 1, end_, position);
+      throw;
+    }
+    return position;
+  }
   if (elems_before < (size() / 2))
   { // 在前半段插入
-    emplace_front(front());
+    emplace_front(mystl::move(front()));
     auto front1 = begin_;
     ++front1;
     auto front2 = front1;
@@ -1059,17 +1291,17 @@ insert_aux(iterator position, Args&& ...args)
     position = begin_ + elems_before;
     auto pos = position;
     ++pos;
-    mystl::copy(front2, pos, front1);
+    mystl::move(front2, pos, front1);
   }
   else
   { // 在后半段插入
-    emplace_back(back());
+    emplace_back(mystl::move(back()));
     auto back1 = end_;
     --back1;
     auto back2 = back1;
     --back2;
     position = begin_ + elems_before;
-    mystl::copy_backward(position, back2, back1);
+    mystl::move_backward(position, back2, back1);
   }
   *position = mystl::move(value_copy);
   return position;
@@ -1077,8 +1309,8 @@ insert_aux(iterator position, Args&& ...args)
 
 // fill_insert 函数
 // 在指定位置插入多个元素
-template <class T>
-void deque<T>::
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::
 fill_insert(iterator position, size_type n, const value_type& value)
 {
   const size_type elems_before = position - begin_;
@@ -1097,15 +1329,16 @@ fill_insert(iterator position, size_type n, const value_type& value)
       {
         // elems_before == n(未初始化) + (position - begin_n_)(已初始化)
         auto begin_n = begin_ + n;
-        mystl::uninitialized_copy(begin_, begin_n, new_begin);  // 先复制到未初始化，新申请内存空间上
+        mystl::uninitialized_move_a(begin_, begin_n, new_begin, M_alloc());  // 先移动到未初始化，新申请内存空间上
         begin_ = new_begin;
-        mystl::copy(begin_n, position, old_begin);  // 超出 n 的部分复制到begin_ 
+        mystl::move(begin_n, position, old_begin);  // 超出 n 的部分移动到begin_ 
         mystl::fill(position - n, position, value_copy);
       }
       else
       {
-        mystl::uninitialized_fill(
-          mystl::uninitialized_copy(begin_, position, new_begin), begin_, value_copy);
+        mystl::uninitialized_fill_a(
+          mystl::uninitialized_move_a(begin_, position, new_begin, M_alloc()),
+          begin_, value_copy, M_alloc());
         begin_ = new_begin;
         mystl::fill(old_begin, position, value_copy);
       }
@@ -1130,15 +1363,15 @@ fill_insert(iterator position, size_type n, const value_type& value)
       if (elems_after > n)
       {
         auto end_n = end_ - n;
-        mystl::uninitialized_copy(end_n, end_, end_);
+        mystl::uninitialized_move_a(end_n, end_, end_, M_alloc());
         end_ = new_end;
-        mystl::copy_backward(position, end_n, old_end);
+        mystl::move_backward(position, end_n, old_end);
         mystl::fill(position, position + n, value_copy);
       }
       else
       {
-        mystl::uninitialized_fill(end_, position + n, value_copy);
-        mystl::uninitialized_copy(position, end_, position + n);
+        mystl::uninitialized_fill_a(end_, position + n, value_copy, M_alloc());
+        mystl::uninitialized_move_a(position, end_, position + n, M_alloc());
         end_ = new_end;
         mystl::fill(position, old_end, value_copy);
       }
@@ -1154,9 +1387,9 @@ fill_insert(iterator position, size_type n, const value_type& value)
 
 // copy_insert
 // 插入一段元素，并且确保容器内部的元素和内存都正确地调整和更新
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 copy_insert(iterator position, FIter first, FIter last, size_type n)
 {
   const size_type elems_before = position - begin_;
@@ -1173,17 +1406,18 @@ copy_insert(iterator position, FIter first, FIter last, size_type n)
       if (elems_before >= n)
       {
         auto begin_n = begin_ + n;
-        mystl::uninitialized_copy(begin_, begin_n, new_begin);
+        mystl::uninitialized_move_a(begin_, begin_n, new_begin, M_alloc());
         begin_ = new_begin;
-        mystl::copy(begin_n, position, old_begin);
+        mystl::move(begin_n, position, old_begin);
         mystl::copy(first, last, position - n);
       }
       else
       {
         auto mid = first;
         mystl::advance(mid, n - elems_before);
-        mystl::uninitialized_copy(first, mid,
-                                  mystl::uninitialized_copy(begin_, position, new_begin));
+        mystl::uninitialized_copy_a(first, mid,
+                                    mystl::uninitialized_move_a(begin_, position, new_begin, M_alloc()),
+                                    M_alloc());
         begin_ = new_begin;
         mystl::copy(mid, last, old_begin);
       }
@@ -1208,17 +1442,18 @@ copy_insert(iterator position, FIter first, FIter last, size_type n)
       if (elems_after > n)
       {
         auto end_n = end_ - n;
-        mystl::uninitialized_copy(end_n, end_, end_);
+        mystl::uninitialized_move_a(end_n, end_, end_, M_alloc());
         end_ = new_end;
-        mystl::copy_backward(position, end_n, old_end);
+        mystl::move_backward(position, end_n, old_end);
         mystl::copy(first, last, position);
       }
       else
       {
         auto mid = first;
         mystl::advance(mid, elems_after);
-        mystl::uninitialized_copy(position, end_,
-                                  mystl::uninitialized_copy(mid, last, end_));
+        mystl::uninitialized_move_a(position, end_,
+                                    mystl::uninitialized_copy_a(mid, last, end_, M_alloc()),
+                                    M_alloc());
         end_ = new_end;
         mystl::copy(first, mid, position);
       }
@@ -1233,9 +1468,9 @@ copy_insert(iterator position, FIter first, FIter last, size_type n)
 }
 
 // insert_dispatch 函数 ==》 根据情况申请新空间，
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
 {
   if (last <= first)  return;
@@ -1257,9 +1492,9 @@ insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
   }
 }
 
-template <class T>
+template <class T, class Alloc, class Traits>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, Traits>::
 insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
 {
   if (last <= first)  return;
@@ -1270,7 +1505,7 @@ insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag
     auto new_begin = begin_ - n;
     try
     {
-      mystl::uninitialized_copy(first, last, new_begin);
+      mystl::uninitialized_copy_a(first, last, new_begin, M_alloc());
       begin_ = new_begin;
     }
     catch (...)
@@ -1286,7 +1521,7 @@ insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag
     auto new_end = end_ + n;
     try
     {
-      mystl::uninitialized_copy(first, last, end_);
+      mystl::uninitialized_copy_a(first, last, end_, M_alloc());
       end_ = new_end;
     }
     catch (...)
@@ -1302,10 +1537,54 @@ insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag
   }
 }
 
+// relocate_forward 函数
+// 把 [first, last) 按缓冲区分段搬移到以 result 为起始处，result 位于 first 之前，返回搬移结束的位置
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::
+relocate_forward(iterator first, iterator last, iterator result) noexcept
+{
+  auto len = last - first;
+  while (len > 0)
+  {
+    const difference_type n = mystl::min(len, mystl::min(first.last - first.cur,
+                                                         result.last - result.cur));
+    std::memmove(static_cast<void*>(result.cur), static_cast<const void*>(first.cur),
+                 static_cast<size_type>(n) * sizeof(T));
+    first += n;
+    result += n;
+    len -= n;
+  }
+  return result;
+}
+
+// relocate_backward 函数
+// 把 [first, last) 按缓冲区分段搬移到以 result 为结束处，result 位于 last 之后，返回搬移后的起始位置
+template <class T, class Alloc, class Traits>
+typename deque<T, Alloc, Traits>::iterator
+deque<T, Alloc, Traits>::
+relocate_backward(iterator first, iterator last, iterator result) noexcept
+{
+  const auto bsize = static_cast<difference_type>(buffer_size);
+  auto len = last - first;
+  while (len > 0)
+  {
+    const difference_type ln = last.cur == last.first ? bsize : last.cur - last.first;
+    const difference_type rn = result.cur == result.first ? bsize : result.cur - result.first;
+    const difference_type n = mystl::min(len, mystl::min(ln, rn));
+    last -= n;
+    result -= n;
+    std::memmove(static_cast<void*>(result.cur), static_cast<const void*>(last.cur),
+                 static_cast<size_type>(n) * sizeof(T));
+    len -= n;
+  }
+  return result;
+}
+
 // require_capacity 函数
 // 判断是否有足够空间 -- true 前面插入新空间 false 后面插入新空间
-template <class T>
-void deque<T>::require_capacity(size_type n, bool front)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::require_capacity(size_type n, bool front)
 {
   // 前面
   if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n))
@@ -1333,12 +1612,13 @@ void deque<T>::require_capacity(size_type n, bool front)
 
 // reallocate_map_at_front 函数
 // 开辟前面新空间，将缓存区指针指向原来的 buffer 
-template <class T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::reallocate_map_at_front(size_type need_buffer)
 {
   const size_type new_map_size = mystl::max(map_size_ << 1,
                                             map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
   map_pointer new_map = create_map(new_map_size);
+  instrument::count(deque_map_reallocation);
   const size_type old_buffer = end_.node - begin_.node + 1;
   const size_type new_buffer = old_buffer + need_buffer;
 
@@ -1350,8 +1630,9 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
   for (auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
     *begin1 = *begin2;
 
-  // 更新数据
-  map_allocator::deallocate(map_, map_size_);
+  // 更新数据，旧 map 中未被使用的缓冲区一并释放
+  shrink_to_fit();
+  destroy_map(map_, map_size_);
   map_ = new_map;
   map_size_ = new_map_size;
   begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
@@ -1360,12 +1641,13 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
 
 // reallocate_map_at_back 函数
 // 开辟后面新空间，将指针指向原来的 buffer 
-template <class T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer)
+template <class T, class Alloc, class Traits>
+void deque<T, Alloc, Traits>::reallocate_map_at_back(size_type need_buffer)
 {
   const size_type new_map_size = mystl::max(map_size_ << 1,
                                             map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
   map_pointer new_map = create_map(new_map_size);
+  instrument::count(deque_map_reallocation);
   const size_type old_buffer = end_.node - begin_.node + 1;
   const size_type new_buffer = old_buffer + need_buffer;
 
@@ -1377,8 +1659,9 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer)
     *begin1 = *begin2;
   create_buffer(mid, end - 1);
 
-  // 更新数据
-  map_allocator::deallocate(map_, map_size_);
+  // 更新数据，旧 map 中未被使用的缓冲区一并释放
+  shrink_to_fit();
+  destroy_map(map_, map_size_);
   map_ = new_map;
   map_size_ = new_map_size;
   begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
@@ -1386,51 +1669,61 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer)
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator==(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return lhs.size() == rhs.size() && 
     mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator<(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return mystl::lexicographical_compare(
     lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator!=(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator>(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator<=(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+bool operator>=(const deque<T, Alloc, Traits>& lhs, const deque<T, Alloc, Traits>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs)
+template <class T, class Alloc, class Traits>
+void swap(deque<T, Alloc, Traits>& lhs, deque<T, Alloc, Traits>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// deque 的迭代器与 map 都指向堆上的空间，可以按字节搬移
+template <class T, class Alloc, class Traits>
+struct is_trivially_relocatable<deque<T, Alloc, Traits>> :is_trivially_relocatable<Alloc> {};
+
+namespace pmr
+{
+template <class T>
+using deque = mystl::deque<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_DEQUE_H_
 
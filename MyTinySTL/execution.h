@@ -0,0 +1,698 @@
+﻿#ifndef MYTINYSTL_EXECUTION_H_
+#define MYTINYSTL_EXECUTION_H_
+
+// 这个头文件包含执行策略 mystl::execution::seq, par, par_unseq，
+// 以及 sort, stable_sort, for_each, transform, reduce, inclusive_scan, count, count_if 接受执行策略的版本，
+// 和对整个 list 排序的 sort(policy, list)
+
+// notes:
+//
+// 1. 并行版本在 thread_pool 上执行，默认使用 thread_pool::instance()，par.on(pool) 可以指定线程池
+// 2. 并行版本要求随机访问迭代器，其余迭代器以及较小的区间使用串行版本
+// 3. reduce 的二元操作需满足结合律与交换律，inclusive_scan 的二元操作需满足结合律
+// 4. 元素操作抛出的异常会在调用线程中重新抛出（std 的并行算法此时调用 std::terminate）
+// 5. par_unseq 目前与 par 相同
+
+#include "algo.h"
+#include "list.h"
+#include "numeric.h"
+#include "vector.h"
+#include "thread_pool.h"
+
+namespace mystl
+{
+namespace execution
+{
+
+// 串行执行
+class sequenced_policy
+{
+public:
+  constexpr sequenced_policy() noexcept {}
+};
+
+// 并行执行
+class parallel_policy
+{
+public:
+  constexpr parallel_policy() noexcept :pool_(nullptr) {}
+  explicit parallel_policy(thread_pool& pool) noexcept :pool_(&pool) {}
+
+  // 返回在线程池 pool 上执行的策略
+  parallel_policy on(thread_pool& pool) const noexcept { return parallel_policy(pool); }
+
+  thread_pool& pool() const { return pool_ ? *pool_ : thread_pool::instance(); }
+
+private:
+  thread_pool* pool_;
+};
+
+// 并行且允许向量化执行
+class parallel_unsequenced_policy :public parallel_policy
+{
+public:
+  constexpr parallel_unsequenced_policy() noexcept {}
+  explicit parallel_unsequenced_policy(thread_pool& pool) noexcept :parallel_policy(pool) {}
+
+  parallel_unsequenced_policy on(thread_pool& pool) const noexcept
+  { return parallel_unsequenced_policy(pool); }
+};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+// is_execution_policy
+template <class T>
+struct is_execution_policy :public m_false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> :public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> :public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> :public m_true_type {};
+
+// 只有第一个参数是执行策略时，下面的重载版本才参与重载决议
+template <class ExecutionPolicy, class T>
+struct enable_if_execution_policy
+  :public std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T>
+{
+};
+
+/*****************************************************************************************/
+// 并行算法的辅助函数
+
+constexpr static size_t kParallelGrain = 4096;  // 每一块至少包含的元素个数
+
+// 计算区间分成的块数，块数多于线程数以平衡负载
+inline size_t par_chunk_count(const execution::parallel_policy& policy, size_t n)
+{
+  const size_t threads = policy.pool().concurrency();
+  if (threads == 1 || n < kParallelGrain * 2)
+    return 1;
+  const size_t chunks = threads * 4;
+  return n / kParallelGrain < chunks ? n / kParallelGrain : chunks;
+}
+
+// 第 i 块的起始位置
+inline size_t par_chunk_begin(size_t n, size_t chunks, size_t i)
+{
+  return n / chunks * i + (n % chunks) * i / chunks;
+}
+
+// 在线程池上执行 f(0), f(1), ..., f(chunks - 1)，调用线程执行 f(0) 后帮助执行其余任务
+template <class Function>
+void par_run_chunks(thread_pool& pool, size_t chunks, Function& f)
+{
+  task_group group(pool);
+  for (size_t i = 1; i < chunks; ++i)
+    group.run([&f, i] { f(i); });
+  f(0);
+  group.wait();
+}
+
+/*****************************************************************************************/
+// for_each
+/*****************************************************************************************/
+template <class InputIter, class Function>
+void exec_for_each(const execution::sequenced_policy&, InputIter first, InputIter last, Function f)
+{
+  mystl::for_each(first, last, f);
+}
+
+template <class InputIter, class Function>
+void exec_for_each(const execution::parallel_policy&,
+                   InputIter first, InputIter last, Function f, m_false_type)
+{
+  mystl::for_each(first, last, f);
+}
+
+template <class RandomIter, class Function>
+void exec_for_each(const execution::parallel_policy& policy,
+                   RandomIter first, RandomIter last, Function f, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+  {
+    mystl::for_each(first, last, f);
+    return;
+  }
+  auto body = [&](size_t i)
+  {
+    mystl::for_each(first + par_chunk_begin(n, chunks, i),
+                    first + par_chunk_begin(n, chunks, i + 1), f);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, body);
+}
+
+template <class InputIter, class Function>
+void exec_for_each(const execution::parallel_policy& policy,
+                   InputIter first, InputIter last, Function f)
+{
+  mystl::exec_for_each(policy, first, last, f,
+                       m_bool_constant<is_random_access_iterator<InputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter, class Function>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+for_each(ExecutionPolicy&& policy, InputIter first, InputIter last, Function f)
+{
+  mystl::exec_for_each(policy, first, last, f);
+}
+
+/*****************************************************************************************/
+// transform
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class UnaryOperation>
+OutputIter exec_transform(const execution::sequenced_policy&, InputIter first, InputIter last,
+                          OutputIter result, UnaryOperation unary_op)
+{
+  return mystl::transform(first, last, result, unary_op);
+}
+
+template <class InputIter, class OutputIter, class UnaryOperation>
+OutputIter exec_transform(const execution::parallel_policy&, InputIter first, InputIter last,
+                          OutputIter result, UnaryOperation unary_op, m_false_type)
+{
+  return mystl::transform(first, last, result, unary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class UnaryOperation>
+RandomIter2 exec_transform(const execution::parallel_policy& policy, RandomIter1 first, RandomIter1 last,
+                           RandomIter2 result, UnaryOperation unary_op, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+    return mystl::transform(first, last, result, unary_op);
+  auto body = [&](size_t i)
+  {
+    const size_t b = par_chunk_begin(n, chunks, i);
+    const size_t e = par_chunk_begin(n, chunks, i + 1);
+    mystl::transform(first + b, first + e, result + b, unary_op);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, body);
+  return result + n;
+}
+
+template <class InputIter, class OutputIter, class UnaryOperation>
+OutputIter exec_transform(const execution::parallel_policy& policy, InputIter first, InputIter last,
+                          OutputIter result, UnaryOperation unary_op)
+{
+  return mystl::exec_transform(policy, first, last, result, unary_op,
+                               m_bool_constant<is_random_access_iterator<InputIter>::value &&
+                                               is_random_access_iterator<OutputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+transform(ExecutionPolicy&& policy, InputIter first, InputIter last,
+          OutputIter result, UnaryOperation unary_op)
+{
+  return mystl::exec_transform(policy, first, last, result, unary_op);
+}
+
+// 二元操作的版本
+template <class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+OutputIter exec_transform2(const execution::sequenced_policy&, InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, OutputIter result, BinaryOperation binary_op)
+{
+  return mystl::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+OutputIter exec_transform2(const execution::parallel_policy&, InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, OutputIter result, BinaryOperation binary_op,
+                          m_false_type)
+{
+  return mystl::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3, class BinaryOperation>
+RandomIter3 exec_transform2(const execution::parallel_policy& policy, RandomIter1 first1, RandomIter1 last1,
+                           RandomIter2 first2, RandomIter3 result, BinaryOperation binary_op,
+                           m_true_type)
+{
+  const size_t n = static_cast<size_t>(last1 - first1);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+    return mystl::transform(first1, last1, first2, result, binary_op);
+  auto body = [&](size_t i)
+  {
+    const size_t b = par_chunk_begin(n, chunks, i);
+    const size_t e = par_chunk_begin(n, chunks, i + 1);
+    mystl::transform(first1 + b, first1 + e, first2 + b, result + b, binary_op);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, body);
+  return result + n;
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+OutputIter exec_transform2(const execution::parallel_policy& policy, InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, OutputIter result, BinaryOperation binary_op)
+{
+  return mystl::exec_transform2(policy, first1, last1, first2, result, binary_op,
+                               m_bool_constant<is_random_access_iterator<InputIter1>::value &&
+                                               is_random_access_iterator<InputIter2>::value &&
+                                               is_random_access_iterator<OutputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter,
+          class BinaryOperation>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+transform(ExecutionPolicy&& policy, InputIter1 first1, InputIter1 last1,
+          InputIter2 first2, OutputIter result, BinaryOperation binary_op)
+{
+  return mystl::exec_transform2(policy, first1, last1, first2, result, binary_op);
+}
+
+/*****************************************************************************************/
+// count_if / count
+/*****************************************************************************************/
+template <class InputIter, class UnaryPredicate>
+size_t exec_count_if(const execution::sequenced_policy&, InputIter first, InputIter last,
+                     UnaryPredicate unary_pred)
+{
+  return mystl::count_if(first, last, unary_pred);
+}
+
+template <class InputIter, class UnaryPredicate>
+size_t exec_count_if(const execution::parallel_policy&, InputIter first, InputIter last,
+                     UnaryPredicate unary_pred, m_false_type)
+{
+  return mystl::count_if(first, last, unary_pred);
+}
+
+template <class RandomIter, class UnaryPredicate>
+size_t exec_count_if(const execution::parallel_policy& policy, RandomIter first, RandomIter last,
+                     UnaryPredicate unary_pred, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+    return mystl::count_if(first, last, unary_pred);
+  mystl::vector<size_t> counts(chunks, 0);
+  auto body = [&](size_t i)
+  {
+    counts[i] = mystl::count_if(first + par_chunk_begin(n, chunks, i),
+                                first + par_chunk_begin(n, chunks, i + 1), unary_pred);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, body);
+  return mystl::accumulate(counts.begin(), counts.end(), size_t(0));
+}
+
+template <class InputIter, class UnaryPredicate>
+size_t exec_count_if(const execution::parallel_policy& policy, InputIter first, InputIter last,
+                     UnaryPredicate unary_pred)
+{
+  return mystl::exec_count_if(policy, first, last, unary_pred,
+                              m_bool_constant<is_random_access_iterator<InputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+typename enable_if_execution_policy<ExecutionPolicy, size_t>::type
+count_if(ExecutionPolicy&& policy, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::exec_count_if(policy, first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class InputIter, class T>
+typename enable_if_execution_policy<ExecutionPolicy, size_t>::type
+count(ExecutionPolicy&& policy, InputIter first, InputIter last, const T& value)
+{
+  typedef typename iterator_traits<InputIter>::reference reference;
+  return mystl::exec_count_if(policy, first, last,
+                              [&value](reference x) { return x == value; });
+}
+
+/*****************************************************************************************/
+// reduce
+// 以初值 init 与二元操作 binary_op 归约[first, last)，缺省的初值为 value_type()，缺省的操作为加法
+// 并行版本先归约每一块，再按块的顺序合并结果，每一块与顺序版本都使用 mystl::reduce，数组的加法会向量化
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T exec_reduce(const execution::sequenced_policy&, InputIter first, InputIter last,
+              T init, BinaryOp binary_op)
+{
+  return mystl::reduce(first, last, init, binary_op);
+}
+
+template <class InputIter, class T, class BinaryOp>
+T exec_reduce(const execution::parallel_policy&, InputIter first, InputIter last,
+              T init, BinaryOp binary_op, m_false_type)
+{
+  return mystl::reduce(first, last, init, binary_op);
+}
+
+template <class RandomIter, class T, class BinaryOp>
+T exec_reduce(const execution::parallel_policy& policy, RandomIter first, RandomIter last,
+              T init, BinaryOp binary_op, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+    return mystl::reduce(first, last, init, binary_op);
+  mystl::vector<T> partial(chunks, init);
+  auto body = [&](size_t i)
+  {
+    auto b = first + par_chunk_begin(n, chunks, i);
+    const auto e = first + par_chunk_begin(n, chunks, i + 1);
+    T sum = *b;
+    partial[i] = mystl::reduce(++b, e, mystl::move(sum), binary_op);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, body);
+  for (auto& x : partial)
+    init = binary_op(init, x);
+  return init;
+}
+
+template <class InputIter, class T, class BinaryOp>
+T exec_reduce(const execution::parallel_policy& policy, InputIter first, InputIter last,
+              T init, BinaryOp binary_op)
+{
+  return mystl::exec_reduce(policy, first, last, init, binary_op,
+                            m_bool_constant<is_random_access_iterator<InputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp>
+typename enable_if_execution_policy<ExecutionPolicy, T>::type
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::exec_reduce(policy, first, last, init, binary_op);
+}
+
+template <class ExecutionPolicy, class InputIter, class T>
+typename enable_if_execution_policy<ExecutionPolicy, T>::type
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last, T init)
+{
+  return mystl::exec_reduce(policy, first, last, init, mystl::plus<T>());
+}
+
+template <class ExecutionPolicy, class InputIter>
+typename enable_if_execution_policy<ExecutionPolicy,
+  typename iterator_traits<InputIter>::value_type>::type
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::exec_reduce(policy, first, last, value_type(), mystl::plus<value_type>());
+}
+
+/*****************************************************************************************/
+// inclusive_scan
+// 并行版本先归约每一块，串行计算每一块之前的前缀，再分别计算每一块的前缀和
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter exec_inclusive_scan(const execution::sequenced_policy&, InputIter first, InputIter last,
+                               OutputIter result, BinaryOp binary_op, const T* init)
+{
+  return init ? mystl::inclusive_scan(first, last, result, binary_op, *init)
+              : mystl::inclusive_scan(first, last, result, binary_op);
+}
+
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter exec_inclusive_scan(const execution::parallel_policy&, InputIter first, InputIter last,
+                               OutputIter result, BinaryOp binary_op, const T* init, m_false_type)
+{
+  return init ? mystl::inclusive_scan(first, last, result, binary_op, *init)
+              : mystl::inclusive_scan(first, last, result, binary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class BinaryOp, class T>
+RandomIter2 exec_inclusive_scan(const execution::parallel_policy& policy, RandomIter1 first, RandomIter1 last,
+                                RandomIter2 result, BinaryOp binary_op, const T* init, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+  {
+    return init ? mystl::inclusive_scan(first, last, result, binary_op, *init)
+                : mystl::inclusive_scan(first, last, result, binary_op);
+  }
+  // 每一块的和，最后一块不需要
+  mystl::vector<T> sums(chunks - 1, T(*first));
+  auto reduce_body = [&](size_t i)
+  {
+    auto b = first + par_chunk_begin(n, chunks, i);
+    const auto e = first + par_chunk_begin(n, chunks, i + 1);
+    T sum = *b;
+    sums[i] = mystl::accumulate(++b, e, mystl::move(sum), binary_op);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks - 1, reduce_body);
+  // sums[i] 变为前 i + 1 块的前缀
+  if (init)
+    sums[0] = binary_op(*init, sums[0]);
+  for (size_t i = 1; i < sums.size(); ++i)
+    sums[i] = binary_op(sums[i - 1], sums[i]);
+  auto scan_body = [&](size_t i)
+  {
+    const size_t b = par_chunk_begin(n, chunks, i);
+    const size_t e = par_chunk_begin(n, chunks, i + 1);
+    if (i != 0)
+      mystl::inclusive_scan(first + b, first + e, result + b, binary_op, sums[i - 1]);
+    else if (init)
+      mystl::inclusive_scan(first + b, first + e, result + b, binary_op, *init);
+    else
+      mystl::inclusive_scan(first + b, first + e, result + b, binary_op);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, scan_body);
+  return result + n;
+}
+
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter exec_inclusive_scan(const execution::parallel_policy& policy, InputIter first, InputIter last,
+                               OutputIter result, BinaryOp binary_op, const T* init)
+{
+  return mystl::exec_inclusive_scan(policy, first, last, result, binary_op, init,
+                                    m_bool_constant<is_random_access_iterator<InputIter>::value &&
+                                                    is_random_access_iterator<OutputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::exec_inclusive_scan(policy, first, last, result, mystl::plus<value_type>(),
+                                    static_cast<const value_type*>(nullptr));
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result,
+               BinaryOp binary_op)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::exec_inclusive_scan(policy, first, last, result, binary_op,
+                                    static_cast<const value_type*>(nullptr));
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp, class T>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result,
+               BinaryOp binary_op, T init)
+{
+  return mystl::exec_inclusive_scan(policy, first, last, result, binary_op,
+                                    static_cast<const T*>(&init));
+}
+
+/*****************************************************************************************/
+// sort
+// 并行版本：快速排序的每次分割把右半部分交给线程池，区间小于阈值或分割恶化时使用串行的 sort
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void par_sort_aux(task_group& group, RandomIter first, RandomIter last,
+                  size_t cutoff, size_t depth_limit, Compared comp)
+{
+  while (static_cast<size_t>(last - first) > cutoff && depth_limit != 0)
+  {
+    --depth_limit;
+    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
+    auto cut = mystl::unchecked_partition(first, last, mid, comp);
+    group.run([&group, cut, last, cutoff, depth_limit, comp]
+    {
+      mystl::par_sort_aux(group, cut, last, cutoff, depth_limit, comp);
+    });
+    last = cut;
+  }
+  mystl::sort(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void exec_sort(const execution::sequenced_policy&, RandomIter first, RandomIter last, Compared comp)
+{
+  mystl::sort(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void exec_sort(const execution::parallel_policy& policy, RandomIter first, RandomIter last,
+               Compared comp)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t threads = policy.pool().concurrency();
+  if (threads == 1 || n < kParallelGrain * 4)
+  {
+    mystl::sort(first, last, comp);
+    return;
+  }
+  size_t cutoff = n / (threads * 8);
+  if (cutoff < kParallelGrain)
+    cutoff = kParallelGrain;
+  task_group group(policy.pool());
+  mystl::par_sort_aux(group, first, last, cutoff, slg2(n) * 2, comp);
+  group.wait();
+}
+
+template <class ExecutionPolicy, class RandomIter>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::exec_sort(policy, first, last, mystl::less<value_type>());
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last, Compared comp)
+{
+  mystl::exec_sort(policy, first, last, comp);
+}
+
+/*****************************************************************************************/
+// sort(policy, list)
+// 并行版本把 list 拆成若干个 list 并行排序，再逐轮并行 merge，结果与 list::sort 相同 (稳定)
+/*****************************************************************************************/
+template <class T, class Alloc, class Compared>
+void exec_list_sort(const execution::sequenced_policy&, list<T, Alloc>& l, Compared comp)
+{
+  l.sort(comp);
+}
+
+template <class T, class Alloc, class Compared>
+void exec_list_sort(const execution::parallel_policy& policy, list<T, Alloc>& l, Compared comp)
+{
+  const size_t n = l.size();
+  const size_t threads = policy.pool().concurrency();
+  if (threads == 1 || n < kParallelGrain * 4)
+  {
+    l.sort(comp);
+    return;
+  }
+  const size_t parts = n / kParallelGrain < threads ? n / kParallelGrain : threads;
+  mystl::vector<list<T, Alloc>> pieces;
+  pieces.reserve(parts);
+  for (size_t i = 0; i < parts; ++i)
+    pieces.emplace_back(l.get_allocator());
+  // 按顺序拆分，保证 merge 之后相等元素的相对位置不变
+  for (size_t i = 0; i + 1 < parts; ++i)
+  {
+    auto last = l.begin();
+    mystl::advance(last, par_chunk_begin(n, parts, i + 1) - par_chunk_begin(n, parts, i));
+    pieces[i].splice(pieces[i].end(), l, l.begin(), last);
+  }
+  pieces[parts - 1].splice(pieces[parts - 1].end(), l);
+  try
+  {
+    auto sort_body = [&](size_t i) { pieces[i].sort(comp); };
+    mystl::par_run_chunks(policy.pool(), parts, sort_body);
+    for (size_t width = 1; width < parts; width *= 2)
+    {
+      const size_t merges = (parts - width + width * 2 - 1) / (width * 2);
+      auto merge_body = [&](size_t k)
+      {
+        const size_t i = k * width * 2;
+        pieces[i].merge(pieces[i + width], comp);
+      };
+      mystl::par_run_chunks(policy.pool(), merges, merge_body);
+    }
+  }
+  catch (...)
+  { // 把所有元素放回 l
+    for (auto& piece : pieces)
+      l.splice(l.end(), piece);
+    throw;
+  }
+  l.splice(l.end(), pieces[0]);
+}
+
+template <class ExecutionPolicy, class T, class Alloc>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+sort(ExecutionPolicy&& policy, list<T, Alloc>& l)
+{
+  mystl::exec_list_sort(policy, l, mystl::less<T>());
+}
+
+template <class ExecutionPolicy, class T, class Alloc, class Compared>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+sort(ExecutionPolicy&& policy, list<T, Alloc>& l, Compared comp)
+{
+  mystl::exec_list_sort(policy, l, comp);
+}
+
+/*****************************************************************************************/
+// stable_sort
+// 并行版本把区间分块后并行调用 stable_sort，再逐轮并行合并相邻的块
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void exec_stable_sort(const execution::sequenced_policy&, RandomIter first, RandomIter last,
+                      Compared comp)
+{
+  mystl::stable_sort(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void exec_stable_sort(const execution::parallel_policy& policy, RandomIter first, RandomIter last,
+                      Compared comp)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = par_chunk_count(policy, n);
+  if (chunks == 1)
+  {
+    mystl::stable_sort(first, last, comp);
+    return;
+  }
+  auto sort_body = [&](size_t i)
+  {
+    mystl::stable_sort(first + par_chunk_begin(n, chunks, i),
+                       first + par_chunk_begin(n, chunks, i + 1), comp);
+  };
+  mystl::par_run_chunks(policy.pool(), chunks, sort_body);
+  for (size_t width = 1; width < chunks; width *= 2)
+  {
+    // 本轮合并 [i, i + width) 与 [i + width, i + 2 * width) 两组块，i = 0, 2 * width, ...
+    const size_t merges = (chunks - width + width * 2 - 1) / (width * 2);
+    auto merge_body = [&](size_t k)
+    {
+      const size_t i = k * width * 2;
+      const size_t j = mystl::min(i + width * 2, chunks);
+      mystl::inplace_merge(first + par_chunk_begin(n, chunks, i),
+                           first + par_chunk_begin(n, chunks, i + width),
+                           first + par_chunk_begin(n, chunks, j), comp);
+    };
+    mystl::par_run_chunks(policy.pool(), merges, merge_body);
+  }
+}
+
+template <class ExecutionPolicy, class RandomIter>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+stable_sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::exec_stable_sort(policy, first, last, mystl::less<value_type>());
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+stable_sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last, Compared comp)
+{
+  mystl::exec_stable_sort(policy, first, last, comp);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EXECUTION_H_
+
@@ -0,0 +1,1092 @@
+﻿#ifndef MYTINYSTL_FLAT_HASHTABLE_H_
+#define MYTINYSTL_FLAT_HASHTABLE_H_
+
+// 这个头文件包含了一个模板类 flat_hashtable
+// flat_hashtable : 开放寻址哈希表，元素直接存放在一块连续的槽数组中，
+// 另用一个字节数组记录每个槽的控制信息，以 8 个控制字节为一组进行探测
+
+// notes:
+//
+// 与 hashtable 的取舍：
+// hashtable 为每个元素单独分配节点，元素的地址在整个生命周期内保持不变，
+// flat_hashtable 把元素放在连续的槽里，查找时只需要读控制字节和少量槽，缓存更友好，但：
+//   * 插入可能触发扩容，扩容会移动所有元素，之前的迭代器、指针、引用全部失效
+//   * 删除只把槽标记为已删除，不移动其它元素，只有指向被删元素的迭代器失效
+//   * 扩容时元素通过移动构造搬到新槽，对 pair<const Key, T> 而言键会被复制
+//   * 只支持键值唯一的版本，没有桶和局部迭代器，bucket 系列接口按槽来解释
+
+#include <initializer_list>
+#include <cstdint>
+
+#include "hashtable.h"
+
+namespace mystl
+{
+
+// 控制字节的取值
+// 0 ~ 127 : 槽已被占用，值为哈希值的低 7 位
+// empty   : 空槽，探测遇到它就可以停止
+// deleted : 删除留下的墓碑，查找时要越过它，插入时可以复用
+// sentinel: 放在控制数组末尾，迭代器遍历到这里结束
+typedef signed char fht_ctrl_type;
+
+static constexpr fht_ctrl_type fht_empty    = -128;
+static constexpr fht_ctrl_type fht_deleted  = -2;
+static constexpr fht_ctrl_type fht_sentinel = -1;
+
+// 一组控制字节的宽度
+static constexpr size_t fht_group_width = 8;
+
+// 空表共用的控制字节，保证空表上的查找和遍历不需要特判
+inline fht_ctrl_type* fht_empty_group()
+{
+  alignas(16) static fht_ctrl_type group[16] = {
+    fht_sentinel, fht_empty, fht_empty, fht_empty, fht_empty, fht_empty, fht_empty, fht_empty,
+    fht_empty,    fht_empty, fht_empty, fht_empty, fht_empty, fht_empty, fht_empty, fht_empty
+  };
+  return group;
+}
+
+// 求最低位的 1 所在的位置，mask 不能为 0
+inline unsigned fht_trailing_zeros(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(mask));
+#else
+  unsigned n = 0;
+  while ((mask & 1) == 0)
+  {
+    mask >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// 求最高位的 1 之前 0 的个数，mask 不能为 0
+inline unsigned fht_leading_zeros(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_clzll(mask));
+#else
+  unsigned n = 0;
+  while ((mask & (static_cast<uint64_t>(1) << 63)) == 0)
+  {
+    mask <<= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// 一组控制字节，按小端序装进一个 64 位整数中，用位运算一次比较 8 个字节
+struct fht_group
+{
+  static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+  uint64_t ctrl;
+
+  explicit fht_group(const fht_ctrl_type* pos)
+  {
+    ctrl = 0;
+    for (size_t i = 0; i < fht_group_width; ++i)
+      ctrl |= static_cast<uint64_t>(static_cast<unsigned char>(pos[i])) << (i * 8);
+  }
+
+  // 返回与 h2 相等的字节，每个匹配字节的最高位置 1
+  // 这种写法在真正匹配的字节之后偶尔会多报一个，调用者总会再比较一次键，不影响正确性
+  uint64_t match(fht_ctrl_type h2) const
+  {
+    const uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+    return (x - lsbs) & ~x & msbs;
+  }
+
+  // 空槽：最高位为 1 且第 1 位为 0
+  uint64_t match_empty() const
+  {
+    return (ctrl & (~ctrl << 6)) & msbs;
+  }
+
+  // 空槽或墓碑：最高位为 1 且第 0 位为 0
+  uint64_t match_empty_or_deleted() const
+  {
+    return (ctrl & (~ctrl << 7)) & msbs;
+  }
+
+  // 从匹配结果中取出最低的字节下标
+  static size_t lowest(uint64_t mask)
+  {
+    return fht_trailing_zeros(mask) >> 3;
+  }
+};
+
+// 探测序列：以组为单位做三角数跳跃，容量为 2^k - 1 时可以遍历全部槽
+struct fht_probe_seq
+{
+  size_t mask;
+  size_t offset;
+  size_t index;
+
+  fht_probe_seq(size_t h, size_t m)
+    :mask(m), offset(h & m), index(0)
+  {
+  }
+
+  size_t pos(size_t i) const { return (offset + i) & mask; }
+
+  void next()
+  {
+    index += fht_group_width;
+    offset = (offset + index) & mask;
+  }
+};
+
+// forward declaration
+template <class T, class Hash, class KeyEqual, class Alloc>
+class flat_hashtable;
+
+template <class T, class Hash, class KeyEqual>
+struct fht_iterator;
+
+template <class T, class Hash, class KeyEqual>
+struct fht_const_iterator;
+
+// fht_iterator
+// 迭代器同时记录控制字节与槽的位置，前进时跳过空槽和墓碑，遇到 sentinel 即为 end
+template <class T, class Hash, class KeyEqual>
+struct fht_iterator_base :public mystl::iterator<mystl::forward_iterator_tag, T>
+{
+  typedef fht_iterator_base<T, Hash, KeyEqual> base;
+
+  fht_ctrl_type* ctrl;  // 指向控制字节
+  T*             slot;  // 指向对应的槽
+
+  fht_iterator_base() = default;
+  fht_iterator_base(fht_ctrl_type* c, T* s) :ctrl(c), slot(s) {}
+
+  void skip_empty_or_deleted()
+  {
+    while (*ctrl < fht_sentinel)
+    {
+      ++ctrl;
+      ++slot;
+    }
+  }
+
+  void incr()
+  {
+    ++ctrl;
+    ++slot;
+    skip_empty_or_deleted();
+  }
+
+  bool operator==(const base& rhs) const { return ctrl == rhs.ctrl; }
+  bool operator!=(const base& rhs) const { return ctrl != rhs.ctrl; }
+};
+
+template <class T, class Hash, class KeyEqual>
+struct fht_iterator :public fht_iterator_base<T, Hash, KeyEqual>
+{
+  typedef fht_iterator_base<T, Hash, KeyEqual> base;
+  typedef fht_iterator<T, Hash, KeyEqual>      iterator;
+  typedef T                                    value_type;
+  typedef value_type*                          pointer;
+  typedef value_type&                          reference;
+
+  using base::ctrl;
+  using base::slot;
+
+  fht_iterator() = default;
+  fht_iterator(fht_ctrl_type* c, T* s) :base(c, s) {}
+
+  reference operator*()  const { return *slot; }
+  pointer   operator->() const { return &(operator*()); }
+
+  iterator& operator++()
+  {
+    MYSTL_DEBUG(*ctrl >= 0);
+    this->incr();
+    return *this;
+  }
+  iterator operator++(int)
+  {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+};
+
+template <class T, class Hash, class KeyEqual>
+struct fht_const_iterator :public fht_iterator_base<T, Hash, KeyEqual>
+{
+  typedef fht_iterator_base<T, Hash, KeyEqual> base;
+  typedef fht_iterator<T, Hash, KeyEqual>      iterator;
+  typedef fht_const_iterator<T, Hash, KeyEqual> const_iterator;
+  typedef T                                    value_type;
+  typedef const value_type*                    pointer;
+  typedef const value_type&                    reference;
+
+  using base::ctrl;
+  using base::slot;
+
+  fht_const_iterator() = default;
+  fht_const_iterator(fht_ctrl_type* c, T* s) :base(c, s) {}
+  fht_const_iterator(const iterator& rhs) :base(rhs.ctrl, rhs.slot) {}
+
+  reference operator*()  const { return *slot; }
+  pointer   operator->() const { return &(operator*()); }
+
+  const_iterator& operator++()
+  {
+    MYSTL_DEBUG(*ctrl >= 0);
+    this->incr();
+    return *this;
+  }
+  const_iterator operator++(int)
+  {
+    const_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+};
+
+// 模板类 flat_hashtable
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表分配器类型
+template <class T, class Hash, class KeyEqual, class Alloc = mystl::allocator<T>>
+class flat_hashtable
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+public:
+  // flat_hashtable 的型别定义
+  typedef ht_value_traits<T>                           value_traits;
+  typedef typename value_traits::key_type              key_type;
+  typedef typename value_traits::mapped_type           mapped_type;
+  typedef typename value_traits::value_type            value_type;
+  typedef Hash                                         hasher;
+  typedef KeyEqual                                     key_equal;
+
+  typedef Alloc                                        allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> data_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<fht_ctrl_type> ctrl_allocator;
+  typedef mystl::allocator_traits<data_allocator>      data_traits;
+  typedef mystl::allocator_traits<ctrl_allocator>      ctrl_traits;
+
+  typedef typename data_traits::pointer                pointer;
+  typedef typename data_traits::const_pointer          const_pointer;
+  typedef value_type&                                  reference;
+  typedef const value_type&                            const_reference;
+  typedef typename data_traits::size_type              size_type;
+  typedef typename data_traits::difference_type        difference_type;
+
+  typedef mystl::fht_iterator<T, Hash, KeyEqual>       iterator;
+  typedef mystl::fht_const_iterator<T, Hash, KeyEqual> const_iterator;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<data_allocator>          alloc_base;
+  using alloc_base::M_alloc;
+
+  // 用以下几个参数来表现 flat_hashtable
+  fht_ctrl_type* ctrl_;         // 控制字节，长度为 capacity_ + fht_group_width
+  T*             slots_;        // 槽数组，长度为 capacity_
+  size_type      capacity_;     // 槽的数量，总是 0 或 2^k - 1
+  size_type      size_;         // 元素个数
+  size_type      growth_left_;  // 在需要扩容之前还能占用的空槽数
+  float          mlf_;          // 最大负载因子
+  hasher         hash_;
+  key_equal      equal_;
+
+public:
+  // 构造、复制、移动、析构函数
+  explicit flat_hashtable(size_type bucket_count,
+                          const Hash& hash = Hash(),
+                          const KeyEqual& equal = KeyEqual(),
+                          const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)),
+    ctrl_(fht_empty_group()), slots_(nullptr), capacity_(0), size_(0),
+    growth_left_(0), mlf_(0.875f), hash_(hash), equal_(equal)
+  {
+    if (bucket_count != 0)
+      reserve(bucket_count);
+  }
+
+  flat_hashtable(const flat_hashtable& rhs)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc())),
+    ctrl_(fht_empty_group()), slots_(nullptr), capacity_(0), size_(0),
+    growth_left_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    copy_init(rhs);
+  }
+  flat_hashtable(const flat_hashtable& rhs, const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc)),
+    ctrl_(fht_empty_group()), slots_(nullptr), capacity_(0), size_(0),
+    growth_left_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    copy_init(rhs);
+  }
+  flat_hashtable(flat_hashtable&& rhs) noexcept
+    :alloc_base(mystl::move(rhs.M_alloc())),
+    ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_), size_(rhs.size_),
+    growth_left_(rhs.growth_left_), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    rhs.ctrl_ = fht_empty_group();
+    rhs.slots_ = nullptr;
+    rhs.capacity_ = 0;
+    rhs.size_ = 0;
+    rhs.growth_left_ = 0;
+  }
+  flat_hashtable(flat_hashtable&& rhs, const allocator_type& alloc);
+
+  flat_hashtable& operator=(const flat_hashtable& rhs);
+  flat_hashtable& operator=(flat_hashtable&& rhs)
+    noexcept(data_traits::propagate_on_container_move_assignment::value ||
+             data_traits::is_always_equal::value);
+
+  ~flat_hashtable() { destroy_and_free(); }
+
+  // 迭代器相关操作
+  iterator       begin()        noexcept
+  {
+    iterator it(ctrl_, slots_);
+    it.skip_empty_or_deleted();
+    return it;
+  }
+  const_iterator begin()  const noexcept
+  { return const_cast<flat_hashtable*>(this)->begin(); }
+  iterator       end()          noexcept
+  { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+  const_iterator end()    const noexcept
+  { return const_cast<flat_hashtable*>(this)->end(); }
+
+  const_iterator cbegin() const noexcept
+  { return begin(); }
+  const_iterator cend()   const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+  // 修改容器相关操作
+
+  // emplace / emplace_hint
+
+  template <class ...Args>
+  pair<iterator, bool> emplace_unique(Args&& ...args);
+
+  // 先用 key 查找，找不到时才用 args 在槽上原地构造元素，args 构造出的元素的键必须与 key 相等
+  template <class K, class ...Args>
+  pair<iterator, bool> emplace_key_args(const K& key, Args&& ...args);
+
+  // [note]: 与 hashtable 相同，hint 没有意义，选择忽略它
+  template <class ...Args>
+  iterator emplace_unique_use_hint(const_iterator /*hint*/, Args&& ...args)
+  { return emplace_unique(mystl::forward<Args>(args)...).first; }
+
+  // insert
+
+  pair<iterator, bool> insert_unique(const value_type& value)
+  { return emplace_key_args(value_traits::get_key(value), value); }
+  pair<iterator, bool> insert_unique(value_type&& value)
+  { return emplace_key_args(value_traits::get_key(value), mystl::move(value)); }
+
+  iterator insert_unique_use_hint(const_iterator /*hint*/, const value_type& value)
+  { return insert_unique(value).first; }
+  iterator insert_unique_use_hint(const_iterator /*hint*/, value_type&& value)
+  { return insert_unique(mystl::move(value)).first; }
+
+  template <class InputIter>
+  void insert_unique(InputIter first, InputIter last)
+  { copy_insert_unique(first, last, iterator_category(first)); }
+
+  // erase / clear
+
+  void      erase(const_iterator position);
+  void      erase(const_iterator first, const_iterator last);
+  size_type erase_unique(const key_type& key);
+
+  void      clear();
+
+  void      swap(flat_hashtable& rhs) noexcept;
+
+  // 查找相关操作
+
+  size_type                            count(const key_type& key) const
+  { return find(key) != end() ? 1 : 0; }
+
+  iterator                             find(const key_type& key);
+  const_iterator                       find(const key_type& key) const
+  { return const_cast<flat_hashtable*>(this)->find(key); }
+
+  pair<iterator, iterator>             equal_range_unique(const key_type& key);
+  pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
+
+  // bucket interface
+  // 开放寻址没有桶，这里把每个槽看作一个桶，槽里至多有一个元素
+
+  size_type bucket_count()                 const noexcept
+  { return capacity_; }
+  size_type max_bucket_count()             const noexcept
+  { return max_size(); }
+
+  size_type bucket_size(size_type n)       const noexcept
+  { return n < capacity_ && ctrl_[n] >= 0 ? 1 : 0; }
+  size_type bucket(const key_type& key)    const
+  { return capacity_ == 0 ? 0 : (ht_mix(hash_(key)) >> 7) & capacity_; }
+
+  // hash policy
+
+  float load_factor() const noexcept
+  { return capacity_ != 0 ? (float)size_ / capacity_ : 0.0f; }
+
+  float max_load_factor() const noexcept
+  { return mlf_; }
+  // 开放寻址的负载因子不能超过 1，过高的负载因子会让探测序列变长，这里限制在 (0, 0.9375] 之间
+  void max_load_factor(float ml)
+  {
+    THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0, "invalid hash load factor");
+    mlf_ = ml > 0.9375f ? 0.9375f : ml;
+    rehash(0);
+  }
+
+  void rehash(size_type count);
+
+  void reserve(size_type count)
+  { rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
+
+  hasher    hash_fcn() const { return hash_; }
+  key_equal key_eq()   const { return equal_; }
+
+private:
+  // flat_hashtable 成员函数
+
+  // capacity
+  static size_type normalize_capacity(size_type n);
+  size_type        capacity_to_growth(size_type cap) const;
+
+  // init
+  void      initialize_slots(size_type cap);
+  void      copy_init(const flat_hashtable& ht);
+  void      destroy_and_free();
+  void      swap_data(flat_hashtable& rhs) noexcept;
+  void      move_assign(flat_hashtable& rhs, m_true_type) noexcept;
+  void      move_assign(flat_hashtable& rhs, m_false_type);
+  void      reset_growth_left();
+
+  // ctrl
+  void      set_ctrl(size_type i, fht_ctrl_type h);
+  bool      was_never_full(size_type i) const;
+
+  // hash
+  // mystl::hash 对整数是恒等映射，先用 ht_mix 混合，否则探测序列会聚集
+  size_type hash(const key_type& key) const { return ht_mix(hash_(key)); }
+  static size_type     h1(size_type h) { return h >> 7; }
+  static fht_ctrl_type h2(size_type h) { return static_cast<fht_ctrl_type>(h & 0x7f); }
+
+  // probe
+  size_type find_first_non_full(size_type h) const;
+  size_type find_index(const key_type& key, size_type h) const;
+  size_type prepare_insert(size_type h);
+  void      rehash_and_grow_if_necessary();
+  void      resize(size_type new_capacity);
+
+  iterator  M_it(size_type i) noexcept
+  { return iterator(ctrl_ + i, slots_ + i); }
+
+  // insert
+  template <class InputIter>
+  void copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag);
+  template <class ForwardIter>
+  void copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值运算符
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>&
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+operator=(const flat_hashtable& rhs)
+{
+  if (this != &rhs)
+  {
+    if (data_traits::propagate_on_container_copy_assignment::value &&
+        !data_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 新的分配器无法释放旧的空间，先用旧的分配器释放
+      destroy_and_free();
+    }
+    mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(),
+                             typename data_traits::propagate_on_container_copy_assignment());
+    flat_hashtable tmp(rhs, M_alloc());
+    swap_data(tmp);
+  }
+  return *this;
+}
+
+// 移动赋值运算符
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>&
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+operator=(flat_hashtable&& rhs)
+noexcept(data_traits::propagate_on_container_move_assignment::value ||
+         data_traits::is_always_equal::value)
+{
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                data_traits::propagate_on_container_move_assignment::value ||
+                data_traits::is_always_equal::value>());
+  }
+  return *this;
+}
+
+// 使用指定分配器的移动构造函数，分配器不相等时逐个移动元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+flat_hashtable(flat_hashtable&& rhs, const allocator_type& alloc)
+  :alloc_base(data_allocator(alloc)),
+  ctrl_(fht_empty_group()), slots_(nullptr), capacity_(0), size_(0),
+  growth_left_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    swap_data(rhs);
+  }
+  else
+  {
+    reserve(rhs.size_);
+    for (auto it = rhs.begin(), end = rhs.end(); it != end; ++it)
+      insert_unique(mystl::move(*it));
+    rhs.clear();
+  }
+}
+
+// 就地构造元素，键值不允许重复
+// 元素的键要在构造后才能得到，所以先构造一个临时对象，再移动到槽中
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+emplace_unique(Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);
+  return emplace_key_args(value_traits::get_key(tmp), mystl::move(tmp));
+}
+
+// 先查找 key，不存在时再构造元素，构造失败时不改变容器
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class K, class ...Args>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+emplace_key_args(const K& key, Args&& ...args)
+{
+  const size_type h = hash(key);
+  const size_type i = find_index(key, h);
+  if (i != capacity_)
+    return mystl::make_pair(M_it(i), false);
+  const size_type target = prepare_insert(h);
+  data_traits::construct(M_alloc(), slots_ + target, mystl::forward<Args>(args)...);
+  growth_left_ -= (ctrl_[target] == fht_empty);
+  set_ctrl(target, h2(h));
+  ++size_;
+  return mystl::make_pair(M_it(target), true);
+}
+
+// 删除迭代器所指的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase(const_iterator position)
+{
+  MYSTL_DEBUG(position.ctrl >= ctrl_ && position.ctrl < ctrl_ + capacity_);
+  MYSTL_DEBUG(*position.ctrl >= 0);
+  const size_type i = static_cast<size_type>(position.ctrl - ctrl_);
+  data_traits::destroy(M_alloc(), slots_ + i);
+  --size_;
+  // 所在窗口从未满过时，不会有探测序列越过这个槽，可以直接置为空槽
+  if (was_never_full(i))
+  {
+    set_ctrl(i, fht_empty);
+    ++growth_left_;
+  }
+  else
+  {
+    set_ctrl(i, fht_deleted);
+  }
+}
+
+// 删除[first, last)内的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase(const_iterator first, const_iterator last)
+{
+  if (first.ctrl == ctrl_ && last.ctrl == ctrl_ + capacity_)
+  {
+    clear();
+    return;
+  }
+  while (first != last)
+  {
+    const_iterator next = first;
+    ++next;
+    erase(first);
+    first = next;
+  }
+}
+
+// 删除键值为 key 的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+erase_unique(const key_type& key)
+{
+  iterator it = find(key);
+  if (it == end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+// 清空 flat_hashtable，保留槽数组
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+clear()
+{
+  if (capacity_ == 0)
+    return;
+  if (size_ != 0)
+  {
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+      if (ctrl_[i] >= 0)
+        data_traits::destroy(M_alloc(), slots_ + i);
+    }
+  }
+  mystl::fill_n(ctrl_, capacity_ + fht_group_width, fht_empty);
+  ctrl_[capacity_] = fht_sentinel;
+  size_ = 0;
+  reset_growth_left();
+}
+
+// 在某个位置查找键值为 key 的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+find(const key_type& key)
+{
+  return M_it(find_index(key, hash(key)));
+}
+
+// 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+  typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+equal_range_unique(const key_type& key)
+{
+  iterator it = find(key);
+  if (it == end())
+    return mystl::make_pair(it, it);
+  iterator next = it;
+  return mystl::make_pair(it, ++next);
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+  typename flat_hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+equal_range_unique(const key_type& key) const
+{
+  const_iterator it = find(key);
+  if (it == end())
+    return mystl::make_pair(it, it);
+  const_iterator next = it;
+  return mystl::make_pair(it, ++next);
+}
+
+// 交换 flat_hashtable
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+swap(flat_hashtable& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
+    swap_data(rhs);
+  }
+}
+
+// 重新对元素进行一遍哈希，槽数至少能以当前的负载因子容纳 size_ 个元素
+// count 为 0 时只做收缩或清理墓碑
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+rehash(size_type count)
+{
+  const size_type need = static_cast<size_type>((float)size_ / max_load_factor()) + 1;
+  if (count == 0 && size_ == 0)
+  {
+    destroy_and_free();
+    return;
+  }
+  const size_type n = normalize_capacity(mystl::max(count, need));
+  if (n != capacity_ || capacity_to_growth(capacity_) < size_)
+    resize(n);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 把槽数调整为 2^k - 1，最少为 15 个，以保证控制数组尾部复制的那一组字节不与 sentinel 冲突
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+normalize_capacity(size_type n)
+{
+  size_type cap = 15;
+  while (cap < n)
+  {
+    THROW_LENGTH_ERROR_IF(cap > (static_cast<size_type>(-1) >> 1) / sizeof(T),
+                          "flat_hashtable<T>'s size too big");
+    cap = cap * 2 + 1;
+  }
+  return cap;
+}
+
+// 在负载因子的限制下，cap 个槽最多能放多少个元素，至少留一个空槽保证探测能够终止
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+capacity_to_growth(size_type cap) const
+{
+  const size_type growth = static_cast<size_type>((float)cap * mlf_);
+  return growth < cap ? growth : cap - 1;
+}
+
+// 分配 cap 个槽与控制字节，并全部标记为空
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+initialize_slots(size_type cap)
+{
+  THROW_LENGTH_ERROR_IF(cap > data_traits::max_size(M_alloc()),
+                        "flat_hashtable<T>'s size too big");
+  ctrl_allocator ca(M_alloc());
+  fht_ctrl_type* ctrl = ctrl_traits::allocate(ca, cap + fht_group_width);
+  try
+  {
+    slots_ = data_traits::allocate(M_alloc(), cap);
+  }
+  catch (...)
+  {
+    ctrl_traits::deallocate(ca, ctrl, cap + fht_group_width);
+    throw;
+  }
+  ctrl_ = ctrl;
+  capacity_ = cap;
+  mystl::fill_n(ctrl_, cap + fht_group_width, fht_empty);
+  ctrl_[cap] = fht_sentinel;
+  reset_growth_left();
+}
+
+// 复制另一个 flat_hashtable，槽位的布局保持不变，不需要重新哈希
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+copy_init(const flat_hashtable& ht)
+{
+  if (ht.size_ == 0)
+    return;
+  initialize_slots(ht.capacity_);
+  size_type i = 0;
+  try
+  {
+    for (; i < capacity_; ++i)
+    {
+      if (ht.ctrl_[i] >= 0)
+        data_traits::construct(M_alloc(), slots_ + i, ht.slots_[i]);
+    }
+  }
+  catch (...)
+  {
+    for (size_type j = 0; j < i; ++j)
+    {
+      if (ht.ctrl_[j] >= 0)
+        data_traits::destroy(M_alloc(), slots_ + j);
+    }
+    data_traits::deallocate(M_alloc(), slots_, capacity_);
+    ctrl_allocator ca(M_alloc());
+    ctrl_traits::deallocate(ca, ctrl_, capacity_ + fht_group_width);
+    ctrl_ = fht_empty_group();
+    slots_ = nullptr;
+    capacity_ = 0;
+    growth_left_ = 0;
+    throw;
+  }
+  mystl::copy(ht.ctrl_, ht.ctrl_ + capacity_ + fht_group_width, ctrl_);
+  size_ = ht.size_;
+  growth_left_ = ht.growth_left_;
+}
+
+// 析构所有元素并释放空间
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+destroy_and_free()
+{
+  if (capacity_ == 0)
+    return;
+  for (size_type i = 0; i < capacity_; ++i)
+  {
+    if (ctrl_[i] >= 0)
+      data_traits::destroy(M_alloc(), slots_ + i);
+  }
+  data_traits::deallocate(M_alloc(), slots_, capacity_);
+  ctrl_allocator ca(M_alloc());
+  ctrl_traits::deallocate(ca, ctrl_, capacity_ + fht_group_width);
+  ctrl_ = fht_empty_group();
+  slots_ = nullptr;
+  capacity_ = 0;
+  size_ = 0;
+  growth_left_ = 0;
+}
+
+// 只交换数据成员，不交换分配器
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+swap_data(flat_hashtable& rhs) noexcept
+{
+  mystl::swap(ctrl_, rhs.ctrl_);
+  mystl::swap(slots_, rhs.slots_);
+  mystl::swap(capacity_, rhs.capacity_);
+  mystl::swap(size_, rhs.size_);
+  mystl::swap(growth_left_, rhs.growth_left_);
+  mystl::swap(mlf_, rhs.mlf_);
+  mystl::swap(hash_, rhs.hash_);
+  mystl::swap(equal_, rhs.equal_);
+}
+
+// move_assign 函数
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+move_assign(flat_hashtable& rhs, m_true_type) noexcept
+{
+  destroy_and_free();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename data_traits::propagate_on_container_move_assignment());
+  swap_data(rhs);
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+move_assign(flat_hashtable& rhs, m_false_type)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  flat_hashtable tmp(mystl::move(rhs), M_alloc());
+  destroy_and_free();
+  swap_data(tmp);
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+reset_growth_left()
+{
+  growth_left_ = capacity_to_growth(capacity_) - size_;
+}
+
+// 设置第 i 个控制字节，前 fht_group_width - 1 个字节同时复制到 sentinel 之后，
+// 使得从任意位置读取一整组时都不需要回绕
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+set_ctrl(size_type i, fht_ctrl_type h)
+{
+  const size_type cloned = fht_group_width - 1;
+  ctrl_[i] = h;
+  ctrl_[((i - cloned) & capacity_) + (cloned & capacity_)] = h;
+}
+
+// 若第 i 个槽前后两组中的空槽之间距离小于一组，说明没有哪次探测在这里遇到过满组
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool flat_hashtable<T, Hash, KeyEqual, Alloc>::
+was_never_full(size_type i) const
+{
+  const size_type before = (i - fht_group_width) & capacity_;
+  const uint64_t empty_after = fht_group(ctrl_ + i).match_empty();
+  const uint64_t empty_before = fht_group(ctrl_ + before).match_empty();
+  return empty_before != 0 && empty_after != 0 &&
+    (fht_trailing_zeros(empty_after) >> 3) + (fht_leading_zeros(empty_before) >> 3) < fht_group_width;
+}
+
+// 找到探测序列上第一个空槽或墓碑
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+find_first_non_full(size_type h) const
+{
+  fht_probe_seq seq(h1(h), capacity_);
+  while (true)
+  {
+    const uint64_t mask = fht_group(ctrl_ + seq.offset).match_empty_or_deleted();
+    if (mask != 0)
+      return seq.pos(fht_group::lowest(mask));
+    seq.next();
+    MYSTL_DEBUG(seq.index <= capacity_);
+  }
+}
+
+// 查找键值为 key 的元素所在的槽，找不到时返回 capacity_
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+find_index(const key_type& key, size_type h) const
+{
+  const fht_ctrl_type tag = h2(h);
+  fht_probe_seq seq(h1(h), capacity_);
+  while (true)
+  {
+    const fht_group g(ctrl_ + seq.offset);
+    for (uint64_t mask = g.match(tag); mask != 0; mask &= mask - 1)
+    {
+      const size_type i = seq.pos(fht_group::lowest(mask));
+      if (equal_(value_traits::get_key(slots_[i]), key))
+        return i;
+    }
+    if (g.match_empty() != 0)
+      return capacity_;
+    seq.next();
+    MYSTL_DEBUG(seq.index <= capacity_);
+  }
+}
+
+// 为哈希值为 h 的新元素找一个槽，必要时先扩容
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::
+prepare_insert(size_type h)
+{
+  if (capacity_ == 0)
+    rehash_and_grow_if_necessary();
+  size_type target = find_first_non_full(h);
+  if (growth_left_ == 0 && ctrl_[target] != fht_deleted)
+  {
+    rehash_and_grow_if_necessary();
+    target = find_first_non_full(h);
+  }
+  return target;
+}
+
+// 墓碑较多时在原容量上重新哈希以清理墓碑，否则容量翻倍
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+rehash_and_grow_if_necessary()
+{
+  if (capacity_ == 0)
+    resize(normalize_capacity(0));
+  else if (size_ * 2 <= capacity_to_growth(capacity_))
+    resize(capacity_);
+  else
+    resize(capacity_ * 2 + 1);
+}
+
+// 分配新的槽数组，把所有元素移动过去
+template <class T, class Hash, class KeyEqual, class Alloc>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+resize(size_type new_capacity)
+{
+  fht_ctrl_type* old_ctrl = ctrl_;
+  T*             old_slots = slots_;
+  const size_type old_capacity = capacity_;
+  const size_type old_size = size_;
+  size_ = 0;
+  try
+  {
+    initialize_slots(new_capacity);
+  }
+  catch (...)
+  {
+    ctrl_ = old_ctrl;
+    slots_ = old_slots;
+    capacity_ = old_capacity;
+    size_ = old_size;
+    throw;
+  }
+  for (size_type i = 0; i < old_capacity; ++i)
+  {
+    if (old_ctrl[i] >= 0)
+    {
+      const size_type h = hash(value_traits::get_key(old_slots[i]));
+      const size_type target = find_first_non_full(h);
+      data_traits::construct(M_alloc(), slots_ + target, mystl::move(old_slots[i]));
+      data_traits::destroy(M_alloc(), old_slots + i);
+      set_ctrl(target, h2(h));
+    }
+  }
+  size_ = old_size;
+  reset_growth_left();
+  if (old_capacity != 0)
+  {
+    data_traits::deallocate(M_alloc(), old_slots, old_capacity);
+    ctrl_allocator ca(M_alloc());
+    ctrl_traits::deallocate(ca, old_ctrl, old_capacity + fht_group_width);
+  }
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class InputIter>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
+{
+  for (; first != last; ++first)
+    insert_unique(*first);
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ForwardIter>
+void flat_hashtable<T, Hash, KeyEqual, Alloc>::
+copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
+{
+  reserve(size_ + static_cast<size_type>(mystl::distance(first, last)));
+  for (; first != last; ++first)
+    insert_unique(*first);
+}
+
+// 重载比较操作符，两个表中的元素互相能够找到且相等时为 true
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool operator==(const flat_hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+                const flat_hashtable<T, Hash, KeyEqual, Alloc>& rhs)
+{
+  typedef ht_value_traits<T> value_traits;
+  if (lhs.size() != rhs.size())
+    return false;
+  for (auto it = lhs.begin(), end = lhs.end(); it != end; ++it)
+  {
+    auto found = rhs.find(value_traits::get_key(*it));
+    if (found == rhs.end() || !(*found == *it))
+      return false;
+  }
+  return true;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool operator!=(const flat_hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+                const flat_hashtable<T, Hash, KeyEqual, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+          flat_hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_HASHTABLE_H_
+
@@ -0,0 +1,804 @@
+﻿#ifndef MYTINYSTL_FLAT_MAP_H_
+#define MYTINYSTL_FLAT_MAP_H_
+
+// 这个头文件包含了两个模板类 flat_map 和 flat_multimap
+// flat_map      : 映射，功能与用法与 map 类似，元素按键值顺序存放在 vector 中，键值不允许重复
+// flat_multimap : 映射，功能与用法与 multimap 类似，元素按键值顺序存放在 vector 中，键值允许重复
+
+// notes:
+//
+// 与 map 的区别：
+// 1. 元素类型为 pair<Key, T> 而不是 pair<const Key, T>，以便在 vector 中移动，
+//    不要通过迭代器修改键值，否则会破坏元素的顺序
+// 2. 插入删除会移动其它元素，之后所有的迭代器、指针、引用都会失效
+// 3. 批量构建时请使用范围构造或范围插入，新元素只排序一次，
+//    输入已经有序时可以传入 sorted_unique / sorted_equivalent 标签跳过排序
+// 4. extract() 取出底层的 vector，replace() 以一个 vector 替换底层序列
+// 5. 参数五为 flat_eytzinger_search 时，查找使用 Eytzinger 索引，详见 flat_tree.h
+//
+// 异常保证：
+// mystl::flat_map<Key, T> / mystl::flat_multimap<Key, T> 满足基本异常保证，
+// 在元素的移动构造不抛出异常时，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert（单个元素）
+
+#include "flat_tree.h"
+
+namespace mystl
+{
+
+// 模板类 flat_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator，参数五代表查找方式，缺省使用 flat_binary_search
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<Key, T>>,
+          class Search = flat_binary_search>
+class flat_map
+{
+public:
+  // flat_map 的嵌套型别定义
+  typedef Key                        key_type;
+  typedef T                          mapped_type;
+  typedef mystl::pair<Key, T>        value_type;
+  typedef Compare                    key_compare;
+
+  // 定义一个 functor，用来进行元素比较
+  class value_compare : public binary_function <value_type, value_type, bool>
+  {
+    friend class flat_map<Key, T, Compare, Alloc, Search>;
+  private:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+  public:
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    {
+      return comp(lhs.first, rhs.first);  // 比较键值的大小
+    }
+  };
+
+private:
+  // 以 mystl::flat_tree 作为底层机制
+  typedef mystl::flat_tree<value_type, key_compare, Alloc, Search>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 flat_tree 的型别
+  typedef typename base_type::pointer                pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::reference              reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::iterator               iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::reverse_iterator       reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+  typedef typename base_type::sequence_type          sequence_type;
+
+public:
+  // 构造、复制、移动、赋值函数
+
+  flat_map() = default;
+
+  explicit flat_map(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit flat_map(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
+  template <class InputIterator>
+  flat_map(InputIterator first, InputIterator last,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(first, last); }
+  flat_map(std::initializer_list<value_type> ilist,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+  // 输入序列已经有序且没有重复键值时，使用 sorted_unique 标签跳过排序
+  template <class InputIterator>
+  flat_map(sorted_unique_t, InputIterator first, InputIterator last,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_sorted_unique(first, last); }
+  flat_map(sorted_unique_t, std::initializer_list<value_type> ilist,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_sorted_unique(ilist.begin(), ilist.end()); }
+
+  // 接管一个序列，序列会被排序并去重
+  explicit flat_map(sequence_type seq, const key_compare& comp = key_compare())
+    :tree_(comp, seq.get_allocator())
+  { tree_.replace_unique(mystl::move(seq)); }
+  flat_map(sorted_unique_t, sequence_type seq, const key_compare& comp = key_compare())
+    :tree_(comp, seq.get_allocator())
+  { tree_.replace_sorted(mystl::move(seq)); }
+
+  flat_map(const flat_map& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  flat_map(const flat_map& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
+  flat_map(flat_map&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+  flat_map(flat_map&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
+
+  flat_map& operator=(const flat_map& rhs)
+  { 
+    tree_ = rhs.tree_; 
+    return *this;
+  }
+  flat_map& operator=(flat_map&& rhs)
+  { 
+    tree_ = mystl::move(rhs.tree_);
+    return *this;
+  }
+
+  flat_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare            key_comp()      const { return tree_.key_comp(); }
+  value_compare          value_comp()    const { return value_compare(tree_.key_comp()); }
+  allocator_type         get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept
+  { return tree_.begin(); }
+  const_iterator         begin()   const noexcept
+  { return tree_.begin(); }
+  iterator               end()           noexcept
+  { return tree_.end(); }
+  const_iterator         end()     const noexcept
+  { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+  size_type              capacity() const noexcept { return tree_.capacity(); }
+
+  void                   reserve(size_type n)      { tree_.reserve(n); }
+  void                   shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+  // 底层序列相关
+
+  // 只读访问底层的有序序列
+  const sequence_type&   sequence() const noexcept { return tree_.sequence(); }
+
+  // 取出底层序列，之后容器为空
+  sequence_type          extract()                 { return tree_.extract(); }
+
+  // 以 seq 替换底层序列，seq 会被排序并去重，sorted_unique 版本要求 seq 已经有序且没有重复键值
+  void                   replace(sequence_type&& seq)
+  { tree_.replace_unique(mystl::move(seq)); }
+  void                   replace(sorted_unique_t, sequence_type&& seq)
+  { tree_.replace_sorted(mystl::move(seq)); }
+
+  // 访问元素相关
+
+  // 若键值不存在，at 会抛出一个异常
+  mapped_type& at(const key_type& key)
+  {
+    iterator it = lower_bound(key);
+    // it->first >= key
+    THROW_OUT_OF_RANGE_IF(it == end() || key_comp()(it->first, key),
+                          "flat_map<Key, T> no such element exists");
+    return it->second;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    // it->first >= key
+    THROW_OUT_OF_RANGE_IF(it == end() || key_comp()(it->first, key),
+                          "flat_map<Key, T> no such element exists");
+    return it->second;
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    iterator it = lower_bound(key);
+    // it->first >= key
+    if (it == end() || key_comp()(key, it->first))
+      it = emplace_hint(it, key, T{});
+    return it->second;
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    iterator it = lower_bound(key);
+    // it->first >= key
+    if (it == end() || key_comp()(key, it->first))
+      it = emplace_hint(it, mystl::move(key), T{});
+    return it->second;
+  }
+
+  // 插入删除相关
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  {
+    return tree_.emplace_unique(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  pair<iterator, bool> insert(const value_type& value)
+  {
+    return tree_.insert_unique(value);
+  }
+  pair<iterator, bool> insert(value_type&& value)
+  {
+    return tree_.insert_unique(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_unique(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_unique(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  template <class InputIterator>
+  void insert(sorted_unique_t, InputIterator first, InputIterator last)
+  {
+    tree_.insert_sorted_unique(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_unique(ilist.begin(), ilist.end());
+  }
+  void insert(sorted_unique_t, std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_sorted_unique(ilist.begin(), ilist.end());
+  }
+
+  iterator  erase(iterator position)             { return tree_.erase(position); }
+  size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
+  iterator  erase(iterator first, iterator last) { return tree_.erase(first, last); }
+
+  void      clear()                              { tree_.clear(); }
+
+  // flat_map 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  size_type      count(const key_type& key)       const { return tree_.count_unique(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key) 
+  { return tree_.equal_range_unique(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const 
+  { return tree_.equal_range_unique(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_unique(key); }
+
+  void           swap(flat_map& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const flat_map& lhs, const flat_map& rhs) { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const flat_map& lhs, const flat_map& rhs) { return lhs.tree_ <  rhs.tree_; }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator==(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return lhs == rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator<(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return lhs < rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator!=(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator>(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator<=(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator>=(const flat_map<Key, T, Compare, Alloc, Search>& lhs, const flat_map<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc, class Search>
+void swap(flat_map<Key, T, Compare, Alloc, Search>& lhs, flat_map<Key, T, Compare, Alloc, Search>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 flat_multimap，键值允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator，参数五代表查找方式，缺省使用 flat_binary_search
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<Key, T>>,
+          class Search = flat_binary_search>
+class flat_multimap
+{
+public:
+  // flat_multimap 的型别定义
+  typedef Key                        key_type;
+  typedef T                          mapped_type;
+  typedef mystl::pair<Key, T>        value_type;
+  typedef Compare                    key_compare;
+
+  // 定义一个 functor，用来进行元素比较
+  class value_compare : public binary_function <value_type, value_type, bool>
+  {
+    friend class flat_multimap<Key, T, Compare, Alloc, Search>;
+  private:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+  public:
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    {
+      return comp(lhs.first, rhs.first);
+    }
+  };
+
+private:
+  // 用 mystl::flat_tree 作为底层机制
+  typedef mystl::flat_tree<value_type, key_compare, Alloc, Search>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 flat_tree 的型别
+  typedef typename base_type::pointer                pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::reference              reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::iterator               iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::reverse_iterator       reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+  typedef typename base_type::sequence_type          sequence_type;
+
+public:
+  // 构造、复制、移动函数
+
+  flat_multimap() = default;
+
+  explicit flat_multimap(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit flat_multimap(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
+  template <class InputIterator>
+  flat_multimap(InputIterator first, InputIterator last,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(first, last); }
+  flat_multimap(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+  // 输入序列已经有序时，使用 sorted_equivalent 标签跳过排序
+  template <class InputIterator>
+  flat_multimap(sorted_equivalent_t, InputIterator first, InputIterator last,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_sorted_multi(first, last); }
+  flat_multimap(sorted_equivalent_t, std::initializer_list<value_type> ilist,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_sorted_multi(ilist.begin(), ilist.end()); }
+
+  // 接管一个序列，序列会被排序
+  explicit flat_multimap(sequence_type seq, const key_compare& comp = key_compare())
+    :tree_(comp, seq.get_allocator())
+  { tree_.replace_multi(mystl::move(seq)); }
+  flat_multimap(sorted_equivalent_t, sequence_type seq, const key_compare& comp = key_compare())
+    :tree_(comp, seq.get_allocator())
+  { tree_.replace_sorted(mystl::move(seq)); }
+
+  flat_multimap(const flat_multimap& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  flat_multimap(const flat_multimap& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
+  flat_multimap(flat_multimap&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+  flat_multimap(flat_multimap&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
+
+  flat_multimap& operator=(const flat_multimap& rhs) 
+  { 
+    tree_ = rhs.tree_; 
+    return *this; 
+  }
+  flat_multimap& operator=(flat_multimap&& rhs) 
+  { 
+    tree_ = mystl::move(rhs.tree_);
+    return *this; 
+  }
+
+  flat_multimap& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_multi(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare            key_comp()      const { return tree_.key_comp(); }
+  value_compare          value_comp()    const { return value_compare(tree_.key_comp()); }
+  allocator_type         get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept
+  { return tree_.begin(); }
+  const_iterator         begin()   const noexcept
+  { return tree_.begin(); }
+  iterator               end()           noexcept
+  { return tree_.end(); }
+  const_iterator         end()     const noexcept
+  { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+  size_type              capacity() const noexcept { return tree_.capacity(); }
+
+  void                   reserve(size_type n)      { tree_.reserve(n); }
+  void                   shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+  // 底层序列相关
+
+  // 只读访问底层的有序序列
+  const sequence_type&   sequence() const noexcept { return tree_.sequence(); }
+
+  // 取出底层序列，之后容器为空
+  sequence_type          extract()                 { return tree_.extract(); }
+
+  // 以 seq 替换底层序列，seq 会被排序，sorted_equivalent 版本要求 seq 已经有序
+  void                   replace(sequence_type&& seq)
+  { tree_.replace_multi(mystl::move(seq)); }
+  void                   replace(sorted_equivalent_t, sequence_type&& seq)
+  { tree_.replace_sorted(mystl::move(seq)); }
+
+  // 插入删除操作
+
+  template <class ...Args>
+  iterator emplace(Args&& ...args)
+  {
+    return tree_.emplace_multi(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  iterator insert(const value_type& value)
+  {
+    return tree_.insert_multi(value);
+  }
+  iterator insert(value_type&& value)
+  {
+    return tree_.insert_multi(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_multi(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_multi(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_multi(first, last);
+  }
+
+  template <class InputIterator>
+  void insert(sorted_equivalent_t, InputIterator first, InputIterator last)
+  {
+    tree_.insert_sorted_multi(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_multi(ilist.begin(), ilist.end());
+  }
+  void insert(sorted_equivalent_t, std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_sorted_multi(ilist.begin(), ilist.end());
+  }
+
+  iterator       erase(iterator position)             { return tree_.erase(position); }
+  size_type      erase(const key_type& key)           { return tree_.erase_multi(key); }
+  iterator       erase(iterator first, iterator last) { return tree_.erase(first, last); }
+
+  void           clear() { tree_.clear(); }
+
+  // flat_multimap 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  size_type      count(const key_type& key)       const { return tree_.count_multi(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator> 
+    equal_range(const key_type& key)
+  { return tree_.equal_range_multi(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const 
+  { return tree_.equal_range_multi(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_multi(key); }
+
+  void swap(flat_multimap& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const flat_multimap& lhs, const flat_multimap& rhs) { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const flat_multimap& lhs, const flat_multimap& rhs) { return lhs.tree_ <  rhs.tree_; }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator==(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return lhs == rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator<(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return lhs < rhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator!=(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator>(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator<=(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+bool operator>=(const flat_multimap<Key, T, Compare, Alloc, Search>& lhs, const flat_multimap<Key, T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc, class Search>
+void swap(flat_multimap<Key, T, Compare, Alloc, Search>& lhs, flat_multimap<Key, T, Compare, Alloc, Search>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+namespace pmr
+{
+template <class Key, class T, class Compare = mystl::less<Key>>
+using flat_map = mystl::flat_map<Key, T, Compare, polymorphic_allocator<mystl::pair<Key, T>>>;
+template <class Key, class T, class Compare = mystl::less<Key>>
+using flat_multimap = mystl::flat_multimap<Key, T, Compare, polymorphic_allocator<mystl::pair<Key, T>>>;
+} // namespace pmr
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_MAP_H_
+
@@ -0,0 +1,853 @@
+﻿#ifndef MYTINYSTL_FLAT_TREE_H_
+#define MYTINYSTL_FLAT_TREE_H_
+
+// 这个头文件包含一个模板类 flat_tree
+// flat_tree : 有序 vector，元素按键值顺序连续存放，用二分查找定位，
+// 是 flat_map / flat_set / flat_multimap / flat_multiset 的底层实现
+
+// notes:
+//
+// 与 rb_tree 的取舍：
+// 元素连续存放，没有节点开销，查找与遍历的缓存表现好，适合读多写少的查找表，但：
+//   * 单个元素的插入删除需要移动其后的所有元素，复杂度为 O(n)
+//   * 插入删除之后所有的迭代器、指针、引用都会失效
+//   * 范围插入先把新元素追加到末尾，排序后与原有元素合并，再去重，复杂度为 O(n + m log m)，
+//     批量构建时应优先使用范围版本而不是逐个插入
+//   * 范围插入时比较函数抛出异常，容器会被清空
+//
+// 查找方式：
+//   * flat_binary_search    : 缺省，直接在有序序列上使用 mystl::lower_bound / upper_bound
+//   * flat_eytzinger_search : 另外以 Eytzinger（BFS）顺序保存一份键的副本，查找时没有分支，
+//     访问的前几层集中在开头的几个缓存行里；每次修改后重建索引，需要 key_type 可以复制，
+//     只适合构建之后很少修改的表
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "rb_tree.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+// 表示输入序列已经有序且没有重复键值的标签
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+constexpr sorted_unique_t sorted_unique{};
+
+// 表示输入序列已经有序，可以有重复键值的标签
+struct sorted_equivalent_t { explicit sorted_equivalent_t() = default; };
+constexpr sorted_equivalent_t sorted_equivalent{};
+
+// 查找方式
+struct flat_binary_search {};
+struct flat_eytzinger_search {};
+
+// 计算最低位连续的 1 的个数
+inline unsigned flat_trailing_ones(size_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(x)));
+#else
+  unsigned n = 0;
+  while (x & 1)
+  {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// 最高位 1 的下标，x 不能为 0
+inline unsigned flat_highest_bit(size_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return 63u - static_cast<unsigned>(__builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+  unsigned n = 0;
+  while (x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+/*****************************************************************************************/
+// flat_search_index
+// 查找索引，缺省的二分查找不需要索引
+
+template <class Search, class Key, class Alloc>
+class flat_search_index
+{
+public:
+  static constexpr bool enabled = false;
+
+  flat_search_index() = default;
+  explicit flat_search_index(const Alloc&) {}
+
+  template <class Iter, class GetKey>
+  void   rebuild(Iter, Iter, GetKey) {}
+  void   clear() noexcept {}
+  void   swap(flat_search_index&) noexcept {}
+
+  template <class K, class Compare>
+  size_t lower_bound(const K&, Compare) const { return 0; }
+  template <class K, class Compare>
+  size_t upper_bound(const K&, Compare) const { return 0; }
+  template <class K, class Compare>
+  size_t find(const K&, Compare) const { return 0; }
+};
+
+// Eytzinger 索引
+// keys_[k - 1] 是隐式完全二叉树中编号为 k 的节点的键，节点 k 的子节点为 2k 与 2k + 1，
+// 节点在有序序列中的位置就是它的中序次序，由 rank 直接算出，不需要另外保存
+template <class Key, class Alloc>
+class flat_search_index<flat_eytzinger_search, Key, Alloc>
+{
+public:
+  static constexpr bool enabled = true;
+
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<Key> key_allocator;
+
+private:
+  mystl::vector<Key, key_allocator> keys_;
+
+public:
+  flat_search_index() = default;
+  explicit flat_search_index(const Alloc& alloc)
+    :keys_(key_allocator(alloc))
+  {
+  }
+
+  template <class Iter, class GetKey>
+  void rebuild(Iter first, Iter last, GetKey get_key)
+  {
+    const size_t n = static_cast<size_t>(last - first);
+    keys_.clear();
+    keys_.reserve(n);
+    for (size_t k = 1; k <= n; ++k)
+      keys_.push_back(get_key(first[rank(k, n)]));
+  }
+
+  void clear() noexcept { keys_.clear(); }
+
+  void swap(flat_search_index& rhs) noexcept { keys_.swap(rhs.keys_); }
+
+  // 返回第一个不小于 key 的元素在有序序列中的位置
+  template <class K, class Compare>
+  size_t lower_bound(const K& key, Compare comp) const
+  {
+    const size_t n = keys_.size();
+    size_t k = 1;
+    while (k <= n)
+    {
+      prefetch(k);
+      k = 2 * k + static_cast<size_t>(comp(keys_[k - 1], key));
+    }
+    return position(k);
+  }
+
+  // 返回第一个大于 key 的元素在有序序列中的位置
+  template <class K, class Compare>
+  size_t upper_bound(const K& key, Compare comp) const
+  {
+    const size_t n = keys_.size();
+    size_t k = 1;
+    while (k <= n)
+    {
+      prefetch(k);
+      k = 2 * k + static_cast<size_t>(!comp(key, keys_[k - 1]));
+    }
+    return position(k);
+  }
+
+  // 返回键值等于 key 的元素在有序序列中的位置，不存在时返回元素个数
+  // 结果节点在查找路径上，比较时不需要访问元素本身
+  template <class K, class Compare>
+  size_t find(const K& key, Compare comp) const
+  {
+    const size_t n = keys_.size();
+    size_t k = 1;
+    while (k <= n)
+    {
+      prefetch(k);
+      k = 2 * k + static_cast<size_t>(comp(keys_[k - 1], key));
+    }
+    k >>= flat_trailing_ones(k) + 1;
+    return (k == 0 || comp(key, keys_[k - 1])) ? n : rank(k, n);
+  }
+
+private:
+  // 最后一次向左走的节点就是结果，去掉末尾向右走的步数与最后一次向左走的一步
+  size_t position(size_t k) const noexcept
+  {
+    k >>= flat_trailing_ones(k) + 1;
+    return k == 0 ? keys_.size() : rank(k, keys_.size());
+  }
+
+  // n 个节点的树中节点 k 的中序次序
+  // 先按 h 层的满二叉树算出次序 r，满树最后一层的节点位于偶数次序上，再减去 r 之前缺少的节点
+  static size_t rank(size_t k, size_t n) noexcept
+  {
+    const unsigned h = flat_highest_bit(n) + 1;
+    const unsigned d = flat_highest_bit(k);
+    const size_t last = n - ((static_cast<size_t>(1) << (h - 1)) - 1);  // 最后一层的节点数
+    const size_t r = ((2 * (k - (static_cast<size_t>(1) << d)) + 1) << (h - 1 - d)) - 1;
+    const size_t before = (r + 1) / 2;  // 满树中 r 之前最后一层的节点数
+    return before > last ? r - (before - last) : r;
+  }
+
+  // 预取四层之后的节点，这 16 个节点是相邻的
+  void prefetch(size_t k) const noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    if (16 * k <= keys_.size())
+      __builtin_prefetch(keys_.data() + 16 * k - 1);
+#else
+    (void)k;
+#endif
+  }
+};
+
+/*****************************************************************************************/
+// 模板类 flat_tree
+// 参数一代表元素类型，参数二代表键值比较类型，参数三代表分配器类型，参数四代表查找方式
+template <class T, class Compare, class Alloc, class Search = flat_binary_search>
+class flat_tree
+{
+public:
+  // flat_tree 的嵌套型别定义
+
+  typedef rb_tree_value_traits<T>                   value_traits;
+
+  typedef typename value_traits::key_type           key_type;
+  typedef typename value_traits::mapped_type        mapped_type;
+  typedef typename value_traits::value_type         value_type;
+  typedef Compare                                   key_compare;
+
+  typedef mystl::vector<T, Alloc>                   sequence_type;
+  typedef typename sequence_type::allocator_type    allocator_type;
+  typedef typename sequence_type::pointer           pointer;
+  typedef typename sequence_type::const_pointer     const_pointer;
+  typedef typename sequence_type::reference         reference;
+  typedef typename sequence_type::const_reference   const_reference;
+  typedef typename sequence_type::size_type         size_type;
+  typedef typename sequence_type::difference_type   difference_type;
+
+  typedef typename sequence_type::iterator               iterator;
+  typedef typename sequence_type::const_iterator         const_iterator;
+  typedef typename sequence_type::reverse_iterator       reverse_iterator;
+  typedef typename sequence_type::const_reverse_iterator const_reverse_iterator;
+
+  typedef flat_search_index<Search, key_type, Alloc> index_type;
+
+private:
+  // 比较两个元素的键值
+  struct value_less
+  {
+    Compare comp;
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    { return comp(value_traits::get_key(lhs), value_traits::get_key(rhs)); }
+  };
+
+  // 有序序列中相邻的两个元素键值相等
+  struct value_equiv
+  {
+    Compare comp;
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    { return !comp(value_traits::get_key(lhs), value_traits::get_key(rhs)); }
+  };
+
+  // lower_bound 以 comp(*it, key) 的形式调用
+  template <class K>
+  struct lower_less
+  {
+    Compare comp;
+    bool operator()(const value_type& lhs, const K& rhs) const
+    { return comp(value_traits::get_key(lhs), rhs); }
+  };
+
+  // upper_bound 以 comp(key, *it) 的形式调用
+  template <class K>
+  struct upper_less
+  {
+    Compare comp;
+    bool operator()(const K& lhs, const value_type& rhs) const
+    { return comp(lhs, value_traits::get_key(rhs)); }
+  };
+
+  struct key_getter
+  {
+    const key_type& operator()(const value_type& value) const
+    { return value_traits::get_key(value); }
+  };
+
+private:
+  sequence_type seq_;
+  index_type    index_;
+  key_compare   key_comp_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  flat_tree() = default;
+
+  explicit flat_tree(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :seq_(alloc), index_(alloc), key_comp_(comp)
+  {
+  }
+
+  flat_tree(const flat_tree& rhs)
+    :seq_(rhs.seq_), index_(rhs.index_), key_comp_(rhs.key_comp_)
+  {
+  }
+  flat_tree(const flat_tree& rhs, const allocator_type& alloc)
+    :seq_(rhs.seq_, alloc), index_(alloc), key_comp_(rhs.key_comp_)
+  {
+    rebuild_index();
+  }
+  flat_tree(flat_tree&& rhs) noexcept
+    :seq_(mystl::move(rhs.seq_)), index_(mystl::move(rhs.index_)), key_comp_(rhs.key_comp_)
+  {
+    rhs.index_.clear();
+  }
+  flat_tree(flat_tree&& rhs, const allocator_type& alloc)
+    :seq_(mystl::move(rhs.seq_), alloc), index_(alloc), key_comp_(rhs.key_comp_)
+  {
+    rhs.clear();
+    rebuild_index();
+  }
+
+  flat_tree& operator=(const flat_tree& rhs)
+  {
+    if (this != &rhs)
+    {
+      seq_ = rhs.seq_;
+      index_ = rhs.index_;
+      key_comp_ = rhs.key_comp_;
+    }
+    return *this;
+  }
+  flat_tree& operator=(flat_tree&& rhs)
+  {
+    if (this != &rhs)
+    {
+      seq_ = mystl::move(rhs.seq_);
+      index_ = mystl::move(rhs.index_);
+      key_comp_ = rhs.key_comp_;
+      rhs.clear();
+    }
+    return *this;
+  }
+
+  ~flat_tree() = default;
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept { return seq_.begin(); }
+  const_iterator         begin()   const noexcept { return seq_.begin(); }
+  iterator               end()           noexcept { return seq_.end(); }
+  const_iterator         end()     const noexcept { return seq_.end(); }
+
+  reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return seq_.empty(); }
+  size_type size()     const noexcept { return seq_.size(); }
+  size_type max_size() const noexcept { return seq_.max_size(); }
+  size_type capacity() const noexcept { return seq_.capacity(); }
+
+  void      reserve(size_type n)      { seq_.reserve(n); }
+  void      shrink_to_fit()           { seq_.shrink_to_fit(); }
+
+  // 底层序列相关操作
+
+  const sequence_type& sequence() const noexcept { return seq_; }
+
+  // 取出底层序列，之后容器为空
+  sequence_type extract()
+  {
+    sequence_type result(mystl::move(seq_));
+    clear();
+    return result;
+  }
+
+  // 以 seq 替换底层序列，sorted 版本要求 seq 已经有序（unique 版本还要求没有重复键值）
+  void replace_unique(sequence_type&& seq)
+  {
+    seq_ = mystl::move(seq);
+    sort_tail_unique(0);
+  }
+  void replace_multi(sequence_type&& seq)
+  {
+    seq_ = mystl::move(seq);
+    sort_tail_multi(0);
+  }
+  void replace_sorted(sequence_type&& seq)
+  {
+    seq_ = mystl::move(seq);
+    MYSTL_DEBUG(mystl::is_sorted(seq_.begin(), seq_.end(), value_less{ key_comp_ }));
+    rebuild_index();
+  }
+
+  // 插入删除相关操作
+
+  // emplace / emplace_use_hint 先构造出元素再确定位置
+  template <class ...Args>
+  pair<iterator, bool> emplace_unique(Args&& ...args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_unique(mystl::move(value));
+  }
+
+  template <class ...Args>
+  iterator emplace_multi(Args&& ...args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_multi(mystl::move(value));
+  }
+
+  template <class ...Args>
+  iterator emplace_unique_use_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_unique(hint, mystl::move(value));
+  }
+
+  template <class ...Args>
+  iterator emplace_multi_use_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_multi(hint, mystl::move(value));
+  }
+
+  pair<iterator, bool> insert_unique(const value_type& value)
+  { return insert_unique_value(value); }
+  pair<iterator, bool> insert_unique(value_type&& value)
+  { return insert_unique_value(mystl::move(value)); }
+
+  iterator             insert_multi(const value_type& value)
+  { return insert_multi_value(value); }
+  iterator             insert_multi(value_type&& value)
+  { return insert_multi_value(mystl::move(value)); }
+
+  iterator             insert_unique(const_iterator hint, const value_type& value)
+  { return insert_unique_value(hint, value); }
+  iterator             insert_unique(const_iterator hint, value_type&& value)
+  { return insert_unique_value(hint, mystl::move(value)); }
+
+  iterator             insert_multi(const_iterator hint, const value_type& value)
+  { return insert_multi_value(hint, value); }
+  iterator             insert_multi(const_iterator hint, value_type&& value)
+  { return insert_multi_value(hint, mystl::move(value)); }
+
+  template <class InputIter>
+  void insert_unique(InputIter first, InputIter last)
+  {
+    const size_type old_size = size();
+    seq_.insert(seq_.end(), first, last);
+    sort_tail_unique(old_size);
+  }
+
+  template <class InputIter>
+  void insert_multi(InputIter first, InputIter last)
+  {
+    const size_type old_size = size();
+    seq_.insert(seq_.end(), first, last);
+    sort_tail_multi(old_size);
+  }
+
+  // [first, last) 已经有序时跳过排序，只做合并
+  template <class InputIter>
+  void insert_sorted_unique(InputIter first, InputIter last)
+  {
+    const size_type old_size = size();
+    seq_.insert(seq_.end(), first, last);
+    merge_tail(old_size, true);
+  }
+
+  template <class InputIter>
+  void insert_sorted_multi(InputIter first, InputIter last)
+  {
+    const size_type old_size = size();
+    seq_.insert(seq_.end(), first, last);
+    merge_tail(old_size, false);
+  }
+
+  iterator  erase(const_iterator position);
+  iterator  erase(const_iterator first, const_iterator last);
+
+  template <class K>
+  size_type erase_unique(const K& key);
+  template <class K>
+  size_type erase_multi(const K& key);
+
+  void      clear() noexcept
+  {
+    seq_.clear();
+    index_.clear();
+  }
+
+  // 查找相关操作
+
+  template <class K>
+  iterator       find(const K& key)
+  { return begin() + find_pos(key, m_bool_constant<index_type::enabled>()); }
+  template <class K>
+  const_iterator find(const K& key) const
+  { return begin() + find_pos(key, m_bool_constant<index_type::enabled>()); }
+
+  template <class K>
+  size_type count_unique(const K& key) const
+  {
+    return find(key) != end() ? 1 : 0;
+  }
+  template <class K>
+  size_type count_multi(const K& key) const
+  {
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(p.second - p.first);
+  }
+
+  template <class K>
+  iterator       lower_bound(const K& key)
+  { return begin() + lower_pos(key, m_bool_constant<index_type::enabled>()); }
+  template <class K>
+  const_iterator lower_bound(const K& key) const
+  { return begin() + lower_pos(key, m_bool_constant<index_type::enabled>()); }
+
+  template <class K>
+  iterator       upper_bound(const K& key)
+  { return begin() + upper_pos(key, m_bool_constant<index_type::enabled>()); }
+  template <class K>
+  const_iterator upper_bound(const K& key) const
+  { return begin() + upper_pos(key, m_bool_constant<index_type::enabled>()); }
+
+  template <class K>
+  pair<iterator, iterator>
+  equal_range_unique(const K& key)
+  {
+    iterator it = find(key);
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, it + 1);
+  }
+  template <class K>
+  pair<const_iterator, const_iterator>
+  equal_range_unique(const K& key) const
+  {
+    const_iterator it = find(key);
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, it + 1);
+  }
+
+  template <class K>
+  pair<iterator, iterator>
+  equal_range_multi(const K& key)
+  { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+  template <class K>
+  pair<const_iterator, const_iterator>
+  equal_range_multi(const K& key) const
+  { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+
+  key_compare    key_comp()      const { return key_comp_; }
+  allocator_type get_allocator() const { return seq_.get_allocator(); }
+
+  void swap(flat_tree& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      seq_.swap(rhs.seq_);
+      index_.swap(rhs.index_);
+      mystl::swap(key_comp_, rhs.key_comp_);
+    }
+  }
+
+private:
+  template <class K>
+  size_type lower_pos(const K& key, m_false_type) const
+  {
+    return static_cast<size_type>(
+      mystl::lower_bound(seq_.begin(), seq_.end(), key, lower_less<K>{ key_comp_ }) - seq_.begin());
+  }
+  template <class K>
+  size_type lower_pos(const K& key, m_true_type) const
+  {
+    return index_.lower_bound(key, key_comp_);
+  }
+
+  template <class K>
+  size_type find_pos(const K& key, m_false_type) const
+  {
+    const size_type pos = lower_pos(key, m_false_type());
+    return (pos == size() || key_comp_(key, value_traits::get_key(seq_[pos]))) ? size() : pos;
+  }
+  template <class K>
+  size_type find_pos(const K& key, m_true_type) const
+  {
+    return index_.find(key, key_comp_);
+  }
+
+  template <class K>
+  size_type upper_pos(const K& key, m_false_type) const
+  {
+    return static_cast<size_type>(
+      mystl::upper_bound(seq_.begin(), seq_.end(), key, upper_less<K>{ key_comp_ }) - seq_.begin());
+  }
+  template <class K>
+  size_type upper_pos(const K& key, m_true_type) const
+  {
+    return index_.upper_bound(key, key_comp_);
+  }
+
+  // 检查 hint 是否是 key 的合法插入位置
+  bool hint_unique_ok(const_iterator hint, const key_type& key) const
+  {
+    return (hint == begin() || key_comp_(value_traits::get_key(*(hint - 1)), key)) &&
+           (hint == end()   || key_comp_(key, value_traits::get_key(*hint)));
+  }
+  bool hint_multi_ok(const_iterator hint, const key_type& key) const
+  {
+    return (hint == begin() || !key_comp_(key, value_traits::get_key(*(hint - 1)))) &&
+           (hint == end()   || !key_comp_(value_traits::get_key(*hint), key));
+  }
+
+  void rebuild_index()
+  {
+    index_.rebuild(seq_.begin(), seq_.end(), key_getter());
+  }
+
+  template <class V>
+  pair<iterator, bool> insert_unique_value(V&& value);
+  template <class V>
+  iterator             insert_multi_value(V&& value);
+  template <class V>
+  iterator             insert_unique_value(const_iterator hint, V&& value);
+  template <class V>
+  iterator             insert_multi_value(const_iterator hint, V&& value);
+
+  void sort_tail_unique(size_type pos);
+  void sort_tail_multi(size_type pos);
+  void merge_tail(size_type pos, bool unique);
+};
+
+/*****************************************************************************************/
+
+// 插入新值，键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为 true，否则为 false
+template <class T, class Compare, class Alloc, class Search>
+template <class V>
+pair<typename flat_tree<T, Compare, Alloc, Search>::iterator, bool>
+flat_tree<T, Compare, Alloc, Search>::
+insert_unique_value(V&& value)
+{
+  const key_type& key = value_traits::get_key(value);
+  iterator pos = lower_bound(key);
+  if (pos != end() && !key_comp_(key, value_traits::get_key(*pos)))
+    return mystl::make_pair(pos, false);
+  pos = seq_.insert(pos, mystl::forward<V>(value));
+  rebuild_index();
+  return mystl::make_pair(pos, true);
+}
+
+// 插入新值，键值允许重复，新值放在相同键值的元素之后
+template <class T, class Compare, class Alloc, class Search>
+template <class V>
+typename flat_tree<T, Compare, Alloc, Search>::iterator
+flat_tree<T, Compare, Alloc, Search>::
+insert_multi_value(V&& value)
+{
+  iterator pos = upper_bound(value_traits::get_key(value));
+  pos = seq_.insert(pos, mystl::forward<V>(value));
+  rebuild_index();
+  return pos;
+}
+
+// 在 hint 附近插入，键值不允许重复，hint 不合适时退化为普通的插入
+template <class T, class Compare, class Alloc, class Search>
+template <class V>
+typename flat_tree<T, Compare, Alloc, Search>::iterator
+flat_tree<T, Compare, Alloc, Search>::
+insert_unique_value(const_iterator hint, V&& value)
+{
+  if (!hint_unique_ok(hint, value_traits::get_key(value)))
+    return insert_unique_value(mystl::forward<V>(value)).first;
+  iterator pos = seq_.insert(hint, mystl::forward<V>(value));
+  rebuild_index();
+  return pos;
+}
+
+// 在 hint 附近插入，键值允许重复，hint 不合适时退化为普通的插入
+template <class T, class Compare, class Alloc, class Search>
+template <class V>
+typename flat_tree<T, Compare, Alloc, Search>::iterator
+flat_tree<T, Compare, Alloc, Search>::
+insert_multi_value(const_iterator hint, V&& value)
+{
+  if (!hint_multi_ok(hint, value_traits::get_key(value)))
+    return insert_multi_value(mystl::forward<V>(value));
+  iterator pos = seq_.insert(hint, mystl::forward<V>(value));
+  rebuild_index();
+  return pos;
+}
+
+// 删除 position 处的元素，返回指向下一个元素的迭代器
+template <class T, class Compare, class Alloc, class Search>
+typename flat_tree<T, Compare, Alloc, Search>::iterator
+flat_tree<T, Compare, Alloc, Search>::
+erase(const_iterator position)
+{
+  iterator pos = seq_.erase(position);
+  rebuild_index();
+  return pos;
+}
+
+// 删除[first, last)区间内的元素
+template <class T, class Compare, class Alloc, class Search>
+typename flat_tree<T, Compare, Alloc, Search>::iterator
+flat_tree<T, Compare, Alloc, Search>::
+erase(const_iterator first, const_iterator last)
+{
+  iterator pos = seq_.erase(first, last);
+  rebuild_index();
+  return pos;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare, class Alloc, class Search>
+template <class K>
+typename flat_tree<T, Compare, Alloc, Search>::size_type
+flat_tree<T, Compare, Alloc, Search>::
+erase_unique(const K& key)
+{
+  iterator it = find(key);
+  if (it == end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+template <class T, class Compare, class Alloc, class Search>
+template <class K>
+typename flat_tree<T, Compare, Alloc, Search>::size_type
+flat_tree<T, Compare, Alloc, Search>::
+erase_multi(const K& key)
+{
+  auto p = equal_range_multi(key);
+  const size_type n = static_cast<size_type>(p.second - p.first);
+  if (n != 0)
+    erase(p.first, p.second);
+  return n;
+}
+
+// 对 [pos, end) 的新元素做稳定排序，与原有元素合并后去重
+// 稳定排序与合并保证相同键值中先出现的元素在前，去重时保留先出现的元素
+template <class T, class Compare, class Alloc, class Search>
+void flat_tree<T, Compare, Alloc, Search>::
+sort_tail_unique(size_type pos)
+{
+  try
+  {
+    mystl::stable_sort(seq_.begin() + pos, seq_.end(), value_less{ key_comp_ });
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+  merge_tail(pos, true);
+}
+
+template <class T, class Compare, class Alloc, class Search>
+void flat_tree<T, Compare, Alloc, Search>::
+sort_tail_multi(size_type pos)
+{
+  try
+  {
+    mystl::stable_sort(seq_.begin() + pos, seq_.end(), value_less{ key_comp_ });
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+  merge_tail(pos, false);
+}
+
+// 合并有序的 [begin, pos) 与 [pos, end)，新元素全部大于原有元素时不需要移动
+template <class T, class Compare, class Alloc, class Search>
+void flat_tree<T, Compare, Alloc, Search>::
+merge_tail(size_type pos, bool unique)
+{
+  try
+  {
+    const iterator mid = seq_.begin() + pos;
+    MYSTL_DEBUG(mystl::is_sorted(mid, seq_.end(), value_less{ key_comp_ }));
+    if (pos != 0 && mid != seq_.end() && !value_less{ key_comp_ }(*(mid - 1), *mid))
+      mystl::inplace_merge(seq_.begin(), mid, seq_.end(), value_less{ key_comp_ });
+    if (unique)
+      seq_.erase(mystl::unique(seq_.begin(), seq_.end(), value_equiv{ key_comp_ }), seq_.end());
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+  rebuild_index();
+}
+
+// 重载比较操作符
+template <class T, class Compare, class Alloc, class Search>
+bool operator==(const flat_tree<T, Compare, Alloc, Search>& lhs,
+                const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare, class Alloc, class Search>
+bool operator<(const flat_tree<T, Compare, Alloc, Search>& lhs,
+               const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Compare, class Alloc, class Search>
+bool operator!=(const flat_tree<T, Compare, Alloc, Search>& lhs,
+                const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Compare, class Alloc, class Search>
+bool operator>(const flat_tree<T, Compare, Alloc, Search>& lhs,
+               const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Compare, class Alloc, class Search>
+bool operator<=(const flat_tree<T, Compare, Alloc, Search>& lhs,
+                const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Compare, class Alloc, class Search>
+bool operator>=(const flat_tree<T, Compare, Alloc, Search>& lhs,
+                const flat_tree<T, Compare, Alloc, Search>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare, class Alloc, class Search>
+void swap(flat_tree<T, Compare, Alloc, Search>& lhs,
+          flat_tree<T, Compare, Alloc, Search>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_TREE_H_
+
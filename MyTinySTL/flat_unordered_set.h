@@ -0,0 +1,280 @@
+﻿#ifndef MYTINYSTL_FLAT_UNORDERED_SET_H_
+#define MYTINYSTL_FLAT_UNORDERED_SET_H_
+
+// 这个头文件包含一个模板类 flat_unordered_set
+// 功能与用法与 unordered_set 类似，不同的是使用 flat_hashtable 作为底层实现机制，元素存放在连续的槽中
+
+// notes:
+//
+// 迭代器与引用的稳定性：
+// 与 unordered_set 不同，插入元素可能引起扩容，扩容后所有的迭代器、指针、引用都会失效，
+// 需要保存元素地址或者边遍历边插入时，请使用 unordered_set
+//
+// 异常保证：
+// mystl::flat_unordered_set<Key> 满足基本异常保证，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert
+
+#include "flat_hashtable.h"
+
+namespace mystl
+{
+
+// 模板类 flat_unordered_set，键值不允许重复
+// 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
+// 参数三代表键值比较方式，缺省使用 mystl::equal_to
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<Key>>
+class flat_unordered_set
+{
+private:
+  // 使用 flat_hashtable 作为底层机制
+  typedef flat_hashtable<Key, Hash, KeyEqual, Alloc> base_type;
+  base_type ht_;
+
+public:
+  // 使用 flat_hashtable 的型别
+  typedef typename base_type::allocator_type       allocator_type;
+  typedef typename base_type::key_type             key_type;
+  typedef typename base_type::value_type           value_type;
+  typedef typename base_type::hasher               hasher;
+  typedef typename base_type::key_equal            key_equal;
+
+  typedef typename base_type::size_type            size_type;
+  typedef typename base_type::difference_type      difference_type;
+  typedef typename base_type::pointer              pointer;
+  typedef typename base_type::const_pointer        const_pointer;
+  typedef typename base_type::reference            reference;
+  typedef typename base_type::const_reference      const_reference;
+
+  typedef typename base_type::const_iterator       iterator;
+  typedef typename base_type::const_iterator       const_iterator;
+
+  allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+public:
+  // 构造、复制、移动函数
+
+  // 默认构造不分配空间，第一次插入时再分配
+  flat_unordered_set()
+    :ht_(0, Hash(), KeyEqual())
+  {
+  }
+
+  explicit flat_unordered_set(const allocator_type& alloc)
+    :ht_(0, Hash(), KeyEqual(), alloc)
+  {
+  }
+
+  explicit flat_unordered_set(size_type bucket_count,
+                              const Hash& hash = Hash(),
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
+  {
+  }
+
+  template <class InputIterator>
+  flat_unordered_set(InputIterator first, InputIterator last,
+                     const size_type bucket_count = 0,
+                     const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc)
+  {
+    ht_.insert_unique(first, last);
+  }
+
+  flat_unordered_set(std::initializer_list<value_type> ilist,
+                     const size_type bucket_count = 0,
+                     const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
+  {
+    ht_.insert_unique(ilist.begin(), ilist.end());
+  }
+
+  flat_unordered_set(const flat_unordered_set& rhs)
+    :ht_(rhs.ht_)
+  {
+  }
+  flat_unordered_set(const flat_unordered_set& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
+  flat_unordered_set(flat_unordered_set&& rhs) noexcept
+    : ht_(mystl::move(rhs.ht_))
+  {
+  }
+  flat_unordered_set(flat_unordered_set&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
+
+  flat_unordered_set& operator=(const flat_unordered_set& rhs)
+  {
+    ht_ = rhs.ht_;
+    return *this;
+  }
+  flat_unordered_set& operator=(flat_unordered_set&& rhs)
+    noexcept(std::is_nothrow_move_assignable<base_type>::value)
+  {
+    ht_ = mystl::move(rhs.ht_);
+    return *this;
+  }
+
+  flat_unordered_set& operator=(std::initializer_list<value_type> ilist)
+  {
+    ht_.clear();
+    ht_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~flat_unordered_set() = default;
+
+
+  // 迭代器相关
+
+  iterator       begin()        noexcept
+  { return ht_.begin(); }
+  const_iterator begin()  const noexcept
+  { return ht_.begin(); }
+  iterator       end()          noexcept
+  { return ht_.end(); }
+  const_iterator end()    const noexcept
+  { return ht_.end(); }
+
+  const_iterator cbegin() const noexcept
+  { return ht_.cbegin(); }
+  const_iterator cend()   const noexcept
+  { return ht_.cend(); }
+
+  // 容量相关
+
+  bool      empty()    const noexcept { return ht_.empty(); }
+  size_type size()     const noexcept { return ht_.size(); }
+  size_type max_size() const noexcept { return ht_.max_size(); }
+
+  // 修改容器操作
+
+  // empalce / empalce_hint
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  { return ht_.emplace_unique(mystl::forward<Args>(args)...); }
+
+  template <class ...Args>
+  iterator emplace_hint(const_iterator hint, Args&& ...args)
+  { return ht_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...); }
+
+  // insert
+
+  pair<iterator, bool> insert(const value_type& value)
+  { return ht_.insert_unique(value); }
+  pair<iterator, bool> insert(value_type&& value)
+  { return ht_.insert_unique(mystl::move(value)); }
+
+  iterator insert(const_iterator hint, const value_type& value)
+  { return ht_.insert_unique_use_hint(hint, value); }
+  iterator insert(const_iterator hint, value_type&& value)
+  { return ht_.insert_unique_use_hint(hint, mystl::move(value)); }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  { ht_.insert_unique(first, last); }
+
+  // erase / clear
+
+  void      erase(iterator it)
+  { ht_.erase(it); }
+  void      erase(iterator first, iterator last)
+  { ht_.erase(first, last); }
+
+  size_type erase(const key_type& key)
+  { return ht_.erase_unique(key); }
+
+  void      clear()
+  { ht_.clear(); }
+
+  void      swap(flat_unordered_set& other) noexcept
+  { ht_.swap(other.ht_); }
+
+  // 查找相关
+
+  size_type      count(const key_type& key) const
+  { return ht_.count(key); }
+
+  iterator       find(const key_type& key)
+  { return ht_.find(key); }
+  const_iterator find(const key_type& key)  const
+  { return ht_.find(key); }
+
+  pair<iterator, iterator> equal_range(const key_type& key)
+  { return ht_.equal_range_unique(key); }
+  pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+  { return ht_.equal_range_unique(key); }
+
+  // bucket interface
+  // 每个槽看作一个桶，没有局部迭代器
+
+  size_type bucket_count()                 const noexcept
+  { return ht_.bucket_count(); }
+  size_type max_bucket_count()             const noexcept
+  { return ht_.max_bucket_count(); }
+
+  size_type bucket_size(size_type n)       const noexcept
+  { return ht_.bucket_size(n); }
+  size_type bucket(const key_type& key)    const
+  { return ht_.bucket(key); }
+
+  // hash policy
+
+  float     load_factor()            const noexcept { return ht_.load_factor(); }
+
+  float     max_load_factor()        const noexcept { return ht_.max_load_factor(); }
+  void      max_load_factor(float ml)               { ht_.max_load_factor(ml); }
+
+  void      rehash(size_type count)                 { ht_.rehash(count); }
+  void      reserve(size_type count)                { ht_.reserve(count); }
+
+  hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
+  key_equal key_eq()                 const          { return ht_.key_eq(); }
+
+public:
+  friend bool operator==(const flat_unordered_set& lhs, const flat_unordered_set& rhs)
+  {
+    return lhs.ht_ == rhs.ht_;
+  }
+  friend bool operator!=(const flat_unordered_set& lhs, const flat_unordered_set& rhs)
+  {
+    return lhs.ht_ != rhs.ht_;
+  }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class Hash, class KeyEqual, class Alloc>
+void swap(flat_unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+          flat_unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+// 控制字节与槽位都在堆上（空表指向共享的静态控制字节），可以按字节搬移
+template <class Key, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<flat_unordered_set<Key, Hash, KeyEqual, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Hash>::value &&
+                   is_trivially_relocatable<KeyEqual>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+namespace pmr
+{
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+using flat_unordered_set = mystl::flat_unordered_set<Key, Hash, KeyEqual, polymorphic_allocator<Key>>;
+} // namespace pmr
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_UNORDERED_SET_H_
+
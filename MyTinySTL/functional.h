@@ -4,6 +4,10 @@
 // 这个头文件包含了 mystl 的函数对象与哈希函数
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "util.h"
 
 namespace mystl
 {
@@ -29,42 +33,42 @@ struct binary_function
 template <class T>
 struct plus :public binary_function<T, T, T>
 {
-  T operator()(const T& x, const T& y) const { return x + y; }
+  constexpr T operator()(const T& x, const T& y) const { return x + y; }
 };
 
 // 函数对象：减法
 template <class T>
 struct minus :public binary_function<T, T, T>
 {
-  T operator()(const T& x, const T& y) const { return x - y; }
+  constexpr T operator()(const T& x, const T& y) const { return x - y; }
 };
 
 // 函数对象：乘法
 template <class T>
 struct multiplies :public binary_function<T, T, T>
 {
-  T operator()(const T& x, const T& y) const { return x * y; }
+  constexpr T operator()(const T& x, const T& y) const { return x * y; }
 };
 
 // 函数对象：除法
 template <class T>
 struct divides :public binary_function<T, T, T>
 {
-  T operator()(const T& x, const T& y) const { return x / y; }
+  constexpr T operator()(const T& x, const T& y) const { return x / y; }
 };
 
 // 函数对象：模取
 template <class T>
 struct modulus :public binary_function<T, T, T>
 {
-  T operator()(const T& x, const T& y) const { return x % y; }
+  constexpr T operator()(const T& x, const T& y) const { return x % y; }
 };
 
 // 函数对象：否定
 template <class T>
 struct negate :public unarg_function<T, T>
 {
-  T operator()(const T& x) const { return -x; }
+  constexpr T operator()(const T& x) const { return -x; }
 };
 
 // 加法的证同元素
@@ -75,81 +79,125 @@ T identity_element(plus<T>) { return T(0); }
 template <class T>
 T identity_element(multiplies<T>) { return T(1); }
 
+// 判断函数对象是否声明了 is_transparent
+template <class F, class = void>
+struct is_transparent :public m_false_type {};
+
+template <class F>
+struct is_transparent<F, typename m_void<typename F::is_transparent>::type>
+  :public m_true_type {};
+
 // 函数对象：等于
-template <class T>
+template <class T = void>
 struct equal_to :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x == y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x == y; }
+};
+
+// equal_to<void> 接受任意两个可以用 == 比较的参数，并声明 is_transparent，供关联容器做异构查找
+template <>
+struct equal_to<void>
+{
+  typedef int is_transparent;
+
+  template <class T, class U>
+  constexpr auto operator()(T&& x, U&& y) const
+    -> decltype(mystl::forward<T>(x) == mystl::forward<U>(y))
+  { return mystl::forward<T>(x) == mystl::forward<U>(y); }
 };
 
 // 函数对象：不等于
 template <class T>
 struct not_equal_to :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x != y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x != y; }
 };
 
 // 函数对象：大于
-template <class T>
+template <class T = void>
 struct greater :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x > y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x > y; }
+};
+
+// greater<void>：透明版本，用法同 equal_to<void>
+template <>
+struct greater<void>
+{
+  typedef int is_transparent;
+
+  template <class T, class U>
+  constexpr auto operator()(T&& x, U&& y) const
+    -> decltype(mystl::forward<T>(x) > mystl::forward<U>(y))
+  { return mystl::forward<T>(x) > mystl::forward<U>(y); }
 };
 
 // 函数对象：小于
-template <class T>
+template <class T = void>
 struct less :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x < y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x < y; }
+};
+
+// less<void>：透明版本，用法同 equal_to<void>，可作为 map / set 的 Compare，如 mystl::map<mystl::string, int, mystl::less<>>
+template <>
+struct less<void>
+{
+  typedef int is_transparent;
+
+  template <class T, class U>
+  constexpr auto operator()(T&& x, U&& y) const
+    -> decltype(mystl::forward<T>(x) < mystl::forward<U>(y))
+  { return mystl::forward<T>(x) < mystl::forward<U>(y); }
 };
 
 // 函数对象：大于等于
 template <class T>
 struct greater_equal :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x >= y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x >= y; }
 };
 
 // 函数对象：小于等于
 template <class T>
 struct less_equal :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x <= y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x <= y; }
 };
 
 // 函数对象：逻辑与
 template <class T>
 struct logical_and :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x && y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x && y; }
 };
 
 // 函数对象：逻辑或
 template <class T>
 struct logical_or :public binary_function<T, T, bool>
 {
-  bool operator()(const T& x, const T& y) const { return x || y; }
+  constexpr bool operator()(const T& x, const T& y) const { return x || y; }
 };
 
 // 函数对象：逻辑非
 template <class T>
 struct logical_not :public unarg_function<T, bool>
 {
-  bool operator()(const T& x) const { return !x; }
+  constexpr bool operator()(const T& x) const { return !x; }
 };
 
 // 证同函数：不会改变元素，返回本身
 template <class T>
 struct identity :public unarg_function<T, bool>
 {
-  const T& operator()(const T& x) const { return x; }
+  constexpr const T& operator()(const T& x) const { return x; }
 };
 
 // 选择函数：接受一个 pair，返回第一个元素
 template <class Pair>
 struct selectfirst :public unarg_function<Pair, typename Pair::first_type>
 {
-  const typename Pair::first_type& operator()(const Pair& x) const
+  constexpr const typename Pair::first_type& operator()(const Pair& x) const
   {
     return x.first;
   }
@@ -159,7 +207,7 @@ struct selectfirst :public unarg_function<Pair, typename Pair::first_type>
 template <class Pair>
 struct selectsecond :public unarg_function<Pair, typename Pair::second_type>
 {
-  const typename Pair::second_type& operator()(const Pair& x) const
+  constexpr const typename Pair::second_type& operator()(const Pair& x) const
   {
     return x.second;
   }
@@ -169,14 +217,14 @@ struct selectsecond :public unarg_function<Pair, typename Pair::second_type>
 template <class Arg1, class Arg2>
 struct projectfirst :public binary_function<Arg1, Arg2, Arg1>
 {
-  Arg1 operator()(const Arg1& x, const Arg2&) const { return x; }
+  constexpr Arg1 operator()(const Arg1& x, const Arg2&) const { return x; }
 };
 
 // 投射函数：返回第二参数
 template <class Arg1, class Arg2>
 struct projectsecond :public binary_function<Arg1, Arg2, Arg1>
 {
-  Arg2 operator()(const Arg1&, const Arg2& y) const { return y; }
+  constexpr Arg2 operator()(const Arg1&, const Arg2& y) const { return y; }
 };
 
 /*****************************************************************************************/
@@ -195,11 +243,11 @@ struct hash<T*>
 };
 
 // 对于整型类型，只是返回原值
-#define MYSTL_TRIVIAL_HASH_FCN(Type)         \
-template <> struct hash<Type>                \
-{                                            \
-  size_t operator()(Type val) const noexcept \
-  { return static_cast<size_t>(val); }       \
+#define MYSTL_TRIVIAL_HASH_FCN(Type)                   \
+template <> struct hash<Type>                          \
+{                                                      \
+  constexpr size_t operator()(Type val) const noexcept \
+  { return static_cast<size_t>(val); }                 \
 };
 
 MYSTL_TRIVIAL_HASH_FCN(bool)
@@ -234,49 +282,173 @@ MYSTL_TRIVIAL_HASH_FCN(unsigned long long)
 
 #undef MYSTL_TRIVIAL_HASH_FCN
 
-// 对于浮点数，逐位哈希
-inline size_t bitwise_hash(const unsigned char* first, size_t count)
-{
+// FNV-1a 的参数
 #if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) &&__SIZEOF_POINTER__ == 8)
-  const size_t fnv_offset = 14695981039346656037ull;
-  const size_t fnv_prime = 1099511628211ull;
+constexpr size_t fnv_offset_basis = 14695981039346656037ull;
+constexpr size_t fnv_prime = 1099511628211ull;
 #else
-  const size_t fnv_offset = 2166136261u;
-  const size_t fnv_prime = 16777619u;
+constexpr size_t fnv_offset_basis = 2166136261u;
+constexpr size_t fnv_prime = 16777619u;
 #endif
-  size_t result = fnv_offset;
+
+// 逐个字符的 FNV-1a，C++14 下可以在编译期求值，供 static_map 等编译期的表使用
+// 字符按其无符号值参与运算，对 char 序列与 bitwise_hash 的结果相同
+template <class CharType>
+MYSTL_CONSTEXPR14 size_t fnv1a_hash(const CharType* first, size_t count,
+                                    size_t basis = fnv_offset_basis) noexcept
+{
+  typedef typename std::make_unsigned<CharType>::type uchar_type;
+  size_t result = basis;
   for (size_t i = 0; i < count; ++i)
   {
-    result ^= (size_t)first[i];
+    result ^= static_cast<size_t>(static_cast<uchar_type>(first[i]));
     result *= fnv_prime;
   }
   return result;
 }
 
+// FNV-1a，每次处理一个字节，保留它是为了与旧版本的哈希值保持一致
+inline size_t bitwise_hash(const unsigned char* first, size_t count)
+{
+  return mystl::fnv1a_hash(first, count);
+}
+
+// hash_bytes 的辅助函数
+namespace hash_detail
+{
+
+// 小端序读取，不要求地址对齐
+inline uint64_t read8(const unsigned char* p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint64_t read4(const unsigned char* p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+// 读取 1 ~ 3 个字节
+inline uint64_t read_small(const unsigned char* p, size_t k)
+{
+  return (static_cast<uint64_t>(p[0]) << 16) |
+         (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+// 64 位乘法，a、b 分别被替换为 128 位结果的低、高两半
+inline void mul128(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#else
+  const uint64_t a_lo = a & 0xffffffffull, a_hi = a >> 32;
+  const uint64_t b_lo = b & 0xffffffffull, b_hi = b >> 32;
+  const uint64_t lo_lo = a_lo * b_lo;
+  const uint64_t hi_lo = a_hi * b_lo;
+  const uint64_t lo_hi = a_lo * b_hi;
+  const uint64_t hi_hi = a_hi * b_hi;
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+  a = (cross << 32) | (lo_lo & 0xffffffffull);
+  b = hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+// 乘法混合：128 位乘积的高低两半异或
+inline uint64_t mum(uint64_t a, uint64_t b)
+{
+  mul128(a, b);
+  return a ^ b;
+}
+
+static constexpr uint64_t secret0 = 0x2d358dccaa6c78a5ull;
+static constexpr uint64_t secret1 = 0x8bb84b93962eacc9ull;
+static constexpr uint64_t secret2 = 0x4b33a62ed433d4a3ull;
+static constexpr uint64_t secret3 = 0x4d5a2da51de1aa47ull;
+
+} // namespace hash_detail
+
+// 按字长处理的字节串哈希，算法结构参考 wyhash
+// 长度不超过 16 字节时只做少量重叠读取（不超过 8 字节时只混合一个字），更长的输入每轮读取 48 字节，分三路做乘法混合
+inline size_t hash_bytes(const void* data, size_t len)
+{
+  using namespace hash_detail;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  uint64_t seed = mum(secret0, secret1);  // 种子固定为 0 时的初值
+  uint64_t a, b;
+  if (len <= 8)
+  {
+    if (len >= 4)
+      a = (read4(p) << 32) | read4(p + len - 4);
+    else
+      a = len > 0 ? read_small(p, len) : 0;
+    return static_cast<size_t>(mum(mum(a ^ secret1, seed ^ len) ^ secret0, seed ^ secret2));
+  }
+  if (len <= 16)
+  {
+    a = read8(p);
+    b = read8(p + len - 8);
+  }
+  else
+  {
+    size_t i = len;
+    if (i > 48)
+    {
+      uint64_t see1 = seed, see2 = seed;
+      do
+      {
+        seed = mum(read8(p) ^ secret1, read8(p + 8) ^ seed);
+        see1 = mum(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+        see2 = mum(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16)
+    {
+      seed = mum(read8(p) ^ secret1, read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= secret1;
+  b ^= seed;
+  mul128(a, b);
+  return static_cast<size_t>(mum(a ^ secret0 ^ len, b ^ secret1));
+}
+
 template <>
 struct hash<float>
 {
-  size_t operator()(const float& val)
+  size_t operator()(const float& val) const noexcept
   { 
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(float));
+    return val == 0.0f ? 0 : hash_bytes(&val, sizeof(float));
   }
 };
 
 template <>
 struct hash<double>
 {
-  size_t operator()(const double& val)
+  size_t operator()(const double& val) const noexcept
   {
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(double));
+    return val == 0.0f ? 0 : hash_bytes(&val, sizeof(double));
   }
 };
 
 template <>
 struct hash<long double>
 {
-  size_t operator()(const long double& val)
+  size_t operator()(const long double& val) const noexcept
   {
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(long double));
+    return val == 0.0f ? 0 : hash_bytes(&val, sizeof(long double));
   }
 };
 
@@ -4,35 +4,39 @@
 // 这个头文件包含了一个模板类 hashtable
 // hashtable : 哈希表，使用开链法处理冲突
 
+// notes:
+//
+// 渐进式 rehash：调用 incremental_rehash(true) 后，扩容时不再一次性搬移所有节点，
+// 而是分配新的桶数组后与旧的桶数组并存，之后每次插入搬移 HT_REHASH_STEP 个旧桶，全部搬完后释放旧桶数组
+//   * 迁移期间桶的编号先是新桶，再是尚未搬移的旧桶，bucket_count() 返回两者之和
+//   * 键的哈希值在旧桶数组中的位置还没有搬移时，它留在旧桶中，插入也插入到旧桶中，
+//     因此一个键的所有节点总在同一个桶里，查找与遍历都只需要看一个位置
+//   * 只有插入会搬移旧桶，删除与查找不会，删除不使其它迭代器失效
+//   * rehash_step(n) 可以在空闲时主动搬移，rehash() 与 reserve() 会先完成迁移
+//
+// 桶分布：stats() 遍历所有桶，给出链长直方图、空桶个数、最长链、内存占用，以及查找时期望与实际的比较次数，
+// 两者相差很大说明哈希函数不适合这些键（例如 hash<int> 是恒等函数，键有规律时可能聚集在少数桶中）；
+// 定义 HT_CHAIN_WARN_LENGTH 为正数时，插入不重复的键后所在的链超过这个长度会调用 ht_chain_warning 的告警函数
+//
+// 节点保存哈希值：键不是算术、枚举或指针类型时，节点多保存一个哈希值，rehash 不再调用哈希函数，
+// 查找时哈希值不同的节点不调用 KeyEqual，见 ht_cache_hash
+
 #include <initializer_list>
+#include <cstdint>
+#include <cstdio>
 
 #include "algo.h"
 #include "functional.h"
 #include "memory.h"
+#include "node_handle.h"
 #include "vector.h"
 #include "util.h"
 #include "exceptdef.h"
+#include "instrument.h"
 
 namespace mystl
 {
 
-// hashtable 的节点定义
-template <class T>
-struct hashtable_node
-{
-  hashtable_node* next;   // 指向下一个节点
-  T               value;  // 储存实值
-
-  hashtable_node() = default;
-  hashtable_node(const T& n) :next(nullptr), value(n) {}
-
-  hashtable_node(const hashtable_node& node) :next(node.next), value(node.value) {}
-  hashtable_node(hashtable_node&& node) :next(node.next), value(mystl::move(node.value))
-  {
-    node.next = nullptr;
-  }
-};
-
 // value traits
 template <class T, bool>
 struct ht_value_traits_imp
@@ -98,6 +102,48 @@ struct ht_value_traits
   }
 };
 
+// 节点是否保存键的哈希值
+// 保存后 rehash 与迭代器跨桶时直接取出哈希值，不再调用哈希函数；查找时先比较哈希值，不同时不调用 KeyEqual。
+// 缺省为键不是算术、枚举或指针类型时保存，这些键的哈希函数几乎没有开销，多出的一个字段得不偿失；
+// 可以为自己的键类型特化 ht_cache_hash 改变选择
+template <class Key>
+struct ht_cache_hash
+  :public m_bool_constant<!(std::is_arithmetic<Key>::value ||
+                            std::is_enum<Key>::value ||
+                            std::is_pointer<Key>::value)>
+{
+};
+
+template <class T, bool = ht_cache_hash<typename ht_value_traits<T>::key_type>::value>
+struct ht_node_hash
+{
+};
+
+template <class T>
+struct ht_node_hash<T, true>
+{
+  size_t hash_code;  // 键的哈希值
+};
+
+// hashtable 的节点定义
+template <class T>
+struct hashtable_node :public ht_node_hash<T>
+{
+  hashtable_node* next;   // 指向下一个节点
+  T               value;  // 储存实值
+
+  hashtable_node() = default;
+  hashtable_node(const T& n) :next(nullptr), value(n) {}
+
+  hashtable_node(const hashtable_node& node)
+    :ht_node_hash<T>(node), next(node.next), value(node.value) {}
+  hashtable_node(hashtable_node&& node)
+    :ht_node_hash<T>(node), next(node.next), value(mystl::move(node.value))
+  {
+    node.next = nullptr;
+  }
+};
+
 
 // forward declaration
 // hashtable：哈希表的主要模板类
@@ -106,13 +152,13 @@ struct ht_value_traits
 // ht_local_iterator：用于访问单个桶内元素的局部迭代器
 // ht_const_local_iterator：用于访问单个桶内元素的常量局部迭代器
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Policy, class Alloc>
 class hashtable;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Policy, class Alloc>
 struct ht_iterator;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Policy, class Alloc>
 struct ht_const_iterator;
 
 template <class T>
@@ -123,20 +169,20 @@ struct ht_const_local_iterator;
 
 // ht_iterator
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 struct ht_iterator_base :public mystl::iterator<mystl::forward_iterator_tag, T>
 {
-  typedef mystl::hashtable<T, Hash, KeyEqual>         hashtable;
-  typedef ht_iterator_base<T, Hash, KeyEqual>         base;
-  typedef mystl::ht_iterator<T, Hash, KeyEqual>       iterator;
-  typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-  typedef hashtable_node<T>*                          node_ptr;
-  typedef hashtable*                                  contain_ptr;
-  typedef const node_ptr                              const_node_ptr;
-  typedef const contain_ptr                           const_contain_ptr;
-
-  typedef size_t                                      size_type;
-  typedef ptrdiff_t                                   difference_type;
+  typedef mystl::hashtable<T, Hash, KeyEqual, Policy, Alloc>         hashtable;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Policy, Alloc>         base;
+  typedef mystl::ht_iterator<T, Hash, KeyEqual, Policy, Alloc>       iterator;
+  typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Policy, Alloc> const_iterator;
+  typedef hashtable_node<T>*                                  node_ptr;
+  typedef hashtable*                                          contain_ptr;
+  typedef const node_ptr                                      const_node_ptr;
+  typedef const contain_ptr                                   const_contain_ptr;
+
+  typedef size_t                                              size_type;
+  typedef ptrdiff_t                                           difference_type;
 
   node_ptr    node;  // 迭代器当前所指节点
   contain_ptr ht;    // 保持与容器的连结
@@ -147,10 +193,10 @@ struct ht_iterator_base :public mystl::iterator<mystl::forward_iterator_tag, T>
   bool operator!=(const base& rhs) const { return node != rhs.node; }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual, Policy, Alloc>
 {
-  typedef ht_iterator_base<T, Hash, KeyEqual> base;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Policy, Alloc> base;
   typedef typename base::hashtable            hashtable;
   typedef typename base::iterator             iterator;
   typedef typename base::const_iterator       const_iterator;
@@ -211,9 +257,9 @@ struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
     node = node->next;
     if (node == nullptr)
     { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-      auto index = ht->hash(value_traits::get_key(old->value));
-      while (!node && ++index < ht->bucket_size_)
-        node = ht->buckets_[index];
+      auto index = ht->M_index(ht->M_code(old));
+      while (!node && ++index < ht->M_nbuckets())
+        node = ht->M_bucket(index);
     }
     return *this;
   }
@@ -225,10 +271,10 @@ struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
   }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual, Policy, Alloc>
 {
-  typedef ht_iterator_base<T, Hash, KeyEqual> base;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Policy, Alloc> base;
   typedef typename base::hashtable            hashtable;
   typedef typename base::iterator             iterator;
   typedef typename base::const_iterator       const_iterator;
@@ -289,10 +335,10 @@ struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual>
     node = node->next;
     if (node == nullptr)
     { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-      auto index = ht->hash(value_traits::get_key(old->value));
-      while (!node && ++index < ht->bucket_size_)
+      auto index = ht->M_index(ht->M_code(old));
+      while (!node && ++index < ht->M_nbuckets())
       {
-        node = ht->buckets_[index];
+        node = ht->M_bucket(index);
       }
     }
     return *this;
@@ -472,48 +518,210 @@ inline size_t ht_next_prime(size_t n)
   return pos == last ? *(last - 1) : *pos;
 }
 
+// 对哈希值做一次雪崩混合（murmur3 的 finalizer），使输入的每一位都能影响输出的高位与低位
+// mystl::hash 对整数直接返回原值，按位截取桶号前必须先混合，否则连续或等间隔的键会聚集
+inline size_t ht_mix(size_t h)
+{
+#ifdef SYSTEM_64
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+#else
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+#endif
+  return h;
+}
+
+// 桶策略：决定桶的数量如何增长，以及哈希值如何映射到桶上
+// ht_prime_policy    : 桶数取质数表中的值，用取模映射，对哈希函数的质量要求最低，但每次映射都要做一次除法
+// ht_power2_policy   : 桶数取 2 的幂，先用 ht_mix 混合，再用位与取低位
+// ht_fastrange_policy: 桶数沿用质数表，先用 ht_mix 混合，再用乘法取高位把哈希值映射到 [0, n)，不做除法
+
+struct ht_prime_policy
+{
+  static size_t next_size(size_t n)         { return ht_next_prime(n); }
+  static size_t index(size_t h, size_t n)   { return h % n; }
+  static size_t max_size()                  { return ht_prime_list[PRIME_NUM - 1]; }
+};
+
+struct ht_power2_policy
+{
+  // 最少 16 个桶
+  static size_t next_size(size_t n)
+  {
+    size_t size = 16;
+    while (size < n && size < max_size())
+      size <<= 1;
+    return size;
+  }
+  static size_t index(size_t h, size_t n)   { return ht_mix(h) & (n - 1); }
+  static size_t max_size()                  { return static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1); }
+};
+
+struct ht_fastrange_policy
+{
+  static size_t next_size(size_t n)         { return ht_next_prime(n); }
+  static size_t index(size_t h, size_t n)   { return mulhi(ht_mix(h), n); }
+  static size_t max_size()                  { return ht_prime_list[PRIME_NUM - 1]; }
+
+  // 返回 a * b 的高半部分
+  static size_t mulhi(size_t a, size_t b)
+  {
+#if defined(SYSTEM_64) && defined(__SIZEOF_INT128__)
+    return static_cast<size_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(SYSTEM_64)
+    const uint64_t a_lo = a & 0xffffffffull, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xffffffffull, b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+    return static_cast<size_t>(a_hi * b_hi + (hi_lo >> 32) + (cross >> 32));
+#else
+    return static_cast<size_t>((static_cast<uint64_t>(a) * b) >> 32);
+#endif
+  }
+};
+
+// 渐进式 rehash 时，每次插入搬移的旧桶个数
+#ifndef HT_REHASH_STEP
+#define HT_REHASH_STEP 4
+#endif
+
+// stats() 中链长直方图的项数
+#ifndef HT_STATS_HISTOGRAM
+#define HT_STATS_HISTOGRAM 8
+#endif
+
+// 链长告警的阈值，0 表示不检查
+#ifndef HT_CHAIN_WARN_LENGTH
+#define HT_CHAIN_WARN_LENGTH 0
+#endif
+
+// 哈希表的桶分布与内存占用，由 hashtable::stats() 返回
+struct ht_stats
+{
+  size_t size;                           // 元素个数
+  size_t bucket_count;                   // 桶的个数，迁移期间包括旧桶
+  size_t empty_buckets;                  // 空桶的个数
+  size_t max_chain;                      // 最长链的长度
+  size_t histogram[HT_STATS_HISTOGRAM];  // histogram[i] 为长度为 i 的链的个数，最后一项包括所有更长的链
+  size_t node_bytes;                     // 节点占用的字节数，不含分配器的额外开销
+  size_t bucket_bytes;                   // 桶数组占用的字节数
+  double expected_probes;                // 哈希值均匀分布时，成功查找一个元素平均比较的次数
+  double actual_probes;                  // 按实际的分布，成功查找一个元素平均比较的次数
+
+  size_t total_bytes() const noexcept
+  { return node_bytes + bucket_bytes; }
+
+  // 实际与期望比较次数之比，明显大于 1 时说明键在桶中聚集
+  double probe_ratio() const noexcept
+  { return expected_probes > 0 ? actual_probes / expected_probes : 0.0; }
+};
+
+// 链长告警
+// 告警函数的参数依次为链长、桶的编号、元素个数、桶的个数，缺省的告警函数输出到 stderr
+// set_handler 不是线程安全的，应在使用哈希表之前设置
+typedef void (*ht_chain_warning_handler)(size_t chain, size_t bucket, size_t size,
+                                         size_t bucket_count);
+
+class ht_chain_warning
+{
+private:
+  static ht_chain_warning_handler& M_handler() noexcept
+  {
+    static ht_chain_warning_handler handler = &default_handler;
+    return handler;
+  }
+
+public:
+  static void default_handler(size_t chain, size_t bucket, size_t size, size_t bucket_count)
+  {
+    std::fprintf(stderr, "mystl::hashtable: chain of length %lu in bucket %lu "
+                 "(size %lu, bucket_count %lu), the hash function may be degenerate\n",
+                 static_cast<unsigned long>(chain), static_cast<unsigned long>(bucket),
+                 static_cast<unsigned long>(size), static_cast<unsigned long>(bucket_count));
+  }
+
+  // 设置告警函数，返回原来的告警函数，参数为 nullptr 时恢复缺省
+  static ht_chain_warning_handler set_handler(ht_chain_warning_handler h) noexcept
+  {
+    auto old = M_handler();
+    M_handler() = h != nullptr ? h : &default_handler;
+    return old;
+  }
+
+  static void report(size_t chain, size_t bucket, size_t size, size_t bucket_count)
+  {
+    M_handler()(chain, bucket, size, bucket_count);
+  }
+};
+
 // 模板类 hashtable
 // 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
-template <class T, class Hash, class KeyEqual>
+// 参数四代表桶策略，缺省使用 ht_prime_policy
+template <class T, class Hash, class KeyEqual, class Policy = ht_prime_policy,
+          class Alloc = mystl::allocator<T>>
 class hashtable
+  :private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<hashtable_node<T>>>
 {  
 
-  friend struct mystl::ht_iterator<T, Hash, KeyEqual>;
-  friend struct mystl::ht_const_iterator<T, Hash, KeyEqual>;
+  friend struct mystl::ht_iterator<T, Hash, KeyEqual, Policy, Alloc>;
+  friend struct mystl::ht_const_iterator<T, Hash, KeyEqual, Policy, Alloc>;
+
+  template <class, class, class, class, class>
+  friend class hashtable;
 
 public:
   // hashtable 的型别定义
-  typedef ht_value_traits<T>                          value_traits;
-  typedef typename value_traits::key_type             key_type;
-  typedef typename value_traits::mapped_type          mapped_type;
-  typedef typename value_traits::value_type           value_type;
-  typedef Hash                                        hasher;
-  typedef KeyEqual                                    key_equal;
-
-  typedef hashtable_node<T>                           node_type;
-  typedef node_type*                                  node_ptr;
-  typedef mystl::vector<node_ptr>                     bucket_type;
-
-  typedef mystl::allocator<T>                         allocator_type;
-  typedef mystl::allocator<T>                         data_allocator;
-  typedef mystl::allocator<node_type>                 node_allocator;
-
-  typedef typename allocator_type::pointer            pointer;
-  typedef typename allocator_type::const_pointer      const_pointer;
-  typedef typename allocator_type::reference          reference;
-  typedef typename allocator_type::const_reference    const_reference;
-  typedef typename allocator_type::size_type          size_type;
-  typedef typename allocator_type::difference_type    difference_type;
-
-  typedef mystl::ht_iterator<T, Hash, KeyEqual>       iterator;
-  typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-  typedef mystl::ht_local_iterator<T>                 local_iterator;
-  typedef mystl::ht_const_local_iterator<T>           const_local_iterator;
-
-  allocator_type get_allocator() const { return allocator_type(); }
+  typedef ht_value_traits<T>                                  value_traits;
+  typedef typename value_traits::key_type                     key_type;
+  typedef typename value_traits::mapped_type                  mapped_type;
+  typedef typename value_traits::value_type                   value_type;
+  typedef Hash                                                hasher;
+  typedef KeyEqual                                            key_equal;
+
+  typedef hashtable_node<T>                                   node_type;
+  typedef node_type*                                          node_ptr;
+  typedef node_ptr*                                           bucket_type;
+
+  typedef Alloc                                               allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<node_type>
+                                                              node_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<node_ptr>
+                                                              bucket_allocator;
+  typedef mystl::allocator_traits<node_allocator>             node_alloc_traits;
+  typedef mystl::allocator_traits<bucket_allocator>           bucket_alloc_traits;
+
+  typedef value_type*                                         pointer;
+  typedef const value_type*                                   const_pointer;
+  typedef value_type&                                         reference;
+  typedef const value_type&                                   const_reference;
+  typedef size_t                                              size_type;
+  typedef ptrdiff_t                                           difference_type;
+
+  typedef mystl::ht_iterator<T, Hash, KeyEqual, Policy, Alloc>       iterator;
+  typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Policy, Alloc> const_iterator;
+  typedef mystl::ht_local_iterator<T>                         local_iterator;
+  typedef mystl::ht_const_local_iterator<T>                   const_local_iterator;
+
+  typedef mystl::node_handle<T, node_type, Alloc>             node_handle_type;
+  typedef mystl::node_insert_return<iterator, node_handle_type> insert_return_type;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
 
 private:
-  // 用以下六个参数来表现 hashtable
+  typedef mystl::alloc_holder<node_allocator>                 alloc_base;
+  using alloc_base::M_alloc;
+
+  // 用以下六个参数来表现 hashtable，桶数组与节点都由同一个分配器重新绑定后分配
   bucket_type buckets_;
   size_type   bucket_size_;
   size_type   size_;
@@ -521,38 +729,110 @@ private:
   hasher      hash_;  // 用于计算键的哈希值
   key_equal   equal_;  // 键比较函数对象
 
+  // 渐进式 rehash 使用的旧桶数组，不在迁移中时为空
+  bucket_type old_buckets_;
+  size_type   old_bucket_size_;
+  size_type   migrate_pos_;  // [0, migrate_pos_) 的旧桶已经搬移
+  bool        incremental_;
+
 private:
-  bool is_equal(const key_type& key1, const key_type& key2)
+  template <class K>
+  bool is_equal(const key_type& key1, const K& key2) const
   {
     return equal_(key1, key2);
   }
 
-  bool is_equal(const key_type& key1, const key_type& key2) const
-  {
-    return equal_(key1, key2);
-  }
+  // 以下函数按节点是否保存哈希值分别处理，见 ht_cache_hash
+  typedef m_bool_constant<ht_cache_hash<key_type>::value>     cache_hash;
+
+  // 节点中键的哈希值
+  size_type M_code(node_ptr p) const
+  { return M_code(p, cache_hash()); }
+  size_type M_code(node_ptr p, m_true_type) const noexcept
+  { return p->hash_code; }
+  size_type M_code(node_ptr p, m_false_type) const
+  { return hash_(value_traits::get_key(p->value)); }
+
+  // 记下新节点的哈希值，或者从 src 复制
+  void M_store_code(node_ptr p, size_type code) noexcept
+  { M_store_code(p, code, cache_hash()); }
+  void M_store_code(node_ptr p, size_type code, m_true_type) noexcept
+  { p->hash_code = code; }
+  void M_store_code(node_ptr, size_type, m_false_type) noexcept {}
+
+  void M_copy_code(node_ptr p, node_ptr src) noexcept
+  { M_copy_code(p, src, cache_hash()); }
+  void M_copy_code(node_ptr p, node_ptr src, m_true_type) noexcept
+  { p->hash_code = src->hash_code; }
+  void M_copy_code(node_ptr, node_ptr, m_false_type) noexcept {}
+
+  // 节点 p 的键是否等于哈希值为 code 的 key，保存了哈希值时先比较哈希值，不同时不调用 equal_
+  template <class K>
+  bool M_match(node_ptr p, size_type code, const K& key) const
+  { return M_match(p, code, key, cache_hash()); }
+  template <class K>
+  bool M_match(node_ptr p, size_type code, const K& key, m_true_type) const
+  { return p->hash_code == code && is_equal(value_traits::get_key(p->value), key); }
+  template <class K>
+  bool M_match(node_ptr p, size_type, const K& key, m_false_type) const
+  { return is_equal(value_traits::get_key(p->value), key); }
+
+  // 两个节点的键是否相等
+  bool M_match_node(node_ptr p, node_ptr q) const
+  { return M_match_node(p, q, cache_hash()); }
+  bool M_match_node(node_ptr p, node_ptr q, m_true_type) const
+  {
+    return p->hash_code == q->hash_code &&
+      is_equal(value_traits::get_key(p->value), value_traits::get_key(q->value));
+  }
+  bool M_match_node(node_ptr p, node_ptr q, m_false_type) const
+  { return is_equal(value_traits::get_key(p->value), value_traits::get_key(q->value)); }
 
   const_iterator M_cit(node_ptr node) const noexcept
   {
     return const_iterator(node, const_cast<hashtable*>(this));
   }
 
+  // 桶的总数，迁移期间包括尚未释放的旧桶，它们的编号排在新桶之后
+  size_type M_nbuckets() const noexcept
+  {
+    return bucket_size_ + old_bucket_size_;
+  }
+
+  // 第 n 个桶的链表头
+  node_ptr& M_bucket(size_type n) const noexcept
+  {
+    return n < bucket_size_ ? buckets_[n] : old_buckets_[n - bucket_size_];
+  }
+
+  // 哈希值为 code 的键所在的桶，旧桶还没有搬移时在旧桶中
+  size_type M_index(size_type code) const
+  {
+    if (old_buckets_ != nullptr)
+    {
+      const auto n = Policy::index(code, old_bucket_size_);
+      if (n >= migrate_pos_)
+        return bucket_size_ + n;
+    }
+    return Policy::index(code, bucket_size_);
+  }
+
   iterator M_begin() noexcept
   {
-    for (size_type n = 0; n < bucket_size_; ++n)
+    for (size_type n = 0; n < M_nbuckets(); ++n)
     {
-      if (buckets_[n])  // 找到第一个有节点的位置就返回
-        return iterator(buckets_[n], this);
+      if (M_bucket(n))  // 找到第一个有节点的位置就返回
+        return iterator(M_bucket(n), this);
     }
     return iterator(nullptr, this);
   }
 
   const_iterator M_begin() const noexcept
   {
-    for (size_type n = 0; n < bucket_size_; ++n)
+    for (size_type n = 0; n < M_nbuckets(); ++n)
     {
-      if (buckets_[n])  // 找到第一个有节点的位置就返回
-        return M_cit(buckets_[n]);
+      if (M_bucket(n))  // 找到第一个有节点的位置就返回
+        return M_cit(M_bucket(n));
     }
     return M_cit(nullptr);
   }
@@ -561,8 +841,11 @@ public:
   // 构造、复制、移动、析构函数
   explicit hashtable(size_type bucket_count,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc)), buckets_(nullptr), bucket_size_(0),
+    size_(0), mlf_(1.0f), hash_(hash), equal_(equal),
+    old_buckets_(nullptr), old_bucket_size_(0), migrate_pos_(0), incremental_(false)
   {
     init(bucket_count);
   }
@@ -572,34 +855,64 @@ public:
     hashtable(Iter first, Iter last,
               size_type bucket_count,
               const Hash& hash = Hash(),
-              const KeyEqual& equal = KeyEqual())
-    :size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
+              const KeyEqual& equal = KeyEqual(),
+              const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc)), buckets_(nullptr), bucket_size_(0),
+    size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal),
+    old_buckets_(nullptr), old_bucket_size_(0), migrate_pos_(0), incremental_(false)
   {
     init(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))));
   }
 
   hashtable(const hashtable& rhs)
-    :hash_(rhs.hash_), equal_(rhs.equal_)
+    :alloc_base(node_alloc_traits::select_on_container_copy_construction(rhs.M_alloc())),
+    buckets_(nullptr), bucket_size_(0), size_(0), mlf_(rhs.mlf_),
+    hash_(rhs.hash_), equal_(rhs.equal_),
+    old_buckets_(nullptr), old_bucket_size_(0), migrate_pos_(0), incremental_(rhs.incremental_)
   {
-    copy_init(rhs);
+    copy_init(rhs, m_false_type());
   }
+
+  hashtable(const hashtable& rhs, const allocator_type& alloc)
+    :alloc_base(node_allocator(alloc)),
+    buckets_(nullptr), bucket_size_(0), size_(0), mlf_(rhs.mlf_),
+    hash_(rhs.hash_), equal_(rhs.equal_),
+    old_buckets_(nullptr), old_bucket_size_(0), migrate_pos_(0), incremental_(rhs.incremental_)
+  {
+    copy_init(rhs, m_false_type());
+  }
+
   hashtable(hashtable&& rhs) noexcept
-    : bucket_size_(rhs.bucket_size_), 
+    :alloc_base(mystl::move(rhs.M_alloc())),
+    buckets_(rhs.buckets_),
+    bucket_size_(rhs.bucket_size_), 
     size_(rhs.size_),
     mlf_(rhs.mlf_),
     hash_(rhs.hash_),
-    equal_(rhs.equal_)
+    equal_(rhs.equal_),
+    old_buckets_(rhs.old_buckets_),
+    old_bucket_size_(rhs.old_bucket_size_),
+    migrate_pos_(rhs.migrate_pos_),
+    incremental_(rhs.incremental_)
   {
-    buckets_ = mystl::move(rhs.buckets_);
+    rhs.buckets_ = nullptr;
     rhs.bucket_size_ = 0;
     rhs.size_ = 0;
     rhs.mlf_ = 0.0f;
+    rhs.old_buckets_ = nullptr;
+    rhs.old_bucket_size_ = 0;
+    rhs.migrate_pos_ = 0;
   }
 
+  // 分配器不相等时逐个移动元素
+  hashtable(hashtable&& rhs, const allocator_type& alloc);
+
   hashtable& operator=(const hashtable& rhs);
-  hashtable& operator=(hashtable&& rhs) noexcept;
+  hashtable& operator=(hashtable&& rhs)
+    noexcept(node_alloc_traits::propagate_on_container_move_assignment::value ||
+             node_alloc_traits::is_always_equal::value);
 
-  ~hashtable() { clear(); }
+  ~hashtable() { destroy_all(); }
 
   // 迭代器相关操作
   iterator       begin()        noexcept
@@ -619,7 +932,7 @@ public:
   // 容量相关操作
   bool      empty()    const noexcept { return size_ == 0; }
   size_type size()     const noexcept { return size_; }
-  size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+  size_type max_size() const noexcept { return node_alloc_traits::max_size(M_alloc()); }
 
   // 修改容器相关操作
 
@@ -628,8 +941,13 @@ public:
   template <class ...Args>
   iterator emplace_multi(Args&& ...args);
 
+  // 参数可以直接取得键值时先查找，键值重复时不创建节点
   template <class ...Args>
-  pair<iterator, bool> emplace_unique(Args&& ...args);
+  pair<iterator, bool> emplace_unique(Args&& ...args)
+  {
+    return emplace_unique_aux(emplace_key_kind<key_type, value_type, Args...>(),
+                              mystl::forward<Args>(args)...);
+  }
 
   // [note]: hint 对于 hash_table 其实没有意义，因为即使提供了 hint，也要做一次 hash，
   // 来确保 hash_table 的性质，所以选择忽略它
@@ -656,12 +974,17 @@ public:
 
 
   pair<iterator, bool> insert_unique(const value_type& value)
+  { return emplace_unique_key(value_traits::get_key(value), value); }
+  pair<iterator, bool> insert_unique(value_type&& value)
+  { return emplace_unique_key(value_traits::get_key(value), mystl::move(value)); }
+
+  // try_emplace：键值已存在时不创建节点，也不使用 args
+  template <class K, class ...Args>
+  pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args)
   {
-    rehash_if_need(1);
-    return insert_unique_noresize(value);
+    return emplace_unique_key(key, mystl::emplace_second_t(),
+                              mystl::forward<K>(key), mystl::forward<Args>(args)...);
   }
-  pair<iterator, bool> insert_unique(value_type&& value)
-  { return emplace_unique(mystl::move(value)); }
 
   // [note]: 同 emplace_hint
   iterator insert_multi_use_hint(const_iterator /*hint*/, const value_type& value)
@@ -672,7 +995,7 @@ public:
   iterator insert_unique_use_hint(const_iterator /*hint*/, const value_type& value)
   { return insert_unique(value).first; }
   iterator insert_unique_use_hint(const_iterator /*hint*/, value_type&& value)
-  { return emplace_unique(mystl::move(value)); }
+  { return insert_unique(mystl::move(value)).first; }
 
   template <class InputIter>
   void insert_multi(InputIter first, InputIter last)
@@ -694,35 +1017,99 @@ public:
 
   void      swap(hashtable& rhs) noexcept;
 
-  // 查找相关操作
+  // node handle
+
+  // 把节点从桶中摘下，不销毁节点
+  node_handle_type   extract(const_iterator position);
+  node_handle_type   extract(const key_type& key);
 
-  size_type                            count(const key_type& key) const;
+  // 重新链接句柄中的节点，只可能分配新的桶，键值重复时节点留在返回值的 node 中
+  insert_return_type insert_node_unique(node_handle_type&& nh);
+  iterator           insert_node_multi(node_handle_type&& nh);
 
-  iterator                             find(const key_type& key);
-  const_iterator                       find(const key_type& key) const;
+  iterator insert_node_unique(const_iterator /*hint*/, node_handle_type&& nh)
+  { return insert_node_unique(mystl::move(nh)).position; }
+  iterator insert_node_multi(const_iterator /*hint*/, node_handle_type&& nh)
+  { return insert_node_multi(mystl::move(nh)); }
 
-  pair<iterator, iterator>             equal_range_multi(const key_type& key);
-  pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const;
+  // 把 rhs 的节点逐个移到本表中，键值不允许重复时，重复的节点留在 rhs 中
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void merge_unique(hashtable<T, Hash2, KeyEqual2, Policy2, Alloc>& rhs);
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void merge_multi(hashtable<T, Hash2, KeyEqual2, Policy2, Alloc>& rhs);
 
-  pair<iterator, iterator>             equal_range_unique(const key_type& key);
-  pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
+  // 查找相关操作
+
+  size_type                            count(const key_type& key) const
+  { return M_count(key); }
+
+  iterator                             find(const key_type& key)
+  { return iterator(M_find(key), this); }
+  const_iterator                       find(const key_type& key) const
+  { return M_cit(M_find(key)); }
+
+  pair<iterator, iterator>             equal_range_multi(const key_type& key)
+  { return M_range(M_equal_range_multi(key)); }
+  pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+  { return M_crange(M_equal_range_multi(key)); }
+
+  pair<iterator, iterator>             equal_range_unique(const key_type& key)
+  { return M_range(M_equal_range_unique(key)); }
+  pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+  { return M_crange(M_equal_range_unique(key)); }
+
+  // 异构查找：仅当 Hash 与 KeyEqual 都声明了 is_transparent 时启用，
+  // 可以直接用与键值可哈希、可比较的类型查找，不必构造临时的 key_type
+  // 注意 Hash 对等价的两个参数必须给出相同的哈希值
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  size_type                            count(const K& key) const
+  { return M_count(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  iterator                             find(const K& key)
+  { return iterator(M_find(key), this); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  const_iterator                       find(const K& key) const
+  { return M_cit(M_find(key)); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator>             equal_range_multi(const K& key)
+  { return M_range(M_equal_range_multi(key)); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+  { return M_crange(M_equal_range_multi(key)); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator>             equal_range_unique(const K& key)
+  { return M_range(M_equal_range_unique(key)); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+  { return M_crange(M_equal_range_unique(key)); }
 
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
   { 
     MYSTL_DEBUG(n < size_);
-    return buckets_[n];
+    return M_bucket(n);
   }
   const_local_iterator begin(size_type n)  const noexcept
   { 
     MYSTL_DEBUG(n < size_);
-    return buckets_[n];
+    return M_bucket(n);
   }
   const_local_iterator cbegin(size_type n) const noexcept
   { 
     MYSTL_DEBUG(n < size_);
-    return buckets_[n];
+    return M_bucket(n);
   }
 
   local_iterator       end(size_type n)          noexcept
@@ -742,9 +1129,9 @@ public:
   }
 
   size_type bucket_count()                 const noexcept
-  { return bucket_size_; }
+  { return M_nbuckets(); }
   size_type max_bucket_count()             const noexcept
-  { return ht_prime_list[PRIME_NUM - 1]; }
+  { return Policy::max_size(); }
 
   size_type bucket_size(size_type n)       const noexcept;
   size_type bucket(const key_type& key)    const
@@ -771,26 +1158,72 @@ public:
   void reserve(size_type count)
   { rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
 
+  // 渐进式 rehash，关闭时先完成正在进行的迁移
+  bool incremental_rehash() const noexcept
+  { return incremental_; }
+  void incremental_rehash(bool on)
+  {
+    if (!on)
+      migrate_buckets(old_bucket_size_);
+    incremental_ = on;
+  }
+
+  // 是否有尚未搬移完的旧桶
+  bool rehashing() const noexcept
+  { return old_buckets_ != nullptr; }
+
+  // 搬移至多 n 个旧桶，返回迁移是否仍未完成
+  bool rehash_step(size_type n)
+  {
+    migrate_buckets(n);
+    return rehashing();
+  }
+
   hasher    hash_fcn() const { return hash_; }
   key_equal key_eq()   const { return equal_; }
 
+  // 桶分布与内存占用，O(bucket_count())
+  ht_stats  stats() const;
+
 private:
   // hashtable 成员函数
 
   // init
   void      init(size_type n);
-  void      copy_init(const hashtable& ht);
+  template <class Ht, class Move>
+  void      copy_init(Ht& ht, Move);
+  void      destroy_all();
+  void      swap_data(hashtable& rhs) noexcept;
+
+  // move
+  void      move_assign(hashtable& rhs, m_true_type) noexcept;
+  void      move_assign(hashtable& rhs, m_false_type);
+
+  // bucket array
+  bucket_type create_buckets(size_type n);
+  void        destroy_buckets(bucket_type b, size_type n);
 
   // node
   template  <class ...Args>
   node_ptr  create_node(Args&& ...args);
+  node_ptr  clone_node(const value_type& value, m_false_type)
+  { return create_node(value); }
+  node_ptr  clone_node(value_type& value, m_true_type)
+  { return create_node(mystl::move(value)); }
   void      destroy_node(node_ptr n);
 
   // hash
   size_type next_size(size_type n) const;
-  size_type hash(const key_type& key, size_type n) const;
-  size_type hash(const key_type& key) const;
-  void      rehash_if_need(size_type n);
+  template <class K>
+  size_type hash(const K& key, size_type n) const;
+  template <class K>
+  size_type hash(const K& key) const;
+  bool      rehash_if_need(size_type n);
+
+  // incremental rehash
+  void      start_migration(size_type count);
+  void      migrate_buckets(size_type n) noexcept;
+  void      link_rehashed(bucket_type b, size_type n, node_ptr np) noexcept;
 
   // insert
   template <class InputIter>
@@ -802,12 +1235,54 @@ private:
   template <class ForwardIter>
   void copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
 
+  // 先以 key 查找，确定键值不存在后才用 args 创建节点
+  template <class ...Args>
+  pair<iterator, bool> emplace_unique_key(const key_type& key, Args&& ...args);
+
+  template <class ...Args>
+  pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 0>, Args&& ...args);
+  template <class Arg>
+  pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 1>, Arg&& value)
+  { return emplace_unique_key(value_traits::get_key(value), mystl::forward<Arg>(value)); }
+  template <class Key, class Arg>
+  pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 2>, Key&& key, Arg&& arg)
+  { return emplace_unique_key(key, mystl::forward<Key>(key), mystl::forward<Arg>(arg)); }
+
   // insert node
   pair<iterator, bool> insert_node_unique(node_ptr np);
   iterator             insert_node_multi(node_ptr np);
 
+  // 把节点从所在的桶中摘下，节点不在表中时返回 nullptr
+  node_ptr  unlink_node(node_ptr p);
+
+  // 插入不重复的键后检查第 n 个桶的链长，超过 HT_CHAIN_WARN_LENGTH 时告警
+  void      check_chain(size_type n) const
+  {
+    if (HT_CHAIN_WARN_LENGTH > 0)
+    {
+      const auto chain = bucket_size(n);
+      if (chain > static_cast<size_type>(HT_CHAIN_WARN_LENGTH))
+        ht_chain_warning::report(chain, n, size_, M_nbuckets());
+    }
+  }
+
   // bucket operator
   void replace_bucket(size_type bucket_count);
+
+  // find / count / equal_range 的实现，以节点指针表示位置，nullptr 代表 end()
+  template <class K>
+  node_ptr  M_find(const K& key) const;
+  template <class K>
+  size_type M_count(const K& key) const;
+  template <class K>
+  pair<node_ptr, node_ptr> M_equal_range_multi(const K& key) const;
+  template <class K>
+  pair<node_ptr, node_ptr> M_equal_range_unique(const K& key) const;
+
+  pair<iterator, iterator> M_range(const pair<node_ptr, node_ptr>& p)
+  { return mystl::make_pair(iterator(p.first, this), iterator(p.second, this)); }
+  pair<const_iterator, const_iterator> M_crange(const pair<node_ptr, node_ptr>& p) const
+  { return mystl::make_pair(M_cit(p.first), M_cit(p.second)); }
   void erase_bucket(size_type n, node_ptr first, node_ptr last);
   void erase_bucket(size_type n, node_ptr last);
 
@@ -819,43 +1294,75 @@ private:
 /*****************************************************************************************/
 
 // 复制赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>&
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 operator=(const hashtable& rhs)
 {
   if (this != &rhs)
   {
-    hashtable tmp(rhs);
-    swap(tmp);
+    const bool pocca = node_alloc_traits::propagate_on_container_copy_assignment::value &&
+                       !node_alloc_traits::equal(M_alloc(), rhs.M_alloc());
+    hashtable tmp(rhs, pocca ? allocator_type(rhs.M_alloc()) : allocator_type(M_alloc()));
+    if (pocca)
+    { // 旧的节点必须由旧的分配器释放
+      destroy_all();
+      mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(), m_true_type());
+    }
+    swap_data(tmp);
   }
   return *this;
 }
 
 // 移动赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
-operator=(hashtable&& rhs) noexcept
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>&
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+operator=(hashtable&& rhs)
+  noexcept(node_alloc_traits::propagate_on_container_move_assignment::value ||
+           node_alloc_traits::is_always_equal::value)
 {
-  hashtable tmp(mystl::move(rhs));
-  swap(tmp);
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                node_alloc_traits::propagate_on_container_move_assignment::value ||
+                node_alloc_traits::is_always_equal::value>());
+  }
   return *this;
 }
 
+// 带分配器的移动构造函数
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+hashtable(hashtable&& rhs, const allocator_type& alloc)
+  :alloc_base(node_allocator(alloc)),
+  buckets_(nullptr), bucket_size_(0), size_(0), mlf_(rhs.mlf_),
+  hash_(rhs.hash_), equal_(rhs.equal_),
+  old_buckets_(nullptr), old_bucket_size_(0), migrate_pos_(0), incremental_(rhs.incremental_)
+{
+  if (node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    swap_data(rhs);
+  }
+  else
+  {
+    copy_init(rhs, m_true_type());
+    rhs.clear();
+  }
+}
+
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 emplace_multi(Args&& ...args)
 {
   auto np = create_node(mystl::forward<Args>(args)...);
   try
   {
-    if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-      rehash(size_ + 1);
+    rehash_if_need(1);
   }
   catch (...)
   {
@@ -865,19 +1372,18 @@ emplace_multi(Args&& ...args)
   return insert_node_multi(np);
 }
 
-// 就地构造元素，键值允许重复
+// 就地构造元素，键值不允许重复，参数不能直接取得键值时先创建节点
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class ...Args>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool> 
-hashtable<T, Hash, KeyEqual>::
-emplace_unique(Args&& ...args)
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator, bool> 
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+emplace_unique_aux(std::integral_constant<int, 0>, Args&& ...args)
 {
   auto np = create_node(mystl::forward<Args>(args)...);
   try
   {
-    if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-      rehash(size_ + 1);
+    rehash_if_need(1);
   }
   catch (...)
   {
@@ -887,40 +1393,85 @@ emplace_unique(Args&& ...args)
   return insert_node_unique(np);
 }
 
+// 以 key 查找后再创建节点，键值重复时不分配内存，哈希值只计算一次
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class ...Args>
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+emplace_unique_key(const key_type& key, Args&& ...args)
+{
+  const auto code = hash_(key);
+  auto n = M_index(code);
+  size_type probes = 0;
+  for (node_ptr cur = M_bucket(n); cur; cur = cur->next)
+  {
+    ++probes;
+    if (M_match(cur, code, key))
+    {
+      instrument::probe(probes);
+      return mystl::make_pair(iterator(cur, this), false);
+    }
+  }
+  instrument::probe(probes);
+  if (rehash_if_need(1))
+    n = M_index(code);
+  node_ptr np = create_node(mystl::forward<Args>(args)...);
+  M_store_code(np, code);
+  np->next = M_bucket(n);
+  M_bucket(n) = np;
+  ++size_;
+  check_chain(n);
+  return mystl::make_pair(iterator(np, this), true);
+}
+
 // 在不需要重建表格的情况下插入新节点，键值不允许重复
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 insert_unique_noresize(const value_type& value)
 {
-  const auto n = hash(value_traits::get_key(value));
-  auto first = buckets_[n];
+  const auto code = hash_(value_traits::get_key(value));
+  const auto n = M_index(code);
+  auto first = M_bucket(n);
+  size_type probes = 0;
   for (auto cur = first; cur; cur = cur->next)
   {
-    if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
+    ++probes;
+    if (M_match(cur, code, value_traits::get_key(value)))
+    {
+      instrument::probe(probes);
       return mystl::make_pair(iterator(cur, this), false);
+    }
   }
+  instrument::probe(probes);
   // 让新节点成为链表的第一个节点
   auto tmp = create_node(value);  
+  M_store_code(tmp, code);
   tmp->next = first;
-  buckets_[n] = tmp;
+  M_bucket(n) = tmp;
   ++size_;
+  check_chain(n);
   return mystl::make_pair(iterator(tmp, this), true);
 }
 
 // 在不需要重建表格的情况下插入新节点，键值允许重复
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 insert_multi_noresize(const value_type& value)
 {
-  const auto n = hash(value_traits::get_key(value));
-  auto first = buckets_[n];
+  const auto code = hash_(value_traits::get_key(value));
+  const auto n = M_index(code);
+  auto first = M_bucket(n);
   auto tmp = create_node(value);
+  M_store_code(tmp, code);
+  size_type probes = 0;
   for (auto cur = first; cur; cur = cur->next)
   {
-    if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
+    ++probes;
+    if (M_match(cur, code, value_traits::get_key(value)))
     { // 如果链表中存在相同键值的节点就马上插入，然后返回
+      instrument::probe(probes);
       tmp->next = cur->next;
       cur->next = tmp;
       ++size_;
@@ -928,63 +1479,36 @@ insert_multi_noresize(const value_type& value)
     }
   }
   // 否则插入在链表头部
+  instrument::probe(probes);
   tmp->next = first;
-  buckets_[n] = tmp;
+  M_bucket(n) = tmp;
   ++size_;
   return iterator(tmp, this);
 }
 
 // 删除迭代器所指的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase(const_iterator position)
 {
   auto p = position.node;
-  if (p)
-  {
-    const auto n = hash(value_traits::get_key(p->value));
-    auto cur = buckets_[n];
-    if (cur == p)
-    { // p 位于链表头部
-      buckets_[n] = cur->next;
-      destroy_node(cur);
-      --size_;
-    }
-    else
-    {
-      auto next = cur->next;
-      while (next)
-      {
-        if (next == p)
-        {
-          cur->next = next->next;
-          destroy_node(next);
-          --size_;
-          break;
-        }
-        else
-        {
-          cur = next;
-          next = cur->next;
-        }
-      }
-    }
-  }
+  if (p && unlink_node(p))
+    destroy_node(p);
 }
 
 // 删除[first, last)内的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase(const_iterator first, const_iterator last)
 {
   if (first.node == last.node)
     return;
   auto first_bucket = first.node 
-    ? hash(value_traits::get_key(first.node->value)) 
-    : bucket_size_;
+    ? M_index(M_code(first.node)) 
+    : M_nbuckets();
   auto last_bucket = last.node 
-    ? hash(value_traits::get_key(last.node->value))
-    : bucket_size_;
+    ? M_index(M_code(last.node))
+    : M_nbuckets();
   if (first_bucket == last_bucket)
   { // 如果在 bucket 在同一个位置
     erase_bucket(first_bucket, first.node, last.node);
@@ -994,10 +1518,10 @@ erase(const_iterator first, const_iterator last)
     erase_bucket(first_bucket, first.node, nullptr);
     for (auto n = first_bucket + 1; n < last_bucket; ++n)
     {
-      if(buckets_[n] != nullptr)
+      if(M_bucket(n) != nullptr)
         erase_bucket(n, nullptr);
     }
-    if (last_bucket != bucket_size_)
+    if (last_bucket != M_nbuckets())
     {
       erase_bucket(last_bucket, last.node);
     }
@@ -1005,32 +1529,34 @@ erase(const_iterator first, const_iterator last)
 }
 
 // 删除键值为 key 的节点
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase_multi(const key_type& key)
 {
   auto p = equal_range_multi(key);
   if (p.first.node != nullptr)
   {
+    const auto n = mystl::distance(p.first, p.second);
     erase(p.first, p.second);
-    return mystl::distance(p.first, p.second);
+    return n;
   }
   return 0;
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase_unique(const key_type& key)
 {
-  const auto n = hash(key);
-  auto first = buckets_[n];
+  const auto code = hash_(key);
+  const auto n = M_index(code);
+  auto first = M_bucket(n);
   if (first)
   {
-    if (is_equal(value_traits::get_key(first->value), key))
+    if (M_match(first, code, key))
     {
-      buckets_[n] = first->next;
+      M_bucket(n) = first->next;
       destroy_node(first);
       --size_;
       return 1;
@@ -1040,7 +1566,7 @@ erase_unique(const key_type& key)
       auto next = first->next;
       while (next)
       {
-        if (is_equal(value_traits::get_key(next->value), key))
+        if (M_match(next, code, key))
         {
           first->next = next->next;
           destroy_node(next);
@@ -1056,48 +1582,85 @@ erase_unique(const key_type& key)
 }
 
 // 清空 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 clear()
 {
   if (size_ != 0)
   {
-    for (size_type i = 0; i < bucket_size_; ++i)
+    for (size_type i = 0; i < M_nbuckets(); ++i)
     {
-      node_ptr cur = buckets_[i];
+      node_ptr cur = M_bucket(i);
       while (cur != nullptr)
       {
         node_ptr next = cur->next;
         destroy_node(cur);
         cur = next;
       }
-      buckets_[i] = nullptr;
+      M_bucket(i) = nullptr;
     }
     size_ = 0;
   }
+  // 旧桶都已为空，直接结束迁移
+  migrate_buckets(old_bucket_size_);
 }
 
 // 返回指定桶 n 中的元素数量
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 bucket_size(size_type n) const noexcept
 {
   size_type result = 0;
-  for (auto cur = buckets_[n]; cur; cur = cur->next)
+  for (auto cur = M_bucket(n); cur; cur = cur->next)
   {
     ++result;
   }
   return result;
 }
 
+// 统计桶分布与内存占用
+// 成功查找链上第 i 个元素需要比较 i 次，实际比较次数为所有元素的平均值；
+// 哈希值均匀分布时，平均比较次数为 1 + (size - 1) / (2 * bucket_count)
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+ht_stats hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+stats() const
+{
+  ht_stats result;
+  const auto nbuckets = M_nbuckets();
+  result.size = size_;
+  result.bucket_count = nbuckets;
+  result.empty_buckets = 0;
+  result.max_chain = 0;
+  for (size_t i = 0; i < HT_STATS_HISTOGRAM; ++i)
+    result.histogram[i] = 0;
+  result.node_bytes = size_ * sizeof(node_type);
+  result.bucket_bytes = nbuckets * sizeof(node_ptr);
+
+  double probes = 0.0;
+  for (size_type n = 0; n < nbuckets; ++n)
+  {
+    const auto len = bucket_size(n);
+    if (len == 0)
+      ++result.empty_buckets;
+    result.max_chain = mystl::max(result.max_chain, len);
+    ++result.histogram[mystl::min(len, static_cast<size_type>(HT_STATS_HISTOGRAM - 1))];
+    probes += static_cast<double>(len) * static_cast<double>(len + 1) / 2;
+  }
+  result.actual_probes = size_ != 0 ? probes / static_cast<double>(size_) : 0.0;
+  result.expected_probes = size_ != 0 && nbuckets != 0 ?
+    1.0 + static_cast<double>(size_ - 1) / (2.0 * static_cast<double>(nbuckets)) : 0.0;
+  return result;
+}
+
 // 重新对元素进行一遍哈希，插入到新的位置
 // 增加 or 减少桶
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 rehash(size_type count)
 {
-  auto n = ht_next_prime(count);
+  migrate_buckets(old_bucket_size_);
+  auto n = next_size(count);
   if (n > bucket_size_)
   {
     replace_bucket(n);
@@ -1112,161 +1675,197 @@ rehash(size_type count)
   }
 }
 
-// 查找键值为 key 的节点，返回其迭代器
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
-find(const key_type& key)
+// 查找键值为 key 的节点，返回其节点指针
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+M_find(const K& key) const
 {
-  const auto n = hash(key);
-  node_ptr first = buckets_[n];
-  for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-  return iterator(first, this);
-}
-
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::const_iterator
-hashtable<T, Hash, KeyEqual>::
-find(const key_type& key) const
-{
-  const auto n = hash(key);
-  node_ptr first = buckets_[n];
-  for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-  return M_cit(first);
+  const auto code = hash_(key);
+  node_ptr first = M_bucket(M_index(code));
+  size_type probes = 0;
+  for (; first && (++probes, !M_match(first, code, key));
+       first = first->next) {}
+  instrument::probe(probes);
+  return first;
 }
 
 // 查找键值为 key 出现的次数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
-count(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+M_count(const K& key) const
 {
-  const auto n = hash(key);
+  const auto code = hash_(key);
   size_type result = 0;
-  for (node_ptr cur = buckets_[n]; cur; cur = cur->next)
+  for (node_ptr cur = M_bucket(M_index(code)); cur; cur = cur->next)
   {
-    if (is_equal(value_traits::get_key(cur->value), key))
+    if (M_match(cur, code, key))
       ++result;
   }
   return result;
 }
 
 // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key)
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr,
+  typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+M_equal_range_multi(const K& key) const
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  const auto code = hash_(key);
+  const auto n = M_index(code);
+  for (node_ptr first = M_bucket(n); first; first = first->next)
   {
-    if (is_equal(value_traits::get_key(first->value), key))
+    if (M_match(first, code, key))
     { // 如果出现相等的键值
       for (node_ptr second = first->next; second; second = second->next)
       {
-        if (!is_equal(value_traits::get_key(second->value), key))
-          return mystl::make_pair(iterator(first, this), iterator(second, this));
+        if (!M_match(second, code, key))
+          return mystl::make_pair(first, second);
       }
-      for (auto m = n + 1; m < bucket_size_; ++m)
+      for (auto m = n + 1; m < M_nbuckets(); ++m)
       { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
+        if (M_bucket(m))
+          return mystl::make_pair(first, M_bucket(m));
       }
-      return mystl::make_pair(iterator(first, this), end());
+      return mystl::make_pair(first, node_ptr(nullptr));
     }
   }
-  return mystl::make_pair(end(), end());
+  return mystl::make_pair(node_ptr(nullptr), node_ptr(nullptr));
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr,
+  typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+M_equal_range_unique(const K& key) const
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  const auto code = hash_(key);
+  const auto n = M_index(code);
+  for (node_ptr first = M_bucket(n); first; first = first->next)
   {
-    if (is_equal(value_traits::get_key(first->value), key))
+    if (M_match(first, code, key))
     {
-      for (node_ptr second = first->next; second; second = second->next)
-      {
-        if (!is_equal(value_traits::get_key(second->value), key))
-          return mystl::make_pair(M_cit(first), M_cit(second));
-      }
-      for (auto m = n + 1; m < bucket_size_; ++m)
+      if (first->next)
+        return mystl::make_pair(first, first->next);
+      for (auto m = n + 1; m < M_nbuckets(); ++m)
       { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
+        if (M_bucket(m))
+          return mystl::make_pair(first, M_bucket(m));
       }
-      return mystl::make_pair(M_cit(first), cend());
+      return mystl::make_pair(first, node_ptr(nullptr));
     }
   }
-  return mystl::make_pair(cend(), cend());
+  return mystl::make_pair(node_ptr(nullptr), node_ptr(nullptr));
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::
-equal_range_unique(const key_type& key)
+// 交换 hashtable
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+swap(hashtable& rhs) noexcept
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  if (this != &rhs)
   {
-    if (is_equal(value_traits::get_key(first->value), key))
-    {
-      if (first->next)
-        return mystl::make_pair(iterator(first, this), iterator(first->next, this));
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-      }
-      return mystl::make_pair(iterator(first, this), end());
-    }
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename node_alloc_traits::propagate_on_container_swap());
+    swap_data(rhs);
   }
-  return mystl::make_pair(end(), end());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::
-equal_range_unique(const key_type& key) const
+// 取出迭代器所指的节点
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_handle_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+extract(const_iterator position)
+{
+  auto p = position.node;
+  if (p && unlink_node(p))
+    return node_handle_type(p, M_alloc());
+  return node_handle_type();
+}
+
+// 取出一个键值等于 key 的节点，找不到时返回空的句柄
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_handle_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+extract(const key_type& key)
+{
+  auto p = M_find(key);
+  return p ? extract(M_cit(p)) : node_handle_type();
+}
+
+// 插入句柄中的节点，键值不允许重复
+// 先查重再重建表格，重建失败时节点仍留在句柄中
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::insert_return_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+insert_node_unique(node_handle_type&& nh)
+{
+  if (nh.empty())
+    return insert_return_type{ end(), false, node_handle_type() };
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  auto p = M_find(value_traits::get_key(nh.node()->value));
+  if (p)
+    return insert_return_type{ iterator(p, this), false, mystl::move(nh) };
+  rehash_if_need(1);
+  auto it = insert_node_unique(nh.release()).first;
+  return insert_return_type{ it, true, node_handle_type() };
+}
+
+// 插入句柄中的节点，键值允许重复
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+insert_node_multi(node_handle_type&& nh)
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  if (nh.empty())
+    return end();
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  rehash_if_need(1);
+  return insert_node_multi(nh.release());
+}
+
+// 合并 rhs 的节点，键值不允许重复
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class Hash2, class KeyEqual2, class Policy2>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+merge_unique(hashtable<T, Hash2, KeyEqual2, Policy2, Alloc>& rhs)
+{
+  if (static_cast<void*>(this) == static_cast<void*>(&rhs))
+    return;
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+  for (auto it = rhs.begin(); it != rhs.end();)
   {
-    if (is_equal(value_traits::get_key(first->value), key))
+    auto p = (it++).node;
+    if (M_find(value_traits::get_key(p->value)) == nullptr)
     {
-      if (first->next)
-        return mystl::make_pair(M_cit(first), M_cit(first->next));
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
-      }
-      return mystl::make_pair(M_cit(first), cend());
+      rehash_if_need(1);
+      insert_node_unique(rhs.unlink_node(p));
     }
   }
-  return mystl::make_pair(cend(), cend());
 }
 
-// 交换 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
-swap(hashtable& rhs) noexcept
+// 合并 rhs 的节点，键值允许重复
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class Hash2, class KeyEqual2, class Policy2>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+merge_multi(hashtable<T, Hash2, KeyEqual2, Policy2, Alloc>& rhs)
 {
-  if (this != &rhs)
+  if (static_cast<void*>(this) == static_cast<void*>(&rhs))
+    return;
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+  rehash_if_need(rhs.size());
+  for (auto it = rhs.begin(); it != rhs.end();)
   {
-    buckets_.swap(rhs.buckets_);
-    mystl::swap(bucket_size_, rhs.bucket_size_);
-    mystl::swap(size_, rhs.size_);
-    mystl::swap(mlf_, rhs.mlf_);
-    mystl::swap(hash_, rhs.hash_);
-    mystl::swap(equal_, rhs.equal_);
+    auto p = (it++).node;
+    insert_node_multi(rhs.unlink_node(p));
   }
 }
 
@@ -1274,33 +1873,35 @@ swap(hashtable& rhs) noexcept
 // helper function
 
 // init 函数 桶函数指针初始化
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 init(size_type n)
 {
   const auto bucket_nums = next_size(n);
   try
   {
-    buckets_.reserve(bucket_nums);
-    buckets_.assign(bucket_nums, nullptr);
+    buckets_ = create_buckets(bucket_nums);
   }
   catch (...)
   {
+    buckets_ = nullptr;
     bucket_size_ = 0;
     size_ = 0;
     throw;
   }
-  bucket_size_ = buckets_.size();
+  bucket_size_ = bucket_nums;
 }
 
 // copy_init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
-copy_init(const hashtable& ht)
+// 按 ht 的桶结构逐个复制节点，Move 为 m_true_type 时移动节点中的值
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class Ht, class Move>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+copy_init(Ht& ht, Move)
 {
   bucket_size_ = 0;
-  buckets_.reserve(ht.bucket_size_);
-  buckets_.assign(ht.bucket_size_, nullptr);
+  buckets_ = create_buckets(ht.bucket_size_);
+  bucket_size_ = ht.bucket_size_;
   try
   {
     for (size_type i = 0; i < ht.bucket_size_; ++i)
@@ -1308,19 +1909,32 @@ copy_init(const hashtable& ht)
       node_ptr cur = ht.buckets_[i];
       if (cur)
       { // 如果某 bucket 存在链表
-        auto copy = create_node(cur->value);
+        auto copy = clone_node(cur->value, Move());
+        M_copy_code(copy, cur);
         buckets_[i] = copy;
+        ++size_;
         for (auto next = cur->next; next; cur = next, next = cur->next)
         {  //复制链表
-          copy->next = create_node(next->value);
+          copy->next = clone_node(next->value, Move());
           copy = copy->next;
+          M_copy_code(copy, next);
+          ++size_;
         }
         copy->next = nullptr;
       }
     }
-    bucket_size_ = ht.bucket_size_;
+    // ht 正在迁移时，尚未搬移的旧桶中的节点按新桶数重新链接
+    for (size_type i = ht.migrate_pos_; i < ht.old_bucket_size_; ++i)
+    {
+      for (node_ptr cur = ht.old_buckets_[i]; cur; cur = cur->next)
+      {
+        auto copy = clone_node(cur->value, Move());
+        M_copy_code(copy, cur);
+        link_rehashed(buckets_, Policy::index(M_code(copy), bucket_size_), copy);
+        ++size_;
+      }
+    }
     mlf_ = ht.mlf_;
-    size_ = ht.size_;
   }
   catch (...)
   {
@@ -1330,76 +1944,247 @@ copy_init(const hashtable& ht)
 
 // create_node 函数
 // 创建一个新的节点，初始化节点的值，并设置节点的 next 指针为 nullptr
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::node_ptr
-hashtable<T, Hash, KeyEqual>::
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 create_node(Args&& ...args)
 {
-  node_ptr tmp = node_allocator::allocate(1);
+  node_ptr tmp = node_alloc_traits::allocate(M_alloc(), 1);
   try
   {
-    data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(M_alloc(), mystl::address_of(tmp->value),
+                                 mystl::forward<Args>(args)...);
     tmp->next = nullptr;
   }
   catch (...)
   {
-    node_allocator::deallocate(tmp);
+    node_alloc_traits::deallocate(M_alloc(), tmp, 1);
     throw;
   }
   return tmp;
 }
 
 // destroy_node 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 destroy_node(node_ptr node)
 {
-  data_allocator::destroy(mystl::address_of(node->value));
-  node_allocator::deallocate(node);
+  node_alloc_traits::destroy(M_alloc(), mystl::address_of(node->value));
+  node_alloc_traits::deallocate(M_alloc(), node, 1);
   node = nullptr;
 }
 
+// create_buckets 函数
+// 分配 n 个桶并全部置空
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::bucket_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+create_buckets(size_type n)
+{
+  bucket_allocator ba(M_alloc());
+  THROW_LENGTH_ERROR_IF(n > bucket_alloc_traits::max_size(ba),
+                        "hashtable<T>'s bucket count too big");
+  bucket_type b = bucket_alloc_traits::allocate(ba, n);
+  for (size_type i = 0; i < n; ++i)
+    b[i] = nullptr;
+  return b;
+}
+
+// destroy_buckets 函数
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+destroy_buckets(bucket_type b, size_type n)
+{
+  if (b != nullptr)
+  {
+    bucket_allocator ba(M_alloc());
+    bucket_alloc_traits::deallocate(ba, b, n);
+  }
+}
+
+// destroy_all 函数
+// 销毁所有节点并释放桶数组
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+destroy_all()
+{
+  clear();
+  destroy_buckets(buckets_, bucket_size_);
+  buckets_ = nullptr;
+  bucket_size_ = 0;
+}
+
+// swap_data 函数
+// 交换除分配器以外的所有数据
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+swap_data(hashtable& rhs) noexcept
+{
+  mystl::swap(buckets_, rhs.buckets_);
+  mystl::swap(bucket_size_, rhs.bucket_size_);
+  mystl::swap(size_, rhs.size_);
+  mystl::swap(mlf_, rhs.mlf_);
+  mystl::swap(hash_, rhs.hash_);
+  mystl::swap(equal_, rhs.equal_);
+  mystl::swap(old_buckets_, rhs.old_buckets_);
+  mystl::swap(old_bucket_size_, rhs.old_bucket_size_);
+  mystl::swap(migrate_pos_, rhs.migrate_pos_);
+  mystl::swap(incremental_, rhs.incremental_);
+}
+
+// move_assign 函数
+// 可以接管 rhs 的节点：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+move_assign(hashtable& rhs, m_true_type) noexcept
+{
+  destroy_all();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename node_alloc_traits::propagate_on_container_move_assignment());
+  swap_data(rhs);
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+move_assign(hashtable& rhs, m_false_type)
+{
+  if (node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  hashtable tmp(mystl::move(rhs), allocator_type(M_alloc()));
+  swap_data(tmp);
+}
+
 // next_size 函数
 // 返回大小
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::next_size(size_type n) const
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::next_size(size_type n) const
 {
-  return ht_next_prime(n);
+  return Policy::next_size(n);
 }
 
 // hash 函数返回 hash 后的 key 值
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key, size_type n) const
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+hash(const K& key, size_type n) const
 {
-  return hash_(key) % n;
+  return Policy::index(hash_(key), n);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key) const
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+template <class K>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+hash(const K& key) const
 {
-  return hash_(key) % bucket_size_;
+  return M_index(hash_(key));
 }
 
 // rehash_if_need 函数
-//判断是否进行并完成 rehash 
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+// 判断是否进行 rehash，迁移期间每次调用都搬移一些旧桶，返回节点所在的桶是否可能改变
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 rehash_if_need(size_type n)
 {
+  const bool migrating = old_buckets_ != nullptr;
+  if (migrating)
+    migrate_buckets(HT_REHASH_STEP);
   if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
-    rehash(size_ + n);
+  {
+    if (incremental_)
+      start_migration(size_ + n);
+    else
+      rehash(size_ + n);
+    return true;
+  }
+  return migrating;
+}
+
+// start_migration 函数
+// 分配新的桶数组，原有的桶数组成为旧桶，节点暂时留在旧桶中
+// 上一次迁移还没有完成时先把它做完
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+start_migration(size_type count)
+{
+  migrate_buckets(old_bucket_size_);
+  const auto n = next_size(count);
+  if (n <= bucket_size_)
+    return;
+  bucket_type bucket = create_buckets(n);
+  instrument::count(hashtable_rehash);
+  if (size_ == 0)
+  {
+    destroy_buckets(buckets_, bucket_size_);
+    buckets_ = bucket;
+    bucket_size_ = n;
+    return;
+  }
+  old_buckets_ = buckets_;
+  old_bucket_size_ = bucket_size_;
+  migrate_pos_ = 0;
+  buckets_ = bucket;
+  bucket_size_ = n;
+  migrate_buckets(HT_REHASH_STEP);
+}
+
+// migrate_buckets 函数
+// 把至多 n 个旧桶中的节点链接到新桶中，旧桶全部搬完后释放旧桶数组
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+migrate_buckets(size_type n) noexcept
+{
+  if (old_buckets_ == nullptr)
+    return;
+  for (; n > 0 && migrate_pos_ < old_bucket_size_; --n, ++migrate_pos_)
+  {
+    for (auto first = old_buckets_[migrate_pos_]; first; )
+    {
+      auto tmp = first;
+      first = first->next;
+      link_rehashed(buckets_, Policy::index(M_code(tmp), bucket_size_), tmp);
+    }
+    old_buckets_[migrate_pos_] = nullptr;
+  }
+  if (migrate_pos_ == old_bucket_size_)
+  {
+    destroy_buckets(old_buckets_, old_bucket_size_);
+    old_buckets_ = nullptr;
+    old_bucket_size_ = 0;
+    migrate_pos_ = 0;
+  }
+}
+
+// link_rehashed 函数
+// 把节点链接到桶数组 b 的第 n 个桶中，桶中有相同键值的节点时放在它后面，使相同键值的节点保持相邻
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+link_rehashed(bucket_type b, size_type n, node_ptr np) noexcept
+{
+  for (auto cur = b[n]; cur; cur = cur->next)
+  {
+    if (M_match_node(cur, np))
+    {
+      np->next = cur->next;
+      cur->next = np;
+      return;
+    }
+  }
+  np->next = b[n];
+  b[n] = np;
 }
 
 // copy_insert
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
   rehash_if_need(mystl::distance(first, last));
@@ -1407,9 +2192,9 @@ copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
     insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 copy_insert_multi(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
 {
   size_type n = mystl::distance(first, last);
@@ -1418,9 +2203,9 @@ copy_insert_multi(ForwardIter first, ForwardIter last, mystl::forward_iterator_t
     insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
   rehash_if_need(mystl::distance(first, last));
@@ -1428,9 +2213,9 @@ copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
     insert_unique_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
 {
   size_type n = mystl::distance(first, last);
@@ -1440,110 +2225,136 @@ copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_
 }
 
 // insert_node 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 insert_node_multi(node_ptr np)
 {
-  const auto n = hash(value_traits::get_key(np->value));
-  auto cur = buckets_[n];
+  const auto code = hash_(value_traits::get_key(np->value));
+  M_store_code(np, code);
+  const auto n = M_index(code);
+  auto cur = M_bucket(n);
   if (cur == nullptr)
   {
-    buckets_[n] = np;
+    instrument::probe(0);
+    M_bucket(n) = np;
     ++size_;
     return iterator(np, this);
   }
+  size_type probes = 0;
   for (; cur; cur = cur->next)
   {
-    if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value)))
+    ++probes;
+    if (M_match_node(cur, np))
     {
+      instrument::probe(probes);
       np->next = cur->next;
       cur->next = np;
       ++size_;
       return iterator(np, this);
     }
   }
-  np->next = buckets_[n];
-  buckets_[n] = np;
+  instrument::probe(probes);
+  np->next = M_bucket(n);
+  M_bucket(n) = np;
   ++size_;
   return iterator(np, this);
 }
 
 // insert_node_unique 函数
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 insert_node_unique(node_ptr np)
 {
-  const auto n = hash(value_traits::get_key(np->value));
-  auto cur = buckets_[n];
+  const auto code = hash_(value_traits::get_key(np->value));
+  M_store_code(np, code);
+  const auto n = M_index(code);
+  auto cur = M_bucket(n);
   if (cur == nullptr)
   {
-    buckets_[n] = np;
+    instrument::probe(0);
+    M_bucket(n) = np;
     ++size_;
     return mystl::make_pair(iterator(np, this), true);
   }
+  size_type probes = 0;
   for (; cur; cur = cur->next)
   {
-    if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value)))
-    {
+    ++probes;
+    if (M_match_node(cur, np))
+    { // 键值已存在，新节点不再需要
+      instrument::probe(probes);
+      instrument::count(hashtable_failed_insert);
+      destroy_node(np);
       return mystl::make_pair(iterator(cur, this), false);
     }
   }
-  np->next = buckets_[n];
-  buckets_[n] = np;
+  instrument::probe(probes);
+  np->next = M_bucket(n);
+  M_bucket(n) = np;
   ++size_;
+  check_chain(n);
   return mystl::make_pair(iterator(np, this), true);
 }
 
+// unlink_node 函数
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Policy, Alloc>::node_ptr
+hashtable<T, Hash, KeyEqual, Policy, Alloc>::
+unlink_node(node_ptr p)
+{
+  const auto n = M_index(M_code(p));
+  auto cur = M_bucket(n);
+  if (cur == p)
+  { // p 位于链表头部
+    M_bucket(n) = p->next;
+  }
+  else
+  {
+    while (cur && cur->next != p)
+      cur = cur->next;
+    if (cur == nullptr)
+      return nullptr;
+    cur->next = p->next;
+  }
+  p->next = nullptr;
+  --size_;
+  return p;
+}
+
 // replace_bucket 函数
-// 重新分配桶
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+// 重新分配桶，原有节点直接链接到新桶中
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 replace_bucket(size_type bucket_count)
 {
-  bucket_type bucket(bucket_count);
+  bucket_type bucket = create_buckets(bucket_count);
+  instrument::count(hashtable_rehash);
   if (size_ != 0)
   {
     for (size_type i = 0; i < bucket_size_; ++i)
     {
-      for (auto first = buckets_[i]; first; first = first->next)
+      for (auto first = buckets_[i]; first; )
       {
-        auto tmp = create_node(first->value);
-        const auto n = hash(value_traits::get_key(first->value), bucket_count);
-        auto f = bucket[n];
-        bool is_inserted = false;
-        // 检查新桶中是否存在具有相同键的元素，如果存在，将新节点插入到相同键的元素后面
-        for (auto cur = f; cur; cur = cur->next)
-        {
-          if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
-          {
-            tmp->next = cur->next;
-            cur->next = tmp;
-            is_inserted = true;
-            break;
-          }
-        }
-        // 否则，将新节点插入到桶的开头
-        if (!is_inserted)
-        {
-          tmp->next = f;
-          bucket[n] = tmp;
-        }
+        auto tmp = first;
+        first = first->next;
+        link_rehashed(bucket, Policy::index(M_code(tmp), bucket_count), tmp);
       }
     }
   }
-  buckets_.swap(bucket);
-  bucket_size_ = buckets_.size();
+  destroy_buckets(buckets_, bucket_size_);
+  buckets_ = bucket;
+  bucket_size_ = bucket_count;
 }
 
 // erase_bucket 函数
 // 在第 n 个 bucket 内，删除 [first, last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase_bucket(size_type n, node_ptr first, node_ptr last)
 {
-  auto cur = buckets_[n];
+  auto cur = M_bucket(n);
   if (cur == first)
   {
     erase_bucket(n, last);
@@ -1563,12 +2374,12 @@ erase_bucket(size_type n, node_ptr first, node_ptr last)
 }
 
 // erase_bucket 函数
-// 在第 n 个 bucket 内，删除 [buckets_[n], last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+// 在第 n 个 bucket 内，删除 [M_bucket(n), last) 的节点
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void hashtable<T, Hash, KeyEqual, Policy, Alloc>::
 erase_bucket(size_type n, node_ptr last)
 {
-  auto cur = buckets_[n];
+  auto cur = M_bucket(n);
   while (cur != last)
   {
     auto next = cur->next;
@@ -1576,13 +2387,13 @@ erase_bucket(size_type n, node_ptr last)
     cur = next;
     --size_;
   }
-  buckets_[n] = last;
+  M_bucket(n) = last;
 }
 
 // equal_to 函数
 // 检查两个哈希表是否在内容上完全相等
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Policy, Alloc>::equal_to_multi(const hashtable& other)
 {
   if (size_ != other.size_)
     return false;
@@ -1598,8 +2409,8 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
   return true;
 }
 
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Policy, Alloc>::equal_to_unique(const hashtable& other)
 {
   if (size_ != other.size_)
     return false;
@@ -1613,9 +2424,9 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
 }
 
 // 重载 mystl 的 swap
-template <class T, class Hash, class KeyEqual>
-void swap(hashtable<T, Hash, KeyEqual>& lhs,
-          hashtable<T, Hash, KeyEqual>& rhs) noexcept
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void swap(hashtable<T, Hash, KeyEqual, Policy, Alloc>& lhs,
+          hashtable<T, Hash, KeyEqual, Policy, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
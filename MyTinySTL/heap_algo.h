@@ -2,8 +2,12 @@
 #define MYTINYSTL_HEAP_ALGO_H_
 
 // 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+// 以及它们的 d 叉堆版本 : push_dary_heap, pop_dary_heap, sort_dary_heap, make_dary_heap, is_dary_heap
+// 和供 priority_queue 选择堆结构的策略 : heap_binary_policy, heap_dary_policy
 
 #include "iterator.h"
+#include "functional.h"
+#include "util.h"
 
 namespace mystl
 {
@@ -19,17 +23,18 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T va
   while (holeIndex > topIndex && *(first + parent) < value)
   {
     // 使用 operator<，所以 heap 为 max-heap
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*)
 {
-  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1));
+  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
+                       mystl::move(*(last - 1)));
 }
 
 template <class RandomIter>
@@ -46,18 +51,18 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T va
   auto parent = (holeIndex - 1) / 2;
   while (holeIndex > topIndex && comp(*(first + parent), value))
   {
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Compared, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*, Compared comp)
 {
   mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
-                       *(last - 1), comp);
+                       mystl::move(*(last - 1)), comp);
 }
 
 template <class RandomIter, class Compared>
@@ -81,17 +86,17 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value)
   {
     if (*(first + rchild) < *(first + rchild - 1))
       --rchild;
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len)
   {  // 如果没有右子节点
-    *(first + holeIndex) = *(first + (rchild - 1));
+    *(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
     holeIndex = rchild - 1;
   }
   // 再执行一次上溯(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value));
 }
 
 template <class RandomIter, class T, class Distance>
@@ -99,14 +104,15 @@ void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value,
                   Distance*)
 {
   // 先将首值调至尾节点，然后调整[first, last - 1)使之重新成为一个 max-heap
-  *result = *first;
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value);
+  *result = mystl::move(*first);
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value));
 }
 
 template <class RandomIter>
 void pop_heap(RandomIter first, RandomIter last)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), distance_type(first));
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)),
+                      distance_type(first));
 }
 
 // 重载版本使用函数对象 comp 代替比较操作
@@ -122,31 +128,31 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value,
   while (rchild < len)
   {
     if (comp(*(first + rchild), *(first + rchild - 1)))  --rchild;
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len)
   {
-    *(first + holeIndex) = *(first + (rchild - 1));
+    *(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
     holeIndex = rchild - 1;
   }
   // 再执行一次上溯(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value, comp);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value), comp);
 }
 
 template <class RandomIter, class T, class Distance, class Compared>
 void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, 
                   T value, Distance*, Compared comp)
 {
-  *result = *first;  // 先将尾指设置成首值，即尾指为欲求结果
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value, comp);
+  *result = mystl::move(*first);  // 先将尾指设置成首值，即尾指为欲求结果
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value), comp);
 }
 
 template <class RandomIter, class Compared>
 void pop_heap(RandomIter first, RandomIter last, Compared comp)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)),
                       distance_type(first), comp);
 }
 
@@ -191,7 +197,7 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+    mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)));
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -217,7 +223,7 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared comp)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex), comp);
+    mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)), comp);
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -231,6 +237,192 @@ void make_heap(RandomIter first, RandomIter last, Compared comp)
   mystl::make_heap_aux(first, last, distance_type(first), comp);
 }
 
+/*****************************************************************************************/
+// d 叉堆
+// 节点 i 的子节点为 D * i + 1 ... D * i + D，父节点为 (i - 1) / D
+// 树高为 log_D(n)，D = 4 时 pop 的下溯层数减半，同一节点的四个子节点相邻，通常位于同一条 cache line
+// 用法与二叉堆相同，D 作为第一个模板参数显式给出，如 mystl::push_dary_heap<4>(first, last, comp)
+/*****************************************************************************************/
+
+// 把 value 从 holeIndex 上溯，直到父节点不小于它或到达 topIndex
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_heap_sift_up(RandomIter first, Distance holeIndex, Distance topIndex, T value,
+                       Compared comp)
+{
+  static_assert(D >= 2, "the arity of a heap should be at least 2");
+  while (holeIndex > topIndex)
+  {
+    const Distance parent = (holeIndex - 1) / static_cast<Distance>(D);
+    if (!comp(*(first + parent), value))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + parent));
+    holeIndex = parent;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// 把 value 从 holeIndex 下溯：每次取 D 个子节点中最大的一个，value 不小于它时停止
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_heap_sift_down(RandomIter first, Distance holeIndex, Distance len, T value,
+                         Compared comp)
+{
+  static_assert(D >= 2, "the arity of a heap should be at least 2");
+  while (true)
+  {
+    const Distance child = static_cast<Distance>(D) * holeIndex + 1;
+    if (child >= len)
+      break;
+    const Distance last = len - child > static_cast<Distance>(D)
+      ? child + static_cast<Distance>(D) : len;
+    Distance best = child;
+    for (Distance i = child + 1; i < last; ++i)
+    {
+      if (comp(*(first + best), *(first + i)))
+        best = i;
+    }
+    if (!comp(value, *(first + best)))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// push_dary_heap : 新元素已置于尾端，将它上溯到合适的位置
+template <size_t D, class RandomIter, class Compared>
+void push_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  if (len < 2)
+    return;
+  auto value = mystl::move(*(last - 1));
+  mystl::dary_heap_sift_up<D>(first, len - 1, static_cast<Distance>(0), mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void push_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::push_dary_heap<D>(first, last, mystl::less<>());
+}
+
+// pop_dary_heap : 将根节点放到尾端，调整 [first, last - 1) 使之重新成为 d 叉堆
+template <size_t D, class RandomIter, class Compared>
+void pop_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  if (len < 2)
+    return;
+  auto value = mystl::move(*(last - 1));
+  *(last - 1) = mystl::move(*first);
+  mystl::dary_heap_sift_down<D>(first, static_cast<Distance>(0), len - 1, mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void pop_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::pop_dary_heap<D>(first, last, mystl::less<>());
+}
+
+// make_dary_heap : 从最后一个非叶节点开始逐个下溯
+template <size_t D, class RandomIter, class Compared>
+void make_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  if (len < 2)
+    return;
+  for (Distance holeIndex = (len - 2) / static_cast<Distance>(D); ; --holeIndex)
+  {
+    auto value = mystl::move(*(first + holeIndex));
+    mystl::dary_heap_sift_down<D>(first, holeIndex, len, mystl::move(value), comp);
+    if (holeIndex == 0)
+      return;
+  }
+}
+
+template <size_t D, class RandomIter>
+void make_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::make_dary_heap<D>(first, last, mystl::less<>());
+}
+
+// sort_dary_heap : 不断执行 pop_dary_heap，直到首尾最多相差 1
+template <size_t D, class RandomIter, class Compared>
+void sort_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  while (last - first > 1)
+  {
+    mystl::pop_dary_heap<D>(first, last--, comp);
+  }
+}
+
+template <size_t D, class RandomIter>
+void sort_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::sort_dary_heap<D>(first, last, mystl::less<>());
+}
+
+// is_dary_heap : 检查 [first, last) 是否为 d 叉堆
+template <size_t D, class RandomIter, class Compared>
+bool is_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  for (Distance i = 1; i < len; ++i)
+  {
+    if (comp(*(first + (i - 1) / static_cast<Distance>(D)), *(first + i)))
+      return false;
+  }
+  return true;
+}
+
+template <size_t D, class RandomIter>
+bool is_dary_heap(RandomIter first, RandomIter last)
+{
+  return mystl::is_dary_heap<D>(first, last, mystl::less<>());
+}
+
+/*****************************************************************************************/
+// 堆策略
+// priority_queue 通过堆策略的 push / pop / make 维护底层容器
+// heap_binary_policy   : 二叉堆，缺省的策略
+// heap_dary_policy<D>  : d 叉堆，堆较大、pop 较多时访存更少
+/*****************************************************************************************/
+
+struct heap_binary_policy
+{
+  template <class RandomIter, class Compared>
+  static void push(RandomIter first, RandomIter last, Compared comp)
+  { mystl::push_heap(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void pop(RandomIter first, RandomIter last, Compared comp)
+  { mystl::pop_heap(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void make(RandomIter first, RandomIter last, Compared comp)
+  { mystl::make_heap(first, last, comp); }
+};
+
+template <size_t D>
+struct heap_dary_policy
+{
+  template <class RandomIter, class Compared>
+  static void push(RandomIter first, RandomIter last, Compared comp)
+  { mystl::push_dary_heap<D>(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void pop(RandomIter first, RandomIter last, Compared comp)
+  { mystl::pop_dary_heap<D>(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void make(RandomIter first, RandomIter last, Compared comp)
+  { mystl::make_dary_heap<D>(first, last, comp); }
+};
+
+typedef heap_dary_policy<4> heap_4ary_policy;
+
 } // namespace mystl
 #endif // !MYTINYSTL_HEAP_ALGO_H_
-
@@ -0,0 +1,342 @@
+﻿#ifndef MYTINYSTL_INDEXED_PRIORITY_QUEUE_H_
+#define MYTINYSTL_INDEXED_PRIORITY_QUEUE_H_
+
+// 这个头文件包含一个模板类 indexed_priority_queue
+// indexed_priority_queue : 可索引的优先队列，push 返回一个句柄，之后可以通过句柄修改或删除元素
+
+// notes:
+//
+// 1. 元素放在槽位数组中，句柄就是槽位的下标；堆中只保存槽位下标，每个槽位记录自己在堆中的位置，
+//    调整堆时只移动下标，元素本身不移动，修改、删除任意元素都是 O(log n)
+// 2. 堆为 d 叉堆，分叉数由 INDEXED_PQ_ARITY 决定，缺省为 4
+// 3. increase_key / decrease_key 以 Compare 定义的优先级为准：increase_key 使元素更靠近 top()，
+//    例如以 mystl::greater 作为比较方式(top() 为最小值)时，把距离改小应调用 increase_key，
+//    不确定方向时使用 update
+// 4. 元素被 pop 或 erase 后它的句柄失效，槽位会被之后的 push 复用
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// indexed_priority_queue 的堆的分叉数
+#ifndef INDEXED_PQ_ARITY
+#define INDEXED_PQ_ARITY 4
+#endif
+
+// 模板类 indexed_priority_queue
+// 参数一代表数据类型，参数二代表比较权值的方式，缺省使用 mystl::less，top() 为最大值
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Compare = mystl::less<T>, class Alloc = mystl::allocator<T>>
+class indexed_priority_queue
+{
+public:
+  typedef T                 value_type;
+  typedef Compare           value_compare;
+  typedef Alloc             allocator_type;
+  typedef size_t            size_type;
+  typedef size_t            handle_type;
+  typedef T&                reference;
+  typedef const T&          const_reference;
+
+  static constexpr handle_type npos = static_cast<handle_type>(-1);
+
+private:
+  // 槽位：元素与它在堆中的位置，pos 为 npos 表示槽位空闲
+  struct slot
+  {
+    value_type value;
+    size_type  pos;
+
+    template <class... Args>
+    slot(size_type p, Args&& ...args)
+      :value(mystl::forward<Args>(args)...), pos(p) {}
+  };
+
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<slot>      slot_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<size_type> index_allocator;
+
+  mystl::vector<slot, slot_allocator>       slots_;  // 槽位数组，下标即句柄
+  mystl::vector<size_type, index_allocator> heap_;   // 按堆的顺序保存槽位下标
+  mystl::vector<size_type, index_allocator> free_;   // 空闲的槽位
+  value_compare                             comp_;   // 权值比较的标准
+
+public:
+  // 构造、复制、移动函数
+  indexed_priority_queue() = default;
+
+  explicit indexed_priority_queue(const Compare& comp,
+                                  const allocator_type& alloc = allocator_type())
+    :slots_(slot_allocator(alloc)), heap_(index_allocator(alloc)),
+    free_(index_allocator(alloc)), comp_(comp)
+  {
+  }
+
+  indexed_priority_queue(std::initializer_list<T> ilist, const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    reserve(ilist.size());
+    for (auto& value : ilist)
+      push(value);
+  }
+
+  indexed_priority_queue(const indexed_priority_queue&) = default;
+  indexed_priority_queue(indexed_priority_queue&&) = default;
+  indexed_priority_queue& operator=(const indexed_priority_queue&) = default;
+  indexed_priority_queue& operator=(indexed_priority_queue&&) = default;
+
+  ~indexed_priority_queue() = default;
+
+public:
+  // 访问元素相关操作
+  const_reference top()        const { MYSTL_DEBUG(!empty()); return slots_[heap_.front()].value; }
+  handle_type     top_handle() const { MYSTL_DEBUG(!empty()); return heap_.front(); }
+
+  // 句柄 h 对应的元素
+  const_reference operator[](handle_type h) const
+  {
+    MYSTL_DEBUG(contains(h));
+    return slots_[h].value;
+  }
+  const_reference at(handle_type h) const
+  {
+    THROW_OUT_OF_RANGE_IF(!contains(h), "indexed_priority_queue<T>::at() invalid handle");
+    return slots_[h].value;
+  }
+
+  // 句柄 h 是否对应队列中的元素
+  bool contains(handle_type h) const noexcept
+  { return h < slots_.size() && slots_[h].pos != npos; }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return heap_.empty(); }
+  size_type size()     const noexcept { return heap_.size(); }
+  void      reserve(size_type n)
+  {
+    slots_.reserve(n);
+    heap_.reserve(n);
+  }
+
+  value_compare value_comp() const { return comp_; }
+
+  // 修改容器相关操作
+  template <class... Args>
+  handle_type emplace(Args&& ...args);
+
+  handle_type push(const value_type& value)
+  { return emplace(value); }
+  handle_type push(value_type&& value)
+  { return emplace(mystl::move(value)); }
+
+  void pop()
+  {
+    MYSTL_DEBUG(!empty());
+    erase(heap_.front());
+  }
+
+  void erase(handle_type h);
+
+  // 修改句柄 h 对应的元素，根据新值上溯或下溯
+  void update(handle_type h, const value_type& value)
+  { M_update(h, value); }
+  void update(handle_type h, value_type&& value)
+  { M_update(h, mystl::move(value)); }
+
+  // 提高句柄 h 对应元素的优先级，新值不应小于旧值
+  void increase_key(handle_type h, const value_type& value)
+  { M_increase(h, value); }
+  void increase_key(handle_type h, value_type&& value)
+  { M_increase(h, mystl::move(value)); }
+
+  // 降低句柄 h 对应元素的优先级，新值不应大于旧值
+  void decrease_key(handle_type h, const value_type& value)
+  { M_decrease(h, value); }
+  void decrease_key(handle_type h, value_type&& value)
+  { M_decrease(h, mystl::move(value)); }
+
+  void clear() noexcept
+  {
+    slots_.clear();
+    heap_.clear();
+    free_.clear();
+  }
+
+  void swap(indexed_priority_queue& rhs) noexcept
+  {
+    slots_.swap(rhs.slots_);
+    heap_.swap(rhs.heap_);
+    free_.swap(rhs.free_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  // helper functions
+
+  bool less_at(size_type i, size_type j) const
+  { return comp_(slots_[heap_[i]].value, slots_[heap_[j]].value); }
+
+  void place(size_type pos, size_type h) noexcept
+  {
+    heap_[pos] = h;
+    slots_[h].pos = pos;
+  }
+
+  void sift_up(size_type pos);
+  void sift_down(size_type pos);
+
+  template <class V>
+  void M_update(handle_type h, V&& value)
+  {
+    MYSTL_DEBUG(contains(h));
+    slots_[h].value = mystl::forward<V>(value);
+    const auto pos = slots_[h].pos;
+    sift_up(pos);
+    if (slots_[h].pos == pos)
+      sift_down(pos);
+  }
+
+  template <class V>
+  void M_increase(handle_type h, V&& value)
+  {
+    MYSTL_DEBUG(contains(h));
+    MYSTL_DEBUG(!comp_(value, slots_[h].value));
+    slots_[h].value = mystl::forward<V>(value);
+    sift_up(slots_[h].pos);
+  }
+
+  template <class V>
+  void M_decrease(handle_type h, V&& value)
+  {
+    MYSTL_DEBUG(contains(h));
+    MYSTL_DEBUG(!comp_(slots_[h].value, value));
+    slots_[h].value = mystl::forward<V>(value);
+    sift_down(slots_[h].pos);
+  }
+};
+
+template <class T, class Compare, class Alloc>
+constexpr typename indexed_priority_queue<T, Compare, Alloc>::handle_type
+indexed_priority_queue<T, Compare, Alloc>::npos;
+
+/*****************************************************************************************/
+
+// 就地构造元素，返回它的句柄
+// 强异常安全保证
+template <class T, class Compare, class Alloc>
+template <class... Args>
+typename indexed_priority_queue<T, Compare, Alloc>::handle_type
+indexed_priority_queue<T, Compare, Alloc>::
+emplace(Args&& ...args)
+{
+  const auto pos = heap_.size();
+  handle_type h;
+  if (free_.empty())
+  {
+    h = slots_.size();
+    heap_.push_back(h);
+    try
+    {
+      slots_.emplace_back(pos, mystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      heap_.pop_back();
+      throw;
+    }
+  }
+  else
+  { // 复用空闲的槽位
+    h = free_.back();
+    slots_[h].value = value_type(mystl::forward<Args>(args)...);
+    heap_.push_back(h);
+    slots_[h].pos = pos;
+    free_.pop_back();
+  }
+  sift_up(pos);
+  return h;
+}
+
+// 删除句柄 h 对应的元素：用堆的最后一个元素填补它的位置，再上溯或下溯
+template <class T, class Compare, class Alloc>
+void indexed_priority_queue<T, Compare, Alloc>::
+erase(handle_type h)
+{
+  MYSTL_DEBUG(contains(h));
+  free_.push_back(h);
+  const auto pos = slots_[h].pos;
+  const auto last = heap_.back();
+  heap_.pop_back();
+  if (last != h)
+  {
+    place(pos, last);
+    sift_up(pos);
+    if (slots_[last].pos == pos)
+      sift_down(pos);
+  }
+  slots_[h].pos = npos;
+  // 释放元素持有的资源，槽位留待复用
+  static_cast<void>(value_type(mystl::move(slots_[h].value)));
+}
+
+// sift_up 函数
+// 把位于 pos 的槽位上溯，直到父节点不小于它
+template <class T, class Compare, class Alloc>
+void indexed_priority_queue<T, Compare, Alloc>::
+sift_up(size_type pos)
+{
+  const auto h = heap_[pos];
+  while (pos > 0)
+  {
+    const auto parent = (pos - 1) / INDEXED_PQ_ARITY;
+    if (!comp_(slots_[heap_[parent]].value, slots_[h].value))
+      break;
+    place(pos, heap_[parent]);
+    pos = parent;
+  }
+  place(pos, h);
+}
+
+// sift_down 函数
+// 把位于 pos 的槽位下溯：每次与最大的子节点比较，不小于它时停止
+template <class T, class Compare, class Alloc>
+void indexed_priority_queue<T, Compare, Alloc>::
+sift_down(size_type pos)
+{
+  const auto h = heap_[pos];
+  const auto len = heap_.size();
+  while (true)
+  {
+    const auto child = INDEXED_PQ_ARITY * pos + 1;
+    if (child >= len)
+      break;
+    const auto last = len - child > INDEXED_PQ_ARITY ? child + INDEXED_PQ_ARITY : len;
+    auto best = child;
+    for (auto i = child + 1; i < last; ++i)
+    {
+      if (less_at(best, i))
+        best = i;
+    }
+    if (!comp_(slots_[h].value, slots_[heap_[best]].value))
+      break;
+    place(pos, heap_[best]);
+    pos = best;
+  }
+  place(pos, h);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare, class Alloc>
+void swap(indexed_priority_queue<T, Compare, Alloc>& lhs,
+          indexed_priority_queue<T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_INDEXED_PRIORITY_QUEUE_H_
+
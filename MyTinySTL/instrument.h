@@ -0,0 +1,166 @@
+﻿#ifndef MYTINYSTL_INSTRUMENT_H_
+#define MYTINYSTL_INSTRUMENT_H_
+
+// 这个头文件包含一个类 instrument，统计容器内部的扩容、rehash、探查与旋转次数
+
+// notes:
+//
+// 1. 定义 MYSTL_INSTRUMENT 为 1 时启用，缺省为 0，此时所有记录函数都是空函数，没有任何开销；
+//    同一个程序的所有编译单元应使用相同的设置
+// 2. 计数按容器种类在进程内汇总，使用 relaxed 原子操作，可以在多个线程中同时记录
+// 3. instrument::snapshot() 返回当前所有计数的副本，instrument::name(id) 给出计数的名字，
+//    可以逐项导出；instrument::reset() 清零，便于只统计一段代码
+// 4. 各项计数的含义：
+//    hashtable_rehash           : 桶数组扩大或缩小的次数（包括渐进式 rehash 开始迁移）
+//    hashtable_probes           : 插入与查找时遍历桶链表的次数
+//    hashtable_probe_length     : 遍历时经过的节点总数，除以 hashtable_probes 为平均链长
+//    hashtable_max_chain        : 遍历时经过的最多节点数
+//    hashtable_failed_insert    : emplace 等先构造节点、再发现键值重复而销毁节点的次数
+//    vector_reallocation        : vector 扩容时搬移原有元素的次数，原来没有元素时不计
+//    vector_bytes_moved         : 扩容时搬移的字节数
+//    string_reallocation        : basic_string 扩容时复制原有字符的次数，原来没有字符时不计
+//    string_bytes_moved         : 扩容时复制的字节数
+//    deque_map_reallocation     : deque 重新分配中控器（map）的次数
+//    rb_tree_rotation           : rb_tree 插入与删除时的旋转次数
+// 5. 另见 vector.h 中的 vector_stats，它统计所有 vector 当前占用的字节数
+
+#include <atomic>
+
+#include <cstddef>
+
+namespace mystl
+{
+
+#ifndef MYSTL_INSTRUMENT
+#define MYSTL_INSTRUMENT 0
+#endif
+
+// 计数的编号
+enum instrument_counter
+{
+  hashtable_rehash,
+  hashtable_probes,
+  hashtable_probe_length,
+  hashtable_max_chain,
+  hashtable_failed_insert,
+  vector_reallocation,
+  vector_bytes_moved,
+  string_reallocation,
+  string_bytes_moved,
+  deque_map_reallocation,
+  rb_tree_rotation,
+  instrument_counter_count
+};
+
+// 所有计数的副本，由 instrument::snapshot() 返回
+struct instrument_snapshot
+{
+  size_t values[instrument_counter_count];
+
+  size_t operator[](instrument_counter id) const noexcept { return values[id]; }
+
+  // 插入与查找时的平均链长
+  double average_chain_length() const noexcept
+  {
+    return values[hashtable_probes] == 0 ? 0.0 :
+      static_cast<double>(values[hashtable_probe_length]) /
+      static_cast<double>(values[hashtable_probes]);
+  }
+};
+
+// 类 instrument
+class instrument
+{
+private:
+  static std::atomic<size_t>* M_counters() noexcept
+  {
+    static std::atomic<size_t> c[instrument_counter_count] = {};
+    return c;
+  }
+
+public:
+  // 计数 id 增加 n
+  static void count(instrument_counter id, size_t n = 1) noexcept
+  {
+#if MYSTL_INSTRUMENT
+    M_counters()[id].fetch_add(n, std::memory_order_relaxed);
+#else
+    (void)id;
+    (void)n;
+#endif
+  }
+
+  // 计数 id 取它与 value 中的较大者
+  static void count_max(instrument_counter id, size_t value) noexcept
+  {
+#if MYSTL_INSTRUMENT
+    auto& c = M_counters()[id];
+    size_t old = c.load(std::memory_order_relaxed);
+    while (old < value && !c.compare_exchange_weak(old, value, std::memory_order_relaxed))
+    {
+    }
+#else
+    (void)id;
+    (void)value;
+#endif
+  }
+
+  // 记录一次扩容搬移了 bytes 个字节，没有搬移任何数据时不计
+  static void relocation(instrument_counter id, instrument_counter bytes_id, size_t bytes) noexcept
+  {
+#if MYSTL_INSTRUMENT
+    if (bytes == 0)
+      return;
+    count(id);
+    count(bytes_id, bytes);
+#else
+    (void)id;
+    (void)bytes_id;
+    (void)bytes;
+#endif
+  }
+
+  // 记录一次经过 length 个节点的链表遍历
+  static void probe(size_t length) noexcept
+  {
+#if MYSTL_INSTRUMENT
+    count(hashtable_probes);
+    count(hashtable_probe_length, length);
+    count_max(hashtable_max_chain, length);
+#else
+    (void)length;
+#endif
+  }
+
+  static instrument_snapshot snapshot() noexcept
+  {
+    instrument_snapshot result;
+    auto c = M_counters();
+    for (size_t i = 0; i < instrument_counter_count; ++i)
+      result.values[i] = c[i].load(std::memory_order_relaxed);
+    return result;
+  }
+
+  static void reset() noexcept
+  {
+    auto c = M_counters();
+    for (size_t i = 0; i < instrument_counter_count; ++i)
+      c[i].store(0, std::memory_order_relaxed);
+  }
+
+  static constexpr bool enabled() noexcept { return MYSTL_INSTRUMENT != 0; }
+
+  static const char* name(instrument_counter id) noexcept
+  {
+    static const char* const names[instrument_counter_count] = {
+      "hashtable_rehash", "hashtable_probes", "hashtable_probe_length", "hashtable_max_chain",
+      "hashtable_failed_insert", "vector_reallocation", "vector_bytes_moved",
+      "string_reallocation", "string_bytes_moved", "deque_map_reallocation", "rb_tree_rotation"
+    };
+    return id < instrument_counter_count ? names[id] : "unknown";
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_INSTRUMENT_H_
+
@@ -0,0 +1,1042 @@
+﻿#ifndef MYTINYSTL_INTRUSIVE_H_
+#define MYTINYSTL_INTRUSIVE_H_
+
+// 这个头文件包含两个挂钩 intrusive_list_hook、intrusive_set_hook
+// 与三个模板类 intrusive_list、intrusive_set、intrusive_multiset
+//
+// intrusive_list     : 侵入式双向链表，链接的是元素自身的挂钩成员
+// intrusive_set      : 侵入式红黑树，键值不允许重复
+// intrusive_multiset : 侵入式红黑树，键值允许重复
+
+// notes:
+//
+// 1. 侵入式容器不分配内存，也不拥有元素：插入时把元素内的挂钩链入容器，删除时只是断开链接，
+//    元素的生命周期由使用者管理。容器通过挂钩成员指针（如 &T::hook）由挂钩找回元素，
+//    一个元素含有多个挂钩时可以同时位于多个容器中
+// 2. 挂钩链入容器时，元素不能被移动或销毁；挂钩析构时若仍在容器中，会自动从容器中断开，
+//    复制元素不会复制挂钩的链接状态
+// 3. 挂钩的 unlink() 可以在不知道所属容器的情况下把元素从容器中删除：
+//    intrusive_list_hook 为 O(1)，intrusive_set_hook 需要上溯到 header，为 O(log n)
+// 4. 为了支持 3，容器不保存元素个数，size() 为 O(n)，empty() 为 O(1)
+// 5. intrusive_set 的节点算法与 rb_tree 共用 rb_tree_insert_rebalance、rb_tree_erase_rebalance 等函数
+// 6. 容器不可复制，移动与交换是 O(1)；容器析构或 clear() 时把所有元素的挂钩置为未链接状态
+
+#include <type_traits>
+
+#include "list.h"
+#include "rb_tree.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 由元素中的挂钩成员找回元素
+template <class T, class Hook, Hook T::*Member>
+struct intrusive_member_traits
+{
+  static Hook* to_hook(T& value) noexcept { return &(value.*Member); }
+
+  static T* to_value(Hook* hook) noexcept
+  { return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset()); }
+
+  static const T* to_value(const Hook* hook) noexcept
+  { return reinterpret_cast<const T*>(reinterpret_cast<const char*>(hook) - offset()); }
+
+  // 挂钩在元素中的偏移，借助一块未构造的对齐内存求得
+  static ptrdiff_t offset() noexcept
+  {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+    const T* p = reinterpret_cast<const T*>(&buf);
+    return reinterpret_cast<const char*>(&(p->*Member)) - reinterpret_cast<const char*>(p);
+  }
+};
+
+/*****************************************************************************************/
+
+// intrusive_list 的挂钩
+// 未链接时 prev、next 为 nullptr
+class intrusive_list_hook :public list_node_base<void>
+{
+public:
+  intrusive_list_hook() noexcept { prev = next = nullptr; }
+
+  // 复制元素时挂钩不复制链接状态
+  intrusive_list_hook(const intrusive_list_hook&) noexcept { prev = next = nullptr; }
+  intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept { return *this; }
+
+  ~intrusive_list_hook() { unlink(); }
+
+  bool is_linked() const noexcept { return next != nullptr; }
+
+  // 从所在的链表中断开，O(1)
+  void unlink() noexcept
+  {
+    if (next == nullptr)
+      return;
+    prev->next = next;
+    next->prev = prev;
+    prev = next = nullptr;
+  }
+};
+
+// intrusive_list 的迭代器
+template <class T, intrusive_list_hook T::*Hook, class Ref, class Ptr>
+struct intrusive_list_iterator : public iterator<bidirectional_iterator_tag, T>
+{
+  typedef intrusive_list_iterator<T, Hook, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Hook, const T&, const T*> const_iterator;
+  typedef intrusive_list_iterator                              self;
+
+  typedef T                                                    value_type;
+  typedef Ptr                                                  pointer;
+  typedef Ref                                                  reference;
+  typedef list_node_base<void>*                                base_ptr;
+  typedef intrusive_member_traits<T, intrusive_list_hook, Hook> member_traits;
+
+  base_ptr node_;  // 指向当前挂钩
+
+  intrusive_list_iterator() noexcept :node_(nullptr) {}
+  explicit intrusive_list_iterator(base_ptr x) noexcept :node_(x) {}
+  // 由 iterator 转换为 const_iterator，写成模板以免成为复制构造函数
+  template <class R, class P, typename std::enable_if<
+    std::is_same<intrusive_list_iterator<T, Hook, R, P>, iterator>::value, int>::type = 0>
+  intrusive_list_iterator(const intrusive_list_iterator<T, Hook, R, P>& rhs) noexcept :node_(rhs.node_) {}
+  intrusive_list_iterator(const intrusive_list_iterator&) = default;
+  intrusive_list_iterator& operator=(const intrusive_list_iterator&) = default;
+
+  reference operator*()  const
+  { return *member_traits::to_value(static_cast<intrusive_list_hook*>(node_)); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->next;
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->prev;
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+  bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类 intrusive_list
+// 参数一代表元素类型，参数二代表元素中 intrusive_list_hook 成员的指针
+template <class T, intrusive_list_hook T::*Hook>
+class intrusive_list
+{
+public:
+  typedef T                                                           value_type;
+  typedef T*                                                          pointer;
+  typedef const T*                                                    const_pointer;
+  typedef T&                                                          reference;
+  typedef const T&                                                    const_reference;
+  typedef size_t                                                      size_type;
+  typedef ptrdiff_t                                                   difference_type;
+
+  typedef intrusive_list_iterator<T, Hook, T&, T*>                    iterator;
+  typedef intrusive_list_iterator<T, Hook, const T&, const T*>        const_iterator;
+  typedef mystl::reverse_iterator<iterator>                           reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>                     const_reverse_iterator;
+
+private:
+  typedef list_node_base<void>*                                       base_ptr;
+  typedef intrusive_member_traits<T, intrusive_list_hook, Hook>       member_traits;
+
+  list_node_base<void> node_;  // 哨兵，首尾相连
+
+public:
+  // 构造、移动、析构函数
+  intrusive_list() noexcept { node_.unlink(); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_list(Iter first, Iter last)
+  {
+    node_.unlink();
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  intrusive_list(const intrusive_list&) = delete;
+  intrusive_list& operator=(const intrusive_list&) = delete;
+
+  intrusive_list(intrusive_list&& rhs) noexcept
+  {
+    node_.unlink();
+    swap(rhs);
+  }
+
+  intrusive_list& operator=(intrusive_list&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      swap(rhs);
+    }
+    return *this;
+  }
+
+  ~intrusive_list() { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(node_.next); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(node_.next); }
+  iterator               end()           noexcept
+  { return iterator(&node_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(const_cast<base_ptr>(&node_)); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return node_.next == &node_; }
+
+  size_type size()     const noexcept
+  { return static_cast<size_type>(mystl::distance(begin(), end())); }
+
+  // 访问元素相关操作
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *(--end());
+  }
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return *(--end());
+  }
+
+  // 由元素得到它的迭代器，元素必须在此链表中，O(1)
+  iterator       iterator_to(reference value) noexcept
+  { return iterator(member_traits::to_hook(value)); }
+  const_iterator iterator_to(const_reference value) const noexcept
+  { return const_iterator(member_traits::to_hook(const_cast<reference>(value))); }
+
+  // 修改容器相关操作
+
+  // insert：把 value 链接到 pos 之前，value 必须未链接
+  iterator insert(const_iterator pos, reference value) noexcept
+  {
+    auto hook = member_traits::to_hook(value);
+    MYSTL_DEBUG(!hook->is_linked());
+    base_ptr p = pos.node_;
+    hook->next = p;
+    hook->prev = p->prev;
+    p->prev->next = hook;
+    p->prev = hook;
+    return iterator(hook);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(const_iterator pos, Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      insert(pos, *first);
+  }
+
+  void push_front(reference value) noexcept { insert(begin(), value); }
+  void push_back(reference value)  noexcept { insert(end(), value); }
+
+  void pop_front() noexcept
+  {
+    MYSTL_DEBUG(!empty());
+    erase(begin());
+  }
+  void pop_back() noexcept
+  {
+    MYSTL_DEBUG(!empty());
+    erase(--end());
+  }
+
+  // erase：断开 pos 所指元素的链接，返回下一个位置
+  iterator erase(const_iterator pos) noexcept
+  {
+    MYSTL_DEBUG(pos != cend());
+    base_ptr next = pos.node_->next;
+    static_cast<intrusive_list_hook*>(pos.node_)->unlink();
+    return iterator(next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) noexcept
+  {
+    while (first != last)
+      first = erase(first);
+    return iterator(last.node_);
+  }
+
+  // 断开 value 的链接，value 必须在此链表中，O(1)
+  void     remove(reference value) noexcept
+  {
+    MYSTL_DEBUG(member_traits::to_hook(value)->is_linked());
+    member_traits::to_hook(value)->unlink();
+  }
+
+  template <class UnaryPredicate>
+  void     remove_if(UnaryPredicate pred)
+  {
+    for (auto it = begin(); it != end(); )
+    {
+      if (pred(*it))
+        it = erase(it);
+      else
+        ++it;
+    }
+  }
+
+  void     clear() noexcept;
+
+  // 将 x 的全部或部分元素移到 pos 之前，O(1)
+  void     splice(const_iterator pos, intrusive_list& x) noexcept
+  {
+    if (!x.empty())
+      transfer(pos.node_, x.node_.next, &x.node_);
+  }
+  void     splice(const_iterator pos, intrusive_list&, const_iterator it) noexcept
+  {
+    if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
+      transfer(pos.node_, it.node_, it.node_->next);
+  }
+  void     splice(const_iterator pos, intrusive_list&, const_iterator first,
+                  const_iterator last) noexcept
+  {
+    if (first != last && pos != last)
+      transfer(pos.node_, first.node_, last.node_);
+  }
+
+  void     reverse() noexcept;
+
+  void     swap(intrusive_list& rhs) noexcept;
+
+private:
+  // helper functions
+
+  // 把 [first, last) 移到 pos 之前
+  void transfer(base_ptr pos, base_ptr first, base_ptr last) noexcept
+  {
+    base_ptr tail = last->prev;
+    first->prev->next = last;
+    last->prev = first->prev;
+    tail->next = pos;
+    first->prev = pos->prev;
+    pos->prev->next = first;
+    pos->prev = tail;
+  }
+};
+
+/*****************************************************************************************/
+
+// 断开所有元素的链接
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::clear() noexcept
+{
+  base_ptr cur = node_.next;
+  while (cur != &node_)
+  {
+    base_ptr next = cur->next;
+    cur->prev = cur->next = nullptr;
+    cur = next;
+  }
+  node_.unlink();
+}
+
+// 翻转链表，O(n)
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::reverse() noexcept
+{
+  base_ptr cur = &node_;
+  do
+  {
+    mystl::swap(cur->prev, cur->next);
+    cur = cur->prev;
+  } while (cur != &node_);
+}
+
+// 交换两个链表，哨兵是成员，需要修正首尾元素对它的指向
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::swap(intrusive_list& rhs) noexcept
+{
+  if (this == &rhs)
+    return;
+  mystl::swap(node_.prev, rhs.node_.prev);
+  mystl::swap(node_.next, rhs.node_.next);
+  if (node_.next == &rhs.node_)
+    node_.unlink();
+  else
+    node_.next->prev = node_.prev->next = &node_;
+  if (rhs.node_.next == &node_)
+    rhs.node_.unlink();
+  else
+    rhs.node_.next->prev = rhs.node_.prev->next = &rhs.node_;
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void swap(intrusive_list<T, Hook>& lhs, intrusive_list<T, Hook>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// intrusive_set、intrusive_multiset 的挂钩
+// 未链接时 parent 为 nullptr，链接后至少指向 header
+class intrusive_set_hook :public rb_tree_node_base<void>
+{
+public:
+  intrusive_set_hook() noexcept { reset(); }
+
+  intrusive_set_hook(const intrusive_set_hook&) noexcept { reset(); }
+  intrusive_set_hook& operator=(const intrusive_set_hook&) noexcept { return *this; }
+
+  ~intrusive_set_hook() { unlink(); }
+
+  bool is_linked() const noexcept { return parent != nullptr; }
+
+  // 从所在的树中断开：先上溯找到 header，再删除并调整平衡，O(log n)
+  void unlink() noexcept
+  {
+    if (parent == nullptr)
+      return;
+    base_ptr header = this;
+    while (!(header->parent->parent == header && rb_tree_is_red(header)))
+      header = header->parent;
+    rb_tree_erase_rebalance(static_cast<base_ptr>(this),
+                            header->parent, header->left, header->right);
+    reset();
+  }
+
+  void reset() noexcept
+  {
+    parent = left = right = nullptr;
+    color = rb_tree_red;
+  }
+};
+
+// intrusive_set 的迭代器，前进与后退的方式与 rb_tree_iterator_base 相同
+template <class T, intrusive_set_hook T::*Hook, class Ref, class Ptr>
+struct intrusive_set_iterator : public iterator<bidirectional_iterator_tag, T>
+{
+  typedef intrusive_set_iterator<T, Hook, T&, T*>              iterator;
+  typedef intrusive_set_iterator<T, Hook, const T&, const T*>  const_iterator;
+  typedef intrusive_set_iterator                               self;
+
+  typedef T                                                    value_type;
+  typedef Ptr                                                  pointer;
+  typedef Ref                                                  reference;
+  typedef rb_tree_node_base<void>*                             base_ptr;
+  typedef intrusive_member_traits<T, intrusive_set_hook, Hook> member_traits;
+
+  base_ptr node_;  // 指向当前挂钩
+
+  intrusive_set_iterator() noexcept :node_(nullptr) {}
+  explicit intrusive_set_iterator(base_ptr x) noexcept :node_(x) {}
+  // 由 iterator 转换为 const_iterator，写成模板以免成为复制构造函数
+  template <class R, class P, typename std::enable_if<
+    std::is_same<intrusive_set_iterator<T, Hook, R, P>, iterator>::value, int>::type = 0>
+  intrusive_set_iterator(const intrusive_set_iterator<T, Hook, R, P>& rhs) noexcept :node_(rhs.node_) {}
+  intrusive_set_iterator(const intrusive_set_iterator&) = default;
+  intrusive_set_iterator& operator=(const intrusive_set_iterator&) = default;
+
+  reference operator*()  const
+  { return *member_traits::to_value(static_cast<intrusive_set_hook*>(node_)); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    if (node_->right != nullptr)
+    {
+      node_ = rb_tree_min(node_->right);
+    }
+    else
+    {
+      auto y = node_->parent;
+      while (y->right == node_)
+      {
+        node_ = y;
+        y = y->parent;
+      }
+      if (node_->right != y)
+        node_ = y;
+    }
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    if (node_->parent->parent == node_ && rb_tree_is_red(node_))
+    { // header
+      node_ = node_->right;
+    }
+    else if (node_->left != nullptr)
+    {
+      node_ = rb_tree_max(node_->left);
+    }
+    else
+    {
+      auto y = node_->parent;
+      while (node_ == y->left)
+      {
+        node_ = y;
+        y = y->parent;
+      }
+      node_ = y;
+    }
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+  bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类 intrusive_rb_tree，intrusive_set 与 intrusive_multiset 的底层实现
+// 参数一代表元素类型，参数二代表元素中 intrusive_set_hook 成员的指针，参数三代表比较方式
+// 查找函数接受任意键类型 K，只要 Compare 能比较 T 与 K
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+class intrusive_rb_tree
+{
+public:
+  typedef T                                                       value_type;
+  typedef T                                                       key_type;
+  typedef Compare                                                 key_compare;
+  typedef Compare                                                 value_compare;
+  typedef T*                                                      pointer;
+  typedef const T*                                                const_pointer;
+  typedef T&                                                      reference;
+  typedef const T&                                                const_reference;
+  typedef size_t                                                  size_type;
+  typedef ptrdiff_t                                               difference_type;
+
+  typedef intrusive_set_iterator<T, Hook, T&, T*>                 iterator;
+  typedef intrusive_set_iterator<T, Hook, const T&, const T*>     const_iterator;
+  typedef mystl::reverse_iterator<iterator>                       reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>                 const_reverse_iterator;
+
+private:
+  typedef rb_tree_node_base<void>*                                base_ptr;
+  typedef intrusive_member_traits<T, intrusive_set_hook, Hook>    member_traits;
+
+  rb_tree_node_base<void> header_;  // 特殊节点，与根节点互为对方的父节点
+  key_compare             comp_;
+
+  base_ptr& root()      const { return const_cast<base_ptr&>(header_.parent); }
+  base_ptr& leftmost()  const { return const_cast<base_ptr&>(header_.left); }
+  base_ptr& rightmost() const { return const_cast<base_ptr&>(header_.right); }
+  base_ptr  header()    const { return const_cast<base_ptr>(&header_); }
+
+  const T&  value(base_ptr x) const
+  { return *member_traits::to_value(static_cast<intrusive_set_hook*>(x)); }
+
+public:
+  // 构造、移动、析构函数
+  explicit intrusive_rb_tree(const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    reset();
+  }
+
+  intrusive_rb_tree(const intrusive_rb_tree&) = delete;
+  intrusive_rb_tree& operator=(const intrusive_rb_tree&) = delete;
+
+  intrusive_rb_tree(intrusive_rb_tree&& rhs) noexcept
+    :comp_(mystl::move(rhs.comp_))
+  {
+    reset();
+    swap(rhs);
+  }
+
+  intrusive_rb_tree& operator=(intrusive_rb_tree&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      swap(rhs);
+    }
+    return *this;
+  }
+
+  ~intrusive_rb_tree() { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(leftmost()); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(leftmost()); }
+  iterator               end()           noexcept
+  { return iterator(header()); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(header()); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return root() == nullptr; }
+  size_type size()     const noexcept
+  { return static_cast<size_type>(mystl::distance(begin(), end())); }
+
+  key_compare key_comp() const { return comp_; }
+
+  // 由元素得到它的迭代器，元素必须在此树中，O(1)
+  iterator       iterator_to(reference value) noexcept
+  { return iterator(member_traits::to_hook(value)); }
+  const_iterator iterator_to(const_reference value) const noexcept
+  { return const_iterator(member_traits::to_hook(const_cast<reference>(value))); }
+
+  // 插入删除相关操作，被插入的元素必须未链接
+  iterator                   insert_multi(reference value) noexcept;
+  mystl::pair<iterator, bool> insert_unique(reference value) noexcept;
+
+  iterator  erase(const_iterator pos) noexcept
+  {
+    MYSTL_DEBUG(pos != cend());
+    iterator next(pos.node_);
+    ++next;
+    static_cast<intrusive_set_hook*>(pos.node_)->unlink();
+    return next;
+  }
+
+  iterator  erase(const_iterator first, const_iterator last) noexcept
+  {
+    if (first == cbegin() && last == cend())
+    {
+      clear();
+      return end();
+    }
+    while (first != last)
+      first = erase(first);
+    return iterator(last.node_);
+  }
+
+  template <class K>
+  size_type erase_key(const K& key) noexcept
+  {
+    auto p = equal_range(key);
+    size_type n = 0;
+    for (auto it = p.first; it != p.second; ++n)
+      it = erase(it);
+    return n;
+  }
+
+  // 断开 value 的链接，value 必须在此树中
+  void      remove(reference value) noexcept
+  {
+    MYSTL_DEBUG(member_traits::to_hook(value)->is_linked());
+    member_traits::to_hook(value)->unlink();
+  }
+
+  void      clear() noexcept;
+
+  // 查找相关操作
+  template <class K>
+  iterator       find(const K& key)
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, *it)) ? it : end();
+  }
+  template <class K>
+  const_iterator find(const K& key) const
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, *it)) ? it : end();
+  }
+
+  template <class K>
+  size_type      count(const K& key) const
+  {
+    auto p = equal_range(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+
+  template <class K>
+  bool           contains(const K& key) const
+  { return find(key) != end(); }
+
+  template <class K>
+  iterator       lower_bound(const K& key)
+  { return iterator(M_lower_bound(key)); }
+  template <class K>
+  const_iterator lower_bound(const K& key) const
+  { return const_iterator(M_lower_bound(key)); }
+
+  template <class K>
+  iterator       upper_bound(const K& key)
+  { return iterator(M_upper_bound(key)); }
+  template <class K>
+  const_iterator upper_bound(const K& key) const
+  { return const_iterator(M_upper_bound(key)); }
+
+  template <class K>
+  mystl::pair<iterator, iterator>
+  equal_range(const K& key)
+  { return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key)); }
+  template <class K>
+  mystl::pair<const_iterator, const_iterator>
+  equal_range(const K& key) const
+  { return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key)); }
+
+  void swap(intrusive_rb_tree& rhs) noexcept;
+
+private:
+  // helper functions
+  void reset() noexcept
+  {
+    header_.color = rb_tree_red;
+    root() = nullptr;
+    leftmost() = rightmost() = header();
+  }
+
+  template <class K>
+  base_ptr M_lower_bound(const K& key) const
+  {
+    auto y = header();
+    auto x = root();
+    while (x != nullptr)
+    {
+      if (!comp_(value(x), key))
+      {
+        y = x;
+        x = x->left;
+      }
+      else
+      {
+        x = x->right;
+      }
+    }
+    return y;
+  }
+
+  template <class K>
+  base_ptr M_upper_bound(const K& key) const
+  {
+    auto y = header();
+    auto x = root();
+    while (x != nullptr)
+    {
+      if (comp_(key, value(x)))
+      {
+        y = x;
+        x = x->left;
+      }
+      else
+      {
+        x = x->right;
+      }
+    }
+    return y;
+  }
+
+  void link_at(base_ptr x, base_ptr node, bool add_to_left) noexcept;
+  void unlink_subtree(base_ptr x) noexcept;
+};
+
+/*****************************************************************************************/
+
+// 插入元素，键值允许重复
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+typename intrusive_rb_tree<T, Hook, Compare>::iterator
+intrusive_rb_tree<T, Hook, Compare>::
+insert_multi(reference v) noexcept
+{
+  base_ptr node = member_traits::to_hook(v);
+  MYSTL_DEBUG(node->parent == nullptr);
+  auto y = header();
+  auto x = root();
+  bool add_to_left = true;
+  while (x != nullptr)
+  {
+    y = x;
+    add_to_left = comp_(v, value(x));
+    x = add_to_left ? x->left : x->right;
+  }
+  link_at(y, node, add_to_left);
+  return iterator(node);
+}
+
+// 插入元素，键值不允许重复，已有相等的元素时不插入并返回它的位置
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+mystl::pair<typename intrusive_rb_tree<T, Hook, Compare>::iterator, bool>
+intrusive_rb_tree<T, Hook, Compare>::
+insert_unique(reference v) noexcept
+{
+  base_ptr node = member_traits::to_hook(v);
+  MYSTL_DEBUG(node->parent == nullptr);
+  auto y = header();
+  auto x = root();
+  bool add_to_left = true;
+  while (x != nullptr)
+  {
+    y = x;
+    add_to_left = comp_(v, value(x));
+    x = add_to_left ? x->left : x->right;
+  }
+  iterator j(y);
+  if (add_to_left)
+  {
+    if (y == header() || j == begin())
+    {
+      link_at(y, node, true);
+      return mystl::make_pair(iterator(node), true);
+    }
+    --j;
+  }
+  if (comp_(*j, v))
+  {
+    link_at(y, node, add_to_left);
+    return mystl::make_pair(iterator(node), true);
+  }
+  return mystl::make_pair(j, false);
+}
+
+// 把 node 链接为 x 的子节点，并维护 root、leftmost、rightmost
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void intrusive_rb_tree<T, Hook, Compare>::
+link_at(base_ptr x, base_ptr node, bool add_to_left) noexcept
+{
+  node->parent = x;
+  node->left = node->right = nullptr;
+  node->color = rb_tree_red;
+  if (x == header())
+  {
+    root() = node;
+    leftmost() = node;
+    rightmost() = node;
+  }
+  else if (add_to_left)
+  {
+    x->left = node;
+    if (leftmost() == x)
+      leftmost() = node;
+  }
+  else
+  {
+    x->right = node;
+    if (rightmost() == x)
+      rightmost() = node;
+  }
+  rb_tree_insert_rebalance(node, root());
+}
+
+// 断开所有元素的链接，O(n)
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void intrusive_rb_tree<T, Hook, Compare>::clear() noexcept
+{
+  if (root() != nullptr)
+    unlink_subtree(root());
+  reset();
+}
+
+// 把以 x 为根的子树中的挂钩全部置为未链接状态，右子树递归、左子树迭代
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void intrusive_rb_tree<T, Hook, Compare>::unlink_subtree(base_ptr x) noexcept
+{
+  while (x != nullptr)
+  {
+    unlink_subtree(x->right);
+    auto y = x->left;
+    static_cast<intrusive_set_hook*>(x)->reset();
+    x = y;
+  }
+}
+
+// 交换两棵树，header 是成员，需要修正根节点对它的指向
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void intrusive_rb_tree<T, Hook, Compare>::swap(intrusive_rb_tree& rhs) noexcept
+{
+  if (this == &rhs)
+    return;
+  mystl::swap(root(), rhs.root());
+  mystl::swap(leftmost(), rhs.leftmost());
+  mystl::swap(rightmost(), rhs.rightmost());
+  mystl::swap(comp_, rhs.comp_);
+  if (root() == nullptr)
+    reset();
+  else
+    root()->parent = header();
+  if (rhs.root() == nullptr)
+    rhs.reset();
+  else
+    rhs.root()->parent = rhs.header();
+}
+
+/*****************************************************************************************/
+
+// 模板类 intrusive_set，键值不允许重复
+template <class T, intrusive_set_hook T::*Hook, class Compare = mystl::less<T>>
+class intrusive_set :public intrusive_rb_tree<T, Hook, Compare>
+{
+  typedef intrusive_rb_tree<T, Hook, Compare> base_type;
+
+public:
+  typedef typename base_type::iterator        iterator;
+  typedef typename base_type::const_iterator  const_iterator;
+  typedef typename base_type::size_type       size_type;
+
+  intrusive_set() = default;
+  explicit intrusive_set(const Compare& comp) :base_type(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_set(Iter first, Iter last, const Compare& comp = Compare())
+    :base_type(comp)
+  {
+    insert(first, last);
+  }
+
+  intrusive_set(intrusive_set&&) = default;
+  intrusive_set& operator=(intrusive_set&&) = default;
+
+  mystl::pair<iterator, bool> insert(T& value) noexcept
+  { return base_type::insert_unique(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      base_type::insert_unique(*first);
+  }
+
+  iterator  erase(const_iterator pos) noexcept
+  { return base_type::erase(pos); }
+  iterator  erase(const_iterator first, const_iterator last) noexcept
+  { return base_type::erase(first, last); }
+  size_type erase(const T& key) noexcept
+  { return base_type::erase_key(key); }
+
+  void swap(intrusive_set& rhs) noexcept { base_type::swap(rhs); }
+};
+
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void swap(intrusive_set<T, Hook, Compare>& lhs, intrusive_set<T, Hook, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 模板类 intrusive_multiset，键值允许重复
+template <class T, intrusive_set_hook T::*Hook, class Compare = mystl::less<T>>
+class intrusive_multiset :public intrusive_rb_tree<T, Hook, Compare>
+{
+  typedef intrusive_rb_tree<T, Hook, Compare> base_type;
+
+public:
+  typedef typename base_type::iterator        iterator;
+  typedef typename base_type::const_iterator  const_iterator;
+  typedef typename base_type::size_type       size_type;
+
+  intrusive_multiset() = default;
+  explicit intrusive_multiset(const Compare& comp) :base_type(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_multiset(Iter first, Iter last, const Compare& comp = Compare())
+    :base_type(comp)
+  {
+    insert(first, last);
+  }
+
+  intrusive_multiset(intrusive_multiset&&) = default;
+  intrusive_multiset& operator=(intrusive_multiset&&) = default;
+
+  iterator insert(T& value) noexcept
+  { return base_type::insert_multi(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      base_type::insert_multi(*first);
+  }
+
+  iterator  erase(const_iterator pos) noexcept
+  { return base_type::erase(pos); }
+  iterator  erase(const_iterator first, const_iterator last) noexcept
+  { return base_type::erase(first, last); }
+  size_type erase(const T& key) noexcept
+  { return base_type::erase_key(key); }
+
+  void swap(intrusive_multiset& rhs) noexcept { base_type::swap(rhs); }
+};
+
+template <class T, intrusive_set_hook T::*Hook, class Compare>
+void swap(intrusive_multiset<T, Hook, Compare>& lhs,
+          intrusive_multiset<T, Hook, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_H_
+
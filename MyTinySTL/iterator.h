@@ -224,6 +224,26 @@ void advance(InputIterator& i, Distance n)
 
 /*****************************************************************************************/
 
+// 模板类 : segmented_iterator_traits
+// 分段迭代器萃取：迭代器所指的序列由若干段连续内存组成（如 deque 的各个缓冲区）
+// 容器为自己的迭代器特化它，copy / fill / find 等算法据此逐段处理，每段退化为指针区间
+// 特化版本需提供：
+//   segment_iterator / local_iterator : 段迭代器与段内（指针）迭代器
+//   segment(it) / local(it)           : 取得 it 所在的段与段内位置
+//   begin(seg) / end(seg)             : 段的首尾
+//   compose(seg, local)               : 由段与段内位置合成迭代器，local 不能是段尾
+template <class Iterator>
+struct segmented_iterator_traits
+{
+  static constexpr bool is_segmented = false;
+};
+
+template <class Iterator>
+struct is_segmented_iterator
+  : public m_bool_constant<segmented_iterator_traits<Iterator>::is_segmented> {};
+
+/*****************************************************************************************/
+
 // 模板类 : reverse_iterator
 // 代表反向迭代器，使前进为后退，后退为前进
 template <class Iterator>
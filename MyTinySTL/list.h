@@ -205,24 +205,32 @@ struct list_const_iterator : public iterator<bidirectional_iterator_tag, T>
 };
 
 // 模板类: list
-// 模板参数 T 代表数据类型
-template <class T>
+// 模板参数 T 代表数据类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
 class list
+  :private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>>>
 {
 public:
   // list 的嵌套型别定义
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<list_node_base<T>>      base_allocator;
-  typedef mystl::allocator<list_node<T>>           node_allocator;
-
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node_base<T>>
+                                                   base_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>>
+                                                   node_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+  typedef mystl::allocator_traits<base_allocator>  base_traits;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
 
   typedef list_iterator<T>                         iterator;
   typedef list_const_iterator<T>                   const_iterator;
@@ -232,9 +240,12 @@ public:
   typedef typename node_traits<T>::base_ptr        base_ptr;
   typedef typename node_traits<T>::node_ptr        node_ptr;
 
-  allocator_type get_allocator() { return node_allocator(); }
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
 
 private:
+  typedef mystl::alloc_holder<node_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
   base_ptr  node_;  // 指向末尾节点
   size_type size_;  // 大小
 
@@ -243,49 +254,87 @@ public:
   list() 
   { fill_init(0, value_type()); }
 
-  explicit list(size_type n) 
+  explicit list(const allocator_type& alloc)
+    :alloc_base(node_allocator(alloc))
+  { fill_init(0, value_type()); }
+
+  explicit list(size_type n, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc))
   { fill_init(n, value_type()); }
 
-  list(size_type n, const T& value)
+  list(size_type n, const T& value, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc))
   { fill_init(n, value); }
 
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
-  list(Iter first, Iter last)
+  list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc))
   { copy_init(first, last); }
 
-  list(std::initializer_list<T> ilist)
+  list(std::initializer_list<T> ilist, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc))
   { copy_init(ilist.begin(), ilist.end()); }
 
   list(const list& rhs)
+    :alloc_base(node_alloc_traits::select_on_container_copy_construction(rhs.M_alloc()))
+  { copy_init(rhs.cbegin(), rhs.cend()); }
+
+  list(const list& rhs, const allocator_type& alloc)
+    :alloc_base(node_allocator(alloc))
   { copy_init(rhs.cbegin(), rhs.cend()); }
 
   list(list&& rhs) noexcept
-    :node_(rhs.node_), size_(rhs.size_)
+    :alloc_base(mystl::move(rhs.M_alloc())), node_(rhs.node_), size_(rhs.size_)
   {
     rhs.node_ = nullptr;
     rhs.size_ = 0;
   }
 
+  // 分配器不相等时逐个移动元素
+  list(list&& rhs, const allocator_type& alloc)
+    :alloc_base(node_allocator(alloc))
+  {
+    fill_init(0, value_type());
+    move_assign(rhs, m_false_type());
+  }
+
   list& operator=(const list& rhs)
   {
     if (this != &rhs)
     {
+      if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+          !node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+      { // 旧的节点必须由旧的分配器释放
+        clear();
+        destroy_base(node_);
+        node_ = nullptr;
+        mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(), m_true_type());
+        fill_init(0, value_type());
+      }
+      if (node_ == nullptr)  // 被移动过的 list
+        fill_init(0, value_type());
       assign(rhs.begin(), rhs.end());
     }
     return *this;
   }
 
-  list& operator=(list&& rhs) noexcept
+  list& operator=(list&& rhs)
+    noexcept(node_alloc_traits::propagate_on_container_move_assignment::value ||
+             node_alloc_traits::is_always_equal::value)
   {
-    clear();
-    splice(end(), rhs);
+    if (this != &rhs)
+    {
+      move_assign(rhs, m_bool_constant<
+                  node_alloc_traits::propagate_on_container_move_assignment::value ||
+                  node_alloc_traits::is_always_equal::value>());
+    }
     return *this;
   }
 
   list& operator=(std::initializer_list<T> ilist)
   {
-    list tmp(ilist.begin(), ilist.end());
+    list tmp(ilist.begin(), ilist.end(), M_alloc());
     swap(tmp);
     return *this;
   }
@@ -294,8 +343,11 @@ public:
   {
     if (node_)
     {
-      clear();
-      base_allocator::deallocate(node_);
+      if (!release_nodes())
+      {
+        clear();
+        destroy_base(node_);
+      }
       node_ = nullptr;
       size_ = 0;
     }
@@ -338,7 +390,7 @@ public:
   { return size_; }
 
   size_type max_size() const noexcept 
-  { return static_cast<size_type>(-1); }
+  { return node_alloc_traits::max_size(M_alloc()); }
 
   // 访问元素相关操作
   reference       front() 
@@ -503,10 +555,14 @@ public:
   void     resize(size_type new_size) { resize(new_size, value_type()); }
   void     resize(size_type new_size, const value_type& value);
 
+  // 分配器不随之交换时，两者的分配器必须相等
   void     swap(list& rhs) noexcept
   {
-    mystl::swap(node_, rhs.node_);
-    mystl::swap(size_, rhs.size_);
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename node_alloc_traits::propagate_on_container_swap());
+    swap_impl(rhs);
   }
 
   // list 相关操作
@@ -531,10 +587,10 @@ public:
   void merge(list& x, Compare comp);
 
   void sort()
-  { list_sort(begin(), end(), size(), mystl::less<T>()); }
+  { list_sort(mystl::less<T>()); }
   template <class Compared>
   void sort(Compared comp)
-  { list_sort(begin(), end(), size(), comp); }
+  { list_sort(comp); }
 
   void reverse();
 
@@ -545,6 +601,24 @@ private:
   template <class ...Args>
   node_ptr create_node(Args&& ...agrs);
   void     destroy_node(node_ptr p);
+  base_ptr create_base();
+  void     destroy_base(base_ptr p);
+
+  // 元素可以平凡析构且分配器只被本容器使用时，一次归还全部节点（包括哨兵节点）
+  bool     release_nodes() noexcept
+  {
+    return std::is_trivially_destructible<T>::value &&
+      alloc_release_traits<node_allocator>::release_if_unique(M_alloc());
+  }
+
+  // move / swap
+  void     move_assign(list& rhs, m_true_type) noexcept;
+  void     move_assign(list& rhs, m_false_type);
+  void     swap_impl(list& rhs) noexcept
+  {
+    mystl::swap(node_, rhs.node_);
+    mystl::swap(size_, rhs.size_);
+  }
 
   // initialize
   void      fill_init(size_type n, const value_type& value);
@@ -570,16 +644,22 @@ private:
 
   // sort
   template <class Compared>
-  iterator  list_sort(iterator first, iterator last, size_type n, Compared comp);
+  void      list_sort(Compared comp);
+  template <class Compared>
+  static base_ptr take_run(base_ptr& input, Compared& comp);
+  template <class Compared>
+  static void     merge_nodes(base_ptr& a, base_ptr& b, Compared& comp);
+  static base_ptr concat_nodes(base_ptr a, base_ptr b) noexcept;
+  void            relink_nodes(base_ptr first) noexcept;
 
 };
 
 /*****************************************************************************************/
 
 // 删除 pos 处的元素
-template <class T>
-typename list<T>::iterator 
-list<T>::erase(const_iterator pos)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos != cend());
   auto n = pos.node_;
@@ -591,9 +671,9 @@ list<T>::erase(const_iterator pos)
 }
 
 // 删除 [first, last) 内的元素
-template <class T>
-typename list<T>::iterator 
-list<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator first, const_iterator last)
 {
   if (first != last)
   {
@@ -610,11 +690,18 @@ list<T>::erase(const_iterator first, const_iterator last)
 }
 
 // 清空 list
-template <class T>
-void list<T>::clear()
+template <class T, class Alloc>
+void list<T, Alloc>::clear()
 {
   if (size_ != 0)
   {
+    if (release_nodes())
+    { // 分配器保留了最新的一块内存，重新创建哨兵节点不会失败
+      node_ = create_base();
+      node_->unlink();
+      size_ = 0;
+      return;
+    }
     auto cur = node_->next;
     for (base_ptr next = cur->next; cur != node_; cur = next, next = cur->next)
     {
@@ -626,8 +713,8 @@ void list<T>::clear()
 }
 
 // 重置容器大小
-template <class T>
-void list<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::resize(size_type new_size, const value_type& value)
 {
   auto i = begin();
   size_type len = 0;
@@ -647,8 +734,8 @@ void list<T>::resize(size_type new_size, const value_type& value)
 }
 
 // 将 list x 接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x)
 {
   MYSTL_DEBUG(this != &x);
   if (!x.empty())
@@ -667,8 +754,8 @@ void list<T>::splice(const_iterator pos, list& x)
 }
 
 // 将 it 所指的节点接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x, const_iterator it)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator it)
 {
   if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
   {
@@ -685,8 +772,8 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator it)
 }
 
 // 将 list x 的 [first, last) 内的节点接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x, const_iterator first, const_iterator last)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator first, const_iterator last)
 {
   if (first != last && this != &x)
   {
@@ -704,9 +791,9 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator first, const_it
 }
 
 // 将另一元操作 pred 为 true 的所有元素移除
-template <class T>
+template <class T, class Alloc>
 template <class UnaryPredicate>
-void list<T>::remove_if(UnaryPredicate pred)
+void list<T, Alloc>::remove_if(UnaryPredicate pred)
 {
   auto f = begin();
   auto l = end();
@@ -721,9 +808,9 @@ void list<T>::remove_if(UnaryPredicate pred)
 }
 
 // 移除 list 中满足 pred 为 true 重复元素
-template <class T>
+template <class T, class Alloc>
 template <class BinaryPredicate>
-void list<T>::unique(BinaryPredicate pred)
+void list<T, Alloc>::unique(BinaryPredicate pred)
 {
   auto i = begin();
   auto e = end();
@@ -745,9 +832,9 @@ void list<T>::unique(BinaryPredicate pred)
 }
 
 // 与另一个 list 合并，按照 comp 为 true 的顺序
-template <class T>
+template <class T, class Alloc>
 template <class Compare>
-void list<T>::merge(list& x, Compare comp)
+void list<T, Alloc>::merge(list& x, Compare comp)
 {
   if (this != &x)
   {
@@ -796,8 +883,8 @@ void list<T>::merge(list& x, Compare comp)
 }
 
 // 将 list 反转
-template <class T>
-void list<T>::reverse()
+template <class T, class Alloc>
+void list<T, Alloc>::reverse()
 {
   if (size_ <= 1)
   {
@@ -817,39 +904,95 @@ void list<T>::reverse()
 // helper function
 
 // 创建结点
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-typename list<T>::node_ptr 
-list<T>::create_node(Args&& ...args)
+typename list<T, Alloc>::node_ptr 
+list<T, Alloc>::create_node(Args&& ...args)
 {
-  node_ptr p = node_allocator::allocate(1);
+  node_ptr p = node_alloc_traits::allocate(M_alloc(), 1);
   try
   {
-    data_allocator::construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(M_alloc(), mystl::address_of(p->value),
+                                mystl::forward<Args>(args)...);
     p->prev = nullptr;
     p->next = nullptr;
   }
   catch (...)
   {
-    node_allocator::deallocate(p);
+    node_alloc_traits::deallocate(M_alloc(), p, 1);
     throw;
   }
   return p;
 }
 
 // 销毁结点
-template <class T>
-void list<T>::destroy_node(node_ptr p)
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_node(node_ptr p)
+{
+  node_alloc_traits::destroy(M_alloc(), mystl::address_of(p->value));
+  node_alloc_traits::deallocate(M_alloc(), p, 1);
+}
+
+// 创建与销毁哨兵结点，哨兵结点不含元素，由重新绑定的分配器管理
+template <class T, class Alloc>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::create_base()
 {
-  data_allocator::destroy(mystl::address_of(p->value));
-  node_allocator::deallocate(p);
+  base_allocator ba(M_alloc());
+  return base_traits::allocate(ba, 1);
+}
+
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_base(base_ptr p)
+{
+  base_allocator ba(M_alloc());
+  base_traits::deallocate(ba, p, 1);
+}
+
+// move_assign 函数
+// 可以接管 rhs 的节点：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_true_type) noexcept
+{
+  clear();
+  if (node_ == nullptr || !node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  { // 旧的哨兵节点必须由旧的分配器释放，再接管 rhs 的哨兵节点
+    if (node_ != nullptr)
+      destroy_base(node_);
+    mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                             typename node_alloc_traits::propagate_on_container_move_assignment());
+    node_ = rhs.node_;
+    size_ = rhs.size_;
+    rhs.node_ = nullptr;
+    rhs.size_ = 0;
+    return;
+  }
+  if (rhs.node_ != nullptr)
+    splice(end(), rhs);
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_false_type)
+{
+  if (node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  if (rhs.node_ == nullptr)
+    return;
+  for (auto it = rhs.begin(); it != rhs.end(); ++it)
+    emplace_back(mystl::move(*it));
+  rhs.clear();
 }
 
 // 用 n 个元素初始化容器
-template <class T>
-void list<T>::fill_init(size_type n, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::fill_init(size_type n, const value_type& value)
 {
-  node_ = base_allocator::allocate(1);
+  node_ = create_base();
   node_->unlink();
   size_ = n;
   try
@@ -863,18 +1006,18 @@ void list<T>::fill_init(size_type n, const value_type& value)
   catch (...)
   {
     clear();
-    base_allocator::deallocate(node_);
+    destroy_base(node_);
     node_ = nullptr;
     throw;
   }
 }
 
 // 以 [first, last) 初始化容器
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_init(Iter first, Iter last)
+void list<T, Alloc>::copy_init(Iter first, Iter last)
 {
-  node_ = base_allocator::allocate(1);
+  node_ = create_base();
   node_->unlink();
   size_type n = mystl::distance(first, last);
   size_ = n;
@@ -889,16 +1032,16 @@ void list<T>::copy_init(Iter first, Iter last)
   catch (...)
   {
     clear();
-    base_allocator::deallocate(node_);
+    destroy_base(node_);
     node_ = nullptr;
     throw;
   }
 }
 
 // 在 pos 处连接一个节点
-template <class T>
-typename list<T>::iterator 
-list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::link_iter_node(const_iterator pos, base_ptr link_node)
 {
   if (pos == node_->next)
   {
@@ -916,8 +1059,8 @@ list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
 }
 
 // 在 pos 处连接 [first, last] 的结点
-template <class T>
-void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
 {
   pos->prev->next = first;
   first->prev = pos->prev;
@@ -926,8 +1069,8 @@ void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
 }
 
 // 在头部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_front(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last)
 {
   first->prev = node_;
   last->next = node_->next;
@@ -936,8 +1079,8 @@ void list<T>::link_nodes_at_front(base_ptr first, base_ptr last)
 }
 
 // 在尾部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last)
 {
   last->next = node_;
   first->prev = node_->prev;
@@ -946,16 +1089,16 @@ void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
 }
 
 // 容器与 [first, last] 结点断开连接
-template <class T>
-void list<T>::unlink_nodes(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last)
 {
   first->prev->next = last->next;
   last->next->prev = first->prev;
 }
 
 // 用 n 个元素为容器赋值
-template <class T>
-void list<T>::fill_assign(size_type n, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::fill_assign(size_type n, const value_type& value)
 {
   auto i = begin();
   auto e = end();
@@ -974,9 +1117,9 @@ void list<T>::fill_assign(size_type n, const value_type& value)
 }
 
 // 复制[f2, l2)为容器赋值
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_assign(Iter f2, Iter l2)
+void list<T, Alloc>::copy_assign(Iter f2, Iter l2)
 {
   auto f1 = begin();
   auto l1 = end();
@@ -995,9 +1138,9 @@ void list<T>::copy_assign(Iter f2, Iter l2)
 }
 
 // 在 pos 处插入 n 个元素
-template <class T>
-typename list<T>::iterator 
-list<T>::fill_insert(const_iterator pos, size_type n, const value_type& value)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::fill_insert(const_iterator pos, size_type n, const value_type& value)
 {
   iterator r(pos.node_);
   if (n != 0)
@@ -1037,10 +1180,10 @@ list<T>::fill_insert(const_iterator pos, size_type n, const value_type& value)
 }
 
 // 在 pos 处插入 [first, last) 的元素
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-typename list<T>::iterator 
-list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::copy_insert(const_iterator pos, size_type n, Iter first)
 {
   iterator r(pos.node_);
   if (n != 0)
@@ -1078,86 +1221,179 @@ list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
   return r;
 }
 
-// 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
-template <class T>
+// 对 list 进行自底向上的归并排序
+// 排序时只维护 next 指针，每次从输入中取出一段有序的节点，
+// 像二进制计数器一样合并到 buckets 中，buckets[i] 为空或者是 2^i 段合并的结果，
+// 最后合并所有 buckets 并一次性恢复 prev 指针
+// comp 抛出异常时所有节点仍然在 list 中，但顺序未指定
+template <class T, class Alloc>
 template <class Compared>
-typename list<T>::iterator 
-list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+void list<T, Alloc>::list_sort(Compared comp)
 {
-  if (n < 2)
-    return f1;
-
-  if (n == 2)
+  if (size_ < 2)
+    return;
+  constexpr size_t kBuckets = 64;
+  base_ptr buckets[kBuckets] = {};
+  base_ptr input = node_->next;
+  base_ptr carry = nullptr;
+  node_->prev->next = nullptr;
+  try
   {
-    if (comp(*--l2, *f1))
+    while (input != nullptr)
     {
-      auto ln = l2.node_;
-      unlink_nodes(ln, ln);
-      link_nodes(f1.node_, ln, ln);
-      return l2;
+      carry = take_run(input, comp);
+      size_t i = 0;
+      for (; buckets[i] != nullptr && i + 1 < kBuckets; ++i)
+      {
+        merge_nodes(buckets[i], carry, comp);
+        carry = buckets[i];
+        buckets[i] = nullptr;
+      }
+      if (buckets[i] != nullptr)
+        merge_nodes(buckets[i], carry, comp);
+      else
+        buckets[i] = carry;
+      carry = nullptr;
+    }
+    // 序号小的 bucket 中的节点在原序列中靠后
+    for (size_t i = 0; i < kBuckets; ++i)
+    {
+      if (buckets[i] != nullptr)
+      {
+        merge_nodes(buckets[i], carry, comp);
+        carry = buckets[i];
+        buckets[i] = nullptr;
+      }
     }
-    return f1;
-  }
-
-  auto n2 = n / 2;
-  auto l1 = f1;
-  mystl::advance(l1, n2);
-  auto result = f1 = list_sort(f1, l1, n2, comp);  // 前半段的最小位置
-  auto f2 = l1 = list_sort(l1, l2, n - n2, comp);  // 后半段的最小位置
-
-  // 把较小的一段区间移到前面
-  if (comp(*f2, *f1))
-  {
-    auto m = f2;
-    ++m;
-    for (; m != l2 && comp(*m, *f1); ++m)
-      ;
-    auto f = f2.node_;
-    auto l = m.node_->prev;
-    result = f2;
-    l1 = f2 = m;
-    unlink_nodes(f, l);
-    m = f1;
-    ++m;
-    link_nodes(f1.node_, f, l);
-    f1 = m;
   }
-  else
+  catch (...)
   {
-    ++f1;
+    carry = concat_nodes(carry, input);
+    for (size_t i = 0; i < kBuckets; ++i)
+      carry = concat_nodes(carry, buckets[i]);
+    relink_nodes(carry);
+    throw;
   }
+  relink_nodes(carry);
+}
 
-  // 合并两段有序区间
-  while (f1 != l1 && f2 != l2)
+// 从 input 中取出一段有序的节点，严格递减的一段会被反转
+template <class T, class Alloc>
+template <class Compared>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::take_run(base_ptr& input, Compared& comp)
+{
+  base_ptr head = input;
+  base_ptr cur = head;
+  base_ptr next = cur->next;
+  if (next != nullptr && comp(next->as_node()->value, cur->as_node()->value))
   {
-    if (comp(*f2, *f1))
+    do
     {
-      auto m = f2;
-      ++m;
-      for (; m != l2 && comp(*m, *f1); ++m)
-        ;
-      auto f = f2.node_;
-      auto l = m.node_->prev;
-      if (l1 == f2)
-        l1 = m;
-      f2 = m;
-      unlink_nodes(f, l);
-      m = f1;
-      ++m;
-      link_nodes(f1.node_, f, l);
-      f1 = m;
+      cur = next;
+      next = next->next;
+    } while (next != nullptr && comp(next->as_node()->value, cur->as_node()->value));
+    input = next;
+    cur->next = nullptr;
+    base_ptr prev = nullptr;
+    while (head != nullptr)
+    {
+      next = head->next;
+      head->next = prev;
+      prev = head;
+      head = next;
     }
-    else
+    return prev;
+  }
+  while (next != nullptr && !comp(next->as_node()->value, cur->as_node()->value))
+  {
+    cur = next;
+    next = next->next;
+  }
+  input = next;
+  cur->next = nullptr;
+  return head;
+}
+
+// 合并两段以 nullptr 结尾的有序节点，结果保存在 a 中，相等时 a 中的节点在前
+// comp 抛出异常时所有节点都连接到 a 中
+template <class T, class Alloc>
+template <class Compared>
+void list<T, Alloc>::merge_nodes(base_ptr& a, base_ptr& b, Compared& comp)
+{
+  base_ptr head = nullptr;
+  base_ptr* tail = &head;
+  base_ptr x = a;
+  base_ptr y = b;
+  try
+  {
+    // 连续取自同一段的节点已经连接在一起，只在切换时修改 next 指针
+    while (x != nullptr && y != nullptr)
     {
-      ++f1;
+      if (comp(y->as_node()->value, x->as_node()->value))
+      {
+        *tail = y;
+        do
+        {
+          tail = &y->next;
+          y = y->next;
+        } while (y != nullptr && comp(y->as_node()->value, x->as_node()->value));
+      }
+      else
+      {
+        *tail = x;
+        do
+        {
+          tail = &x->next;
+          x = x->next;
+        } while (x != nullptr && !comp(y->as_node()->value, x->as_node()->value));
+      }
     }
   }
-  return result;
+  catch (...)
+  {
+    *tail = concat_nodes(x, y);
+    a = head;
+    b = nullptr;
+    throw;
+  }
+  *tail = x != nullptr ? x : y;
+  a = head;
+  b = nullptr;
+}
+
+// 连接两段以 nullptr 结尾的节点
+template <class T, class Alloc>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::concat_nodes(base_ptr a, base_ptr b) noexcept
+{
+  if (a == nullptr)
+    return b;
+  base_ptr last = a;
+  while (last->next != nullptr)
+    last = last->next;
+  last->next = b;
+  return a;
+}
+
+// 把以 nullptr 结尾的节点重新连接为环状链表，并恢复 prev 指针
+template <class T, class Alloc>
+void list<T, Alloc>::relink_nodes(base_ptr first) noexcept
+{
+  base_ptr prev = node_;
+  for (base_ptr p = first; p != nullptr; p = p->next)
+  {
+    p->prev = prev;
+    prev = p;
+  }
+  prev->next = node_;
+  node_->prev = prev;
+  node_->next = first != nullptr ? first : node_;
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   auto f1 = lhs.cbegin();
   auto f2 = rhs.cbegin();
@@ -1168,43 +1404,53 @@ bool operator==(const list<T>& lhs, const list<T>& rhs)
   return f1 == l1 && f2 == l2;
 }
 
-template <class T>
-bool operator<(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator<(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return mystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
 
-template <class T>
-bool operator!=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator!=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator>(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator<=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator>=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(list<T>& lhs, list<T>& rhs) noexcept
+template <class T, class Alloc>
+void swap(list<T, Alloc>& lhs, list<T, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// list 的哨兵节点也分配在堆上，可以按字节搬移
+template <class T, class Alloc>
+struct is_trivially_relocatable<list<T, Alloc>> :is_trivially_relocatable<Alloc> {};
+
+namespace pmr
+{
+template <class T>
+using list = mystl::list<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_LIST_H_
 
@@ -19,9 +19,14 @@
 namespace mystl
 {
 
+template <class, class, class, class>
+class multimap;
+
 // 模板类 map，键值不允许重复
-// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class map
 {
 public:
@@ -34,7 +39,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class map<Key, T, Compare>;
+    friend class map<Key, T, Compare, Alloc>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -47,12 +52,17 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;
 
+  template <class, class, class, class>
+  friend class map;
+  template <class, class, class, class>
+  friend class multimap;
+
 public:
   // 使用 rb_tree 的型别
-  typedef typename base_type::node_type              node_type;
+  typedef typename base_type::node_handle_type       node_type;
   typedef typename base_type::pointer                pointer;
   typedef typename base_type::const_pointer          const_pointer;
   typedef typename base_type::reference              reference;
@@ -64,29 +74,48 @@ public:
   typedef typename base_type::size_type              size_type;
   typedef typename base_type::difference_type        difference_type;
   typedef typename base_type::allocator_type         allocator_type;
+  typedef mystl::node_insert_return<iterator, node_type> insert_return_type;
 
 public:
   // 构造、复制、移动、赋值函数
 
   map() = default;
 
+  explicit map(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit map(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
   template <class InputIterator>
-  map(InputIterator first, InputIterator last)
-    :tree_()
+  map(InputIterator first, InputIterator last,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_unique(first, last); }
-
-  map(std::initializer_list<value_type> ilist) 
-    :tree_()
+  map(std::initializer_list<value_type> ilist,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
-  map(const map& rhs) 
-    :tree_(rhs.tree_) 
+  map(const map& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  map(const map& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
   {
   }
   map(map&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  map(map&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   map& operator=(const map& rhs)
   { 
@@ -166,21 +195,14 @@ public:
     return it->second;
   }
 
+  // 键值不存在时插入一个值初始化的实值
   mapped_type& operator[](const key_type& key)
   {
-    iterator it = lower_bound(key);
-    // it->first >= key
-    if (it == end() || key_comp()(key, it->first))
-      it = emplace_hint(it, key, T{});
-    return it->second;
+    return tree_.try_emplace_unique(key).first->second;
   }
   mapped_type& operator[](key_type&& key)
   {
-    iterator it = lower_bound(key);
-    // it->first >= key
-    if (it == end() || key_comp()(key, it->first))
-      it = emplace_hint(it, mystl::move(key), T{});
-    return it->second;
+    return tree_.try_emplace_unique(mystl::move(key)).first->second;
   }
 
   // 插入删除相关
@@ -197,6 +219,65 @@ public:
     return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
   }
 
+  // try_emplace：先查找键值，已存在时不创建节点，args 也不会被移动
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique(key, mystl::forward<Args>(args)...);
+  }
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...);
+  }
+  template <class ...Args>
+  iterator try_emplace(iterator hint, const key_type& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique_use_hint(hint, key, mystl::forward<Args>(args)...);
+  }
+  template <class ...Args>
+  iterator try_emplace(iterator hint, key_type&& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique_use_hint(hint, mystl::move(key), mystl::forward<Args>(args)...);
+  }
+
+  // insert_or_assign：键值已存在时给实值赋值，否则插入
+  // try_emplace 失败时不会使用 obj，所以可以再把它转发给赋值操作
+  template <class M>
+  pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+  {
+    auto res = tree_.try_emplace_unique(key, mystl::forward<M>(obj));
+    if (!res.second)
+      res.first->second = mystl::forward<M>(obj);
+    return res;
+  }
+  template <class M>
+  pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+  {
+    auto res = tree_.try_emplace_unique(mystl::move(key), mystl::forward<M>(obj));
+    if (!res.second)
+      res.first->second = mystl::forward<M>(obj);
+    return res;
+  }
+  template <class M>
+  iterator insert_or_assign(iterator hint, const key_type& key, M&& obj)
+  {
+    auto n = size();
+    auto it = tree_.try_emplace_unique_use_hint(hint, key, mystl::forward<M>(obj));
+    if (n == size())
+      it->second = mystl::forward<M>(obj);
+    return it;
+  }
+  template <class M>
+  iterator insert_or_assign(iterator hint, key_type&& key, M&& obj)
+  {
+    auto n = size();
+    auto it = tree_.try_emplace_unique_use_hint(hint, mystl::move(key), mystl::forward<M>(obj));
+    if (n == size())
+      it->second = mystl::forward<M>(obj);
+    return it;
+  }
+
   pair<iterator, bool> insert(const value_type& value)
   {
     return tree_.insert_unique(value);
@@ -227,6 +308,30 @@ public:
 
   void      clear()                              { tree_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配内存
+
+  node_type extract(iterator position)           { return tree_.extract(position); }
+  node_type extract(const key_type& key)         { return tree_.extract_unique(key); }
+
+  insert_return_type insert(node_type&& nh)
+  {
+    auto r = tree_.insert_node_unique(mystl::move(nh));
+    return insert_return_type{ r.position, r.inserted, mystl::move(r.node) };
+  }
+  iterator  insert(iterator hint, node_type&& nh)
+  {
+    return tree_.insert_node_unique(hint, mystl::move(nh));
+  }
+
+  template <class Compare2>
+  void merge(map<Key, T, Compare2, Alloc>& source)   { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(map<Key, T, Compare2, Alloc>&& source)  { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(multimap<Key, T, Compare2, Alloc>& source)  { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(multimap<Key, T, Compare2, Alloc>&& source) { tree_.merge_unique(source.tree_); }
+
   // map 相关操作
 
   iterator       find(const key_type& key)              { return tree_.find(key); }
@@ -248,6 +353,51 @@ public:
     equal_range(const key_type& key) const 
   { return tree_.equal_range_unique(key); }
 
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_unique(key); }
+
   void           swap(map& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -257,45 +407,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(map<Key, T, Compare, Alloc>& lhs, map<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -303,8 +453,10 @@ void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
 /*****************************************************************************************/
 
 // 模板类 multimap，键值允许重复
-// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class multimap
 {
 public:
@@ -317,7 +469,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class multimap<Key, T, Compare>;
+    friend class multimap<Key, T, Compare, Alloc>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -330,12 +482,17 @@ public:
 
 private:
   // 用 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;
 
+  template <class, class, class, class>
+  friend class map;
+  template <class, class, class, class>
+  friend class multimap;
+
 public:
   // 使用 rb_tree 的型别
-  typedef typename base_type::node_type              node_type;
+  typedef typename base_type::node_handle_type       node_type;
   typedef typename base_type::pointer                pointer;
   typedef typename base_type::const_pointer          const_pointer;
   typedef typename base_type::reference              reference;
@@ -353,22 +510,41 @@ public:
 
   multimap() = default;
 
+  explicit multimap(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit multimap(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
   template <class InputIterator>
-  multimap(InputIterator first, InputIterator last) 
-    :tree_() 
+  multimap(InputIterator first, InputIterator last,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_multi(first, last); }
-  multimap(std::initializer_list<value_type> ilist) 
-    :tree_() 
+  multimap(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
   multimap(const multimap& rhs)
     :tree_(rhs.tree_)
   {
   }
+  multimap(const multimap& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   multimap(multimap&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  multimap(multimap&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   multimap& operator=(const multimap& rhs) 
   { 
@@ -472,6 +648,29 @@ public:
 
   void           clear() { tree_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配内存
+
+  node_type extract(iterator position)           { return tree_.extract(position); }
+  node_type extract(const key_type& key)         { return tree_.extract_multi(key); }
+
+  iterator  insert(node_type&& nh)
+  {
+    return tree_.insert_node_multi(mystl::move(nh));
+  }
+  iterator  insert(iterator hint, node_type&& nh)
+  {
+    return tree_.insert_node_multi(hint, mystl::move(nh));
+  }
+
+  template <class Compare2>
+  void merge(multimap<Key, T, Compare2, Alloc>& source)   { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(multimap<Key, T, Compare2, Alloc>&& source)  { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(map<Key, T, Compare2, Alloc>& source)  { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(map<Key, T, Compare2, Alloc>&& source) { tree_.merge_multi(source.tree_); }
+
   // multimap 相关操作
 
   iterator       find(const key_type& key)              { return tree_.find(key); }
@@ -493,6 +692,51 @@ public:
     equal_range(const key_type& key) const 
   { return tree_.equal_range_multi(key); }
 
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_multi(key); }
+
   void swap(multimap& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -502,49 +746,68 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(multimap<Key, T, Compare, Alloc>& lhs, multimap<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// rb_tree 的 header_ 节点分配在堆上，比较函数与分配器可以按字节搬移时，整个容器也可以
+template <class Key, class T, class Compare, class Alloc>
+struct is_trivially_relocatable<map<Key, T, Compare, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Compare>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class T, class Compare, class Alloc>
+struct is_trivially_relocatable<multimap<Key, T, Compare, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Compare>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+namespace pmr
+{
+template <class Key, class T, class Compare = mystl::less<Key>>
+using map = mystl::map<Key, T, Compare, polymorphic_allocator<mystl::pair<const Key, T>>>;
+template <class Key, class T, class Compare = mystl::less<Key>>
+using multimap = mystl::multimap<Key, T, Compare, polymorphic_allocator<mystl::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_MAP_H_
 
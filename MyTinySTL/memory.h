@@ -12,6 +12,7 @@
 #include "allocator.h"
 #include "construct.h"
 #include "uninitialized.h"
+#include "memory_resource.h"
 
 namespace mystl
 {
@@ -101,6 +102,7 @@ private:
 template <class ForwardIterator, class T>
 temporary_buffer<ForwardIterator, T>::
 temporary_buffer(ForwardIterator first, ForwardIterator last)
+  :original_len(0), len(0), buffer(nullptr)
 {
   try
   {
@@ -205,6 +207,10 @@ public:
   }
 };
 
+// auto_ptr 只持有一个指针，可以按字节搬移
+template <class T>
+struct is_trivially_relocatable<auto_ptr<T>> :m_true_type {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_MEMORY_H_
 
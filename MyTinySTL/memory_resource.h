@@ -0,0 +1,660 @@
+﻿#ifndef MYTINYSTL_MEMORY_RESOURCE_H_
+#define MYTINYSTL_MEMORY_RESOURCE_H_
+
+// 这个头文件包含 mystl::pmr 命名空间下的内存资源与多态分配器
+//
+// memory_resource             : 内存资源的抽象基类
+// monotonic_buffer_resource   : 单调增长的内存资源，释放为空操作，release 或析构时一次性归还
+// unsynchronized_pool_resource: 按大小分级的内存池，非线程安全
+// synchronized_pool_resource  : 加锁的 unsynchronized_pool_resource
+// polymorphic_allocator       : 通过 memory_resource 分配内存的分配器
+//
+// 各容器的 pmr 别名（pmr::vector, pmr::map, pmr::string 等）定义在各自的头文件中
+
+// notes:
+//
+// 1. polymorphic_allocator 不随容器的复制、移动、交换传播，复制容器时使用默认的内存资源
+// 2. polymorphic_allocator::construct 会把分配器传给能够接受分配器的元素（如 pmr::string），
+//    使容器中嵌套的容器也来自同一内存资源；pair 的元素不做这种处理
+
+#include <new>
+#include <mutex>
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "type_traits.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+namespace pmr
+{
+
+// 类 memory_resource
+// 派生类需要实现 do_allocate, do_deallocate, do_is_equal
+class memory_resource
+{
+public:
+  enum { max_align = alignof(std::max_align_t) };
+
+  virtual ~memory_resource() = default;
+
+  void* allocate(size_t bytes, size_t alignment = max_align)
+  { return do_allocate(bytes, alignment); }
+  void  deallocate(void* p, size_t bytes, size_t alignment = max_align)
+  { do_deallocate(p, bytes, alignment); }
+  bool  is_equal(const memory_resource& other) const noexcept
+  { return do_is_equal(other); }
+
+private:
+  virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+  virtual void  do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+  virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{ return &lhs == &rhs || lhs.is_equal(rhs); }
+
+inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{ return !(lhs == rhs); }
+
+/*****************************************************************************************/
+// new_delete_resource, null_memory_resource 与默认内存资源
+
+// 使用 ::operator new, ::operator delete 的内存资源
+// 对齐要求超过 max_align 时多申请一些空间，在返回地址之前保存原始地址
+class new_delete_memory_resource :public memory_resource
+{
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    if (alignment <= max_align)
+      return ::operator new(bytes);
+    char* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+    uintptr_t addr = reinterpret_cast<uintptr_t>(raw + sizeof(void*));
+    addr = (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    void* result = reinterpret_cast<void*>(addr);
+    static_cast<void**>(result)[-1] = raw;
+    return result;
+  }
+
+  void  do_deallocate(void* p, size_t, size_t alignment) override
+  {
+    if (alignment <= max_align)
+      ::operator delete(p);
+    else
+      ::operator delete(static_cast<void**>(p)[-1]);
+  }
+
+  bool  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// 任何分配都抛出 std::bad_alloc 的内存资源，可作为 upstream 检查是否有额外的分配
+class null_memory_resource_type :public memory_resource
+{
+private:
+  void* do_allocate(size_t, size_t) override
+  { throw std::bad_alloc(); }
+  void  do_deallocate(void*, size_t, size_t) override {}
+  bool  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+inline memory_resource* new_delete_resource() noexcept
+{
+  static new_delete_memory_resource r;
+  return &r;
+}
+
+inline memory_resource* null_memory_resource() noexcept
+{
+  static null_memory_resource_type r;
+  return &r;
+}
+
+inline std::atomic<memory_resource*>& M_default_resource() noexcept
+{
+  static std::atomic<memory_resource*> r(new_delete_resource());
+  return r;
+}
+
+// 默认的内存资源，polymorphic_allocator 默认构造时使用
+inline memory_resource* get_default_resource() noexcept
+{ return M_default_resource().load(std::memory_order_acquire); }
+
+// 设置默认的内存资源，传入 nullptr 时恢复为 new_delete_resource，返回原来的内存资源
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{
+  if (r == nullptr)
+    r = new_delete_resource();
+  return M_default_resource().exchange(r, std::memory_order_acq_rel);
+}
+
+/*****************************************************************************************/
+// monotonic_buffer_resource
+
+// 从初始缓冲区或 upstream 申请的大块内存中顺序划分空间，deallocate 不做任何事情，
+// release 或析构时把向 upstream 申请的内存全部归还，并重新从初始缓冲区开始划分
+// 每次向 upstream 申请的大小按 2 倍增长
+class monotonic_buffer_resource :public memory_resource
+{
+private:
+  // 向 upstream 申请的大块内存，头部记录链表与大小
+  struct chunk_header
+  {
+    chunk_header* next;
+    size_t        bytes;
+    size_t        alignment;
+  };
+
+  enum { default_size = 1024 };
+
+  memory_resource* upstream_;
+  void*            initial_buffer_;   // 用户提供的初始缓冲区
+  size_t           initial_size_;
+  size_t           next_size_;        // 下一次向 upstream 申请的大小
+  char*            cur_;              // 当前可用空间的起始位置
+  char*            end_;              // 当前可用空间的结束位置
+  chunk_header*    chunks_;
+
+public:
+  monotonic_buffer_resource()
+    :monotonic_buffer_resource(get_default_resource()) {}
+
+  explicit monotonic_buffer_resource(memory_resource* upstream)
+    :monotonic_buffer_resource(default_size, upstream) {}
+
+  explicit monotonic_buffer_resource(size_t initial_size,
+                                     memory_resource* upstream = get_default_resource())
+    :upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+    next_size_(initial_size == 0 ? 1 : initial_size),
+    cur_(nullptr), end_(nullptr), chunks_(nullptr)
+  {
+    MYSTL_DEBUG(upstream != nullptr);
+  }
+
+  monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                            memory_resource* upstream = get_default_resource())
+    :upstream_(upstream), initial_buffer_(buffer), initial_size_(buffer_size),
+    next_size_(buffer_size == 0 ? static_cast<size_t>(default_size) : buffer_size * 2),
+    cur_(static_cast<char*>(buffer)), end_(static_cast<char*>(buffer) + buffer_size),
+    chunks_(nullptr)
+  {
+    MYSTL_DEBUG(upstream != nullptr);
+  }
+
+  monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+  monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+  ~monotonic_buffer_resource() override { release(); }
+
+  void             release() noexcept;
+  memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+  // 当前块中剩余可用的字节数
+  size_t           remaining() const noexcept { return static_cast<size_t>(end_ - cur_); }
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void  do_deallocate(void*, size_t, size_t) override {}
+  bool  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+
+  void  M_new_chunk(size_t bytes, size_t alignment);
+};
+
+// 把向 upstream 申请的内存全部归还，回到初始缓冲区
+inline void monotonic_buffer_resource::release() noexcept
+{
+  while (chunks_ != nullptr)
+  {
+    chunk_header* next = chunks_->next;
+    upstream_->deallocate(chunks_, chunks_->bytes, chunks_->alignment);
+    chunks_ = next;
+  }
+  cur_ = static_cast<char*>(initial_buffer_);
+  end_ = cur_ + initial_size_;
+}
+
+inline void* monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment)
+{
+  MYSTL_DEBUG((alignment & (alignment - 1)) == 0);
+  if (bytes == 0)
+    bytes = 1;
+  uintptr_t addr = reinterpret_cast<uintptr_t>(cur_);
+  uintptr_t aligned = (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  if (cur_ == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(end_))
+  {
+    M_new_chunk(bytes, alignment);
+    addr = reinterpret_cast<uintptr_t>(cur_);
+    aligned = (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+  cur_ = reinterpret_cast<char*>(aligned + bytes);
+  return reinterpret_cast<void*>(aligned);
+}
+
+// 向 upstream 申请一个至少能放下 bytes 字节的新块
+inline void monotonic_buffer_resource::M_new_chunk(size_t bytes, size_t alignment)
+{
+  const size_t header = (sizeof(chunk_header) + alignment - 1) & ~(alignment - 1);
+  size_t need = bytes + header + alignment;
+  size_t size = next_size_ < need ? need : next_size_;
+  const size_t chunk_align = alignment < max_align ? static_cast<size_t>(max_align) : alignment;
+  void* p = upstream_->allocate(size, chunk_align);
+  chunk_header* h = static_cast<chunk_header*>(p);
+  h->next = chunks_;
+  h->bytes = size;
+  h->alignment = chunk_align;
+  chunks_ = h;
+  cur_ = static_cast<char*>(p) + sizeof(chunk_header);
+  end_ = static_cast<char*>(p) + size;
+  if (next_size_ <= (static_cast<size_t>(-1) >> 1))
+    next_size_ = (size > next_size_ ? size : next_size_) * 2;
+}
+
+/*****************************************************************************************/
+// pool resource
+
+// 内存池的参数
+struct pool_options
+{
+  size_t max_blocks_per_chunk;         // 每次向 upstream 申请的最多区块数，0 表示使用缺省值
+  size_t largest_required_pool_block;  // 由内存池管理的最大区块，0 表示使用缺省值
+
+  pool_options(size_t max_blocks = 0, size_t largest_block = 0) noexcept
+    :max_blocks_per_chunk(max_blocks), largest_required_pool_block(largest_block) {}
+};
+
+// 按大小分级的内存池，非线程安全
+// 区块大小为 2 的幂，从 8 bytes 到 largest_required_pool_block，每一级有一条自由链表，
+// 链表为空时向 upstream 申请一块能放下若干区块的内存，区块数从 16 开始按 2 倍增长，
+// 超过 largest_required_pool_block 的请求直接交给 upstream，并记录下来以便 release
+class unsynchronized_pool_resource :public memory_resource
+{
+private:
+  // 自由链表中的区块
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  // 向 upstream 申请的大块内存，记录在块的尾部
+  struct chunk_footer
+  {
+    chunk_footer* next;
+    void*         base;
+    size_t        bytes;
+    size_t        alignment;
+  };
+
+  // 直接由 upstream 分配的大区块，记录在返回地址之前
+  struct large_header
+  {
+    large_header* prev;
+    large_header* next;
+    void*         base;
+    size_t        bytes;
+    size_t        alignment;
+  };
+
+  // 同一大小的区块
+  struct pool
+  {
+    free_block*   free;         // 已归还的区块
+    char*         cur;          // 当前块中尚未划分的部分
+    char*         end;
+    size_t        next_blocks;  // 下一次申请的区块数
+  };
+
+  enum
+  {
+    min_block_shift    = 3,     // 最小的区块为 8 bytes
+    max_pool_count     = 20,
+    default_largest    = 4096,
+    default_max_blocks = 1024,
+    first_blocks       = 16
+  };
+
+  memory_resource* upstream_;
+  pool_options     options_;
+  size_t           pool_count_;
+  pool             pools_[max_pool_count];
+  chunk_footer*    chunks_;
+  large_header*    large_;
+
+public:
+  unsynchronized_pool_resource()
+    :unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+  explicit unsynchronized_pool_resource(memory_resource* upstream)
+    :unsynchronized_pool_resource(pool_options(), upstream) {}
+
+  explicit unsynchronized_pool_resource(const pool_options& opts)
+    :unsynchronized_pool_resource(opts, get_default_resource()) {}
+
+  unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream);
+
+  unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+  unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+  ~unsynchronized_pool_resource() override { release(); }
+
+  void             release() noexcept;
+  memory_resource* upstream_resource() const noexcept { return upstream_; }
+  pool_options     options() const noexcept { return options_; }
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void  do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+
+private:
+  static size_t M_block_size(size_t index) noexcept
+  { return static_cast<size_t>(1) << (index + min_block_shift); }
+  size_t        M_pool_index(size_t bytes, size_t alignment) const noexcept;
+  void*         M_refill(size_t index);
+  void*         M_allocate_large(size_t bytes, size_t alignment);
+  void          M_deallocate_large(void* p);
+};
+
+inline unsynchronized_pool_resource::
+unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+  :upstream_(upstream), options_(opts), pool_count_(0), chunks_(nullptr), large_(nullptr)
+{
+  MYSTL_DEBUG(upstream != nullptr);
+  if (options_.max_blocks_per_chunk == 0)
+    options_.max_blocks_per_chunk = default_max_blocks;
+  if (options_.max_blocks_per_chunk < first_blocks)
+    options_.max_blocks_per_chunk = first_blocks;
+  if (options_.largest_required_pool_block == 0)
+    options_.largest_required_pool_block = default_largest;
+  // 向上取到 2 的幂，并限制在能够管理的范围内
+  size_t largest = M_block_size(0);
+  while (largest < options_.largest_required_pool_block && pool_count_ + 1 < max_pool_count)
+  {
+    largest <<= 1;
+    ++pool_count_;
+  }
+  ++pool_count_;
+  options_.largest_required_pool_block = largest;
+  for (size_t i = 0; i < max_pool_count; ++i)
+  {
+    pools_[i].free = nullptr;
+    pools_[i].cur = nullptr;
+    pools_[i].end = nullptr;
+    pools_[i].next_blocks = first_blocks;
+  }
+}
+
+// 归还向 upstream 申请的全部内存，之前分配出去的区块全部失效
+inline void unsynchronized_pool_resource::release() noexcept
+{
+  while (chunks_ != nullptr)
+  {
+    chunk_footer* next = chunks_->next;
+    upstream_->deallocate(chunks_->base, chunks_->bytes, chunks_->alignment);
+    chunks_ = next;
+  }
+  while (large_ != nullptr)
+  {
+    large_header* next = large_->next;
+    upstream_->deallocate(large_->base, large_->bytes, large_->alignment);
+    large_ = next;
+  }
+  for (size_t i = 0; i < pool_count_; ++i)
+  {
+    pools_[i].free = nullptr;
+    pools_[i].cur = nullptr;
+    pools_[i].end = nullptr;
+    pools_[i].next_blocks = first_blocks;
+  }
+}
+
+// 对齐要求也按区块大小满足，所以取 bytes 与 alignment 中较大的一个
+inline size_t unsynchronized_pool_resource::
+M_pool_index(size_t bytes, size_t alignment) const noexcept
+{
+  const size_t need = bytes < alignment ? alignment : bytes;
+  size_t index = 0;
+  while (index < pool_count_ && M_block_size(index) < need)
+    ++index;
+  return index;
+}
+
+inline void* unsynchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+{
+  const size_t index = M_pool_index(bytes, alignment);
+  if (index >= pool_count_)
+    return M_allocate_large(bytes, alignment);
+  pool& p = pools_[index];
+  if (p.free != nullptr)
+  {
+    free_block* result = p.free;
+    p.free = result->next;
+    return result;
+  }
+  if (p.cur != p.end)
+  {
+    void* result = p.cur;
+    p.cur += M_block_size(index);
+    return result;
+  }
+  return M_refill(index);
+}
+
+inline void unsynchronized_pool_resource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+  if (p == nullptr)
+    return;
+  const size_t index = M_pool_index(bytes, alignment);
+  if (index >= pool_count_)
+  {
+    M_deallocate_large(p);
+    return;
+  }
+  free_block* b = static_cast<free_block*>(p);
+  b->next = pools_[index].free;
+  pools_[index].free = b;
+}
+
+// 为第 index 级申请新的一块内存，返回其中的第一个区块，其余的留待以后划分
+inline void* unsynchronized_pool_resource::M_refill(size_t index)
+{
+  pool& p = pools_[index];
+  const size_t block = M_block_size(index);
+  const size_t nblock = p.next_blocks;
+  const size_t bytes = block * nblock + sizeof(chunk_footer);
+  const size_t alignment = block < max_align ? static_cast<size_t>(max_align) : block;
+  char* base = static_cast<char*>(upstream_->allocate(bytes, alignment));
+  chunk_footer* f = reinterpret_cast<chunk_footer*>(base + block * nblock);
+  f->next = chunks_;
+  f->base = base;
+  f->bytes = bytes;
+  f->alignment = alignment;
+  chunks_ = f;
+  p.cur = base + block;
+  p.end = base + block * nblock;
+  if (nblock < options_.max_blocks_per_chunk)
+    p.next_blocks = nblock * 2 < options_.max_blocks_per_chunk
+    ? nblock * 2 : options_.max_blocks_per_chunk;
+  return base;
+}
+
+inline void* unsynchronized_pool_resource::M_allocate_large(size_t bytes, size_t alignment)
+{
+  const size_t align = alignment < alignof(large_header) ? alignof(large_header) : alignment;
+  const size_t header = (sizeof(large_header) + align - 1) & ~(align - 1);
+  THROW_LENGTH_ERROR_IF(bytes > static_cast<size_t>(-1) - header,
+                        "unsynchronized_pool_resource's request too big");
+  char* base = static_cast<char*>(upstream_->allocate(bytes + header, align));
+  char* result = base + header;
+  large_header* h = reinterpret_cast<large_header*>(result) - 1;
+  h->prev = nullptr;
+  h->next = large_;
+  h->base = base;
+  h->bytes = bytes + header;
+  h->alignment = align;
+  if (large_ != nullptr)
+    large_->prev = h;
+  large_ = h;
+  return result;
+}
+
+inline void unsynchronized_pool_resource::M_deallocate_large(void* p)
+{
+  large_header* h = static_cast<large_header*>(p) - 1;
+  if (h->prev != nullptr)
+    h->prev->next = h->next;
+  else
+    large_ = h->next;
+  if (h->next != nullptr)
+    h->next->prev = h->prev;
+  upstream_->deallocate(h->base, h->bytes, h->alignment);
+}
+
+// 线程安全的内存池，所有操作由一把锁保护
+class synchronized_pool_resource :public unsynchronized_pool_resource
+{
+private:
+  mutable std::mutex mtx_;
+
+public:
+  synchronized_pool_resource()
+    :unsynchronized_pool_resource() {}
+  explicit synchronized_pool_resource(memory_resource* upstream)
+    :unsynchronized_pool_resource(upstream) {}
+  explicit synchronized_pool_resource(const pool_options& opts)
+    :unsynchronized_pool_resource(opts) {}
+  synchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+    :unsynchronized_pool_resource(opts, upstream) {}
+
+  void release()
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    unsynchronized_pool_resource::release();
+  }
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return unsynchronized_pool_resource::do_allocate(bytes, alignment);
+  }
+  void  do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    unsynchronized_pool_resource::do_deallocate(p, bytes, alignment);
+  }
+  bool  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+/*****************************************************************************************/
+// polymorphic_allocator
+
+template <class T>
+class polymorphic_allocator;
+
+// 元素类型 U 能否接受 polymorphic_allocator 作为最后一个构造参数
+template <class U, class A, class... Args>
+struct pmr_uses_allocator
+{
+private:
+  template <class V>
+  static auto test(int) -> m_bool_constant<
+    std::is_convertible<A, typename V::allocator_type>::value &&
+    std::is_constructible<V, Args..., const typename V::allocator_type&>::value>;
+  template <class V>
+  static m_false_type test(...);
+public:
+  typedef decltype(test<U>(0)) type;
+};
+
+// 模板类 polymorphic_allocator
+// 通过一个 memory_resource 分配内存，两个分配器相等当且仅当它们的内存资源相等
+template <class T>
+class polymorphic_allocator
+{
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  template <class U>
+  struct rebind { typedef polymorphic_allocator<U> other; };
+
+private:
+  memory_resource* resource_;
+
+public:
+  polymorphic_allocator() noexcept
+    :resource_(get_default_resource()) {}
+  polymorphic_allocator(memory_resource* r) noexcept
+    :resource_(r)
+  {
+    MYSTL_DEBUG(r != nullptr);
+  }
+  polymorphic_allocator(const polymorphic_allocator& rhs) = default;
+  template <class U>
+  polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept
+    :resource_(rhs.resource()) {}
+
+  polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+  T*   allocate(size_type n)
+  {
+    THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                          "polymorphic_allocator<T>::allocate's n too big");
+    return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, size_type n)
+  { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+  // 元素能接受分配器时，把当前分配器追加到构造参数的末尾
+  template <class U, class... Args>
+  void construct(U* p, Args&& ...args)
+  {
+    construct_aux(typename pmr_uses_allocator<U, polymorphic_allocator, Args...>::type(),
+                  p, mystl::forward<Args>(args)...);
+  }
+
+  template <class U>
+  void destroy(U* p)
+  { p->~U(); }
+
+  // 复制容器时不传播，使用默认的内存资源
+  polymorphic_allocator select_on_container_copy_construction() const
+  { return polymorphic_allocator(); }
+
+  memory_resource* resource() const noexcept { return resource_; }
+
+private:
+  template <class U, class... Args>
+  void construct_aux(m_true_type, U* p, Args&& ...args)
+  { ::new ((void*)p) U(mystl::forward<Args>(args)..., typename U::allocator_type(*this)); }
+  template <class U, class... Args>
+  void construct_aux(m_false_type, U* p, Args&& ...args)
+  { ::new ((void*)p) U(mystl::forward<Args>(args)...); }
+};
+
+template <class T, class U>
+bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+{ return *lhs.resource() == *rhs.resource(); }
+
+template <class T, class U>
+bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+{ return !(lhs == rhs); }
+
+} // namespace pmr
+} // namespace mystl
+#endif // !MYTINYSTL_MEMORY_RESOURCE_H_
+
@@ -0,0 +1,200 @@
+﻿#ifndef MYTINYSTL_NODE_HANDLE_H_
+#define MYTINYSTL_NODE_HANDLE_H_
+
+// 这个头文件包含一个模板类 node_handle 与一个模板结构 node_insert_return
+// node_handle        : 节点句柄，持有从关联式容器中取出的节点，可以把节点重新插入同类容器
+// node_insert_return : 以节点句柄插入 map / set 类容器的返回值
+
+// notes:
+//
+// 1. extract 只是把节点从容器的结构中摘下，insert(node_type&&) 与 merge 也只是重新链接节点，
+//    全程不分配内存，也不复制或移动元素
+// 2. 句柄在析构时用它保存的分配器销毁节点
+// 3. 节点只能插入分配器相等的容器，key() 返回可修改的键，用于取出后修改键值再插回
+
+#include <type_traits>
+
+#include "memory.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+template <class T, class Compare, class Alloc>
+class rb_tree;
+
+template <class T, class Hash, class KeyEqual, class Policy, class Alloc>
+class hashtable;
+
+// 根据元素类型定义 key_type / mapped_type 或 value_type
+template <class T, bool = mystl::is_pair<T>::value>
+struct node_handle_types
+{
+  typedef T value_type;
+};
+
+template <class T>
+struct node_handle_types<T, true>
+{
+  typedef typename std::remove_const<typename T::first_type>::type key_type;
+  typedef typename T::second_type                                  mapped_type;
+};
+
+// 模板类 node_handle
+// 参数一代表元素类型，参数二代表节点类型，参数三代表容器的分配器类型
+template <class T, class Node, class Alloc>
+class node_handle :public node_handle_types<T>
+{
+  template <class, class, class>
+  friend class mystl::rb_tree;
+  template <class, class, class, class, class>
+  friend class mystl::hashtable;
+
+public:
+  typedef Alloc allocator_type;
+
+private:
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<Node> node_allocator;
+  typedef mystl::allocator_traits<node_allocator>                             node_traits;
+
+  // 分配器只在句柄非空时构造
+  typedef typename std::aligned_storage<sizeof(node_allocator),
+                                        alignof(node_allocator)>::type alloc_storage;
+
+  Node*         node_;
+  alloc_storage alloc_;
+
+public:
+  constexpr node_handle() noexcept
+    :node_(nullptr), alloc_()
+  {
+  }
+
+  node_handle(node_handle&& rhs) noexcept
+    :node_(nullptr), alloc_()
+  {
+    take(rhs);
+  }
+
+  node_handle& operator=(node_handle&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      reset();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  node_handle(const node_handle&) = delete;
+  node_handle& operator=(const node_handle&) = delete;
+
+  ~node_handle() { reset(); }
+
+  bool empty() const noexcept { return node_ == nullptr; }
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+
+  allocator_type get_allocator() const
+  {
+    MYSTL_DEBUG(!empty());
+    return allocator_type(M_alloc());
+  }
+
+  // set 类容器的节点
+  template <class U = T, typename std::enable_if<
+    !mystl::is_pair<U>::value, int>::type = 0>
+  U& value() const
+  {
+    MYSTL_DEBUG(!empty());
+    return node_->value;
+  }
+
+  // map 类容器的节点，键在容器中是 const 的，取出后可以修改
+  template <class U = T, typename std::enable_if<
+    mystl::is_pair<U>::value, int>::type = 0>
+  typename node_handle_types<U>::key_type& key() const
+  {
+    MYSTL_DEBUG(!empty());
+    return const_cast<typename node_handle_types<U>::key_type&>(node_->value.first);
+  }
+
+  template <class U = T, typename std::enable_if<
+    mystl::is_pair<U>::value, int>::type = 0>
+  typename node_handle_types<U>::mapped_type& mapped() const
+  {
+    MYSTL_DEBUG(!empty());
+    return node_->value.second;
+  }
+
+  void swap(node_handle& rhs) noexcept
+  {
+    node_handle tmp(mystl::move(rhs));
+    rhs = mystl::move(*this);
+    *this = mystl::move(tmp);
+  }
+
+  friend void swap(node_handle& lhs, node_handle& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+private:
+  // 以下由容器使用
+
+  node_handle(Node* node, const node_allocator& alloc) noexcept
+    :node_(node), alloc_()
+  {
+    ::new (static_cast<void*>(&alloc_)) node_allocator(alloc);
+  }
+
+  Node* node() const noexcept { return node_; }
+
+  // 交出节点，句柄变为空
+  Node* release() noexcept
+  {
+    Node* p = node_;
+    if (p != nullptr)
+    {
+      M_alloc().~node_allocator();
+      node_ = nullptr;
+    }
+    return p;
+  }
+
+  node_allocator&       M_alloc()       noexcept { return *reinterpret_cast<node_allocator*>(&alloc_); }
+  const node_allocator& M_alloc() const noexcept { return *reinterpret_cast<const node_allocator*>(&alloc_); }
+
+  void take(node_handle& rhs) noexcept
+  {
+    if (rhs.node_ != nullptr)
+    {
+      ::new (static_cast<void*>(&alloc_)) node_allocator(mystl::move(rhs.M_alloc()));
+      node_ = rhs.release();
+    }
+  }
+
+  void reset() noexcept
+  {
+    if (node_ != nullptr)
+    {
+      node_traits::destroy(M_alloc(), mystl::address_of(node_->value));
+      node_traits::deallocate(M_alloc(), node_, 1);
+      release();
+    }
+  }
+};
+
+// 以节点句柄插入键值不允许重复的容器的返回值
+// 插入成功时 node 为空，失败时 position 指向键值相同的元素，节点留在 node 中
+template <class Iterator, class NodeType>
+struct node_insert_return
+{
+  Iterator position;
+  bool     inserted;
+  NodeType node;
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_NODE_HANDLE_H_
+
@@ -0,0 +1,327 @@
+﻿#ifndef MYTINYSTL_NODE_POOL_H_
+#define MYTINYSTL_NODE_POOL_H_
+
+// 这个头文件包含一个类 node_pool 与一个模板类 node_pool_allocator
+//
+// node_pool           : 从 4KB~64KB 的大块内存（slab）中依次切出节点，释放的节点放入侵入式自由链表
+// node_pool_allocator : 使用 node_pool 的有状态分配器，作为 list、rb_tree（map、set）的分配器时，
+//                       容器的节点来自它独占的 slab，遍历新建的容器时基本是顺序访问
+
+// notes:
+//
+// 1. 缺省构造的 node_pool_allocator 创建一个新的 node_pool，复制与 rebind 得到的分配器共用同一个 node_pool，
+//    node_pool 按引用计数管理，最后一个使用它的分配器析构时释放全部 slab
+// 2. 复制容器时创建新的 node_pool，移动与交换容器时分配器随之传播；两个分配器相等当且仅当共用同一个 node_pool，
+//    splice、merge 等在容器之间转移节点的操作要求两者的分配器相等
+// 3. 一个 node_pool 最多管理 NODE_POOL_CLASSES 种节点大小（如 list 的哨兵与节点、rb_tree 的 header 与节点），
+//    一次分配多个对象、超出这些大小或对齐要求超过指针的请求直接使用 ::operator new
+// 4. 元素可以平凡析构且 node_pool 只被一个容器使用时，list 与 rb_tree 的 clear() 与析构不再逐个释放节点，
+//    而是一次归还全部 slab（clear() 保留最新的一块以便重新使用），时间与 slab 的个数成正比
+// 5. node_pool 不是线程安全的
+
+#include <new>
+
+#include <cstddef>
+
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// node_pool 最多管理的节点大小种类
+#ifndef NODE_POOL_CLASSES
+#define NODE_POOL_CLASSES 4
+#endif
+
+// 第一块 slab 的大小，之后每块翻倍，直到 NODE_POOL_MAX_SLAB
+#ifndef NODE_POOL_MIN_SLAB
+#define NODE_POOL_MIN_SLAB 4096
+#endif
+
+#ifndef NODE_POOL_MAX_SLAB
+#define NODE_POOL_MAX_SLAB 65536
+#endif
+
+// 类 node_pool
+class node_pool
+{
+public:
+  enum { align = alignof(void*) };  // 节点按指针大小对齐
+
+private:
+  // slab 的头部，链接同一个 node_pool 的所有 slab，最新的在前
+  struct slab
+  {
+    slab*  next;
+    size_t bytes;
+  };
+
+  // 自由链表的节点，放在已释放的节点内部
+  struct free_node
+  {
+    free_node* next;
+  };
+
+  // 同一大小的节点共用一条自由链表
+  struct size_class
+  {
+    size_t     size;
+    free_node* free;
+  };
+
+  static constexpr size_t header_size = (sizeof(slab) + align - 1) & ~static_cast<size_t>(align - 1);
+
+  slab*      slabs_;          // 所有 slab
+  char*      cur_;            // 最新的 slab 中未划分部分的起始位置
+  char*      end_;            // 最新的 slab 的结束位置
+  size_t     next_bytes_;     // 下一块 slab 的大小
+  size_t     slab_count_;     // slab 的个数
+  size_t     slab_bytes_;     // slab 的总字节数
+  size_t     refs_;           // 使用它的分配器个数
+  size_t     class_count_;
+  size_class classes_[NODE_POOL_CLASSES];
+
+public:
+  node_pool() noexcept
+    :slabs_(nullptr), cur_(nullptr), end_(nullptr), next_bytes_(NODE_POOL_MIN_SLAB),
+    slab_count_(0), slab_bytes_(0), refs_(1), class_count_(0)
+  {
+  }
+
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+
+  ~node_pool() { free_slabs(slabs_); }
+
+  void*  allocate(size_t bytes);
+  void   deallocate(void* p, size_t bytes) noexcept;
+
+  // 归还除最新一块以外的所有 slab，之前分配的节点全部失效
+  void   release() noexcept;
+
+  // 只有一个分配器使用它时 release 并返回 true，否则什么也不做
+  bool   release_if_unique() noexcept
+  {
+    if (refs_ != 1)
+      return false;
+    release();
+    return true;
+  }
+
+  size_t slab_count() const noexcept { return slab_count_; }
+  size_t slab_bytes() const noexcept { return slab_bytes_; }
+
+  // 引用计数
+  void   add_ref() noexcept { ++refs_; }
+  void   drop_ref() noexcept
+  {
+    if (--refs_ == 0)
+      delete this;
+  }
+
+private:
+  static size_t M_round_up(size_t bytes) noexcept
+  { return (bytes + align - 1) & ~static_cast<size_t>(align - 1); }
+
+  size_class* M_find_class(size_t size) noexcept;
+  char*       M_new_slab(size_t size);
+  void        free_slabs(slab* s) noexcept;
+};
+
+/*****************************************************************************************/
+
+// 分配 bytes 个字节：先从自由链表中取，再从 slab 中切分
+inline void* node_pool::allocate(size_t bytes)
+{
+  const size_t size = M_round_up(bytes);
+  size_class* c = M_find_class(size);
+  if (c == nullptr)
+    return ::operator new(bytes);
+  if (c->free != nullptr)
+  {
+    free_node* p = c->free;
+    c->free = p->next;
+    return p;
+  }
+  if (static_cast<size_t>(end_ - cur_) < size)
+    return M_new_slab(size);
+  char* result = cur_;
+  cur_ += size;
+  return result;
+}
+
+// 释放 bytes 个字节，大小必须与分配时相同
+inline void node_pool::deallocate(void* p, size_t bytes) noexcept
+{
+  if (p == nullptr)
+    return;
+  size_class* c = M_find_class(M_round_up(bytes));
+  if (c == nullptr)
+  {
+    ::operator delete(p);
+    return;
+  }
+  free_node* node = static_cast<free_node*>(p);
+  node->next = c->free;
+  c->free = node;
+}
+
+inline void node_pool::release() noexcept
+{
+  for (size_t i = 0; i < class_count_; ++i)
+    classes_[i].free = nullptr;
+  if (slabs_ == nullptr)
+    return;
+  free_slabs(slabs_->next);
+  slabs_->next = nullptr;
+  slab_count_ = 1;
+  slab_bytes_ = slabs_->bytes;
+  cur_ = reinterpret_cast<char*>(slabs_) + header_size;
+  end_ = reinterpret_cast<char*>(slabs_) + slabs_->bytes;
+}
+
+// 查找大小为 size 的等级，没有时在空位上新建，放不下或 size 过大时返回 nullptr
+inline node_pool::size_class* node_pool::M_find_class(size_t size) noexcept
+{
+  for (size_t i = 0; i < class_count_; ++i)
+  {
+    if (classes_[i].size == size)
+      return classes_ + i;
+  }
+  if (class_count_ == NODE_POOL_CLASSES || size > (NODE_POOL_MIN_SLAB - header_size) / 4)
+    return nullptr;
+  classes_[class_count_].size = size;
+  classes_[class_count_].free = nullptr;
+  return classes_ + class_count_++;
+}
+
+// 申请一块新的 slab，并从中切出 size 个字节，旧 slab 的剩余部分不再使用
+inline char* node_pool::M_new_slab(size_t size)
+{
+  const size_t bytes = next_bytes_;
+  slab* s = static_cast<slab*>(::operator new(bytes));
+  s->next = slabs_;
+  s->bytes = bytes;
+  slabs_ = s;
+  ++slab_count_;
+  slab_bytes_ += bytes;
+  if (next_bytes_ < NODE_POOL_MAX_SLAB)
+    next_bytes_ *= 2;
+  char* result = reinterpret_cast<char*>(s) + header_size;
+  cur_ = result + size;
+  end_ = reinterpret_cast<char*>(s) + bytes;
+  return result;
+}
+
+inline void node_pool::free_slabs(slab* s) noexcept
+{
+  while (s != nullptr)
+  {
+    slab* next = s->next;
+    ::operator delete(s);
+    s = next;
+  }
+}
+
+/*****************************************************************************************/
+
+// 模板类：node_pool_allocator
+// 内存来自共用的 node_pool
+template <class T>
+class node_pool_allocator
+{
+  template <class U>
+  friend class node_pool_allocator;
+
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_false_type propagate_on_container_copy_assignment;
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  propagate_on_container_swap;
+  typedef m_false_type is_always_equal;
+
+  template <class U>
+  struct rebind { typedef node_pool_allocator<U> other; };
+
+private:
+  node_pool* pool_;
+
+public:
+  node_pool_allocator()
+    :pool_(new node_pool) {}
+
+  node_pool_allocator(const node_pool_allocator& rhs) noexcept
+    :pool_(rhs.pool_)
+  { pool_->add_ref(); }
+
+  template <class U>
+  node_pool_allocator(const node_pool_allocator<U>& rhs) noexcept
+    :pool_(rhs.pool_)
+  { pool_->add_ref(); }
+
+  node_pool_allocator& operator=(const node_pool_allocator& rhs) noexcept
+  {
+    rhs.pool_->add_ref();
+    pool_->drop_ref();
+    pool_ = rhs.pool_;
+    return *this;
+  }
+
+  ~node_pool_allocator() { pool_->drop_ref(); }
+
+  T*   allocate(size_type n)
+  {
+    if (n == 0)
+      return nullptr;
+    if (n != 1 || alignof(T) > node_pool::align)
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    return static_cast<T*>(pool_->allocate(sizeof(T)));
+  }
+
+  void deallocate(T* p, size_type n) noexcept
+  {
+    if (p == nullptr)
+      return;
+    if (n != 1 || alignof(T) > node_pool::align)
+      ::operator delete(p);
+    else
+      pool_->deallocate(p, sizeof(T));
+  }
+
+  // 复制容器时使用新的 node_pool
+  node_pool_allocator select_on_container_copy_construction() const
+  { return node_pool_allocator(); }
+
+  node_pool* pool() const noexcept { return pool_; }
+};
+
+template <class T, class U>
+bool operator==(const node_pool_allocator<T>& lhs, const node_pool_allocator<U>& rhs) noexcept
+{ return lhs.pool() == rhs.pool(); }
+
+template <class T, class U>
+bool operator!=(const node_pool_allocator<T>& lhs, const node_pool_allocator<U>& rhs) noexcept
+{ return lhs.pool() != rhs.pool(); }
+
+template <class T>
+struct alloc_plain_construct<node_pool_allocator<T>> :public m_true_type {};
+
+// node_pool 只被一个容器使用时可以一次归还全部节点
+template <class T>
+struct alloc_release_traits<node_pool_allocator<T>>
+{
+  static bool release_if_unique(node_pool_allocator<T>& a) noexcept
+  { return a.pool()->release_if_unique(); }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_NODE_POOL_H_
+
@@ -3,7 +3,17 @@
 
 // 这个头文件包含了 mystl 的数值算法
 
+// notes:
+//
+// 1. 区间是 int、long long、float、double 等类型的数组（指针）时，以下算法使用 simd_numeric.h 中的向量化版本：
+//    accumulate、inner_product、partial_sum 只对整数使用，结果与逐个计算相同；
+//    reduce、transform_reduce、inclusive_scan 允许改变计算的分组，对浮点数也使用，结果可能有舍入误差；
+//    adjacent_difference 不改变计算，对所有类型使用
+// 2. 定义 MYSTL_NO_SIMD 时只使用标量版本
+
 #include "iterator.h"
+#include "functional.h"
+#include "simd_numeric.h"
 
 namespace mystl
 {
@@ -15,7 +25,7 @@ namespace mystl
 /*****************************************************************************************/
 // 版本1
 template <class InputIter, class T>
-T accumulate(InputIter first, InputIter last, T init)
+T accumulate_dispatch(InputIter first, InputIter last, T init, m_false_type)
 {
   for (; first != last; ++first)
   {
@@ -24,6 +34,22 @@ T accumulate(InputIter first, InputIter last, T init)
   return init;
 }
 
+// 整数数组，以 simd::sum 求和
+template <class InputIter, class T>
+T accumulate_dispatch(InputIter first, InputIter last, T init, m_true_type)
+{
+  typedef typename simd::arith_type<T>::type A;
+  return static_cast<T>(static_cast<A>(init) +
+                        static_cast<A>(simd::sum(first, static_cast<size_t>(last - first))));
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter first, InputIter last, T init)
+{
+  return mystl::accumulate_dispatch(first, last, init,
+                                    m_bool_constant<simd::is_integer_range<InputIter, T>::value>());
+}
+
 // 版本2
 template <class InputIter, class T, class BinaryOp>
 T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
@@ -35,6 +61,56 @@ T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
   return init;
 }
 
+/*****************************************************************************************/
+// reduce
+// 版本1：以初值 init 对每个元素进行累加，与 accumulate 不同，允许改变相加的顺序
+// 版本2：以初值 init 对每个元素进行二元操作，二元操作需满足结合律与交换律
+// 版本3：以 value_type() 为初值
+/*****************************************************************************************/
+template <class InputIter, class T>
+T reduce_dispatch(InputIter first, InputIter last, T init, m_false_type)
+{
+  return mystl::accumulate(first, last, init);
+}
+
+// 数组，以 simd::sum 求和
+template <class InputIter, class T>
+T reduce_dispatch(InputIter first, InputIter last, T init, m_true_type)
+{
+  typedef typename simd::arith_type<T>::type A;
+  return static_cast<T>(static_cast<A>(init) +
+                        static_cast<A>(simd::sum(first, static_cast<size_t>(last - first))));
+}
+
+// 版本1
+template <class InputIter, class T>
+T reduce(InputIter first, InputIter last, T init)
+{
+  return mystl::reduce_dispatch(first, last, init,
+                                m_bool_constant<simd::is_numeric_range<InputIter, T>::value>());
+}
+
+// 版本2
+template <class InputIter, class T, class BinaryOp>
+T reduce(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::accumulate(first, last, init, binary_op);
+}
+
+template <class InputIter, class T>
+T reduce(InputIter first, InputIter last, T init, mystl::plus<T>)
+{
+  return mystl::reduce(first, last, init);
+}
+
+// 版本3
+template <class InputIter>
+typename iterator_traits<InputIter>::value_type
+reduce(InputIter first, InputIter last)
+{
+  return mystl::reduce(first, last, typename iterator_traits<InputIter>::value_type());
+}
+
 /*****************************************************************************************/
 // adjacent_difference
 // 版本1：计算相邻元素的差值，结果保存到以 result 为起始的区间上
@@ -42,7 +118,8 @@ T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
 /*****************************************************************************************/
 // 版本1
 template <class InputIter, class OutputIter>
-OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result)
+OutputIter adjacent_difference_dispatch(InputIter first, InputIter last, OutputIter result,
+                                        m_false_type)
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
@@ -56,6 +133,24 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
   return ++result;
 }
 
+// 数组，以 simd::adjacent_difference 计算，允许 result == first
+template <class T, class U>
+T* adjacent_difference_dispatch(U* first, U* last, T* result, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  simd::adjacent_difference(first, result, n);
+  return result + n;
+}
+
+template <class InputIter, class OutputIter>
+OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::adjacent_difference_dispatch(first, last, result,
+    m_bool_constant<simd::is_numeric_range<InputIter, value_type>::value &&
+                    std::is_same<OutputIter, value_type*>::value>());
+}
+
 // 版本2
 template <class InputIter, class OutputIter, class BinaryOp>
 OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result,
@@ -80,7 +175,8 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
 /*****************************************************************************************/
 // 版本1
 template <class InputIter1, class InputIter2, class T>
-T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+T inner_product_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                         m_false_type)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
@@ -89,6 +185,24 @@ T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
   return init;
 }
 
+// 整数数组，以 simd::dot 计算
+template <class InputIter1, class InputIter2, class T>
+T inner_product_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                         m_true_type)
+{
+  typedef typename simd::arith_type<T>::type A;
+  return static_cast<T>(static_cast<A>(init) +
+    static_cast<A>(simd::dot(first1, first2, static_cast<size_t>(last1 - first1))));
+}
+
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+  return mystl::inner_product_dispatch(first1, last1, first2, init,
+    m_bool_constant<simd::is_integer_range<InputIter1, T>::value &&
+                    simd::is_integer_range<InputIter2, T>::value>());
+}
+
 // 版本2
 template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
 T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
@@ -101,6 +215,58 @@ T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
   return init;
 }
 
+/*****************************************************************************************/
+// transform_reduce
+// 版本1：以 init 为初值，计算两个区间的内积，与 inner_product 不同，允许改变相加的顺序
+// 版本2：以 transform_op 合并两个区间的元素，以 reduce_op 归约
+// 版本3：以 unary_op 变换每个元素，以 reduce_op 归约
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                            m_false_type)
+{
+  return mystl::inner_product(first1, last1, first2, init);
+}
+
+// 数组，以 simd::dot 计算
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                            m_true_type)
+{
+  typedef typename simd::arith_type<T>::type A;
+  return static_cast<T>(static_cast<A>(init) +
+    static_cast<A>(simd::dot(first1, first2, static_cast<size_t>(last1 - first1))));
+}
+
+// 版本1
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+  return mystl::transform_reduce_dispatch(first1, last1, first2, init,
+    m_bool_constant<simd::is_numeric_range<InputIter1, T>::value &&
+                    simd::is_numeric_range<InputIter2, T>::value>());
+}
+
+// 版本2
+template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                   BinaryOp1 reduce_op, BinaryOp2 transform_op)
+{
+  return mystl::inner_product(first1, last1, first2, init, reduce_op, transform_op);
+}
+
+// 版本3
+template <class InputIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce(InputIter first, InputIter last, T init,
+                   BinaryOp reduce_op, UnaryOp unary_op)
+{
+  for (; first != last; ++first)
+  {
+    init = reduce_op(init, unary_op(*first));
+  }
+  return init;
+}
+
 /*****************************************************************************************/
 // iota
 // 填充[first, last)，以 value 为初值开始递增
@@ -120,8 +286,10 @@ void iota(ForwardIter first, ForwardIter last, T value)
 // 版本1：计算局部累计求和，结果保存到以 result 为起始的区间上
 // 版本2：进行局部进行自定义二元操作
 /*****************************************************************************************/
+// 版本1
 template <class InputIter, class OutputIter>
-OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
+OutputIter partial_sum_dispatch(InputIter first, InputIter last, OutputIter result,
+                                m_false_type)
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
@@ -134,6 +302,24 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
   return ++result;
 }
 
+// 数组，以 simd::prefix_sum 计算，允许 result == first
+template <class T, class U>
+T* partial_sum_dispatch(U* first, U* last, T* result, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  simd::prefix_sum(first, result, n, T());
+  return result + n;
+}
+
+template <class InputIter, class OutputIter>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::partial_sum_dispatch(first, last, result,
+    m_bool_constant<simd::is_integer_range<InputIter, value_type>::value &&
+                    std::is_same<OutputIter, value_type*>::value>());
+}
+
 // 版本2
 template <class InputIter, class OutputIter, class BinaryOp>
 OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
@@ -150,6 +336,44 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
   return ++result;
 }
 
+/*****************************************************************************************/
+// inclusive_scan
+// 版本1：计算包含当前元素的前缀和，结果保存到以 result 为起始的区间上，与 partial_sum 不同，允许改变相加的顺序
+// 版本2：使用自定义的二元操作
+// 版本3：使用自定义的二元操作，并以 init 作为初值
+// 二元操作需满足结合律，mystl::execution 中的并行版本会改变计算的分组
+/*****************************************************************************************/
+// 版本1
+template <class InputIter, class OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::partial_sum_dispatch(first, last, result,
+    m_bool_constant<simd::is_numeric_range<InputIter, value_type>::value &&
+                    std::is_same<OutputIter, value_type*>::value>());
+}
+
+// 版本2
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op)
+{
+  return mystl::partial_sum(first, last, result, binary_op);
+}
+
+// 版本3
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op, T init)
+{
+  for (; first != last; ++first, ++result)
+  {
+    init = binary_op(init, *first);
+    *result = init;
+  }
+  return result;
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_NUMERIC_H_
 
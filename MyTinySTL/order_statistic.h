@@ -0,0 +1,953 @@
+﻿#ifndef MYTINYSTL_ORDER_STATISTIC_H_
+#define MYTINYSTL_ORDER_STATISTIC_H_
+
+// 这个头文件包含了四个模板类 order_statistic_set、order_statistic_multiset、
+// order_statistic_map 和 order_statistic_multimap
+// 它们的功能与用法分别与 set、multiset、map、multimap 类似，另外可以在 O(log n) 内：
+//   * nth(k)            : 取得第 k 小的元素（从 0 开始）
+//   * rank(key)         : 取得小于 key 的元素个数
+//   * index_of(it)      : 取得 it 之前的元素个数
+//   * distance(it1, it2): 取得两个迭代器之间的距离，mystl::distance 也是 O(log n)
+
+// notes:
+//
+// 底层为 rb_tree<rb_tree_os<T>, Compare, Alloc>，每个节点比 set / map 的节点多一个记录子树大小
+// 的 size_t，插入删除时沿路径维护，只多出常数的开销；不需要以上操作时请使用 set / map
+// 不提供节点句柄、merge 与异构查找
+//
+// 异常保证：
+// 与 set / map 相同，满足基本异常保证，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert
+
+#include "rb_tree.h"
+
+namespace mystl
+{
+
+// 模板类 order_statistic_set，键值不允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
+class order_statistic_set
+{
+public:
+  typedef Key        key_type;
+  typedef Key        value_type;
+  typedef Compare    key_compare;
+  typedef Compare    value_compare;
+
+private:
+  // 以记录子树大小的 mystl::rb_tree 作为底层机制
+  typedef mystl::rb_tree<mystl::rb_tree_os<value_type>, key_compare, Alloc>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 rb_tree 定义的型别
+  typedef typename base_type::const_pointer          pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::const_reference        reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::const_iterator         iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::const_reverse_iterator reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+
+public:
+  // 构造、复制、移动函数
+  order_statistic_set() = default;
+
+  explicit order_statistic_set(const key_compare& comp,
+                               const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
+  template <class InputIterator>
+  order_statistic_set(InputIterator first, InputIterator last,
+                      const key_compare& comp = key_compare(),
+                      const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(first, last); }
+  order_statistic_set(std::initializer_list<value_type> ilist,
+                      const key_compare& comp = key_compare(),
+                      const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+  order_statistic_set(const order_statistic_set& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  order_statistic_set(order_statistic_set&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+
+  order_statistic_set& operator=(const order_statistic_set& rhs)
+  {
+    tree_ = rhs.tree_;
+    return *this;
+  }
+  order_statistic_set& operator=(order_statistic_set&& rhs)
+  {
+    tree_ = mystl::move(rhs.tree_);
+    return *this;
+  }
+  order_statistic_set& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare      key_comp()      const { return tree_.key_comp(); }
+  value_compare    value_comp()    const { return tree_.key_comp(); }
+  allocator_type   get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept { return tree_.begin(); }
+  const_iterator         begin()   const noexcept { return tree_.begin(); }
+  iterator               end()           noexcept { return tree_.end(); }
+  const_iterator         end()     const noexcept { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept { return begin(); }
+  const_iterator         cend()    const noexcept { return end(); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+
+  // 插入删除操作
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  {
+    return tree_.emplace_unique(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  pair<iterator, bool> insert(const value_type& value)
+  {
+    return tree_.insert_unique(value);
+  }
+  pair<iterator, bool> insert(value_type&& value)
+  {
+    return tree_.insert_unique(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_unique(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_unique(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  void      erase(iterator position)             { tree_.erase(position); }
+  size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
+  void      erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+  void      clear() { tree_.clear(); }
+
+  // set 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  size_type      count(const key_type& key)       const { return tree_.count_unique(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key)
+  { return tree_.equal_range_unique(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const
+  { return tree_.equal_range_unique(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // order statistic 相关操作，复杂度 O(log n)
+
+  // 第 k 小的元素，k >= size() 时返回 end()
+  iterator        nth(size_type k)                      { return tree_.nth(k); }
+  const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+
+  // 小于 key 的元素个数
+  size_type       rank(const key_type& key)       const
+  { return tree_.index_of(tree_.lower_bound(key)); }
+
+  // it 之前的元素个数，it 为 end() 时返回 size()
+  size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+
+  difference_type distance(const_iterator first, const_iterator last) const
+  { return mystl::distance(first, last); }
+
+  void swap(order_statistic_set& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const order_statistic_set& lhs, const order_statistic_set& rhs)
+  { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const order_statistic_set& lhs, const order_statistic_set& rhs)
+  { return lhs.tree_ <  rhs.tree_; }
+  friend bool operator!=(const order_statistic_set& lhs, const order_statistic_set& rhs)
+  { return !(lhs == rhs); }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class Compare, class Alloc>
+void swap(order_statistic_set<Key, Compare, Alloc>& lhs,
+          order_statistic_set<Key, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 order_statistic_multiset，键值允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
+class order_statistic_multiset
+{
+public:
+  typedef Key        key_type;
+  typedef Key        value_type;
+  typedef Compare    key_compare;
+  typedef Compare    value_compare;
+
+private:
+  // 以记录子树大小的 mystl::rb_tree 作为底层机制
+  typedef mystl::rb_tree<mystl::rb_tree_os<value_type>, key_compare, Alloc>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 rb_tree 定义的型别
+  typedef typename base_type::const_pointer          pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::const_reference        reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::const_iterator         iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::const_reverse_iterator reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+
+public:
+  // 构造、复制、移动函数
+  order_statistic_multiset() = default;
+
+  explicit order_statistic_multiset(const key_compare& comp,
+                                    const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
+  template <class InputIterator>
+  order_statistic_multiset(InputIterator first, InputIterator last,
+                           const key_compare& comp = key_compare(),
+                           const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(first, last); }
+  order_statistic_multiset(std::initializer_list<value_type> ilist,
+                           const key_compare& comp = key_compare(),
+                           const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+  order_statistic_multiset(const order_statistic_multiset& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  order_statistic_multiset(order_statistic_multiset&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+
+  order_statistic_multiset& operator=(const order_statistic_multiset& rhs)
+  {
+    tree_ = rhs.tree_;
+    return *this;
+  }
+  order_statistic_multiset& operator=(order_statistic_multiset&& rhs)
+  {
+    tree_ = mystl::move(rhs.tree_);
+    return *this;
+  }
+  order_statistic_multiset& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_multi(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare      key_comp()      const { return tree_.key_comp(); }
+  value_compare    value_comp()    const { return tree_.key_comp(); }
+  allocator_type   get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept { return tree_.begin(); }
+  const_iterator         begin()   const noexcept { return tree_.begin(); }
+  iterator               end()           noexcept { return tree_.end(); }
+  const_iterator         end()     const noexcept { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept { return begin(); }
+  const_iterator         cend()    const noexcept { return end(); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+
+  // 插入删除操作
+
+  template <class ...Args>
+  iterator emplace(Args&& ...args)
+  {
+    return tree_.emplace_multi(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  iterator insert(const value_type& value)
+  {
+    return tree_.insert_multi(value);
+  }
+  iterator insert(value_type&& value)
+  {
+    return tree_.insert_multi(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_multi(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_multi(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_multi(first, last);
+  }
+
+  void      erase(iterator position)             { tree_.erase(position); }
+  size_type erase(const key_type& key)           { return tree_.erase_multi(key); }
+  void      erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+  void      clear() { tree_.clear(); }
+
+  // multiset 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  // 由两端的位置相减得到，O(log n)
+  size_type      count(const key_type& key)       const { return tree_.count_multi(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key)
+  { return tree_.equal_range_multi(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const
+  { return tree_.equal_range_multi(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // order statistic 相关操作，复杂度 O(log n)
+
+  // 第 k 小的元素，k >= size() 时返回 end()
+  iterator        nth(size_type k)                      { return tree_.nth(k); }
+  const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+
+  // 小于 key 的元素个数
+  size_type       rank(const key_type& key)       const
+  { return tree_.index_of(tree_.lower_bound(key)); }
+
+  // it 之前的元素个数，it 为 end() 时返回 size()
+  size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+
+  difference_type distance(const_iterator first, const_iterator last) const
+  { return mystl::distance(first, last); }
+
+  void swap(order_statistic_multiset& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const order_statistic_multiset& lhs, const order_statistic_multiset& rhs)
+  { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const order_statistic_multiset& lhs, const order_statistic_multiset& rhs)
+  { return lhs.tree_ <  rhs.tree_; }
+  friend bool operator!=(const order_statistic_multiset& lhs, const order_statistic_multiset& rhs)
+  { return !(lhs == rhs); }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class Compare, class Alloc>
+void swap(order_statistic_multiset<Key, Compare, Alloc>& lhs,
+          order_statistic_multiset<Key, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 order_statistic_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
+class order_statistic_map
+{
+public:
+  // order_statistic_map 的嵌套型别定义
+  typedef Key                        key_type;
+  typedef T                          mapped_type;
+  typedef mystl::pair<const Key, T>  value_type;
+  typedef Compare                    key_compare;
+
+  // 定义一个 functor，用来进行元素比较
+  class value_compare : public binary_function <value_type, value_type, bool>
+  {
+    friend class order_statistic_map<Key, T, Compare, Alloc>;
+  private:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+  public:
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    {
+      return comp(lhs.first, rhs.first);  // 比较键值的大小
+    }
+  };
+
+private:
+  // 以记录子树大小的 mystl::rb_tree 作为底层机制
+  typedef mystl::rb_tree<mystl::rb_tree_os<value_type>, key_compare, Alloc>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 rb_tree 的型别
+  typedef typename base_type::pointer                pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::reference              reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::iterator               iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::reverse_iterator       reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+
+public:
+  // 构造、复制、移动、赋值函数
+
+  order_statistic_map() = default;
+
+  explicit order_statistic_map(const key_compare& comp,
+                               const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
+  template <class InputIterator>
+  order_statistic_map(InputIterator first, InputIterator last,
+                      const key_compare& comp = key_compare(),
+                      const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(first, last); }
+  order_statistic_map(std::initializer_list<value_type> ilist,
+                      const key_compare& comp = key_compare(),
+                      const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+  order_statistic_map(const order_statistic_map& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  order_statistic_map(order_statistic_map&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+
+  order_statistic_map& operator=(const order_statistic_map& rhs)
+  {
+    tree_ = rhs.tree_;
+    return *this;
+  }
+  order_statistic_map& operator=(order_statistic_map&& rhs)
+  {
+    tree_ = mystl::move(rhs.tree_);
+    return *this;
+  }
+  order_statistic_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare            key_comp()      const { return tree_.key_comp(); }
+  value_compare          value_comp()    const { return value_compare(tree_.key_comp()); }
+  allocator_type         get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept { return tree_.begin(); }
+  const_iterator         begin()   const noexcept { return tree_.begin(); }
+  iterator               end()           noexcept { return tree_.end(); }
+  const_iterator         end()     const noexcept { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept { return begin(); }
+  const_iterator         cend()    const noexcept { return end(); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+
+  // 访问元素相关
+
+  // 若键值不存在，at 会抛出一个异常
+  mapped_type& at(const key_type& key)
+  {
+    iterator it = lower_bound(key);
+    THROW_OUT_OF_RANGE_IF(it == end() || key_comp()(key, it->first),
+                          "order_statistic_map<Key, T> no such element exists");
+    return it->second;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    THROW_OUT_OF_RANGE_IF(it == end() || key_comp()(key, it->first),
+                          "order_statistic_map<Key, T> no such element exists");
+    return it->second;
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    return tree_.try_emplace_unique(key).first->second;
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    return tree_.try_emplace_unique(mystl::move(key)).first->second;
+  }
+
+  // 插入删除相关
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  {
+    return tree_.emplace_unique(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  // try_emplace：先查找键值，已存在时不创建节点，args 也不会被移动
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique(key, mystl::forward<Args>(args)...);
+  }
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+  {
+    return tree_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...);
+  }
+
+  pair<iterator, bool> insert(const value_type& value)
+  {
+    return tree_.insert_unique(value);
+  }
+  pair<iterator, bool> insert(value_type&& value)
+  {
+    return tree_.insert_unique(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_unique(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_unique(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  void      erase(iterator position)             { tree_.erase(position); }
+  size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
+  void      erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+  void      clear()                              { tree_.clear(); }
+
+  // map 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  size_type      count(const key_type& key)       const { return tree_.count_unique(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key)
+  { return tree_.equal_range_unique(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const
+  { return tree_.equal_range_unique(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // order statistic 相关操作，复杂度 O(log n)
+
+  // 键值第 k 小的元素，k >= size() 时返回 end()
+  iterator        nth(size_type k)                      { return tree_.nth(k); }
+  const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+
+  // 键值小于 key 的元素个数
+  size_type       rank(const key_type& key)       const
+  { return tree_.index_of(tree_.lower_bound(key)); }
+
+  // it 之前的元素个数，it 为 end() 时返回 size()
+  size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+
+  difference_type distance(const_iterator first, const_iterator last) const
+  { return mystl::distance(first, last); }
+
+  void swap(order_statistic_map& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const order_statistic_map& lhs, const order_statistic_map& rhs)
+  { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const order_statistic_map& lhs, const order_statistic_map& rhs)
+  { return lhs.tree_ <  rhs.tree_; }
+  friend bool operator!=(const order_statistic_map& lhs, const order_statistic_map& rhs)
+  { return !(lhs == rhs); }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc>
+void swap(order_statistic_map<Key, T, Compare, Alloc>& lhs,
+          order_statistic_map<Key, T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 order_statistic_multimap，键值允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
+class order_statistic_multimap
+{
+public:
+  // order_statistic_multimap 的嵌套型别定义
+  typedef Key                        key_type;
+  typedef T                          mapped_type;
+  typedef mystl::pair<const Key, T>  value_type;
+  typedef Compare                    key_compare;
+
+  // 定义一个 functor，用来进行元素比较
+  class value_compare : public binary_function <value_type, value_type, bool>
+  {
+    friend class order_statistic_multimap<Key, T, Compare, Alloc>;
+  private:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+  public:
+    bool operator()(const value_type& lhs, const value_type& rhs) const
+    {
+      return comp(lhs.first, rhs.first);  // 比较键值的大小
+    }
+  };
+
+private:
+  // 以记录子树大小的 mystl::rb_tree 作为底层机制
+  typedef mystl::rb_tree<mystl::rb_tree_os<value_type>, key_compare, Alloc>  base_type;
+  base_type tree_;
+
+public:
+  // 使用 rb_tree 的型别
+  typedef typename base_type::pointer                pointer;
+  typedef typename base_type::const_pointer          const_pointer;
+  typedef typename base_type::reference              reference;
+  typedef typename base_type::const_reference        const_reference;
+  typedef typename base_type::iterator               iterator;
+  typedef typename base_type::const_iterator         const_iterator;
+  typedef typename base_type::reverse_iterator       reverse_iterator;
+  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename base_type::size_type              size_type;
+  typedef typename base_type::difference_type        difference_type;
+  typedef typename base_type::allocator_type         allocator_type;
+
+public:
+  // 构造、复制、移动、赋值函数
+
+  order_statistic_multimap() = default;
+
+  explicit order_statistic_multimap(const key_compare& comp,
+                                    const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
+  template <class InputIterator>
+  order_statistic_multimap(InputIterator first, InputIterator last,
+                           const key_compare& comp = key_compare(),
+                           const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(first, last); }
+  order_statistic_multimap(std::initializer_list<value_type> ilist,
+                           const key_compare& comp = key_compare(),
+                           const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+  order_statistic_multimap(const order_statistic_multimap& rhs)
+    :tree_(rhs.tree_)
+  {
+  }
+  order_statistic_multimap(order_statistic_multimap&& rhs) noexcept
+    :tree_(mystl::move(rhs.tree_))
+  {
+  }
+
+  order_statistic_multimap& operator=(const order_statistic_multimap& rhs)
+  {
+    tree_ = rhs.tree_;
+    return *this;
+  }
+  order_statistic_multimap& operator=(order_statistic_multimap&& rhs)
+  {
+    tree_ = mystl::move(rhs.tree_);
+    return *this;
+  }
+  order_statistic_multimap& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_multi(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  // 相关接口
+
+  key_compare            key_comp()      const { return tree_.key_comp(); }
+  value_compare          value_comp()    const { return value_compare(tree_.key_comp()); }
+  allocator_type         get_allocator() const { return tree_.get_allocator(); }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept { return tree_.begin(); }
+  const_iterator         begin()   const noexcept { return tree_.begin(); }
+  iterator               end()           noexcept { return tree_.end(); }
+  const_iterator         end()     const noexcept { return tree_.end(); }
+
+  reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept { return begin(); }
+  const_iterator         cend()    const noexcept { return end(); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept { return rend(); }
+
+  // 容量相关
+  bool                   empty()    const noexcept { return tree_.empty(); }
+  size_type              size()     const noexcept { return tree_.size(); }
+  size_type              max_size() const noexcept { return tree_.max_size(); }
+
+  // 插入删除相关
+
+  template <class ...Args>
+  iterator emplace(Args&& ...args)
+  {
+    return tree_.emplace_multi(mystl::forward<Args>(args)...);
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(iterator hint, Args&& ...args)
+  {
+    return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+  }
+
+  iterator insert(const value_type& value)
+  {
+    return tree_.insert_multi(value);
+  }
+  iterator insert(value_type&& value)
+  {
+    return tree_.insert_multi(mystl::move(value));
+  }
+
+  iterator insert(iterator hint, const value_type& value)
+  {
+    return tree_.insert_multi(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value)
+  {
+    return tree_.insert_multi(hint, mystl::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    tree_.insert_multi(first, last);
+  }
+
+  void      erase(iterator position)             { tree_.erase(position); }
+  size_type erase(const key_type& key)           { return tree_.erase_multi(key); }
+  void      erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+  void      clear()                              { tree_.clear(); }
+
+  // multimap 相关操作
+
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  // 由两端的位置相减得到，O(log n)
+  size_type      count(const key_type& key)       const { return tree_.count_multi(key); }
+
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key)
+  { return tree_.equal_range_multi(key); }
+
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const
+  { return tree_.equal_range_multi(key); }
+
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // order statistic 相关操作，复杂度 O(log n)
+
+  // 键值第 k 小的元素，k >= size() 时返回 end()
+  iterator        nth(size_type k)                      { return tree_.nth(k); }
+  const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+
+  // 键值小于 key 的元素个数
+  size_type       rank(const key_type& key)       const
+  { return tree_.index_of(tree_.lower_bound(key)); }
+
+  // it 之前的元素个数，it 为 end() 时返回 size()
+  size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+
+  difference_type distance(const_iterator first, const_iterator last) const
+  { return mystl::distance(first, last); }
+
+  void swap(order_statistic_multimap& rhs) noexcept
+  { tree_.swap(rhs.tree_); }
+
+public:
+  friend bool operator==(const order_statistic_multimap& lhs, const order_statistic_multimap& rhs)
+  { return lhs.tree_ == rhs.tree_; }
+  friend bool operator< (const order_statistic_multimap& lhs, const order_statistic_multimap& rhs)
+  { return lhs.tree_ <  rhs.tree_; }
+  friend bool operator!=(const order_statistic_multimap& lhs, const order_statistic_multimap& rhs)
+  { return !(lhs == rhs); }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc>
+void swap(order_statistic_multimap<Key, T, Compare, Alloc>& lhs,
+          order_statistic_multimap<Key, T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_ORDER_STATISTIC_H_
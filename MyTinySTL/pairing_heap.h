@@ -0,0 +1,503 @@
+﻿#ifndef MYTINYSTL_PAIRING_HEAP_H_
+#define MYTINYSTL_PAIRING_HEAP_H_
+
+// 这个头文件包含一个模板类 pairing_heap
+// pairing_heap : 配对堆，push 与 merge 为 O(1)，pop 与 erase 为均摊 O(log n)
+
+// notes:
+//
+// 1. 每个节点保存第一个子节点 child、下一个兄弟 next 与 prev，
+//    prev 对最左的子节点指向父节点，对其余节点指向上一个兄弟，因此任意节点都能在 O(1) 内从树中摘下
+// 2. 两个堆的合并(meld)只是把根较小的一棵树挂为另一个根的第一个子节点
+// 3. pop 使用两趟合并：先从左到右两两合并根的子树，再从右到左依次合并
+// 4. push 返回句柄，句柄在元素被 pop 或 erase 之前一直有效，merge 之后仍然有效
+// 5. increase_key 使元素更靠近 top()，只需摘下子树再与根合并；decrease_key 与 update 需要重新挂接子树
+// 6. merge 要求两个堆的分配器相等，否则逐个移动元素
+
+#include <initializer_list>
+
+#include "memory.h"
+#include "vector.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// pairing_heap 的节点设计
+template <class T>
+struct pairing_heap_node
+{
+  T                     value;
+  pairing_heap_node<T>* child;  // 第一个子节点
+  pairing_heap_node<T>* next;   // 下一个兄弟
+  pairing_heap_node<T>* prev;   // 最左的子节点指向父节点，其余指向上一个兄弟
+};
+
+template <class T, class Compare, class Alloc>
+class pairing_heap;
+
+// pairing_heap 的句柄，指向一个节点，只能读取元素
+template <class T>
+class pairing_heap_handle
+{
+  template <class, class, class> friend class pairing_heap;
+
+private:
+  pairing_heap_node<T>* node_;
+
+  explicit pairing_heap_handle(pairing_heap_node<T>* n) noexcept :node_(n) {}
+
+public:
+  pairing_heap_handle() noexcept :node_(nullptr) {}
+
+  const T& operator*()  const { return node_->value; }
+  const T* operator->() const { return mystl::address_of(node_->value); }
+
+  bool operator==(const pairing_heap_handle& rhs) const noexcept { return node_ == rhs.node_; }
+  bool operator!=(const pairing_heap_handle& rhs) const noexcept { return node_ != rhs.node_; }
+};
+
+// 模板类 pairing_heap
+// 参数一代表数据类型，参数二代表比较权值的方式，缺省使用 mystl::less，top() 为最大值
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Compare = mystl::less<T>, class Alloc = mystl::allocator<T>>
+class pairing_heap
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template
+                               rebind_alloc<pairing_heap_node<T>>>
+{
+public:
+  typedef T                                        value_type;
+  typedef Compare                                  value_compare;
+  typedef Alloc                                    allocator_type;
+  typedef size_t                                   size_type;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef pairing_heap_handle<T>                   handle_type;
+
+  typedef pairing_heap_node<T>                     node_type;
+  typedef node_type*                               node_ptr;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<node_type>
+                                                   node_allocator;
+  typedef mystl::allocator_traits<node_allocator>  node_traits;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<node_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  node_ptr      root_;  // 根节点
+  size_type     size_;  // 元素个数
+  value_compare comp_;  // 权值比较的标准
+
+public:
+  // 构造、复制、移动、析构函数
+  pairing_heap()
+    :root_(nullptr), size_(0), comp_()
+  {
+  }
+
+  explicit pairing_heap(const Compare& comp, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc)), root_(nullptr), size_(0), comp_(comp)
+  {
+  }
+
+  template <class IIter, typename std::enable_if<
+    mystl::is_input_iterator<IIter>::value, int>::type = 0>
+  pairing_heap(IIter first, IIter last, const Compare& comp = Compare())
+    :root_(nullptr), size_(0), comp_(comp)
+  {
+    try
+    {
+      for (; first != last; ++first)
+        push(*first);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  pairing_heap(std::initializer_list<T> ilist, const Compare& comp = Compare())
+    :pairing_heap(ilist.begin(), ilist.end(), comp)
+  {
+  }
+
+  pairing_heap(const pairing_heap& rhs)
+    :alloc_base(node_traits::select_on_container_copy_construction(rhs.M_alloc())),
+    root_(nullptr), size_(0), comp_(rhs.comp_)
+  {
+    copy_from(rhs);
+  }
+
+  pairing_heap(pairing_heap&& rhs) noexcept
+    :alloc_base(mystl::move(rhs.M_alloc())), root_(rhs.root_), size_(rhs.size_),
+    comp_(rhs.comp_)
+  {
+    rhs.root_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  pairing_heap& operator=(const pairing_heap& rhs)
+  {
+    if (this != &rhs)
+    {
+      pairing_heap tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  pairing_heap& operator=(pairing_heap&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      pairing_heap tmp(mystl::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ~pairing_heap() { clear(); }
+
+public:
+  // 访问元素相关操作
+  const_reference top()        const { MYSTL_DEBUG(!empty()); return root_->value; }
+  handle_type     top_handle() const { MYSTL_DEBUG(!empty()); return handle_type(root_); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return root_ == nullptr; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return node_traits::max_size(M_alloc()); }
+
+  value_compare value_comp() const { return comp_; }
+
+  // 修改容器相关操作
+  template <class... Args>
+  handle_type emplace(Args&& ...args)
+  {
+    node_ptr np = create_node(mystl::forward<Args>(args)...);
+    root_ = meld(root_, np);
+    ++size_;
+    return handle_type(np);
+  }
+
+  handle_type push(const value_type& value)
+  { return emplace(value); }
+  handle_type push(value_type&& value)
+  { return emplace(mystl::move(value)); }
+
+  void pop()
+  {
+    MYSTL_DEBUG(!empty());
+    node_ptr old = root_;
+    root_ = merge_pairs(old->child);
+    destroy_node(old);
+    --size_;
+  }
+
+  void erase(handle_type h);
+
+  // 修改句柄 h 对应的元素
+  void update(handle_type h, const value_type& value)
+  { M_update(h.node_, value); }
+  void update(handle_type h, value_type&& value)
+  { M_update(h.node_, mystl::move(value)); }
+
+  // 提高句柄 h 对应元素的优先级，新值不应小于旧值
+  void increase_key(handle_type h, const value_type& value)
+  { M_increase(h.node_, value); }
+  void increase_key(handle_type h, value_type&& value)
+  { M_increase(h.node_, mystl::move(value)); }
+
+  // 降低句柄 h 对应元素的优先级，新值不应大于旧值
+  void decrease_key(handle_type h, const value_type& value)
+  {
+    MYSTL_DEBUG(!comp_(h.node_->value, value));
+    M_update(h.node_, value);
+  }
+  void decrease_key(handle_type h, value_type&& value)
+  {
+    MYSTL_DEBUG(!comp_(h.node_->value, value));
+    M_update(h.node_, mystl::move(value));
+  }
+
+  // 把 rhs 中的元素全部并入，rhs 变为空，rhs 的句柄在本堆中继续有效
+  void merge(pairing_heap& rhs);
+  void merge(pairing_heap&& rhs)
+  { merge(rhs); }
+
+  void clear() noexcept;
+
+  void swap(pairing_heap& rhs) noexcept
+  {
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename node_traits::propagate_on_container_swap());
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  // helper functions
+
+  // node
+  template <class... Args>
+  node_ptr create_node(Args&& ...args);
+  void     destroy_node(node_ptr np) noexcept;
+
+  // link
+  node_ptr meld(node_ptr a, node_ptr b);
+  node_ptr merge_pairs(node_ptr first);
+  void     cut(node_ptr np) noexcept;
+  void     copy_from(const pairing_heap& rhs);
+
+  template <class V>
+  void M_increase(node_ptr np, V&& value)
+  {
+    MYSTL_DEBUG(!comp_(value, np->value));
+    np->value = mystl::forward<V>(value);
+    if (np != root_)
+    {
+      cut(np);
+      root_ = meld(root_, np);
+    }
+  }
+
+  // 摘下节点，把它的子树合并回堆中，再把它作为单个节点插入
+  template <class V>
+  void M_update(node_ptr np, V&& value)
+  {
+    np->value = mystl::forward<V>(value);
+    node_ptr sub = merge_pairs(np->child);
+    np->child = nullptr;
+    if (np == root_)
+    {
+      root_ = meld(sub, np);
+    }
+    else
+    {
+      cut(np);
+      root_ = meld(meld(root_, sub), np);
+    }
+  }
+};
+
+/*****************************************************************************************/
+
+// 删除句柄 h 对应的元素
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+erase(handle_type h)
+{
+  node_ptr np = h.node_;
+  MYSTL_DEBUG(np != nullptr);
+  if (np == root_)
+  {
+    pop();
+    return;
+  }
+  cut(np);
+  root_ = meld(root_, merge_pairs(np->child));
+  destroy_node(np);
+  --size_;
+}
+
+// 合并两个堆
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+merge(pairing_heap& rhs)
+{
+  if (this == &rhs || rhs.empty())
+    return;
+  if (node_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    root_ = meld(root_, rhs.root_);
+    size_ += rhs.size_;
+    rhs.root_ = nullptr;
+    rhs.size_ = 0;
+    return;
+  }
+  // 分配器不相等时，只能逐个移动元素
+  while (!rhs.empty())
+  {
+    push(mystl::move(rhs.root_->value));
+    rhs.pop();
+  }
+}
+
+// 销毁所有节点：把每个节点的子节点链表接到它的兄弟链表上，再沿兄弟链表逐个释放
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+clear() noexcept
+{
+  node_ptr cur = root_;
+  while (cur != nullptr)
+  {
+    if (cur->child != nullptr)
+    {
+      node_ptr last = cur->child;
+      while (last->next != nullptr)
+        last = last->next;
+      last->next = cur->next;
+      cur->next = cur->child;
+    }
+    node_ptr next = cur->next;
+    destroy_node(cur);
+    cur = next;
+  }
+  root_ = nullptr;
+  size_ = 0;
+}
+
+// create_node 函数
+template <class T, class Compare, class Alloc>
+template <class... Args>
+typename pairing_heap<T, Compare, Alloc>::node_ptr
+pairing_heap<T, Compare, Alloc>::
+create_node(Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "pairing_heap<T>'s size too big");
+  node_ptr np = node_traits::allocate(M_alloc(), 1);
+  try
+  {
+    node_traits::construct(M_alloc(), mystl::address_of(np->value),
+                           mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    node_traits::deallocate(M_alloc(), np, 1);
+    throw;
+  }
+  np->child = nullptr;
+  np->next = nullptr;
+  np->prev = nullptr;
+  return np;
+}
+
+// destroy_node 函数
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+destroy_node(node_ptr np) noexcept
+{
+  node_traits::destroy(M_alloc(), mystl::address_of(np->value));
+  node_traits::deallocate(M_alloc(), np, 1);
+}
+
+// meld 函数
+// 合并两棵没有兄弟的树，根较小的一棵成为另一个根的第一个子节点，返回新的根
+template <class T, class Compare, class Alloc>
+typename pairing_heap<T, Compare, Alloc>::node_ptr
+pairing_heap<T, Compare, Alloc>::
+meld(node_ptr a, node_ptr b)
+{
+  if (a == nullptr)
+    return b;
+  if (b == nullptr)
+    return a;
+  if (comp_(a->value, b->value))
+    mystl::swap(a, b);
+  b->prev = a;
+  b->next = a->child;
+  if (a->child != nullptr)
+    a->child->prev = b;
+  a->child = b;
+  return a;
+}
+
+// merge_pairs 函数
+// 两趟合并以 first 开头的兄弟链表，返回合并后的根
+template <class T, class Compare, class Alloc>
+typename pairing_heap<T, Compare, Alloc>::node_ptr
+pairing_heap<T, Compare, Alloc>::
+merge_pairs(node_ptr first)
+{
+  if (first == nullptr)
+    return nullptr;
+  // 第一趟：从左到右两两合并，结果以 next 串成一个栈
+  node_ptr stack = nullptr;
+  while (first != nullptr)
+  {
+    node_ptr a = first;
+    node_ptr b = a->next;
+    first = b != nullptr ? b->next : nullptr;
+    a->next = a->prev = nullptr;
+    if (b != nullptr)
+      b->next = b->prev = nullptr;
+    node_ptr m = meld(a, b);
+    m->next = stack;
+    stack = m;
+  }
+  // 第二趟：从右到左依次合并
+  node_ptr result = stack;
+  stack = stack->next;
+  result->next = nullptr;
+  while (stack != nullptr)
+  {
+    node_ptr np = stack;
+    stack = stack->next;
+    np->next = nullptr;
+    result = meld(result, np);
+  }
+  result->prev = nullptr;
+  return result;
+}
+
+// cut 函数
+// 把以 np 为根的子树从树中摘下，np 不能是根节点
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+cut(node_ptr np) noexcept
+{
+  if (np->prev->child == np)
+    np->prev->child = np->next;  // np 是最左的子节点，prev 是父节点
+  else
+    np->prev->next = np->next;
+  if (np->next != nullptr)
+    np->next->prev = np->prev;
+  np->next = nullptr;
+  np->prev = nullptr;
+}
+
+// copy_from 函数
+// 遍历 rhs 的所有节点逐个插入，push 为 O(1)，整体为 O(n)
+template <class T, class Compare, class Alloc>
+void pairing_heap<T, Compare, Alloc>::
+copy_from(const pairing_heap& rhs)
+{
+  if (rhs.root_ == nullptr)
+    return;
+  mystl::vector<const node_type*> stack;
+  stack.reserve(rhs.size_);
+  stack.push_back(rhs.root_);
+  try
+  {
+    while (!stack.empty())
+    {
+      const node_type* np = stack.back();
+      stack.pop_back();
+      push(np->value);
+      for (const node_type* c = np->child; c != nullptr; c = c->next)
+        stack.push_back(c);
+    }
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare, class Alloc>
+void swap(pairing_heap<T, Compare, Alloc>& lhs, pairing_heap<T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_PAIRING_HEAP_H_
+
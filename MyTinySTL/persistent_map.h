@@ -0,0 +1,870 @@
+﻿#ifndef MYTINYSTL_PERSISTENT_MAP_H_
+#define MYTINYSTL_PERSISTENT_MAP_H_
+
+// 这个头文件包含一个模板类 persistent_map
+// persistent_map : 可持久化的映射，键值不允许重复，复制的复杂度为 O(1)，各个版本共享没有修改过的节点
+
+// notes:
+//
+// 1. 底层是没有父指针的红黑树，插入使用 Okasaki 的平衡方法，删除使用 Kahrs 的方法，
+//    修改只复制从根到目标节点的路径（path copying），每次修改最多复制 O(log n) 个节点
+// 2. 节点带有原子的引用计数，复制 persistent_map 只增加根节点的计数；
+//    被多个版本共享的节点不会再被修改，因此任意线程都可以不加锁地读取自己持有的版本
+// 3. 插入时路径上的节点只被当前版本持有（计数为 1）就直接在原节点上修改，不分配内存，
+//    只有一个版本时与普通的红黑树一样快；删除总是复制路径，以便在抛出异常时退回原来的版本
+// 4. 同一个 persistent_map 对象不能一边被修改一边被其它线程读取或复制，
+//    发布新版本时请用互斥锁等方式保护持有“当前版本”的对象，读者复制一份后即可无锁读取
+// 5. 迭代器是只读的前向迭代器，内部保存从根到当前节点的路径，在产生它的对象被修改或析构前有效；
+//    元素的引用在还有任意一个版本持有该节点时都有效
+// 6. 各个版本的节点由最后一个持有它的版本释放，分配器随复制、赋值、交换一起传播，
+//    必须能够释放其它副本分配的内存
+//
+// 异常保证：
+// mystl::persistent_map<Key, T> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * insert
+//   * try_emplace
+//   * erase
+
+#include <atomic>
+#include <initializer_list>
+#include <new>
+
+#include "rb_tree.h"
+#include "small_vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// persistent_map 的节点，没有父指针，因此可以被多棵树共享
+template <class T>
+struct persistent_rb_node
+{
+  typedef persistent_rb_node* node_ptr;
+
+  std::atomic<size_t> refs;
+  rb_tree_color_type  color;
+  node_ptr            left;
+  node_ptr            right;
+  T                   value;
+};
+
+// persistent_map 的迭代器
+// path_ 的栈顶是当前节点，其下是尚未访问、且当前节点位于其左子树中的祖先
+template <class T>
+struct persistent_map_iterator :public mystl::iterator<mystl::forward_iterator_tag, T>
+{
+  typedef const T*                          pointer;
+  typedef const T&                          reference;
+  typedef const persistent_rb_node<T>*      node_ptr;
+  typedef persistent_map_iterator<T>        self;
+
+  // 红黑树的高度不超过 2log(n+1)，32 层可以覆盖绝大多数的树，更高时才会分配内存
+  mystl::small_vector<node_ptr, 32> path_;
+
+  persistent_map_iterator() = default;
+
+  reference operator*()  const { return path_.back()->value; }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    node_ptr x = path_.back()->right;
+    path_.pop_back();
+    push_left(x);
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  // 从 x 出发沿左子树一直走到底
+  void push_left(node_ptr x)
+  {
+    for (; x != nullptr; x = x->left)
+      path_.push_back(x);
+  }
+
+  bool operator==(const self& rhs) const
+  {
+    return path_.empty() ? rhs.path_.empty()
+                         : !rhs.path_.empty() && path_.back() == rhs.path_.back();
+  }
+  bool operator!=(const self& rhs) const { return !(*this == rhs); }
+};
+
+// 模板类 persistent_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
+// 参数四代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
+class persistent_map
+{
+public:
+  typedef Key                                      key_type;
+  typedef T                                        mapped_type;
+  typedef mystl::pair<const Key, T>                value_type;
+  typedef Compare                                  key_compare;
+  typedef Alloc                                    allocator_type;
+
+  typedef const value_type*                        pointer;
+  typedef const value_type*                        const_pointer;
+  typedef const value_type&                        reference;
+  typedef const value_type&                        const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  // 元素不能通过迭代器修改，iterator 与 const_iterator 相同
+  typedef persistent_map_iterator<value_type>      const_iterator;
+  typedef const_iterator                           iterator;
+
+private:
+  typedef persistent_rb_node<value_type>           node_type;
+  typedef node_type*                               node_ptr;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<node_type>
+                                                   node_allocator;
+  typedef mystl::allocator_traits<node_allocator>  node_traits;
+
+  node_allocator alloc_;
+  node_ptr       root_;
+  size_type      size_;
+  key_compare    comp_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  persistent_map()
+    :alloc_(), root_(nullptr), size_(0), comp_()
+  {
+  }
+
+  explicit persistent_map(const Compare& comp, const allocator_type& alloc = allocator_type())
+    :alloc_(alloc), root_(nullptr), size_(0), comp_(comp)
+  {
+  }
+
+  template <class InputIter, typename std::enable_if<
+    mystl::is_input_iterator<InputIter>::value, int>::type = 0>
+  persistent_map(InputIter first, InputIter last)
+    :alloc_(), root_(nullptr), size_(0), comp_()
+  {
+    try
+    {
+      for (; first != last; ++first)
+        insert(*first);
+    }
+    catch (...)
+    {
+      release(root_);
+      throw;
+    }
+  }
+
+  persistent_map(std::initializer_list<value_type> ilist)
+    :persistent_map(ilist.begin(), ilist.end())
+  {
+  }
+
+  // 复制只增加根节点的引用计数
+  persistent_map(const persistent_map& rhs) noexcept
+    :alloc_(rhs.alloc_), root_(retain(rhs.root_)), size_(rhs.size_), comp_(rhs.comp_)
+  {
+  }
+
+  persistent_map(persistent_map&& rhs) noexcept
+    :alloc_(mystl::move(rhs.alloc_)), root_(rhs.root_), size_(rhs.size_),
+     comp_(mystl::move(rhs.comp_))
+  {
+    rhs.root_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  persistent_map& operator=(const persistent_map& rhs) noexcept
+  {
+    persistent_map tmp(rhs);
+    swap(tmp);
+    return *this;
+  }
+
+  persistent_map& operator=(persistent_map&& rhs) noexcept
+  {
+    persistent_map tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  persistent_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    persistent_map tmp(ilist);
+    swap(tmp);
+    return *this;
+  }
+
+  ~persistent_map() { release(root_); }
+
+public:
+  // 迭代器相关操作
+
+  const_iterator begin()  const { const_iterator it; it.push_left(root_); return it; }
+  const_iterator end()    const { return const_iterator(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend()   const { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(node_type); }
+
+  allocator_type get_allocator() const { return allocator_type(alloc_); }
+  key_compare    key_comp()      const { return comp_; }
+
+  // 两个对象是否共享同一棵树，此时它们的内容一定相同
+  bool shares_with(const persistent_map& rhs) const noexcept { return root_ == rhs.root_; }
+
+  // 访问元素相关操作
+
+  const mapped_type& at(const key_type& key) const
+  {
+    node_ptr x = find_node(key);
+    THROW_OUT_OF_RANGE_IF(x == nullptr, "persistent_map<Key, T> no such element exists");
+    return x->value.second;
+  }
+
+  // 查找相关操作
+
+  const_iterator find(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    return it == end() || comp_(key, it->first) ? end() : it;
+  }
+
+  size_type count(const key_type& key)    const { return find_node(key) != nullptr ? 1 : 0; }
+  bool      contains(const key_type& key) const { return find_node(key) != nullptr; }
+
+  const_iterator lower_bound(const key_type& key) const
+  {
+    const_iterator it;
+    for (node_ptr x = root_; x != nullptr; )
+    {
+      if (!comp_(x->value.first, key))
+      { // 向左走的节点都不小于 key，最后一个就是结果
+        it.path_.push_back(x);
+        x = x->left;
+      }
+      else
+      {
+        x = x->right;
+      }
+    }
+    return it;
+  }
+
+  const_iterator upper_bound(const key_type& key) const
+  {
+    const_iterator it;
+    for (node_ptr x = root_; x != nullptr; )
+    {
+      if (comp_(key, x->value.first))
+      {
+        it.path_.push_back(x);
+        x = x->left;
+      }
+      else
+      {
+        x = x->right;
+      }
+    }
+    return it;
+  }
+
+  mystl::pair<const_iterator, const_iterator>
+  equal_range(const key_type& key) const
+  { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+
+  // 修改容器相关操作，只影响当前对象，其它版本保持不变
+
+  // 键值不存在时插入，返回是否插入
+  bool insert(const value_type& value)
+  { return insert_value(value.first, value); }
+  bool insert(value_type&& value)
+  { return insert_value(value.first, mystl::move(value)); }
+
+  template <class ...Args>
+  bool try_emplace(const key_type& key, Args&& ...args)
+  {
+    return insert_value(key, mystl::emplace_second_t(), key, mystl::forward<Args>(args)...);
+  }
+
+  // 键值存在时赋值，否则插入，返回是否插入
+  template <class M>
+  bool insert_or_assign(const key_type& key, M&& obj)
+  {
+    // 键值已存在时 insert_value 不会使用 obj
+    if (insert_value(key, key, mystl::forward<M>(obj)))
+      return true;
+    assign_node(root_, key, mystl::forward<M>(obj));
+    return false;
+  }
+
+  // 删除键值为 key 的元素，返回删除的个数
+  size_type erase(const key_type& key);
+
+  void clear() noexcept
+  {
+    release(root_);
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  void swap(persistent_map& rhs) noexcept
+  {
+    mystl::swap(alloc_, rhs.alloc_);
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+public:
+  friend bool operator==(const persistent_map& lhs, const persistent_map& rhs)
+  {
+    return lhs.size_ == rhs.size_ &&
+      (lhs.root_ == rhs.root_ || mystl::equal(lhs.begin(), lhs.end(), rhs.begin()));
+  }
+  friend bool operator<(const persistent_map& lhs, const persistent_map& rhs)
+  {
+    return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  // 引用计数
+
+  static node_ptr retain(node_ptr x) noexcept
+  {
+    if (x != nullptr)
+      x->refs.fetch_add(1, std::memory_order_relaxed);
+    return x;
+  }
+
+  void release(node_ptr x) noexcept
+  {
+    if (x != nullptr && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      release(x->left);
+      release(x->right);
+      destroy_node(x);
+    }
+  }
+
+  // 只有当前版本持有 x 时才可以修改它，否则复制一份替换 x
+  void own(node_ptr& x)
+  {
+    if (x->refs.load(std::memory_order_acquire) == 1)
+      return;
+    node_ptr tmp = create_node(x->value);
+    tmp->color = x->color;
+    tmp->left = retain(x->left);
+    tmp->right = retain(x->right);
+    release(x);
+    x = tmp;
+  }
+
+  static bool is_red(node_ptr x) noexcept   { return x != nullptr && x->color == rb_tree_red; }
+  static bool is_black(node_ptr x) noexcept { return x != nullptr && x->color == rb_tree_black; }
+
+  // 节点的创建与销毁
+  template <class ...Args>
+  node_ptr create_node(Args&& ...args);
+  void     destroy_node(node_ptr x) noexcept;
+
+  node_ptr find_node(const key_type& key) const;
+
+  template <class ...Args>
+  bool insert_value(const key_type& key, Args&& ...args);
+  template <class ...Args>
+  bool insert_node(node_ptr& t, bool owned, const key_type& key, Args&& ...args);
+  void copy_with_child(node_ptr& t, bool owned, bool to_left, node_ptr child);
+  template <class M>
+  void assign_node(node_ptr& t, const key_type& key, M&& obj);
+
+  // 平衡与删除
+  void balance(node_ptr& t);
+  void balance_recolor(node_ptr& t);
+  void balance_left(node_ptr& t);
+  void balance_right(node_ptr& t);
+  void erase_node(node_ptr& t, const key_type& key);
+  void fuse(node_ptr& a, node_ptr& b);
+};
+
+/*****************************************************************************************/
+
+// 创建一个引用计数为 1 的红色节点
+template <class Key, class T, class Compare, class Alloc>
+template <class ...Args>
+typename persistent_map<Key, T, Compare, Alloc>::node_ptr
+persistent_map<Key, T, Compare, Alloc>::
+create_node(Args&& ...args)
+{
+  node_ptr tmp = node_traits::allocate(alloc_, 1);
+  try
+  {
+    node_traits::construct(alloc_, mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    node_traits::deallocate(alloc_, tmp, 1);
+    throw;
+  }
+  ::new (static_cast<void*>(mystl::address_of(tmp->refs))) std::atomic<size_t>(1);
+  tmp->color = rb_tree_red;
+  tmp->left = nullptr;
+  tmp->right = nullptr;
+  return tmp;
+}
+
+// 销毁一个节点，不处理子节点
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+destroy_node(node_ptr x) noexcept
+{
+  node_traits::destroy(alloc_, mystl::address_of(x->value));
+  node_traits::deallocate(alloc_, x, 1);
+}
+
+// 查找键值为 key 的节点，不存在时返回 nullptr
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::node_ptr
+persistent_map<Key, T, Compare, Alloc>::
+find_node(const key_type& key) const
+{
+  node_ptr x = root_;
+  while (x != nullptr)
+  {
+    if (comp_(key, x->value.first))
+      x = x->left;
+    else if (comp_(x->value.first, key))
+      x = x->right;
+    else
+      return x;
+  }
+  return nullptr;
+}
+
+// 键值不存在时以 args 构造元素并插入，键值已存在时不使用 args
+template <class Key, class T, class Compare, class Alloc>
+template <class ...Args>
+bool persistent_map<Key, T, Compare, Alloc>::
+insert_value(const key_type& key, Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "persistent_map<Key, T>'s size too big");
+  if (!insert_node(root_, true, key, mystl::forward<Args>(args)...))
+    return false;
+  root_->color = rb_tree_black;
+  ++size_;
+  return true;
+}
+
+// 在 t 中插入 key，键值已存在时返回 false，树不变
+// owned 表示 t 的所有祖先都只属于当前版本，此时 t 持有的引用属于当前版本
+// 向下查找时不修改任何节点，返回时复制不属于当前版本的节点，再就地修改属于当前版本的节点：
+// 后者总是位于路径的上段，因此可能抛出异常的分配都发生在修改树之前
+template <class Key, class T, class Compare, class Alloc>
+template <class ...Args>
+bool persistent_map<Key, T, Compare, Alloc>::
+insert_node(node_ptr& t, bool owned, const key_type& key, Args&& ...args)
+{
+  if (t == nullptr)
+  {
+    t = create_node(mystl::forward<Args>(args)...);
+    return true;
+  }
+  const bool exclusive = owned && t->refs.load(std::memory_order_acquire) == 1;
+  const bool to_left = comp_(key, t->value.first);
+  if (!to_left && !comp_(t->value.first, key))
+    return false;
+  if (exclusive)
+  {
+    if (!insert_node(to_left ? t->left : t->right, true, key, mystl::forward<Args>(args)...))
+      return false;
+  }
+  else
+  {
+    node_ptr child = to_left ? t->left : t->right;
+    if (!insert_node(child, false, key, mystl::forward<Args>(args)...))
+      return false;
+    copy_with_child(t, owned, to_left, child);
+  }
+  // 只有路径上的子节点是红色时才可能出现连续的红色节点
+  if (t->color == rb_tree_black && is_red(to_left ? t->left : t->right))
+    balance(t);
+  return true;
+}
+
+// 复制 t，以 child 代替它左边或右边的子树，owned 表示 t 持有的引用属于当前版本
+// 复制失败时释放 child，t 保持不变
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+copy_with_child(node_ptr& t, bool owned, bool to_left, node_ptr child)
+{
+  node_ptr tmp;
+  try
+  {
+    tmp = create_node(t->value);
+  }
+  catch (...)
+  {
+    release(child);
+    throw;
+  }
+  tmp->color = t->color;
+  tmp->left = to_left ? child : retain(t->left);
+  tmp->right = to_left ? retain(t->right) : child;
+  if (owned)
+    release(t);
+  t = tmp;
+}
+
+// 复制到 key 为止的路径，为它的实值赋值
+template <class Key, class T, class Compare, class Alloc>
+template <class M>
+void persistent_map<Key, T, Compare, Alloc>::
+assign_node(node_ptr& t, const key_type& key, M&& obj)
+{
+  own(t);
+  if (comp_(key, t->value.first))
+    assign_node(t->left, key, mystl::forward<M>(obj));
+  else if (comp_(t->value.first, key))
+    assign_node(t->right, key, mystl::forward<M>(obj));
+  else
+    t->value.second = mystl::forward<M>(obj);
+}
+
+// 删除键值为 key 的元素
+// 先持有原来的根，使删除过程中的每个节点都被复制，抛出异常时释放复制出的节点并恢复原来的根
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::size_type
+persistent_map<Key, T, Compare, Alloc>::
+erase(const key_type& key)
+{
+  if (find_node(key) == nullptr)
+    return 0;
+  node_ptr old = retain(root_);
+  try
+  {
+    erase_node(root_, key);
+    if (root_ != nullptr)
+    {
+      own(root_);
+      root_->color = rb_tree_black;
+    }
+  }
+  catch (...)
+  {
+    release(root_);
+    root_ = old;
+    throw;
+  }
+  release(old);
+  --size_;
+  return 1;
+}
+
+/*****************************************************************************************/
+// 平衡与删除，t 都已经属于当前版本，左右子树的黑高可能不相等
+
+// 黑色节点 t 的某个子节点与孙节点都是红色时，把这三个节点中键值居中的一个旋转到根，
+// 改为红色，另外两个作为它的黑色子节点；没有这样的红色节点时 t 为黑色
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+balance(node_ptr& t)
+{
+  if (is_red(t->left))
+  {
+    if (is_red(t->left->left))
+    {
+      own(t->left);
+      node_ptr y = t->left;
+      own(y->left);
+      y->left->color = rb_tree_black;
+      t->left = y->right;
+      t->color = rb_tree_black;
+      y->right = t;
+      y->color = rb_tree_red;
+      t = y;
+      return;
+    }
+    if (is_red(t->left->right))
+    {
+      own(t->left);
+      node_ptr x = t->left;
+      own(x->right);
+      node_ptr y = x->right;
+      x->right = y->left;
+      x->color = rb_tree_black;
+      t->left = y->right;
+      t->color = rb_tree_black;
+      y->left = x;
+      y->right = t;
+      y->color = rb_tree_red;
+      t = y;
+      return;
+    }
+  }
+  if (is_red(t->right))
+  {
+    if (is_red(t->right->right))
+    {
+      own(t->right);
+      node_ptr y = t->right;
+      own(y->right);
+      y->right->color = rb_tree_black;
+      t->right = y->left;
+      t->color = rb_tree_black;
+      y->left = t;
+      y->color = rb_tree_red;
+      t = y;
+      return;
+    }
+    if (is_red(t->right->left))
+    {
+      own(t->right);
+      node_ptr z = t->right;
+      own(z->left);
+      node_ptr y = z->left;
+      z->left = y->right;
+      z->color = rb_tree_black;
+      t->right = y->left;
+      t->color = rb_tree_black;
+      y->left = t;
+      y->right = z;
+      y->color = rb_tree_red;
+      t = y;
+      return;
+    }
+  }
+  t->color = rb_tree_black;
+}
+
+// 删除时使用的平衡：两个子节点都是红色时只改变颜色
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+balance_recolor(node_ptr& t)
+{
+  if (is_red(t->left) && is_red(t->right))
+  {
+    own(t->left);
+    own(t->right);
+    t->left->color = rb_tree_black;
+    t->right->color = rb_tree_black;
+    t->color = rb_tree_red;
+    return;
+  }
+  balance(t);
+}
+
+// t 的左子树的黑高比右子树少一
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+balance_left(node_ptr& t)
+{
+  if (is_red(t->left))
+  {
+    own(t->left);
+    t->left->color = rb_tree_black;
+    t->color = rb_tree_red;
+    return;
+  }
+  if (is_black(t->right))
+  {
+    own(t->right);
+    t->right->color = rb_tree_red;
+    balance_recolor(t);
+    return;
+  }
+  // 右子节点为红色，它的左子节点 y 为黑色，y 成为新的根
+  MYSTL_DEBUG(is_red(t->right) && is_black(t->right->left));
+  own(t->right);
+  node_ptr z = t->right;
+  own(z->left);
+  own(z->right);
+  node_ptr y = z->left;
+  z->right->color = rb_tree_red;
+  t->right = y->left;
+  t->color = rb_tree_black;
+  z->left = y->right;
+  y->left = t;
+  y->right = z;
+  y->color = rb_tree_red;
+  t = y;
+  balance_recolor(y->right);
+}
+
+// t 的右子树的黑高比左子树少一
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+balance_right(node_ptr& t)
+{
+  if (is_red(t->right))
+  {
+    own(t->right);
+    t->right->color = rb_tree_black;
+    t->color = rb_tree_red;
+    return;
+  }
+  if (is_black(t->left))
+  {
+    own(t->left);
+    t->left->color = rb_tree_red;
+    balance_recolor(t);
+    return;
+  }
+  // 左子节点为红色，它的右子节点 y 为黑色，y 成为新的根
+  MYSTL_DEBUG(is_red(t->left) && is_black(t->left->right));
+  own(t->left);
+  node_ptr x = t->left;
+  own(x->right);
+  own(x->left);
+  node_ptr y = x->right;
+  x->left->color = rb_tree_red;
+  t->left = y->right;
+  t->color = rb_tree_black;
+  x->right = y->left;
+  y->left = x;
+  y->right = t;
+  y->color = rb_tree_red;
+  t = y;
+  balance_recolor(y->left);
+}
+
+// 从 t 中删除 key，删除黑色子树中的节点后黑高减一，由 balance_left / balance_right 补偿
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+erase_node(node_ptr& t, const key_type& key)
+{
+  own(t);
+  if (comp_(key, t->value.first))
+  {
+    const bool black_child = is_black(t->left);
+    erase_node(t->left, key);
+    if (black_child)
+      balance_left(t);
+    else
+      t->color = rb_tree_red;
+  }
+  else if (comp_(t->value.first, key))
+  {
+    const bool black_child = is_black(t->right);
+    erase_node(t->right, key);
+    if (black_child)
+      balance_right(t);
+    else
+      t->color = rb_tree_red;
+  }
+  else
+  { // 合并左右子树代替 t
+    fuse(t->left, t->right);
+    node_ptr x = t;
+    t = x->left;
+    x->left = nullptr;
+    release(x);
+  }
+}
+
+// 把黑高相同的 a、b 合并到 a 中，a 的元素都小于 b 的元素，结束后 b 为空
+// 合并过程中所有节点都挂在 a、b 之下，抛出异常时仍然可以被释放
+template <class Key, class T, class Compare, class Alloc>
+void persistent_map<Key, T, Compare, Alloc>::
+fuse(node_ptr& a, node_ptr& b)
+{
+  if (a == nullptr)
+  {
+    a = b;
+    b = nullptr;
+    return;
+  }
+  if (b == nullptr)
+    return;
+  if (a->color == b->color)
+  { // 合并 a 的右子树与 b 的左子树，结果为红色时它成为新的根
+    own(a);
+    own(b);
+    fuse(a->right, b->left);
+    if (is_red(a->right))
+    {
+      own(a->right);
+      node_ptr m = a->right;
+      a->right = m->left;
+      b->left = m->right;
+      m->left = a;
+      m->right = b;
+      a = m;
+      b = nullptr;
+    }
+    else
+    { // b 挂到 a 之下后立即置空，此后的 balance_left 抛出异常时 b 不会被释放两次
+      b->left = a->right;
+      a->right = b;
+      b = nullptr;
+      if (a->color == rb_tree_black)
+        balance_left(a);
+    }
+  }
+  else if (b->color == rb_tree_red)
+  {
+    own(b);
+    fuse(a, b->left);
+    b->left = a;
+    a = b;
+    b = nullptr;
+  }
+  else
+  {
+    own(a);
+    fuse(a->right, b);
+  }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+                const persistent_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const persistent_map<Key, T, Compare, Alloc>& lhs,
+               const persistent_map<Key, T, Compare, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+                const persistent_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+                const persistent_map<Key, T, Compare, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare, class Alloc>
+void swap(persistent_map<Key, T, Compare, Alloc>& lhs,
+          persistent_map<Key, T, Compare, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_PERSISTENT_MAP_H_
+
@@ -0,0 +1,759 @@
+﻿#ifndef MYTINYSTL_PERSISTENT_VECTOR_H_
+#define MYTINYSTL_PERSISTENT_VECTOR_H_
+
+// 这个头文件包含一个模板类 persistent_vector
+// persistent_vector : 可持久化的向量，复制的复杂度为 O(1)，各个版本共享没有修改过的节点
+
+// notes:
+//
+// 1. 底层是分支数为 32 的前缀树（bit-partitioned trie），下标每 5 位选择一层的子节点，
+//    最后不满 32 个的元素单独放在 tail 中，因此 push_back / pop_back 通常只修改 tail
+// 2. 按下标访问与 set 的复杂度为 O(log32 n)，修改时只复制从根到叶子的路径
+// 3. 节点带有原子的引用计数，复制 persistent_vector 只增加根与 tail 的计数；
+//    被多个版本共享的节点不会再被修改，因此任意线程都可以不加锁地读取自己持有的版本
+// 4. 路径上的节点只被当前版本持有（计数为 1）时直接在原节点上修改，不分配内存
+// 5. 同一个 persistent_vector 对象不能一边被修改一边被其它线程读取或复制，
+//    发布新版本时请用互斥锁等方式保护持有“当前版本”的对象，读者复制一份后即可无锁读取
+// 6. 只支持在尾部增删元素，前缀树中的叶子总是满的，下标直接按位计算，
+//    没有 RRB 树的 concat 与任意位置插入，也就不需要保存每个子树的大小
+// 7. 迭代器是只读的随机访问迭代器，缓存当前叶子，顺序遍历时每 32 个元素才查找一次；
+//    迭代器在产生它的对象被修改或析构前有效
+// 8. 分配器随复制、赋值、交换一起传播，必须能够释放其它副本分配的内存
+//
+// 异常保证：
+// mystl::persistent_vector<T> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * emplace_back
+//   * push_back
+
+#include <atomic>
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "algobase.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 每层使用的下标位数与分支数
+constexpr size_t persistent_vector_bits  = 5;
+constexpr size_t persistent_vector_width = size_t(1) << persistent_vector_bits;
+constexpr size_t persistent_vector_mask  = persistent_vector_width - 1;
+
+// persistent_vector 的节点，只有引用计数，叶子与内部节点由所在的层区分
+struct persistent_vector_node
+{
+  std::atomic<size_t> refs;
+
+  persistent_vector_node() noexcept :refs(1) {}
+};
+
+// 内部节点，子节点不足 32 个时其余为 nullptr
+struct persistent_vector_branch :public persistent_vector_node
+{
+  persistent_vector_node* child[persistent_vector_width];
+
+  persistent_vector_branch() noexcept
+  {
+    for (size_t i = 0; i < persistent_vector_width; ++i)
+      child[i] = nullptr;
+  }
+};
+
+// 叶子，保存 count 个已构造的元素
+template <class T>
+struct persistent_vector_leaf :public persistent_vector_node
+{
+  size_t count;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[persistent_vector_width];
+
+  persistent_vector_leaf() noexcept :count(0) {}
+
+  T*       data()       noexcept { return reinterpret_cast<T*>(buf); }
+  const T* data() const noexcept { return reinterpret_cast<const T*>(buf); }
+};
+
+template <class T, class Alloc>
+class persistent_vector;
+
+// persistent_vector 的迭代器，block_ 指向 index_ 所在叶子的第一个元素
+template <class T, class Alloc>
+struct persistent_vector_iterator
+  :public mystl::iterator<mystl::random_access_iterator_tag, T, ptrdiff_t, const T*, const T&>
+{
+  typedef persistent_vector<T, Alloc>            container_type;
+  typedef persistent_vector_iterator<T, Alloc>   self;
+  typedef const T*                               pointer;
+  typedef const T&                               reference;
+  typedef size_t                                 size_type;
+  typedef ptrdiff_t                              difference_type;
+
+  const container_type* vec_;
+  size_type             index_;
+  const T*              block_;
+
+  persistent_vector_iterator() noexcept :vec_(nullptr), index_(0), block_(nullptr) {}
+  persistent_vector_iterator(const container_type* vec, size_type index)
+    :vec_(vec), index_(index), block_(nullptr)
+  {
+    sync();
+  }
+
+  // 重新查找 index_ 所在的叶子
+  void sync()
+  {
+    block_ = index_ < vec_->size() ? vec_->leaf_data(index_) : nullptr;
+  }
+
+  reference operator*()  const { return block_[index_ & persistent_vector_mask]; }
+  pointer   operator->() const { return &(operator*()); }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  self& operator++()
+  {
+    if ((++index_ & persistent_vector_mask) == 0)
+      sync();
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    const bool cross = (index_ & persistent_vector_mask) == 0;
+    --index_;
+    if (cross || block_ == nullptr)
+      sync();
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n)
+  {
+    index_ += n;
+    sync();
+    return *this;
+  }
+  self& operator-=(difference_type n) { return *this += -n; }
+  self  operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+  self  operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+  friend self operator+(difference_type n, const self& it) { return it + n; }
+
+  difference_type operator-(const self& rhs) const
+  { return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_); }
+
+  bool operator==(const self& rhs) const { return index_ == rhs.index_; }
+  bool operator!=(const self& rhs) const { return index_ != rhs.index_; }
+  bool operator<(const self& rhs)  const { return index_ < rhs.index_; }
+  bool operator>(const self& rhs)  const { return rhs < *this; }
+  bool operator<=(const self& rhs) const { return !(rhs < *this); }
+  bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+// 模板类 persistent_vector
+// 参数一代表元素类型，参数二代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
+class persistent_vector
+{
+  friend struct persistent_vector_iterator<T, Alloc>;
+
+public:
+  typedef T                                        value_type;
+  typedef Alloc                                    allocator_type;
+  typedef const T*                                 pointer;
+  typedef const T*                                 const_pointer;
+  typedef const T&                                 reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  // 元素不能通过迭代器修改，iterator 与 const_iterator 相同
+  typedef persistent_vector_iterator<T, Alloc>     const_iterator;
+  typedef const_iterator                           iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+  typedef const_reverse_iterator                   reverse_iterator;
+
+private:
+  typedef persistent_vector_node                   node_type;
+  typedef persistent_vector_branch                 branch_type;
+  typedef persistent_vector_leaf<T>                leaf_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<branch_type>
+                                                   branch_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<leaf_type>
+                                                   leaf_allocator;
+  typedef mystl::allocator_traits<branch_allocator> branch_traits;
+  typedef mystl::allocator_traits<leaf_allocator>   leaf_traits;
+
+  static constexpr size_type bits  = persistent_vector_bits;
+  static constexpr size_type width = persistent_vector_width;
+  static constexpr size_type mask  = persistent_vector_mask;
+
+  branch_allocator branch_alloc_;
+  leaf_allocator   leaf_alloc_;
+  node_type*       root_;   // 前缀树的根，位于第 shift_ 层，叶子位于第 0 层
+  leaf_type*       tail_;   // 最后 1 ~ 32 个元素，为空时是 nullptr
+  size_type        size_;
+  size_type        shift_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  persistent_vector() noexcept
+    :branch_alloc_(), leaf_alloc_(), root_(nullptr), tail_(nullptr), size_(0), shift_(bits)
+  {
+  }
+
+  explicit persistent_vector(const allocator_type& alloc) noexcept
+    :branch_alloc_(alloc), leaf_alloc_(alloc), root_(nullptr), tail_(nullptr),
+     size_(0), shift_(bits)
+  {
+  }
+
+  persistent_vector(size_type n, const value_type& value)
+    :persistent_vector()
+  {
+    try
+    {
+      for (; n > 0; --n)
+        push_back(value);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  template <class InputIter, typename std::enable_if<
+    mystl::is_input_iterator<InputIter>::value, int>::type = 0>
+  persistent_vector(InputIter first, InputIter last)
+    :persistent_vector()
+  {
+    try
+    {
+      for (; first != last; ++first)
+        push_back(*first);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  persistent_vector(std::initializer_list<value_type> ilist)
+    :persistent_vector(ilist.begin(), ilist.end())
+  {
+  }
+
+  // 复制只增加根与 tail 的引用计数
+  persistent_vector(const persistent_vector& rhs) noexcept
+    :branch_alloc_(rhs.branch_alloc_), leaf_alloc_(rhs.leaf_alloc_),
+     root_(retain(rhs.root_)), tail_(retain(rhs.tail_)), size_(rhs.size_), shift_(rhs.shift_)
+  {
+  }
+
+  persistent_vector(persistent_vector&& rhs) noexcept
+    :branch_alloc_(mystl::move(rhs.branch_alloc_)), leaf_alloc_(mystl::move(rhs.leaf_alloc_)),
+     root_(rhs.root_), tail_(rhs.tail_), size_(rhs.size_), shift_(rhs.shift_)
+  {
+    rhs.root_ = nullptr;
+    rhs.tail_ = nullptr;
+    rhs.size_ = 0;
+    rhs.shift_ = bits;
+  }
+
+  persistent_vector& operator=(const persistent_vector& rhs) noexcept
+  {
+    persistent_vector tmp(rhs);
+    swap(tmp);
+    return *this;
+  }
+
+  persistent_vector& operator=(persistent_vector&& rhs) noexcept
+  {
+    persistent_vector tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  persistent_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    persistent_vector tmp(ilist);
+    swap(tmp);
+    return *this;
+  }
+
+  ~persistent_vector() { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  const_iterator         begin()   const { return const_iterator(this, 0); }
+  const_iterator         end()     const { return const_iterator(this, size_); }
+  const_iterator         cbegin()  const { return begin(); }
+  const_iterator         cend()    const { return end(); }
+  const_reverse_iterator rbegin()  const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend()    const { return const_reverse_iterator(begin()); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+  allocator_type get_allocator() const { return allocator_type(leaf_alloc_); }
+
+  // 两个对象是否共享全部节点，此时它们的内容一定相同
+  bool shares_with(const persistent_vector& rhs) const noexcept
+  { return root_ == rhs.root_ && tail_ == rhs.tail_ && size_ == rhs.size_; }
+
+  // 访问元素相关操作
+
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return leaf_data(n)[n & mask];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "persistent_vector<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+  const_reference back() const
+  {
+    MYSTL_DEBUG(!empty());
+    return tail_->data()[tail_->count - 1];
+  }
+
+  // 修改容器相关操作，只影响当前对象，其它版本保持不变
+
+  template <class ...Args>
+  void emplace_back(Args&& ...args);
+
+  void push_back(const value_type& value) { emplace_back(value); }
+  void push_back(value_type&& value)      { emplace_back(mystl::move(value)); }
+
+  void pop_back();
+
+  // 替换下标为 n 的元素
+  void set(size_type n, const value_type& value) { set_value(n, value); }
+  void set(size_type n, value_type&& value)      { set_value(n, mystl::move(value)); }
+
+  void clear() noexcept
+  {
+    release(root_, shift_);
+    release_leaf(tail_);
+    root_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+    shift_ = bits;
+  }
+
+  void swap(persistent_vector& rhs) noexcept
+  {
+    mystl::swap(branch_alloc_, rhs.branch_alloc_);
+    mystl::swap(leaf_alloc_, rhs.leaf_alloc_);
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(tail_, rhs.tail_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(shift_, rhs.shift_);
+  }
+
+private:
+  // tail 中第一个元素的下标
+  size_type tail_offset() const noexcept
+  { return size_ < width ? 0 : ((size_ - 1) >> bits) << bits; }
+
+  // 下标为 n 的元素所在的叶子
+  const leaf_type* leaf_node(size_type n) const noexcept
+  {
+    if (n >= tail_offset())
+      return tail_;
+    const node_type* x = root_;
+    for (size_type level = shift_; level > 0; level -= bits)
+      x = static_cast<const branch_type*>(x)->child[(n >> level) & mask];
+    return static_cast<const leaf_type*>(x);
+  }
+  const T* leaf_data(size_type n) const noexcept { return leaf_node(n)->data(); }
+
+  // 引用计数
+  template <class Node>
+  static Node* retain(Node* x) noexcept
+  {
+    if (x != nullptr)
+      x->refs.fetch_add(1, std::memory_order_relaxed);
+    return x;
+  }
+  void release(node_type* x, size_type level) noexcept;
+  void release_leaf(leaf_type* x) noexcept;
+
+  // 节点的创建、复制与销毁
+  branch_type* create_branch();
+  leaf_type*   create_leaf();
+  branch_type* own_branch(node_type* x, size_type level);
+  leaf_type*   own_leaf(leaf_type* x);
+
+  node_type*   make_path(size_type level, leaf_type* leaf);
+  void         push_tail();
+  bool         pop_tail(node_type*& x, size_type level, size_type index);
+
+  template <class V>
+  void         set_value(size_type n, V&& value);
+};
+
+/*****************************************************************************************/
+
+// 释放第 level 层的节点 x
+template <class T, class Alloc>
+void persistent_vector<T, Alloc>::
+release(node_type* x, size_type level) noexcept
+{
+  if (level == 0)
+  {
+    release_leaf(static_cast<leaf_type*>(x));
+    return;
+  }
+  if (x != nullptr && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    branch_type* b = static_cast<branch_type*>(x);
+    for (size_type i = 0; i < width && b->child[i] != nullptr; ++i)
+      release(b->child[i], level - bits);
+    branch_traits::destroy(branch_alloc_, b);
+    branch_traits::deallocate(branch_alloc_, b, 1);
+  }
+}
+
+template <class T, class Alloc>
+void persistent_vector<T, Alloc>::
+release_leaf(leaf_type* x) noexcept
+{
+  if (x != nullptr && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    mystl::destroy(x->data(), x->data() + x->count);
+    leaf_traits::destroy(leaf_alloc_, x);
+    leaf_traits::deallocate(leaf_alloc_, x, 1);
+  }
+}
+
+template <class T, class Alloc>
+typename persistent_vector<T, Alloc>::branch_type*
+persistent_vector<T, Alloc>::
+create_branch()
+{
+  branch_type* x = branch_traits::allocate(branch_alloc_, 1);
+  branch_traits::construct(branch_alloc_, x);
+  return x;
+}
+
+template <class T, class Alloc>
+typename persistent_vector<T, Alloc>::leaf_type*
+persistent_vector<T, Alloc>::
+create_leaf()
+{
+  leaf_type* x = leaf_traits::allocate(leaf_alloc_, 1);
+  leaf_traits::construct(leaf_alloc_, x);
+  return x;
+}
+
+// 只有当前版本持有 x 时直接返回，否则返回 x 的副本并释放 x
+template <class T, class Alloc>
+typename persistent_vector<T, Alloc>::branch_type*
+persistent_vector<T, Alloc>::
+own_branch(node_type* x, size_type level)
+{
+  branch_type* b = static_cast<branch_type*>(x);
+  if (b->refs.load(std::memory_order_acquire) == 1)
+    return b;
+  branch_type* tmp = create_branch();
+  for (size_type i = 0; i < width; ++i)
+    tmp->child[i] = retain(b->child[i]);
+  release(b, level);
+  return tmp;
+}
+
+template <class T, class Alloc>
+typename persistent_vector<T, Alloc>::leaf_type*
+persistent_vector<T, Alloc>::
+own_leaf(leaf_type* x)
+{
+  if (x->refs.load(std::memory_order_acquire) == 1)
+    return x;
+  leaf_type* tmp = create_leaf();
+  try
+  {
+    for (; tmp->count < x->count; ++tmp->count)
+      mystl::construct(tmp->data() + tmp->count, x->data()[tmp->count]);
+  }
+  catch (...)
+  {
+    release_leaf(tmp);
+    throw;
+  }
+  release_leaf(x);
+  return tmp;
+}
+
+// 创建从第 level 层到 leaf 的一条路径，路径持有 leaf 的一个引用
+template <class T, class Alloc>
+typename persistent_vector<T, Alloc>::node_type*
+persistent_vector<T, Alloc>::
+make_path(size_type level, leaf_type* leaf)
+{
+  node_type* x = retain(leaf);
+  for (size_type l = bits; l <= level; l += bits)
+  {
+    branch_type* b;
+    try
+    {
+      b = create_branch();
+    }
+    catch (...)
+    {
+      release(x, l - bits);
+      throw;
+    }
+    b->child[0] = x;
+    x = b;
+  }
+  return x;
+}
+
+// 把已满的 tail_ 放入前缀树，它的元素下标为 [size_ - width, size_)
+template <class T, class Alloc>
+void persistent_vector<T, Alloc>::
+push_tail()
+{
+  const size_type index = size_ - 1;
+  if (root_ == nullptr)
+  {
+    branch_type* root = create_branch();
+    root->child[0] = retain(tail_);
+    root_ = root;
+    return;
+  }
+  if ((size_ >> bits) > (size_type(1) << shift_))
+  { // 根已满，树增高一层
+    node_type* path = make_path(shift_, tail_);
+    branch_type* root;
+    try
+    {
+      root = create_branch();
+    }
+    catch (...)
+    {
+      release(path, shift_);
+      throw;
+    }
+    root->child[0] = root_;
+    root->child[1] = path;
+    root_ = root;
+    shift_ += bits;
+    return;
+  }
+  branch_type* parent = own_branch(root_, shift_);
+  root_ = parent;
+  for (size_type level = shift_; level > bits; level -= bits)
+  {
+    node_type*& child = parent->child[(index >> level) & mask];
+    if (child == nullptr)
+    {
+      child = make_path(level - bits, tail_);
+      return;
+    }
+    child = own_branch(child, level - bits);
+    parent = static_cast<branch_type*>(child);
+  }
+  parent->child[(index >> bits) & mask] = retain(tail_);
+}
+
+// 删除前缀树中最后一个叶子，它包含下标 index，x 因此变空时返回 true
+template <class T, class Alloc>
+bool persistent_vector<T, Alloc>::
+pop_tail(node_type*& x, size_type level, size_type index)
+{
+  branch_type* b = own_branch(x, level);
+  x = b;
+  const size_type i = (index >> level) & mask;
+  if (level > bits && !pop_tail(b->child[i], level - bits, index))
+    return false;
+  release(b->child[i], level - bits);
+  b->child[i] = nullptr;
+  return i == 0;
+}
+
+// 在尾部就地构造元素
+template <class T, class Alloc>
+template <class ...Args>
+void persistent_vector<T, Alloc>::
+emplace_back(Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "persistent_vector<T>'s size too big");
+  if (tail_ != nullptr && tail_->count < width)
+  {
+    tail_ = own_leaf(tail_);
+    mystl::construct(tail_->data() + tail_->count, mystl::forward<Args>(args)...);
+    ++tail_->count;
+    ++size_;
+    return;
+  }
+  // tail 已满或为空：先构造新的 tail，再把旧的 tail 放入前缀树
+  leaf_type* leaf = create_leaf();
+  try
+  {
+    mystl::construct(leaf->data(), mystl::forward<Args>(args)...);
+    leaf->count = 1;
+    if (tail_ != nullptr)
+      push_tail();
+  }
+  catch (...)
+  {
+    release_leaf(leaf);
+    throw;
+  }
+  release_leaf(tail_);
+  tail_ = leaf;
+  ++size_;
+}
+
+// 删除尾部的元素，tail 变空时把前缀树的最后一个叶子取出作为新的 tail
+template <class T, class Alloc>
+void persistent_vector<T, Alloc>::
+pop_back()
+{
+  MYSTL_DEBUG(!empty());
+  if (tail_->count > 1)
+  {
+    tail_ = own_leaf(tail_);
+    mystl::destroy(tail_->data() + tail_->count - 1);
+    --tail_->count;
+    --size_;
+    return;
+  }
+  if (size_ == 1)
+  {
+    clear();
+    return;
+  }
+  leaf_type* leaf = retain(const_cast<leaf_type*>(leaf_node(size_ - 2)));
+  try
+  {
+    if (size_ - 2 < width)
+    { // 前缀树中只有这一个叶子
+      release(root_, shift_);
+      root_ = nullptr;
+      shift_ = bits;
+    }
+    else
+    {
+      pop_tail(root_, shift_, size_ - 2);
+      branch_type* root = static_cast<branch_type*>(root_);
+      if (shift_ > bits && root->child[1] == nullptr)
+      { // 根只剩一个子节点，树降低一层
+        root_ = retain(root->child[0]);
+        release(root, shift_);
+        shift_ -= bits;
+      }
+    }
+  }
+  catch (...)
+  {
+    release_leaf(leaf);
+    throw;
+  }
+  release_leaf(tail_);
+  tail_ = leaf;
+  --size_;
+}
+
+// 复制从根到下标 n 所在叶子的路径，为元素赋值
+template <class T, class Alloc>
+template <class V>
+void persistent_vector<T, Alloc>::
+set_value(size_type n, V&& value)
+{
+  MYSTL_DEBUG(n < size_);
+  if (n >= tail_offset())
+  {
+    tail_ = own_leaf(tail_);
+    tail_->data()[n - tail_offset()] = mystl::forward<V>(value);
+    return;
+  }
+  node_type** slot = &root_;
+  for (size_type level = shift_; level > 0; level -= bits)
+  {
+    branch_type* b = own_branch(*slot, level);
+    *slot = b;
+    slot = &b->child[(n >> level) & mask];
+  }
+  leaf_type* leaf = own_leaf(static_cast<leaf_type*>(*slot));
+  *slot = leaf;
+  leaf->data()[n & mask] = mystl::forward<V>(value);
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, class Alloc>
+bool operator==(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    (lhs.shares_with(rhs) || mystl::equal(lhs.begin(), lhs.end(), rhs.begin()));
+}
+
+template <class T, class Alloc>
+bool operator<(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+bool operator!=(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc>
+bool operator>(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc>
+bool operator<=(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc>
+bool operator>=(const persistent_vector<T, Alloc>& lhs, const persistent_vector<T, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Alloc>
+void swap(persistent_vector<T, Alloc>& lhs, persistent_vector<T, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_PERSISTENT_VECTOR_H_
+
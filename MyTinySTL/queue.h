@@ -3,7 +3,7 @@
 
 // 这个头文件包含了两个模板类 queue 和 priority_queue
 // queue          : 队列
-// priority_queue : 优先队列
+// priority_queue : 优先队列，可以通过堆策略选择二叉堆或 d 叉堆
 
 #include "deque.h"
 #include "vector.h"
@@ -179,13 +179,16 @@ void swap(queue<T, Container>& lhs, queue<T, Container>& rhs) noexcept(noexcept(
 // 模板类 priority_queue
 // 参数一代表数据类型，参数二代表容器类型，缺省使用 mystl::vector 作为底层容器
 // 参数三代表比较权值的方式，缺省使用 mystl::less 作为比较方式
+// 参数四代表堆策略，缺省使用二叉堆 heap_binary_policy，可选 heap_4ary_policy 等 d 叉堆
 template <class T, class Container = mystl::vector<T>,
-  class Compare = mystl::less<typename Container::value_type>>
+  class Compare = mystl::less<typename Container::value_type>,
+  class HeapPolicy = mystl::heap_binary_policy>
 class priority_queue
 {
 public:
   typedef Container                           container_type;
   typedef Compare                             value_compare;
+  typedef HeapPolicy                          heap_policy;
   // 使用底层容器的型别
   typedef typename Container::value_type      value_type;
   typedef typename Container::size_type       size_type;
@@ -211,68 +214,65 @@ public:
   explicit priority_queue(size_type n)
     :c_(n)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
   priority_queue(size_type n, const value_type& value) 
     :c_(n, value)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
 
   template <class IIter>
   priority_queue(IIter first, IIter last) 
     :c_(first, last)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
 
   priority_queue(std::initializer_list<T> ilist)
     :c_(ilist)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
 
   priority_queue(const Container& s)
     :c_(s)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
   priority_queue(Container&& s) 
     :c_(mystl::move(s))
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
   }
 
+  // rhs 已经是堆，复制、移动后不需要重新建堆
   priority_queue(const priority_queue& rhs)
     :c_(rhs.c_), comp_(rhs.comp_)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
   }
   priority_queue(priority_queue&& rhs) 
     :c_(mystl::move(rhs.c_)), comp_(rhs.comp_)
   {
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
   }
 
   priority_queue& operator=(const priority_queue& rhs)
   {
     c_ = rhs.c_;
     comp_ = rhs.comp_;
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
     return *this;
   }
   priority_queue& operator=(priority_queue&& rhs)
   {
     c_ = mystl::move(rhs.c_);
     comp_ = rhs.comp_;
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
     return *this;
   }
   priority_queue& operator=(std::initializer_list<T> ilist)
   {
     c_ = ilist;
     comp_ = value_compare();
-    mystl::make_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::make(c_.begin(), c_.end(), comp_);
     return *this;
   }
 
@@ -292,26 +292,36 @@ public:
   void emplace(Args&& ...args)
   {
     c_.emplace_back(mystl::forward<Args>(args)...);
-    mystl::push_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::push(c_.begin(), c_.end(), comp_);
   }
 
   void push(const value_type& value)
   {
     c_.push_back(value);
-    mystl::push_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::push(c_.begin(), c_.end(), comp_);
   }
   void push(value_type&& value)
   {
     c_.push_back(mystl::move(value));
-    mystl::push_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::push(c_.begin(), c_.end(), comp_);
   }
 
   void pop()
   {
-    mystl::pop_heap(c_.begin(), c_.end(), comp_);
+    HeapPolicy::pop(c_.begin(), c_.end(), comp_);
     c_.pop_back();
   }
 
+  // 删除堆顶并返回它，元素移动出来而不是复制
+  // 元素的移动构造函数抛出异常时，堆顶已经移到末尾，容器中的元素不变但不再是堆
+  value_type pop_value()
+  {
+    HeapPolicy::pop(c_.begin(), c_.end(), comp_);
+    value_type value(mystl::move(c_.back()));
+    c_.pop_back();
+    return value;
+  }
+
   void clear()
   {
     while (!empty())
@@ -337,24 +347,24 @@ public:
 };
 
 // 重载比较操作符
-template <class T, class Container, class Compare>
-bool operator==(priority_queue<T, Container, Compare>& lhs,
-                priority_queue<T, Container, Compare>& rhs)
+template <class T, class Container, class Compare, class HeapPolicy>
+bool operator==(priority_queue<T, Container, Compare, HeapPolicy>& lhs,
+                priority_queue<T, Container, Compare, HeapPolicy>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class T, class Container, class Compare>
-bool operator!=(priority_queue<T, Container, Compare>& lhs,
-                priority_queue<T, Container, Compare>& rhs)
+template <class T, class Container, class Compare, class HeapPolicy>
+bool operator!=(priority_queue<T, Container, Compare, HeapPolicy>& lhs,
+                priority_queue<T, Container, Compare, HeapPolicy>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class T, class Container, class Compare>
-void swap(priority_queue<T, Container, Compare>& lhs, 
-          priority_queue<T, Container, Compare>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <class T, class Container, class Compare, class HeapPolicy>
+void swap(priority_queue<T, Container, Compare, HeapPolicy>& lhs, 
+          priority_queue<T, Container, Compare, HeapPolicy>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
   lhs.swap(rhs);
 }
@@ -7,12 +7,15 @@
 #include <initializer_list>
 
 #include <cassert>
+#include <cstdint>
 
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
+#include "node_handle.h"
 #include "type_traits.h"
 #include "exceptdef.h"
+#include "instrument.h"
 
 namespace mystl
 {
@@ -29,6 +32,8 @@ static constexpr rb_tree_color_type rb_tree_black = true;
 template <class T> struct rb_tree_node_base;
 template <class T> struct rb_tree_node;
 
+template <class T> struct rb_tree_os;
+
 template <class T> struct rb_tree_iterator;
 template <class T> struct rb_tree_const_iterator;
 
@@ -99,6 +104,18 @@ struct rb_tree_value_traits
   }
 };
 
+// order statistic 红黑树
+// rb_tree<rb_tree_os<T>, Compare, Alloc> 的元素类型仍为 T，但每个节点额外记录以它为根的子树的节点数，
+// 由旋转与插入、删除后的重新平衡一并维护，从而可以在 O(log n) 内取得第 k 个元素与元素的排名，
+// 见 order_statistic.h。普通的 rb_tree<T, ...> 节点不含这个字段，维护函数都是空操作
+template <class T>
+struct rb_tree_os {};
+
+template <class T>
+struct rb_tree_value_traits<rb_tree_os<T>> :public rb_tree_value_traits<T>
+{
+};
+
 // rb tree node traits
 
 template <class T>
@@ -117,18 +134,115 @@ struct rb_tree_node_traits
 
 // rb tree 的节点设计
 
+// 节点的附加数据，缺省为空，作为空基类不占用空间
+template <class T>
+struct rb_tree_node_augment
+{
+};
+
+template <class T>
+struct rb_tree_node_augment<rb_tree_os<T>>
+{
+  size_t size;  // 以该节点为根的子树的节点数
+};
+
+// 节点的布局
+// 缺省时节点保存 parent、left、right 三个指针与一个颜色字段，64 位下对齐后节点头部占 32 字节
+// 为键值类型特化 rb_tree_compact_node 为 m_true_type 后，颜色保存在 parent 指针的最低位，节点头部只占 24 字节；
+// 节点至少按指针对齐，这一位总是 0。读取父节点要多一次位与，查找只沿 left / right 下降，不受影响
+// 节点总是通过 get_parent / set_parent / get_color / set_color 访问，两种布局共用所有的算法
+template <class Key>
+struct rb_tree_compact_node :public m_false_type {};
+
 template <class T>
-struct rb_tree_node_base
+struct rb_tree_use_compact_node
+  :public rb_tree_compact_node<typename rb_tree_value_traits<T>::key_type> {};
+
+// intrusive_set 的钩子使用 rb_tree_node_base<void>
+template <>
+struct rb_tree_use_compact_node<void> :public m_false_type {};
+
+template <class T, bool = rb_tree_use_compact_node<T>::value>
+struct rb_tree_node_links
 {
   typedef rb_tree_color_type    color_type;
   typedef rb_tree_node_base<T>* base_ptr;
-  typedef rb_tree_node<T>*      node_ptr;
 
   base_ptr   parent;  // 父节点
   base_ptr   left;    // 左子节点
   base_ptr   right;   // 右子节点
   color_type color;   // 节点颜色
 
+  base_ptr   get_parent() const noexcept      { return parent; }
+  void       set_parent(base_ptr p) noexcept  { parent = p; }
+  color_type get_color()  const noexcept      { return color; }
+  void       set_color(color_type c) noexcept { color = c; }
+
+  void set_parent_color(base_ptr p, color_type c) noexcept
+  {
+    parent = p;
+    color = c;
+  }
+
+  // header 的 parent 即根节点
+  base_ptr&  root_ref() noexcept              { return parent; }
+};
+
+template <class T>
+struct rb_tree_node_links<T, true>
+{
+  typedef rb_tree_color_type    color_type;
+  typedef rb_tree_node_base<T>* base_ptr;
+
+  static_assert(rb_tree_red == false && rb_tree_black == true,
+                "the color bit of a compact node assumes red == 0 and black == 1");
+
+  base_ptr   parent_color;  // 父节点，最低位为颜色
+  base_ptr   left;          // 左子节点
+  base_ptr   right;         // 右子节点
+
+  base_ptr   get_parent() const noexcept
+  {
+    return reinterpret_cast<base_ptr>(bits() & ~static_cast<uintptr_t>(1));
+  }
+  void       set_parent(base_ptr p) noexcept
+  {
+    parent_color = reinterpret_cast<base_ptr>(reinterpret_cast<uintptr_t>(p) | (bits() & 1));
+  }
+  color_type get_color()  const noexcept
+  {
+    return (bits() & 1) != 0;
+  }
+  void       set_color(color_type c) noexcept
+  {
+    parent_color = reinterpret_cast<base_ptr>(
+      (bits() & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c));
+  }
+
+  void set_parent_color(base_ptr p, color_type c) noexcept
+  {
+    parent_color = reinterpret_cast<base_ptr>(
+      reinterpret_cast<uintptr_t>(p) | static_cast<uintptr_t>(c));
+  }
+
+  // header 是红色的，颜色位为 0，保存的就是根节点指针本身
+  base_ptr&  root_ref() noexcept
+  {
+    MYSTL_DEBUG(get_color() == rb_tree_red);
+    return parent_color;
+  }
+
+private:
+  uintptr_t  bits() const noexcept { return reinterpret_cast<uintptr_t>(parent_color); }
+};
+
+template <class T>
+struct rb_tree_node_base :public rb_tree_node_augment<T>, public rb_tree_node_links<T>
+{
+  typedef rb_tree_color_type    color_type;
+  typedef rb_tree_node_base<T>* base_ptr;
+  typedef rb_tree_node<T>*      node_ptr;
+
   base_ptr get_base_ptr()
   {
     return &*this;
@@ -151,7 +265,7 @@ struct rb_tree_node :public rb_tree_node_base<T>
   typedef rb_tree_node_base<T>* base_ptr;
   typedef rb_tree_node<T>*      node_ptr;
 
-  T value;  // 节点值
+  typename rb_tree_value_traits<T>::value_type value;  // 节点值
 
   base_ptr get_base_ptr()
   {
@@ -207,11 +321,11 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
     }
     else
     {  // 如果没有右子节点
-      auto y = node->parent;
+      auto y = node->get_parent();
       while (y->right == node)
       {
         node = y;
-        y = y->parent;
+        y = y->get_parent();
       }
       if (node->right != y)  // 应对“寻找根节点的下一节点，而根节点没有右子节点”的特殊情况
         node = y;
@@ -221,7 +335,7 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
   // 使迭代器后退
   void dec()
   {
-    if (node->parent->parent == node && rb_tree_is_red(node))
+    if (node->get_parent()->get_parent() == node && rb_tree_is_red(node))
     { // 如果 node 为 header
       node = node->right;  // 指向整棵树的 max 节点
     }
@@ -231,11 +345,11 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
     }
     else
     {  // 非 header 节点，也无左子节点
-      auto y = node->parent;
+      auto y = node->get_parent();
       while (node == y->left)
       {
         node = y;
-        y = y->parent;
+        y = y->get_parent();
       }
       node = y;
     }
@@ -370,25 +484,25 @@ NodePtr rb_tree_max(NodePtr x) noexcept
 template <class NodePtr>
 bool rb_tree_is_lchild(NodePtr node) noexcept
 {
-  return node == node->parent->left;
+  return node == node->get_parent()->left;
 }
 
 template <class NodePtr>
 bool rb_tree_is_red(NodePtr node) noexcept
 {
-  return node->color == rb_tree_red;
+  return node->get_color() == rb_tree_red;
 }
 
 template <class NodePtr>
-void rb_tree_set_black(NodePtr& node) noexcept
+void rb_tree_set_black(NodePtr node) noexcept
 {
-  node->color = rb_tree_black;
+  node->set_color(rb_tree_black);
 }
 
 template <class NodePtr>
-void rb_tree_set_red(NodePtr& node) noexcept
+void rb_tree_set_red(NodePtr node) noexcept
 {
-  node->color = rb_tree_red;
+  node->set_color(rb_tree_red);
 }
 
 template <class NodePtr>
@@ -397,8 +511,150 @@ NodePtr rb_tree_next(NodePtr node) noexcept
   if (node->right != nullptr)
     return rb_tree_min(node->right);
   while (!rb_tree_is_lchild(node))
-    node = node->parent;
-  return node->parent;
+    node = node->get_parent();
+  return node->get_parent();
+}
+
+// 以下函数维护节点的附加数据，普通的节点为空操作，rb_tree_os 的节点维护子树大小
+// 参数都是节点的基类指针
+
+template <class T>
+size_t rb_tree_os_size(rb_tree_node_base<rb_tree_os<T>>* x) noexcept
+{
+  return x == nullptr ? 0 : x->size;
+}
+
+// 旋转之后，y 顶替了 x 的位置
+template <class T>
+void rb_tree_augment_rotate(rb_tree_node_base<T>*, rb_tree_node_base<T>*) noexcept
+{
+}
+
+template <class T>
+void rb_tree_augment_rotate(rb_tree_node_base<rb_tree_os<T>>* x,
+                            rb_tree_node_base<rb_tree_os<T>>* y) noexcept
+{
+  y->size = x->size;
+  x->size = rb_tree_os_size(x->left) + rb_tree_os_size(x->right) + 1;
+}
+
+// 新节点 x 链接为叶节点之后、重新平衡之前，x 到根节点路径上的子树各增加一个节点
+template <class T>
+void rb_tree_augment_insert(rb_tree_node_base<T>*, rb_tree_node_base<T>*) noexcept
+{
+}
+
+template <class T>
+void rb_tree_augment_insert(rb_tree_node_base<rb_tree_os<T>>* x,
+                            rb_tree_node_base<rb_tree_os<T>>* root) noexcept
+{
+  x->size = 1;
+  while (x != root)
+  {
+    x = x->get_parent();
+    ++x->size;
+  }
+}
+
+// 删除节点之前，y 为实际从树中摘下的位置，它的祖先的子树各减少一个节点
+template <class T>
+void rb_tree_augment_erase(rb_tree_node_base<T>*, rb_tree_node_base<T>*) noexcept
+{
+}
+
+template <class T>
+void rb_tree_augment_erase(rb_tree_node_base<rb_tree_os<T>>* y,
+                           rb_tree_node_base<rb_tree_os<T>>* root) noexcept
+{
+  while (y != root)
+  {
+    y = y->get_parent();
+    --y->size;
+  }
+}
+
+// y 顶替了 z 的位置，或者 y 是 z 的复制
+template <class T>
+void rb_tree_augment_copy(rb_tree_node_base<T>*, rb_tree_node_base<T>*) noexcept
+{
+}
+
+template <class T>
+void rb_tree_augment_copy(rb_tree_node_base<rb_tree_os<T>>* y,
+                          rb_tree_node_base<rb_tree_os<T>>* z) noexcept
+{
+  y->size = z->size;
+}
+
+// 由子节点重新计算 x 的附加数据
+template <class T>
+void rb_tree_augment_update(rb_tree_node_base<T>*) noexcept
+{
+}
+
+template <class T>
+void rb_tree_augment_update(rb_tree_node_base<rb_tree_os<T>>* x) noexcept
+{
+  x->size = rb_tree_os_size(x->left) + rb_tree_os_size(x->right) + 1;
+}
+
+// 以 x 为根的子树中，中序第 k 个节点（从 0 开始），k 必须小于子树的节点数
+template <class T>
+rb_tree_node_base<rb_tree_os<T>>*
+rb_tree_os_select(rb_tree_node_base<rb_tree_os<T>>* x, size_t k) noexcept
+{
+  while (true)
+  {
+    const size_t l = rb_tree_os_size(x->left);
+    if (k < l)
+    {
+      x = x->left;
+    }
+    else if (k == l)
+    {
+      return x;
+    }
+    else
+    {
+      k -= l + 1;
+      x = x->right;
+    }
+  }
+}
+
+// 节点 x 在整棵树中序中的位置，x 为 header 时返回节点总数
+// 根节点的父节点是 header，header 的父节点是根节点，由此判断何时到达根节点
+template <class T>
+size_t rb_tree_os_index(rb_tree_node_base<rb_tree_os<T>>* x) noexcept
+{
+  if (x->get_parent() == nullptr)  // 空树的 header
+    return 0;
+  if (rb_tree_is_red(x) && x->get_parent()->get_parent() == x)  // header
+    return x->get_parent()->size;
+  size_t r = rb_tree_os_size(x->left);
+  while (x->get_parent()->get_parent() != x)
+  {
+    if (x == x->get_parent()->right)
+      r += rb_tree_os_size(x->get_parent()->left) + 1;
+    x = x->get_parent();
+  }
+  return r;
+}
+
+// rb_tree_os 的迭代器之间的距离由两者的位置相减得到，复杂度 O(log n)
+template <class T>
+ptrdiff_t distance(rb_tree_iterator<rb_tree_os<T>> first, rb_tree_iterator<rb_tree_os<T>> last)
+{
+  return static_cast<ptrdiff_t>(rb_tree_os_index(last.node)) -
+         static_cast<ptrdiff_t>(rb_tree_os_index(first.node));
+}
+
+template <class T>
+ptrdiff_t distance(rb_tree_const_iterator<rb_tree_os<T>> first,
+                   rb_tree_const_iterator<rb_tree_os<T>> last)
+{
+  return static_cast<ptrdiff_t>(rb_tree_os_index(last.node)) -
+         static_cast<ptrdiff_t>(rb_tree_os_index(first.node));
 }
 
 /*---------------------------------------*\
@@ -414,11 +670,12 @@ NodePtr rb_tree_next(NodePtr node) noexcept
 template <class NodePtr>
 void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
 {
+  instrument::count(rb_tree_rotation);
   auto y = x->right;  // y 为 x 的右子节点
   x->right = y->left;
   if (y->left != nullptr)
-    y->left->parent = x;
-  y->parent = x->parent;
+    y->left->set_parent(x);
+  y->set_parent(x->get_parent());
 
   if (x == root)
   { // 如果 x 为根节点，让 y 顶替 x 成为根节点
@@ -426,15 +683,16 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
   }
   else if (rb_tree_is_lchild(x))
   { // 如果 x 是左子节点
-    x->parent->left = y;
+    x->get_parent()->left = y;
   }
   else
   { // 如果 x 是右子节点
-    x->parent->right = y;
+    x->get_parent()->right = y;
   }
   // 调整 x 与 y 的关系
   y->left = x;  
-  x->parent = y;
+  x->set_parent(y);
+  rb_tree_augment_rotate(x, y);
 }
 
 /*----------------------------------------*\
@@ -450,11 +708,12 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
 template <class NodePtr>
 void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
 {
+  instrument::count(rb_tree_rotation);
   auto y = x->left;
   x->left = y->right;
   if (y->right)
-    y->right->parent = x;
-  y->parent = x->parent;
+    y->right->set_parent(x);
+  y->set_parent(x->get_parent());
 
   if (x == root)
   { // 如果 x 为根节点，让 y 顶替 x 成为根节点
@@ -462,15 +721,16 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
   }
   else if (rb_tree_is_lchild(x))
   { // 如果 x 是右子节点
-    x->parent->left = y;
+    x->get_parent()->left = y;
   }
   else
   { // 如果 x 是左子节点
-    x->parent->right = y;
+    x->get_parent()->right = y;
   }
   // 调整 x 与 y 的关系
   y->right = x;                      
-  x->parent = y;
+  x->set_parent(y);
+  rb_tree_augment_rotate(x, y);
 }
 
 // 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为根节点
@@ -491,41 +751,42 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
 template <class NodePtr>
 void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
 {
+  rb_tree_augment_insert(x, root);
   rb_tree_set_red(x);  // 新增节点为红色
-  while (x != root && rb_tree_is_red(x->parent))
+  while (x != root && rb_tree_is_red(x->get_parent()))
   {
-    if (rb_tree_is_lchild(x->parent))
+    if (rb_tree_is_lchild(x->get_parent()))
     { // 如果父节点是左子节点
-      auto uncle = x->parent->parent->right;
+      auto uncle = x->get_parent()->get_parent()->right;
       if (uncle != nullptr && rb_tree_is_red(uncle))
       { // case 3: 父节点和叔叔节点都为红
-        rb_tree_set_black(x->parent);
+        rb_tree_set_black(x->get_parent());
         rb_tree_set_black(uncle);
-        x = x->parent->parent;
+        x = x->get_parent()->get_parent();
         rb_tree_set_red(x);
       }
       else
       { // 无叔叔节点或叔叔节点为黑
         if (!rb_tree_is_lchild(x))
         { // case 4: 当前节点 x 为右子节点
-          x = x->parent;
+          x = x->get_parent();
           rb_tree_rotate_left(x, root);
         }
         // 都转换成 case 5： 当前节点为左子节点
-        rb_tree_set_black(x->parent);
-        rb_tree_set_red(x->parent->parent);
-        rb_tree_rotate_right(x->parent->parent, root);
+        rb_tree_set_black(x->get_parent());
+        rb_tree_set_red(x->get_parent()->get_parent());
+        rb_tree_rotate_right(x->get_parent()->get_parent(), root);
         break;
       }
     }
     else  // 如果父节点是右子节点，对称处理
     { 
-      auto uncle = x->parent->parent->left;
+      auto uncle = x->get_parent()->get_parent()->left;
       if (uncle != nullptr && rb_tree_is_red(uncle))
       { // case 3: 父节点和叔叔节点都为红
-        rb_tree_set_black(x->parent);
+        rb_tree_set_black(x->get_parent());
         rb_tree_set_black(uncle);
-        x = x->parent->parent;
+        x = x->get_parent()->get_parent();
         rb_tree_set_red(x);
         // 此时祖父节点为红，可能会破坏红黑树的性质，令当前节点为祖父节点，继续处理
       }
@@ -533,13 +794,13 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
       { // 无叔叔节点或叔叔节点为黑
         if (rb_tree_is_lchild(x))
         { // case 4: 当前节点 x 为左子节点
-          x = x->parent;
+          x = x->get_parent();
           rb_tree_rotate_right(x, root);
         }
         // 都转换成 case 5： 当前节点为左子节点
-        rb_tree_set_black(x->parent);
-        rb_tree_set_red(x->parent->parent);
-        rb_tree_rotate_left(x->parent->parent, root);
+        rb_tree_set_black(x->get_parent());
+        rb_tree_set_red(x->get_parent()->get_parent());
+        rb_tree_rotate_left(x->get_parent()->get_parent(), root);
         break;
       }
     }
@@ -560,24 +821,25 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
   auto x = y->left != nullptr ? y->left : y->right;
   // xp 为 x 的父节点
   NodePtr xp = nullptr;
+  rb_tree_augment_erase(y, root);
 
   // y != z 说明 z 有两个非空子节点，此时 y 指向 z 右子树的最左节点，x 指向 y 的右子节点。
   // 用 y 顶替 z 的位置，用 x 顶替 y 的位置，最后用 y 指向 z
   if (y != z)
   {
-    z->left->parent = y;
+    z->left->set_parent(y);
     y->left = z->left;
 
     // 如果 y 不是 z 的右子节点，那么 z 的右子节点一定有左孩子
     if (y != z->right)
     { // x 替换 y 的位置
-      xp = y->parent;
+      xp = y->get_parent();
       if (x != nullptr)
-        x->parent = y->parent;
+        x->set_parent(y->get_parent());
 
-      y->parent->left = x;
+      y->get_parent()->left = x;
       y->right = z->right;
-      z->right->parent = y;
+      z->right->set_parent(y);
     }
     else
     {
@@ -588,27 +850,30 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
     if (root == z)
       root = y;
     else if (rb_tree_is_lchild(z))
-      z->parent->left = y;
+      z->get_parent()->left = y;
     else
-      z->parent->right = y;
-    y->parent = z->parent;
-    mystl::swap(y->color, z->color);
+      z->get_parent()->right = y;
+    y->set_parent(z->get_parent());
+    const auto color = y->get_color();
+    y->set_color(z->get_color());
+    z->set_color(color);
+    rb_tree_augment_copy(y, z);
     y = z;
   }
   // y == z 说明 z 至多只有一个孩子
   else
   { 
-    xp = y->parent;
+    xp = y->get_parent();
     if (x)  
-      x->parent = y->parent;
+      x->set_parent(y->get_parent());
 
     // 连接 x 与 z 的父节点
     if (root == z)
       root = x;
     else if (rb_tree_is_lchild(z))
-      z->parent->left = x;
+      z->get_parent()->left = x;
     else
-      z->parent->right = x;
+      z->get_parent()->right = x;
 
     // 此时 z 有可能是最左节点或最右节点，更新数据
     if (leftmost == z)
@@ -645,7 +910,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
         { // case 2
           rb_tree_set_red(brother);
           x = xp;
-          xp = xp->parent;
+          xp = xp->get_parent();
         }
         else
         { 
@@ -658,7 +923,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
             brother = xp->right;
           }
           // 转为 case 4
-          brother->color = xp->color;
+          brother->set_color(xp->get_color());
           rb_tree_set_black(xp);
           if (brother->right != nullptr)  
             rb_tree_set_black(brother->right);
@@ -681,7 +946,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
         { // case 2
           rb_tree_set_red(brother);
           x = xp;
-          xp = xp->parent;
+          xp = xp->get_parent();
         }
         else
         {
@@ -694,7 +959,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
             brother = xp->left;
           }
           // 转为 case 4
-          brother->color = xp->color;
+          brother->set_color(xp->get_color());
           rb_tree_set_black(xp);
           if (brother->left != nullptr)  
             rb_tree_set_black(brother->left);
@@ -710,9 +975,11 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 }
 
 // 模板类 rb_tree
-// 参数一代表数据类型，参数二代表键值比较类型
-template <class T, class Compare>
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Compare, class Alloc = mystl::allocator<T>>
 class rb_tree
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template
+                               rebind_alloc<typename rb_tree_traits<T>::node_type>>
 {
 public:
   // rb_tree 的嵌套型别定义 
@@ -729,27 +996,38 @@ public:
   typedef typename tree_traits::value_type         value_type;
   typedef Compare                                  key_compare;
 
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<base_type>              base_allocator;
-  typedef mystl::allocator<node_type>              node_allocator;
-
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<base_type>
+                                                   base_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<node_type>
+                                                   node_allocator;
+  typedef mystl::allocator_traits<base_allocator>  base_traits;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef value_type*                              pointer;
+  typedef const value_type*                        const_pointer;
+  typedef value_type&                              reference;
+  typedef const value_type&                        const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
 
   typedef rb_tree_iterator<T>                      iterator;
   typedef rb_tree_const_iterator<T>                const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() const { return node_allocator(); }
+  typedef mystl::node_handle<value_type, node_type, Alloc>
+                                                   node_handle_type;
+  typedef mystl::node_insert_return<iterator, node_handle_type>
+                                                   insert_return_type;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
   key_compare    key_comp()      const { return key_comp_; }
 
 private:
+  typedef mystl::alloc_holder<node_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
   // 用以下三个数据表现 rb tree
   base_ptr    header_;      // 特殊节点，与根节点互为对方的父节点
   size_type   node_count_;  // 节点数
@@ -757,7 +1035,7 @@ private:
 
 private:
   // 以下三个函数用于取得根节点，最小节点和最大节点
-  base_ptr& root()      const { return header_->parent; }
+  base_ptr& root()      const { return header_->root_ref(); }
   base_ptr& leftmost()  const { return header_->left; }
   base_ptr& rightmost() const { return header_->right; }
 
@@ -765,13 +1043,22 @@ public:
   // 构造、复制、析构函数
   rb_tree() { rb_tree_init(); }
 
+  explicit rb_tree(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :alloc_base(node_allocator(alloc)), key_comp_(comp)
+  { rb_tree_init(); }
+
   rb_tree(const rb_tree& rhs);
+  rb_tree(const rb_tree& rhs, const allocator_type& alloc);
   rb_tree(rb_tree&& rhs) noexcept;
+  // 分配器不相等时逐个移动元素
+  rb_tree(rb_tree&& rhs, const allocator_type& alloc);
 
   rb_tree& operator=(const rb_tree& rhs);
-  rb_tree& operator=(rb_tree&& rhs);
+  rb_tree& operator=(rb_tree&& rhs)
+    noexcept(node_alloc_traits::propagate_on_container_move_assignment::value ||
+             node_alloc_traits::is_always_equal::value);
 
-  ~rb_tree() { clear(); }
+  ~rb_tree() { destroy_all(); }
 
 public:
   // 迭代器相关操作
@@ -807,7 +1094,7 @@ public:
 
   bool      empty()    const noexcept { return node_count_ == 0; }
   size_type size()     const noexcept { return node_count_; }
-  size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+  size_type max_size() const noexcept { return node_alloc_traits::max_size(M_alloc()); }
 
   // 插入删除相关操作
 
@@ -816,22 +1103,28 @@ public:
   template <class ...Args>
   iterator  emplace_multi(Args&& ...args);
 
+  // 参数可以直接取得键值时先查找，键值重复时不创建节点
   template <class ...Args>
-  mystl::pair<iterator, bool> emplace_unique(Args&& ...args);
+  mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+  {
+    return emplace_unique_aux(emplace_key_kind<key_type, value_type, Args...>(),
+                              mystl::forward<Args>(args)...);
+  }
 
   template <class ...Args>
   iterator  emplace_multi_use_hint(iterator hint, Args&& ...args);
 
   template <class ...Args>
-  iterator  emplace_unique_use_hint(iterator hint, Args&& ...args);
+  iterator  emplace_unique_use_hint(iterator hint, Args&& ...args)
+  {
+    return emplace_unique_hint_aux(emplace_key_kind<key_type, value_type, Args...>(), hint,
+                                   mystl::forward<Args>(args)...);
+  }
 
   // insert
 
   iterator  insert_multi(const value_type& value);
-  iterator  insert_multi(value_type&& value)
-  {
-    return emplace_multi(mystl::move(value));
-  }
+  iterator  insert_multi(value_type&& value);
 
   iterator  insert_multi(iterator hint, const value_type& value)
   {
@@ -842,37 +1135,46 @@ public:
     return emplace_multi_use_hint(hint, mystl::move(value));
   }
 
+  // 空树上插入有序的范围时，直接自底向上建成平衡的树，复杂度为 O(n)
   template <class InputIterator>
   void      insert_multi(InputIterator first, InputIterator last)
   {
-    size_type n = mystl::distance(first, last);
-    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
-    for (; n > 0; --n, ++first)
-      insert_multi(end(), *first);
+    insert_multi_range(first, last, iterator_category(first));
   }
 
   mystl::pair<iterator, bool> insert_unique(const value_type& value);
   mystl::pair<iterator, bool> insert_unique(value_type&& value)
   {
-    return emplace_unique(mystl::move(value));
+    return emplace_unique_key(value_traits::get_key(value), mystl::move(value));
   }
 
   iterator  insert_unique(iterator hint, const value_type& value)
   {
-    return emplace_unique_use_hint(hint, value);
+    return emplace_unique_key_use_hint(hint, value_traits::get_key(value), value);
   }
   iterator  insert_unique(iterator hint, value_type&& value)
   {
-    return emplace_unique_use_hint(hint, mystl::move(value));
+    return emplace_unique_key_use_hint(hint, value_traits::get_key(value), mystl::move(value));
+  }
+
+  // try_emplace：键值已存在时不创建节点，也不使用 args
+  template <class K, class ...Args>
+  mystl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args)
+  {
+    return emplace_unique_key(key, mystl::emplace_second_t(),
+                              mystl::forward<K>(key), mystl::forward<Args>(args)...);
+  }
+  template <class K, class ...Args>
+  iterator  try_emplace_unique_use_hint(iterator hint, K&& key, Args&& ...args)
+  {
+    return emplace_unique_key_use_hint(hint, key, mystl::emplace_second_t(),
+                                       mystl::forward<K>(key), mystl::forward<Args>(args)...);
   }
 
   template <class InputIterator>
   void      insert_unique(InputIterator first, InputIterator last)
   {
-    size_type n = mystl::distance(first, last);
-    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
-    for (; n > 0; --n, ++first)
-      insert_unique(end(), *first);
+    insert_unique_range(first, last, iterator_category(first));
   }
 
   // erase
@@ -886,10 +1188,31 @@ public:
 
   void      clear();
 
+  // node handle
+
+  // 把节点从树中摘下，不销毁节点
+  node_handle_type   extract(iterator hint);
+  node_handle_type   extract_multi(const key_type& key);
+  node_handle_type   extract_unique(const key_type& key);
+
+  // 重新链接句柄中的节点，不分配内存，键值重复时节点留在返回值的 node 中
+  insert_return_type insert_node_unique(node_handle_type&& nh);
+  iterator           insert_node_unique(iterator hint, node_handle_type&& nh);
+  iterator           insert_node_multi(node_handle_type&& nh);
+  iterator           insert_node_multi(iterator hint, node_handle_type&& nh);
+
+  // 把 rhs 的节点逐个移到本树中，键值不允许重复时，重复的节点留在 rhs 中
+  template <class Compare2>
+  void      merge_unique(rb_tree<T, Compare2, Alloc>& rhs);
+  template <class Compare2>
+  void      merge_multi(rb_tree<T, Compare2, Alloc>& rhs);
+
   // rb_tree 相关操作
 
-  iterator       find(const key_type& key);
-  const_iterator find(const key_type& key) const;
+  iterator       find(const key_type& key)
+  { return iterator(find_node(key)); }
+  const_iterator find(const key_type& key) const
+  { return const_iterator(find_node(key)); }
 
   size_type      count_multi(const key_type& key) const
   {
@@ -901,11 +1224,15 @@ public:
     return find(key) != end() ? 1 : 0;
   }
 
-  iterator       lower_bound(const key_type& key);
-  const_iterator lower_bound(const key_type& key) const;
+  iterator       lower_bound(const key_type& key)
+  { return iterator(lower_bound_node(key)); }
+  const_iterator lower_bound(const key_type& key) const
+  { return const_iterator(lower_bound_node(key)); }
 
-  iterator       upper_bound(const key_type& key);
-  const_iterator upper_bound(const key_type& key) const;
+  iterator       upper_bound(const key_type& key)
+  { return iterator(upper_bound_node(key)); }
+  const_iterator upper_bound(const key_type& key) const
+  { return const_iterator(upper_bound_node(key)); }
   
   // 查找 key 的范围
   mystl::pair<iterator, iterator>             
@@ -934,9 +1261,99 @@ public:
     return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
   }
 
+  // 异构查找：仅当 Compare 声明了 is_transparent 时（如 mystl::less<>）才启用，
+  // 可以直接用 const char* 等与键值可比较的类型查找，不必构造临时的 key_type
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return iterator(find_node(key)); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key) const
+  { return const_iterator(find_node(key)); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count_multi(const K& key) const
+  {
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count_unique(const K& key) const
+  {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)
+  { return iterator(lower_bound_node(key)); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key) const
+  { return const_iterator(lower_bound_node(key)); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)
+  { return iterator(upper_bound_node(key)); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key) const
+  { return const_iterator(upper_bound_node(key)); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<iterator, iterator>
+  equal_range_multi(const K& key)
+  {
+    return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_multi(const K& key) const
+  {
+    return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<iterator, iterator>
+  equal_range_unique(const K& key)
+  {
+    iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  mystl::pair<const_iterator, const_iterator>
+  equal_range_unique(const K& key) const
+  {
+    const_iterator it = find(key);
+    auto next = it;
+    return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+  }
+
+  // order statistic：仅当 T 为 rb_tree_os<...> 时可用，复杂度 O(log n)
+  // nth(k) 返回中序第 k 个元素（从 0 开始），k >= size() 时返回 end()
+  // index_of(it) 返回 it 之前的元素个数，it 为 end() 时返回 size()
+  iterator       nth(size_type k)
+  { return k < node_count_ ? iterator(rb_tree_os_select(root(), k)) : end(); }
+  const_iterator nth(size_type k) const
+  { return k < node_count_ ? const_iterator(rb_tree_os_select(root(), k)) : end(); }
+  size_type      index_of(const_iterator it) const
+  { return rb_tree_os_index(it.node); }
+
   void swap(rb_tree& rhs) noexcept;
 
 private:
+  template <class, class, class>
+  friend class rb_tree;
 
   // node related
   template <class ...Args>
@@ -944,9 +1361,31 @@ private:
   node_ptr clone_node(base_ptr x);
   void     destroy_node(node_ptr p);
 
+  // 元素可以平凡析构且分配器只被本容器使用时，一次归还全部节点（包括 header_）
+  bool     release_nodes() noexcept
+  {
+    return std::is_trivially_destructible<value_type>::value &&
+      alloc_release_traits<node_allocator>::release_if_unique(M_alloc());
+  }
+
   // init / reset
   void     rb_tree_init();
   void     reset();
+  void     destroy_all();
+  void     copy_tree(const rb_tree& rhs);
+
+  // move
+  void     move_assign(rb_tree& rhs, m_true_type) noexcept;
+  void     move_assign(rb_tree& rhs, m_false_type);
+  void     move_elements(rb_tree& rhs);
+
+  // find / lower_bound / upper_bound 的实现，返回节点指针，找不到时返回 header_
+  template <class K>
+  base_ptr find_node(const K& key) const;
+  template <class K>
+  base_ptr lower_bound_node(const K& key) const;
+  template <class K>
+  base_ptr upper_bound_node(const K& key) const;
 
   // get insert pos
   mystl::pair<base_ptr, bool> 
@@ -955,12 +1394,68 @@ private:
            get_insert_unique_pos(const key_type& key);
 
   // insert value / insert node
-  iterator insert_value_at(base_ptr x, const value_type& value, bool add_to_left);
+  template <class V>
+  iterator insert_value_at(base_ptr x, V&& value, bool add_to_left);
   iterator insert_node_at(base_ptr x, node_ptr node, bool add_to_left);
 
-  // insert use hint
-  iterator insert_multi_use_hint(iterator hint, key_type key, node_ptr node);
-  iterator insert_unique_use_hint(iterator hint, key_type key, node_ptr node);
+  // 先以 key 查找插入位置，确定可以插入后才用 args 创建节点
+  template <class ...Args>
+  mystl::pair<iterator, bool> emplace_unique_key(const key_type& key, Args&& ...args);
+  template <class ...Args>
+  iterator emplace_unique_key_use_hint(iterator hint, const key_type& key, Args&& ...args);
+
+  template <class ...Args>
+  mystl::pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 0>, Args&& ...args);
+  template <class Arg>
+  mystl::pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 1>, Arg&& value)
+  { return emplace_unique_key(value_traits::get_key(value), mystl::forward<Arg>(value)); }
+  template <class Key, class Arg>
+  mystl::pair<iterator, bool> emplace_unique_aux(std::integral_constant<int, 2>, Key&& key, Arg&& arg)
+  { return emplace_unique_key(key, mystl::forward<Key>(key), mystl::forward<Arg>(arg)); }
+
+  template <class ...Args>
+  iterator emplace_unique_hint_aux(std::integral_constant<int, 0>, iterator hint, Args&& ...args);
+  template <class Arg>
+  iterator emplace_unique_hint_aux(std::integral_constant<int, 1>, iterator hint, Arg&& value)
+  {
+    return emplace_unique_key_use_hint(hint, value_traits::get_key(value),
+                                       mystl::forward<Arg>(value));
+  }
+  template <class Key, class Arg>
+  iterator emplace_unique_hint_aux(std::integral_constant<int, 2>, iterator hint,
+                                   Key&& key, Arg&& arg)
+  {
+    return emplace_unique_key_use_hint(hint, key, mystl::forward<Key>(key),
+                                       mystl::forward<Arg>(arg));
+  }
+
+  // get insert pos use hint
+  mystl::pair<base_ptr, bool>
+           get_insert_multi_hint_pos(iterator hint, const key_type& key);
+  mystl::pair<mystl::pair<base_ptr, bool>, bool>
+           get_insert_unique_hint_pos(iterator hint, const key_type& key);
+
+  // 摘下节点
+  node_ptr unlink_node(base_ptr x);
+
+  // insert range
+  template <class InputIter>
+  void     insert_multi_range(InputIter first, InputIter last, input_iterator_tag);
+  template <class ForwardIter>
+  void     insert_multi_range(ForwardIter first, ForwardIter last, forward_iterator_tag);
+  template <class InputIter>
+  void     insert_unique_range(InputIter first, InputIter last, input_iterator_tag);
+  template <class ForwardIter>
+  void     insert_unique_range(ForwardIter first, ForwardIter last, forward_iterator_tag);
+
+  // build from sorted range
+  template <class ForwardIter>
+  bool     sorted_range_count(ForwardIter first, ForwardIter last, bool unique, size_type& count);
+  template <class ForwardIter>
+  void     build_sorted(ForwardIter first, ForwardIter last, size_type count, bool unique);
+  template <class ForwardIter>
+  base_ptr build_sorted_from(ForwardIter& first, ForwardIter last, size_type count,
+                             size_type depth, size_type red_depth, bool unique);
 
   // copy tree / erase tree
   base_ptr copy_from(base_ptr x, base_ptr p);
@@ -970,74 +1465,104 @@ private:
 /*****************************************************************************************/
 
 // 复制构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
 rb_tree(const rb_tree& rhs)
+  :alloc_base(node_alloc_traits::select_on_container_copy_construction(rhs.M_alloc()))
 {
   rb_tree_init();
-  if (rhs.node_count_ != 0)
-  {
-    root() = copy_from(rhs.root(), header_);
-    leftmost() = rb_tree_min(root());
-    rightmost() = rb_tree_max(root());
-  }
-  node_count_ = rhs.node_count_;
-  key_comp_ = rhs.key_comp_;
+  copy_tree(rhs);
+}
+
+// 带分配器的复制构造函数
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
+rb_tree(const rb_tree& rhs, const allocator_type& alloc)
+  :alloc_base(node_allocator(alloc))
+{
+  rb_tree_init();
+  copy_tree(rhs);
 }
 
 // 移动构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
 rb_tree(rb_tree&& rhs) noexcept
-  :header_(mystl::move(rhs.header_)),
+  :alloc_base(mystl::move(rhs.M_alloc())),
+  header_(mystl::move(rhs.header_)),
   node_count_(rhs.node_count_),
   key_comp_(rhs.key_comp_)
 {
   rhs.reset();
 }
 
+// 带分配器的移动构造函数
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
+rb_tree(rb_tree&& rhs, const allocator_type& alloc)
+  :alloc_base(node_allocator(alloc)),
+  header_(nullptr),
+  node_count_(0),
+  key_comp_(rhs.key_comp_)
+{
+  if (node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    header_ = rhs.header_;
+    node_count_ = rhs.node_count_;
+    rhs.reset();
+  }
+  else
+  {
+    rb_tree_init();
+    move_elements(rhs);
+  }
+}
+
 // 复制赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>& 
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>& 
+rb_tree<T, Compare, Alloc>::
 operator=(const rb_tree& rhs)
 {
   if (this != &rhs)
   {
-    clear();
-
-    if (rhs.node_count_ != 0)
-    {
-      root() = copy_from(rhs.root(), header_);
-      leftmost() = rb_tree_min(root());
-      rightmost() = rb_tree_max(root());
+    if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+        !node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 旧的节点必须由旧的分配器释放
+      destroy_all();
+      mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(), m_true_type());
+      rb_tree_init();
     }
-
-    node_count_ = rhs.node_count_;
-    key_comp_ = rhs.key_comp_;
+    if (header_ == nullptr)  // 被移动过的树
+      rb_tree_init();
+    clear();
+    copy_tree(rhs);
   }
   return *this;
 }
 
 // 移动赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>&
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>&
+rb_tree<T, Compare, Alloc>::
 operator=(rb_tree&& rhs)
+  noexcept(node_alloc_traits::propagate_on_container_move_assignment::value ||
+           node_alloc_traits::is_always_equal::value)
 {
-  clear();
-  header_ = mystl::move(rhs.header_);
-  node_count_ = rhs.node_count_;
-  key_comp_ = rhs.key_comp_;
-  rhs.reset();
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                node_alloc_traits::propagate_on_container_move_assignment::value ||
+                node_alloc_traits::is_always_equal::value>());
+  }
   return *this;
 }
 
 // 就地插入元素，键值允许重复
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::iterator 
+rb_tree<T, Compare, Alloc>::
 emplace_multi(Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1046,12 +1571,12 @@ emplace_multi(Args&& ...args)
   return insert_node_at(res.first, np, res.second);
 }
 
-// 就地插入元素，键值不允许重复
-template <class T, class Compare>
+// 就地插入元素，键值不允许重复，参数不能直接取得键值时先创建节点
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool> 
-rb_tree<T, Compare>::
-emplace_unique(Args&& ...args)
+mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool> 
+rb_tree<T, Compare, Alloc>::
+emplace_unique_aux(std::integral_constant<int, 0>, Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
   node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -1065,101 +1590,69 @@ emplace_unique(Args&& ...args)
 }
 
 // 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 emplace_multi_use_hint(iterator hint, Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
   node_ptr np = create_node(mystl::forward<Args>(args)...);
-  if (node_count_ == 0)
-  {
-    return insert_node_at(header_, np, true);
-  }
-  key_type key = value_traits::get_key(np->value);
-  if (hint == begin())
-  { // 位于 begin 处
-    if (key_comp_(key, value_traits::get_key(*hint)))
-    {
-      return insert_node_at(hint.node, np, true);
-    }
-    else
-    {
-      auto pos = get_insert_multi_pos(key);
-      return insert_node_at(pos.first, np, pos.second);
-    }
-  }
-  else if (hint == end())
-  { // 位于 end 处
-    if (!key_comp_(key, value_traits::get_key(rightmost()->get_node_ptr()->value)))
-    {
-      return insert_node_at(rightmost(), np, false);
-    }
-    else
-    {
-      auto pos = get_insert_multi_pos(key);
-      return insert_node_at(pos.first, np, pos.second);
-    }
-  }
-  return insert_multi_use_hint(hint, key, np);
+  auto pos = get_insert_multi_hint_pos(hint, value_traits::get_key(np->value));
+  return insert_node_at(pos.first, np, pos.second);
 }
 
 // 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template<class T, class Compare>
+template<class T, class Compare, class Alloc>
 template<class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-emplace_unique_use_hint(iterator hint, Args&& ...args)
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+emplace_unique_hint_aux(std::integral_constant<int, 0>, iterator hint, Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
   node_ptr np = create_node(mystl::forward<Args>(args)...);
-  if (node_count_ == 0)
+  auto pos = get_insert_unique_hint_pos(hint, value_traits::get_key(np->value));
+  if (!pos.second)
   {
-    return insert_node_at(header_, np, true);
+    destroy_node(np);
+    return pos.first.first;
   }
-  key_type key = value_traits::get_key(np->value);
-  if (hint == begin())
-  { // 位于 begin 处
-    if (key_comp_(key, value_traits::get_key(*hint)))
-    {
-      return insert_node_at(hint.node, np, true);
-    }
-    else
-    {
-      auto pos = get_insert_unique_pos(key);
-      if (!pos.second)
-      {
-        destroy_node(np);
-        return pos.first.first;
-      }
-      return insert_node_at(pos.first.first, np, pos.first.second);
-    }
-  }
-  else if (hint == end())
-  { // 位于 end 处
-    if (key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value), key))
-    {
-      return insert_node_at(rightmost(), np, false);
-    }
-    else
-    {
-      auto pos = get_insert_unique_pos(key);
-      if (!pos.second)
-      {
-        destroy_node(np);
-        return pos.first.first;
-      }
-      return insert_node_at(pos.first.first, np, pos.first.second);
-    }
-  }
-  return insert_unique_use_hint(hint, key, np);
+  return insert_node_at(pos.first.first, np, pos.first.second);
+}
+
+// 以 key 确定插入位置后再创建节点，键值重复时不分配内存
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+rb_tree<T, Compare, Alloc>::
+emplace_unique_key(const key_type& key, Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+  auto res = get_insert_unique_pos(key);
+  if (!res.second)
+    return mystl::make_pair(iterator(res.first.first), false);
+  node_ptr np = create_node(mystl::forward<Args>(args)...);
+  return mystl::make_pair(insert_node_at(res.first.first, np, res.first.second), true);
+}
+
+template <class T, class Compare, class Alloc>
+template <class ...Args>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+emplace_unique_key_use_hint(iterator hint, const key_type& key, Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+  auto res = get_insert_unique_hint_pos(hint, key);
+  if (!res.second)
+    return res.first.first;
+  node_ptr np = create_node(mystl::forward<Args>(args)...);
+  return insert_node_at(res.first.first, np, res.first.second);
 }
 
 // 插入元素，节点键值允许重复
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 insert_multi(const value_type& value)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1167,10 +1660,21 @@ insert_multi(const value_type& value)
   return insert_value_at(res.first, value, res.second);
 }
 
+// 移动插入元素，节点键值允许重复，先查找插入位置再把 value 移动进新节点
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+insert_multi(value_type&& value)
+{
+  THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+  auto res = get_insert_multi_pos(value_traits::get_key(value));
+  return insert_value_at(res.first, mystl::move(value), res.second);
+}
+
 // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为 true，否则为 false
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+rb_tree<T, Compare, Alloc>::
 insert_unique(const value_type& value)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1183,25 +1687,21 @@ insert_unique(const value_type& value)
 }
 
 // 删除 hint 位置的节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 erase(iterator hint)
 {
-  auto node = hint.node->get_node_ptr();
-  iterator next(node);
+  iterator next(hint.node);
   ++next;
-  
-  rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
-  destroy_node(node);
-  --node_count_;
+  destroy_node(unlink_node(hint.node));
   return next;
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::
 erase_multi(const key_type& key)
 {
   auto p = equal_range_multi(key);
@@ -1211,9 +1711,9 @@ erase_multi(const key_type& key)
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::
 erase_unique(const key_type& key)
 {
   auto it = find(key);
@@ -1226,8 +1726,8 @@ erase_unique(const key_type& key)
 }
 
 // 删除[first, last)区间内的元素
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 erase(iterator first, iterator last)
 {
   if (first == begin() && last == end())
@@ -1241,138 +1741,190 @@ erase(iterator first, iterator last)
   }
 }
 
-// 清空 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::
-clear()
+// 取出 hint 位置的节点
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_handle_type
+rb_tree<T, Compare, Alloc>::
+extract(iterator hint)
 {
-  if (node_count_ != 0)
-  {
-    erase_since(root());
-    leftmost() = header_;
-    root() = nullptr;
-    rightmost() = header_;
-    node_count_ = 0;
-  }
+  return node_handle_type(unlink_node(hint.node), M_alloc());
 }
 
-// 查找键值为 k 的节点，返回指向它的迭代器
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-find(const key_type& key)
+// 取出一个键值等于 key 的节点，找不到时返回空的句柄
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_handle_type
+rb_tree<T, Compare, Alloc>::
+extract_multi(const key_type& key)
 {
-  auto y = header_;  // 最后一个不小于 key 的节点
-  auto x = root();
-  while (x != nullptr)
-  {
-    if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-    { // key 小于等于 x 键值，向左走
-      y = x, x = x->left;
-    }
-    else
-    { // key 大于 x 键值，向右走
-      x = x->right;
-    }
-  }
-  iterator j = iterator(y);
-  return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
+  auto it = lower_bound(key);
+  if (it != end() && !key_comp_(key, value_traits::get_key(*it)))
+    return extract(it);
+  return node_handle_type();
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-find(const key_type& key) const
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_handle_type
+rb_tree<T, Compare, Alloc>::
+extract_unique(const key_type& key)
 {
-  auto y = header_;  // 最后一个不小于 key 的节点
-  auto x = root();
-  while (x != nullptr)
+  auto it = find(key);
+  return it != end() ? extract(it) : node_handle_type();
+}
+
+// 插入句柄中的节点，键值不允许重复
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::insert_return_type
+rb_tree<T, Compare, Alloc>::
+insert_node_unique(node_handle_type&& nh)
+{
+  if (nh.empty())
+    return insert_return_type{ end(), false, node_handle_type() };
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  auto res = get_insert_unique_pos(value_traits::get_key(nh.node()->value));
+  if (!res.second)
+    return insert_return_type{ iterator(res.first.first), false, mystl::move(nh) };
+  auto it = insert_node_at(res.first.first, nh.release(), res.first.second);
+  return insert_return_type{ it, true, node_handle_type() };
+}
+
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+insert_node_unique(iterator hint, node_handle_type&& nh)
+{
+  if (nh.empty())
+    return end();
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  auto res = get_insert_unique_hint_pos(hint, value_traits::get_key(nh.node()->value));
+  if (!res.second)
+    return res.first.first;
+  return insert_node_at(res.first.first, nh.release(), res.first.second);
+}
+
+// 插入句柄中的节点，键值允许重复
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+insert_node_multi(node_handle_type&& nh)
+{
+  if (nh.empty())
+    return end();
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  auto res = get_insert_multi_pos(value_traits::get_key(nh.node()->value));
+  return insert_node_at(res.first, nh.release(), res.second);
+}
+
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+insert_node_multi(iterator hint, node_handle_type&& nh)
+{
+  if (nh.empty())
+    return end();
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), nh.M_alloc()));
+  auto res = get_insert_multi_hint_pos(hint, value_traits::get_key(nh.node()->value));
+  return insert_node_at(res.first, nh.release(), res.second);
+}
+
+// 合并 rhs 的节点，键值不允许重复
+template <class T, class Compare, class Alloc>
+template <class Compare2>
+void rb_tree<T, Compare, Alloc>::
+merge_unique(rb_tree<T, Compare2, Alloc>& rhs)
+{
+  if (static_cast<void*>(this) == static_cast<void*>(&rhs))
+    return;
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+  for (auto it = rhs.begin(); it != rhs.end();)
   {
-    if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-    { // key 小于等于 x 键值，向左走
-      y = x, x = x->left;
-    }
-    else
-    { // key 大于 x 键值，向右走
-      x = x->right;
-    }
+    auto cur = it++;
+    auto res = get_insert_unique_pos(value_traits::get_key(*cur));
+    if (res.second)
+      insert_node_at(res.first.first, rhs.unlink_node(cur.node), res.first.second);
   }
-  const_iterator j = const_iterator(y);
-  return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
 }
 
-// 键值不小于 key 的第一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-lower_bound(const key_type& key)
+// 合并 rhs 的节点，键值允许重复
+template <class T, class Compare, class Alloc>
+template <class Compare2>
+void rb_tree<T, Compare, Alloc>::
+merge_multi(rb_tree<T, Compare2, Alloc>& rhs)
 {
-  auto y = header_;
-  auto x = root();
-  while (x != nullptr)
+  if (static_cast<void*>(this) == static_cast<void*>(&rhs))
+    return;
+  MYSTL_DEBUG(node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+  for (auto it = rhs.begin(); it != rhs.end();)
   {
-    if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-    { // key <= x
-      y = x, x = x->left;
-    }
-    else
-    {
-      x = x->right;
-    }
+    auto cur = it++;
+    auto res = get_insert_multi_pos(value_traits::get_key(*cur));
+    insert_node_at(res.first, rhs.unlink_node(cur.node), res.second);
   }
-  return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-lower_bound(const key_type& key) const
+// 清空 rb tree
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
+clear()
 {
-  auto y = header_;
-  auto x = root();
-  while (x != nullptr)
+  if (node_count_ != 0)
   {
-    if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
-    { // key <= x
-      y = x, x = x->left;
-    }
-    else
-    {
-      x = x->right;
+    if (release_nodes())
+    { // 分配器保留了最新的一块内存，重新创建 header_ 不会失败
+      rb_tree_init();
+      return;
     }
+    erase_since(root());
+    leftmost() = header_;
+    root() = nullptr;
+    rightmost() = header_;
+    node_count_ = 0;
   }
-  return const_iterator(y);
 }
 
-// 键值大于 key 的第一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-upper_bound(const key_type& key)
+// 查找键值为 k 的节点，返回指向它的节点指针
+template <class T, class Compare, class Alloc>
+template <class K>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::
+find_node(const K& key) const
 {
-  auto y = header_;
-  auto x = root();
+  auto y = lower_bound_node(key);
+  return (y == header_ || key_comp_(key, value_traits::get_key(y->get_node_ptr()->value)))
+    ? header_ : y;
+}
+
+// 键值不小于 key 的第一个位置
+template <class T, class Compare, class Alloc>
+template <class K>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::
+lower_bound_node(const K& key) const
+{
+  base_ptr y = header_;  // 最后一个不小于 key 的节点
+  base_ptr x = root();
   while (x != nullptr)
   {
-    if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value)))
-    { // key < x
+    if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
+    { // key 小于等于 x 键值，向左走
       y = x, x = x->left;
     }
     else
-    {
+    { // key 大于 x 键值，向右走
       x = x->right;
     }
   }
-  return iterator(y);
+  return y;
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-upper_bound(const key_type& key) const
-{
-  auto y = header_;
-  auto x = root();
+// 键值大于 key 的第一个位置
+template <class T, class Compare, class Alloc>
+template <class K>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::
+upper_bound_node(const K& key) const
+{
+  base_ptr y = header_;
+  base_ptr x = root();
   while (x != nullptr)
   {
     if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value)))
@@ -1384,16 +1936,20 @@ upper_bound(const key_type& key) const
       x = x->right;
     }
   }
-  return const_iterator(y);
+  return y;
 }
 
 // 交换 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 swap(rb_tree& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                node_alloc_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename node_alloc_traits::propagate_on_container_swap());
     mystl::swap(header_, rhs.header_);
     mystl::swap(node_count_, rhs.node_count_);
     mystl::swap(key_comp_, rhs.key_comp_);
@@ -1404,75 +1960,149 @@ swap(rb_tree& rhs) noexcept
 // helper function
 
 // 创建一个结点
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::
 create_node(Args&&... args)
 {
-  auto tmp = node_allocator::allocate(1);
+  auto tmp = node_alloc_traits::allocate(M_alloc(), 1);
   try
   {
-    data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(M_alloc(), mystl::address_of(tmp->value),
+                           mystl::forward<Args>(args)...);
     tmp->left = nullptr;
     tmp->right = nullptr;
-    tmp->parent = nullptr;
+    tmp->set_parent_color(nullptr, rb_tree_red);
   }
   catch (...)
   {
-    node_allocator::deallocate(tmp);
+    node_alloc_traits::deallocate(M_alloc(), tmp, 1);
     throw;
   }
   return tmp;
 }
 
 // 复制一个结点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::
 clone_node(base_ptr x)
 {
   node_ptr tmp = create_node(x->get_node_ptr()->value);
-  tmp->color = x->color;
+  tmp->set_color(x->get_color());
+  rb_tree_augment_copy(tmp->get_base_ptr(), x);
   tmp->left = nullptr;
   tmp->right = nullptr;
   return tmp;
 }
 
 // 销毁一个结点
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 destroy_node(node_ptr p)
 {
-  data_allocator::destroy(&p->value);
-  node_allocator::deallocate(p);
+  node_alloc_traits::destroy(M_alloc(), &p->value);
+  node_alloc_traits::deallocate(M_alloc(), p, 1);
 }
 
 // 初始化容器
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 rb_tree_init()
 {
-  header_ = base_allocator::allocate(1);
-  header_->color = rb_tree_red;  // header_ 节点颜色为红，与 root 区分
-  root() = nullptr;
+  base_allocator ba(M_alloc());
+  header_ = base_traits::allocate(ba, 1);
+  header_->set_parent_color(nullptr, rb_tree_red);  // header_ 节点颜色为红，与 root 区分
   leftmost() = header_;
   rightmost() = header_;
   node_count_ = 0;
 }
 
 // reset 函数
-template <class T, class Compare>
-void rb_tree<T, Compare>::reset()
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::reset()
 {
   header_ = nullptr;
   node_count_ = 0;
 }
 
+// destroy_all 函数
+// 销毁所有节点并释放 header_
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::destroy_all()
+{
+  if (header_ != nullptr)
+  {
+    if (!release_nodes())
+    {
+      clear();
+      base_allocator ba(M_alloc());
+      base_traits::deallocate(ba, header_, 1);
+    }
+    reset();
+  }
+}
+
+// copy_tree 函数
+// 复制 rhs 的结构到空树中
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::copy_tree(const rb_tree& rhs)
+{
+  if (rhs.node_count_ != 0)
+  {
+    root() = copy_from(rhs.root(), header_);
+    leftmost() = rb_tree_min(root());
+    rightmost() = rb_tree_max(root());
+  }
+  node_count_ = rhs.node_count_;
+  key_comp_ = rhs.key_comp_;
+}
+
+// move_assign 函数
+// 可以接管 rhs 的节点：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::move_assign(rb_tree& rhs, m_true_type) noexcept
+{
+  destroy_all();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename node_alloc_traits::propagate_on_container_move_assignment());
+  header_ = rhs.header_;
+  node_count_ = rhs.node_count_;
+  key_comp_ = rhs.key_comp_;
+  rhs.reset();
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::move_assign(rb_tree& rhs, m_false_type)
+{
+  if (node_alloc_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  key_comp_ = rhs.key_comp_;
+  move_elements(rhs);
+}
+
+// move_elements 函数
+// 把 rhs 的元素按顺序移动到本树的末尾，rhs 随后被清空
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::move_elements(rb_tree& rhs)
+{
+  if (rhs.header_ == nullptr)
+    return;
+  for (auto it = rhs.begin(); it != rhs.end(); ++it)
+    emplace_multi_use_hint(end(), mystl::move(*it));
+  rhs.clear();
+}
+
 // get_insert_multi_pos 函数
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key)
+template <class T, class Compare, class Alloc>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>
+rb_tree<T, Compare, Alloc>::get_insert_multi_pos(const key_type& key)
 {
   auto x = root();
   auto y = header_;
@@ -1487,9 +2117,9 @@ rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key)
 }
 
 // get_insert_unique_pos 函数
-template <class T, class Compare>
-mystl::pair<mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key)
+template <class T, class Compare, class Alloc>
+mystl::pair<mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc>::get_insert_unique_pos(const key_type& key)
 { // 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个 bool 表示是否在左边插入，
   // 第二个值为一个 bool，表示是否插入成功
   auto x = root();
@@ -1517,51 +2147,31 @@ rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key)
   { // 表明新节点没有重复
     return mystl::make_pair(mystl::make_pair(y, add_to_left), true);
   }
-  // 进行至此，表示新节点与现有节点键值重复
-  return mystl::make_pair(mystl::make_pair(y, add_to_left), false);
+  // 进行至此，表示新节点与现有节点键值重复，返回重复的节点
+  return mystl::make_pair(mystl::make_pair(j.node, add_to_left), false);
 }
 
 // insert_value_at 函数
-// x 为插入点的父节点， value 为要插入的值，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
-{
-  node_ptr node = create_node(value);
-  node->parent = x;
-  auto base_node = node->get_base_ptr();
-  if (x == header_)
-  {
-    root() = base_node;
-    leftmost() = base_node;
-    rightmost() = base_node;
-  }
-  else if (add_to_left)
-  {
-    x->left = base_node;
-    if (leftmost() == x)
-      leftmost() = base_node;
-  }
-  else
-  {
-    x->right = base_node;
-    if (rightmost() == x)
-      rightmost() = base_node;
-  }
-  rb_tree_insert_rebalance(base_node, root());
-  ++node_count_;
-  return iterator(node);
+// x 为插入点的父节点， value 为要插入的值（复制或移动进新节点），add_to_left 表示是否在左边插入
+template <class T, class Compare, class Alloc>
+template <class V>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
+insert_value_at(base_ptr x, V&& value, bool add_to_left)
+{
+  return insert_node_at(x, create_node(mystl::forward<V>(value)), add_to_left);
 }
 
 // 在 x 节点处插入新的节点
 // x 为插入点的父节点， node 为要插入的节点，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
 {
-  node->parent = x;
+  node->set_parent(x);
+  node->left = nullptr;  // 重新链接取出的节点时，旧的链接已经失效
+  node->right = nullptr;
   auto base_node = node->get_base_ptr();
   if (x == header_)
   {
@@ -1586,13 +2196,29 @@ insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
   return iterator(node);
 }
 
-// 插入元素，键值允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
-insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
+// get_insert_multi_hint_pos 函数
+// 在 hint 附近寻找插入点，找不到时退回到从根节点开始查找
+template <class T, class Compare, class Alloc>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>
+rb_tree<T, Compare, Alloc>::
+get_insert_multi_hint_pos(iterator hint, const key_type& key)
 {
-  // 在 hint 附近寻找可插入的位置
+  if (node_count_ == 0)
+  {
+    return mystl::make_pair(header_, true);
+  }
+  if (hint == begin())
+  { // 位于 begin 处
+    if (key_comp_(key, value_traits::get_key(*hint)))
+      return mystl::make_pair(hint.node, true);
+    return get_insert_multi_pos(key);
+  }
+  if (hint == end())
+  { // 位于 end 处
+    if (!key_comp_(key, value_traits::get_key(rightmost()->get_node_ptr()->value)))
+      return mystl::make_pair(rightmost(), false);
+    return get_insert_multi_pos(key);
+  }
   auto np = hint.node;
   auto before = hint;
   --before;
@@ -1601,25 +2227,36 @@ insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
       !key_comp_(value_traits::get_key(*hint), key))
   { // before <= node <= hint
     if (bnp->right == nullptr)
-    {
-      return insert_node_at(bnp, node, false);
-    }
+      return mystl::make_pair(bnp, false);
     else if (np->left == nullptr)
-    {
-      return insert_node_at(np, node, true);
-    }
+      return mystl::make_pair(np, true);
   }
-  auto pos = get_insert_multi_pos(key);
-  return insert_node_at(pos.first, node, pos.second);
+  return get_insert_multi_pos(key);
 }
 
-// 插入元素，键值不允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
-insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
+// get_insert_unique_hint_pos 函数
+// 返回值与 get_insert_unique_pos 相同
+template <class T, class Compare, class Alloc>
+mystl::pair<mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc>::
+get_insert_unique_hint_pos(iterator hint, const key_type& key)
 {
-  // 在 hint 附近寻找可插入的位置
+  if (node_count_ == 0)
+  {
+    return mystl::make_pair(mystl::make_pair(header_, true), true);
+  }
+  if (hint == begin())
+  { // 位于 begin 处
+    if (key_comp_(key, value_traits::get_key(*hint)))
+      return mystl::make_pair(mystl::make_pair(hint.node, true), true);
+    return get_insert_unique_pos(key);
+  }
+  if (hint == end())
+  { // 位于 end 处
+    if (key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value), key))
+      return mystl::make_pair(mystl::make_pair(rightmost(), false), true);
+    return get_insert_unique_pos(key);
+  }
   auto np = hint.node;
   auto before = hint;
   --before;
@@ -1628,31 +2265,183 @@ insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
       key_comp_(key, value_traits::get_key(*hint)))
   { // before < node < hint
     if (bnp->right == nullptr)
-    {
-      return insert_node_at(bnp, node, false);
-    }
+      return mystl::make_pair(mystl::make_pair(bnp, false), true);
     else if (np->left == nullptr)
-    {
-      return insert_node_at(np, node, true);
-    }
+      return mystl::make_pair(mystl::make_pair(np, true), true);
   }
-  auto pos = get_insert_unique_pos(key);
-  if (!pos.second)
+  return get_insert_unique_pos(key);
+}
+
+// unlink_node 函数
+// 把节点 x 从树中摘下并重新平衡，返回该节点
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::
+unlink_node(base_ptr x)
+{
+  auto node = x->get_node_ptr();
+  rb_tree_erase_rebalance(x, root(), leftmost(), rightmost());
+  --node_count_;
+  return node;
+}
+
+// insert_multi_range 函数
+// 只能遍历一次的范围，逐个在末尾附近插入，有序时每次插入只需与最大的节点比较
+template <class T, class Compare, class Alloc>
+template <class InputIter>
+void rb_tree<T, Compare, Alloc>::
+insert_multi_range(InputIter first, InputIter last, input_iterator_tag)
+{
+  for (; first != last; ++first)
+    insert_multi(end(), *first);
+}
+
+template <class T, class Compare, class Alloc>
+template <class ForwardIter>
+void rb_tree<T, Compare, Alloc>::
+insert_multi_range(ForwardIter first, ForwardIter last, forward_iterator_tag)
+{
+  size_type n = mystl::distance(first, last);
+  THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
+  size_type count = 0;
+  if (node_count_ == 0 && n > 1 && sorted_range_count(first, last, false, count))
   {
-    destroy_node(node);
-    return pos.first.first;
+    build_sorted(first, last, count, false);
+    return;
+  }
+  for (; n > 0; --n, ++first)
+    insert_multi(end(), *first);
+}
+
+// insert_unique_range 函数
+template <class T, class Compare, class Alloc>
+template <class InputIter>
+void rb_tree<T, Compare, Alloc>::
+insert_unique_range(InputIter first, InputIter last, input_iterator_tag)
+{
+  for (; first != last; ++first)
+    insert_unique(end(), *first);
+}
+
+template <class T, class Compare, class Alloc>
+template <class ForwardIter>
+void rb_tree<T, Compare, Alloc>::
+insert_unique_range(ForwardIter first, ForwardIter last, forward_iterator_tag)
+{
+  size_type n = mystl::distance(first, last);
+  THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
+  size_type count = 0;
+  if (node_count_ == 0 && n > 1 && sorted_range_count(first, last, true, count))
+  {
+    build_sorted(first, last, count, true);
+    return;
+  }
+  for (; n > 0; --n, ++first)
+    insert_unique(end(), *first);
+}
+
+// sorted_range_count 函数
+// 检查 [first, last) 是否按键值非降序排列，是则在 count 中返回需要建立的节点数，
+// unique 为 true 时相同键值只计一次
+template <class T, class Compare, class Alloc>
+template <class ForwardIter>
+bool rb_tree<T, Compare, Alloc>::
+sorted_range_count(ForwardIter first, ForwardIter last, bool unique, size_type& count)
+{
+  count = 1;
+  for (ForwardIter next = first; ++next != last; first = next)
+  {
+    if (key_comp_(value_traits::get_key(*next), value_traits::get_key(*first)))
+      return false;
+    if (!unique || key_comp_(value_traits::get_key(*first), value_traits::get_key(*next)))
+      ++count;
+  }
+  return true;
+}
+
+// build_sorted 函数
+// 以有序的 [first, last) 在空树上建立 count 个节点的平衡红黑树
+// 每个节点的左右子树大小至多相差一，除最深的一层外每层都是满的，
+// 最深一层的节点染成红色，其余为黑色，每条路径上的黑色节点数相同
+template <class T, class Compare, class Alloc>
+template <class ForwardIter>
+void rb_tree<T, Compare, Alloc>::
+build_sorted(ForwardIter first, ForwardIter last, size_type count, bool unique)
+{
+  MYSTL_DEBUG(node_count_ == 0);
+  size_type red_depth = 0;  // 最深一层的深度，根节点深度为 0
+  for (size_type n = count; n > 1; n >>= 1)
+    ++red_depth;
+  base_ptr r = build_sorted_from(first, last, count, 0, red_depth, unique);
+  r->set_parent(header_);
+  rb_tree_set_black(r);
+  root() = r;
+  base_ptr x = r;
+  while (x->left != nullptr)
+    x = x->left;
+  leftmost() = x;
+  x = r;
+  while (x->right != nullptr)
+    x = x->right;
+  rightmost() = x;
+  node_count_ = count;
+}
+
+// build_sorted_from 函数
+// 按中序依次取出元素，建立 count 个节点的子树，返回子树的根，失败时销毁已建立的节点
+template <class T, class Compare, class Alloc>
+template <class ForwardIter>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::
+build_sorted_from(ForwardIter& first, ForwardIter last, size_type count,
+                  size_type depth, size_type red_depth, bool unique)
+{
+  if (count == 0)
+    return nullptr;
+  const size_type left_count = (count - 1) / 2;
+  base_ptr left = build_sorted_from(first, last, left_count, depth + 1, red_depth, unique);
+  base_ptr x = nullptr;
+  try
+  {
+    x = create_node(*first)->get_base_ptr();
+  }
+  catch (...)
+  {
+    erase_since(left);
+    throw;
   }
-  return insert_node_at(pos.first.first, node, pos.first.second);
+  x->left = left;
+  if (left != nullptr)
+    left->set_parent(x);
+  x->set_color(depth == red_depth && depth != 0 ? rb_tree_red : rb_tree_black);
+  try
+  {
+    // 跳过键值相同的元素，保留第一个
+    const key_type& key = value_traits::get_key(x->get_node_ptr()->value);
+    ++first;
+    while (unique && first != last && !key_comp_(key, value_traits::get_key(*first)))
+      ++first;
+    x->right = build_sorted_from(first, last, count - 1 - left_count, depth + 1, red_depth, unique);
+  }
+  catch (...)
+  {
+    erase_since(x);
+    throw;
+  }
+  if (x->right != nullptr)
+    x->right->set_parent(x);
+  rb_tree_augment_update(x);
+  return x;
 }
 
 // copy_from 函数
 // 递归复制一颗树，节点从 x 开始，p 为 x 的父节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::base_ptr
-rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::copy_from(base_ptr x, base_ptr p)
 {
   auto top = clone_node(x);
-  top->parent = p;
+  top->set_parent(p);
   try
   {
     if (x->right)
@@ -1663,7 +2452,7 @@ rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
     {
       auto y = clone_node(x);
       p->left = y;
-      y->parent = p;
+      y->set_parent(p);
       if (x->right)
         y->right = copy_from(x->right, y);
       p = y;
@@ -1680,8 +2469,8 @@ rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
 
 // erase_since 函数
 // 从 x 节点开始删除该节点及其子树
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 erase_since(base_ptr x)
 {
   while (x != nullptr)
@@ -1694,45 +2483,45 @@ erase_since(base_ptr x)
 }
 
 // 重载比较操作符
-template <class T, class Compare>
-bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator==(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T, class Compare>
-bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator<(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T, class Compare>
-bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator!=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T, class Compare>
-bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator>(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T, class Compare>
-bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator<=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T, class Compare>
-bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator>=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T, class Compare>
-void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept
+template <class T, class Compare, class Alloc>
+void swap(rb_tree<T, Compare, Alloc>& lhs, rb_tree<T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -0,0 +1,1035 @@
+﻿#ifndef MYTINYSTL_RING_BUFFER_H_
+#define MYTINYSTL_RING_BUFFER_H_
+
+// 这个头文件包含两个模板类 ring_buffer 和 fixed_ring_buffer
+// ring_buffer       : 环形缓冲区，元素放在一块连续的空间中，容量为 2 的幂，空间不足时倍增
+// fixed_ring_buffer : 固定容量的环形缓冲区，元素放在对象内部，不分配内存
+
+// notes:
+//
+// 1. 两者都可以作为 mystl::queue 的底层容器，例如 mystl::queue<T, mystl::ring_buffer<T>>
+//    头尾的插入与删除只需要移动一个下标，不需要像 deque 一样维护 map 与缓冲区
+// 2. 头尾下标不回绕，以 pos & (capacity - 1) 定位元素，size() 为两个下标之差
+// 3. ring_buffer 扩容时所有迭代器失效；fixed_ring_buffer 已满时插入会抛出 length_error
+//
+// 异常保证：
+// mystl::ring_buffer<T> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * emplace_front / emplace_back
+//   * push_front / push_back
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "algobase.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// ring_buffer 的初始容量
+#ifndef RING_BUFFER_INIT_SIZE
+#define RING_BUFFER_INIT_SIZE 8
+#endif
+
+// 不小于 n 的最小的 2 的幂
+inline size_t ring_buffer_round_up(size_t n) noexcept
+{
+  size_t cap = 1;
+  while (cap < n)
+    cap <<= 1;
+  return cap;
+}
+
+// ring_buffer 的迭代器设计
+// 保存缓冲区首地址、容量掩码与不回绕的逻辑位置
+template <class T, class Ref, class Ptr>
+struct ring_buffer_iterator : public iterator<random_access_iterator_tag, T>
+{
+  typedef ring_buffer_iterator<T, T&, T*>             iterator;
+  typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+  typedef ring_buffer_iterator                        self;
+
+  typedef T            value_type;
+  typedef Ptr          pointer;
+  typedef Ref          reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  T*        buf;   // 缓冲区首地址
+  size_type mask;  // 容量减一
+  size_type pos;   // 逻辑位置
+
+  ring_buffer_iterator() noexcept
+    :buf(nullptr), mask(0), pos(0) {}
+
+  ring_buffer_iterator(T* b, size_type m, size_type p) noexcept
+    :buf(b), mask(m), pos(p) {}
+
+  ring_buffer_iterator(const iterator& rhs) noexcept
+    :buf(rhs.buf), mask(rhs.mask), pos(rhs.pos) {}
+
+  reference operator*()  const { return buf[pos & mask]; }
+  pointer   operator->() const { return buf + (pos & mask); }
+
+  // 下标不回绕，两者之差就是距离
+  difference_type operator-(const self& x) const
+  { return static_cast<difference_type>(pos - x.pos); }
+
+  self& operator++()    { ++pos; return *this; }
+  self  operator++(int) { self tmp = *this; ++pos; return tmp; }
+  self& operator--()    { --pos; return *this; }
+  self  operator--(int) { self tmp = *this; --pos; return tmp; }
+
+  self& operator+=(difference_type n) { pos += static_cast<size_type>(n); return *this; }
+  self& operator-=(difference_type n) { pos -= static_cast<size_type>(n); return *this; }
+  self  operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+  self  operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const { return pos == rhs.pos; }
+  bool operator< (const self& rhs) const { return (*this - rhs) < 0; }
+  bool operator!=(const self& rhs) const { return !(*this == rhs); }
+  bool operator> (const self& rhs) const { return rhs < *this; }
+  bool operator<=(const self& rhs) const { return !(rhs < *this); }
+  bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+/*****************************************************************************************/
+
+// 模板类 ring_buffer
+// 模板参数 T 代表数据类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
+class ring_buffer
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+public:
+  // ring_buffer 的型别定义
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef ring_buffer_iterator<T, T&, T*>             iterator;
+  typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  // 元素能否按字节搬移，决定扩容时移动元素的方式
+  typedef mystl::alloc_can_relocate<data_allocator, T> relocate_type;
+
+  pointer   buf_;   // 缓冲区
+  size_type cap_;   // 容量，为 0 或 2 的幂
+  size_type head_;  // 第一个元素的逻辑位置
+  size_type tail_;  // 最后一个元素的下一逻辑位置
+
+public:
+  // 构造、复制、移动、析构函数
+
+  ring_buffer() noexcept
+    :buf_(nullptr), cap_(0), head_(0), tail_(0) {}
+
+  explicit ring_buffer(const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), cap_(0), head_(0), tail_(0) {}
+
+  explicit ring_buffer(size_type n, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), cap_(0), head_(0), tail_(0)
+  { fill_init(n, value_type()); }
+
+  ring_buffer(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), cap_(0), head_(0), tail_(0)
+  { fill_init(n, value); }
+
+  template <class IIter, typename std::enable_if<
+    mystl::is_input_iterator<IIter>::value, int>::type = 0>
+  ring_buffer(IIter first, IIter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), cap_(0), head_(0), tail_(0)
+  { copy_init(first, last, iterator_category(first)); }
+
+  ring_buffer(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc)), buf_(nullptr), cap_(0), head_(0), tail_(0)
+  { copy_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag()); }
+
+  ring_buffer(const ring_buffer& rhs)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc())),
+    buf_(nullptr), cap_(0), head_(0), tail_(0)
+  { copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag()); }
+
+  ring_buffer(ring_buffer&& rhs) noexcept
+    :alloc_base(mystl::move(rhs.M_alloc())),
+    buf_(rhs.buf_), cap_(rhs.cap_), head_(rhs.head_), tail_(rhs.tail_)
+  {
+    rhs.buf_ = nullptr;
+    rhs.cap_ = 0;
+    rhs.head_ = 0;
+    rhs.tail_ = 0;
+  }
+
+  ring_buffer& operator=(const ring_buffer& rhs);
+  ring_buffer& operator=(ring_buffer&& rhs)
+    noexcept(data_traits::propagate_on_container_move_assignment::value ||
+             data_traits::is_always_equal::value);
+
+  ring_buffer& operator=(std::initializer_list<value_type> ilist)
+  {
+    ring_buffer tmp(ilist, M_alloc());
+    swap(tmp);
+    return *this;
+  }
+
+  ~ring_buffer()
+  { destroy_all(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept
+  { return iterator(buf_, cap_ - 1, head_); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(buf_, cap_ - 1, head_); }
+  iterator               end()           noexcept
+  { return iterator(buf_, cap_ - 1, tail_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(buf_, cap_ - 1, tail_); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return head_ == tail_; }
+  size_type size()     const noexcept { return tail_ - head_; }
+  size_type capacity() const noexcept { return cap_; }
+  size_type max_size() const noexcept { return data_traits::max_size(M_alloc()); }
+  void      reserve(size_type n);
+  void      shrink_to_fit();
+
+  // 访问元素相关操作
+
+  reference       operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return *slot(head_ + n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return *slot(head_ + n);
+  }
+
+  reference       at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "ring_buffer<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "ring_buffer<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *slot(head_);
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *slot(head_);
+  }
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *slot(tail_ - 1);
+  }
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return *slot(tail_ - 1);
+  }
+
+  // 修改容器相关操作
+
+  template <class ...Args>
+  void emplace_back(Args&& ...args);
+  template <class ...Args>
+  void emplace_front(Args&& ...args);
+
+  void push_back(const value_type& value)  { emplace_back(value); }
+  void push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+  void push_front(const value_type& value) { emplace_front(value); }
+  void push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+
+  void pop_front()
+  {
+    MYSTL_DEBUG(!empty());
+    data_traits::destroy(M_alloc(), slot(head_));
+    ++head_;
+  }
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --tail_;
+    data_traits::destroy(M_alloc(), slot(tail_));
+  }
+
+  void clear() noexcept;
+
+  void swap(ring_buffer& rhs) noexcept;
+
+private:
+  // helper functions
+
+  pointer slot(size_type pos) const noexcept
+  { return buf_ + (pos & (cap_ - 1)); }
+
+  size_type get_new_cap(size_type add_size) const;
+
+  // initialize / destroy
+  void      fill_init(size_type n, const value_type& value);
+  template <class IIter>
+  void      copy_init(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void      copy_init(FIter first, FIter last, forward_iterator_tag);
+  void      destroy_all() noexcept;
+
+  // assign
+  void      move_assign(ring_buffer& rhs, m_true_type) noexcept;
+  void      move_assign(ring_buffer& rhs, m_false_type);
+
+  // reallocate
+  void      relocate_to(pointer dst, m_true_type) noexcept;
+  void      relocate_to(pointer dst, m_false_type);
+  void      replace_buffer(pointer new_buf, size_type new_cap, size_type new_head);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值运算符
+template <class T, class Alloc>
+ring_buffer<T, Alloc>& ring_buffer<T, Alloc>::operator=(const ring_buffer& rhs)
+{
+  if (this != &rhs)
+  {
+    if (data_traits::propagate_on_container_copy_assignment::value &&
+        !data_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 旧的空间必须由旧的分配器释放
+      destroy_all();
+    }
+    mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(),
+                             typename data_traits::propagate_on_container_copy_assignment());
+    clear();
+    reserve(rhs.size());
+    for (const auto& value : rhs)
+      emplace_back(value);
+  }
+  return *this;
+}
+
+// 移动赋值运算符
+template <class T, class Alloc>
+ring_buffer<T, Alloc>& ring_buffer<T, Alloc>::operator=(ring_buffer&& rhs)
+  noexcept(data_traits::propagate_on_container_move_assignment::value ||
+           data_traits::is_always_equal::value)
+{
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                data_traits::propagate_on_container_move_assignment::value ||
+                data_traits::is_always_equal::value>());
+  }
+  return *this;
+}
+
+// 预留至少容纳 n 个元素的空间
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::reserve(size_type n)
+{
+  if (n <= cap_)
+    return;
+  THROW_LENGTH_ERROR_IF(n > max_size(), "ring_buffer<T>'s size too big");
+  const auto new_cap = mystl::ring_buffer_round_up(n);
+  replace_buffer(data_traits::allocate(M_alloc(), new_cap), new_cap, 0);
+}
+
+// 放弃多余的容量，容量仍为 2 的幂
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::shrink_to_fit()
+{
+  if (empty())
+  {
+    destroy_all();
+    return;
+  }
+  const auto new_cap = mystl::ring_buffer_round_up(size());
+  if (new_cap < cap_)
+    replace_buffer(data_traits::allocate(M_alloc(), new_cap), new_cap, 0);
+}
+
+// 在尾部就地构造元素
+template <class T, class Alloc>
+template <class ...Args>
+void ring_buffer<T, Alloc>::emplace_back(Args&& ...args)
+{
+  if (size() < cap_)
+  {
+    data_traits::construct(M_alloc(), slot(tail_), mystl::forward<Args>(args)...);
+    ++tail_;
+    return;
+  }
+  const auto n = size();
+  const auto new_cap = get_new_cap(1);
+  auto new_buf = data_traits::allocate(M_alloc(), new_cap);
+  try
+  { // 先构造新元素，参数可能引用容器中的元素
+    data_traits::construct(M_alloc(), new_buf + n, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_traits::deallocate(M_alloc(), new_buf, new_cap);
+    throw;
+  }
+  try
+  {
+    replace_buffer(new_buf, new_cap, 0);
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), new_buf + n);
+    data_traits::deallocate(M_alloc(), new_buf, new_cap);
+    throw;
+  }
+  ++tail_;
+}
+
+// 在头部就地构造元素
+template <class T, class Alloc>
+template <class ...Args>
+void ring_buffer<T, Alloc>::emplace_front(Args&& ...args)
+{
+  if (size() < cap_)
+  {
+    data_traits::construct(M_alloc(), slot(head_ - 1), mystl::forward<Args>(args)...);
+    --head_;
+    return;
+  }
+  // 新元素放在新空间的最后一个位置，原有元素从 0 开始放置
+  const auto new_cap = get_new_cap(1);
+  auto new_buf = data_traits::allocate(M_alloc(), new_cap);
+  try
+  {
+    data_traits::construct(M_alloc(), new_buf + new_cap - 1, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_traits::deallocate(M_alloc(), new_buf, new_cap);
+    throw;
+  }
+  try
+  {
+    replace_buffer(new_buf, new_cap, 0);
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), new_buf + new_cap - 1);
+    data_traits::deallocate(M_alloc(), new_buf, new_cap);
+    throw;
+  }
+  --head_;
+}
+
+// 析构所有元素，保留空间
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::clear() noexcept
+{
+  for (; head_ != tail_; ++head_)
+    data_traits::destroy(M_alloc(), slot(head_));
+  head_ = tail_ = 0;
+}
+
+// 与另一个 ring_buffer 交换
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::swap(ring_buffer& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
+    mystl::swap(buf_, rhs.buf_);
+    mystl::swap(cap_, rhs.cap_);
+    mystl::swap(head_, rhs.head_);
+    mystl::swap(tail_, rhs.tail_);
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// get_new_cap 函数
+template <class T, class Alloc>
+typename ring_buffer<T, Alloc>::size_type
+ring_buffer<T, Alloc>::get_new_cap(size_type add_size) const
+{
+  THROW_LENGTH_ERROR_IF(size() > max_size() - add_size, "ring_buffer<T>'s size too big");
+  const auto need = size() + add_size;
+  auto new_cap = cap_ == 0 ? static_cast<size_type>(RING_BUFFER_INIT_SIZE) : cap_ * 2;
+  return new_cap < need ? mystl::ring_buffer_round_up(need) : new_cap;
+}
+
+// fill_init 函数
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::fill_init(size_type n, const value_type& value)
+{
+  reserve(n);
+  try
+  {
+    for (; n > 0; --n)
+      emplace_back(value);
+  }
+  catch (...)
+  {
+    destroy_all();
+    throw;
+  }
+}
+
+// copy_init 函数
+template <class T, class Alloc>
+template <class IIter>
+void ring_buffer<T, Alloc>::copy_init(IIter first, IIter last, input_iterator_tag)
+{
+  try
+  {
+    for (; first != last; ++first)
+      emplace_back(*first);
+  }
+  catch (...)
+  {
+    destroy_all();
+    throw;
+  }
+}
+
+template <class T, class Alloc>
+template <class FIter>
+void ring_buffer<T, Alloc>::copy_init(FIter first, FIter last, forward_iterator_tag)
+{
+  const size_type n = mystl::distance(first, last);
+  reserve(n);
+  try
+  {
+    for (; first != last; ++first)
+      emplace_back(*first);
+  }
+  catch (...)
+  {
+    destroy_all();
+    throw;
+  }
+}
+
+// destroy_all 函数
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::destroy_all() noexcept
+{
+  clear();
+  if (buf_ != nullptr)
+    data_traits::deallocate(M_alloc(), buf_, cap_);
+  buf_ = nullptr;
+  cap_ = 0;
+}
+
+// 分配器相等时直接接管 rhs 的空间
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::move_assign(ring_buffer& rhs, m_true_type) noexcept
+{
+  destroy_all();
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename data_traits::propagate_on_container_move_assignment());
+  buf_ = rhs.buf_;
+  cap_ = rhs.cap_;
+  head_ = rhs.head_;
+  tail_ = rhs.tail_;
+  rhs.buf_ = nullptr;
+  rhs.cap_ = 0;
+  rhs.head_ = 0;
+  rhs.tail_ = 0;
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::move_assign(ring_buffer& rhs, m_false_type)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  reserve(rhs.size());
+  for (auto& value : rhs)
+    emplace_back(mystl::move(value));
+  rhs.clear();
+}
+
+// relocate_to 函数
+// 把 [head_, tail_) 上的元素依次搬移到 dst 开始的空间，元素在原空间中最多分成两段
+// 元素可以按字节搬移时直接复制内存，原空间上的元素不再析构
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::relocate_to(pointer dst, m_true_type) noexcept
+{
+  const auto n = size();
+  if (n == 0)
+    return;
+  const auto first = head_ & (cap_ - 1);
+  const auto len = mystl::min(n, cap_ - first);
+  mystl::uninitialized_relocate(buf_ + first, buf_ + first + len, dst);
+  mystl::uninitialized_relocate(buf_, buf_ + (n - len), dst + len);
+}
+
+// 否则逐个移动元素，全部移动成功后再析构原有元素，移动失败时原有元素保持不变
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::relocate_to(pointer dst, m_false_type)
+{
+  const auto n = size();
+  if (n == 0)
+    return;
+  const auto first = head_ & (cap_ - 1);
+  const auto len = mystl::min(n, cap_ - first);
+  auto mid = mystl::uninitialized_move_a(buf_ + first, buf_ + first + len, dst, M_alloc());
+  try
+  {
+    mystl::uninitialized_move_a(buf_, buf_ + (n - len), mid, M_alloc());
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), dst, mid);
+    throw;
+  }
+  for (auto i = head_; i != tail_; ++i)
+    data_traits::destroy(M_alloc(), slot(i));
+}
+
+// replace_buffer 函数
+// 把元素搬移到新空间中从 new_head 开始的位置，再释放原空间
+// 搬移失败时释放新空间，原有元素保持不变
+template <class T, class Alloc>
+void ring_buffer<T, Alloc>::
+replace_buffer(pointer new_buf, size_type new_cap, size_type new_head)
+{
+  const auto n = size();
+  relocate_to(new_buf + new_head, relocate_type());
+  if (buf_ != nullptr)
+    data_traits::deallocate(M_alloc(), buf_, cap_);
+  buf_ = new_buf;
+  cap_ = new_cap;
+  head_ = new_head;
+  tail_ = new_head + n;
+}
+
+// 重载比较操作符
+template <class T, class Alloc>
+bool operator==(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Alloc>
+bool operator<(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+bool operator!=(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc>
+bool operator>(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc>
+bool operator<=(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc>
+bool operator>=(const ring_buffer<T, Alloc>& lhs, const ring_buffer<T, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Alloc>
+void swap(ring_buffer<T, Alloc>& lhs, ring_buffer<T, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// ring_buffer 只保存一个指向堆上空间的指针，可以按字节搬移
+template <class T, class Alloc>
+struct is_trivially_relocatable<ring_buffer<T, Alloc>> :is_trivially_relocatable<Alloc> {};
+
+/*****************************************************************************************/
+
+// 模板类 fixed_ring_buffer
+// 模板参数 T 代表数据类型，N 代表容量，必须是 2 的幂
+template <class T, size_t N>
+class fixed_ring_buffer
+{
+  static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity of fixed_ring_buffer must be a power of 2");
+
+public:
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef ring_buffer_iterator<T, T&, T*>             iterator;
+  typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+
+  storage_type buf_[N];
+  size_type    head_;
+  size_type    tail_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  fixed_ring_buffer() noexcept
+    :head_(0), tail_(0) {}
+
+  explicit fixed_ring_buffer(size_type n)
+    :head_(0), tail_(0)
+  { fill_init(n, value_type()); }
+
+  fixed_ring_buffer(size_type n, const value_type& value)
+    :head_(0), tail_(0)
+  { fill_init(n, value); }
+
+  template <class IIter, typename std::enable_if<
+    mystl::is_input_iterator<IIter>::value, int>::type = 0>
+  fixed_ring_buffer(IIter first, IIter last)
+    :head_(0), tail_(0)
+  { copy_init(first, last); }
+
+  fixed_ring_buffer(std::initializer_list<value_type> ilist)
+    :head_(0), tail_(0)
+  { copy_init(ilist.begin(), ilist.end()); }
+
+  fixed_ring_buffer(const fixed_ring_buffer& rhs)
+    :head_(0), tail_(0)
+  { copy_init(rhs.begin(), rhs.end()); }
+
+  fixed_ring_buffer(fixed_ring_buffer&& rhs)
+    :head_(0), tail_(0)
+  {
+    try
+    {
+      for (auto& value : rhs)
+        emplace_back(mystl::move(value));
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+    rhs.clear();
+  }
+
+  fixed_ring_buffer& operator=(const fixed_ring_buffer& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      for (const auto& value : rhs)
+        emplace_back(value);
+    }
+    return *this;
+  }
+
+  fixed_ring_buffer& operator=(fixed_ring_buffer&& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      for (auto& value : rhs)
+        emplace_back(mystl::move(value));
+      rhs.clear();
+    }
+    return *this;
+  }
+
+  fixed_ring_buffer& operator=(std::initializer_list<value_type> ilist)
+  {
+    THROW_LENGTH_ERROR_IF(ilist.size() > N, "fixed_ring_buffer<T, N> is full");
+    clear();
+    for (const auto& value : ilist)
+      emplace_back(value);
+    return *this;
+  }
+
+  ~fixed_ring_buffer()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept
+  { return iterator(base(), N - 1, head_); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(base(), N - 1, head_); }
+  iterator               end()           noexcept
+  { return iterator(base(), N - 1, tail_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(base(), N - 1, tail_); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return head_ == tail_; }
+  bool      full()     const noexcept { return tail_ - head_ == N; }
+  size_type size()     const noexcept { return tail_ - head_; }
+  static constexpr size_type capacity() noexcept { return N; }
+  static constexpr size_type max_size() noexcept { return N; }
+
+  // 访问元素相关操作
+
+  reference       operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return *slot(head_ + n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return *slot(head_ + n);
+  }
+
+  reference       at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "fixed_ring_buffer<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "fixed_ring_buffer<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()       { MYSTL_DEBUG(!empty()); return *slot(head_); }
+  const_reference front() const { MYSTL_DEBUG(!empty()); return *slot(head_); }
+  reference       back()        { MYSTL_DEBUG(!empty()); return *slot(tail_ - 1); }
+  const_reference back()  const { MYSTL_DEBUG(!empty()); return *slot(tail_ - 1); }
+
+  // 修改容器相关操作，已满时抛出 length_error
+
+  template <class ...Args>
+  void emplace_back(Args&& ...args)
+  {
+    THROW_LENGTH_ERROR_IF(full(), "fixed_ring_buffer<T, N> is full");
+    mystl::construct(slot(tail_), mystl::forward<Args>(args)...);
+    ++tail_;
+  }
+  template <class ...Args>
+  void emplace_front(Args&& ...args)
+  {
+    THROW_LENGTH_ERROR_IF(full(), "fixed_ring_buffer<T, N> is full");
+    mystl::construct(slot(head_ - 1), mystl::forward<Args>(args)...);
+    --head_;
+  }
+
+  void push_back(const value_type& value)  { emplace_back(value); }
+  void push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+  void push_front(const value_type& value) { emplace_front(value); }
+  void push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+
+  void pop_front()
+  {
+    MYSTL_DEBUG(!empty());
+    mystl::destroy(slot(head_));
+    ++head_;
+  }
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --tail_;
+    mystl::destroy(slot(tail_));
+  }
+
+  void clear() noexcept
+  {
+    for (; head_ != tail_; ++head_)
+      mystl::destroy(slot(head_));
+    head_ = tail_ = 0;
+  }
+
+  // 元素在对象内部，只能逐个交换
+  void swap(fixed_ring_buffer& rhs)
+  {
+    if (this != &rhs)
+    {
+      fixed_ring_buffer tmp(mystl::move(rhs));
+      rhs = mystl::move(*this);
+      *this = mystl::move(tmp);
+    }
+  }
+
+private:
+  // 迭代器只保存非 const 指针，const 版本的 begin() 也使用它
+  T* base() const noexcept
+  { return const_cast<T*>(reinterpret_cast<const T*>(buf_)); }
+
+  T* slot(size_type pos) const noexcept
+  { return base() + (pos & (N - 1)); }
+
+  void fill_init(size_type n, const value_type& value)
+  {
+    THROW_LENGTH_ERROR_IF(n > N, "fixed_ring_buffer<T, N> is full");
+    try
+    {
+      for (; n > 0; --n)
+        emplace_back(value);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  template <class IIter>
+  void copy_init(IIter first, IIter last)
+  {
+    try
+    {
+      for (; first != last; ++first)
+        emplace_back(*first);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+};
+
+// 重载比较操作符
+template <class T, size_t N>
+bool operator==(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator<(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const fixed_ring_buffer<T, N>& lhs, const fixed_ring_buffer<T, N>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N>
+void swap(fixed_ring_buffer<T, N>& lhs, fixed_ring_buffer<T, N>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+namespace pmr
+{
+template <class T>
+using ring_buffer = mystl::ring_buffer<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
+} // namespace mystl
+#endif // !MYTINYSTL_RING_BUFFER_H_
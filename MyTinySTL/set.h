@@ -18,9 +18,14 @@
 namespace mystl
 {
 
+template <class, class, class>
+class multiset;
+
 // 模板类 set，键值不允许重复
-// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <class Key, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
 class set
 {
 public:
@@ -31,12 +36,17 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;
 
+  template <class, class, class>
+  friend class set;
+  template <class, class, class>
+  friend class multiset;
+
 public:
   // 使用 rb_tree 定义的型别
-  typedef typename base_type::node_type              node_type;
+  typedef typename base_type::node_handle_type       node_type;
   typedef typename base_type::const_pointer          pointer;
   typedef typename base_type::const_pointer          const_pointer;
   typedef typename base_type::const_reference        reference;
@@ -48,27 +58,47 @@ public:
   typedef typename base_type::size_type              size_type;
   typedef typename base_type::difference_type        difference_type;
   typedef typename base_type::allocator_type         allocator_type;
+  typedef mystl::node_insert_return<iterator, node_type> insert_return_type;
 
 public:
   // 构造、复制、移动函数
   set() = default;
 
+  explicit set(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit set(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
   template <class InputIterator>
-  set(InputIterator first, InputIterator last) 
-    :tree_() 
+  set(InputIterator first, InputIterator last,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_unique(first, last); }
-  set(std::initializer_list<value_type> ilist)
-    :tree_()
+  set(std::initializer_list<value_type> ilist,
+      const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
-  set(const set& rhs) 
+  set(const set& rhs)
     :tree_(rhs.tree_)
   {
   }
+  set(const set& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   set(set&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  set(set&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   set& operator=(const set& rhs)
   {
@@ -171,6 +201,30 @@ public:
 
   void      clear() { tree_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配内存
+
+  node_type extract(iterator position)           { return tree_.extract(position); }
+  node_type extract(const key_type& key)         { return tree_.extract_unique(key); }
+
+  insert_return_type insert(node_type&& nh)
+  {
+    auto r = tree_.insert_node_unique(mystl::move(nh));
+    return insert_return_type{ r.position, r.inserted, mystl::move(r.node) };
+  }
+  iterator  insert(iterator hint, node_type&& nh)
+  {
+    return tree_.insert_node_unique(hint, mystl::move(nh));
+  }
+
+  template <class Compare2>
+  void merge(set<Key, Compare2, Alloc>& source)   { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(set<Key, Compare2, Alloc>&& source)  { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(multiset<Key, Compare2, Alloc>& source)  { tree_.merge_unique(source.tree_); }
+  template <class Compare2>
+  void merge(multiset<Key, Compare2, Alloc>&& source) { tree_.merge_unique(source.tree_); }
+
   // set 相关操作
 
   iterator       find(const key_type& key)              { return tree_.find(key); }
@@ -192,6 +246,51 @@ public:
     equal_range(const key_type& key) const
   { return tree_.equal_range_unique(key); }
 
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_unique(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_unique(key); }
+
   void swap(set& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -201,45 +300,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc>
+void swap(set<Key, Compare, Alloc>& lhs, set<Key, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -247,8 +346,10 @@ void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
 /*****************************************************************************************/
 
 // 模板类 multiset，键值允许重复
-// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <class Key, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
 class multiset
 {
 public:
@@ -259,12 +360,17 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;  // 以 rb_tree 表现 multiset
 
+  template <class, class, class>
+  friend class set;
+  template <class, class, class>
+  friend class multiset;
+
 public:
   // 使用 rb_tree 定义的型别
-  typedef typename base_type::node_type              node_type;
+  typedef typename base_type::node_handle_type       node_type;
   typedef typename base_type::const_pointer          pointer;
   typedef typename base_type::const_pointer          const_pointer;
   typedef typename base_type::const_reference        reference;
@@ -281,22 +387,41 @@ public:
   // 构造、复制、移动函数
   multiset() = default;
 
+  explicit multiset(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+  explicit multiset(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+
   template <class InputIterator>
-  multiset(InputIterator first, InputIterator last) 
-    :tree_() 
+  multiset(InputIterator first, InputIterator last,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_multi(first, last); }
-  multiset(std::initializer_list<value_type> ilist)
-    :tree_() 
+  multiset(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
   { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
   multiset(const multiset& rhs)
     :tree_(rhs.tree_)
   {
   }
+  multiset(const multiset& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   multiset(multiset&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  multiset(multiset&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   multiset& operator=(const multiset& rhs) 
   { 
@@ -399,6 +524,29 @@ public:
 
   void           clear() { tree_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配内存
+
+  node_type extract(iterator position)           { return tree_.extract(position); }
+  node_type extract(const key_type& key)         { return tree_.extract_multi(key); }
+
+  iterator  insert(node_type&& nh)
+  {
+    return tree_.insert_node_multi(mystl::move(nh));
+  }
+  iterator  insert(iterator hint, node_type&& nh)
+  {
+    return tree_.insert_node_multi(hint, mystl::move(nh));
+  }
+
+  template <class Compare2>
+  void merge(multiset<Key, Compare2, Alloc>& source)   { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(multiset<Key, Compare2, Alloc>&& source)  { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(set<Key, Compare2, Alloc>& source)  { tree_.merge_multi(source.tree_); }
+  template <class Compare2>
+  void merge(set<Key, Compare2, Alloc>&& source) { tree_.merge_multi(source.tree_); }
+
   // multiset 相关操作
 
   iterator       find(const key_type& key)              { return tree_.find(key); }
@@ -420,6 +568,51 @@ public:
     equal_range(const key_type& key) const
   { return tree_.equal_range_multi(key); }
 
+  bool           contains(const key_type& key)    const { return tree_.find(key) != tree_.end(); }
+
+  // 异构查找，需要 Compare 声明 is_transparent，如 mystl::less<>
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       find(const K& key)                     { return tree_.find(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator find(const K& key)               const { return tree_.find(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  size_type      count(const K& key)              const { return tree_.count_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  bool           contains(const K& key)           const { return tree_.find(key) != tree_.end(); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<iterator, iterator>
+    equal_range(const K& key)
+  { return tree_.equal_range_multi(key); }
+
+  template <class K, class C = Compare,
+    typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+  pair<const_iterator, const_iterator>
+    equal_range(const K& key) const
+  { return tree_.equal_range_multi(key); }
+
   void swap(multiset& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -429,49 +622,68 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc>
+void swap(multiset<Key, Compare, Alloc>& lhs, multiset<Key, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// rb_tree 的 header_ 节点分配在堆上，比较函数与分配器可以按字节搬移时，整个容器也可以
+template <class Key, class Compare, class Alloc>
+struct is_trivially_relocatable<set<Key, Compare, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Compare>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class Compare, class Alloc>
+struct is_trivially_relocatable<multiset<Key, Compare, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Compare>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+namespace pmr
+{
+template <class Key, class Compare = mystl::less<Key>>
+using set = mystl::set<Key, Compare, polymorphic_allocator<Key>>;
+template <class Key, class Compare = mystl::less<Key>>
+using multiset = mystl::multiset<Key, Compare, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_SET_H_
 
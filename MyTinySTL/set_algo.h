@@ -1,32 +1,83 @@
 ﻿#ifndef MYTINYSTL_SET_ALGO_H_
 #define MYTINYSTL_SET_ALGO_H_
 
-// 这个头文件包含 set 的四种算法: union, intersection, difference, symmetric_difference
+// 这个头文件包含 set 的四种算法: union, intersection, difference, symmetric_difference，
+// 以及多个序列的 intersection 与 union
 // 所有函数都要求序列有序
 
+// notes:
+//
+// 1. 两个序列都是随机访问迭代器，并且一个的长度超过另一个的 MYSTL_SET_GALLOP_RATIO 倍时，
+//    改用跳跃查找（galloping）：在较长的序列中以 1、2、4 … 的步长跳过较小的元素再二分，
+//    比较次数与 短序列长度 * log(长度之比) 成正比，结果与逐个归并相同
+// 2. set_intersection_unique 要求两个序列严格递增（没有重复元素），
+//    元素为 4 字节整数的数组时每次比较 4 * 4 个元素
+// 3. set_intersection_many / set_union_many 的参数是一组 [first, second) 区间，
+//    结果与依次两两计算相同；相等的元素可能取自不同的序列
+
 #include "algobase.h"
+#include "algo.h"
 #include "iterator.h"
+#include "vector.h"
 
 namespace mystl
 {
 
+#ifndef MYSTL_SET_GALLOP_RATIO
+#define MYSTL_SET_GALLOP_RATIO 32
+#endif
+
+// 两个序列的长度之比超过 MYSTL_SET_GALLOP_RATIO
+template <class RandomIter1, class RandomIter2>
+bool set_skewed(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2)
+{
+  const size_t n1 = static_cast<size_t>(last1 - first1);
+  const size_t n2 = static_cast<size_t>(last2 - first2);
+  return n1 / MYSTL_SET_GALLOP_RATIO > n2 || n2 / MYSTL_SET_GALLOP_RATIO > n1;
+}
+
+// 从 first 开始以 1、2、4 … 的步长向后查找，再在最后一步跨过的范围内二分，
+// 返回第一个不小于 value 的位置，代价与 first 到结果的距离的对数成正比
+template <class RandomIter, class T, class Compared>
+RandomIter set_gallop(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+  const difference_type n = last - first;
+  if (n == 0 || !comp(*first, value))
+    return first;
+  // first[lo] 小于 value，结果在 (lo, hi] 中
+  difference_type lo = 0, step = 1, hi = 1;
+  while (hi < n && comp(*(first + hi), value))
+  {
+    lo = hi;
+    step <<= 1;
+    hi = lo + step;
+  }
+  if (hi > n)
+    hi = n;
+  return mystl::bound_search(first + lo + 1, first + hi,
+                             bound_less_pred<T, Compared>{ value, comp });
+}
+
 /*****************************************************************************************/
 // set_union
 // 计算 S1∪S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
 /*****************************************************************************************/
-template <class InputIter1, class InputIter2, class OutputIter>
-OutputIter set_union(InputIter1 first1, InputIter1 last1,
-                     InputIter2 first2, InputIter2 last2, 
-                     OutputIter result)
+// set_union_dispatch 的 input_iterator_tag 版本，逐个归并
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_union_dispatch(InputIter1 first1, InputIter1 last1,
+                              InputIter2 first2, InputIter2 last2,
+                              OutputIter result, Compared comp,
+                              input_iterator_tag, input_iterator_tag)
 {
   while (first1 != last1 && first2 != last2)
   {
-    if (*first1 < *first2)
+    if (comp(*first1, *first2))
     {
       *result = *first1;
       ++first1;
     }
-    else if (*first2 < *first1)
+    else if (comp(*first2, *first1))
     {
       *result = *first2;
       ++first2;
@@ -43,52 +94,80 @@ OutputIter set_union(InputIter1 first1, InputIter1 last1,
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class InputIter1, class InputIter2, class OutputIter, class Compared>
-OutputIter set_union(InputIter1 first1, InputIter1 last1,
-                     InputIter2 first2, InputIter2 last2, 
-                     OutputIter result, Compared comp)
+// set_union_dispatch 的 random_access_iterator_tag 版本，长度相差悬殊时跳跃查找
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_union_dispatch(RandomIter1 first1, RandomIter1 last1,
+                              RandomIter2 first2, RandomIter2 last2,
+                              OutputIter result, Compared comp,
+                              random_access_iterator_tag, random_access_iterator_tag)
 {
+  if (!mystl::set_skewed(first1, last1, first2, last2))
+  {
+    return mystl::set_union_dispatch(first1, last1, first2, last2, result, comp,
+                                     input_iterator_tag(), input_iterator_tag());
+  }
   while (first1 != last1 && first2 != last2)
   {
     if (comp(*first1, *first2))
     {
-      *result = *first1;
-      ++first1;
+      auto next = mystl::set_gallop(first1 + 1, last1, *first2, comp);
+      result = mystl::copy(first1, next, result);
+      first1 = next;
     }
     else if (comp(*first2, *first1))
     {
-      *result = *first2;
-      ++first2;
+      auto next = mystl::set_gallop(first2 + 1, last2, *first1, comp);
+      result = mystl::copy(first2, next, result);
+      first2 = next;
     }
     else
     {
       *result = *first1;
       ++first1;
       ++first2;
+      ++result;
     }
-    ++result;
   }
-  // 将剩余元素拷贝到 result
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
 }
 
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result)
+{
+  return mystl::set_union_dispatch(first1, last1, first2, last2, result, bound_op_less(),
+                                   iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result, Compared comp)
+{
+  return mystl::set_union_dispatch(first1, last1, first2, last2, result, comp,
+                                   iterator_category(first1), iterator_category(first2));
+}
+
 /*****************************************************************************************/
 // set_intersection
 // 计算 S1∩S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
 /*****************************************************************************************/
-template <class InputIter1, class InputIter2, class OutputIter>
-OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
-                            InputIter2 first2, InputIter2 last2, 
-                            OutputIter result)
+// set_intersection_dispatch 的 input_iterator_tag 版本，逐个归并
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection_dispatch(InputIter1 first1, InputIter1 last1,
+                                     InputIter2 first2, InputIter2 last2,
+                                     OutputIter result, Compared comp,
+                                     input_iterator_tag, input_iterator_tag)
 {
   while (first1 != last1 && first2 != last2)
   {
-    if (*first1 < *first2)
+    if (comp(*first1, *first2))
     {
       ++first1;
     }
-    else if (*first2 < *first1)
+    else if (comp(*first2, *first1))
     {
       ++first2;
     }
@@ -103,21 +182,27 @@ OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
   return result;
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class InputIter1, class InputIter2, class OutputIter, class Compared>
-OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
-                            InputIter2 first2, InputIter2 last2,
-                            OutputIter result, Compared comp)
+// set_intersection_dispatch 的 random_access_iterator_tag 版本，长度相差悬殊时跳跃查找
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_intersection_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter result, Compared comp,
+                                     random_access_iterator_tag, random_access_iterator_tag)
 {
+  if (!mystl::set_skewed(first1, last1, first2, last2))
+  {
+    return mystl::set_intersection_dispatch(first1, last1, first2, last2, result, comp,
+                                            input_iterator_tag(), input_iterator_tag());
+  }
   while (first1 != last1 && first2 != last2)
   {
     if (comp(*first1, *first2))
     {
-      ++first1;
+      first1 = mystl::set_gallop(first1 + 1, last1, *first2, comp);
     }
     else if (comp(*first2, *first1))
     {
-      ++first2;
+      first2 = mystl::set_gallop(first2 + 1, last2, *first1, comp);
     }
     else
     {
@@ -130,24 +215,45 @@ OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
   return result;
 }
 
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result)
+{
+  return mystl::set_intersection_dispatch(first1, last1, first2, last2, result, bound_op_less(),
+                                          iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result, Compared comp)
+{
+  return mystl::set_intersection_dispatch(first1, last1, first2, last2, result, comp,
+                                          iterator_category(first1), iterator_category(first2));
+}
+
 /*****************************************************************************************/
 // set_difference
 // 计算 S1-S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
 /*****************************************************************************************/
-template <class InputIter1, class InputIter2, class OutputIter>
-OutputIter set_difference(InputIter1 first1, InputIter1 last1,
-                          InputIter2 first2, InputIter2 last2,
-                          OutputIter result)
+// set_difference_dispatch 的 input_iterator_tag 版本，逐个归并
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference_dispatch(InputIter1 first1, InputIter1 last1,
+                                   InputIter2 first2, InputIter2 last2,
+                                   OutputIter result, Compared comp,
+                                   input_iterator_tag, input_iterator_tag)
 {
   while (first1 != last1 && first2 != last2)
   {
-    if (*first1 < *first2)
+    if (comp(*first1, *first2))
     {
       *result = *first1;
       ++first1;
       ++result;
     }
-    else if (*first2 < *first1)
+    else if (comp(*first2, *first1))
     {
       ++first2;
     }
@@ -160,23 +266,29 @@ OutputIter set_difference(InputIter1 first1, InputIter1 last1,
   return mystl::copy(first1, last1, result);
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class InputIter1, class InputIter2, class OutputIter, class Compared>
-OutputIter set_difference(InputIter1 first1, InputIter1 last1,
-                          InputIter2 first2, InputIter2 last2, 
-                          OutputIter result, Compared comp)
+// set_difference_dispatch 的 random_access_iterator_tag 版本，长度相差悬殊时跳跃查找
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_difference_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared comp,
+                                   random_access_iterator_tag, random_access_iterator_tag)
 {
+  if (!mystl::set_skewed(first1, last1, first2, last2))
+  {
+    return mystl::set_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                          input_iterator_tag(), input_iterator_tag());
+  }
   while (first1 != last1 && first2 != last2)
   {
     if (comp(*first1, *first2))
     {
-      *result = *first1;
-      ++first1;
-      ++result;
+      auto next = mystl::set_gallop(first1 + 1, last1, *first2, comp);
+      result = mystl::copy(first1, next, result);
+      first1 = next;
     }
     else if (comp(*first2, *first1))
     {
-      ++first2;
+      first2 = mystl::set_gallop(first2 + 1, last2, *first1, comp);
     }
     else
     {
@@ -187,24 +299,45 @@ OutputIter set_difference(InputIter1 first1, InputIter1 last1,
   return mystl::copy(first1, last1, result);
 }
 
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result)
+{
+  return mystl::set_difference_dispatch(first1, last1, first2, last2, result, bound_op_less(),
+                                        iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result, Compared comp)
+{
+  return mystl::set_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                        iterator_category(first1), iterator_category(first2));
+}
+
 /*****************************************************************************************/
 // set_symmetric_difference
 // 计算 (S1-S2)∪(S2-S1) 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
 /*****************************************************************************************/
-template <class InputIter1, class InputIter2, class OutputIter>
-OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
-                                    InputIter2 first2, InputIter2 last2, 
-                                    OutputIter result)
+// set_symmetric_difference_dispatch 的 input_iterator_tag 版本，逐个归并
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference_dispatch(InputIter1 first1, InputIter1 last1,
+                                             InputIter2 first2, InputIter2 last2,
+                                             OutputIter result, Compared comp,
+                                             input_iterator_tag, input_iterator_tag)
 {
   while (first1 != last1 && first2 != last2)
   {
-    if (*first1 < *first2)
+    if (comp(*first1, *first2))
     {
       *result = *first1;
       ++first1;
       ++result;
     }
-    else if (*first2 < *first1)
+    else if (comp(*first2, *first1))
     {
       *result = *first2;
       ++first2;
@@ -219,25 +352,31 @@ OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class InputIter1, class InputIter2, class OutputIter, class Compared>
-OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
-                                    InputIter2 first2, InputIter2 last2,
-                                    OutputIter result, Compared comp)
+// set_symmetric_difference_dispatch 的 random_access_iterator_tag 版本，长度相差悬殊时跳跃查找
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                             RandomIter2 first2, RandomIter2 last2,
+                                             OutputIter result, Compared comp,
+                                             random_access_iterator_tag, random_access_iterator_tag)
 {
+  if (!mystl::set_skewed(first1, last1, first2, last2))
+  {
+    return mystl::set_symmetric_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                                    input_iterator_tag(), input_iterator_tag());
+  }
   while (first1 != last1 && first2 != last2)
   {
     if (comp(*first1, *first2))
     {
-      *result = *first1;
-      ++first1;
-      ++result;
+      auto next = mystl::set_gallop(first1 + 1, last1, *first2, comp);
+      result = mystl::copy(first1, next, result);
+      first1 = next;
     }
     else if (comp(*first2, *first1))
     {
-      *result = *first2;
-      ++first2;
-      ++result;
+      auto next = mystl::set_gallop(first2 + 1, last2, *first1, comp);
+      result = mystl::copy(first2, next, result);
+      first2 = next;
     }
     else
     {
@@ -248,6 +387,191 @@ OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
 }
 
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result)
+{
+  return mystl::set_symmetric_difference_dispatch(first1, last1, first2, last2, result, bound_op_less(),
+                                                  iterator_category(first1), iterator_category(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result, Compared comp)
+{
+  return mystl::set_symmetric_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                                  iterator_category(first1), iterator_category(first2));
+}
+
+/*****************************************************************************************/
+// set_intersection_unique
+// 计算 S1∩S2，两个序列都必须严格递增，返回一个迭代器指向输出结果的尾部
+// 元素为 4 字节整数的数组并且长度相差不大时使用 simd::intersect_unique，否则同 set_intersection
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection_unique_dispatch(InputIter1 first1, InputIter1 last1,
+                                            InputIter2 first2, InputIter2 last2,
+                                            OutputIter result, std::false_type)
+{
+  return mystl::set_intersection(first1, last1, first2, last2, result);
+}
+
+template <class E1, class E2, class E>
+E* set_intersection_unique_dispatch(E1* first1, E1* last1, E2* first2, E2* last2,
+                                    E* result, std::true_type)
+{
+  if (mystl::set_skewed(first1, last1, first2, last2))
+    return mystl::set_intersection(first1, last1, first2, last2, result);
+  return result + simd::intersect_unique<E>(first1, static_cast<size_t>(last1 - first1),
+                                            first2, static_cast<size_t>(last2 - first2),
+                                            result);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection_unique(InputIter1 first1, InputIter1 last1,
+                                   InputIter2 first2, InputIter2 last2,
+                                   OutputIter result)
+{
+  return mystl::set_intersection_unique_dispatch(first1, last1, first2, last2, result,
+    simd::is_intersect_range<InputIter1, InputIter2, OutputIter>());
+}
+
+/*****************************************************************************************/
+// set_intersection_many
+// 计算 [lists_first, lists_last) 中所有区间的交集并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// 区间的类型有成员 first 与 second，是随机访问迭代器，例如 mystl::pair<const int*, const int*>
+// 以最短的区间为候选，按长度从短到长在其它区间中跳跃查找；某个区间中没有候选值时，
+// 以它的下一个元素为界在最短的区间中跳过候选，输出的元素取自最短的区间
+/*****************************************************************************************/
+template <class ForwardIter, class OutputIter, class Compared>
+OutputIter set_intersection_many(ForwardIter lists_first, ForwardIter lists_last,
+                                 OutputIter result, Compared comp)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type range_type;
+  mystl::vector<range_type> lists(lists_first, lists_last);
+  if (lists.empty())
+    return result;
+  mystl::sort(lists.begin(), lists.end(), [](const range_type& x, const range_type& y)
+  {
+    return x.second - x.first < y.second - y.first;
+  });
+  const size_t k = lists.size();
+  auto first = lists[0].first;
+  auto last = lists[0].second;
+  while (first != last)
+  {
+    size_t i = 1;
+    for (; i < k; ++i)
+    {
+      auto& cur = lists[i];
+      cur.first = mystl::set_gallop(cur.first, cur.second, *first, comp);
+      if (cur.first == cur.second)
+        return result;
+      if (comp(*first, *cur.first))
+        break;
+    }
+    if (i < k)
+    {
+      first = mystl::set_gallop(first + 1, last, *lists[i].first, comp);
+      continue;
+    }
+    // 所有区间中都有，各消耗一个
+    *result = *first;
+    ++result;
+    ++first;
+    for (i = 1; i < k; ++i)
+      ++lists[i].first;
+  }
+  return result;
+}
+
+template <class ForwardIter, class OutputIter>
+OutputIter set_intersection_many(ForwardIter lists_first, ForwardIter lists_last,
+                                 OutputIter result)
+{
+  return mystl::set_intersection_many(lists_first, lists_last, result, bound_op_less());
+}
+
+/*****************************************************************************************/
+// set_union_many
+// 计算 [lists_first, lists_last) 中所有区间的并集并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// 区间的要求同 set_intersection_many
+// 以区间的首元素建立小顶堆，每次取出首元素相等的所有区间，输出其中相等元素最多的一段
+/*****************************************************************************************/
+template <class ForwardIter, class OutputIter, class Compared>
+OutputIter set_union_many(ForwardIter lists_first, ForwardIter lists_last,
+                          OutputIter result, Compared comp)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type range_type;
+  mystl::vector<range_type> heap;
+  for (; lists_first != lists_last; ++lists_first)
+  {
+    if (lists_first->first != lists_first->second)
+      heap.push_back(*lists_first);
+  }
+  // 首元素较大的区间在堆中较靠下
+  auto heap_comp = [&comp](const range_type& x, const range_type& y)
+  {
+    return static_cast<bool>(comp(*y.first, *x.first));
+  };
+  mystl::make_heap(heap.begin(), heap.end(), heap_comp);
+  while (heap.size() > 1)
+  {
+    // 首元素等于最小值的区间移到 [group, heap.end())
+    auto group = heap.end();
+    mystl::pop_heap(heap.begin(), group, heap_comp);
+    --group;
+    const auto& value = *group->first;
+    while (group != heap.begin() && !comp(value, *heap.front().first))
+    {
+      mystl::pop_heap(heap.begin(), group, heap_comp);
+      --group;
+    }
+    // 各区间跳过等于 value 的一段，输出最长的一段
+    auto best_first = group->first;
+    auto best_last = group->first;
+    for (auto it = group; it != heap.end(); ++it)
+    {
+      auto run_first = it->first;
+      auto run_last = run_first + 1;
+      while (run_last != it->second && !comp(value, *run_last))
+        ++run_last;
+      if (run_last - run_first > best_last - best_first)
+      {
+        best_first = run_first;
+        best_last = run_last;
+      }
+      it->first = run_last;
+    }
+    result = mystl::copy(best_first, best_last, result);
+    // 没有用完的区间放回堆中
+    auto keep = group;
+    for (auto it = group; it != heap.end(); ++it)
+    {
+      if (it->first != it->second)
+      {
+        *keep = *it;
+        ++keep;
+        mystl::push_heap(heap.begin(), keep, heap_comp);
+      }
+    }
+    heap.erase(keep, heap.end());
+  }
+  if (!heap.empty())
+    result = mystl::copy(heap.front().first, heap.front().second, result);
+  return result;
+}
+
+template <class ForwardIter, class OutputIter>
+OutputIter set_union_many(ForwardIter lists_first, ForwardIter lists_last,
+                          OutputIter result)
+{
+  return mystl::set_union_many(lists_first, lists_last, result, bound_op_less());
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_SET_ALGO_H_
 
@@ -0,0 +1,1115 @@
+﻿#ifndef MYTINYSTL_SIMD_H_
+#define MYTINYSTL_SIMD_H_
+
+// 这个头文件包含 mystl 使用的字节查找内核，以及按元素查找、计数与比较的内核
+// 在 x86 上根据编译选项使用 SSE2 / SSSE3 / AVX2 指令，其余平台使用可移植的标量版本
+// 定义 MYSTL_NO_SIMD 可以关闭向量化版本
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(MYSTL_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYSTL_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define MYSTL_SIMD_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define MYSTL_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#endif // !MYSTL_NO_SIMD
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace mystl
+{
+namespace simd
+{
+
+// 查找子串时，模式串长于这个值才会改用 Two-Way 算法
+enum { two_way_threshold = 32 };
+
+// 最低位 1 的下标，x 不能为 0
+inline unsigned lowest_bit(unsigned x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long r;
+  _BitScanForward(&r, x);
+  return static_cast<unsigned>(r);
+#else
+  return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+// 最高位 1 的下标，x 不能为 0
+inline unsigned highest_bit(unsigned x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long r;
+  _BitScanReverse(&r, x);
+  return static_cast<unsigned>(r);
+#else
+  return 31u - static_cast<unsigned>(__builtin_clz(x));
+#endif
+}
+
+/*****************************************************************************************/
+// byte_set
+// 最多 256 个字节值构成的集合，用于 find_first_of 一类的查找
+
+struct byte_set
+{
+  enum { small_size = 8 };
+
+  uint32_t      bits[8];            // 每个字节值对应一位
+  unsigned char small[small_size];  // 集合不超过 8 个元素时逐个比较
+  size_t        count;              // 集合中不同字节值的个数
+#if MYSTL_SIMD_SSSE3
+  unsigned char lo_table[16];  // 低四位为 i 且高四位为 0~7 的字节值
+  unsigned char hi_table[16];  // 低四位为 i 且高四位为 8~15 的字节值
+#endif
+
+  byte_set(const char* s, size_t n) noexcept
+  {
+    std::memset(bits, 0, sizeof(bits));
+    count = 0;
+#if MYSTL_SIMD_SSSE3
+    std::memset(lo_table, 0, sizeof(lo_table));
+    std::memset(hi_table, 0, sizeof(hi_table));
+#endif
+    for (size_t i = 0; i < n; ++i)
+    {
+      const unsigned char c = static_cast<unsigned char>(s[i]);
+      if ((bits[c >> 5] >> (c & 31)) & 1u)
+        continue;
+      bits[c >> 5] |= 1u << (c & 31);
+      if (count < small_size)
+        small[count] = c;
+      ++count;
+#if MYSTL_SIMD_SSSE3
+      if (c < 128)
+        lo_table[c & 15] |= static_cast<unsigned char>(1u << (c >> 4));
+      else
+        hi_table[c & 15] |= static_cast<unsigned char>(1u << ((c >> 4) - 8));
+#endif
+    }
+  }
+
+  bool test(char ch) const noexcept
+  {
+    const unsigned char c = static_cast<unsigned char>(ch);
+    return (bits[c >> 5] >> (c & 31)) & 1u;
+  }
+};
+
+/*****************************************************************************************/
+// 标量版本，也用于处理向量化版本剩下的尾部
+
+// 在 [first, last) 中查找 c，找不到返回 last
+inline const char* find_char_scalar(const char* first, const char* last, char c) noexcept
+{
+  if (first == last)
+    return last;
+  const void* p = std::memchr(first, c, static_cast<size_t>(last - first));
+  return p ? static_cast<const char*>(p) : last;
+}
+
+// 在 [first, last) 中反向查找 c，找不到返回 last
+inline const char* rfind_char_scalar(const char* first, const char* last, char c) noexcept
+{
+  for (const char* p = last; p != first; )
+  {
+    if (*--p == c)
+      return p;
+  }
+  return last;
+}
+
+// 在 [first, last) 中查找长度为 m 的 s，m >= 1，找不到返回 last
+inline const char* search_scalar(const char* first, const char* last,
+                                 const char* s, size_t m) noexcept
+{
+  if (static_cast<size_t>(last - first) < m)
+    return last;
+  const char* stop = last - m + 1;
+  for (const char* p = first; ; ++p)
+  {
+    p = find_char_scalar(p, stop, s[0]);
+    if (p == stop)
+      return last;
+    if (std::memcmp(p + 1, s + 1, m - 1) == 0)
+      return p;
+  }
+}
+
+// 在 [first, last) 中反向查找长度为 m 的 s，m >= 1，找不到返回 last
+inline const char* rsearch_scalar(const char* first, const char* last,
+                                  const char* s, size_t m) noexcept
+{
+  if (static_cast<size_t>(last - first) < m)
+    return last;
+  for (const char* p = last - m + 1; p != first; )
+  {
+    --p;
+    if (*p == s[0] && std::memcmp(p + 1, s + 1, m - 1) == 0)
+      return p;
+  }
+  return last;
+}
+
+// 在 [first, last) 中查找第一个属于（not_in 为 true 时为不属于）set 的字节，找不到返回 last
+inline const char* find_of_scalar(const char* first, const char* last,
+                                  const byte_set& set, bool not_in) noexcept
+{
+  for (; first != last; ++first)
+  {
+    if (set.test(*first) != not_in)
+      return first;
+  }
+  return last;
+}
+
+// 反向查找最后一个属于（not_in 为 true 时为不属于）set 的字节，找不到返回 last
+inline const char* rfind_of_scalar(const char* first, const char* last,
+                                   const byte_set& set, bool not_in) noexcept
+{
+  for (const char* p = last; p != first; )
+  {
+    if (set.test(*--p) != not_in)
+      return p;
+  }
+  return last;
+}
+
+/*****************************************************************************************/
+// Two-Way 算法（Crochemore-Perrin），结合最后一个字节的移位表跳过不可能匹配的位置
+// 预处理 O(m)，查找 O(n)，不需要额外的堆空间
+
+// 计算模式串的最大后缀，reverse 为 true 时使用相反的字典序，返回后缀起点的前一个位置
+inline size_t maximal_suffix(const unsigned char* s, size_t m, bool reverse, size_t& period) noexcept
+{
+  size_t ip = static_cast<size_t>(-1);
+  size_t jp = 0;
+  size_t k = 1;
+  size_t p = 1;
+  while (jp + k < m)
+  {
+    const unsigned char a = s[ip + k];
+    const unsigned char b = s[jp + k];
+    if (a == b)
+    {
+      if (k == p)
+      {
+        jp += p;
+        k = 1;
+      }
+      else
+      {
+        ++k;
+      }
+    }
+    else if (reverse ? a < b : a > b)
+    {
+      jp += k;
+      k = 1;
+      p = jp - ip;
+    }
+    else
+    {
+      ip = jp++;
+      k = p = 1;
+    }
+  }
+  period = p;
+  return ip;
+}
+
+inline const char* search_two_way(const char* first, const char* last,
+                                  const char* s, size_t m) noexcept
+{
+  if (static_cast<size_t>(last - first) < m)
+    return last;
+  const unsigned char* n = reinterpret_cast<const unsigned char*>(s);
+  const unsigned char* h = reinterpret_cast<const unsigned char*>(first);
+  const unsigned char* z = reinterpret_cast<const unsigned char*>(last);
+
+  // shift[c] 为 c 在模式串中最后出现的位置加一，用于对齐窗口的最后一个字节
+  size_t shift[256];
+  std::memset(shift, 0, sizeof(shift));
+  for (size_t i = 0; i < m; ++i)
+    shift[n[i]] = i + 1;
+
+  // 临界分解：取两种字典序下较靠后的最大后缀
+  size_t p0 = 0, p1 = 0;
+  size_t ms = maximal_suffix(n, m, false, p0);
+  const size_t ms1 = maximal_suffix(n, m, true, p1);
+  size_t p = p0;
+  if (ms1 + 1 > ms + 1)
+  {
+    ms = ms1;
+    p = p1;
+  }
+
+  // 周期性模式串可以记住已经匹配的前缀长度 mem
+  size_t mem0 = 0;
+  if (std::memcmp(n, n + p, ms + 1) != 0)
+    p = (ms > m - ms - 1 ? ms : m - ms - 1) + 1;
+  else
+    mem0 = m - p;
+  size_t mem = 0;
+
+  for (;;)
+  {
+    if (static_cast<size_t>(z - h) < m)
+      return last;
+    const size_t k0 = m - shift[h[m - 1]];
+    if (k0 != 0)
+    {
+      h += k0 < mem ? mem : k0;
+      mem = 0;
+      continue;
+    }
+    // 先比较右半部分
+    size_t k = ms + 1 > mem ? ms + 1 : mem;
+    while (k < m && n[k] == h[k])
+      ++k;
+    if (k < m)
+    {
+      h += k - ms;
+      mem = 0;
+      continue;
+    }
+    // 再比较左半部分
+    k = ms + 1;
+    while (k > mem && n[k - 1] == h[k - 1])
+      --k;
+    if (k <= mem)
+      return reinterpret_cast<const char*>(h);
+    h += p;
+    mem = mem0;
+  }
+}
+
+/*****************************************************************************************/
+// 向量化版本
+
+#if MYSTL_SIMD_SSE2
+
+inline __m128i load16(const char* p) noexcept
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline unsigned eq_mask16(const char* p, __m128i v) noexcept
+{
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(load16(p), v)));
+}
+
+#if MYSTL_SIMD_AVX2
+inline unsigned eq_mask32(const char* p, __m256i v) noexcept
+{
+  return static_cast<unsigned>(_mm256_movemask_epi8(
+    _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), v)));
+}
+#endif
+
+// 对 16 个字节做集合测试，集合不超过 8 个元素，返回属于集合的字节构成的掩码
+inline unsigned small_set_mask16(__m128i x, const __m128i* v, size_t n) noexcept
+{
+  __m128i hit = _mm_cmpeq_epi8(x, v[0]);
+  for (size_t i = 1; i < n; ++i)
+    hit = _mm_or_si128(hit, _mm_cmpeq_epi8(x, v[i]));
+  return static_cast<unsigned>(_mm_movemask_epi8(hit));
+}
+
+#if MYSTL_SIMD_SSSE3
+// 对 16 个字节做集合测试，返回属于集合的字节构成的掩码
+inline unsigned set_mask16(__m128i x, __m128i lo_table, __m128i hi_table) noexcept
+{
+  const __m128i low4 = _mm_set1_epi8(0x0f);
+  const __m128i lo = _mm_and_si128(x, low4);
+  const __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), low4);
+  // 以低四位查表得到该列的位图，再以高四位选出对应的位
+  const __m128i row_lo = _mm_shuffle_epi8(lo_table, lo);
+  const __m128i row_hi = _mm_shuffle_epi8(hi_table, lo);
+  const __m128i is_lo = _mm_cmplt_epi8(hi, _mm_set1_epi8(8));
+  const __m128i row = _mm_or_si128(_mm_and_si128(is_lo, row_lo),
+                                   _mm_andnot_si128(is_lo, row_hi));
+  const __m128i bit_table = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                          1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i bit = _mm_shuffle_epi8(bit_table, hi);
+  const __m128i hit = _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+  return static_cast<unsigned>(_mm_movemask_epi8(hit));
+}
+#endif
+
+#endif // MYSTL_SIMD_SSE2
+
+// 在 [first, last) 中查找 c，找不到返回 last
+inline const char* find_char(const char* first, const char* last, char c) noexcept
+{
+#if MYSTL_SIMD_AVX2
+  const __m256i v32 = _mm256_set1_epi8(c);
+  for (; last - first >= 32; first += 32)
+  {
+    const unsigned mask = eq_mask32(first, v32);
+    if (mask != 0)
+      return first + lowest_bit(mask);
+  }
+#endif
+#if MYSTL_SIMD_SSE2
+  const __m128i v = _mm_set1_epi8(c);
+  for (; last - first >= 16; first += 16)
+  {
+    const unsigned mask = eq_mask16(first, v);
+    if (mask != 0)
+      return first + lowest_bit(mask);
+  }
+  for (; first != last; ++first)
+  {
+    if (*first == c)
+      return first;
+  }
+  return last;
+#else
+  return find_char_scalar(first, last, c);
+#endif
+}
+
+// 在 [first, last) 中反向查找 c，找不到返回 last
+inline const char* rfind_char(const char* first, const char* last, char c) noexcept
+{
+#if MYSTL_SIMD_SSE2
+  const __m128i v = _mm_set1_epi8(c);
+  for (const char* p = last; p - first >= 16; )
+  {
+    p -= 16;
+    const unsigned mask = eq_mask16(p, v);
+    if (mask != 0)
+      return p + highest_bit(mask);
+  }
+  const char* head = first + (last - first) % 16;
+  const char* r = rfind_char_scalar(first, head, c);
+  return r == head ? last : r;
+#else
+  return rfind_char_scalar(first, last, c);
+#endif
+}
+
+// 在 [first, last) 中查找长度为 m 的 s，m 为 0 时返回 first，找不到返回 last
+// 同时比较窗口的首尾字节筛选候选位置，再逐个验证
+// 长模式串验证失败的字节数过多时改用 Two-Way 算法，保证最坏情况下也是线性时间
+inline const char* search(const char* first, const char* last,
+                          const char* s, size_t m) noexcept
+{
+  if (m == 0)
+    return first;
+  if (m == 1)
+    return find_char(first, last, s[0]);
+  if (static_cast<size_t>(last - first) < m)
+    return last;
+#if MYSTL_SIMD_SSE2
+  const __m128i vf = _mm_set1_epi8(s[0]);
+  const __m128i vl = _mm_set1_epi8(s[m - 1]);
+  const char* p = first;
+  const char* stop = last - m + 1;  // 候选起点的范围为 [first, stop)
+  size_t work = 0;
+  for (; stop - p >= 16; p += 16)
+  {
+    unsigned mask = eq_mask16(p, vf) & eq_mask16(p + m - 1, vl);
+    while (mask != 0)
+    {
+      const unsigned i = lowest_bit(mask);
+      if (std::memcmp(p + i + 1, s + 1, m - 2) == 0)
+        return p + i;
+      if (m > two_way_threshold && (work += m) > static_cast<size_t>(p - first) * 2 + 1024)
+        return search_two_way(p + i + 1, last, s, m);
+      mask &= mask - 1;
+    }
+  }
+  // 剩下不足 16 个候选位置
+  return search_scalar(p, last, s, m);
+#else
+  if (m > two_way_threshold)
+    return search_two_way(first, last, s, m);
+  return search_scalar(first, last, s, m);
+#endif
+}
+
+// 在 [first, last) 中反向查找长度为 m 的 s，m 为 0 时返回 last，找不到返回 last
+inline const char* rsearch(const char* first, const char* last,
+                           const char* s, size_t m) noexcept
+{
+  if (m == 0)
+    return last;
+  if (m == 1)
+    return rfind_char(first, last, s[0]);
+  if (static_cast<size_t>(last - first) < m)
+    return last;
+#if MYSTL_SIMD_SSE2
+  const __m128i vf = _mm_set1_epi8(s[0]);
+  const __m128i vl = _mm_set1_epi8(s[m - 1]);
+  const char* stop = last - m + 1;
+  const char* p = stop;
+  while (p - first >= 16)
+  {
+    p -= 16;
+    unsigned mask = eq_mask16(p, vf) & eq_mask16(p + m - 1, vl);
+    while (mask != 0)
+    {
+      const unsigned i = highest_bit(mask);
+      if (std::memcmp(p + i + 1, s + 1, m - 2) == 0)
+        return p + i;
+      mask &= ~(1u << i);
+    }
+  }
+  // 剩下的候选起点为 [first, p)
+  const char* r = rsearch_scalar(first, p + m - 1, s, m);
+  return r == p + m - 1 ? last : r;
+#else
+  return rsearch_scalar(first, last, s, m);
+#endif
+}
+
+// 在 [first, last) 中查找第一个属于（not_in 为 true 时为不属于）set 的字节，找不到返回 last
+inline const char* find_of(const char* first, const char* last,
+                           const byte_set& set, bool not_in) noexcept
+{
+#if MYSTL_SIMD_SSSE3
+  const __m128i lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lo_table));
+  const __m128i hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.hi_table));
+  const unsigned flip = not_in ? 0xffffu : 0u;
+  for (; last - first >= 16; first += 16)
+  {
+    const unsigned mask = set_mask16(load16(first), lo_table, hi_table) ^ flip;
+    if (mask != 0)
+      return first + lowest_bit(mask);
+  }
+#elif MYSTL_SIMD_SSE2
+  if (set.count != 0 && set.count <= byte_set::small_size)
+  {
+    __m128i v[byte_set::small_size];
+    for (size_t i = 0; i < set.count; ++i)
+      v[i] = _mm_set1_epi8(static_cast<char>(set.small[i]));
+    const unsigned flip = not_in ? 0xffffu : 0u;
+    for (; last - first >= 16; first += 16)
+    {
+      const unsigned mask = small_set_mask16(load16(first), v, set.count) ^ flip;
+      if (mask != 0)
+        return first + lowest_bit(mask);
+    }
+  }
+#endif
+  return find_of_scalar(first, last, set, not_in);
+}
+
+// 反向查找最后一个属于（not_in 为 true 时为不属于）set 的字节，找不到返回 last
+inline const char* rfind_of(const char* first, const char* last,
+                            const byte_set& set, bool not_in) noexcept
+{
+#if MYSTL_SIMD_SSSE3
+  const __m128i lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lo_table));
+  const __m128i hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.hi_table));
+  const unsigned flip = not_in ? 0xffffu : 0u;
+  for (const char* p = last; p - first >= 16; )
+  {
+    p -= 16;
+    const unsigned mask = set_mask16(load16(p), lo_table, hi_table) ^ flip;
+    if (mask != 0)
+      return p + highest_bit(mask);
+  }
+  const char* head = first + (last - first) % 16;
+  const char* r = rfind_of_scalar(first, head, set, not_in);
+  return r == head ? last : r;
+#else
+  return rfind_of_scalar(first, last, set, not_in);
+#endif
+}
+
+// 统计 [first, last) 中 c 出现的次数
+inline size_t count_char(const char* first, const char* last, char c) noexcept
+{
+  size_t n = 0;
+#if MYSTL_SIMD_SSE2
+  const __m128i v = _mm_set1_epi8(c);
+  for (; last - first >= 16; first += 16)
+  {
+    unsigned mask = eq_mask16(first, v);
+    for (; mask != 0; mask &= mask - 1)
+      ++n;
+  }
+#endif
+  for (; first != last; ++first)
+  {
+    if (*first == c)
+      ++n;
+  }
+  return n;
+}
+
+/*****************************************************************************************/
+// 按元素查找、计数与比较
+// 元素为整数时按同样大小的无符号整数逐位比较，与 operator== 的结果相同；
+// 元素为 float / double 时按浮点数比较，NaN 与任何值都不相等，+0 与 -0 相等
+// 比较每次得到一个字节掩码，每个元素占 sizeof(T) 位
+
+template <size_t Size> struct uint_of_size {};
+template <> struct uint_of_size<1> { typedef uint8_t  type; };
+template <> struct uint_of_size<2> { typedef uint16_t type; };
+template <> struct uint_of_size<4> { typedef uint32_t type; };
+template <> struct uint_of_size<8> { typedef uint64_t type; };
+
+// cmp_type<T>::type 为比较时使用的类型，不能向量化比较时为 void
+template <class T, class U = typename std::remove_cv<T>::type,
+          bool = std::is_integral<U>::value, bool = std::is_floating_point<U>::value>
+struct cmp_type { typedef void type; };
+
+template <class T, class U>
+struct cmp_type<T, U, true, false> { typedef typename uint_of_size<sizeof(U)>::type type; };
+
+template <class T>
+struct cmp_type<T, float, false, true> { typedef float type; };
+
+template <class T>
+struct cmp_type<T, double, false, true> { typedef double type; };
+
+// Iter1 与 Iter2 都是指向同一种可以向量化比较的类型的指针
+template <class Iter1, class Iter2>
+struct is_compare_range :public std::false_type {};
+
+template <class T, class U>
+struct is_compare_range<T*, U*>
+  :public std::integral_constant<bool,
+    std::is_same<typename std::remove_cv<T>::type, typename std::remove_cv<U>::type>::value &&
+    !std::is_void<typename cmp_type<T>::type>::value>
+{
+};
+
+// Iter 是指向可以向量化比较的类型的指针，并且它的元素与 T 类型的值比较时可以换成元素类型之间的比较：
+// T 与元素类型相同，或者二者都是 bool 以外的整数
+template <class Iter, class T>
+struct is_find_range :public std::false_type {};
+
+template <class E, class T>
+struct is_find_range<E*, T>
+  :public std::integral_constant<bool,
+    !std::is_void<typename cmp_type<E>::type>::value &&
+    (std::is_same<typename std::remove_cv<E>::type, T>::value ||
+     (std::is_integral<E>::value && std::is_integral<T>::value &&
+      !std::is_same<typename std::remove_cv<E>::type, bool>::value &&
+      !std::is_same<T, bool>::value))>
+{
+};
+
+// 元素类型 E 的值与整数 value 比较时按通常的算术转换进行，
+// value 转换为 E 再转换回来不变时，与 E(value) 比较的结果相同，否则不会与任何 E 的值相等
+template <class E, class T>
+bool exact_value(const T& value) noexcept
+{
+  typedef decltype(E() + T()) common;
+  return static_cast<common>(static_cast<E>(value)) == static_cast<common>(value);
+}
+
+#if MYSTL_SIMD_SSE2
+
+// 128 位的比较
+// cmp 得到每个元素全为 1 或全为 0 的比较结果，mask 把它转换为字节掩码，any / all 合并两个比较结果，
+// count 把比较结果以元素的宽度累加到计数器上（全为 1 即 -1，所以用减法），每个计数器最多累加 count_block 次
+template <class T> struct sse_lane;
+
+struct sse_int_lane
+{
+  typedef __m128i vec;
+  static vec load(const void* p) noexcept
+  { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+  static vec any(vec a, vec b) noexcept { return _mm_or_si128(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm_and_si128(a, b); }
+  static unsigned mask(vec c) noexcept { return static_cast<unsigned>(_mm_movemask_epi8(c)); }
+  static __m128i zero() noexcept { return _mm_setzero_si128(); }
+};
+
+template <>
+struct sse_lane<uint8_t> :public sse_int_lane
+{
+  enum { count_block = 255 };
+  static vec set1(uint8_t v) noexcept { return _mm_set1_epi8(static_cast<char>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm_cmpeq_epi8(a, b); }
+  static __m128i count(__m128i acc, vec c) noexcept { return _mm_sub_epi8(acc, c); }
+};
+
+template <>
+struct sse_lane<uint16_t> :public sse_int_lane
+{
+  enum { count_block = 65535 };
+  static vec set1(uint16_t v) noexcept { return _mm_set1_epi16(static_cast<short>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm_cmpeq_epi16(a, b); }
+  static __m128i count(__m128i acc, vec c) noexcept { return _mm_sub_epi16(acc, c); }
+};
+
+template <>
+struct sse_lane<uint32_t> :public sse_int_lane
+{
+  enum { count_block = 0x7fffffff };
+  static vec set1(uint32_t v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm_cmpeq_epi32(a, b); }
+  static __m128i count(__m128i acc, vec c) noexcept { return _mm_sub_epi32(acc, c); }
+};
+
+// SSE2 没有 64 位整数的比较，两个 32 位的一半都相等时才相等
+template <>
+struct sse_lane<uint64_t> :public sse_int_lane
+{
+  enum { count_block = 0x7fffffff };
+  static vec set1(uint64_t v) noexcept
+  {
+    return _mm_set_epi32(static_cast<int>(v >> 32), static_cast<int>(v),
+                         static_cast<int>(v >> 32), static_cast<int>(v));
+  }
+  static vec cmp(vec a, vec b) noexcept
+  {
+    const __m128i t = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+  static __m128i count(__m128i acc, vec c) noexcept { return _mm_sub_epi64(acc, c); }
+};
+
+template <>
+struct sse_lane<float>
+{
+  typedef __m128 vec;
+  enum { count_block = 0x7fffffff };
+  static vec load(const void* p) noexcept { return _mm_loadu_ps(static_cast<const float*>(p)); }
+  static vec set1(float v) noexcept { return _mm_set1_ps(v); }
+  static vec cmp(vec a, vec b) noexcept { return _mm_cmpeq_ps(a, b); }
+  static vec any(vec a, vec b) noexcept { return _mm_or_ps(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm_and_ps(a, b); }
+  static unsigned mask(vec c) noexcept
+  { return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(c))); }
+  static __m128i zero() noexcept { return _mm_setzero_si128(); }
+  static __m128i count(__m128i acc, vec c) noexcept
+  { return _mm_sub_epi32(acc, _mm_castps_si128(c)); }
+};
+
+template <>
+struct sse_lane<double>
+{
+  typedef __m128d vec;
+  enum { count_block = 0x7fffffff };
+  static vec load(const void* p) noexcept { return _mm_loadu_pd(static_cast<const double*>(p)); }
+  static vec set1(double v) noexcept { return _mm_set1_pd(v); }
+  static vec cmp(vec a, vec b) noexcept { return _mm_cmpeq_pd(a, b); }
+  static vec any(vec a, vec b) noexcept { return _mm_or_pd(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm_and_pd(a, b); }
+  static unsigned mask(vec c) noexcept
+  { return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(c))); }
+  static __m128i zero() noexcept { return _mm_setzero_si128(); }
+  static __m128i count(__m128i acc, vec c) noexcept
+  { return _mm_sub_epi64(acc, _mm_castpd_si128(c)); }
+};
+
+#endif // MYSTL_SIMD_SSE2
+
+#if MYSTL_SIMD_AVX2
+
+// 256 位的比较，接口同 sse_lane
+template <class T> struct avx_lane;
+
+struct avx_int_lane
+{
+  typedef __m256i vec;
+  static vec load(const void* p) noexcept
+  { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+  static vec any(vec a, vec b) noexcept { return _mm256_or_si256(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm256_and_si256(a, b); }
+  static unsigned mask(vec c) noexcept { return static_cast<unsigned>(_mm256_movemask_epi8(c)); }
+  static __m256i zero() noexcept { return _mm256_setzero_si256(); }
+};
+
+template <>
+struct avx_lane<uint8_t> :public avx_int_lane
+{
+  enum { count_block = 255 };
+  static vec set1(uint8_t v) noexcept { return _mm256_set1_epi8(static_cast<char>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+  static __m256i count(__m256i acc, vec c) noexcept { return _mm256_sub_epi8(acc, c); }
+};
+
+template <>
+struct avx_lane<uint16_t> :public avx_int_lane
+{
+  enum { count_block = 65535 };
+  static vec set1(uint16_t v) noexcept { return _mm256_set1_epi16(static_cast<short>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+  static __m256i count(__m256i acc, vec c) noexcept { return _mm256_sub_epi16(acc, c); }
+};
+
+template <>
+struct avx_lane<uint32_t> :public avx_int_lane
+{
+  enum { count_block = 0x7fffffff };
+  static vec set1(uint32_t v) noexcept { return _mm256_set1_epi32(static_cast<int>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+  static __m256i count(__m256i acc, vec c) noexcept { return _mm256_sub_epi32(acc, c); }
+};
+
+template <>
+struct avx_lane<uint64_t> :public avx_int_lane
+{
+  enum { count_block = 0x7fffffff };
+  static vec set1(uint64_t v) noexcept { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmpeq_epi64(a, b); }
+  static __m256i count(__m256i acc, vec c) noexcept { return _mm256_sub_epi64(acc, c); }
+};
+
+template <>
+struct avx_lane<float>
+{
+  typedef __m256 vec;
+  enum { count_block = 0x7fffffff };
+  static vec load(const void* p) noexcept { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+  static vec set1(float v) noexcept { return _mm256_set1_ps(v); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static vec any(vec a, vec b) noexcept { return _mm256_or_ps(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm256_and_ps(a, b); }
+  static unsigned mask(vec c) noexcept
+  { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(c))); }
+  static __m256i zero() noexcept { return _mm256_setzero_si256(); }
+  static __m256i count(__m256i acc, vec c) noexcept
+  { return _mm256_sub_epi32(acc, _mm256_castps_si256(c)); }
+};
+
+template <>
+struct avx_lane<double>
+{
+  typedef __m256d vec;
+  enum { count_block = 0x7fffffff };
+  static vec load(const void* p) noexcept { return _mm256_loadu_pd(static_cast<const double*>(p)); }
+  static vec set1(double v) noexcept { return _mm256_set1_pd(v); }
+  static vec cmp(vec a, vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+  static vec any(vec a, vec b) noexcept { return _mm256_or_pd(a, b); }
+  static vec all(vec a, vec b) noexcept { return _mm256_and_pd(a, b); }
+  static unsigned mask(vec c) noexcept
+  { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(c))); }
+  static __m256i zero() noexcept { return _mm256_setzero_si256(); }
+  static __m256i count(__m256i acc, vec c) noexcept
+  { return _mm256_sub_epi64(acc, _mm256_castpd_si256(c)); }
+};
+
+#endif // MYSTL_SIMD_AVX2
+
+// 以下的 *_vec 从下标 i 开始以向量 L 处理，找到时返回 true 并把元素的下标存入 i，
+// 否则 i 停在剩下不足一个向量的位置，由调用者逐个处理
+// 先每次检查四个向量，发现目标后再逐个向量定位；元素以 L 中的指令读取，不会以 cmp_type 的类型访问
+
+template <class L, class E, class U>
+bool find_elem_vec(const E* p, size_t n, U value, size_t& i) noexcept
+{
+  const size_t k = sizeof(typename L::vec) / sizeof(E);
+  const typename L::vec v = L::set1(value);
+  for (; i + 4 * k <= n; i += 4 * k)
+  {
+    const typename L::vec c0 = L::cmp(L::load(p + i), v);
+    const typename L::vec c1 = L::cmp(L::load(p + i + k), v);
+    const typename L::vec c2 = L::cmp(L::load(p + i + 2 * k), v);
+    const typename L::vec c3 = L::cmp(L::load(p + i + 3 * k), v);
+    if (L::mask(L::any(L::any(c0, c1), L::any(c2, c3))) != 0)
+      break;
+  }
+  for (; i + k <= n; i += k)
+  {
+    const unsigned mask = L::mask(L::cmp(L::load(p + i), v));
+    if (mask != 0)
+    {
+      i += lowest_bit(mask) / sizeof(E);
+      return true;
+    }
+  }
+  return false;
+}
+
+// 返回已处理部分中等于 value 的元素个数
+template <class L, class E, class U>
+size_t count_elem_vec(const E* p, size_t n, U value, size_t& i) noexcept
+{
+  typedef typename uint_of_size<sizeof(E)>::type counter;
+  typedef decltype(L::zero()) ivec;
+  const size_t k = sizeof(typename L::vec) / sizeof(E);
+  const typename L::vec v = L::set1(value);
+  size_t result = 0;
+  while (i + k <= n)
+  {
+    size_t blocks = (n - i) / k;
+    if (blocks > static_cast<size_t>(L::count_block))
+      blocks = static_cast<size_t>(L::count_block);
+    ivec acc = L::zero();
+    for (; blocks != 0; --blocks, i += k)
+      acc = L::count(acc, L::cmp(L::load(p + i), v));
+    counter lanes[sizeof(ivec) / sizeof(counter)];
+    std::memcpy(lanes, &acc, sizeof(acc));
+    for (size_t j = 0; j < sizeof(ivec) / sizeof(counter); ++j)
+      result += lanes[j];
+  }
+  return result;
+}
+
+template <class L, class E>
+bool mismatch_vec(const E* a, const E* b, size_t n, size_t& i) noexcept
+{
+  const size_t k = sizeof(typename L::vec) / sizeof(E);
+  const unsigned full = static_cast<unsigned>((uint64_t(1) << sizeof(typename L::vec)) - 1);
+  for (; i + 4 * k <= n; i += 4 * k)
+  {
+    const typename L::vec c0 = L::cmp(L::load(a + i), L::load(b + i));
+    const typename L::vec c1 = L::cmp(L::load(a + i + k), L::load(b + i + k));
+    const typename L::vec c2 = L::cmp(L::load(a + i + 2 * k), L::load(b + i + 2 * k));
+    const typename L::vec c3 = L::cmp(L::load(a + i + 3 * k), L::load(b + i + 3 * k));
+    if (L::mask(L::all(L::all(c0, c1), L::all(c2, c3))) != full)
+      break;
+  }
+  for (; i + k <= n; i += k)
+  {
+    const unsigned mask = L::mask(L::cmp(L::load(a + i), L::load(b + i))) ^ full;
+    if (mask != 0)
+    {
+      i += lowest_bit(mask) / sizeof(E);
+      return true;
+    }
+  }
+  return false;
+}
+
+// 比较 p[i] 与 p[i + 1]，需要多读一个元素
+template <class L, class E>
+bool adjacent_eq_vec(const E* p, size_t n, size_t& i) noexcept
+{
+  const size_t k = sizeof(typename L::vec) / sizeof(E);
+  for (; i + 4 * k < n; i += 4 * k)
+  {
+    const typename L::vec c0 = L::cmp(L::load(p + i), L::load(p + i + 1));
+    const typename L::vec c1 = L::cmp(L::load(p + i + k), L::load(p + i + k + 1));
+    const typename L::vec c2 = L::cmp(L::load(p + i + 2 * k), L::load(p + i + 2 * k + 1));
+    const typename L::vec c3 = L::cmp(L::load(p + i + 3 * k), L::load(p + i + 3 * k + 1));
+    if (L::mask(L::any(L::any(c0, c1), L::any(c2, c3))) != 0)
+      break;
+  }
+  for (; i + k < n; i += k)
+  {
+    const unsigned mask = L::mask(L::cmp(L::load(p + i), L::load(p + i + 1)));
+    if (mask != 0)
+    {
+      i += lowest_bit(mask) / sizeof(E);
+      return true;
+    }
+  }
+  return false;
+}
+
+// 以下函数的元素类型 E 满足 cmp_type<E>::type 不为 void
+
+// 第一个等于 value 的元素的下标，找不到返回 n
+template <class E>
+size_t find_elem(const E* p, size_t n, E value, std::false_type) noexcept
+{
+#if MYSTL_SIMD_SSE2
+  typedef typename cmp_type<E>::type U;
+#endif
+  size_t i = 0;
+#if MYSTL_SIMD_AVX2
+  if (find_elem_vec<avx_lane<U>>(p, n, static_cast<U>(value), i))
+    return i;
+#endif
+#if MYSTL_SIMD_SSE2
+  if (find_elem_vec<sse_lane<U>>(p, n, static_cast<U>(value), i))
+    return i;
+#endif
+  for (; i < n; ++i)
+  {
+    if (p[i] == value)
+      return i;
+  }
+  return n;
+}
+
+// 单字节使用 find_char
+template <class E>
+size_t find_elem(const E* p, size_t n, E value, std::true_type) noexcept
+{
+  const char* first = reinterpret_cast<const char*>(p);
+  return static_cast<size_t>(find_char(first, first + n, static_cast<char>(value)) - first);
+}
+
+template <class E>
+size_t find_elem(const E* p, size_t n, E value) noexcept
+{
+  return find_elem(p, n, value, std::integral_constant<bool, sizeof(E) == 1>());
+}
+
+// 等于 value 的元素的个数
+template <class E>
+size_t count_elem(const E* p, size_t n, E value) noexcept
+{
+#if MYSTL_SIMD_SSE2
+  typedef typename cmp_type<E>::type U;
+#endif
+  size_t i = 0;
+  size_t result = 0;
+#if MYSTL_SIMD_AVX2
+  result += count_elem_vec<avx_lane<U>>(p, n, static_cast<U>(value), i);
+#endif
+#if MYSTL_SIMD_SSE2
+  result += count_elem_vec<sse_lane<U>>(p, n, static_cast<U>(value), i);
+#endif
+  for (; i < n; ++i)
+  {
+    if (p[i] == value)
+      ++result;
+  }
+  return result;
+}
+
+// 第一个 a[i] == b[i] 不成立的下标，都相等时返回 n
+template <class E>
+size_t mismatch(const E* a, const E* b, size_t n) noexcept
+{
+#if MYSTL_SIMD_SSE2
+  typedef typename cmp_type<E>::type U;
+#endif
+  size_t i = 0;
+#if MYSTL_SIMD_AVX2
+  if (mismatch_vec<avx_lane<U>>(a, b, n, i))
+    return i;
+#endif
+#if MYSTL_SIMD_SSE2
+  if (mismatch_vec<sse_lane<U>>(a, b, n, i))
+    return i;
+#endif
+  for (; i < n; ++i)
+  {
+    if (!(a[i] == b[i]))
+      return i;
+  }
+  return n;
+}
+
+// [a, a + n) 与 [b, b + n) 是否相等，整数使用 memcmp
+template <class E>
+bool equal_elems(const E* a, const E* b, size_t n, std::true_type) noexcept
+{
+  return n == 0 || std::memcmp(a, b, n * sizeof(E)) == 0;
+}
+
+template <class E>
+bool equal_elems(const E* a, const E* b, size_t n, std::false_type) noexcept
+{
+  return mismatch(a, b, n) == n;
+}
+
+template <class E>
+bool equal_elems(const E* a, const E* b, size_t n) noexcept
+{
+  return equal_elems(a, b, n, std::is_integral<E>());
+}
+
+// 第一个满足 p[i] == p[i + 1] 的下标，找不到返回 n
+template <class E>
+size_t adjacent_eq(const E* p, size_t n) noexcept
+{
+#if MYSTL_SIMD_SSE2
+  typedef typename cmp_type<E>::type U;
+#endif
+  if (n < 2)
+    return n;
+  size_t i = 0;
+#if MYSTL_SIMD_AVX2
+  if (adjacent_eq_vec<avx_lane<U>>(p, n, i))
+    return i;
+#endif
+#if MYSTL_SIMD_SSE2
+  if (adjacent_eq_vec<sse_lane<U>>(p, n, i))
+    return i;
+#endif
+  for (; i + 1 < n; ++i)
+  {
+    if (p[i] == p[i + 1])
+      return i;
+  }
+  return n;
+}
+
+/*****************************************************************************************/
+// 有序集合的交集
+// 元素为 bool 以外的 4 字节整数，两个序列都严格递增
+
+// Iter1 与 Iter2 是指向同一种 4 字节整数的指针，OutputIter 是指向它的可写指针
+template <class Iter1, class Iter2, class OutputIter>
+struct is_intersect_range :public std::false_type {};
+
+template <class T, class U, class E>
+struct is_intersect_range<T*, U*, E*>
+  :public std::integral_constant<bool,
+    std::is_same<typename std::remove_const<T>::type, E>::value &&
+    std::is_same<typename std::remove_const<U>::type, E>::value &&
+    std::is_integral<E>::value && !std::is_same<E, bool>::value && sizeof(E) == 4>
+{
+};
+
+// 把 [a, a + na) 与 [b, b + nb) 的交集写入 out，返回写入的个数
+// 每次比较 a 的 4 个元素与 b 的 4 个元素的所有组合，再前进最大元素较小的一方
+template <class E>
+size_t intersect_unique(const E* a, size_t na, const E* b, size_t nb, E* out) noexcept
+{
+  size_t i = 0, j = 0, k = 0;
+#if MYSTL_SIMD_SSE2
+  while (i + 4 <= na && j + 4 <= nb)
+  {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+    const __m128i m0 = _mm_cmpeq_epi32(va, vb);
+    const __m128i m1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+    const __m128i m2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+    const __m128i m3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(
+      _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3)))));
+    while (mask != 0)
+    {
+      out[k++] = a[i + lowest_bit(mask)];
+      mask &= mask - 1;
+    }
+    const E amax = a[i + 3];
+    const E bmax = b[j + 3];
+    i += amax <= bmax ? 4 : 0;
+    j += bmax <= amax ? 4 : 0;
+  }
+#endif
+  while (i < na && j < nb)
+  {
+    if (a[i] < b[j])
+    {
+      ++i;
+    }
+    else if (b[j] < a[i])
+    {
+      ++j;
+    }
+    else
+    {
+      out[k++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+  return k;
+}
+
+} // namespace simd
+} // namespace mystl
+#endif // !MYTINYSTL_SIMD_H_
+
@@ -0,0 +1,1016 @@
+﻿#ifndef MYTINYSTL_SIMD_NUMERIC_H_
+#define MYTINYSTL_SIMD_NUMERIC_H_
+
+// 这个头文件包含 numeric.h 使用的数值内核：求和、点积、前缀和与相邻差
+// 元素类型为 32 / 64 位整数、float 或 double，区间是连续的数组
+
+// notes:
+//
+// 1. x86 上不依赖编译选项，运行时检测 CPU 是否支持 AVX2 并选择 AVX2 版本，以 -mavx2 编译时不再检测；
+//    AArch64 上使用 NEON 版本；其余情况使用多个累加器的标量版本，定义 MYSTL_NO_SIMD 时也使用标量版本
+// 2. sum、dot、prefix_sum 会改变加法的结合顺序，整数按 2^n 取模运算，结果与顺序相加相同，
+//    浮点数的结果可能有舍入误差，numeric.h 只在允许重新结合的算法（reduce、transform_reduce、inclusive_scan）
+//    中对浮点数使用它们
+// 3. adjacent_difference 从后往前计算，允许 out == in
+
+#include <cstddef>
+#include <cstdint>
+
+#include "type_traits.h"
+
+#if !defined(MYSTL_NO_SIMD)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define MYSTL_SIMD_AVX2_DISPATCH 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define MYSTL_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif // !MYSTL_NO_SIMD
+
+// 使函数可以使用 AVX2 指令，MSVC 不需要
+#if MYSTL_SIMD_AVX2_DISPATCH
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MYSTL_TARGET_AVX2
+#endif
+#endif
+
+namespace mystl
+{
+namespace simd
+{
+
+/*****************************************************************************************/
+// 类型分类
+
+enum numeric_kind_type { nk_none, nk_int32, nk_int64, nk_float, nk_double };
+
+template <class T>
+struct numeric_kind :public std::integral_constant<int,
+  std::is_same<T, float>::value  ? nk_float  :
+  std::is_same<T, double>::value ? nk_double :
+  !std::is_integral<T>::value || std::is_same<T, bool>::value ? nk_none :
+  sizeof(T) == 4 ? nk_int32 :
+  sizeof(T) == 8 ? nk_int64 : nk_none>
+{
+};
+
+// Iter 是指向 T 的指针且 T 有对应的内核
+template <class Iter, class T>
+struct is_numeric_range :public m_false_type {};
+
+template <class U, class T>
+struct is_numeric_range<U*, T>
+  :public m_bool_constant<std::is_same<typename std::remove_cv<U>::type, T>::value &&
+                          numeric_kind<T>::value != nk_none>
+{
+};
+
+// 同上，并且 T 是整数，重新结合不改变结果
+template <class Iter, class T>
+struct is_integer_range
+  :public m_bool_constant<is_numeric_range<Iter, T>::value &&
+                          std::is_integral<T>::value>
+{
+};
+
+/*****************************************************************************************/
+// CPU 特性检测
+
+inline bool M_detect_avx2() noexcept
+{
+#if MYSTL_SIMD_AVX2_DISPATCH && defined(__AVX2__)
+  return true;
+#elif MYSTL_SIMD_AVX2_DISPATCH && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#elif MYSTL_SIMD_AVX2_DISPATCH
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)  // 操作系统保存 ymm 寄存器
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+// 结果只检测一次
+inline bool cpu_has_avx2() noexcept
+{
+  static const bool result = M_detect_avx2();
+  return result;
+}
+
+/*****************************************************************************************/
+// 标量版本，也用于处理向量化版本剩下的尾部
+// 整数以对应的无符号类型运算，溢出时按 2^n 取模
+
+template <class T>
+struct arith_type
+{
+  typedef typename std::conditional<std::is_integral<T>::value,
+    typename std::make_unsigned<typename std::conditional<std::is_integral<T>::value,
+                                                          T, int>::type>::type,
+    T>::type type;
+};
+
+template <class T>
+T sum_scalar(const T* p, size_t n) noexcept
+{
+  typedef typename arith_type<T>::type A;
+  A s0 = A(), s1 = A(), s2 = A(), s3 = A();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    s0 += static_cast<A>(p[i]);
+    s1 += static_cast<A>(p[i + 1]);
+    s2 += static_cast<A>(p[i + 2]);
+    s3 += static_cast<A>(p[i + 3]);
+  }
+  for (; i < n; ++i)
+    s0 += static_cast<A>(p[i]);
+  return static_cast<T>((s0 + s1) + (s2 + s3));
+}
+
+template <class T>
+T dot_scalar(const T* a, const T* b, size_t n) noexcept
+{
+  typedef typename arith_type<T>::type A;
+  A s0 = A(), s1 = A(), s2 = A(), s3 = A();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    s0 += static_cast<A>(a[i]) * static_cast<A>(b[i]);
+    s1 += static_cast<A>(a[i + 1]) * static_cast<A>(b[i + 1]);
+    s2 += static_cast<A>(a[i + 2]) * static_cast<A>(b[i + 2]);
+    s3 += static_cast<A>(a[i + 3]) * static_cast<A>(b[i + 3]);
+  }
+  for (; i < n; ++i)
+    s0 += static_cast<A>(a[i]) * static_cast<A>(b[i]);
+  return static_cast<T>((s0 + s1) + (s2 + s3));
+}
+
+// out[i] = carry + in[0] + ... + in[i]，允许 out == in
+template <class T>
+void prefix_sum_scalar(const T* in, T* out, size_t n, T carry) noexcept
+{
+  typedef typename arith_type<T>::type A;
+  A s = static_cast<A>(carry);
+  for (size_t i = 0; i < n; ++i)
+  {
+    s += static_cast<A>(in[i]);
+    out[i] = static_cast<T>(s);
+  }
+}
+
+// 对 [1, n) 计算 out[i] = in[i] - in[i - 1]，从后往前，允许 out == in
+template <class T>
+void adjacent_difference_scalar(const T* in, T* out, size_t n) noexcept
+{
+  typedef typename arith_type<T>::type A;
+  for (size_t i = n; i > 1; --i)
+    out[i - 1] = static_cast<T>(static_cast<A>(in[i - 1]) - static_cast<A>(in[i - 2]));
+}
+
+/*****************************************************************************************/
+// AVX2 版本，处理整块，返回已处理的元素个数或部分结果，尾部由调用者用标量版本处理
+
+#if MYSTL_SIMD_AVX2_DISPATCH
+
+MYSTL_TARGET_AVX2
+inline uint32_t hsum_epi32(__m256i v) noexcept
+{
+  __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(x));
+}
+
+MYSTL_TARGET_AVX2
+inline uint64_t hsum_epi64(__m256i v) noexcept
+{
+  __m128i x = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  x = _mm_add_epi64(x, _mm_unpackhi_epi64(x, x));
+  uint64_t r;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&r), x);
+  return r;
+}
+
+MYSTL_TARGET_AVX2
+inline float hsum_ps(__m256 v) noexcept
+{
+  __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_add_ss(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(x);
+}
+
+MYSTL_TARGET_AVX2
+inline double hsum_pd(__m256d v) noexcept
+{
+  __m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  x = _mm_add_sd(x, _mm_unpackhi_pd(x, x));
+  return _mm_cvtsd_f64(x);
+}
+
+// 求和：四个累加器，每次处理四个向量
+
+MYSTL_TARGET_AVX2
+inline uint32_t sum_epi32_avx2(const void* data, size_t n, size_t& done) noexcept
+{
+  const __m256i* p = static_cast<const __m256i*>(data);
+  __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32, p += 4)
+  {
+    s0 = _mm256_add_epi32(s0, _mm256_loadu_si256(p));
+    s1 = _mm256_add_epi32(s1, _mm256_loadu_si256(p + 1));
+    s2 = _mm256_add_epi32(s2, _mm256_loadu_si256(p + 2));
+    s3 = _mm256_add_epi32(s3, _mm256_loadu_si256(p + 3));
+  }
+  for (; i + 8 <= n; i += 8, ++p)
+    s0 = _mm256_add_epi32(s0, _mm256_loadu_si256(p));
+  done = i;
+  return hsum_epi32(_mm256_add_epi32(_mm256_add_epi32(s0, s1), _mm256_add_epi32(s2, s3)));
+}
+
+MYSTL_TARGET_AVX2
+inline uint64_t sum_epi64_avx2(const void* data, size_t n, size_t& done) noexcept
+{
+  const __m256i* p = static_cast<const __m256i*>(data);
+  __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16, p += 4)
+  {
+    s0 = _mm256_add_epi64(s0, _mm256_loadu_si256(p));
+    s1 = _mm256_add_epi64(s1, _mm256_loadu_si256(p + 1));
+    s2 = _mm256_add_epi64(s2, _mm256_loadu_si256(p + 2));
+    s3 = _mm256_add_epi64(s3, _mm256_loadu_si256(p + 3));
+  }
+  for (; i + 4 <= n; i += 4, ++p)
+    s0 = _mm256_add_epi64(s0, _mm256_loadu_si256(p));
+  done = i;
+  return hsum_epi64(_mm256_add_epi64(_mm256_add_epi64(s0, s1), _mm256_add_epi64(s2, s3)));
+}
+
+MYSTL_TARGET_AVX2
+inline float sum_ps_avx2(const float* p, size_t n, size_t& done) noexcept
+{
+  __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    s0 = _mm256_add_ps(s0, _mm256_loadu_ps(p + i));
+    s1 = _mm256_add_ps(s1, _mm256_loadu_ps(p + i + 8));
+    s2 = _mm256_add_ps(s2, _mm256_loadu_ps(p + i + 16));
+    s3 = _mm256_add_ps(s3, _mm256_loadu_ps(p + i + 24));
+  }
+  for (; i + 8 <= n; i += 8)
+    s0 = _mm256_add_ps(s0, _mm256_loadu_ps(p + i));
+  done = i;
+  return hsum_ps(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+}
+
+MYSTL_TARGET_AVX2
+inline double sum_pd_avx2(const double* p, size_t n, size_t& done) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    s0 = _mm256_add_pd(s0, _mm256_loadu_pd(p + i));
+    s1 = _mm256_add_pd(s1, _mm256_loadu_pd(p + i + 4));
+    s2 = _mm256_add_pd(s2, _mm256_loadu_pd(p + i + 8));
+    s3 = _mm256_add_pd(s3, _mm256_loadu_pd(p + i + 12));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = _mm256_add_pd(s0, _mm256_loadu_pd(p + i));
+  done = i;
+  return hsum_pd(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+}
+
+// 点积：AVX2 没有 64 位整数乘法，64 位整数使用标量版本
+
+MYSTL_TARGET_AVX2
+inline uint32_t dot_epi32_avx2(const void* a, const void* b, size_t n, size_t& done) noexcept
+{
+  const __m256i* pa = static_cast<const __m256i*>(a);
+  const __m256i* pb = static_cast<const __m256i*>(b);
+  __m256i s0 = _mm256_setzero_si256(), s1 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16, pa += 2, pb += 2)
+  {
+    s0 = _mm256_add_epi32(s0, _mm256_mullo_epi32(_mm256_loadu_si256(pa),
+                                                  _mm256_loadu_si256(pb)));
+    s1 = _mm256_add_epi32(s1, _mm256_mullo_epi32(_mm256_loadu_si256(pa + 1),
+                                                  _mm256_loadu_si256(pb + 1)));
+  }
+  for (; i + 8 <= n; i += 8, ++pa, ++pb)
+    s0 = _mm256_add_epi32(s0, _mm256_mullo_epi32(_mm256_loadu_si256(pa), _mm256_loadu_si256(pb)));
+  done = i;
+  return hsum_epi32(_mm256_add_epi32(s0, s1));
+}
+
+MYSTL_TARGET_AVX2
+inline float dot_ps_avx2(const float* a, const float* b, size_t n, size_t& done) noexcept
+{
+  __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    s1 = _mm256_add_ps(s1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    s2 = _mm256_add_ps(s2, _mm256_mul_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16)));
+    s3 = _mm256_add_ps(s3, _mm256_mul_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24)));
+  }
+  for (; i + 8 <= n; i += 8)
+    s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  done = i;
+  return hsum_ps(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+}
+
+MYSTL_TARGET_AVX2
+inline double dot_pd_avx2(const double* a, const double* b, size_t n, size_t& done) noexcept
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+    s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8)));
+    s3 = _mm256_add_pd(s3, _mm256_mul_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12)));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  done = i;
+  return hsum_pd(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+}
+
+// 前缀和：先在每个 128 位通道内移位相加，再把低通道的和加到高通道，最后加上之前的累计值
+
+MYSTL_TARGET_AVX2
+inline uint32_t prefix_sum_epi32_avx2(const void* in, void* out, size_t n, uint32_t carry,
+                                      size_t& done) noexcept
+{
+  const __m256i* p = static_cast<const __m256i*>(in);
+  __m256i* q = static_cast<__m256i*>(out);
+  __m256i c = _mm256_set1_epi32(static_cast<int>(carry));
+  const __m256i last = _mm256_set1_epi32(7);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8, ++p, ++q)
+  {
+    __m256i x = _mm256_loadu_si256(p);
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    __m256i t = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+    x = _mm256_add_epi32(x, _mm256_permute2x128_si256(t, t, 0x08));
+    x = _mm256_add_epi32(x, c);
+    _mm256_storeu_si256(q, x);
+    c = _mm256_permutevar8x32_epi32(x, last);
+  }
+  done = i;
+  return static_cast<uint32_t>(_mm256_cvtsi256_si32(c));
+}
+
+MYSTL_TARGET_AVX2
+inline uint64_t prefix_sum_epi64_avx2(const void* in, void* out, size_t n, uint64_t carry,
+                                      size_t& done) noexcept
+{
+  const __m256i* p = static_cast<const __m256i*>(in);
+  __m256i* q = static_cast<__m256i*>(out);
+  __m256i c = _mm256_set1_epi64x(static_cast<long long>(carry));
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4, ++p, ++q)
+  {
+    __m256i x = _mm256_loadu_si256(p);
+    x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+    __m256i t = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0));
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(t, zero, 0x0f));
+    x = _mm256_add_epi64(x, c);
+    _mm256_storeu_si256(q, x);
+    c = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  done = i;
+  uint64_t r;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&r), _mm256_castsi256_si128(c));
+  return r;
+}
+
+MYSTL_TARGET_AVX2
+inline float prefix_sum_ps_avx2(const float* in, float* out, size_t n, float carry,
+                                size_t& done) noexcept
+{
+  __m256 c = _mm256_set1_ps(carry);
+  const __m256i last = _mm256_set1_epi32(7);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256 x = _mm256_loadu_ps(in + i);
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    __m256 t = _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3));
+    x = _mm256_add_ps(x, _mm256_permute2f128_ps(t, t, 0x08));
+    x = _mm256_add_ps(x, c);
+    _mm256_storeu_ps(out + i, x);
+    c = _mm256_permutevar8x32_ps(x, last);
+  }
+  done = i;
+  return _mm256_cvtss_f32(c);
+}
+
+MYSTL_TARGET_AVX2
+inline double prefix_sum_pd_avx2(const double* in, double* out, size_t n, double carry,
+                                 size_t& done) noexcept
+{
+  __m256d c = _mm256_set1_pd(carry);
+  const __m256d zero = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256d x = _mm256_loadu_pd(in + i);
+    x = _mm256_add_pd(x, _mm256_castsi256_pd(_mm256_slli_si256(_mm256_castpd_si256(x), 8)));
+    __m256d t = _mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 1, 0, 0));
+    x = _mm256_add_pd(x, _mm256_blend_pd(t, zero, 0x3));
+    x = _mm256_add_pd(x, c);
+    _mm256_storeu_pd(out + i, x);
+    c = _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  done = i;
+  return _mm_cvtsd_f64(_mm256_castpd256_pd128(c));
+}
+
+// 相邻差：从后往前每次处理一个向量，返回尚未处理的前缀长度
+
+MYSTL_TARGET_AVX2
+inline size_t adjacent_difference_epi32_avx2(const void* in, void* out, size_t n) noexcept
+{
+  const int32_t* p = static_cast<const int32_t*>(in);
+  int32_t* q = static_cast<int32_t*>(out);
+  size_t i = n;
+  for (; i >= 9; i -= 8)
+  {
+    const __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i - 8));
+    const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i - 9));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(q + i - 8), _mm256_sub_epi32(cur, prev));
+  }
+  return i;
+}
+
+MYSTL_TARGET_AVX2
+inline size_t adjacent_difference_epi64_avx2(const void* in, void* out, size_t n) noexcept
+{
+  const int64_t* p = static_cast<const int64_t*>(in);
+  int64_t* q = static_cast<int64_t*>(out);
+  size_t i = n;
+  for (; i >= 5; i -= 4)
+  {
+    const __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i - 4));
+    const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i - 5));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(q + i - 4), _mm256_sub_epi64(cur, prev));
+  }
+  return i;
+}
+
+MYSTL_TARGET_AVX2
+inline size_t adjacent_difference_ps_avx2(const float* p, float* q, size_t n) noexcept
+{
+  size_t i = n;
+  for (; i >= 9; i -= 8)
+    _mm256_storeu_ps(q + i - 8, _mm256_sub_ps(_mm256_loadu_ps(p + i - 8), _mm256_loadu_ps(p + i - 9)));
+  return i;
+}
+
+MYSTL_TARGET_AVX2
+inline size_t adjacent_difference_pd_avx2(const double* p, double* q, size_t n) noexcept
+{
+  size_t i = n;
+  for (; i >= 5; i -= 4)
+    _mm256_storeu_pd(q + i - 4, _mm256_sub_pd(_mm256_loadu_pd(p + i - 4), _mm256_loadu_pd(p + i - 5)));
+  return i;
+}
+
+#endif // MYSTL_SIMD_AVX2_DISPATCH
+
+/*****************************************************************************************/
+// NEON 版本，接口与 AVX2 版本相同
+
+#if MYSTL_SIMD_NEON
+
+inline uint32_t sum_epi32_neon(const void* data, size_t n, size_t& done) noexcept
+{
+  const uint32_t* p = static_cast<const uint32_t*>(data);
+  uint32x4_t s0 = vdupq_n_u32(0), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    s0 = vaddq_u32(s0, vld1q_u32(p + i));
+    s1 = vaddq_u32(s1, vld1q_u32(p + i + 4));
+    s2 = vaddq_u32(s2, vld1q_u32(p + i + 8));
+    s3 = vaddq_u32(s3, vld1q_u32(p + i + 12));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = vaddq_u32(s0, vld1q_u32(p + i));
+  done = i;
+  return vaddvq_u32(vaddq_u32(vaddq_u32(s0, s1), vaddq_u32(s2, s3)));
+}
+
+inline uint64_t sum_epi64_neon(const void* data, size_t n, size_t& done) noexcept
+{
+  const uint64_t* p = static_cast<const uint64_t*>(data);
+  uint64x2_t s0 = vdupq_n_u64(0), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    s0 = vaddq_u64(s0, vld1q_u64(p + i));
+    s1 = vaddq_u64(s1, vld1q_u64(p + i + 2));
+    s2 = vaddq_u64(s2, vld1q_u64(p + i + 4));
+    s3 = vaddq_u64(s3, vld1q_u64(p + i + 6));
+  }
+  for (; i + 2 <= n; i += 2)
+    s0 = vaddq_u64(s0, vld1q_u64(p + i));
+  done = i;
+  return vaddvq_u64(vaddq_u64(vaddq_u64(s0, s1), vaddq_u64(s2, s3)));
+}
+
+inline float sum_ps_neon(const float* p, size_t n, size_t& done) noexcept
+{
+  float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    s0 = vaddq_f32(s0, vld1q_f32(p + i));
+    s1 = vaddq_f32(s1, vld1q_f32(p + i + 4));
+    s2 = vaddq_f32(s2, vld1q_f32(p + i + 8));
+    s3 = vaddq_f32(s3, vld1q_f32(p + i + 12));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = vaddq_f32(s0, vld1q_f32(p + i));
+  done = i;
+  return vaddvq_f32(vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+}
+
+inline double sum_pd_neon(const double* p, size_t n, size_t& done) noexcept
+{
+  float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    s0 = vaddq_f64(s0, vld1q_f64(p + i));
+    s1 = vaddq_f64(s1, vld1q_f64(p + i + 2));
+    s2 = vaddq_f64(s2, vld1q_f64(p + i + 4));
+    s3 = vaddq_f64(s3, vld1q_f64(p + i + 6));
+  }
+  for (; i + 2 <= n; i += 2)
+    s0 = vaddq_f64(s0, vld1q_f64(p + i));
+  done = i;
+  return vaddvq_f64(vaddq_f64(vaddq_f64(s0, s1), vaddq_f64(s2, s3)));
+}
+
+inline uint32_t dot_epi32_neon(const void* a, const void* b, size_t n, size_t& done) noexcept
+{
+  const uint32_t* pa = static_cast<const uint32_t*>(a);
+  const uint32_t* pb = static_cast<const uint32_t*>(b);
+  uint32x4_t s0 = vdupq_n_u32(0), s1 = s0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    s0 = vmlaq_u32(s0, vld1q_u32(pa + i), vld1q_u32(pb + i));
+    s1 = vmlaq_u32(s1, vld1q_u32(pa + i + 4), vld1q_u32(pb + i + 4));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = vmlaq_u32(s0, vld1q_u32(pa + i), vld1q_u32(pb + i));
+  done = i;
+  return vaddvq_u32(vaddq_u32(s0, s1));
+}
+
+inline float dot_ps_neon(const float* a, const float* b, size_t n, size_t& done) noexcept
+{
+  float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    s0 = vaddq_f32(s0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    s1 = vaddq_f32(s1, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    s2 = vaddq_f32(s2, vmulq_f32(vld1q_f32(a + i + 8), vld1q_f32(b + i + 8)));
+    s3 = vaddq_f32(s3, vmulq_f32(vld1q_f32(a + i + 12), vld1q_f32(b + i + 12)));
+  }
+  for (; i + 4 <= n; i += 4)
+    s0 = vaddq_f32(s0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+  done = i;
+  return vaddvq_f32(vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+}
+
+inline double dot_pd_neon(const double* a, const double* b, size_t n, size_t& done) noexcept
+{
+  float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    s0 = vaddq_f64(s0, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    s1 = vaddq_f64(s1, vmulq_f64(vld1q_f64(a + i + 2), vld1q_f64(b + i + 2)));
+    s2 = vaddq_f64(s2, vmulq_f64(vld1q_f64(a + i + 4), vld1q_f64(b + i + 4)));
+    s3 = vaddq_f64(s3, vmulq_f64(vld1q_f64(a + i + 6), vld1q_f64(b + i + 6)));
+  }
+  for (; i + 2 <= n; i += 2)
+    s0 = vaddq_f64(s0, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+  done = i;
+  return vaddvq_f64(vaddq_f64(vaddq_f64(s0, s1), vaddq_f64(s2, s3)));
+}
+
+// 前缀和：向量内两次移位相加，再加上之前的累计值
+
+inline uint32_t prefix_sum_epi32_neon(const void* in, void* out, size_t n, uint32_t carry,
+                                      size_t& done) noexcept
+{
+  const uint32_t* p = static_cast<const uint32_t*>(in);
+  uint32_t* q = static_cast<uint32_t*>(out);
+  const uint32x4_t zero = vdupq_n_u32(0);
+  uint32x4_t c = vdupq_n_u32(carry);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    uint32x4_t x = vld1q_u32(p + i);
+    x = vaddq_u32(x, vextq_u32(zero, x, 3));
+    x = vaddq_u32(x, vextq_u32(zero, x, 2));
+    x = vaddq_u32(x, c);
+    vst1q_u32(q + i, x);
+    c = vdupq_laneq_u32(x, 3);
+  }
+  done = i;
+  return vgetq_lane_u32(c, 0);
+}
+
+inline uint64_t prefix_sum_epi64_neon(const void* in, void* out, size_t n, uint64_t carry,
+                                      size_t& done) noexcept
+{
+  const uint64_t* p = static_cast<const uint64_t*>(in);
+  uint64_t* q = static_cast<uint64_t*>(out);
+  const uint64x2_t zero = vdupq_n_u64(0);
+  uint64x2_t c = vdupq_n_u64(carry);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    uint64x2_t x = vld1q_u64(p + i);
+    x = vaddq_u64(x, vextq_u64(zero, x, 1));
+    x = vaddq_u64(x, c);
+    vst1q_u64(q + i, x);
+    c = vdupq_laneq_u64(x, 1);
+  }
+  done = i;
+  return vgetq_lane_u64(c, 0);
+}
+
+inline float prefix_sum_ps_neon(const float* in, float* out, size_t n, float carry,
+                                size_t& done) noexcept
+{
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  float32x4_t c = vdupq_n_f32(carry);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    float32x4_t x = vld1q_f32(in + i);
+    x = vaddq_f32(x, vextq_f32(zero, x, 3));
+    x = vaddq_f32(x, vextq_f32(zero, x, 2));
+    x = vaddq_f32(x, c);
+    vst1q_f32(out + i, x);
+    c = vdupq_laneq_f32(x, 3);
+  }
+  done = i;
+  return vgetq_lane_f32(c, 0);
+}
+
+inline double prefix_sum_pd_neon(const double* in, double* out, size_t n, double carry,
+                                 size_t& done) noexcept
+{
+  const float64x2_t zero = vdupq_n_f64(0.0);
+  float64x2_t c = vdupq_n_f64(carry);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    float64x2_t x = vld1q_f64(in + i);
+    x = vaddq_f64(x, vextq_f64(zero, x, 1));
+    x = vaddq_f64(x, c);
+    vst1q_f64(out + i, x);
+    c = vdupq_laneq_f64(x, 1);
+  }
+  done = i;
+  return vgetq_lane_f64(c, 0);
+}
+
+inline size_t adjacent_difference_epi32_neon(const void* in, void* out, size_t n) noexcept
+{
+  const uint32_t* p = static_cast<const uint32_t*>(in);
+  uint32_t* q = static_cast<uint32_t*>(out);
+  size_t i = n;
+  for (; i >= 5; i -= 4)
+    vst1q_u32(q + i - 4, vsubq_u32(vld1q_u32(p + i - 4), vld1q_u32(p + i - 5)));
+  return i;
+}
+
+inline size_t adjacent_difference_epi64_neon(const void* in, void* out, size_t n) noexcept
+{
+  const uint64_t* p = static_cast<const uint64_t*>(in);
+  uint64_t* q = static_cast<uint64_t*>(out);
+  size_t i = n;
+  for (; i >= 3; i -= 2)
+    vst1q_u64(q + i - 2, vsubq_u64(vld1q_u64(p + i - 2), vld1q_u64(p + i - 3)));
+  return i;
+}
+
+inline size_t adjacent_difference_ps_neon(const float* p, float* q, size_t n) noexcept
+{
+  size_t i = n;
+  for (; i >= 5; i -= 4)
+    vst1q_f32(q + i - 4, vsubq_f32(vld1q_f32(p + i - 4), vld1q_f32(p + i - 5)));
+  return i;
+}
+
+inline size_t adjacent_difference_pd_neon(const double* p, double* q, size_t n) noexcept
+{
+  size_t i = n;
+  for (; i >= 3; i -= 2)
+    vst1q_f64(q + i - 2, vsubq_f64(vld1q_f64(p + i - 2), vld1q_f64(p + i - 3)));
+  return i;
+}
+
+#endif // MYSTL_SIMD_NEON
+
+/*****************************************************************************************/
+// 按元素类型选择内核
+// 向量化版本处理整块后，尾部交给标量版本
+
+// 以 simd_call 调用名为 name##_epi32 / _epi64 / _ps / _pd 的 AVX2 或 NEON 版本
+#if MYSTL_SIMD_AVX2_DISPATCH
+#define MYSTL_SIMD_KERNEL(name) name##_avx2
+#define MYSTL_SIMD_ENABLED()    mystl::simd::cpu_has_avx2()
+#elif MYSTL_SIMD_NEON
+#define MYSTL_SIMD_KERNEL(name) name##_neon
+#define MYSTL_SIMD_ENABLED()    true
+#endif
+
+typedef std::integral_constant<int, nk_int32>  int32_tag;
+typedef std::integral_constant<int, nk_int64>  int64_tag;
+typedef std::integral_constant<int, nk_float>  float_tag;
+typedef std::integral_constant<int, nk_double> double_tag;
+
+// sum
+
+template <class T>
+T M_sum(const T* p, size_t n, int32_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const uint32_t s = MYSTL_SIMD_KERNEL(sum_epi32)(p, n, done);
+    return static_cast<T>(s + static_cast<uint32_t>(sum_scalar(p + done, n - done)));
+  }
+#endif
+  return sum_scalar(p, n);
+}
+
+template <class T>
+T M_sum(const T* p, size_t n, int64_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const uint64_t s = MYSTL_SIMD_KERNEL(sum_epi64)(p, n, done);
+    return static_cast<T>(s + static_cast<uint64_t>(sum_scalar(p + done, n - done)));
+  }
+#endif
+  return sum_scalar(p, n);
+}
+
+inline float M_sum(const float* p, size_t n, float_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const float s = MYSTL_SIMD_KERNEL(sum_ps)(p, n, done);
+    return s + sum_scalar(p + done, n - done);
+  }
+#endif
+  return sum_scalar(p, n);
+}
+
+inline double M_sum(const double* p, size_t n, double_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const double s = MYSTL_SIMD_KERNEL(sum_pd)(p, n, done);
+    return s + sum_scalar(p + done, n - done);
+  }
+#endif
+  return sum_scalar(p, n);
+}
+
+// dot
+
+template <class T>
+T M_dot(const T* a, const T* b, size_t n, int32_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const uint32_t s = MYSTL_SIMD_KERNEL(dot_epi32)(a, b, n, done);
+    return static_cast<T>(s + static_cast<uint32_t>(dot_scalar(a + done, b + done, n - done)));
+  }
+#endif
+  return dot_scalar(a, b, n);
+}
+
+template <class T>
+T M_dot(const T* a, const T* b, size_t n, int64_tag) noexcept
+{
+  return dot_scalar(a, b, n);
+}
+
+inline float M_dot(const float* a, const float* b, size_t n, float_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const float s = MYSTL_SIMD_KERNEL(dot_ps)(a, b, n, done);
+    return s + dot_scalar(a + done, b + done, n - done);
+  }
+#endif
+  return dot_scalar(a, b, n);
+}
+
+inline double M_dot(const double* a, const double* b, size_t n, double_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const double s = MYSTL_SIMD_KERNEL(dot_pd)(a, b, n, done);
+    return s + dot_scalar(a + done, b + done, n - done);
+  }
+#endif
+  return dot_scalar(a, b, n);
+}
+
+// prefix_sum
+
+template <class T>
+void M_prefix_sum(const T* in, T* out, size_t n, T carry, int32_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const uint32_t c = MYSTL_SIMD_KERNEL(prefix_sum_epi32)(in, out, n, static_cast<uint32_t>(carry), done);
+    prefix_sum_scalar(in + done, out + done, n - done, static_cast<T>(c));
+    return;
+  }
+#endif
+  prefix_sum_scalar(in, out, n, carry);
+}
+
+template <class T>
+void M_prefix_sum(const T* in, T* out, size_t n, T carry, int64_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const uint64_t c = MYSTL_SIMD_KERNEL(prefix_sum_epi64)(in, out, n, static_cast<uint64_t>(carry), done);
+    prefix_sum_scalar(in + done, out + done, n - done, static_cast<T>(c));
+    return;
+  }
+#endif
+  prefix_sum_scalar(in, out, n, carry);
+}
+
+inline void M_prefix_sum(const float* in, float* out, size_t n, float carry, float_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const float c = MYSTL_SIMD_KERNEL(prefix_sum_ps)(in, out, n, carry, done);
+    prefix_sum_scalar(in + done, out + done, n - done, c);
+    return;
+  }
+#endif
+  prefix_sum_scalar(in, out, n, carry);
+}
+
+inline void M_prefix_sum(const double* in, double* out, size_t n, double carry, double_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+  {
+    size_t done = 0;
+    const double c = MYSTL_SIMD_KERNEL(prefix_sum_pd)(in, out, n, carry, done);
+    prefix_sum_scalar(in + done, out + done, n - done, c);
+    return;
+  }
+#endif
+  prefix_sum_scalar(in, out, n, carry);
+}
+
+// adjacent_difference
+
+template <class T>
+void M_adjacent_difference(const T* in, T* out, size_t n, int32_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+    n = MYSTL_SIMD_KERNEL(adjacent_difference_epi32)(in, out, n);
+#endif
+  adjacent_difference_scalar(in, out, n);
+}
+
+template <class T>
+void M_adjacent_difference(const T* in, T* out, size_t n, int64_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+    n = MYSTL_SIMD_KERNEL(adjacent_difference_epi64)(in, out, n);
+#endif
+  adjacent_difference_scalar(in, out, n);
+}
+
+inline void M_adjacent_difference(const float* in, float* out, size_t n, float_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+    n = MYSTL_SIMD_KERNEL(adjacent_difference_ps)(in, out, n);
+#endif
+  adjacent_difference_scalar(in, out, n);
+}
+
+inline void M_adjacent_difference(const double* in, double* out, size_t n, double_tag) noexcept
+{
+#ifdef MYSTL_SIMD_KERNEL
+  if (MYSTL_SIMD_ENABLED())
+    n = MYSTL_SIMD_KERNEL(adjacent_difference_pd)(in, out, n);
+#endif
+  adjacent_difference_scalar(in, out, n);
+}
+
+#undef MYSTL_SIMD_KERNEL
+#undef MYSTL_SIMD_ENABLED
+
+/*****************************************************************************************/
+// 接口
+
+// [p, p + n) 的和
+template <class T>
+T sum(const T* p, size_t n) noexcept
+{
+  return M_sum(p, n, numeric_kind<T>());
+}
+
+// [a, a + n) 与 [b, b + n) 的点积
+template <class T>
+T dot(const T* a, const T* b, size_t n) noexcept
+{
+  return M_dot(a, b, n, numeric_kind<T>());
+}
+
+// out[i] = carry + in[0] + ... + in[i]，允许 out == in
+template <class T>
+void prefix_sum(const T* in, T* out, size_t n, T carry) noexcept
+{
+  M_prefix_sum(in, out, n, carry, numeric_kind<T>());
+}
+
+// out[0] = in[0]，out[i] = in[i] - in[i - 1]，允许 out == in
+template <class T>
+void adjacent_difference(const T* in, T* out, size_t n) noexcept
+{
+  if (n == 0)
+    return;
+  M_adjacent_difference(in, out, n, numeric_kind<T>());
+  out[0] = in[0];
+}
+
+} // namespace simd
+} // namespace mystl
+#endif // !MYTINYSTL_SIMD_NUMERIC_H_
+
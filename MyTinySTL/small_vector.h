@@ -0,0 +1,1128 @@
+﻿#ifndef MYTINYSTL_SMALL_VECTOR_H_
+#define MYTINYSTL_SMALL_VECTOR_H_
+
+// 这个头文件包含两个模板类 small_vector 和 static_vector
+// small_vector  : 带有内置缓冲区的向量，不超过 N 个元素时放在对象内部，超过后转移到堆上
+// static_vector : 固定容量的向量，元素放在对象内部，从不分配内存
+
+// notes:
+//
+// 1. 两者的接口与 mystl::vector 相同，迭代器为原生指针
+// 2. small_vector 没有 vector 的最小容量 16，元素转移到堆上之后按 1.5 倍增长，
+//    shrink_to_fit 在元素个数不超过 N 时把元素搬回内置缓冲区
+// 3. 元素在对象内部时，移动构造、移动赋值与 swap 需要逐个移动元素，且会使迭代器失效
+// 4. static_vector 的元素个数超过 N 时抛出 length_error
+//
+// 异常保证：
+// mystl::small_vector<T, N> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * emplace_back
+//   * push_back
+//   * reserve
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "algo.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 模板类 small_vector
+// 模板参数 T 代表类型，N 代表内置缓冲区能容纳的元素个数，Alloc 代表分配器类型，缺省使用 mystl::allocator
+template <class T, size_t N, class Alloc = mystl::allocator<T>>
+class small_vector
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+  static_assert(N > 0, "the inline capacity of small_vector should be greater than 0");
+
+public:
+  // small_vector 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef value_type*                              iterator;
+  typedef const value_type*                        const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+
+  // 元素能否按字节搬移，决定扩容时移动元素的方式
+  typedef mystl::alloc_can_relocate<data_allocator, T> relocate_type;
+
+  iterator     begin_;   // 表示目前使用空间的头部
+  iterator     end_;     // 表示目前使用空间的尾部
+  iterator     cap_;     // 表示目前储存空间的尾部
+  storage_type buf_[N];  // 内置缓冲区
+
+public:
+  // 构造、复制、移动、析构函数
+  small_vector() noexcept
+  { reset_inline(); }
+
+  explicit small_vector(const allocator_type& alloc) noexcept
+    :alloc_base(data_allocator(alloc))
+  { reset_inline(); }
+
+  explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
+  {
+    reset_inline();
+    fill_init(n, value_type());
+  }
+
+  small_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
+  {
+    reset_inline();
+    fill_init(n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
+  {
+    reset_inline();
+    range_init(first, last);
+  }
+
+  small_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
+  {
+    reset_inline();
+    range_init(ilist.begin(), ilist.end());
+  }
+
+  small_vector(const small_vector& rhs)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc()))
+  {
+    reset_inline();
+    range_init(rhs.begin_, rhs.end_);
+  }
+
+  small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+    :alloc_base(mystl::move(rhs.M_alloc()))
+  {
+    reset_inline();
+    take_from(rhs);
+  }
+
+  small_vector& operator=(const small_vector& rhs)
+  {
+    if (this != &rhs)
+      assign(rhs.begin_, rhs.end_);
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& rhs);
+
+  small_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~small_vector()
+  {
+    data_traits::destroy(M_alloc(), begin_, end_);
+    free_storage();
+  }
+
+public:
+
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return begin_; }
+  const_iterator         begin()   const noexcept
+  { return begin_; }
+  iterator               end()           noexcept
+  { return end_; }
+  const_iterator         end()     const noexcept
+  { return end_; }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return begin_ == end_; }
+  size_type size()     const noexcept
+  { return static_cast<size_type>(end_ - begin_); }
+  size_type max_size() const noexcept
+  { return data_traits::max_size(M_alloc()); }
+  size_type capacity() const noexcept
+  { return static_cast<size_type>(cap_ - begin_); }
+  void      reserve(size_type n);
+  void      shrink_to_fit();
+
+  // 元素是否在内置缓冲区中
+  bool      is_inline() const noexcept
+  { return begin_ == inline_begin(); }
+  static constexpr size_type inline_capacity() noexcept
+  { return N; }
+
+  // 访问元素相关操作
+  reference operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+  reference at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()       { MYSTL_DEBUG(!empty()); return *begin_; }
+  const_reference front() const { MYSTL_DEBUG(!empty()); return *begin_; }
+  reference       back()        { MYSTL_DEBUG(!empty()); return *(end_ - 1); }
+  const_reference back()  const { MYSTL_DEBUG(!empty()); return *(end_ - 1); }
+
+  pointer       data()       noexcept { return begin_; }
+  const_pointer data() const noexcept { return begin_; }
+
+  // 修改容器相关操作
+
+  // assign
+
+  void assign(size_type n, const value_type& value)
+  {
+    const value_type value_copy = value;  // value 可能引用容器中的元素
+    clear();
+    insert(end(), n, value_copy);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    clear();
+    insert(end(), first, last);
+  }
+
+  void assign(std::initializer_list<value_type> ilist)
+  { assign(ilist.begin(), ilist.end()); }
+
+  // emplace / emplace_back
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&& ...args);
+
+  template <class... Args>
+  void emplace_back(Args&& ...args)
+  {
+    if (end_ != cap_)
+    {
+      data_traits::construct(M_alloc(), end_, mystl::forward<Args>(args)...);
+      ++end_;
+    }
+    else
+    {
+      reallocate_emplace(end_, mystl::forward<Args>(args)...);
+    }
+  }
+
+  // push_back / pop_back
+
+  void push_back(const value_type& value)
+  { emplace_back(value); }
+  void push_back(value_type&& value)
+  { emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --end_;
+    data_traits::destroy(M_alloc(), end_);
+  }
+
+  // insert
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return emplace(pos, value); }
+  iterator insert(const_iterator pos, value_type&& value)
+  { return emplace(pos, mystl::move(value)); }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return copy_insert(pos - begin_, first, last, iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  { return insert(pos, ilist.begin(), ilist.end()); }
+
+  // erase / clear
+  iterator erase(const_iterator pos)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last);
+  void     clear() noexcept
+  {
+    data_traits::destroy(M_alloc(), begin_, end_);
+    end_ = begin_;
+  }
+
+  // resize
+  void     resize(size_type new_size)
+  { resize(new_size, value_type()); }
+  void     resize(size_type new_size, const value_type& value)
+  {
+    if (new_size < size())
+      erase(begin_ + new_size, end_);
+    else
+      insert(end_, new_size - size(), value);
+  }
+
+  // swap
+  void     swap(small_vector& rhs);
+
+private:
+  // helper functions
+
+  pointer   inline_begin() const noexcept
+  { return const_cast<pointer>(reinterpret_cast<const T*>(buf_)); }
+
+  void      reset_inline() noexcept
+  {
+    begin_ = end_ = inline_begin();
+    cap_ = begin_ + N;
+  }
+
+  // 释放堆上的空间，元素已经析构或搬走
+  void      free_storage() noexcept
+  {
+    if (!is_inline())
+      data_traits::deallocate(M_alloc(), begin_, capacity());
+  }
+
+  void      fill_init(size_type n, const value_type& value);
+  template <class Iter>
+  void      range_init(Iter first, Iter last);
+  void      take_from(small_vector& rhs);
+
+  size_type get_new_cap(size_type add_size) const;
+
+  // relocate
+  pointer   relocate_to(pointer new_begin, iterator pos, pointer gap, m_true_type) noexcept;
+  pointer   relocate_to(pointer new_begin, iterator pos, pointer gap, m_false_type);
+  void      relocate_around(iterator pos, size_type n, pointer new_begin, size_type new_cap);
+
+  template <class... Args>
+  void      reallocate_emplace(iterator pos, Args&& ...args);
+
+  template <class IIter>
+  iterator  copy_insert(size_type offset, IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  iterator  copy_insert(size_type offset, FIter first, FIter last, forward_iterator_tag);
+};
+
+/*****************************************************************************************/
+
+// 移动赋值操作符
+// rhs 的元素在堆上且分配器相等时接管它的空间，否则逐个移动元素
+template <class T, size_t N, class Alloc>
+small_vector<T, N, Alloc>&
+small_vector<T, N, Alloc>::operator=(small_vector&& rhs)
+{
+  if (this != &rhs)
+  {
+    clear();
+    if (!rhs.is_inline() && data_traits::equal(M_alloc(), rhs.M_alloc()))
+    {
+      free_storage();
+      reset_inline();
+    }
+    take_from(rhs);
+  }
+  return *this;
+}
+
+// 预留空间大小，当原容量小于要求大小时，才会重新分配
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reserve(size_type n)
+{
+  if (capacity() < n)
+  {
+    THROW_LENGTH_ERROR_IF(n > max_size(),
+                          "n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+    auto tmp = data_traits::allocate(M_alloc(), n);
+    relocate_around(end_, 0, tmp, n);
+  }
+}
+
+// 放弃多余的容量，元素个数不超过 N 时搬回内置缓冲区
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit()
+{
+  if (is_inline() || end_ == cap_)
+    return;
+  if (size() <= N)
+  {
+    const auto old_begin = begin_;
+    const auto old_cap = capacity();
+    end_ = relocate_to(inline_begin(), end_, inline_begin() + size(), relocate_type());
+    begin_ = inline_begin();
+    cap_ = begin_ + N;
+    data_traits::deallocate(M_alloc(), old_begin, old_cap);
+  }
+  else
+  {
+    auto tmp = data_traits::allocate(M_alloc(), size());
+    relocate_around(end_, 0, tmp, size());
+  }
+}
+
+// 在 pos 位置就地构造元素
+template <class T, size_t N, class Alloc>
+template <class ...Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&& ...args)
+{
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  iterator xpos = const_cast<iterator>(pos);
+  const size_type n = xpos - begin_;
+  if (end_ == cap_)
+  {
+    reallocate_emplace(xpos, mystl::forward<Args>(args)...);
+  }
+  else if (xpos == end_)
+  {
+    data_traits::construct(M_alloc(), end_, mystl::forward<Args>(args)...);
+    ++end_;
+  }
+  else
+  {
+    value_type tmp(mystl::forward<Args>(args)...);  // 参数可能引用容器中的元素，先构造出来
+    data_traits::construct(M_alloc(), end_, mystl::move(*(end_ - 1)));
+    ++end_;
+    mystl::move_backward(xpos, end_ - 2, end_ - 1);
+    *xpos = mystl::move(tmp);
+  }
+  return begin_ + n;
+}
+
+// 在 pos 处插入 n 个 value
+// 先在尾部构造，再旋转到 pos 处
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  const size_type offset = pos - begin_;
+  if (n == 0)
+    return begin_ + offset;
+  const value_type value_copy = value;  // value 可能引用容器中的元素
+  if (static_cast<size_type>(cap_ - end_) < n)
+    reserve(get_new_cap(n));
+  const auto old_end = end_;
+  end_ = mystl::uninitialized_fill_n_a(end_, n, value_copy, M_alloc());
+  mystl::rotate(begin_ + offset, old_end, end_);
+  return begin_ + offset;
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = const_cast<iterator>(first);
+  if (first != last)
+  {
+    auto new_end = mystl::move(const_cast<iterator>(last), end_, xfirst);
+    data_traits::destroy(M_alloc(), new_end, end_);
+    end_ = new_end;
+  }
+  return xfirst;
+}
+
+// 与另一个 small_vector 交换
+// 两者都在堆上时交换指针，否则逐个移动元素
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs)
+{
+  if (this == &rhs)
+    return;
+  if (!is_inline() && !rhs.is_inline())
+  {
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(cap_, rhs.cap_);
+    return;
+  }
+  small_vector tmp(mystl::move(rhs));
+  rhs = mystl::move(*this);
+  *this = mystl::move(tmp);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// fill_init 函数
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::fill_init(size_type n, const value_type& value)
+{
+  if (n > N)
+  {
+    begin_ = end_ = data_traits::allocate(M_alloc(), n);
+    cap_ = begin_ + n;
+  }
+  try
+  {
+    end_ = mystl::uninitialized_fill_n_a(begin_, n, value, M_alloc());
+  }
+  catch (...)
+  {
+    free_storage();
+    throw;
+  }
+}
+
+// range_init 函数
+template <class T, size_t N, class Alloc>
+template <class Iter>
+void small_vector<T, N, Alloc>::range_init(Iter first, Iter last)
+{
+  try
+  {
+    insert(end_, first, last);
+  }
+  catch (...)
+  {
+    clear();
+    free_storage();
+    throw;
+  }
+}
+
+// take_from 函数
+// 本容器为空且使用内置缓冲区，接管 rhs 的堆空间，或者逐个移动 rhs 的元素，rhs 变为空
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::take_from(small_vector& rhs)
+{
+  if (!rhs.is_inline() && is_inline() && data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    cap_ = rhs.cap_;
+    rhs.reset_inline();
+    return;
+  }
+  reserve(rhs.size());
+  end_ = mystl::uninitialized_move_a(rhs.begin_, rhs.end_, begin_, M_alloc());
+  rhs.clear();
+}
+
+// get_new_cap 函数
+// 按 1.5 倍增长，没有最小容量
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::get_new_cap(size_type add_size) const
+{
+  const auto old_size = capacity();
+  THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
+                        "small_vector<T, N>'s size too big");
+  if (old_size > max_size() - old_size / 2)
+    return old_size + add_size;
+  return mystl::max(old_size + old_size / 2, size() + add_size);
+}
+
+// relocate_to 函数
+// 把 [begin_, pos) 搬移到 new_begin 处，[pos, end_) 搬移到 gap 处，返回最后一个元素的下一位置
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::pointer
+small_vector<T, N, Alloc>::
+relocate_to(pointer new_begin, iterator pos, pointer gap, m_true_type) noexcept
+{
+  mystl::uninitialized_relocate(begin_, pos, new_begin);
+  return mystl::uninitialized_relocate(pos, end_, gap);
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::pointer
+small_vector<T, N, Alloc>::
+relocate_to(pointer new_begin, iterator pos, pointer gap, m_false_type)
+{
+  auto mid = mystl::uninitialized_move_a(begin_, pos, new_begin, M_alloc());
+  pointer new_end = gap;
+  try
+  {
+    new_end = mystl::uninitialized_move_a(pos, end_, gap, M_alloc());
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), new_begin, mid);
+    throw;
+  }
+  data_traits::destroy(M_alloc(), begin_, end_);
+  return new_end;
+}
+
+// relocate_around 函数
+// 新空间中 pos 对应位置起的 n 个元素已由调用者构造，把原有元素搬移到它们两侧，再换用新空间
+// 搬移失败时析构这 n 个元素并释放新空间，容器保持不变
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::
+relocate_around(iterator pos, size_type n, pointer new_begin, size_type new_cap)
+{
+  const auto gap = new_begin + (pos - begin_);
+  auto new_end = gap;
+  try
+  {
+    new_end = relocate_to(new_begin, pos, gap + n, relocate_type());
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), gap, gap + n);
+    data_traits::deallocate(M_alloc(), new_begin, new_cap);
+    throw;
+  }
+  free_storage();
+  begin_ = new_begin;
+  end_ = new_end;
+  cap_ = new_begin + new_cap;
+}
+
+// 重新分配空间并在 pos 处就地构造元素
+template <class T, size_t N, class Alloc>
+template <class ...Args>
+void small_vector<T, N, Alloc>::
+reallocate_emplace(iterator pos, Args&& ...args)
+{
+  const auto new_cap = get_new_cap(1);
+  auto new_begin = data_traits::allocate(M_alloc(), new_cap);
+  try
+  { // 先构造新元素，参数可能引用容器中的元素
+    data_traits::construct(M_alloc(), new_begin + (pos - begin_), mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_traits::deallocate(M_alloc(), new_begin, new_cap);
+    throw;
+  }
+  relocate_around(pos, 1, new_begin, new_cap);
+}
+
+// copy_insert 函数
+// 先在尾部逐个构造，再旋转到 offset 处
+template <class T, size_t N, class Alloc>
+template <class IIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::
+copy_insert(size_type offset, IIter first, IIter last, input_iterator_tag)
+{
+  const size_type old_size = size();
+  for (; first != last; ++first)
+    emplace_back(*first);
+  mystl::rotate(begin_ + offset, begin_ + old_size, end_);
+  return begin_ + offset;
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::
+copy_insert(size_type offset, FIter first, FIter last, forward_iterator_tag)
+{
+  const size_type n = mystl::distance(first, last);
+  if (n == 0)
+    return begin_ + offset;
+  if (static_cast<size_type>(cap_ - end_) < n)
+    reserve(get_new_cap(n));
+  const auto old_end = end_;
+  end_ = mystl::uninitialized_copy_a(first, last, end_, M_alloc());
+  mystl::rotate(begin_ + offset, old_end, end_);
+  return begin_ + offset;
+}
+
+// 重载比较操作符
+
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 static_vector
+// 模板参数 T 代表类型，N 代表容量
+template <class T, size_t N>
+class static_vector
+{
+  static_assert(N > 0, "the capacity of static_vector should be greater than 0");
+
+public:
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef value_type*                              iterator;
+  typedef const value_type*                        const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+
+  storage_type buf_[N];
+  size_type    size_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  static_vector() noexcept
+    :size_(0) {}
+
+  explicit static_vector(size_type n)
+    :size_(0)
+  { insert(end(), n, value_type()); }
+
+  static_vector(size_type n, const value_type& value)
+    :size_(0)
+  { insert(end(), n, value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  static_vector(Iter first, Iter last)
+    :size_(0)
+  { range_init(first, last); }
+
+  static_vector(std::initializer_list<value_type> ilist)
+    :size_(0)
+  { range_init(ilist.begin(), ilist.end()); }
+
+  static_vector(const static_vector& rhs)
+    :size_(0)
+  { range_init(rhs.begin(), rhs.end()); }
+
+  static_vector(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+    :size_(0)
+  {
+    mystl::uninitialized_move(rhs.begin(), rhs.end(), begin());
+    size_ = rhs.size_;
+    rhs.clear();
+  }
+
+  static_vector& operator=(const static_vector& rhs)
+  {
+    if (this != &rhs)
+      assign(rhs.begin(), rhs.end());
+    return *this;
+  }
+
+  static_vector& operator=(static_vector&& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      mystl::uninitialized_move(rhs.begin(), rhs.end(), begin());
+      size_ = rhs.size_;
+      rhs.clear();
+    }
+    return *this;
+  }
+
+  static_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~static_vector()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept
+  { return base(); }
+  const_iterator         begin()   const noexcept
+  { return base(); }
+  iterator               end()           noexcept
+  { return base() + size_; }
+  const_iterator         end()     const noexcept
+  { return base() + size_; }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return size_ == 0; }
+  bool      full()     const noexcept { return size_ == N; }
+  size_type size()     const noexcept { return size_; }
+  static constexpr size_type capacity() noexcept { return N; }
+  static constexpr size_type max_size() noexcept { return N; }
+
+  void      reserve(size_type n)
+  { THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N>::reserve(n) n is larger than N"); }
+  void      shrink_to_fit() noexcept {}
+
+  // 访问元素相关操作
+
+  reference       operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return base()[n];
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return base()[n];
+  }
+
+  reference       at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()       { MYSTL_DEBUG(!empty()); return base()[0]; }
+  const_reference front() const { MYSTL_DEBUG(!empty()); return base()[0]; }
+  reference       back()        { MYSTL_DEBUG(!empty()); return base()[size_ - 1]; }
+  const_reference back()  const { MYSTL_DEBUG(!empty()); return base()[size_ - 1]; }
+
+  pointer       data()       noexcept { return base(); }
+  const_pointer data() const noexcept { return base(); }
+
+  // 修改容器相关操作，超过容量时抛出 length_error
+
+  void assign(size_type n, const value_type& value)
+  {
+    THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N> is full");
+    const value_type value_copy = value;
+    clear();
+    insert(end(), n, value_copy);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    clear();
+    insert(end(), first, last);
+  }
+
+  void assign(std::initializer_list<value_type> ilist)
+  { assign(ilist.begin(), ilist.end()); }
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&& ...args)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+    iterator xpos = const_cast<iterator>(pos);
+    if (xpos == end())
+    {
+      mystl::construct(xpos, mystl::forward<Args>(args)...);
+      ++size_;
+    }
+    else
+    {
+      value_type tmp(mystl::forward<Args>(args)...);
+      mystl::construct(end(), mystl::move(back()));
+      ++size_;
+      mystl::move_backward(xpos, end() - 2, end() - 1);
+      *xpos = mystl::move(tmp);
+    }
+    return xpos;
+  }
+
+  template <class... Args>
+  void emplace_back(Args&& ...args)
+  {
+    THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+    mystl::construct(end(), mystl::forward<Args>(args)...);
+    ++size_;
+  }
+
+  void push_back(const value_type& value) { emplace_back(value); }
+  void push_back(value_type&& value)      { emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --size_;
+    mystl::destroy(end());
+  }
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return emplace(pos, value); }
+  iterator insert(const_iterator pos, value_type&& value)
+  { return emplace(pos, mystl::move(value)); }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    THROW_LENGTH_ERROR_IF(n > N - size_, "static_vector<T, N> is full");
+    const size_type offset = pos - begin();
+    const value_type value_copy = value;
+    mystl::uninitialized_fill_n(end(), n, value_copy);
+    size_ += n;
+    mystl::rotate(begin() + offset, end() - n, end());
+    return begin() + offset;
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    const size_type offset = pos - begin();
+    const size_type old_size = size_;
+    try
+    {
+      for (; first != last; ++first)
+        emplace_back(*first);
+    }
+    catch (...)
+    {
+      erase(begin() + old_size, end());
+      throw;
+    }
+    mystl::rotate(begin() + offset, begin() + old_size, end());
+    return begin() + offset;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  { return insert(pos, ilist.begin(), ilist.end()); }
+
+  iterator erase(const_iterator pos)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator xfirst = const_cast<iterator>(first);
+    if (first != last)
+    {
+      auto new_end = mystl::move(const_cast<iterator>(last), end(), xfirst);
+      mystl::destroy(new_end, end());
+      size_ = new_end - begin();
+    }
+    return xfirst;
+  }
+
+  void clear() noexcept
+  {
+    mystl::destroy(begin(), end());
+    size_ = 0;
+  }
+
+  void resize(size_type new_size)
+  { resize(new_size, value_type()); }
+  void resize(size_type new_size, const value_type& value)
+  {
+    if (new_size < size_)
+      erase(begin() + new_size, end());
+    else
+      insert(end(), new_size - size_, value);
+  }
+
+  // 元素在对象内部，只能逐个交换
+  void swap(static_vector& rhs)
+  {
+    if (this != &rhs)
+    {
+      static_vector tmp(mystl::move(rhs));
+      rhs = mystl::move(*this);
+      *this = mystl::move(tmp);
+    }
+  }
+
+private:
+  T* base() const noexcept
+  { return const_cast<T*>(reinterpret_cast<const T*>(buf_)); }
+
+  template <class Iter>
+  void range_init(Iter first, Iter last)
+  {
+    try
+    {
+      for (; first != last; ++first)
+        emplace_back(*first);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+};
+
+// 重载比较操作符
+template <class T, size_t N>
+bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+namespace pmr
+{
+template <class T, size_t N>
+using small_vector = mystl::small_vector<T, N, polymorphic_allocator<T>>;
+} // namespace pmr
+
+} // namespace mystl
+#endif // !MYTINYSTL_SMALL_VECTOR_H_
+
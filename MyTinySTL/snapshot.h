@@ -0,0 +1,1038 @@
+﻿#ifndef MYTINYSTL_SNAPSHOT_H_
+#define MYTINYSTL_SNAPSHOT_H_
+
+// 这个头文件包含容器的二进制快照，以及直接映射快照文件的只读视图
+// save_snapshot / load_snapshot : 把 vector、basic_string、map、flat_map、unordered_map 等
+//                                 写成二进制文件，或从文件重新构造容器
+// mapped_vector                 : 映射 vector 的快照，按下标访问
+// mapped_basic_string           : 映射 basic_string 的快照，可以取得 basic_string_view
+// mapped_flat_map               : 映射有序容器的快照，支持 find / lower_bound / equal_range 等查找
+// mapped_unordered_map          : 映射哈希容器的快照，支持 find / count / equal_range 等查找
+
+// notes:
+//
+// 1. 文件由 snapshot_header 与若干按 64 字节对齐的段组成，段的位置都是相对文件起点的偏移，
+//    不保存任何指针，因此同一个文件可以映射到任意地址，被多个进程共享同一份页缓存
+// 2. 元素按字节写出，键值与实值必须是 trivially copyable 且不能是指针；
+//    字符串作为键值时请先转换为定长的键或编号
+// 3. map、multimap、flat_map、flat_multimap 都写成同一种有序数组的格式，
+//    可以用 load_snapshot 读回其中任意一种容器，也可以用 mapped_flat_map 直接查找
+// 4. 哈希容器写成按桶连续存放的数组，桶的起点单独成段，桶的个数为 2 的幂，
+//    写出与查找都使用容器的哈希函数，因此 mapped_unordered_map 的 Hash 必须与写出时一致，
+//    且哈希值不能依赖进程（mystl::hash 满足这个要求）
+// 5. 文件头记录了版本、字节序、元素的大小与对齐，打开时不匹配会抛出 std::runtime_error，
+//    但无法区分大小相同的不同类型，读写两端请使用相同的模板参数
+// 6. 在 POSIX 与 Windows 上使用 mmap / MapViewOfFile 映射文件，
+//    其余平台或定义了 MYSTL_SNAPSHOT_NO_MMAP 时一次读入整个文件
+// 7. 视图只读，所有迭代器、指针、引用在视图关闭或析构前有效，移动视图不会使它们失效
+// 8. 写出时先写入临时文件再替换，覆盖一个正被映射的快照不会影响已经打开的视图
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(MYSTL_SNAPSHOT_NO_MMAP)
+#if defined(_WIN32)
+#define MYSTL_SNAPSHOT_WIN32 1
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define MYSTL_SNAPSHOT_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif // !MYSTL_SNAPSHOT_NO_MMAP
+
+#include "algo.h"
+#include "astring.h"
+#include "flat_map.h"
+#include "map.h"
+#include "memory.h"
+#include "unordered_map.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// 文件格式
+
+// 快照的种类
+enum snapshot_kind : uint32_t
+{
+  snapshot_sequence = 1,  // vector：元素数组
+  snapshot_string   = 2,  // basic_string：字符数组，末尾多写一个空字符
+  snapshot_sorted   = 3,  // 有序容器：按键值升序排列的 snapshot_pair 数组
+  snapshot_hashed   = 4   // 哈希容器：桶起点数组 + 按桶连续存放的 snapshot_pair 数组
+};
+
+// 文件头，位于文件起点
+struct snapshot_header
+{
+  char     magic[8];      // "MYSTLSNP"
+  uint32_t version;       // 格式版本
+  uint32_t byte_order;    // 以本机字节序写入的 0x01020304
+  uint32_t kind;          // snapshot_kind
+  uint32_t value_size;    // 元素的大小
+  uint32_t value_align;   // 元素的对齐
+  uint32_t bucket_bits;   // 桶个数的对数，仅用于 snapshot_hashed
+  uint64_t size;          // 元素个数
+  uint64_t index_offset;  // 桶起点数组的偏移，共 (1 << bucket_bits) + 1 项，仅用于 snapshot_hashed
+  uint64_t data_offset;   // 元素数组的偏移
+  uint64_t file_size;     // 文件的总长度
+};
+
+static_assert(sizeof(snapshot_header) == 64, "snapshot_header must be 64 bytes");
+
+// 键值对在文件中的形式，布局固定，可以按字节复制
+template <class Key, class T>
+struct snapshot_pair
+{
+  typedef Key first_type;
+  typedef T   second_type;
+
+  Key first;
+  T   second;
+};
+
+namespace snapshot_detail
+{
+
+enum : uint32_t { version = 1, byte_order = 0x01020304u };
+enum : uint64_t { section_align = 64 };
+
+// 写出的元素需要满足的条件
+template <class T>
+struct storable
+{
+  static constexpr bool value = std::is_trivially_copyable<T>::value &&
+                                !std::is_pointer<T>::value &&
+                                alignof(T) <= section_align;
+};
+
+inline uint64_t align_up(uint64_t n) noexcept
+{
+  return (n + section_align - 1) & ~(section_align - 1);
+}
+
+// 哈希值映射到桶：乘法散列取高位，bits 至少为 1
+inline uint64_t bucket_of(size_t code, uint32_t bits) noexcept
+{
+  return (static_cast<uint64_t>(code) * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+}
+
+// 桶个数不少于元素个数
+inline uint32_t bucket_bits_for(uint64_t n) noexcept
+{
+  uint32_t bits = 1;
+  while (bits < 63 && (uint64_t(1) << bits) < n)
+    ++bits;
+  return bits;
+}
+
+inline snapshot_header make_header(snapshot_kind kind, uint32_t value_size, uint32_t value_align,
+                                   uint64_t size) noexcept
+{
+  snapshot_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, "MYSTLSNP", 8);
+  h.version = version;
+  h.byte_order = byte_order;
+  h.kind = kind;
+  h.value_size = value_size;
+  h.value_align = value_align;
+  h.size = size;
+  return h;
+}
+
+} // namespace snapshot_detail
+
+/*****************************************************************************************/
+// snapshot_writer
+// 顺序写出快照文件，记录当前的偏移，出错时抛出 std::runtime_error
+// 内容先写入 path.tmp，close() 时再替换 path：已经映射了旧文件的进程继续看到旧的内容，
+// 而不会因为文件被截断而在访问时收到 SIGBUS；没有调用 close() 时临时文件被删除
+
+class snapshot_writer
+{
+private:
+  mystl::string path_;    // 目标文件
+  mystl::string temp_;    // 正在写入的临时文件
+  std::FILE*    file_;    // 正在写入的文件
+  uint64_t      offset_;  // 已写入的字节数
+
+public:
+  explicit snapshot_writer(const char* path)
+    :path_(path), temp_(path), file_(nullptr), offset_(0)
+  {
+    temp_.append(".tmp");
+    file_ = std::fopen(temp_.c_str(), "wb");
+    THROW_RUNTIME_ERROR_IF(file_ == nullptr, "snapshot_writer: cannot open file");
+  }
+
+  snapshot_writer(const snapshot_writer&) = delete;
+  snapshot_writer& operator=(const snapshot_writer&) = delete;
+
+  ~snapshot_writer()
+  {
+    if (file_ != nullptr)
+    {
+      std::fclose(file_);
+      std::remove(temp_.c_str());
+    }
+  }
+
+  uint64_t offset() const noexcept { return offset_; }
+
+  void write(const void* p, size_t n)
+  {
+    if (n == 0)
+      return;
+    THROW_RUNTIME_ERROR_IF(std::fwrite(p, 1, n, file_) != n, "snapshot_writer: write failed");
+    offset_ += n;
+  }
+
+  // 以 0 填充到 offset
+  void pad_to(uint64_t offset)
+  {
+    static const char zeros[snapshot_detail::section_align] = {};
+    while (offset_ < offset)
+    {
+      const uint64_t n = offset - offset_;
+      write(zeros, static_cast<size_t>(n < sizeof(zeros) ? n : sizeof(zeros)));
+    }
+  }
+
+  // 关闭文件并替换目标文件，失败时删除临时文件并抛出异常
+  void close()
+  {
+    std::FILE* f = file_;
+    file_ = nullptr;
+    bool ok = std::fclose(f) == 0;
+#if defined(MYSTL_SNAPSHOT_WIN32)
+    ok = ok && ::MoveFileExA(temp_.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#elif defined(MYSTL_SNAPSHOT_POSIX)
+    ok = ok && std::rename(temp_.c_str(), path_.c_str()) == 0;
+#else
+    std::remove(path_.c_str());  // 有的平台上 rename 不会覆盖已存在的文件
+    ok = ok && std::rename(temp_.c_str(), path_.c_str()) == 0;
+#endif
+    if (!ok)
+      std::remove(temp_.c_str());
+    THROW_RUNTIME_ERROR_IF(!ok, "snapshot_writer: close failed");
+  }
+};
+
+/*****************************************************************************************/
+// mapped_file
+// 只读地映射整个文件，只能移动，不能复制
+
+class mapped_file
+{
+private:
+  const char* data_;  // 映射的起点
+  size_t      size_;  // 文件长度
+#if defined(MYSTL_SNAPSHOT_WIN32)
+  HANDLE      file_;
+  HANDLE      mapping_;
+#elif !defined(MYSTL_SNAPSHOT_POSIX)
+  char*       buffer_;  // 读入文件的缓冲区，data_ 在其中按 64 字节对齐
+#endif
+
+public:
+  mapped_file() noexcept
+  {
+    reset();
+  }
+
+  explicit mapped_file(const char* path)
+  {
+    reset();
+    open(path);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  mapped_file(mapped_file&& rhs) noexcept
+  {
+    steal(rhs);
+  }
+
+  mapped_file& operator=(mapped_file&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      close();
+      steal(rhs);
+    }
+    return *this;
+  }
+
+  ~mapped_file()
+  {
+    close();
+  }
+
+  const char* data()    const noexcept { return data_; }
+  size_t      size()    const noexcept { return size_; }
+  bool        is_open() const noexcept { return data_ != nullptr; }
+
+  void open(const char* path);
+  void close() noexcept;
+
+private:
+  void reset() noexcept
+  {
+    data_ = nullptr;
+    size_ = 0;
+#if defined(MYSTL_SNAPSHOT_WIN32)
+    file_ = INVALID_HANDLE_VALUE;
+    mapping_ = nullptr;
+#elif !defined(MYSTL_SNAPSHOT_POSIX)
+    buffer_ = nullptr;
+#endif
+  }
+
+  void steal(mapped_file& rhs) noexcept
+  {
+    data_ = rhs.data_;
+    size_ = rhs.size_;
+#if defined(MYSTL_SNAPSHOT_WIN32)
+    file_ = rhs.file_;
+    mapping_ = rhs.mapping_;
+#elif !defined(MYSTL_SNAPSHOT_POSIX)
+    buffer_ = rhs.buffer_;
+#endif
+    rhs.reset();
+  }
+};
+
+#if defined(MYSTL_SNAPSHOT_POSIX)
+
+inline void mapped_file::open(const char* path)
+{
+  close();
+  const int fd = ::open(path, O_RDONLY);
+  THROW_RUNTIME_ERROR_IF(fd < 0, "mapped_file: cannot open file");
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    ::close(fd);
+    THROW_RUNTIME_ERROR_IF(true, "mapped_file: empty or unreadable file");
+  }
+  void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);  // 映射建立后文件描述符不再需要
+  THROW_RUNTIME_ERROR_IF(p == MAP_FAILED, "mapped_file: mmap failed");
+  data_ = static_cast<const char*>(p);
+  size_ = static_cast<size_t>(st.st_size);
+}
+
+inline void mapped_file::close() noexcept
+{
+  if (data_ != nullptr)
+    ::munmap(const_cast<char*>(data_), size_);
+  reset();
+}
+
+#elif defined(MYSTL_SNAPSHOT_WIN32)
+
+inline void mapped_file::open(const char* path)
+{
+  close();
+  file_ = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+  THROW_RUNTIME_ERROR_IF(file_ == INVALID_HANDLE_VALUE, "mapped_file: cannot open file");
+  LARGE_INTEGER len;
+  if (!::GetFileSizeEx(file_, &len) || len.QuadPart <= 0)
+  {
+    close();
+    THROW_RUNTIME_ERROR_IF(true, "mapped_file: empty or unreadable file");
+  }
+  mapping_ = ::CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void* p = mapping_ != nullptr ? ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (p == nullptr)
+  {
+    close();
+    THROW_RUNTIME_ERROR_IF(true, "mapped_file: MapViewOfFile failed");
+  }
+  data_ = static_cast<const char*>(p);
+  size_ = static_cast<size_t>(len.QuadPart);
+}
+
+inline void mapped_file::close() noexcept
+{
+  if (data_ != nullptr)
+    ::UnmapViewOfFile(data_);
+  if (mapping_ != nullptr)
+    ::CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    ::CloseHandle(file_);
+  reset();
+}
+
+#else
+
+inline void mapped_file::open(const char* path)
+{
+  close();
+  std::FILE* f = std::fopen(path, "rb");
+  THROW_RUNTIME_ERROR_IF(f == nullptr, "mapped_file: cannot open file");
+  long len = -1;
+  if (std::fseek(f, 0, SEEK_END) == 0)
+    len = std::ftell(f);
+  if (len <= 0 || std::fseek(f, 0, SEEK_SET) != 0)
+  {
+    std::fclose(f);
+    THROW_RUNTIME_ERROR_IF(true, "mapped_file: empty or unreadable file");
+  }
+  const size_t n = static_cast<size_t>(len);
+  buffer_ = static_cast<char*>(::operator new(n + snapshot_detail::section_align));
+  char* p = buffer_ + (snapshot_detail::section_align -
+    reinterpret_cast<uintptr_t>(buffer_) % snapshot_detail::section_align);
+  const bool ok = std::fread(p, 1, n, f) == n;
+  std::fclose(f);
+  if (!ok)
+  {
+    close();
+    THROW_RUNTIME_ERROR_IF(true, "mapped_file: read failed");
+  }
+  data_ = p;
+  size_ = n;
+}
+
+inline void mapped_file::close() noexcept
+{
+  ::operator delete(buffer_);
+  reset();
+}
+
+#endif
+
+namespace snapshot_detail
+{
+
+// 检查文件头，返回通过检查的文件头
+inline const snapshot_header& check_header(const mapped_file& file, snapshot_kind kind,
+                                           size_t value_size, size_t value_align)
+{
+  THROW_RUNTIME_ERROR_IF(file.size() < sizeof(snapshot_header),
+                         "snapshot: file too small");
+  const snapshot_header& h = *reinterpret_cast<const snapshot_header*>(file.data());
+  THROW_RUNTIME_ERROR_IF(std::memcmp(h.magic, "MYSTLSNP", 8) != 0 || h.version != version ||
+                         h.byte_order != byte_order, "snapshot: not a snapshot of this format");
+  THROW_RUNTIME_ERROR_IF(h.kind != kind || h.value_size != value_size ||
+                         h.value_align != value_align, "snapshot: element type mismatch");
+  THROW_RUNTIME_ERROR_IF(h.file_size != file.size() || h.data_offset % section_align != 0 ||
+                         h.data_offset > h.file_size ||
+                         h.size > (h.file_size - h.data_offset) / value_size,
+                         "snapshot: file truncated or corrupted");
+  if (kind == snapshot_hashed)
+  {
+    THROW_RUNTIME_ERROR_IF(h.bucket_bits == 0 || h.bucket_bits > 63 ||
+                           h.index_offset % section_align != 0 ||
+                           h.index_offset > h.data_offset ||
+                           ((uint64_t(1) << h.bucket_bits) + 1) >
+                           (h.data_offset - h.index_offset) / sizeof(uint64_t),
+                           "snapshot: file truncated or corrupted");
+  }
+  return h;
+}
+
+// 写出一段连续的元素
+template <class T>
+void save_array(const char* path, snapshot_kind kind, const T* data, size_t n)
+{
+  static_assert(storable<T>::value, "snapshot element must be trivially copyable");
+  const uint64_t extra = kind == snapshot_string ? 1 : 0;
+  snapshot_header h = make_header(kind, sizeof(T), alignof(T), n);
+  h.data_offset = align_up(sizeof(snapshot_header));
+  h.file_size = h.data_offset + (n + extra) * sizeof(T);
+  snapshot_writer w(path);
+  w.write(&h, sizeof(h));
+  w.pad_to(h.data_offset);
+  w.write(data, n * sizeof(T));
+  if (extra)
+  {
+    const T zero = T();
+    w.write(&zero, sizeof(T));
+  }
+  w.close();
+}
+
+// 按 [first, first + n) 的顺序写出键值对，每次缓冲一批再写入
+template <class Entry, class Iter>
+void write_entries(snapshot_writer& w, Iter first, size_t n)
+{
+  enum { batch = 4096 / sizeof(Entry) + 1 };
+  alignas(Entry) unsigned char raw[batch * sizeof(Entry)];
+  std::memset(raw, 0, sizeof(raw));  // 填充字节也写成 0，相同的容器得到相同的文件
+  Entry* buf = reinterpret_cast<Entry*>(raw);
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i, ++first)
+  {
+    std::memcpy(&buf[k].first, mystl::address_of((*first).first), sizeof(buf[k].first));
+    std::memcpy(&buf[k].second, mystl::address_of((*first).second), sizeof(buf[k].second));
+    if (++k == batch)
+    {
+      w.write(raw, sizeof(raw));
+      k = 0;
+    }
+  }
+  w.write(raw, k * sizeof(Entry));
+}
+
+// 写出有序容器
+template <class Key, class T, class Container>
+void save_sorted(const char* path, const Container& c)
+{
+  typedef snapshot_pair<Key, T> entry;
+  static_assert(storable<Key>::value && storable<T>::value,
+                "snapshot key and mapped type must be trivially copyable");
+  snapshot_header h = make_header(snapshot_sorted, sizeof(entry), alignof(entry), c.size());
+  h.data_offset = align_up(sizeof(snapshot_header));
+  h.file_size = h.data_offset + h.size * sizeof(entry);
+  snapshot_writer w(path);
+  w.write(&h, sizeof(h));
+  w.pad_to(h.data_offset);
+  write_entries<entry>(w, c.begin(), c.size());
+  w.close();
+}
+
+// 写出哈希容器：先统计每个桶的元素个数得到桶的起点，再按桶的顺序写出元素
+// 同一个桶内保持容器中的相对顺序，因此相等的键值仍然相邻
+template <class Key, class T, class Container>
+void save_hashed(const char* path, const Container& c)
+{
+  typedef snapshot_pair<Key, T>                    entry;
+  typedef typename Container::const_iterator       const_iterator;
+  static_assert(storable<Key>::value && storable<T>::value,
+                "snapshot key and mapped type must be trivially copyable");
+  const size_t n = c.size();
+  snapshot_header h = make_header(snapshot_hashed, sizeof(entry), alignof(entry), n);
+  h.bucket_bits = bucket_bits_for(n);
+  const uint64_t bucket_count = uint64_t(1) << h.bucket_bits;
+  h.index_offset = align_up(sizeof(snapshot_header));
+  h.data_offset = align_up(h.index_offset + (bucket_count + 1) * sizeof(uint64_t));
+  h.file_size = h.data_offset + n * sizeof(entry);
+
+  auto hash = c.hash_fcn();
+  mystl::vector<uint64_t> start(static_cast<size_t>(bucket_count + 1), 0);
+  mystl::vector<uint64_t> where(n);
+  size_t i = 0;
+  for (auto it = c.begin(); it != c.end(); ++it, ++i)
+  {
+    where[i] = bucket_of(hash(it->first), h.bucket_bits);
+    ++start[static_cast<size_t>(where[i] + 1)];
+  }
+  for (size_t b = 0; b < bucket_count; ++b)
+    start[b + 1] += start[b];
+  mystl::vector<const_iterator> order(n);
+  mystl::vector<uint64_t> cursor(bucket_count);
+  for (size_t b = 0; b < bucket_count; ++b)
+    cursor[b] = start[b];
+  i = 0;
+  for (auto it = c.begin(); it != c.end(); ++it, ++i)
+    order[static_cast<size_t>(cursor[static_cast<size_t>(where[i])]++)] = it;
+
+  snapshot_writer w(path);
+  w.write(&h, sizeof(h));
+  w.pad_to(h.index_offset);
+  w.write(start.data(), start.size() * sizeof(uint64_t));
+  w.pad_to(h.data_offset);
+  struct deref
+  {
+    const const_iterator* p;
+    const typename Container::value_type& operator*() const { return **p; }
+    deref& operator++() { ++p; return *this; }
+  };
+  write_entries<entry>(w, deref{ order.data() }, n);
+  w.close();
+}
+
+// 比较元素的键值与 key，供 lower_bound / upper_bound 使用
+template <class Entry, class Key, class Compare>
+struct entry_key_compare
+{
+  Compare comp;
+  bool operator()(const Entry& lhs, const Key& rhs) const { return comp(lhs.first, rhs); }
+  bool operator()(const Key& lhs, const Entry& rhs) const { return comp(lhs, rhs.first); }
+};
+
+} // namespace snapshot_detail
+
+/*****************************************************************************************/
+// mapped_vector
+// 映射 vector 的快照
+
+template <class T>
+class mapped_vector
+{
+  static_assert(snapshot_detail::storable<T>::value,
+                "snapshot element must be trivially copyable");
+
+public:
+  typedef T               value_type;
+  typedef const T*        pointer;
+  typedef const T*        const_pointer;
+  typedef const T&        reference;
+  typedef const T&        const_reference;
+  typedef const T*        iterator;
+  typedef const T*        const_iterator;
+  typedef size_t          size_type;
+  typedef ptrdiff_t       difference_type;
+
+private:
+  mapped_file file_;
+  const T*    data_;
+  size_type   size_;
+
+public:
+  mapped_vector() noexcept
+    :data_(nullptr), size_(0) {}
+
+  explicit mapped_vector(const char* path)
+    :data_(nullptr), size_(0)
+  { open(path); }
+
+  void open(const char* path)
+  {
+    mapped_file f(path);
+    const snapshot_header& h =
+      snapshot_detail::check_header(f, snapshot_sequence, sizeof(T), alignof(T));
+    data_ = reinterpret_cast<const T*>(f.data() + h.data_offset);
+    size_ = static_cast<size_type>(h.size);
+    file_ = mystl::move(f);
+  }
+
+  const_iterator  begin() const noexcept { return data_; }
+  const_iterator  end()   const noexcept { return data_ + size_; }
+  const_pointer   data()  const noexcept { return data_; }
+  size_type       size()  const noexcept { return size_; }
+  bool            empty() const noexcept { return size_ == 0; }
+
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return data_[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "mapped_vector<T>::at() subscript out of range");
+    return data_[n];
+  }
+  const_reference front() const { MYSTL_DEBUG(!empty()); return data_[0]; }
+  const_reference back()  const { MYSTL_DEBUG(!empty()); return data_[size_ - 1]; }
+};
+
+/*****************************************************************************************/
+// mapped_basic_string
+// 映射 basic_string 的快照，字符以空字符结尾
+
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+class mapped_basic_string
+{
+public:
+  typedef CharTraits                                  traits_type;
+  typedef CharType                                    value_type;
+  typedef const CharType*                             const_pointer;
+  typedef const CharType*                             const_iterator;
+  typedef size_t                                      size_type;
+  typedef mystl::basic_string_view<CharType, CharTraits> view_type;
+
+private:
+  mapped_file     file_;
+  const CharType* data_;
+  size_type       size_;
+
+public:
+  mapped_basic_string() noexcept
+    :data_(nullptr), size_(0) {}
+
+  explicit mapped_basic_string(const char* path)
+    :data_(nullptr), size_(0)
+  { open(path); }
+
+  void open(const char* path)
+  {
+    mapped_file f(path);
+    const snapshot_header& h =
+      snapshot_detail::check_header(f, snapshot_string, sizeof(CharType), alignof(CharType));
+    THROW_RUNTIME_ERROR_IF(h.size >= (h.file_size - h.data_offset) / sizeof(CharType),
+                           "snapshot: file truncated or corrupted");
+    data_ = reinterpret_cast<const CharType*>(f.data() + h.data_offset);
+    size_ = static_cast<size_type>(h.size);
+    file_ = mystl::move(f);
+  }
+
+  const_iterator begin() const noexcept { return data_; }
+  const_iterator end()   const noexcept { return data_ + size_; }
+  const_pointer  data()  const noexcept { return data_; }
+  const_pointer  c_str() const noexcept { return data_; }
+  size_type      size()  const noexcept { return size_; }
+  size_type      length() const noexcept { return size_; }
+  bool           empty() const noexcept { return size_ == 0; }
+  view_type      view()  const noexcept { return view_type(data_, size_); }
+
+  CharType operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n <= size_);
+    return data_[n];
+  }
+};
+
+typedef mapped_basic_string<char>     mapped_string;
+typedef mapped_basic_string<wchar_t>  mapped_wstring;
+
+/*****************************************************************************************/
+// mapped_flat_map
+// 映射有序容器的快照，键值可以重复，查找的复杂度为 O(log n)
+
+template <class Key, class T, class Compare = mystl::less<Key>>
+class mapped_flat_map
+{
+public:
+  typedef Key                             key_type;
+  typedef T                               mapped_type;
+  typedef snapshot_pair<Key, T>           value_type;
+  typedef Compare                         key_compare;
+  typedef const value_type*               const_pointer;
+  typedef const value_type&               const_reference;
+  typedef const value_type*               iterator;
+  typedef const value_type*               const_iterator;
+  typedef size_t                          size_type;
+  typedef ptrdiff_t                       difference_type;
+
+  static_assert(snapshot_detail::storable<Key>::value && snapshot_detail::storable<T>::value,
+                "snapshot key and mapped type must be trivially copyable");
+
+private:
+  typedef snapshot_detail::entry_key_compare<value_type, Key, Compare> entry_compare;
+
+  mapped_file       file_;
+  const value_type* data_;
+  size_type         size_;
+  key_compare       comp_;
+
+public:
+  explicit mapped_flat_map(const key_compare& comp = key_compare()) noexcept
+    :data_(nullptr), size_(0), comp_(comp) {}
+
+  explicit mapped_flat_map(const char* path, const key_compare& comp = key_compare())
+    :data_(nullptr), size_(0), comp_(comp)
+  { open(path); }
+
+  void open(const char* path)
+  {
+    mapped_file f(path);
+    const snapshot_header& h =
+      snapshot_detail::check_header(f, snapshot_sorted, sizeof(value_type), alignof(value_type));
+    data_ = reinterpret_cast<const value_type*>(f.data() + h.data_offset);
+    size_ = static_cast<size_type>(h.size);
+    file_ = mystl::move(f);
+  }
+
+  key_compare    key_comp() const { return comp_; }
+
+  const_iterator begin()    const noexcept { return data_; }
+  const_iterator end()      const noexcept { return data_ + size_; }
+  size_type      size()     const noexcept { return size_; }
+  bool           empty()    const noexcept { return size_ == 0; }
+
+  const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    THROW_OUT_OF_RANGE_IF(it == end(), "mapped_flat_map<Key, T> no such element exists");
+    return it->second;
+  }
+
+  const_iterator lower_bound(const key_type& key) const
+  { return mystl::lower_bound(begin(), end(), key, entry_compare{ comp_ }); }
+
+  const_iterator upper_bound(const key_type& key) const
+  { return mystl::upper_bound(begin(), end(), key, entry_compare{ comp_ }); }
+
+  mystl::pair<const_iterator, const_iterator>
+  equal_range(const key_type& key) const
+  {
+    const_iterator first = lower_bound(key);
+    const_iterator last = first;
+    while (last != end() && !comp_(key, last->first))
+      ++last;
+    return mystl::pair<const_iterator, const_iterator>(first, last);
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    return (it == end() || comp_(key, it->first)) ? end() : it;
+  }
+
+  size_type count(const key_type& key) const
+  {
+    auto r = equal_range(key);
+    return static_cast<size_type>(r.second - r.first);
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+};
+
+/*****************************************************************************************/
+// mapped_unordered_map
+// 映射哈希容器的快照，键值可以重复，查找只访问一个桶
+
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+class mapped_unordered_map
+{
+public:
+  typedef Key                             key_type;
+  typedef T                               mapped_type;
+  typedef snapshot_pair<Key, T>           value_type;
+  typedef Hash                            hasher;
+  typedef KeyEqual                        key_equal;
+  typedef const value_type*               const_pointer;
+  typedef const value_type&               const_reference;
+  typedef const value_type*               iterator;
+  typedef const value_type*               const_iterator;
+  typedef size_t                          size_type;
+  typedef ptrdiff_t                       difference_type;
+
+  static_assert(snapshot_detail::storable<Key>::value && snapshot_detail::storable<T>::value,
+                "snapshot key and mapped type must be trivially copyable");
+
+private:
+  mapped_file       file_;
+  const uint64_t*   start_;  // 每个桶在 data_ 中的起点，最后一项为 size_
+  const value_type* data_;
+  size_type         size_;
+  uint32_t          bits_;
+  hasher            hash_;
+  key_equal         equals_;
+
+public:
+  explicit mapped_unordered_map(const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal()) noexcept
+    :start_(nullptr), data_(nullptr), size_(0), bits_(0), hash_(hash), equals_(equal) {}
+
+  explicit mapped_unordered_map(const char* path, const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal())
+    :start_(nullptr), data_(nullptr), size_(0), bits_(0), hash_(hash), equals_(equal)
+  { open(path); }
+
+  void open(const char* path)
+  {
+    mapped_file f(path);
+    const snapshot_header& h =
+      snapshot_detail::check_header(f, snapshot_hashed, sizeof(value_type), alignof(value_type));
+    start_ = reinterpret_cast<const uint64_t*>(f.data() + h.index_offset);
+    THROW_RUNTIME_ERROR_IF(start_[uint64_t(1) << h.bucket_bits] != h.size,
+                           "snapshot: file truncated or corrupted");
+    data_ = reinterpret_cast<const value_type*>(f.data() + h.data_offset);
+    size_ = static_cast<size_type>(h.size);
+    bits_ = h.bucket_bits;
+    file_ = mystl::move(f);
+  }
+
+  hasher         hash_fcn()     const { return hash_; }
+  key_equal      key_eq()       const { return equals_; }
+
+  const_iterator begin()        const noexcept { return data_; }
+  const_iterator end()          const noexcept { return data_ + size_; }
+  size_type      size()         const noexcept { return size_; }
+  bool           empty()        const noexcept { return size_ == 0; }
+  size_type      bucket_count() const noexcept
+  { return bits_ == 0 ? 0 : static_cast<size_type>(uint64_t(1) << bits_); }
+
+  const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    THROW_OUT_OF_RANGE_IF(it == end(), "mapped_unordered_map<Key, T> no such element exists");
+    return it->second;
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    if (size_ == 0)
+      return end();
+    const uint64_t b = snapshot_detail::bucket_of(hash_(key), bits_);
+    const_iterator last = data_ + start_[b + 1];
+    for (const_iterator it = data_ + start_[b]; it != last; ++it)
+    {
+      if (equals_(it->first, key))
+        return it;
+    }
+    return end();
+  }
+
+  mystl::pair<const_iterator, const_iterator>
+  equal_range(const key_type& key) const
+  {
+    const_iterator first = find(key);
+    if (first == end())
+      return mystl::pair<const_iterator, const_iterator>(first, first);
+    const uint64_t b = snapshot_detail::bucket_of(hash_(key), bits_);
+    const_iterator bucket_end = data_ + start_[b + 1];
+    const_iterator last = first + 1;
+    while (last != bucket_end && equals_(last->first, key))
+      ++last;
+    return mystl::pair<const_iterator, const_iterator>(first, last);
+  }
+
+  size_type count(const key_type& key) const
+  {
+    auto r = equal_range(key);
+    return static_cast<size_type>(r.second - r.first);
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+};
+
+/*****************************************************************************************/
+// save_snapshot
+// 把容器写成快照文件，文件已存在时覆盖
+
+template <class T, class Alloc>
+void save_snapshot(const char* path, const vector<T, Alloc>& v)
+{
+  snapshot_detail::save_array(path, snapshot_sequence, v.data(), v.size());
+}
+
+template <class CharType, class CharTraits, class Alloc>
+void save_snapshot(const char* path, const basic_string<CharType, CharTraits, Alloc>& s)
+{
+  snapshot_detail::save_array(path, snapshot_string, s.data(), s.size());
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void save_snapshot(const char* path, const map<Key, T, Compare, Alloc>& m)
+{
+  snapshot_detail::save_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void save_snapshot(const char* path, const multimap<Key, T, Compare, Alloc>& m)
+{
+  snapshot_detail::save_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+void save_snapshot(const char* path, const flat_map<Key, T, Compare, Alloc, Search>& m)
+{
+  snapshot_detail::save_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+void save_snapshot(const char* path, const flat_multimap<Key, T, Compare, Alloc, Search>& m)
+{
+  snapshot_detail::save_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void save_snapshot(const char* path,
+                   const unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& m)
+{
+  snapshot_detail::save_hashed<Key, T>(path, m);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void save_snapshot(const char* path,
+                   const unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& m)
+{
+  snapshot_detail::save_hashed<Key, T>(path, m);
+}
+
+/*****************************************************************************************/
+// load_snapshot
+// 从快照文件重新构造容器，容器原有的元素被替换
+// 有序的快照可以读入 map、multimap、flat_map、flat_multimap，
+// 哈希的快照可以读入 unordered_map、unordered_multimap
+
+namespace snapshot_detail
+{
+
+template <class Key, class T, class Container>
+void load_sorted(const char* path, Container& c)
+{
+  mapped_flat_map<Key, T, typename Container::key_compare> view(path, c.key_comp());
+  Container tmp(c.key_comp());
+  for (auto it = view.begin(); it != view.end(); ++it)
+    tmp.emplace_hint(tmp.end(), it->first, it->second);
+  c.swap(tmp);
+}
+
+template <class Key, class T, class Container>
+void load_hashed(const char* path, Container& c)
+{
+  mapped_unordered_map<Key, T, typename Container::hasher, typename Container::key_equal>
+    view(path, c.hash_fcn(), c.key_eq());
+  Container tmp(view.size(), c.hash_fcn(), c.key_eq());
+  for (auto it = view.begin(); it != view.end(); ++it)
+    tmp.emplace(it->first, it->second);
+  c.swap(tmp);
+}
+
+} // namespace snapshot_detail
+
+template <class T, class Alloc>
+void load_snapshot(const char* path, vector<T, Alloc>& v)
+{
+  mapped_vector<T> view(path);
+  v.assign(view.begin(), view.end());
+}
+
+template <class CharType, class CharTraits, class Alloc>
+void load_snapshot(const char* path, basic_string<CharType, CharTraits, Alloc>& s)
+{
+  mapped_basic_string<CharType, CharTraits> view(path);
+  s.clear();
+  s.append(view.data(), view.size());
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void load_snapshot(const char* path, map<Key, T, Compare, Alloc>& m)
+{
+  snapshot_detail::load_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void load_snapshot(const char* path, multimap<Key, T, Compare, Alloc>& m)
+{
+  snapshot_detail::load_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+void load_snapshot(const char* path, flat_map<Key, T, Compare, Alloc, Search>& m)
+{
+  snapshot_detail::load_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Search>
+void load_snapshot(const char* path, flat_multimap<Key, T, Compare, Alloc, Search>& m)
+{
+  snapshot_detail::load_sorted<Key, T>(path, m);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void load_snapshot(const char* path, unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& m)
+{
+  snapshot_detail::load_hashed<Key, T>(path, m);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void load_snapshot(const char* path,
+                   unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& m)
+{
+  snapshot_detail::load_hashed<Key, T>(path, m);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SNAPSHOT_H_
@@ -0,0 +1,524 @@
+﻿#ifndef MYTINYSTL_STATIC_MAP_H_
+#define MYTINYSTL_STATIC_MAP_H_
+
+// 这个头文件包含两个在编译期构建的只读映射 static_map 和 static_sorted_map
+// static_map        : 以最小完美哈希定位元素，查找只做一次哈希、一次比较
+// static_sorted_map : 元素在编译期按键值排序，以二分查找定位，按键值顺序遍历
+
+// notes:
+//
+// 1. 两者的元素个数 N 为模板参数，元素保存在对象内部的数组中，不分配内存，
+//    以 constexpr 变量定义时在编译期完成构建，没有任何启动开销：
+//      constexpr auto methods = mystl::make_static_map<mystl::string_view, int>({
+//        { "GET", 1 }, { "POST", 2 }, { "PUT", 3 } });
+//      static_assert(methods.at("POST") == 2, "");
+// 2. 需要 C++14 的 constexpr（MYSTL_HAS_CONSTEXPR14），键值与实值必须是字面类型
+// 3. static_map 使用 hash and displace 的构建方式（参考 CHD / PTHash）：
+//    键值先按哈希值分到 N / 2 + 1 个桶中，从大桶开始，为每个桶寻找一个 pilot，
+//    使桶内所有键值经 pilot 扰动后落到互不相同的空位上，N 个元素恰好占满 N 个位置；
+//    失败时更换种子重来。查找时由哈希值找到桶，再由桶的 pilot 算出位置
+// 4. 缺省的哈希为 static_hash，支持整数、枚举与 basic_string_view，其它键值类型需要提供
+//    形如 constexpr uint64_t operator()(const Key&, uint64_t seed) const 的哈希函数
+// 5. string_view 的比较在运行期使用 memcmp，不能在编译期求值，
+//    因此缺省的比较使用 static_key_equal / static_key_less，对 basic_string_view 逐字符比较
+// 6. 键值重复时构建失败：在编译期求值时表现为编译错误，在运行期抛出 std::runtime_error
+
+#include <cstdint>
+
+#include "astring.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+#if !MYSTL_HAS_CONSTEXPR14
+#error "static_map.h requires C++14 constexpr support"
+#endif
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// 编译期可用的比较与哈希
+
+namespace static_map_detail
+{
+
+// 64 位的最终混合（splitmix64），使结果的每一位都依赖于输入的每一位
+constexpr uint64_t mix(uint64_t x) noexcept
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+// 逐个成员赋值：pair::operator= 比较 this 与 &rhs，
+// 两者属于不同的 constexpr 对象时 GCC 不能在编译期求值这个比较
+template <class Key, class T>
+constexpr void assign(mystl::pair<Key, T>& dst, const mystl::pair<Key, T>& src)
+{
+  dst.first = src.first;
+  dst.second = src.second;
+}
+
+// 字符串按 8 字节一组处理，每组的字符个数
+template <class CharType>
+struct word_chars
+{
+  static constexpr size_t value = 8 / sizeof(CharType);
+  static constexpr size_t bits = 8 * sizeof(CharType);
+};
+
+// 把 n 个字符拼成一个 64 位整数，先出现的字符在低位
+// 只用移位与或运算，可以在编译期求值，n 为常数时编译器会把它合并为一次读取
+template <class CharType>
+constexpr uint64_t load_le(const CharType* p, size_t n) noexcept
+{
+  typedef typename std::make_unsigned<CharType>::type uchar_type;
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; ++i)
+    v |= static_cast<uint64_t>(static_cast<uchar_type>(p[i])) << (word_chars<CharType>::bits * i);
+  return v;
+}
+
+// 同上，先出现的字符在高位，按整数比较的结果与按字典序比较相同
+template <class CharType>
+constexpr uint64_t load_be(const CharType* p, size_t n) noexcept
+{
+  typedef typename std::make_unsigned<CharType>::type uchar_type;
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; ++i)
+    v = (v << (word_chars<CharType>::bits - 1) << 1) | static_cast<uchar_type>(p[i]);
+  return v;
+}
+
+// 每次处理 8 字节的字符串哈希：长度相同的两个字符串，每一轮都是对输入的双射，
+// 因此只要内容不同，最终混合前的 64 位状态一定不同
+template <class CharType>
+constexpr uint64_t hash_chars(const CharType* p, size_t n, uint64_t seed) noexcept
+{
+  constexpr size_t w = word_chars<CharType>::value;
+  uint64_t h = seed ^ (static_cast<uint64_t>(n) * 0x9e3779b97f4a7c15ull);
+  size_t i = 0;
+  for (; i + w <= n; i += w)
+  {
+    h = (h ^ load_le(p + i, w)) * 0xbf58476d1ce4e5b9ull;
+    h = (h << 31) | (h >> 33);
+  }
+  if (i < n)
+    h = (h ^ load_le(p + i, n - i)) * 0x94d049bb133111ebull;
+  return mix(h);
+}
+
+} // namespace static_map_detail
+
+// 键值相等，缺省使用 mystl::equal_to
+template <class Key>
+struct static_key_equal :public mystl::equal_to<Key> {};
+
+// basic_string_view 按 8 字节一组比较
+template <class CharType, class CharTraits>
+struct static_key_equal<basic_string_view<CharType, CharTraits>>
+{
+  constexpr bool operator()(basic_string_view<CharType, CharTraits> lhs,
+                            basic_string_view<CharType, CharTraits> rhs) const noexcept
+  {
+    using namespace static_map_detail;
+    constexpr size_t w = word_chars<CharType>::value;
+    const size_t n = lhs.size();
+    if (n != rhs.size())
+      return false;
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+      if (load_le(lhs.data() + i, w) != load_le(rhs.data() + i, w))
+        return false;
+    }
+    return i == n || load_le(lhs.data() + i, n - i) == load_le(rhs.data() + i, n - i);
+  }
+};
+
+// 键值小于，缺省使用 mystl::less
+template <class Key>
+struct static_key_less :public mystl::less<Key> {};
+
+// basic_string_view 按字典序比较，每次比较 8 字节
+template <class CharType, class CharTraits>
+struct static_key_less<basic_string_view<CharType, CharTraits>>
+{
+  constexpr bool operator()(basic_string_view<CharType, CharTraits> lhs,
+                            basic_string_view<CharType, CharTraits> rhs) const noexcept
+  {
+    using namespace static_map_detail;
+    constexpr size_t w = word_chars<CharType>::value;
+    const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    size_t i = 0;
+    for (; i + w <= n; i += w)
+    {
+      const uint64_t a = load_be(lhs.data() + i, w), b = load_be(rhs.data() + i, w);
+      if (a != b)
+        return a < b;
+    }
+    if (i < n)
+    {
+      const uint64_t a = load_be(lhs.data() + i, n - i), b = load_be(rhs.data() + i, n - i);
+      if (a != b)
+        return a < b;
+    }
+    return lhs.size() < rhs.size();
+  }
+};
+
+// 带种子的哈希，缺省只支持整数、枚举与 basic_string_view
+template <class Key, class = void>
+struct static_hash {};
+
+template <class Key>
+struct static_hash<Key, typename std::enable_if<
+  std::is_integral<Key>::value || std::is_enum<Key>::value>::type>
+{
+  constexpr uint64_t operator()(Key key, uint64_t seed) const noexcept
+  { return static_map_detail::mix(static_cast<uint64_t>(key) ^ seed); }
+};
+
+template <class CharType, class CharTraits>
+struct static_hash<basic_string_view<CharType, CharTraits>>
+{
+  constexpr uint64_t operator()(basic_string_view<CharType, CharTraits> str,
+                                uint64_t seed) const noexcept
+  { return static_map_detail::hash_chars(str.data(), str.size(), seed); }
+};
+
+/*****************************************************************************************/
+// static_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表元素个数，
+// 参数四代表带种子的哈希函数，缺省使用 static_hash，参数五代表键值相等的比较方式，缺省使用 static_key_equal
+
+template <class Key, class T, size_t N, class Hash = mystl::static_hash<Key>,
+          class KeyEqual = mystl::static_key_equal<Key>>
+class static_map
+{
+  static_assert(N > 0, "static_map must not be empty");
+
+public:
+  typedef Key                      key_type;
+  typedef T                        mapped_type;
+  typedef mystl::pair<Key, T>      value_type;
+  typedef Hash                     hasher;
+  typedef KeyEqual                 key_equal;
+  typedef const value_type*        pointer;
+  typedef const value_type*        const_pointer;
+  typedef const value_type&        reference;
+  typedef const value_type&        const_reference;
+  typedef const value_type*        iterator;
+  typedef const value_type*        const_iterator;
+  typedef size_t                   size_type;
+  typedef ptrdiff_t                difference_type;
+
+private:
+  enum : size_t   { bucket_count = N / 2 + 1 };
+  enum : uint32_t { max_pilot = 1u << 16 };  // 一个桶最多尝试的 pilot 个数，超过时更换种子
+
+  value_type slots_[N];                // 元素按完美哈希的位置存放
+  uint64_t   displace_[bucket_count];  // 每个桶的 pilot 混合后的扰动值
+  uint64_t   seed_;
+  hasher     hash_;
+  key_equal  equal_;
+
+public:
+  constexpr explicit static_map(const value_type (&items)[N], const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal())
+    :slots_(), displace_(), seed_(0), hash_(hash), equal_(equal)
+  {
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    while (!try_build(items, seed))
+      seed = static_map_detail::mix(seed + 1);
+    seed_ = seed;
+  }
+
+  // 迭代器与容量，遍历的顺序由哈希决定
+  constexpr const_iterator begin()    const noexcept { return slots_; }
+  constexpr const_iterator end()      const noexcept { return slots_ + N; }
+  constexpr const_iterator cbegin()   const noexcept { return begin(); }
+  constexpr const_iterator cend()     const noexcept { return end(); }
+  constexpr size_type      size()     const noexcept { return N; }
+  constexpr size_type      max_size() const noexcept { return N; }
+  constexpr bool           empty()    const noexcept { return false; }
+
+  constexpr hasher         hash_function() const { return hash_; }
+  constexpr key_equal      key_eq()        const { return equal_; }
+
+  // 查找
+
+  constexpr const_iterator find(const key_type& key) const
+  {
+    const uint64_t h = hash_(key, seed_);
+    const_pointer p = slots_ + position(h, displace_[bucket_of(h)]);
+    return equal_(p->first, key) ? p : end();
+  }
+
+  constexpr size_type count(const key_type& key) const
+  { return find(key) != end() ? 1 : 0; }
+
+  constexpr bool contains(const key_type& key) const
+  { return find(key) != end(); }
+
+  constexpr const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    THROW_OUT_OF_RANGE_IF(it == end(), "static_map<Key, T, N> no such element exists");
+    return it->second;
+  }
+
+private:
+  static constexpr size_t bucket_of(uint64_t h) noexcept
+  { return static_cast<size_t>((h >> 32) % bucket_count); }
+
+  // 异或之后再乘一次取高位：N 为 2 的幂时直接取模只用到低位，异或只能把它们整体平移
+  static constexpr size_t position(uint64_t h, uint64_t displace) noexcept
+  { return static_cast<size_t>((((h ^ displace) * 0x9e3779b97f4a7c15ull) >> 32) % N); }
+
+  constexpr bool try_build(const value_type (&items)[N], uint64_t seed);
+};
+
+// 以 seed 尝试构建，某个桶找不到 pilot 时返回 false
+template <class Key, class T, size_t N, class Hash, class KeyEqual>
+constexpr bool static_map<Key, T, N, Hash, KeyEqual>::
+try_build(const value_type (&items)[N], uint64_t seed)
+{
+  uint64_t hashes[N] = {};
+  size_t   start[bucket_count + 1] = {};  // 每个桶的成员在 members 中的起点
+  size_t   members[N] = {};
+  size_t   order[bucket_count] = {};      // 按桶的大小降序排列的桶
+  bool     taken[N] = {};
+
+  // 分桶
+  size_t max_size = 0;
+  for (size_t i = 0; i < N; ++i)
+  {
+    hashes[i] = hash_(items[i].first, seed);
+    ++start[bucket_of(hashes[i]) + 1];
+  }
+  for (size_t b = 0; b < bucket_count; ++b)
+  {
+    max_size = start[b + 1] > max_size ? start[b + 1] : max_size;
+    start[b + 1] += start[b];
+  }
+  size_t fill[bucket_count] = {};
+  for (size_t b = 0; b < bucket_count; ++b)
+    fill[b] = start[b];
+  for (size_t i = 0; i < N; ++i)
+    members[fill[bucket_of(hashes[i])]++] = i;
+  size_t buckets = 0;
+  for (size_t sz = max_size; sz > 0; --sz)
+  {
+    for (size_t b = 0; b < bucket_count; ++b)
+    {
+      if (start[b + 1] - start[b] == sz)
+        order[buckets++] = b;
+    }
+  }
+
+  // 从大桶开始为每个桶寻找 pilot
+  for (size_t j = 0; j < buckets; ++j)
+  {
+    const size_t b = order[j];
+    const size_t first = start[b], last = start[b + 1];
+    for (size_t p = first; p < last; ++p)
+    {
+      for (size_t q = p + 1; q < last; ++q)
+      {
+        THROW_RUNTIME_ERROR_IF(hashes[members[p]] == hashes[members[q]] &&
+                               equal_(items[members[p]].first, items[members[q]].first),
+                               "static_map: duplicate key");
+      }
+    }
+    bool placed = false;
+    for (uint32_t pilot = 0; pilot < max_pilot && !placed; ++pilot)
+    {
+      const uint64_t displace = static_map_detail::mix(pilot);
+      size_t p = first;
+      for (; p < last; ++p)
+      {
+        const size_t pos = position(hashes[members[p]], displace);
+        if (taken[pos])
+          break;
+        taken[pos] = true;
+      }
+      placed = p == last;
+      if (placed)
+      {
+        displace_[b] = displace;
+      }
+      else
+      {
+        while (p > first)  // 撤销这次尝试占用的位置
+        {
+          --p;
+          taken[position(hashes[members[p]], displace)] = false;
+        }
+      }
+    }
+    if (!placed)
+      return false;
+  }
+
+  for (size_t i = 0; i < N; ++i)
+    static_map_detail::assign(slots_[position(hashes[i], displace_[bucket_of(hashes[i])])], items[i]);
+  return true;
+}
+
+/*****************************************************************************************/
+// static_sorted_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表元素个数，
+// 参数四代表键值的比较方式，缺省使用 static_key_less
+
+template <class Key, class T, size_t N, class Compare = mystl::static_key_less<Key>>
+class static_sorted_map
+{
+  static_assert(N > 0, "static_sorted_map must not be empty");
+
+public:
+  typedef Key                      key_type;
+  typedef T                        mapped_type;
+  typedef mystl::pair<Key, T>      value_type;
+  typedef Compare                  key_compare;
+  typedef const value_type*        pointer;
+  typedef const value_type*        const_pointer;
+  typedef const value_type&        reference;
+  typedef const value_type&        const_reference;
+  typedef const value_type*        iterator;
+  typedef const value_type*        const_iterator;
+  typedef size_t                   size_type;
+  typedef ptrdiff_t                difference_type;
+
+private:
+  value_type  data_[N];  // 按键值升序排列
+  key_compare comp_;
+
+public:
+  constexpr explicit static_sorted_map(const value_type (&items)[N],
+                                       const key_compare& comp = key_compare())
+    :data_(), comp_(comp)
+  {
+    for (size_t i = 0; i < N; ++i)
+      static_map_detail::assign(data_[i], items[i]);
+    heap_sort();
+    for (size_t i = 1; i < N; ++i)
+    {
+      THROW_RUNTIME_ERROR_IF(!comp_(data_[i - 1].first, data_[i].first),
+                             "static_sorted_map: duplicate key");
+    }
+  }
+
+  // 迭代器与容量，按键值升序遍历
+  constexpr const_iterator begin()    const noexcept { return data_; }
+  constexpr const_iterator end()      const noexcept { return data_ + N; }
+  constexpr const_iterator cbegin()   const noexcept { return begin(); }
+  constexpr const_iterator cend()     const noexcept { return end(); }
+  constexpr size_type      size()     const noexcept { return N; }
+  constexpr size_type      max_size() const noexcept { return N; }
+  constexpr bool           empty()    const noexcept { return false; }
+
+  constexpr key_compare    key_comp() const { return comp_; }
+
+  // 查找
+
+  constexpr const_iterator lower_bound(const key_type& key) const
+  {
+    size_t first = 0, len = N;
+    while (len > 0)
+    {
+      const size_t half = len >> 1;
+      if (comp_(data_[first + half].first, key))
+      {
+        first += half + 1;
+        len -= half + 1;
+      }
+      else
+      {
+        len = half;
+      }
+    }
+    return data_ + first;
+  }
+
+  constexpr const_iterator upper_bound(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? it + 1 : it;
+  }
+
+  constexpr mystl::pair<const_iterator, const_iterator>
+  equal_range(const key_type& key) const
+  { return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key)); }
+
+  constexpr const_iterator find(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? it : end();
+  }
+
+  constexpr size_type count(const key_type& key) const
+  { return find(key) != end() ? 1 : 0; }
+
+  constexpr bool contains(const key_type& key) const
+  { return find(key) != end(); }
+
+  constexpr const mapped_type& at(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    THROW_OUT_OF_RANGE_IF(it == end(), "static_sorted_map<Key, T, N> no such element exists");
+    return it->second;
+  }
+
+private:
+  constexpr void sift_down(size_t i, size_t n)
+  {
+    for (size_t child = 2 * i + 1; child < n; child = 2 * i + 1)
+    {
+      if (child + 1 < n && comp_(data_[child].first, data_[child + 1].first))
+        ++child;
+      if (!comp_(data_[i].first, data_[child].first))
+        break;
+      mystl::swap(data_[i], data_[child]);
+      i = child;
+    }
+  }
+
+  // 堆排序，O(N log N) 且不需要额外的空间，适合在编译期求值
+  constexpr void heap_sort()
+  {
+    for (size_t i = N / 2; i > 0; --i)
+      sift_down(i - 1, N);
+    for (size_t n = N - 1; n > 0; --n)
+    {
+      mystl::swap(data_[0], data_[n]);
+      sift_down(0, n);
+    }
+  }
+};
+
+/*****************************************************************************************/
+// make_static_map / make_static_sorted_map
+// 从一组键值对构造，元素个数由参数推导：make_static_map<Key, T>({ { k1, v1 }, { k2, v2 } })
+
+template <class Key, class T, size_t N, class Hash = mystl::static_hash<Key>,
+          class KeyEqual = mystl::static_key_equal<Key>>
+constexpr static_map<Key, T, N, Hash, KeyEqual>
+make_static_map(const mystl::pair<Key, T> (&items)[N])
+{
+  return static_map<Key, T, N, Hash, KeyEqual>(items);
+}
+
+template <class Key, class T, size_t N, class Compare = mystl::static_key_less<Key>>
+constexpr static_sorted_map<Key, T, N, Compare>
+make_static_sorted_map(const mystl::pair<Key, T> (&items)[N])
+{
+  return static_sorted_map<Key, T, N, Compare>(items);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_STATIC_MAP_H_
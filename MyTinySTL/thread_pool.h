@@ -0,0 +1,269 @@
+﻿#ifndef MYTINYSTL_THREAD_POOL_H_
+#define MYTINYSTL_THREAD_POOL_H_
+
+// 这个头文件包含两个类 thread_pool 与 task_group
+// thread_pool : 固定数量工作线程的线程池，mystl 的并行算法默认使用 thread_pool::instance()
+// task_group  : 一组提交到线程池的任务，wait() 等待它们全部完成
+
+// notes:
+//
+// 1. 等待 task_group 的线程不会空等，而是从线程池的队列中取出任务执行，
+//    因此任务内部可以再创建 task_group 并等待，不会死锁
+// 2. 线程池的工作线程数默认为硬件并发数减一，调用并行算法的线程也参与计算
+// 3. task_group 中任务抛出的第一个异常会在 wait() 中重新抛出，直接 submit 的任务不能抛出异常
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "deque.h"
+#include "vector.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 线程池
+class thread_pool
+{
+public:
+  typedef std::function<void()> task_type;
+
+public:
+  // workers 为工作线程数，可以为 0，此时所有任务都由等待的线程执行
+  explicit thread_pool(size_t workers = default_workers());
+  ~thread_pool();
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  // 工作线程数
+  size_t size()        const noexcept { return workers_.size(); }
+  // 可以同时执行任务的线程数，包括调用者线程
+  size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+  // 提交一个任务
+  void submit(task_type task);
+
+  // 在当前线程执行一个排队中的任务，队列为空时返回 false
+  bool run_pending();
+
+  // 全局线程池
+  static thread_pool& instance()
+  {
+    static thread_pool pool;
+    return pool;
+  }
+
+  static size_t default_workers() noexcept
+  {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 1 ? n - 1 : 0;
+  }
+
+private:
+  void worker_loop();
+  void stop_workers() noexcept;
+
+private:
+  std::mutex                mutex_;
+  std::condition_variable   cond_;
+  mystl::deque<task_type>   tasks_;
+  mystl::vector<std::thread> workers_;
+  bool                      stop_;
+};
+
+inline thread_pool::thread_pool(size_t workers)
+  :stop_(false)
+{
+  workers_.reserve(workers);
+  try
+  {
+    for (size_t i = 0; i < workers; ++i)
+      workers_.emplace_back(&thread_pool::worker_loop, this);
+  }
+  catch (...)
+  {
+    stop_workers();
+    throw;
+  }
+}
+
+inline thread_pool::~thread_pool()
+{
+  stop_workers();
+}
+
+inline void thread_pool::submit(task_type task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(mystl::move(task));
+  }
+  cond_.notify_one();
+}
+
+inline bool thread_pool::run_pending()
+{
+  task_type task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty())
+      return false;
+    task = mystl::move(tasks_.front());
+    tasks_.pop_front();
+  }
+  task();
+  return true;
+}
+
+// 工作线程在线程池析构前执行完队列中剩余的任务
+inline void thread_pool::worker_loop()
+{
+  for (;;)
+  {
+    task_type task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        return;
+      task = mystl::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+inline void thread_pool::stop_workers() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  for (auto& t : workers_)
+  {
+    if (t.joinable())
+      t.join();
+  }
+}
+
+/*****************************************************************************************/
+
+// 任务组
+class task_group
+{
+public:
+  explicit task_group(thread_pool& pool = thread_pool::instance())
+    :pool_(pool), pending_(0)
+  {
+  }
+
+  // 析构时等待所有任务完成，但不重新抛出异常
+  ~task_group()
+  {
+    wait_all();
+  }
+
+  task_group(const task_group&) = delete;
+  task_group& operator=(const task_group&) = delete;
+
+  thread_pool& pool() const noexcept { return pool_; }
+
+  // 提交一个任务，f 会被复制
+  template <class Function>
+  void run(Function&& f);
+
+  // 等待所有任务完成，如果有任务抛出异常，重新抛出第一个异常
+  void wait();
+
+private:
+  void record_error() noexcept;
+  void finish() noexcept;
+  void wait_all() noexcept;
+
+private:
+  thread_pool&        pool_;
+  std::atomic<size_t> pending_;  // 尚未完成的任务数
+  std::mutex          mutex_;
+  std::condition_variable cond_;
+  std::exception_ptr  error_;
+};
+
+template <class Function>
+void task_group::run(Function&& f)
+{
+  typedef typename std::decay<Function>::type function_type;
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  try
+  {
+    function_type fn(mystl::forward<Function>(f));
+    pool_.submit([this, fn]() mutable
+    {
+      try
+      {
+        fn();
+      }
+      catch (...)
+      {
+        record_error();
+      }
+      finish();
+    });
+  }
+  catch (...)
+  {
+    finish();
+    throw;
+  }
+}
+
+inline void task_group::wait()
+{
+  wait_all();
+  if (error_)
+  {
+    std::exception_ptr e = error_;
+    error_ = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+inline void task_group::record_error() noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!error_)
+    error_ = std::current_exception();
+}
+
+// 在锁内减少计数，保证 wait_all 返回之后不会再访问本对象
+inline void task_group::finish() noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    cond_.notify_all();
+}
+
+inline void task_group::wait_all() noexcept
+{
+  while (pending_.load(std::memory_order_acquire) != 0)
+  {
+    if (!pool_.run_pending())
+    {
+      // 没有可执行的任务，等待本组任务完成，也定期检查是否有新的任务
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait_for(lock, std::chrono::milliseconds(1),
+                     [this] { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_THREAD_POOL_H_
+
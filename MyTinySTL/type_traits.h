@@ -6,6 +6,17 @@
 // use standard header for type_traits
 #include <type_traits>
 
+// C++14 起 constexpr 函数中可以使用循环、局部变量与赋值，
+// MYSTL_CONSTEXPR14 只在编译器支持时展开为 constexpr，C++11 下为空
+#if (defined(__cpp_constexpr) && __cpp_constexpr >= 201304L) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1910 && defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#define MYSTL_HAS_CONSTEXPR14 1
+#define MYSTL_CONSTEXPR14 constexpr
+#else
+#define MYSTL_HAS_CONSTEXPR14 0
+#define MYSTL_CONSTEXPR14
+#endif
+
 namespace mystl
 {
 
@@ -23,6 +34,14 @@ using m_bool_constant = m_integral_constant<bool, b>;
 typedef m_bool_constant<true>  m_true_type;
 typedef m_bool_constant<false> m_false_type;
 
+// m_void：把任意类型映射为 void，用于以 SFINAE 检测嵌套型别是否存在
+template <class... Ts>
+struct m_void { typedef void type; };
+
+// m_identity：原样返回类型，写作 typename m_identity<T>::type 的参数不参与模板参数推导
+template <class T>
+struct m_identity { typedef T type; };
+
 /*****************************************************************************************/
 // type traits
 
@@ -41,6 +60,20 @@ struct is_pair : mystl::m_false_type {};  //is_pair<int>::value
 template <class T1, class T2>
 struct is_pair<mystl::pair<T1, T2>> : mystl::m_true_type {};  //is_pair<pair<int, double>>::value
 
+// is_trivially_relocatable
+
+// 把对象按字节复制到新位置并直接丢弃原对象（不调用析构函数），与“移动构造到新位置后析构原对象”等价
+// 平凡可复制的类型总是满足这一点；只持有指向堆内存的指针、不保存指向自身的指针的类型，
+// 如库中的各个容器，可以通过特化声明自己满足
+template <class T>
+struct is_trivially_relocatable
+  : mystl::m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
+template <class T1, class T2>
+struct is_trivially_relocatable<mystl::pair<T1, T2>>
+  : mystl::m_bool_constant<is_trivially_relocatable<T1>::value &&
+                           is_trivially_relocatable<T2>::value> {};
+
 } // namespace mystl
 
 #endif // !MYTINYSTL_TYPE_TRAITS_H_
@@ -253,6 +253,36 @@ ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
                                         value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_relocate
+// 把 [first, last) 上的对象搬移到以 result 为起始处的未初始化空间，返回搬移结束的位置
+// 完成后原位置上的对象视为已经析构。满足 is_trivially_relocatable 的类型直接按字节复制，
+// 否则逐个移动构造后析构原对象，移动构造抛出异常时原对象保持不变
+/*****************************************************************************************/
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_true_type) noexcept
+{
+  const auto n = static_cast<size_t>(last - first);
+  if (n != 0)
+    std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+  return result + n;
+}
+
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_false_type)
+{
+  auto cur = mystl::uninitialized_move(first, last, result);
+  mystl::destroy(first, last);
+  return cur;
+}
+
+template <class T>
+T* uninitialized_relocate(T* first, T* last, T* result)
+{
+  return mystl::unchecked_uninit_relocate(first, last, result,
+                                          mystl::is_trivially_relocatable<T>());
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNINITIALIZED_H_
 
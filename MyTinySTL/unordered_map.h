@@ -17,17 +17,28 @@
 namespace mystl
 {
 
+template <class, class, class, class, class, class>
+class unordered_multimap;
+
 // 模板类 unordered_map，键值不允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
 // 参数四代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数五代表桶策略，缺省使用 mystl::ht_prime_policy，可换成 ht_power2_policy 或 ht_fastrange_policy
+// 参数六代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy, class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_map
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+  typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual, Policy, Alloc> base_type;
   base_type ht_;
 
+  template <class, class, class, class, class, class>
+  friend class unordered_map;
+  template <class, class, class, class, class, class>
+  friend class unordered_multimap;
+
 public:
   // 使用 hashtable 的型别  
 
@@ -50,6 +61,9 @@ public:
   typedef typename base_type::local_iterator       local_iterator;
   typedef typename base_type::const_local_iterator const_local_iterator;
 
+  typedef typename base_type::node_handle_type     node_type;
+  typedef mystl::node_insert_return<iterator, node_type> insert_return_type;
+
   allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -60,10 +74,16 @@ public:
   {
   }
 
+  explicit unordered_map(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_map(size_type bucket_count,
                          const Hash& hash = Hash(),
-                         const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -71,8 +91,9 @@ public:
   unordered_map(InputIterator first, InputIterator last,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -81,8 +102,9 @@ public:
   unordered_map(std::initializer_list<value_type> ilist,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -92,10 +114,18 @@ public:
     :ht_(rhs.ht_) 
   {
   }
+  unordered_map(const unordered_map& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_map(unordered_map&& rhs) noexcept
     :ht_(mystl::move(rhs.ht_)) 
   {
   }
+  unordered_map(unordered_map&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_map& operator=(const unordered_map& rhs) 
   { 
@@ -158,17 +188,58 @@ public:
   pair<iterator, bool> insert(const value_type& value)
   { return ht_.insert_unique(value); }
   pair<iterator, bool> insert(value_type&& value)
-  { return ht_.emplace_unique(mystl::move(value)); }
+  { return ht_.insert_unique(mystl::move(value)); }
 
   iterator insert(const_iterator hint, const value_type& value)
   { return ht_.insert_unique_use_hint(hint, value); }
   iterator insert(const_iterator hint, value_type&& value)
-  { return ht_.emplace_unique_use_hint(hint, mystl::move(value)); }
+  { return ht_.insert_unique_use_hint(hint, mystl::move(value)); }
 
   template <class InputIterator>
   void insert(InputIterator first, InputIterator last)
   { ht_.insert_unique(first, last); }
 
+  // try_emplace：先查找键值，已存在时不创建节点，args 也不会被移动
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+  { return ht_.try_emplace_unique(key, mystl::forward<Args>(args)...); }
+  template <class ...Args>
+  pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+  { return ht_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...); }
+
+  // [note]: 同 emplace_hint
+  template <class ...Args>
+  iterator try_emplace(const_iterator /*hint*/, const key_type& key, Args&& ...args)
+  { return ht_.try_emplace_unique(key, mystl::forward<Args>(args)...).first; }
+  template <class ...Args>
+  iterator try_emplace(const_iterator /*hint*/, key_type&& key, Args&& ...args)
+  { return ht_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...).first; }
+
+  // insert_or_assign：键值已存在时给实值赋值，否则插入
+  // try_emplace 失败时不会使用 obj，所以可以再把它转发给赋值操作
+  template <class M>
+  pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+  {
+    auto res = ht_.try_emplace_unique(key, mystl::forward<M>(obj));
+    if (!res.second)
+      res.first->second = mystl::forward<M>(obj);
+    return res;
+  }
+  template <class M>
+  pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+  {
+    auto res = ht_.try_emplace_unique(mystl::move(key), mystl::forward<M>(obj));
+    if (!res.second)
+      res.first->second = mystl::forward<M>(obj);
+    return res;
+  }
+  template <class M>
+  iterator insert_or_assign(const_iterator /*hint*/, const key_type& key, M&& obj)
+  { return insert_or_assign(key, mystl::forward<M>(obj)).first; }
+  template <class M>
+  iterator insert_or_assign(const_iterator /*hint*/, key_type&& key, M&& obj)
+  { return insert_or_assign(mystl::move(key), mystl::forward<M>(obj)).first; }
+
   // erase / clear
 
   void      erase(iterator it)
@@ -182,6 +253,34 @@ public:
   void      clear()
   { ht_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配节点
+
+  node_type extract(const_iterator position)
+  { return ht_.extract(position); }
+  node_type extract(const key_type& key)
+  { return ht_.extract(key); }
+
+  insert_return_type insert(node_type&& nh)
+  {
+    auto r = ht_.insert_node_unique(mystl::move(nh));
+    return insert_return_type{ r.position, r.inserted, mystl::move(r.node) };
+  }
+  iterator  insert(const_iterator hint, node_type&& nh)
+  { return ht_.insert_node_unique(hint, mystl::move(nh)); }
+
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_map<Key, T, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_map<Key, T, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multimap<Key, T, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multimap<Key, T, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_unique(source.ht_); }
+
   void      swap(unordered_map& other) noexcept
   { ht_.swap(other.ht_); }
 
@@ -200,20 +299,11 @@ public:
     return it->second;
   }
 
+  // 键值不存在时插入一个值初始化的实值
   mapped_type& operator[](const key_type& key)
-  {
-    iterator it = ht_.find(key);
-    if (it.node == nullptr)
-      it = ht_.emplace_unique(key, T{}).first;
-    return it->second;
-  }
+  { return ht_.try_emplace_unique(key).first->second; }
   mapped_type& operator[](key_type&& key)
-  {
-    iterator it = ht_.find(key);
-    if (it.node == nullptr)
-      it = ht_.emplace_unique(mystl::move(key), T{}).first;
-    return it->second;
-  }
+  { return ht_.try_emplace_unique(mystl::move(key)).first->second; }
 
   size_type      count(const key_type& key) const 
   { return ht_.count(key); }
@@ -229,6 +319,39 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const
   { return ht_.equal_range_unique(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  // 异构查找，需要 Hash 与 KeyEqual 都声明 is_transparent，如 mystl::string_hash 与 mystl::equal_to<>
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_unique(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_unique(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -265,6 +388,15 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  // 渐进式 rehash：扩容时分多次插入搬移节点，避免单次插入的停顿
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+  bool      rehash_step(size_type n)                { return ht_.rehash_step(n); }
+
+  // 桶分布与内存占用，用于判断哈希函数是否适合这些键
+  ht_stats  stats()                  const          { return ht_.stats(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -280,24 +412,24 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
-          unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+          unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
@@ -307,14 +439,22 @@ void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multimap，键值允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
 // 参数四代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数五代表桶策略，缺省使用 mystl::ht_prime_policy，可换成 ht_power2_policy 或 ht_fastrange_policy
+// 参数六代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy, class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_multimap
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<pair<const Key, T>, Hash, KeyEqual> base_type;
+  typedef hashtable<pair<const Key, T>, Hash, KeyEqual, Policy, Alloc> base_type;
   base_type ht_;
 
+  template <class, class, class, class, class, class>
+  friend class unordered_map;
+  template <class, class, class, class, class, class>
+  friend class unordered_multimap;
+
 public:
   // 使用 hashtable 的型别
   typedef typename base_type::allocator_type       allocator_type;
@@ -336,6 +476,8 @@ public:
   typedef typename base_type::local_iterator       local_iterator;
   typedef typename base_type::const_local_iterator const_local_iterator;
 
+  typedef typename base_type::node_handle_type     node_type;
+
   allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -346,10 +488,16 @@ public:
   {
   }
 
+  explicit unordered_multimap(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_multimap(size_type bucket_count,
                               const Hash& hash = Hash(),
-                              const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal) 
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc) 
   {
   }
 
@@ -357,8 +505,9 @@ public:
   unordered_multimap(InputIterator first, InputIterator last,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -367,8 +516,9 @@ public:
   unordered_multimap(std::initializer_list<value_type> ilist,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -378,10 +528,18 @@ public:
     :ht_(rhs.ht_) 
   {
   }
+  unordered_multimap(const unordered_multimap& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_multimap(unordered_multimap&& rhs) noexcept
     :ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_multimap(unordered_multimap&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_multimap& operator=(const unordered_multimap& rhs)
   { 
@@ -468,6 +626,31 @@ public:
   void      clear()
   { ht_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配节点
+
+  node_type extract(const_iterator position)
+  { return ht_.extract(position); }
+  node_type extract(const key_type& key)
+  { return ht_.extract(key); }
+
+  iterator  insert(node_type&& nh)
+  { return ht_.insert_node_multi(mystl::move(nh)); }
+  iterator  insert(const_iterator hint, node_type&& nh)
+  { return ht_.insert_node_multi(hint, mystl::move(nh)); }
+
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multimap<Key, T, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multimap<Key, T, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_map<Key, T, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_map<Key, T, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_multi(source.ht_); }
+
   void      swap(unordered_multimap& other) noexcept 
   { ht_.swap(other.ht_); }
 
@@ -486,6 +669,39 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
   { return ht_.equal_range_multi(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  // 异构查找，需要 Hash 与 KeyEqual 都声明 is_transparent，如 mystl::string_hash 与 mystl::equal_to<>
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_multi(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_multi(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -522,6 +738,15 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  // 渐进式 rehash：扩容时分多次插入搬移节点，避免单次插入的停顿
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+  bool      rehash_step(size_type n)                { return ht_.rehash_step(n); }
+
+  // 桶分布与内存占用，用于判断哈希函数是否适合这些键
+  ht_stats  stats()                  const          { return ht_.stats(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -537,28 +762,55 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-          unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+void swap(unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& lhs,
+          unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// hashtable 的桶与节点都在堆上，哈希函数、比较函数与分配器可以按字节搬移时，整个容器也可以
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+struct is_trivially_relocatable<unordered_map<Key, T, Hash, KeyEqual, Policy, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Hash>::value &&
+                   is_trivially_relocatable<KeyEqual>::value &&
+                   is_trivially_relocatable<Policy>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class T, class Hash, class KeyEqual, class Policy, class Alloc>
+struct is_trivially_relocatable<unordered_multimap<Key, T, Hash, KeyEqual, Policy, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Hash>::value &&
+                   is_trivially_relocatable<KeyEqual>::value &&
+                   is_trivially_relocatable<Policy>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+namespace pmr
+{
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy>
+using unordered_map = mystl::unordered_map<Key, T, Hash, KeyEqual, Policy,
+                                           polymorphic_allocator<mystl::pair<const Key, T>>>;
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy>
+using unordered_multimap = mystl::unordered_multimap<Key, T, Hash, KeyEqual, Policy,
+                                                     polymorphic_allocator<mystl::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNORDERED_MAP_H_
 
@@ -17,17 +17,28 @@
 namespace mystl
 {
 
+template <class, class, class, class, class>
+class unordered_multiset;
+
 // 模板类 unordered_set，键值不允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数四代表桶策略，缺省使用 mystl::ht_prime_policy，可换成 ht_power2_policy 或 ht_fastrange_policy
+// 参数五代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy, class Alloc = mystl::allocator<Key>>
 class unordered_set
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<Key, Hash, KeyEqual> base_type;
+  typedef hashtable<Key, Hash, KeyEqual, Policy, Alloc> base_type;
   base_type ht_;
 
+  template <class, class, class, class, class>
+  friend class unordered_set;
+  template <class, class, class, class, class>
+  friend class unordered_multiset;
+
 public:
   // 使用 hashtable 的型别
   typedef typename base_type::allocator_type       allocator_type;
@@ -48,6 +59,9 @@ public:
   typedef typename base_type::const_local_iterator local_iterator;
   typedef typename base_type::const_local_iterator const_local_iterator;
 
+  typedef typename base_type::node_handle_type     node_type;
+  typedef mystl::node_insert_return<iterator, node_type> insert_return_type;
+
   allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -58,10 +72,16 @@ public:
   {
   }
 
+  explicit unordered_set(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_set(size_type bucket_count,
                          const Hash& hash = Hash(),
-                         const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -69,8 +89,9 @@ public:
   unordered_set(InputIterator first, InputIterator last,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -79,8 +100,9 @@ public:
   unordered_set(std::initializer_list<value_type> ilist,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -90,10 +112,18 @@ public:
     :ht_(rhs.ht_)
   {
   }
+  unordered_set(const unordered_set& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_set(unordered_set&& rhs) noexcept
     : ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_set(unordered_set&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_set& operator=(const unordered_set& rhs)
   {
@@ -156,12 +186,12 @@ public:
   pair<iterator, bool> insert(const value_type& value)
   { return ht_.insert_unique(value); }
   pair<iterator, bool> insert(value_type&& value)
-  { return ht_.emplace_unique(mystl::move(value)); }
+  { return ht_.insert_unique(mystl::move(value)); }
 
   iterator insert(const_iterator hint, const value_type& value)
   { return ht_.insert_unique_use_hint(hint, value); }
   iterator insert(const_iterator hint, value_type&& value)
-  { return ht_.emplace_unique_use_hint(hint, mystl::move(value)); }
+  { return ht_.insert_unique_use_hint(hint, mystl::move(value)); }
 
   template <class InputIterator>
   void insert(InputIterator first, InputIterator last)
@@ -180,6 +210,34 @@ public:
   void      clear()
   { ht_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配节点
+
+  node_type extract(const_iterator position)
+  { return ht_.extract(position); }
+  node_type extract(const key_type& key)
+  { return ht_.extract(key); }
+
+  insert_return_type insert(node_type&& nh)
+  {
+    auto r = ht_.insert_node_unique(mystl::move(nh));
+    return insert_return_type{ r.position, r.inserted, mystl::move(r.node) };
+  }
+  iterator  insert(const_iterator hint, node_type&& nh)
+  { return ht_.insert_node_unique(hint, mystl::move(nh)); }
+
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_set<Key, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_set<Key, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multiset<Key, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_unique(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multiset<Key, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_unique(source.ht_); }
+
   void      swap(unordered_set& other) noexcept
   { ht_.swap(other.ht_); }
 
@@ -198,6 +256,39 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const
   { return ht_.equal_range_unique(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  // 异构查找，需要 Hash 与 KeyEqual 都声明 is_transparent，如 mystl::string_hash 与 mystl::equal_to<>
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_unique(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_unique(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -234,6 +325,15 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  // 渐进式 rehash：扩容时分多次插入搬移节点，避免单次插入的停顿
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+  bool      rehash_step(size_type n)                { return ht_.rehash_step(n); }
+
+  // 桶分布与内存占用，用于判断哈希函数是否适合这些键
+  ht_stats  stats()                  const          { return ht_.stats(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -250,24 +350,24 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator==(const unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator!=(const unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
-          unordered_set<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+void swap(unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+          unordered_set<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
@@ -277,14 +377,22 @@ void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multiset，键值允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数四代表桶策略，缺省使用 mystl::ht_prime_policy，可换成 ht_power2_policy 或 ht_fastrange_policy
+// 参数五代表分配器类型，缺省使用 mystl::allocator
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy, class Alloc = mystl::allocator<Key>>
 class unordered_multiset
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<Key, Hash, KeyEqual> base_type;
+  typedef hashtable<Key, Hash, KeyEqual, Policy, Alloc> base_type;
   base_type ht_;
 
+  template <class, class, class, class, class>
+  friend class unordered_set;
+  template <class, class, class, class, class>
+  friend class unordered_multiset;
+
 public:
   // 使用 hashtable 的型别
   typedef typename base_type::allocator_type       allocator_type;
@@ -305,6 +413,8 @@ public:
   typedef typename base_type::const_local_iterator local_iterator;
   typedef typename base_type::const_local_iterator const_local_iterator;
 
+  typedef typename base_type::node_handle_type     node_type;
+
   allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -315,10 +425,16 @@ public:
   {
   }
 
+  explicit unordered_multiset(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_multiset(size_type bucket_count,
                               const Hash& hash = Hash(),
-                              const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -326,8 +442,9 @@ public:
   unordered_multiset(InputIterator first, InputIterator last,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -336,8 +453,9 @@ public:
   unordered_multiset(std::initializer_list<value_type> ilist,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -347,10 +465,18 @@ public:
     :ht_(rhs.ht_)
   {
   }
+  unordered_multiset(const unordered_multiset& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_multiset(unordered_multiset&& rhs) noexcept
     : ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_multiset(unordered_multiset&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_multiset& operator=(const unordered_multiset& rhs)
   {
@@ -438,6 +564,31 @@ public:
   void      clear()
   { ht_.clear(); }
 
+  // 节点句柄：取出的节点可以修改键值后插回，也可以插入另一个容器，不会分配节点
+
+  node_type extract(const_iterator position)
+  { return ht_.extract(position); }
+  node_type extract(const key_type& key)
+  { return ht_.extract(key); }
+
+  iterator  insert(node_type&& nh)
+  { return ht_.insert_node_multi(mystl::move(nh)); }
+  iterator  insert(const_iterator hint, node_type&& nh)
+  { return ht_.insert_node_multi(hint, mystl::move(nh)); }
+
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multiset<Key, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_multiset<Key, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_set<Key, Hash2, KeyEqual2, Policy2, Alloc>& source)
+  { ht_.merge_multi(source.ht_); }
+  template <class Hash2, class KeyEqual2, class Policy2>
+  void      merge(unordered_set<Key, Hash2, KeyEqual2, Policy2, Alloc>&& source)
+  { ht_.merge_multi(source.ht_); }
+
   void      swap(unordered_multiset& other) noexcept 
   { ht_.swap(other.ht_); }
 
@@ -456,6 +607,39 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const
   { return ht_.equal_range_multi(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  // 异构查找，需要 Hash 与 KeyEqual 都声明 is_transparent，如 mystl::string_hash 与 mystl::equal_to<>
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key) != ht_.end(); }
+
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_multi(key); }
+  template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+    mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_multi(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -492,6 +676,15 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  // 渐进式 rehash：扩容时分多次插入搬移节点，避免单次插入的停顿
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+  bool      rehash_step(size_type n)                { return ht_.rehash_step(n); }
+
+  // 桶分布与内存占用，用于判断哈希函数是否适合这些键
+  ht_stats  stats()                  const          { return ht_.stats(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -507,28 +700,53 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator==(const unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+bool operator!=(const unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_multiset<Key, Hash, KeyEqual>& lhs,
-          unordered_multiset<Key, Hash, KeyEqual>& rhs)
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+void swap(unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& lhs,
+          unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// hashtable 的桶与节点都在堆上，哈希函数、比较函数与分配器可以按字节搬移时，整个容器也可以
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+struct is_trivially_relocatable<unordered_set<Key, Hash, KeyEqual, Policy, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Hash>::value &&
+                   is_trivially_relocatable<KeyEqual>::value &&
+                   is_trivially_relocatable<Policy>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class Hash, class KeyEqual, class Policy, class Alloc>
+struct is_trivially_relocatable<unordered_multiset<Key, Hash, KeyEqual, Policy, Alloc>>
+  :m_bool_constant<is_trivially_relocatable<Hash>::value &&
+                   is_trivially_relocatable<KeyEqual>::value &&
+                   is_trivially_relocatable<Policy>::value &&
+                   is_trivially_relocatable<Alloc>::value> {};
+
+namespace pmr
+{
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy>
+using unordered_set = mystl::unordered_set<Key, Hash, KeyEqual, Policy, polymorphic_allocator<Key>>;
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Policy = mystl::ht_prime_policy>
+using unordered_multiset = mystl::unordered_multiset<Key, Hash, KeyEqual, Policy, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNORDERED_SET_H_
 
@@ -13,7 +13,7 @@ namespace mystl
 // move
 // 类型退化，返回右值引用
 template <class T>
-typename std::remove_reference<T>::type&& move(T&& arg) noexcept
+constexpr typename std::remove_reference<T>::type&& move(T&& arg) noexcept
 {
   return static_cast<typename std::remove_reference<T>::type&&>(arg);
 }
@@ -22,14 +22,14 @@ typename std::remove_reference<T>::type&& move(T&& arg) noexcept
 // 完美转发，保持参数的左右值属性
 // 如果参数是左值引用，则返回左值引用
 template <class T>
-T&& forward(typename std::remove_reference<T>::type& arg) noexcept
+constexpr T&& forward(typename std::remove_reference<T>::type& arg) noexcept
 {
   return static_cast<T&&>(arg);
 }
 
 // 如果参数是右值引用，则返回右值引用
 template <class T>
-T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
+constexpr T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
 {
   static_assert(!std::is_lvalue_reference<T>::value, "bad forward");
   return static_cast<T&&>(arg);
@@ -38,7 +38,7 @@ T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
 // swap
 
 template <class Tp>
-void swap(Tp& lhs, Tp& rhs)
+MYSTL_CONSTEXPR14 void swap(Tp& lhs, Tp& rhs)
 {
   auto tmp(mystl::move(lhs));
   lhs = mystl::move(rhs);
@@ -63,6 +63,34 @@ void swap(Tp(&a)[N], Tp(&b)[N])
 // --------------------------------------------------------------------------------------
 // pair
 
+// 构造标记：以第一个参数构造 first，其余参数全部用来就地构造 second
+// 供 map 类容器的 try_emplace / operator[] 在确定键值不存在后直接构造节点
+struct emplace_second_t
+{
+  explicit emplace_second_t() = default;
+};
+
+// emplace_key_kind<Key, Value, Args...> 表示关联容器 emplace 的参数能否不构造元素就取得键值
+// 0 : 不能，需要先构造节点
+// 1 : 只有一个参数，类型为 Value，键值由容器的 value_traits::get_key 取得
+// 2 : Value 与 Key 不同（map 类容器），有两个参数且第一个参数的类型为 Key，它就是键值
+template <class Key, class Value, class... Args>
+struct emplace_key_kind :public std::integral_constant<int, 0> {};
+
+template <class Key, class Value, class Arg>
+struct emplace_key_kind<Key, Value, Arg>
+  :public std::integral_constant<int,
+    std::is_same<typename std::decay<Arg>::type, Value>::value ? 1 : 0>
+{
+};
+
+template <class Key, class Value, class Arg1, class Arg2>
+struct emplace_key_kind<Key, Value, Arg1, Arg2>
+  :public std::integral_constant<int, !std::is_same<Key, Value>::value &&
+    std::is_same<typename std::decay<Arg1>::type, Key>::value ? 2 : 0>
+{
+};
+
 // 结构体模板 : pair
 // 两个模板参数分别表示两个数据的类型
 // 用 first 和 second 来分别取出第一个数据和第二个数据
@@ -114,6 +142,14 @@ struct pair
   pair(const pair& rhs) = default;
   pair(pair&& rhs) = default;
 
+  // 以 key 构造 first，以 args 就地构造 second
+  template <class Other1, class ...Args>
+  pair(emplace_second_t, Other1&& key, Args&& ...args)
+    : first(mystl::forward<Other1>(key)),
+    second(mystl::forward<Args>(args)...)
+  {
+  }
+
   // implicit constructiable for other type
   template <class Other1, class Other2,
     typename std::enable_if<
@@ -193,7 +229,7 @@ struct pair
   }
 
   // copy assign for this pair
-  pair& operator=(const pair& rhs)
+  MYSTL_CONSTEXPR14 pair& operator=(const pair& rhs)
   {
     if (this != &rhs)
     {
@@ -204,7 +240,7 @@ struct pair
   }
 
   // move assign for this pair
-  pair& operator=(pair&& rhs)
+  MYSTL_CONSTEXPR14 pair& operator=(pair&& rhs)
   {
     if (this != &rhs)
     {
@@ -216,7 +252,7 @@ struct pair
 
   // copy assign for other pair
   template <class Other1, class Other2>
-  pair& operator=(const pair<Other1, Other2>& other)
+  MYSTL_CONSTEXPR14 pair& operator=(const pair<Other1, Other2>& other)
   {
     first = other.first;
     second = other.second;
@@ -225,7 +261,7 @@ struct pair
 
   // move assign for other pair
   template <class Other1, class Other2>
-  pair& operator=(pair<Other1, Other2>&& other)
+  MYSTL_CONSTEXPR14 pair& operator=(pair<Other1, Other2>&& other)
   {
     first = mystl::forward<Other1>(other.first);
     second = mystl::forward<Other2>(other.second);
@@ -234,7 +270,7 @@ struct pair
 
   ~pair() = default;
 
-  void swap(pair& other)
+  MYSTL_CONSTEXPR14 void swap(pair& other)
   {
     if (this != &other)
     {
@@ -247,51 +283,51 @@ struct pair
 
 // 重载比较操作符 
 template <class Ty1, class Ty2>
-bool operator==(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator==(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return lhs.first == rhs.first && lhs.second == rhs.second;
 }
 
 template <class Ty1, class Ty2>
-bool operator<(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator<(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
 }
 
 template <class Ty1, class Ty2>
-bool operator!=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator!=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return !(lhs == rhs);
 }
 
 template <class Ty1, class Ty2>
-bool operator>(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator>(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return rhs < lhs;
 }
 
 template <class Ty1, class Ty2>
-bool operator<=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator<=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return !(rhs < lhs);
 }
 
 template <class Ty1, class Ty2>
-bool operator>=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+constexpr bool operator>=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
 template <class Ty1, class Ty2>
-void swap(pair<Ty1, Ty2>& lhs, pair<Ty1, Ty2>& rhs)
+MYSTL_CONSTEXPR14 void swap(pair<Ty1, Ty2>& lhs, pair<Ty1, Ty2>& rhs)
 {
   lhs.swap(rhs);
 }
 
 // 全局函数，让两个数据成为一个 pair
 template <class Ty1, class Ty2>
-pair<Ty1, Ty2> make_pair(Ty1&& first, Ty2&& second)
+constexpr pair<Ty1, Ty2> make_pair(Ty1&& first, Ty2&& second)
 {
   return pair<Ty1, Ty2>(mystl::forward<Ty1>(first), mystl::forward<Ty2>(second));
 }
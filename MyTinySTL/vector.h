@@ -6,6 +6,13 @@
 
 // notes:
 //
+// 1. 第三个模板参数 Growth 决定构造与扩容时分配的容量，缺省按 1.5 倍增长，
+//    也可以换成 vector_exact_growth 或 vector_page_growth；reserve 与 shrink_to_fit 总是恰好分配所要求的容量
+//    缺省构造的 vector 不分配内存，按大小或区间构造时恰好分配所需的容量，
+//    最小容量 VECTOR_MIN_CAPACITY 只在向空的 vector 插入元素、第一次扩容时起作用
+// 2. capacity_bytes() 与 slack_bytes() 给出单个 vector 占用与闲置的字节数，
+//    定义 MYSTL_VECTOR_STATS 为 1 时 vector_stats::snapshot() 给出进程中所有 vector 占用的字节数
+//
 // 异常保证：
 // mystl::vecotr<T> 满足基本异常保证，部分函数无异常保证，并对以下函数做强异常安全保证：
 //   * emplace
@@ -17,12 +24,15 @@
 //   * insert
 
 #include <initializer_list>
+#include <atomic>
+#include <cstdint>
 
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
 #include "exceptdef.h"
 #include "algo.h"
+#include "instrument.h"
 
 namespace mystl
 {
@@ -37,33 +47,175 @@ namespace mystl
 #undef min
 #endif // min
 
+// vector 的最小容量，缺省的增长策略使用
+#ifndef VECTOR_MIN_CAPACITY
+#define VECTOR_MIN_CAPACITY 16
+#endif
+
+// 是否统计进程中所有 vector 占用的空间
+#ifndef MYSTL_VECTOR_STATS
+#define MYSTL_VECTOR_STATS 0
+#endif
+
+// vector 的增长策略，作为 vector 的第三个模板参数
+// initial_capacity(n, elem_size)      : 构造含有 n 个元素的 vector 时分配的容量
+// next_capacity(cap, need, elem_size) : 容量为 cap 的 vector 至少需要 need 个元素的空间时，扩容后的容量
+// 返回值小于所需大小时按所需大小分配，超过 max_size() 时按 max_size() 分配
+
+// 按 Num / Den 倍增长，扩容后的容量至少为 Min，构造时恰好分配 n 个元素
+template <size_t Num, size_t Den, size_t Min = 0>
+struct vector_factor_growth
+{
+  static_assert(Den > 0 && Num > Den, "vector growth factor must be greater than 1");
+
+  static size_t initial_capacity(size_t n, size_t) noexcept
+  { return n; }
+
+  static size_t next_capacity(size_t cap, size_t need, size_t) noexcept
+  {
+    const size_t inc = cap / Den * (Num - Den) + cap % Den * (Num - Den) / Den;
+    const size_t grown = cap > static_cast<size_t>(-1) - inc ? need : cap + inc;
+    return mystl::max(mystl::max(grown, need), Min);
+  }
+};
+
+// 缺省的增长策略
+typedef vector_factor_growth<3, 2, VECTOR_MIN_CAPACITY> vector_default_growth;
+
+// 容量恰好等于所需大小，不留备用空间
+// 逐个 push_back 时每次都要重新分配，适合一次构造完成、之后很少插入的 vector
+struct vector_exact_growth
+{
+  static size_t initial_capacity(size_t n, size_t) noexcept
+  { return n; }
+
+  static size_t next_capacity(size_t, size_t need, size_t) noexcept
+  { return need; }
+};
+
+// 在 Base 的基础上，空间达到 Threshold 字节后把容量上调到 PageSize 字节的整数倍，
+// 使大块内存占满整页
+template <class Base = vector_default_growth, size_t PageSize = 4096, size_t Threshold = 64 * 1024>
+struct vector_page_growth
+{
+  static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0,
+                "the page size of vector_page_growth should be a power of 2");
+
+  static size_t initial_capacity(size_t n, size_t elem_size) noexcept
+  { return round_up(Base::initial_capacity(n, elem_size), elem_size); }
+
+  static size_t next_capacity(size_t cap, size_t need, size_t elem_size) noexcept
+  { return round_up(Base::next_capacity(cap, need, elem_size), elem_size); }
+
+  static size_t round_up(size_t cap, size_t elem_size) noexcept
+  {
+    if (cap > static_cast<size_t>(-1) / elem_size)
+      return cap;
+    const size_t bytes = cap * elem_size;
+    if (bytes < Threshold || bytes > static_cast<size_t>(-1) - PageSize)
+      return cap;
+    return ((bytes + PageSize - 1) & ~(PageSize - 1)) / elem_size;
+  }
+};
+
+// 所有 vector 占用空间的统计信息，由 vector_stats::snapshot() 返回
+struct vector_stats_snapshot
+{
+  size_t capacity_bytes;    // 当前所有 vector 的容量之和，以字节计
+  size_t allocate_count;    // 累计分配次数
+  size_t deallocate_count;  // 累计释放次数
+};
+
+// 统计进程中所有 vector 的分配与释放，MYSTL_VECTOR_STATS 为 0 时不做任何事
+class vector_stats
+{
+private:
+  struct counters
+  {
+    std::atomic<size_t> capacity_bytes;
+    std::atomic<size_t> allocate_count;
+    std::atomic<size_t> deallocate_count;
+  };
+
+  static counters& M_counters() noexcept
+  {
+    static counters c{ {0}, {0}, {0} };
+    return c;
+  }
+
+public:
+  static void record_allocate(size_t bytes) noexcept
+  {
+#if MYSTL_VECTOR_STATS
+    auto& c = M_counters();
+    c.capacity_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    c.allocate_count.fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)bytes;
+#endif
+  }
+
+  static void record_deallocate(size_t bytes) noexcept
+  {
+#if MYSTL_VECTOR_STATS
+    auto& c = M_counters();
+    c.capacity_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    c.deallocate_count.fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)bytes;
+#endif
+  }
+
+  static vector_stats_snapshot snapshot() noexcept
+  {
+    auto& c = M_counters();
+    vector_stats_snapshot result;
+    result.capacity_bytes = c.capacity_bytes.load(std::memory_order_relaxed);
+    result.allocate_count = c.allocate_count.load(std::memory_order_relaxed);
+    result.deallocate_count = c.deallocate_count.load(std::memory_order_relaxed);
+    return result;
+  }
+};
+
 // 模板类: vector 
-// 模板参数 T 代表类型
-template <class T>
+// 模板参数 T 代表类型，Alloc 代表分配器类型，缺省使用 mystl::allocator
+// Growth 代表增长策略，缺省使用 mystl::vector_default_growth
+template <class T, class Alloc = mystl::allocator<T>, class Growth = mystl::vector_default_growth>
 class vector
+  :private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
 {
   static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl");
 public:
   // vector 的嵌套型别定义
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>
+                                                   data_allocator;
+  typedef mystl::allocator_traits<data_allocator>  data_traits;
+
+  typedef T                                        value_type;
+  typedef typename data_traits::pointer            pointer;
+  typedef typename data_traits::const_pointer      const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef typename data_traits::size_type          size_type;
+  typedef typename data_traits::difference_type    difference_type;
 
   typedef value_type*                              iterator;
   typedef const value_type*                        const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return data_allocator(); }
+  typedef Growth                                   growth_policy;
+
+  allocator_type get_allocator() const { return allocator_type(M_alloc()); }
 
 private:
+  typedef mystl::alloc_holder<data_allocator>      alloc_base;
+  using alloc_base::M_alloc;
+
+  // 元素能否按字节搬移，决定扩容、插入与删除时移动元素的方式
+  typedef mystl::alloc_can_relocate<data_allocator, T> relocate_type;
+
   iterator begin_;  // 表示目前使用空间的头部
   iterator end_;    // 表示目前使用空间的尾部
   iterator cap_;    // 表示目前储存空间的尾部
@@ -73,47 +225,67 @@ public:
   vector() noexcept
   { try_init(); }
 
-  explicit vector(size_type n)
+  explicit vector(const allocator_type& alloc) noexcept
+    :alloc_base(data_allocator(alloc))
+  { try_init(); }
+
+  explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { fill_init(n, value_type()); }
 
-  vector(size_type n, const value_type& value)
+  vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   { fill_init(n, value); }
 
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
-  vector(Iter first, Iter last)
+  vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   {
     MYSTL_DEBUG(!(last < first));
     range_init(first, last);
   }
 
   vector(const vector& rhs)
+    :alloc_base(data_traits::select_on_container_copy_construction(rhs.M_alloc()))
+  {
+    range_init(rhs.begin_, rhs.end_);
+  }
+
+  vector(const vector& rhs, const allocator_type& alloc)
+    :alloc_base(data_allocator(alloc))
   {
     range_init(rhs.begin_, rhs.end_);
   }
 
   vector(vector&& rhs) noexcept
-    :begin_(rhs.begin_),
+    :alloc_base(mystl::move(rhs.M_alloc())),
+    begin_(rhs.begin_),
     end_(rhs.end_),
     cap_(rhs.cap_)
   {
     rhs.begin_ = nullptr;
     rhs.end_ = nullptr;
     rhs.cap_ = nullptr;
-    // rhs.cap_ = 0;
   }
 
-  vector(std::initializer_list<value_type> ilist)
+  // 分配器不相等时逐个移动元素
+  vector(vector&& rhs, const allocator_type& alloc);
+
+  vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :alloc_base(data_allocator(alloc))
   {
     range_init(ilist.begin(), ilist.end());
   }
 
   vector& operator=(const vector& rhs);
-  vector& operator=(vector&& rhs) noexcept;
+  vector& operator=(vector&& rhs)
+    noexcept(data_traits::propagate_on_container_move_assignment::value ||
+             data_traits::is_always_equal::value);
 
   vector& operator=(std::initializer_list<value_type> ilist)  // 初始化列表赋值运算符重载
   {
-    vector tmp(ilist.begin(), ilist.end());
+    vector tmp(ilist.begin(), ilist.end(), M_alloc());
     swap(tmp);
     return *this;
   }
@@ -159,13 +331,23 @@ public:
   { return begin_ == end_; }
   size_type size()     const noexcept
   { return static_cast<size_type>(end_ - begin_); }
+  // 总字节数不能超过 ptrdiff_t 的范围，否则 end_ - begin_ 会溢出
   size_type max_size() const noexcept
-  { return static_cast<size_type>(-1) / sizeof(T); }
+  {
+    return mystl::min(data_traits::max_size(M_alloc()),
+                      static_cast<size_type>(PTRDIFF_MAX) / sizeof(T));
+  }
   size_type capacity() const noexcept
   { return static_cast<size_type>(cap_ - begin_); }
   void      reserve(size_type n);
   void      shrink_to_fit();
 
+  // 容量占用的字节数，以及其中未被元素使用的字节数
+  size_type capacity_bytes() const noexcept
+  { return capacity() * sizeof(T); }
+  size_type slack_bytes()    const noexcept
+  { return static_cast<size_type>(cap_ - end_) * sizeof(T); }
+
   // 访问元素相关操作
   reference operator[](size_type n)
   {
@@ -179,12 +361,12 @@ public:
   }
   reference at(size_type n)
   {
-    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
     return (*this)[n];
   }
   const_reference at(size_type n) const
   {
-    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
     return (*this)[n];
   }
 
@@ -283,6 +465,10 @@ public:
 private:
   // helper functions
 
+  // allocate / deallocate
+  pointer   M_allocate(size_type n);
+  void      M_deallocate(pointer p, size_type n) noexcept;
+
   // initialize / destroy
   void      try_init() noexcept;
 
@@ -294,7 +480,12 @@ private:
 
   void      destroy_and_recover(iterator first, iterator last, size_type n);
 
+  // move assign
+  void      move_assign(vector& rhs, m_true_type) noexcept;
+  void      move_assign(vector& rhs, m_false_type);
+
   // calculate the growth size
+  size_type get_init_cap(size_type n) const noexcept;
   size_type get_new_cap(size_type add_size);
 
   // assign
@@ -307,6 +498,14 @@ private:
   template <class FIter>
   void      copy_assign(FIter first, FIter last, forward_iterator_tag);
 
+  // relocate
+
+  pointer   relocate_to(pointer new_begin, iterator pos, pointer gap, m_true_type) noexcept;
+  pointer   relocate_to(pointer new_begin, iterator pos, pointer gap, m_false_type);
+  void      relocate_around(iterator pos, size_type n, pointer new_begin, size_type new_cap);
+  void      open_gap(iterator pos, size_type n) noexcept;
+  void      close_gap(iterator pos, size_type n) noexcept;
+
   // reallocate
 
   template <class... Args>
@@ -315,6 +514,7 @@ private:
 
   // insert
 
+  void      insert_shift(iterator pos, value_type&& value);
   iterator  fill_insert(iterator pos, size_type n, const value_type& value);
   template <class IIter>
   void      copy_insert(iterator pos, IIter first, IIter last);
@@ -327,68 +527,91 @@ private:
 /*****************************************************************************************/
 
 // 复制赋值操作符
-template <class T>
-vector<T>& vector<T>::operator=(const vector& rhs)
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(const vector& rhs)
 {
   if (this != &rhs)
   {
+    if (data_traits::propagate_on_container_copy_assignment::value &&
+        !data_traits::equal(M_alloc(), rhs.M_alloc()))
+    { // 旧的空间必须由旧的分配器释放
+      destroy_and_recover(begin_, end_, cap_ - begin_);
+      begin_ = end_ = cap_ = nullptr;
+    }
+    mystl::alloc_copy_assign(M_alloc(), rhs.M_alloc(),
+                             typename data_traits::propagate_on_container_copy_assignment());
     const auto len = rhs.size();
     if (len > capacity())
     { 
-      vector tmp(rhs.begin(), rhs.end());
+      vector tmp(rhs.begin(), rhs.end(), M_alloc());
       swap(tmp);
     }
     else if (size() >= len)
     {
       auto i = mystl::copy(rhs.begin(), rhs.end(), begin());
-      data_allocator::destroy(i, end_);
+      data_traits::destroy(M_alloc(), i, end_);
       end_ = begin_ + len;
     }
     else
     { 
       mystl::copy(rhs.begin(), rhs.begin() + size(), begin_);
-      mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-      cap_ = end_ = begin_ + len;
+      mystl::uninitialized_copy_a(rhs.begin() + size(), rhs.end(), end_, M_alloc());
+      end_ = begin_ + len;
     }
   }
   return *this;
 }
 
 // 移动赋值操作符
-template <class T>
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector&& rhs)
+  noexcept(data_traits::propagate_on_container_move_assignment::value ||
+           data_traits::is_always_equal::value)
 {
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = rhs.begin_;
-  end_ = rhs.end_;
-  cap_ = rhs.cap_;
-  rhs.begin_ = nullptr;
-  rhs.end_ = nullptr;
-  rhs.cap_ = nullptr;
+  if (this != &rhs)
+  {
+    move_assign(rhs, m_bool_constant<
+                data_traits::propagate_on_container_move_assignment::value ||
+                data_traits::is_always_equal::value>());
+  }
   return *this;
 }
 
+// 带分配器的移动构造函数
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>::vector(vector&& rhs, const allocator_type& alloc)
+  :alloc_base(data_allocator(alloc)), begin_(nullptr), end_(nullptr), cap_(nullptr)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(cap_, rhs.cap_);
+  }
+  else
+  {
+    const size_type len = rhs.size();
+    init_space(len, get_init_cap(len));
+    mystl::uninitialized_move_a(rhs.begin_, rhs.end_, begin_, M_alloc());
+  }
+}
+
 // 预留空间大小，当原容量小于要求大小时，才会重新分配
-template <class T>
-void vector<T>::reserve(size_type n)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve(size_type n)
 {
   if (capacity() < n)
   {
     THROW_LENGTH_ERROR_IF(n > max_size(),
-                          "n can not larger than max_size() in vector<T>::reserve(n)");
-    const auto old_size = size();
-    auto tmp = data_allocator::allocate(n);
-    mystl::uninitialized_move(begin_, end_, tmp);
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = tmp;
-    end_ = tmp + old_size;
-    cap_ = begin_ + n;
+                          "n can not larger than max_size() in vector<T, Alloc>::reserve(n)");
+    auto tmp = M_allocate(n);
+    relocate_around(end_, 0, tmp, n);
   }
 }
 
 // 放弃多余的容量
-template <class T>
-void vector<T>::shrink_to_fit()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit()
 {
   if (end_ < cap_)
   {
@@ -397,27 +620,23 @@ void vector<T>::shrink_to_fit()
 }
 
 // 在 pos 位置就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-typename vector<T>::iterator
-vector<T>::emplace(const_iterator pos, Args&& ...args)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&& ...args)
 {
   MYSTL_DEBUG(pos >= begin() && pos <= end());
   iterator xpos = const_cast<iterator>(pos);
   const size_type n = xpos - begin_;
   if (end_ != cap_ && xpos == end_)
   {
-    data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+    data_traits::construct(M_alloc(), mystl::address_of(*end_), mystl::forward<Args>(args)...);
     ++end_;
   }
   else if (end_ != cap_)
   {
-    auto new_end = end_;
-    data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = value_type(mystl::forward<Args>(args)...);
-    end_ = new_end;
+    value_type tmp(mystl::forward<Args>(args)...);  // 参数可能引用容器中的元素，先构造出来
+    insert_shift(xpos, mystl::move(tmp));
   }
   else
   {
@@ -427,13 +646,13 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-void vector<T>::emplace_back(Args&& ...args)
+void vector<T, Alloc, Growth>::emplace_back(Args&& ...args)
 {
   if (end_ < cap_)
   {
-    data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+    data_traits::construct(M_alloc(), mystl::address_of(*end_), mystl::forward<Args>(args)...);
     ++end_;
   }
   else
@@ -443,12 +662,12 @@ void vector<T>::emplace_back(Args&& ...args)
 }
 
 // 在尾部插入元素
-template <class T>
-void vector<T>::push_back(const value_type& value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::push_back(const value_type& value)
 {
   if (end_ != cap_)
   {
-    data_allocator::construct(mystl::address_of(*end_), value);
+    data_traits::construct(M_alloc(), mystl::address_of(*end_), value);
     ++end_;
   }
   else
@@ -458,36 +677,31 @@ void vector<T>::push_back(const value_type& value)
 }
 
 // 弹出尾部元素
-template <class T>
-void vector<T>::pop_back()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::pop_back()
 {
   MYSTL_DEBUG(!empty());
-  data_allocator::destroy(end_ - 1);
+  data_traits::destroy(M_alloc(), end_ - 1);
   --end_;
 }
 
 // 在 pos 处插入元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, const value_type& value)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type& value)
 {
   MYSTL_DEBUG(pos >= begin() && pos <= end());
   iterator xpos = const_cast<iterator>(pos);
   const size_type n = pos - begin_;
   if (end_ != cap_ && xpos == end_)
   {
-    data_allocator::construct(mystl::address_of(*end_), value);
+    data_traits::construct(M_alloc(), mystl::address_of(*end_), value);
     ++end_;
   }
   else if (end_ != cap_)
   {
-    auto new_end = end_;
-    data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    auto value_copy = value;  // 避免元素因以下复制操作而被改变
-    mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = mystl::move(value_copy);
-    end_ = new_end;
+    value_type value_copy = value;  // 避免元素因以下移动操作而被改变
+    insert_shift(xpos, mystl::move(value_copy));
   }
   else
   {
@@ -497,34 +711,52 @@ vector<T>::insert(const_iterator pos, const value_type& value)
 }
 
 // 删除 pos 位置上的元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator pos)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos >= begin() && pos < end());
   iterator xpos = begin_ + (pos - begin());
-  mystl::move(xpos + 1, end_, xpos);
-  data_allocator::destroy(end_ - 1);
-  --end_;
+  if (relocate_type::value)
+  {
+    data_traits::destroy(M_alloc(), xpos);
+    close_gap(xpos, 1);
+  }
+  else
+  {
+    mystl::move(xpos + 1, end_, xpos);
+    data_traits::destroy(M_alloc(), end_ - 1);
+    --end_;
+  }
   return xpos;
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
 {
   MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
   const auto n = first - begin();
   iterator r = begin_ + (first - begin());
-  data_allocator::destroy(mystl::move(r + (last - first), end_, r), end_);
-  end_ = end_ - (last - first);
+  if (first == last)  // 空区间，空容器上 begin_ 为空指针，不能传给 memmove
+    return r;
+  if (relocate_type::value)
+  {
+    data_traits::destroy(M_alloc(), r, r + (last - first));
+    close_gap(r, last - first);
+  }
+  else
+  {
+    data_traits::destroy(M_alloc(), mystl::move(r + (last - first), end_, r), end_);
+    end_ = end_ - (last - first);
+  }
   return begin_ + n;
 }
 
 // 重置容器大小
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type& value)
 {
   if (new_size < size())
   {
@@ -537,11 +769,16 @@ void vector<T>::resize(size_type new_size, const value_type& value)
 }
 
 // 与另一个 vector 交换
-template <class T>
-void vector<T>::swap(vector<T>& rhs) noexcept
+// 分配器不随之交换时，两者的分配器必须相等
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::swap(vector<T, Alloc, Growth>& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(data_traits::propagate_on_container_swap::value ||
+                data_traits::equal(M_alloc(), rhs.M_alloc()));
+    mystl::alloc_swap(M_alloc(), rhs.M_alloc(),
+                      typename data_traits::propagate_on_container_swap());
     mystl::swap(begin_, rhs.begin_);
     mystl::swap(end_, rhs.end_);
     mystl::swap(cap_, rhs.cap_);
@@ -551,15 +788,42 @@ void vector<T>::swap(vector<T>& rhs) noexcept
 /*****************************************************************************************/
 // helper function
 
+// M_allocate 函数，分配 n 个元素的空间并计入统计
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::pointer
+vector<T, Alloc, Growth>::M_allocate(size_type n)
+{
+  auto p = data_traits::allocate(M_alloc(), n);
+  if (p != nullptr)
+    vector_stats::record_allocate(n * sizeof(T));
+  return p;
+}
+
+// M_deallocate 函数
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::M_deallocate(pointer p, size_type n) noexcept
+{
+  if (p != nullptr)
+    vector_stats::record_deallocate(n * sizeof(T));
+  data_traits::deallocate(M_alloc(), p, n);
+}
+
 // try_init 函数，若分配失败则忽略，不抛出异常
-template <class T>
-void vector<T>::try_init() noexcept
+// 增长策略给出的初始容量为 0 时不分配内存
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::try_init() noexcept
 {
+  begin_ = nullptr;
+  end_ = nullptr;
+  cap_ = nullptr;
   try
   {
-    begin_ = data_allocator::allocate(16);
+    const size_type cap = get_init_cap(0);
+    if (cap == 0)
+      return;
+    begin_ = M_allocate(cap);
     end_ = begin_;
-    cap_ = begin_ + 16;
+    cap_ = begin_ + cap;
   }
   catch (...)
   {
@@ -570,12 +834,12 @@ void vector<T>::try_init() noexcept
 }
 
 // init_space 函数
-template <class T>
-void vector<T>::init_space(size_type size, size_type cap)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::init_space(size_type size, size_type cap)
 {
   try
   {
-    begin_ = data_allocator::allocate(cap);
+    begin_ = M_allocate(cap);
     end_ = begin_ + size;
     cap_ = begin_ + cap;
   }
@@ -589,70 +853,105 @@ void vector<T>::init_space(size_type size, size_type cap)
 }
 
 // fill_init 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 fill_init(size_type n, const value_type& value)
 {
-  const size_type init_size = mystl::max(static_cast<size_type>(16), n);
-  init_space(n, init_size);
-  mystl::uninitialized_fill_n(begin_, n, value);
+  init_space(n, get_init_cap(n));
+  mystl::uninitialized_fill_n_a(begin_, n, value, M_alloc());
 }
 
 // range_init 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class Iter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 range_init(Iter first, Iter last)
 {
   const size_type len = mystl::distance(first, last);
-  const size_type init_size = mystl::max(len, static_cast<size_type>(16));
-  init_space(len, init_size);
-  mystl::uninitialized_copy(first, last, begin_);
+  init_space(len, get_init_cap(len));
+  mystl::uninitialized_copy_a(first, last, begin_, M_alloc());
 }
 
 // destroy_and_recover 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 destroy_and_recover(iterator first, iterator last, size_type n)
 {
-  data_allocator::destroy(first, last);
-  data_allocator::deallocate(first, n);
+  data_traits::destroy(M_alloc(), first, last);
+  M_deallocate(first, n);
+}
+
+// move_assign 函数
+// 可以接管 rhs 的空间：分配器随之移动，或者两者的分配器总是相等
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+move_assign(vector& rhs, m_true_type) noexcept
+{
+  destroy_and_recover(begin_, end_, cap_ - begin_);
+  mystl::alloc_move_assign(M_alloc(), rhs.M_alloc(),
+                           typename data_traits::propagate_on_container_move_assignment());
+  begin_ = rhs.begin_;
+  end_ = rhs.end_;
+  cap_ = rhs.cap_;
+  rhs.begin_ = nullptr;
+  rhs.end_ = nullptr;
+  rhs.cap_ = nullptr;
+}
+
+// 分配器不相等时，只能逐个移动元素
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+move_assign(vector& rhs, m_false_type)
+{
+  if (data_traits::equal(M_alloc(), rhs.M_alloc()))
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  vector tmp(mystl::move(rhs), M_alloc());
+  swap(tmp);
+}
+
+// get_init_cap 函数
+// 构造含有 n 个元素的 vector 时分配的容量，由增长策略决定
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type
+vector<T, Alloc, Growth>::
+get_init_cap(size_type n) const noexcept
+{
+  const size_type cap = Growth::initial_capacity(n, sizeof(T));
+  return cap < n ? n : mystl::min(cap, max_size());
 }
 
 // get_new_cap 函数
-template <class T>
-typename vector<T>::size_type 
-vector<T>::
+// 至少还需要 add_size 个元素的空间时扩容后的容量，由增长策略决定
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type 
+vector<T, Alloc, Growth>::
 get_new_cap(size_type add_size)
 {
-  const auto old_size = capacity();
+  const auto old_size = size();
   THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
-                        "vector<T>'s size too big");
-  if (old_size > max_size() - old_size / 2)
-  {
-    return old_size + add_size > max_size() - 16
-      ? old_size + add_size : old_size + add_size + 16;
-  }
-  const size_type new_size = old_size == 0
-    ? mystl::max(add_size, static_cast<size_type>(16))
-    : mystl::max(old_size + old_size / 2, old_size + add_size);
-  return new_size;
+                        "vector<T, Alloc>'s size too big");
+  const size_type need = old_size + add_size;
+  const size_type new_size = Growth::next_capacity(capacity(), need, sizeof(T));
+  return new_size < need ? need : mystl::min(new_size, max_size());
 }
 
 // fill_assign 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 fill_assign(size_type n, const value_type& value)
 {
   if (n > capacity())
   {
-    vector tmp(n, value);
+    vector tmp(n, value, M_alloc());
     swap(tmp);
   }
   else if (n > size())
   {
     mystl::fill(begin(), end(), value);
-    end_ = mystl::uninitialized_fill_n(end_, n - size(), value);
+    end_ = mystl::uninitialized_fill_n_a(end_, n - size(), value, M_alloc());
   }
   else
   {
@@ -661,9 +960,9 @@ fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_assign(IIter first, IIter last, input_iterator_tag)
 {
   auto cur = begin_;
@@ -683,21 +982,21 @@ copy_assign(IIter first, IIter last, input_iterator_tag)
 }
 
 // 用 [first, last) 为容器赋值
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class FIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_assign(FIter first, FIter last, forward_iterator_tag)
 {
   const size_type len = mystl::distance(first, last);
   if (len > capacity())
   {
-    vector tmp(first, last);
+    vector tmp(first, last, M_alloc());
     swap(tmp);
   }
   else if (size() >= len)
   {
     auto new_end = mystl::copy(first, last, begin_);
-    data_allocator::destroy(new_end, end_);
+    data_traits::destroy(M_alloc(), new_end, end_);
     end_ = new_end;
   }
   else
@@ -705,68 +1004,162 @@ copy_assign(FIter first, FIter last, forward_iterator_tag)
     auto mid = first;
     mystl::advance(mid, size());
     mystl::copy(first, mid, begin_);
-    auto new_end = mystl::uninitialized_copy(mid, last, end_);
+    auto new_end = mystl::uninitialized_copy_a(mid, last, end_, M_alloc());
     end_ = new_end;
   }
 }
 
+// relocate_to 函数
+// 把 [begin_, pos) 搬移到 new_begin 处，[pos, end_) 搬移到 gap 处，返回最后一个元素的下一位置
+// 元素可以按字节搬移时直接复制内存，原空间上的元素不再析构
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::pointer
+vector<T, Alloc, Growth>::
+relocate_to(pointer new_begin, iterator pos, pointer gap, m_true_type) noexcept
+{
+  mystl::uninitialized_relocate(begin_, pos, new_begin);
+  return mystl::uninitialized_relocate(pos, end_, gap);
+}
+
+// 否则逐个移动元素，全部移动成功后再析构原有元素，移动失败时原有元素保持不变
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::pointer
+vector<T, Alloc, Growth>::
+relocate_to(pointer new_begin, iterator pos, pointer gap, m_false_type)
+{
+  auto mid = mystl::uninitialized_move_a(begin_, pos, new_begin, M_alloc());
+  pointer new_end = gap;
+  try
+  {
+    new_end = mystl::uninitialized_move_a(pos, end_, gap, M_alloc());
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), new_begin, mid);
+    throw;
+  }
+  data_traits::destroy(M_alloc(), begin_, end_);
+  return new_end;
+}
+
+// relocate_around 函数
+// 新空间中 pos 对应位置起的 n 个元素已由调用者构造，把原有元素搬移到它们两侧，再换用新空间
+// 搬移失败时析构这 n 个元素并释放新空间，容器保持不变
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+relocate_around(iterator pos, size_type n, pointer new_begin, size_type new_cap)
+{
+  const auto gap = new_begin + (pos - begin_);
+  auto new_end = gap;
+  instrument::relocation(vector_reallocation, vector_bytes_moved, size() * sizeof(T));
+  try
+  {
+    new_end = relocate_to(new_begin, pos, gap + n, relocate_type());
+  }
+  catch (...)
+  {
+    data_traits::destroy(M_alloc(), gap, gap + n);
+    M_deallocate(new_begin, new_cap);
+    throw;
+  }
+  M_deallocate(begin_, cap_ - begin_);
+  begin_ = new_begin;
+  end_ = new_end;
+  cap_ = new_begin + new_cap;
+}
+
+// open_gap 函数
+// 元素可以按字节搬移时，把 [pos, end_) 后移 n 个位置，在 pos 处留出 n 个未初始化的空位
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+open_gap(iterator pos, size_type n) noexcept
+{
+  std::memmove(static_cast<void*>(pos + n), static_cast<const void*>(pos),
+               static_cast<size_type>(end_ - pos) * sizeof(T));
+  end_ += n;
+}
+
+// close_gap 函数
+// open_gap 的逆操作：[pos, pos + n) 上的元素已经析构，把后面的元素前移 n 个位置
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+close_gap(iterator pos, size_type n) noexcept
+{
+  std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + n),
+               static_cast<size_type>(end_ - pos - n) * sizeof(T));
+  end_ -= n;
+}
+
 // 重新分配空间并在当前元素 pos 处就地构造元素
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 reallocate_emplace(iterator pos, Args&& ...args)
 {
   const auto new_size = get_new_cap(1);
-  auto new_begin = data_allocator::allocate(new_size);
-  auto new_end = new_begin;
+  auto new_begin = M_allocate(new_size);
   try
-  {
-    new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::construct(mystl::address_of(*new_end), mystl::forward<Args>(args)...);
-    ++new_end;
-    new_end = mystl::uninitialized_move(pos, end_, new_end);
+  { // 先构造新元素，参数可能引用容器中的元素
+    data_traits::construct(M_alloc(), mystl::address_of(*(new_begin + (pos - begin_))),
+                           mystl::forward<Args>(args)...);
   }
   catch (...)
   {
-    data_allocator::deallocate(new_begin, new_size);
+    M_deallocate(new_begin, new_size);
     throw;
   }
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = new_begin;
-  end_ = new_end;
-  cap_ = new_begin + new_size;
+  relocate_around(pos, 1, new_begin, new_size);
 }
 
 // 重新分配空间并在 pos 处插入元素
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate_insert(iterator pos, const value_type& value)
 {
   const auto new_size = get_new_cap(1);
-  auto new_begin = data_allocator::allocate(new_size);
-  auto new_end = new_begin;
-  const value_type& value_copy = value;
+  auto new_begin = M_allocate(new_size);
   try
   {
-    new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::construct(mystl::address_of(*new_end), value_copy);
-    ++new_end;
-    new_end = mystl::uninitialized_move(pos, end_, new_end);
+    data_traits::construct(M_alloc(), mystl::address_of(*(new_begin + (pos - begin_))), value);
   }
   catch (...)
   {
-    data_allocator::deallocate(new_begin, new_size);
+    M_deallocate(new_begin, new_size);
     throw;
   }
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = new_begin;
-  end_ = new_end;
-  cap_ = new_begin + new_size;
+  relocate_around(pos, 1, new_begin, new_size);
+}
+
+// insert_shift 函数
+// 备用空间足够时，把 [pos, end_) 后移一个位置，再把 value 放到 pos 处
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::insert_shift(iterator pos, value_type&& value)
+{
+  if (relocate_type::value)
+  {
+    open_gap(pos, 1);
+    try
+    {
+      data_traits::construct(M_alloc(), mystl::address_of(*pos), mystl::move(value));
+    }
+    catch (...)
+    {
+      close_gap(pos, 1);
+      throw;
+    }
+  }
+  else
+  {
+    data_traits::construct(M_alloc(), mystl::address_of(*end_), mystl::move(*(end_ - 1)));
+    ++end_;
+    mystl::move_backward(pos, end_ - 2, end_ - 1);
+    *pos = mystl::move(value);
+  }
 }
 
 // fill_insert 函数
-template <class T>
-typename vector<T>::iterator 
-vector<T>::
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth>::
 fill_insert(iterator pos, size_type n, const value_type& value)
 {
   if (n == 0)
@@ -777,51 +1170,58 @@ fill_insert(iterator pos, size_type n, const value_type& value)
   { // 如果备用空间大于等于增加的空间
     const size_type after_elems = end_ - pos;
     auto old_end = end_;
+    if (relocate_type::value)
+    { // 元素可以按字节搬移时，直接把 pos 后面的元素整体后移，再在空位上构造
+      open_gap(pos, n);
+      try
+      {
+        mystl::uninitialized_fill_n_a(pos, n, value_copy, M_alloc());
+      }
+      catch (...)
+      {
+        close_gap(pos, n);
+        throw;
+      }
+    }
     // 如果 pos 后面的元素个数大于要插入的元素个数   
     // 直接向后扩展 n 个元素，再将要移动后面的元素 move 到 pos + n 后面
-    if (after_elems > n)
+    else if (after_elems > n)
     {
-      mystl::uninitialized_copy(end_ - n, end_, end_);
+      mystl::uninitialized_copy_a(end_ - n, end_, end_, M_alloc());
       end_ += n;
       mystl::move_backward(pos, old_end - n, old_end);
-      mystl::uninitialized_fill_n(pos, n, value_copy);
+      mystl::uninitialized_fill_n_a(pos, n, value_copy, M_alloc());
     }
     else
     {
       // 
-      end_ = mystl::uninitialized_fill_n(end_, n - after_elems, value_copy);
-      end_ = mystl::uninitialized_move(pos, old_end, end_);
-      mystl::uninitialized_fill_n(pos, after_elems, value_copy);
+      end_ = mystl::uninitialized_fill_n_a(end_, n - after_elems, value_copy, M_alloc());
+      end_ = mystl::uninitialized_move_a(pos, old_end, end_, M_alloc());
+      mystl::uninitialized_fill_n_a(pos, after_elems, value_copy, M_alloc());
     }
   }
   else
   { // 如果备用空间不足
     const auto new_size = get_new_cap(n);
-    auto new_begin = data_allocator::allocate(new_size);
-    auto new_end = new_begin;
+    auto new_begin = M_allocate(new_size);
     try
     {
-      new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-      new_end = mystl::uninitialized_fill_n(new_end, n, value);
-      new_end = mystl::uninitialized_move(pos, end_, new_end);
+      mystl::uninitialized_fill_n_a(new_begin + xpos, n, value_copy, M_alloc());
     }
     catch (...)
     {
-      destroy_and_recover(new_begin, new_end, new_size);
+      M_deallocate(new_begin, new_size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = new_begin;
-    end_ = new_end;
-    cap_ = begin_ + new_size;
+    relocate_around(pos, n, new_begin, new_size);
   }
   return begin_ + xpos;
 }
 
 // copy_insert 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_insert(iterator pos, IIter first, IIter last)
 {
   if (first == last)
@@ -831,111 +1231,116 @@ copy_insert(iterator pos, IIter first, IIter last)
   { // 如果备用空间大小足够
     const auto after_elems = end_ - pos;
     auto old_end = end_;
-    if (after_elems > n)
+    if (relocate_type::value)
+    {
+      open_gap(pos, n);
+      try
+      {
+        mystl::uninitialized_copy_a(first, last, pos, M_alloc());
+      }
+      catch (...)
+      {
+        close_gap(pos, n);
+        throw;
+      }
+    }
+    else if (after_elems > n)
     {
-      end_ = mystl::uninitialized_copy(end_ - n, end_, end_);
+      end_ = mystl::uninitialized_copy_a(end_ - n, end_, end_, M_alloc());
       mystl::move_backward(pos, old_end - n, old_end);
-      mystl::uninitialized_copy(first, last, pos);
+      mystl::uninitialized_copy_a(first, last, pos, M_alloc());
     }
     else
     {
       auto mid = first;
       mystl::advance(mid, after_elems);
-      end_ = mystl::uninitialized_copy(mid, last, end_);
-      end_ = mystl::uninitialized_move(pos, old_end, end_);
-      mystl::uninitialized_copy(first, mid, pos);
+      end_ = mystl::uninitialized_copy_a(mid, last, end_, M_alloc());
+      end_ = mystl::uninitialized_move_a(pos, old_end, end_, M_alloc());
+      mystl::uninitialized_copy_a(first, mid, pos, M_alloc());
     }
   }
   else
   { // 备用空间不足
     const auto new_size = get_new_cap(n);
-    auto new_begin = data_allocator::allocate(new_size);
-    auto new_end = new_begin;
+    auto new_begin = M_allocate(new_size);
     try
     {
-      new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-      new_end = mystl::uninitialized_copy(first, last, new_end);
-      new_end = mystl::uninitialized_move(pos, end_, new_end);
+      mystl::uninitialized_copy_a(first, last, new_begin + (pos - begin_), M_alloc());
     }
     catch (...)
     {
-      destroy_and_recover(new_begin, new_end, new_size);
+      M_deallocate(new_begin, new_size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = new_begin;
-    end_ = new_end;
-    cap_ = begin_ + new_size;
+    relocate_around(pos, n, new_begin, new_size);
   }
 }
 
 // reinsert 函数
-template <class T>
-void vector<T>::reinsert(size_type size)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reinsert(size_type size)
 {
-  auto new_begin = data_allocator::allocate(size);
-  try
-  {
-    mystl::uninitialized_move(begin_, end_, new_begin);
-  }
-  catch (...)
-  {
-    data_allocator::deallocate(new_begin, size);
-    throw;
-  }
-  data_allocator::deallocate(begin_, cap_ - begin_);
-  begin_ = new_begin;
-  end_ = begin_ + size;
-  cap_ = begin_ + size;
+  auto new_begin = M_allocate(size);
+  relocate_around(end_, 0, new_begin, size);
 }
 
 /*****************************************************************************************/
 // 重载比较操作符
 
-template <class T>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator==(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return lhs.size() == rhs.size() &&
     mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator<(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T>
-bool operator!=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator!=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator>(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator<=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator>=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(vector<T>& lhs, vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// vector 只保存指向堆上空间的指针，可以按字节搬移
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth>> :is_trivially_relocatable<Alloc> {};
+
+namespace pmr
+{
+template <class T>
+using vector = mystl::vector<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace mystl
 #endif // !MYTINYSTL_VECTOR_H_
 
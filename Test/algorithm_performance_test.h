@@ -1,11 +1,13 @@
 ﻿#ifndef MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 #define MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 
-// 仅仅针对 sort, binary_search 做了性能测试
+// 仅仅针对 sort, radix_sort, stable_sort, binary_search 以及并行 sort, stable_sort 做了性能测试
 
 #include <algorithm>
+#include <chrono>
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/execution.h"
 #include "test.h"
 
 namespace mystl
@@ -55,6 +57,69 @@ namespace algorithm_performance_test
     delete []arr;                                              \
 } while(0)
 
+// 生成不同分布的数据
+// 0 : 随机, 1 : 升序, 2 : 降序, 3 : 先升后降 (organ pipe), 4 : 只有 16 种取值
+inline void fill_distribution(int* arr, size_t count, int dist)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const int v = static_cast<int>(i);
+    switch (dist)
+    {
+    case 1:  arr[i] = v; break;
+    case 2:  arr[i] = static_cast<int>(count) - v; break;
+    case 3:  arr[i] = i < count / 2 ? v : static_cast<int>(count) - v; break;
+    case 4:  arr[i] = rand() % 16; break;
+    default: arr[i] = rand(); break;
+    }
+  }
+}
+
+#define SORT_DIST_TEST(mode, dist, count) do {                \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    int *arr = new int[count];                                 \
+    fill_distribution(arr, count, dist);                       \
+    start = clock();                                           \
+    mode::sort(arr, arr + count);                              \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+#define SORT_DIST_ROW(label, mode, dist) do {                 \
+    std::cout << label;                                        \
+    SORT_DIST_TEST(mode, dist, LEN1);                          \
+    SORT_DIST_TEST(mode, dist, LEN2);                          \
+    SORT_DIST_TEST(mode, dist, LEN3);                          \
+    std::cout << std::endl;                                    \
+} while(0)
+
+// 并行算法性能测试宏定义
+// 多线程下 clock() 统计的是所有线程的 CPU 时间，这里使用 steady_clock 统计实际经过的时间
+#define PAR_FUN_TEST(fun, pool, len) do {                  \
+    srand((int)time(0));                                   \
+    char buf[10];                                          \
+    int *arr = new int[len];                               \
+    for(size_t i = 0; i < len; ++i)  *(arr + i) = rand();  \
+    auto start = std::chrono::steady_clock::now();         \
+    mystl::fun(mystl::execution::par.on(pool), arr, arr + len); \
+    auto end = std::chrono::steady_clock::now();           \
+    int n = static_cast<int>(std::chrono::duration_cast<   \
+        std::chrono::milliseconds>(end - start).count());  \
+    std::snprintf(buf, sizeof(buf), "%d", n);              \
+    std::string t = buf;                                   \
+    t += "ms   |";                                         \
+    std::cout << std::setw(WIDE) << t;                     \
+    delete []arr;                                          \
+} while(0)
+
 void binary_search_test()
 {
   std::cout << "[------------------- function : binary_search ------------------]" << std::endl;
@@ -84,7 +149,71 @@ void sort_test()
   FUN_TEST1(mystl, sort, LEN1);
   FUN_TEST1(mystl, sort, LEN2);
   FUN_TEST1(mystl, sort, LEN3);
+  std::cout << std::endl << "|     radix_sort      |";
+  FUN_TEST1(mystl, radix_sort, LEN1);
+  FUN_TEST1(mystl, radix_sort, LEN2);
+  FUN_TEST1(mystl, radix_sort, LEN3);
   std::cout << std::endl;
+  std::cout << "[------------------ sort : data distributions ------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  SORT_DIST_ROW("|    std   sorted     |", std, 1);
+  SORT_DIST_ROW("|   mystl  sorted     |", mystl, 1);
+  SORT_DIST_ROW("|    std   reversed   |", std, 2);
+  SORT_DIST_ROW("|   mystl  reversed   |", mystl, 2);
+  SORT_DIST_ROW("|    std   organ pipe |", std, 3);
+  SORT_DIST_ROW("|   mystl  organ pipe |", mystl, 3);
+  SORT_DIST_ROW("|    std   few unique |", std, 4);
+  SORT_DIST_ROW("|   mystl  few unique |", mystl, 4);
+}
+
+// 线程数从 1 开始倍增到硬件并发数，观察并行算法的加速比
+#define PAR_SCALING_TEST(fun) do {                            \
+    const size_t hw = std::thread::hardware_concurrency();     \
+    const size_t max_threads = hw > 1 ? hw : 1;                \
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) \
+    {                                                          \
+      mystl::thread_pool pool(threads - 1);                    \
+      char label[32];                                          \
+      std::snprintf(label, sizeof(label), "%4d threads", static_cast<int>(threads)); \
+      std::cout << "|" << std::setw(16) << label << std::setw(6) << "|"; \
+      PAR_FUN_TEST(fun, pool, LEN1);                           \
+      PAR_FUN_TEST(fun, pool, LEN2);                           \
+      PAR_FUN_TEST(fun, pool, LEN3);                           \
+      std::cout << std::endl;                                  \
+    }                                                          \
+} while(0)
+
+void stable_sort_test()
+{
+  std::cout << "[------------------- function : stable_sort -------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|         std         |";
+  FUN_TEST1(std, stable_sort, LEN1);
+  FUN_TEST1(std, stable_sort, LEN2);
+  FUN_TEST1(std, stable_sort, LEN3);
+  std::cout << std::endl << "|        mystl        |";
+  FUN_TEST1(mystl, stable_sort, LEN1);
+  FUN_TEST1(mystl, stable_sort, LEN2);
+  FUN_TEST1(mystl, stable_sort, LEN3);
+  std::cout << std::endl;
+}
+
+void par_sort_test()
+{
+  std::cout << "[-------------------- function : par sort ----------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  PAR_SCALING_TEST(sort);
+}
+
+void par_stable_sort_test()
+{
+  std::cout << "[----------------- function : par stable_sort ------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  PAR_SCALING_TEST(stable_sort);
 }
 
 void algorithm_performance_test()
@@ -94,7 +223,10 @@ void algorithm_performance_test()
   std::cout << "[===============================================================]" << std::endl;
   std::cout << "[--------------- Run algorithm performance test ----------------]" << std::endl;
   sort_test();
+  stable_sort_test();
   binary_search_test();
+  par_sort_test();
+  par_stable_sort_test();
   std::cout << "[--------------- End algorithm performance test ----------------]" << std::endl;
   std::cout << "[===============================================================]" << std::endl;
 #endif // PERFORMANCE_TEST_ON
@@ -1,13 +1,18 @@
-#ifndef MYTINYSTL_ALGORITHM_TEST_H_
+﻿#ifndef MYTINYSTL_ALGORITHM_TEST_H_
 #define MYTINYSTL_ALGORITHM_TEST_H_
 
-// 算法测试: 包含了 mystl 的 81 个算法测试
+// 算法测试: 包含了 mystl 的 84 个算法测试与 8 个并行算法测试
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <numeric>
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/execution.h"
+#include "../MyTinySTL/list.h"
 #include "../MyTinySTL/vector.h"
 #include "test.h"
 
@@ -314,6 +319,29 @@ TEST(sort_heap_test)
   EXPECT_CON_EQ(arr3, arr4);
 }
 
+TEST(dary_heap_test)
+{
+  int arr1[] = { 6,1,9,3,7,2,8,5,4,0,11,10 };
+  int arr2[] = { 6,1,9,3,7,2,8,5,4,0,11,10 };
+  int arr3[] = { 6,1,9,3,7,2,8,5,4,0,11,10 };
+  std::sort(arr1, arr1 + 12);
+  mystl::make_dary_heap<4>(arr2, arr2 + 12);
+  EXPECT_TRUE(mystl::is_dary_heap<4>(arr2, arr2 + 12));
+  EXPECT_EQ(arr2[0], 11);
+  mystl::pop_dary_heap<4>(arr2, arr2 + 12);
+  EXPECT_TRUE(mystl::is_dary_heap<4>(arr2, arr2 + 11));
+  EXPECT_EQ(arr2[11], 11);
+  mystl::push_dary_heap<4>(arr2, arr2 + 12);
+  EXPECT_TRUE(mystl::is_dary_heap<4>(arr2, arr2 + 12));
+  mystl::sort_dary_heap<4>(arr2, arr2 + 12);
+  EXPECT_CON_EQ(arr1, arr2);
+  mystl::make_dary_heap<3>(arr3, arr3 + 12, std::greater<int>());
+  EXPECT_TRUE(mystl::is_dary_heap<3>(arr3, arr3 + 12, std::greater<int>()));
+  mystl::sort_dary_heap<3>(arr3, arr3 + 12, std::greater<int>());
+  std::reverse(arr1, arr1 + 12);
+  EXPECT_CON_EQ(arr1, arr3);
+}
+
 // set_algo test
 TEST(set_difference_test)
 {
@@ -383,6 +411,125 @@ TEST(set_union_test)
   EXPECT_CON_EQ(exp, act);
 }
 
+// 生成 n 个 [0, range) 中的有序整数，可能有重复
+std::vector<int> sorted_input(size_t n, unsigned range, unsigned seed)
+{
+  std::vector<int> v(n);
+  for (auto& x : v)
+  {
+    seed = seed * 1103515245u + 12345u;
+    x = static_cast<int>((seed >> 8) % range);
+  }
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+// 长度相差悬殊时使用跳跃查找，结果与 std 的逐个归并相同，包括重复元素的个数
+void set_gallop_check(const std::vector<int>& a, const std::vector<int>& b)
+{
+  const int* f1 = a.data();
+  const int* l1 = f1 + a.size();
+  const int* f2 = b.data();
+  const int* l2 = f2 + b.size();
+  std::vector<int> exp(a.size() + b.size()), act(a.size() + b.size());
+  auto e = std::set_union(f1, l1, f2, l2, exp.begin());
+  auto r = mystl::set_union(f1, l1, f2, l2, act.begin());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  e = std::set_intersection(f1, l1, f2, l2, exp.begin());
+  r = mystl::set_intersection(f1, l1, f2, l2, act.begin());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  e = std::set_difference(f1, l1, f2, l2, exp.begin());
+  r = mystl::set_difference(f1, l1, f2, l2, act.begin());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  e = std::set_difference(f2, l2, f1, l1, exp.begin());
+  r = mystl::set_difference(f2, l2, f1, l1, act.begin(), std::less<int>());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  e = std::set_symmetric_difference(f1, l1, f2, l2, exp.begin());
+  r = mystl::set_symmetric_difference(f1, l1, f2, l2, act.begin(), std::less<int>());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+}
+
+TEST(set_gallop_test)
+{
+  const size_t small[] = { 0, 1, 2, 5, 30 };
+  for (auto m : small)
+  {
+    for (unsigned range : { 50u, 100000u })
+    {
+      auto a = sorted_input(m, range, static_cast<unsigned>(m));
+      auto b = sorted_input(5000, range, 7);
+      set_gallop_check(a, b);
+      set_gallop_check(b, a);
+    }
+  }
+  // 双向迭代器逐个归并
+  mystl::list<int> l1 = { 1,2,2,3,5 }, l2 = { 2,3,3,4 };
+  int exp[9] = { 0 }, act[9] = { 0 };
+  std::set_union(l1.begin(), l1.end(), l2.begin(), l2.end(), exp);
+  mystl::set_union(l1.begin(), l1.end(), l2.begin(), l2.end(), act);
+  EXPECT_CON_EQ(exp, act);
+  // 降序
+  int d1[] = { 90,70,70,50 }, d2[100];
+  for (int i = 0; i < 100; ++i)
+    d2[i] = 99 - i;
+  std::set_intersection(d1, d1 + 4, d2, d2 + 100, exp, std::greater<int>());
+  mystl::set_intersection(d1, d1 + 4, d2, d2 + 100, act, std::greater<int>());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(set_intersection_unique_test)
+{
+  const size_t sizes[] = { 0, 1, 3, 4, 5, 8, 17, 100, 1000 };
+  for (auto n1 : sizes)
+  {
+    for (auto n2 : sizes)
+    {
+      std::vector<uint32_t> a, b;
+      for (size_t i = 0; i < n1; ++i)
+        a.push_back(static_cast<uint32_t>(i * 3 + 0x7ffffff0u));
+      for (size_t i = 0; i < n2; ++i)
+        b.push_back(static_cast<uint32_t>(i * 5 + 0x7ffffff0u));
+      std::vector<uint32_t> exp(n1 + n2), act(n1 + n2);
+      auto e = std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), exp.begin());
+      auto r = mystl::set_intersection_unique(a.data(), a.data() + n1,
+                                              b.data(), b.data() + n2, act.data());
+      EXPECT_TRUE(e - exp.begin() == r - act.data() && std::equal(exp.begin(), e, act.begin()));
+    }
+  }
+  int s1[] = { -7,-3,-1,0,2,4,6,8,10 }, s2[] = { -5,-3,0,1,2,3,10 }, out[7];
+  int expect[] = { -3,0,2,10 };
+  EXPECT_EQ(4, mystl::set_intersection_unique(s1, s1 + 9, s2, s2 + 7, out) - out);
+  EXPECT_TRUE(std::equal(expect, expect + 4, out));
+}
+
+TEST(set_many_test)
+{
+  typedef mystl::pair<const int*, const int*> range;
+  auto a = sorted_input(2000, 300, 1);
+  auto b = sorted_input(50, 300, 2);
+  auto c = sorted_input(500, 300, 3);
+  range lists[] = { range(a.data(), a.data() + a.size()), range(b.data(), b.data() + b.size()),
+                    range(c.data(), c.data() + c.size()) };
+  std::vector<int> t(a.size()), exp(a.size() + b.size() + c.size()), act(exp.size());
+  // 两两计算
+  auto te = std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), t.begin());
+  auto e = std::set_intersection(t.begin(), te, c.begin(), c.end(), exp.begin());
+  auto r = mystl::set_intersection_many(lists, lists + 3, act.begin());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  std::vector<int> u(a.size() + b.size());
+  auto ue = std::set_union(a.begin(), a.end(), b.begin(), b.end(), u.begin());
+  e = std::set_union(u.begin(), ue, c.begin(), c.end(), exp.begin());
+  r = mystl::set_union_many(lists, lists + 3, act.begin(), std::less<int>());
+  EXPECT_TRUE(e - exp.begin() == r - act.begin() && std::equal(exp.begin(), e, act.begin()));
+  // 一个区间与没有区间
+  r = mystl::set_union_many(lists + 1, lists + 2, act.begin());
+  EXPECT_TRUE(r - act.begin() == static_cast<ptrdiff_t>(b.size()) &&
+              std::equal(b.begin(), b.end(), act.begin()));
+  EXPECT_TRUE(act.begin() == mystl::set_intersection_many(lists, lists, act.begin()));
+  range with_empty[] = { lists[0], range(a.data(), a.data()) };
+  EXPECT_TRUE(act.begin() == mystl::set_intersection_many(with_empty, with_empty + 2, act.begin()));
+}
+
 // numeric test
 TEST(accumulate_test)
 {
@@ -447,6 +594,379 @@ TEST(partial_sum_test)
   EXPECT_CON_EQ(exp2, act2);
 }
 
+TEST(reduce_test)
+{
+  int arr1[] = { 1,2,3,4,5 };
+  EXPECT_EQ(15, mystl::reduce(arr1, arr1 + 5));
+  EXPECT_EQ(20, mystl::reduce(arr1, arr1 + 5, 5));
+  EXPECT_EQ(120, mystl::reduce(arr1, arr1 + 5, 1, std::multiplies<int>()));
+  mystl::vector<int> v(arr1, arr1 + 5);
+  EXPECT_EQ(15, mystl::reduce(v.begin(), v.end(), 0, mystl::plus<int>()));
+  EXPECT_EQ(0, mystl::reduce(arr1, arr1));
+}
+
+TEST(transform_reduce_test)
+{
+  int arr1[] = { 1,2,3,4,5 };
+  int arr2[] = { 2,2,2,2,2 };
+  EXPECT_EQ(std::inner_product(arr1, arr1 + 5, arr2, 0),
+            mystl::transform_reduce(arr1, arr1 + 5, arr2, 0));
+  EXPECT_EQ(std::inner_product(arr1, arr1 + 5, arr2, 1, std::plus<int>(), std::minus<int>()),
+            mystl::transform_reduce(arr1, arr1 + 5, arr2, 1, std::plus<int>(), std::minus<int>()));
+  EXPECT_EQ(55, mystl::transform_reduce(arr1, arr1 + 5, 0, std::plus<int>(),
+                                        [](int x) { return x * x; }));
+}
+
+// 数组的数值算法使用向量化版本，各种长度都要覆盖向量之外的尾部
+template <class T>
+void numeric_simd_check(size_t n)
+{
+  // 取值较小的整数，float 的和与前缀和也没有舍入误差
+  std::vector<T> a(n), b(n);
+  unsigned seed = static_cast<unsigned>(n) * 2654435761u + 1;
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    a[i] = static_cast<T>(static_cast<int>((seed >> 8) % 100) - 30);
+    b[i] = static_cast<T>((seed >> 20) % 50);
+  }
+  const T* first = a.data();
+  const T* last = first + n;
+  EXPECT_EQ(std::accumulate(first, last, T(3)), mystl::accumulate(first, last, T(3)));
+  EXPECT_EQ(std::accumulate(first, last, T(3)), mystl::reduce(first, last, T(3)));
+  EXPECT_EQ(std::inner_product(first, last, b.data(), T(1)),
+            mystl::inner_product(first, last, b.data(), T(1)));
+  EXPECT_EQ(std::inner_product(first, last, b.data(), T(1)),
+            mystl::transform_reduce(first, last, b.data(), T(1)));
+  std::vector<T> exp(n), act(n);
+  std::partial_sum(first, last, exp.begin());
+  EXPECT_TRUE(act.data() + n == mystl::partial_sum(first, last, act.data()));
+  EXPECT_CON_EQ(exp, act);
+  mystl::inclusive_scan(first, last, act.data());
+  EXPECT_CON_EQ(exp, act);
+  std::adjacent_difference(first, last, exp.begin());
+  EXPECT_TRUE(act.data() + n == mystl::adjacent_difference(first, last, act.data()));
+  EXPECT_CON_EQ(exp, act);
+  // 原地计算
+  act = a;
+  mystl::adjacent_difference(act.data(), act.data() + n, act.data());
+  EXPECT_CON_EQ(exp, act);
+  std::partial_sum(exp.begin(), exp.end(), exp.begin());
+  mystl::partial_sum(act.data(), act.data() + n, act.data());
+  EXPECT_CON_EQ(exp, act);
+  EXPECT_CON_EQ(a, act);
+}
+
+TEST(numeric_simd_test)
+{
+  const size_t sizes[] = { 0, 1, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 65, 100, 1000, 4099 };
+  for (auto n : sizes)
+  {
+    numeric_simd_check<int>(n);
+    numeric_simd_check<unsigned>(n);
+    numeric_simd_check<long long>(n);
+    numeric_simd_check<float>(n);
+    numeric_simd_check<double>(n);
+  }
+  // 整数溢出时按 2^n 取模，与逐个相加的结果相同
+  std::vector<unsigned> big(1000, 0xfffffff0u);
+  EXPECT_EQ(std::accumulate(big.data(), big.data() + big.size(), 7u),
+            mystl::accumulate(big.data(), big.data() + big.size(), 7u));
+}
+
+// 数组的 find、count、equal、mismatch 等使用向量化版本，把不同的值放在每一个位置上检查
+template <class T>
+void compare_simd_check(size_t n)
+{
+  std::vector<T> a(n), b;
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<T>(i % 7 + 1);
+  const T* first = a.data();
+  const T* last = first + n;
+  EXPECT_EQ(static_cast<size_t>(std::count(first, last, T(3))), mystl::count(first, last, T(3)));
+  EXPECT_EQ(std::adjacent_find(first, last), mystl::adjacent_find(first, last));
+  for (size_t i = 0; i < n; ++i)
+  {
+    b = a;
+    b[i] = T(0);
+    EXPECT_EQ(first + i, mystl::find(b.data(), b.data() + n, T(0)) - b.data() + first);
+    EXPECT_EQ(1u, mystl::count(b.data(), b.data() + n, T(0)));
+    EXPECT_FALSE(mystl::equal(first, last, b.data()));
+    EXPECT_EQ(i, static_cast<size_t>(mystl::mismatch(first, last, b.data()).first - first));
+    EXPECT_FALSE(mystl::lexicographical_compare(first, last, b.data(), b.data() + n));
+    EXPECT_TRUE(mystl::lexicographical_compare(b.data(), b.data() + n, first, last));
+    if (i + 1 < n)
+    {
+      b[i + 1] = T(0);
+      EXPECT_EQ(b.data() + i, mystl::adjacent_find(b.data(), b.data() + n));
+    }
+  }
+  b = a;
+  EXPECT_TRUE(mystl::equal(first, last, b.data()));
+  EXPECT_TRUE(last == mystl::mismatch(first, last, b.data()).first);
+  EXPECT_TRUE(last == mystl::find(first, last, T(0)));
+  EXPECT_FALSE(mystl::lexicographical_compare(first, last, b.data(), b.data() + n));
+  if (n > 0)
+    EXPECT_TRUE(mystl::lexicographical_compare(first, last - 1, b.data(), b.data() + n));
+}
+
+TEST(compare_simd_test)
+{
+  const size_t sizes[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 64, 100 };
+  for (auto n : sizes)
+  {
+    compare_simd_check<char>(n);
+    compare_simd_check<unsigned char>(n);
+    compare_simd_check<short>(n);
+    compare_simd_check<int>(n);
+    compare_simd_check<unsigned>(n);
+    compare_simd_check<long long>(n);
+    compare_simd_check<float>(n);
+    compare_simd_check<double>(n);
+  }
+  // 按通常的算术转换比较
+  mystl::vector<int> v(100, -1);
+  mystl::vector<unsigned short> us(100, 65535);
+  EXPECT_TRUE(v.end() == mystl::find(v.begin(), v.end(), 1LL << 32 | 0xffffffffLL));
+  EXPECT_TRUE(v.begin() == mystl::find(v.begin(), v.end(), 0xffffffffu));
+  EXPECT_EQ(100u, mystl::count(v.begin(), v.end(), -1LL));
+  EXPECT_EQ(0u, mystl::count(us.begin(), us.end(), -1));
+  EXPECT_TRUE(us.begin() == mystl::find(us.begin(), us.end(), 65535));
+  // NaN 与任何值都不相等，+0 与 -0 相等
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  double d1[] = { 1.0, 0.0, nan, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0 };
+  double d2[] = { 1.0, -0.0, nan, 2.0, 3.0, 4.0, 5.0, 6.0, 8.0 };
+  EXPECT_TRUE(d1 + 9 == mystl::find(d1, d1 + 9, nan));
+  EXPECT_TRUE(d1 + 1 == mystl::find(d1, d1 + 9, -0.0));
+  EXPECT_TRUE(d1 + 2 == mystl::mismatch(d1, d1 + 9, d2).first);
+  EXPECT_FALSE(mystl::equal(d1, d1 + 9, d1));
+  EXPECT_EQ(std::lexicographical_compare(d1, d1 + 9, d2, d2 + 9),
+            mystl::lexicographical_compare(d1, d1 + 9, d2, d2 + 9));
+  EXPECT_EQ(std::lexicographical_compare(d2, d2 + 9, d1, d1 + 9),
+            mystl::lexicographical_compare(d2, d2 + 9, d1, d1 + 9));
+  // 多字节字符的字符串
+  mystl::u16string s1(40, u'a'), s2(40, u'a');
+  s2[37] = u'b';
+  EXPECT_TRUE(s1.compare(s2) < 0);
+  EXPECT_TRUE(s2.compare(s1) > 0);
+  EXPECT_EQ(37u, s2.find(u'b'));
+  mystl::u32string s3(40, U'x');
+  EXPECT_TRUE(s3 == mystl::u32string(40, U'x'));
+  EXPECT_EQ(mystl::u32string::npos, s3.find(U'y'));
+}
+
+// 随机访问区间的 lower_bound 等使用无分支的二分查找，检查每个位置以及区间两端之外的值
+void bound_search_check(size_t n)
+{
+  std::vector<int> a(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<int>(i / 3 * 2);
+  const int* first = a.data();
+  const int* last = first + n;
+  const int hi = static_cast<int>(n / 3 * 2 + 2);
+  std::vector<int> keys;
+  for (int v = -1; v <= hi; ++v)
+  {
+    keys.push_back(v);
+    EXPECT_EQ(std::lower_bound(first, last, v), mystl::lower_bound(first, last, v));
+    EXPECT_EQ(std::upper_bound(first, last, v), mystl::upper_bound(first, last, v));
+    EXPECT_EQ(std::lower_bound(first, last, v, std::less<int>()),
+              mystl::lower_bound(first, last, v, std::less<int>()));
+    EXPECT_EQ(std::upper_bound(first, last, v, std::less<int>()),
+              mystl::upper_bound(first, last, v, std::less<int>()));
+    EXPECT_EQ(std::binary_search(first, last, v), mystl::binary_search(first, last, v));
+    auto p1 = std::equal_range(first, last, v);
+    auto p2 = mystl::equal_range(first, last, v);
+    EXPECT_EQ(p1.first, p2.first);
+    EXPECT_EQ(p1.second, p2.second);
+  }
+  std::vector<const int*> r1(keys.size()), r2(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    r1[i] = std::lower_bound(first, last, keys[i]);
+  EXPECT_TRUE(r2.data() + keys.size() ==
+              mystl::lower_bound_many(first, last, keys.begin(), keys.end(), r2.data()));
+  EXPECT_TRUE(r1 == r2);
+}
+
+// 大区间逐个比较后只报告一次结果，避免每个键都输出一行
+void bound_search_check_quiet(size_t n)
+{
+  std::vector<int> a(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<int>(i / 3 * 2);
+  const int* first = a.data();
+  const int* last = first + n;
+  const int hi = static_cast<int>(n / 3 * 2 + 2);
+  std::vector<int> keys;
+  bool same = true;
+  for (int v = -1; v <= hi; ++v)
+  {
+    keys.push_back(v);
+    auto p1 = std::equal_range(first, last, v);
+    auto p2 = mystl::equal_range(first, last, v);
+    same = same &&
+      std::lower_bound(first, last, v) == mystl::lower_bound(first, last, v) &&
+      std::upper_bound(first, last, v) == mystl::upper_bound(first, last, v) &&
+      std::lower_bound(first, last, v, std::less<int>()) ==
+      mystl::lower_bound(first, last, v, std::less<int>()) &&
+      std::upper_bound(first, last, v, std::less<int>()) ==
+      mystl::upper_bound(first, last, v, std::less<int>()) &&
+      std::binary_search(first, last, v) == mystl::binary_search(first, last, v) &&
+      p1.first == p2.first && p1.second == p2.second;
+  }
+  std::vector<const int*> r1(keys.size()), r2(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    r1[i] = std::lower_bound(first, last, keys[i]);
+  same = same && r2.data() + keys.size() ==
+    mystl::lower_bound_many(first, last, keys.begin(), keys.end(), r2.data());
+  EXPECT_TRUE(same && r1 == r2);
+}
+
+TEST(bound_search_test)
+{
+  for (size_t n = 0; n <= 64; ++n)
+    bound_search_check(n);
+  bound_search_check(97);
+  bound_search_check(127);
+  bound_search_check_quiet(1000);
+  // 超过 MYSTL_BOUND_PREFETCH_BYTES 的区间使用预取
+  bound_search_check_quiet(200000);
+  // 使用降序的比较函数
+  int arr1[] = { 9,7,7,5,3,1 };
+  EXPECT_EQ(std::lower_bound(arr1, arr1 + 6, 7, std::greater<int>()),
+            mystl::lower_bound(arr1, arr1 + 6, 7, std::greater<int>()));
+  EXPECT_EQ(std::upper_bound(arr1, arr1 + 6, 7, std::greater<int>()),
+            mystl::upper_bound(arr1, arr1 + 6, 7, std::greater<int>()));
+  EXPECT_TRUE(mystl::binary_search(arr1, arr1 + 6, 5, std::greater<int>()));
+  EXPECT_FALSE(mystl::binary_search(arr1, arr1 + 6, 4, std::greater<int>()));
+  int keys[] = { 10, 7, 4, 0 };
+  int* r[4];
+  mystl::lower_bound_many(arr1, arr1 + 6, keys, keys + 4, r, std::greater<int>());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(std::lower_bound(arr1, arr1 + 6, keys[i], std::greater<int>()), r[i]);
+}
+
+// deque 的迭代器是分段迭代器，copy / move / fill / find 等算法逐个缓冲区进行
+// 使用每个缓冲区只有 7 个元素的 deque，让区间的起止落在缓冲区内的各个位置上
+typedef mystl::deque<int, mystl::allocator<int>, mystl::deque_block_traits<7>> seg_deque;
+
+template <class Deque, class Vec>
+bool seg_same(const Deque& d, const Vec& v)
+{
+  return d.size() == v.size() && std::equal(v.begin(), v.end(), d.begin());
+}
+
+TEST(segmented_iterator_test)
+{
+  seg_deque d;
+  std::vector<int> v;
+  for (int i = 0; i < 100; ++i)
+  {
+    d.push_back(i % 13);
+    v.push_back(i % 13);
+  }
+  const int offs[] = { 0, 1, 6, 7, 8, 13, 14, 50, 93, 99, 100 };
+  for (auto f : offs)
+  {
+    for (auto l : offs)
+    {
+      if (l < f)  continue;
+      const seg_deque& cd = d;
+      for (int x = -1; x <= 13; ++x)
+      {
+        EXPECT_EQ(std::find(v.begin() + f, v.begin() + l, x) - v.begin(),
+                  mystl::find(cd.begin() + f, cd.begin() + l, x) - cd.begin());
+        EXPECT_EQ(std::count(v.begin() + f, v.begin() + l, x),
+                  static_cast<std::ptrdiff_t>(mystl::count(d.begin() + f, d.begin() + l, x)));
+      }
+      EXPECT_EQ(std::find_if(v.begin() + f, v.begin() + l, [](int x) { return x > 11; }) - v.begin(),
+                mystl::find_if(d.begin() + f, d.begin() + l, [](int x) { return x > 11; }) - d.begin());
+      int sum = 0;
+      mystl::for_each(d.begin() + f, d.begin() + l, [&sum](int x) { sum += x; });
+      EXPECT_EQ(std::accumulate(v.begin() + f, v.begin() + l, 0), sum);
+      // 指针 -> deque、deque -> 指针、deque -> deque
+      std::vector<int> buf(l - f);
+      EXPECT_EQ(buf.data() + (l - f), mystl::copy(d.begin() + f, d.begin() + l, buf.data()));
+      EXPECT_TRUE(std::equal(buf.begin(), buf.end(), v.begin() + f));
+      for (auto& x : buf)  x += 100;
+      seg_deque d2(d);
+      std::vector<int> v2(v);
+      std::copy(buf.begin(), buf.end(), v2.begin() + (100 - l));
+      EXPECT_TRUE(mystl::copy(buf.data(), buf.data() + buf.size(), d2.begin() + (100 - l)) ==
+                  d2.begin() + (100 - l + buf.size()));
+      EXPECT_TRUE(seg_same(d2, v2));
+      seg_deque d3(d);
+      std::vector<int> v3(v);
+      std::copy_backward(v2.begin() + f, v2.begin() + l, v3.begin() + l);
+      EXPECT_TRUE(mystl::copy_backward(d2.begin() + f, d2.begin() + l, d3.begin() + l) ==
+                  d3.begin() + f);
+      EXPECT_TRUE(seg_same(d3, v3));
+      // 同一个 deque 内重叠区间的左移与右移
+      const int s = (l - f) / 3 + 1;
+      if (l + s <= 100)
+      {
+        std::copy_backward(v3.begin() + f, v3.begin() + l, v3.begin() + l + s);
+        mystl::move_backward(d3.begin() + f, d3.begin() + l, d3.begin() + l + s);
+        EXPECT_TRUE(seg_same(d3, v3));
+      }
+      if (f >= s)
+      {
+        std::copy(v3.begin() + f, v3.begin() + l, v3.begin() + f - s);
+        mystl::move(d3.begin() + f, d3.begin() + l, d3.begin() + f - s);
+        EXPECT_TRUE(seg_same(d3, v3));
+      }
+      std::fill(v3.begin() + f, v3.begin() + l, 7);
+      mystl::fill(d3.begin() + f, d3.begin() + l, 7);
+      EXPECT_TRUE(seg_same(d3, v3));
+      std::fill_n(v3.begin() + f, l - f, -7);
+      EXPECT_TRUE(mystl::fill_n(d3.begin() + f, l - f, -7) == d3.begin() + l);
+      EXPECT_TRUE(seg_same(d3, v3));
+    }
+  }
+  // 单字节类型的 fill 逐段使用 memset
+  mystl::deque<char, mystl::allocator<char>, mystl::deque_block_traits<5>> dc(37, 'a');
+  mystl::fill(dc.begin() + 3, dc.end() - 4, 'z');
+  EXPECT_EQ(30, std::count(dc.begin(), dc.end(), 'z'));
+  EXPECT_EQ(30u, mystl::count(dc.begin(), dc.end(), 'z'));
+  EXPECT_TRUE(mystl::find(dc.begin(), dc.end(), 'z') == dc.begin() + 3);
+  // 不能按字节搬移的类型，区间插入与删除时逐段移动元素
+  mystl::deque<std::string, mystl::allocator<std::string>, mystl::deque_block_traits<5>> ds;
+  std::vector<std::string> vs;
+  for (int i = 0; i < 60; ++i)
+  {
+    ds.push_back(std::string(20, static_cast<char>('a' + i % 26)));
+    vs.push_back(std::string(20, static_cast<char>('a' + i % 26)));
+  }
+  ds.erase(ds.begin() + 3, ds.begin() + 17);
+  vs.erase(vs.begin() + 3, vs.begin() + 17);
+  EXPECT_TRUE(seg_same(ds, vs));
+  ds.erase(ds.begin() + 30, ds.begin() + 41);
+  vs.erase(vs.begin() + 30, vs.begin() + 41);
+  EXPECT_TRUE(seg_same(ds, vs));
+  ds.erase(ds.begin() + 2);
+  vs.erase(vs.begin() + 2);
+  ds.erase(ds.end() - 3);
+  vs.erase(vs.end() - 3);
+  EXPECT_TRUE(seg_same(ds, vs));
+  ds.insert(ds.begin() + 4, 9, std::string("xyz"));
+  vs.insert(vs.begin() + 4, 9, std::string("xyz"));
+  ds.insert(ds.end() - 2, 13, std::string("uvw"));
+  vs.insert(vs.end() - 2, 13, std::string("uvw"));
+  ds.insert(ds.begin() + 1, 20, std::string("pq"));
+  vs.insert(vs.begin() + 1, 20, std::string("pq"));
+  EXPECT_TRUE(seg_same(ds, vs));
+  const std::string arr[] = { "one", "two", "three", "four", "five", "six", "seven" };
+  ds.insert(ds.begin() + 10, arr, arr + 7);
+  vs.insert(vs.begin() + 10, arr, arr + 7);
+  ds.insert(ds.end() - 30, arr, arr + 7);
+  vs.insert(vs.end() - 30, arr, arr + 7);
+  ds.insert(ds.begin() + 2, arr, arr + 7);
+  vs.insert(vs.begin() + 2, arr, arr + 7);
+  ds.insert(ds.end() - 1, arr, arr + 7);
+  vs.insert(vs.end() - 1, arr, arr + 7);
+  EXPECT_TRUE(seg_same(ds, vs));
+}
+
 // algo test
 TEST(adjacent_find_test)
 {
@@ -860,6 +1380,25 @@ TEST(partition_copy_test)
   EXPECT_CON_EQ(exp_false, act_false);
 }
 
+TEST(stable_partition_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[] = { 1,2,3,4,5,6,7,8,9 };
+  mystl::list<int> l1(arr1, arr1 + 9);
+  std::stable_partition(arr1, arr1 + 9, is_odd);
+  auto it = mystl::stable_partition(arr2, arr2 + 9, is_odd);
+  EXPECT_CON_EQ(arr1, arr2);
+  EXPECT_EQ(arr2 + 5, it);
+  std::stable_partition(arr1, arr1 + 9, is_even);
+  mystl::stable_partition(arr2, arr2 + 9, is_even);
+  EXPECT_CON_EQ(arr1, arr2);
+  // 双向迭代器
+  int exp[] = { 2,4,6,8,1,3,5,7,9 };
+  auto it2 = mystl::stable_partition(l1.begin(), l1.end(), is_even);
+  EXPECT_EQ(4, mystl::distance(l1.begin(), it2));
+  EXPECT_CON_EQ(exp, l1);
+}
+
 TEST(prev_permutation_test)
 {
   int arr1[] = { 3,2,1,1 };
@@ -1096,6 +1635,78 @@ TEST(sort_test)
   EXPECT_CON_EQ(arr1, arr2);
   EXPECT_CON_EQ(arr3, arr4);
   EXPECT_CON_EQ(arr5, arr6);
+  // 升序、降序、先升后降、大量重复
+  for (int dist = 0; dist < 4; ++dist)
+  {
+    std::vector<int> v1(5000);
+    for (int i = 0; i < 5000; ++i)
+    {
+      v1[i] = dist == 0 ? i : dist == 1 ? 5000 - i : dist == 2 ? (i < 2500 ? i : 5000 - i) : i * 7919 % 5;
+    }
+    std::vector<int> v2(v1), v3(v1);
+    std::sort(v1.begin(), v1.end());
+    mystl::sort(&v2[0], &v2[0] + 5000);
+    EXPECT_CON_EQ(v1, v2);
+    std::sort(v1.begin(), v1.end(), std::greater<int>());
+    mystl::sort(&v3[0], &v3[0] + 5000, std::greater<int>());
+    EXPECT_CON_EQ(v1, v3);
+  }
+}
+
+TEST(stable_sort_test)
+{
+  int arr1[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  int arr2[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  std::stable_sort(arr1, arr1 + 14);
+  mystl::stable_sort(arr2, arr2 + 14);
+  EXPECT_CON_EQ(arr1, arr2);
+  // 高位为键，低位记录原来的位置
+  for (int dist = 0; dist < 4; ++dist)
+  {
+    std::vector<int> v1(5000);
+    for (int i = 0; i < 5000; ++i)
+    {
+      const int key = dist == 0 ? i * 7919 % 5000 : dist == 1 ? i / 3 : dist == 2 ? 5000 - i : i % 7;
+      v1[i] = key << 13 | i;
+    }
+    std::vector<int> v2(v1);
+    auto by_key = [](int a, int b) { return (a >> 13) < (b >> 13); };
+    std::stable_sort(v1.begin(), v1.end(), by_key);
+    mystl::stable_sort(&v2[0], &v2[0] + 5000, by_key);
+    EXPECT_CON_EQ(v1, v2);
+  }
+}
+
+TEST(radix_sort_test)
+{
+  int arr1[] = { 6,-1,2,5,-4,8,3,2,-4,6,10,2,1,9 };
+  int arr2[] = { 6,-1,2,5,-4,8,3,2,-4,6,10,2,1,9 };
+  double arr3[] = { 3.5,-0.5,2.25,-7.0,1e10,-1e-10,0.0,42.0 };
+  double arr4[] = { 3.5,-0.5,2.25,-7.0,1e10,-1e-10,0.0,42.0 };
+  std::sort(arr1, arr1 + 14);
+  mystl::radix_sort(arr2, arr2 + 14);
+  std::sort(arr3, arr3 + 8);
+  mystl::radix_sort(arr4, arr4 + 8);
+  EXPECT_CON_EQ(arr1, arr2);
+  EXPECT_CON_EQ(arr3, arr4);
+  // 按键排序是稳定的
+  std::vector<std::pair<unsigned, int>> v1, v2;
+  for (int i = 0; i < 5000; ++i)
+    v1.push_back(std::make_pair(static_cast<unsigned>(i * 7919 % 97), i));
+  v2 = v1;
+  std::stable_sort(v1.begin(), v1.end(),
+                   [](const std::pair<unsigned, int>& a, const std::pair<unsigned, int>& b)
+                   { return a.first < b.first; });
+  mystl::radix_sort(&v2[0], &v2[0] + v2.size(),
+                    [](const std::pair<unsigned, int>& a) { return a.first; });
+  EXPECT_TRUE(v1 == v2);
+  // 使用调用者提供的缓冲区
+  std::vector<std::pair<unsigned, int>> buf(v2.size());
+  mystl::radix_sort(&v2[0], &v2[0] + v2.size(), &buf[0],
+                    [](const std::pair<unsigned, int>& a) { return a.second; });
+  EXPECT_TRUE(std::is_sorted(v2.begin(), v2.end(),
+                             [](const std::pair<unsigned, int>& a, const std::pair<unsigned, int>& b)
+                             { return a.second < b.second; }));
 }
 
 TEST(swap_ranges_test)
@@ -1169,6 +1780,165 @@ TEST(upper_bound_test)
             mystl::upper_bound(arr1, arr1 + 9, 7, std::less<int>()));
 }
 
+
+// parallel test
+// 使用有 3 个工作线程的线程池，即使在单核机器上也会走并行的代码路径
+
+mystl::thread_pool& test_pool()
+{
+  static mystl::thread_pool pool(3);
+  return pool;
+}
+
+mystl::vector<int> random_ints(size_t n, int mod)
+{
+  mystl::vector<int> v(n);
+  unsigned seed = 12345;
+  for (auto& x : v)
+  {
+    seed = seed * 1103515245u + 12345u;
+    x = static_cast<int>((seed >> 8) % mod);
+  }
+  return v;
+}
+
+TEST(par_for_each_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> act = random_ints(100000, 1000);
+  std::vector<int> exp(act.begin(), act.end());
+  std::for_each(exp.begin(), exp.end(), [](int& x) { x = x * 2 + 1; });
+  mystl::for_each(pol, act.begin(), act.end(), [](int& x) { x = x * 2 + 1; });
+  EXPECT_CON_EQ(exp, act);
+  mystl::for_each(mystl::execution::seq, act.begin(), act.begin() + 10, [](int& x) { x = 0; });
+  EXPECT_EQ(0, act[9]);
+}
+
+TEST(par_transform_test)
+{
+  auto pol = mystl::execution::par_unseq.on(test_pool());
+  mystl::vector<int> v1 = random_ints(100000, 1000);
+  mystl::vector<int> v2 = random_ints(100000, 77);
+  mystl::vector<int> act(v1.size());
+  std::vector<int> exp(v1.size());
+  std::transform(v1.begin(), v1.end(), exp.begin(), unary_op);
+  EXPECT_TRUE(act.end() == mystl::transform(pol, v1.begin(), v1.end(), act.begin(), unary_op));
+  EXPECT_CON_EQ(exp, act);
+  std::transform(v1.begin(), v1.end(), v2.begin(), exp.begin(), binary_op);
+  mystl::transform(pol, v1.begin(), v1.end(), v2.begin(), act.begin(), binary_op);
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(par_count_if_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> v = random_ints(100000, 10);
+  EXPECT_EQ(std::count_if(v.begin(), v.end(), is_odd),
+            mystl::count_if(pol, v.begin(), v.end(), is_odd));
+  EXPECT_EQ(std::count(v.begin(), v.end(), 7),
+            mystl::count(pol, v.begin(), v.end(), 7));
+  EXPECT_EQ(std::count(v.begin(), v.end(), 7),
+            mystl::count(mystl::execution::seq, v.begin(), v.end(), 7));
+}
+
+TEST(par_reduce_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> v = random_ints(100000, 1000);
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0),
+            mystl::reduce(pol, v.begin(), v.end()));
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), 10LL),
+            mystl::reduce(pol, v.begin(), v.end(), 10LL));
+  EXPECT_EQ(*std::max_element(v.begin(), v.end()),
+            mystl::reduce(pol, v.begin(), v.end(), 0,
+                          [](int a, int b) { return a < b ? b : a; }));
+  EXPECT_EQ(0, mystl::reduce(pol, v.begin(), v.begin()));
+}
+
+TEST(par_inclusive_scan_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> v = random_ints(100000, 100);
+  mystl::vector<int> act(v.size());
+  std::vector<int> exp(v.size());
+  std::partial_sum(v.begin(), v.end(), exp.begin());
+  EXPECT_TRUE(act.end() == mystl::inclusive_scan(pol, v.begin(), v.end(), act.begin()));
+  EXPECT_CON_EQ(exp, act);
+  mystl::fill(act.begin(), act.end(), 0);
+  mystl::inclusive_scan(mystl::execution::seq, v.begin(), v.end(), act.begin());
+  EXPECT_CON_EQ(exp, act);
+  for (auto& x : exp)
+    x += 5;
+  mystl::inclusive_scan(pol, v.begin(), v.end(), act.begin(), mystl::plus<int>(), 5);
+  EXPECT_CON_EQ(exp, act);
+  // 原地计算
+  std::partial_sum(v.begin(), v.end(), exp.begin());
+  mystl::inclusive_scan(pol, v.begin(), v.end(), v.begin(), binary_op);
+  EXPECT_CON_EQ(exp, v);
+}
+
+TEST(par_sort_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> act = random_ints(200000, 1 << 30);
+  std::vector<int> exp(act.begin(), act.end());
+  std::sort(exp.begin(), exp.end());
+  mystl::sort(pol, act.begin(), act.end());
+  EXPECT_CON_EQ(exp, act);
+  act = random_ints(200000, 16);
+  exp.assign(act.begin(), act.end());
+  std::sort(exp.begin(), exp.end(), std::greater<int>());
+  mystl::sort(pol, act.begin(), act.end(), std::greater<int>());
+  EXPECT_CON_EQ(exp, act);
+  mystl::sort(pol, act.begin(), act.end());
+  EXPECT_TRUE(mystl::is_sorted(act.begin(), act.end()));
+  act = random_ints(200000, 1000);
+  exp.assign(act.begin(), act.end());
+  std::sort(exp.begin(), exp.end());
+  mystl::sort(mystl::execution::seq, act.begin(), act.end());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(par_stable_sort_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  // 按高位排序，低位记录原来的顺序
+  mystl::vector<int> v = random_ints(100000, 64);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = v[i] << 20 | static_cast<int>(i);
+  auto by_key = [](int a, int b) { return (a >> 20) < (b >> 20); };
+  mystl::vector<int> act(v);
+  std::vector<int> exp(v.begin(), v.end());
+  std::stable_sort(exp.begin(), exp.end(), by_key);
+  mystl::stable_sort(pol, act.begin(), act.end(), by_key);
+  EXPECT_CON_EQ(exp, act);
+  act = v;
+  mystl::stable_sort(mystl::execution::seq, act.begin(), act.end(), by_key);
+  EXPECT_CON_EQ(exp, act);
+  mystl::stable_sort(pol, act.begin(), act.end());
+  EXPECT_TRUE(std::is_sorted(act.begin(), act.end()));
+}
+
+TEST(par_list_sort_test)
+{
+  auto pol = mystl::execution::par.on(test_pool());
+  mystl::vector<int> v = random_ints(100000, 64);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = v[i] << 20 | static_cast<int>(i);
+  auto by_key = [](int a, int b) { return (a >> 20) < (b >> 20); };
+  std::vector<int> exp(v.begin(), v.end());
+  std::stable_sort(exp.begin(), exp.end(), by_key);
+  mystl::list<int> l(v.begin(), v.end());
+  mystl::sort(pol, l, by_key);
+  EXPECT_EQ(v.size(), l.size());
+  EXPECT_TRUE(mystl::equal(l.begin(), l.end(), exp.data()));
+  mystl::sort(pol, l);
+  EXPECT_TRUE(mystl::is_sorted(l.begin(), l.end()));
+  mystl::list<int> l2(v.begin(), v.end());
+  mystl::sort(mystl::execution::seq, l2, by_key);
+  EXPECT_TRUE(mystl::equal(l2.begin(), l2.end(), exp.data()));
+}
+
 } // namespace algorithm_test
 
 #ifdef _MSC_VER
@@ -0,0 +1,329 @@
+﻿#ifndef MYTINYSTL_ALLOC_TEST_H_
+#define MYTINYSTL_ALLOC_TEST_H_
+
+// alloc test : 测试 alloc, pool_allocator 的接口，多线程下的归还，有状态分配器在各容器中的传播，
+// node_pool_allocator 在 list、map 中的使用，并与 mystl::allocator 比较节点大小的内存分配与释放性能，
+// 以及 list 建立、遍历、清空的性能
+
+#include <thread>
+
+#include "../MyTinySTL/alloc.h"
+#include "../MyTinySTL/node_pool.h"
+#include "../MyTinySTL/allocator.h"
+#include "../MyTinySTL/vector.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/unordered_set.h"
+#include "../MyTinySTL/astring.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace alloc_test
+{
+
+// 模拟节点的分配与释放：先分配 len 个大小为 sizeof(node) 的区块，再按分配顺序释放，重复两轮
+#define ALLOC_DO_TEST(alloc_type, node, len) do {            \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<node*> v(len);                               \
+  start = clock();                                           \
+  for (int round = 0; round < 2; ++round)                    \
+  {                                                          \
+    for (size_t i = 0; i < len; ++i)                         \
+      v[i] = alloc_type<node>::allocate();                   \
+    for (size_t i = 0; i < len; ++i)                         \
+      alloc_type<node>::deallocate(v[i]);                    \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define ALLOC_TEST(node, len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|      allocator      |";                    \
+  ALLOC_DO_TEST(mystl::allocator, node, len1);               \
+  ALLOC_DO_TEST(mystl::allocator, node, len2);               \
+  ALLOC_DO_TEST(mystl::allocator, node, len3);               \
+  std::cout << "\n|   pool_allocator    |";                  \
+  ALLOC_DO_TEST(mystl::pool_allocator, node, len1);          \
+  ALLOC_DO_TEST(mystl::pool_allocator, node, len2);          \
+  ALLOC_DO_TEST(mystl::pool_allocator, node, len3);
+
+// 建立有 len 个元素的 list，遍历求和后清空，重复两轮
+#define LIST_POOL_DO_TEST(alloc_type, len) do {              \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  mystl::list<size_t, alloc_type<size_t>> l;                 \
+  for (int round = 0; round < 2; ++round)                    \
+  {                                                          \
+    for (size_t i = 0; i < len; ++i)                         \
+      l.push_back(i);                                        \
+    for (auto x : l)                                         \
+      sum += x;                                              \
+    l.clear();                                               \
+  }                                                          \
+  end = clock();                                             \
+  if (sum != static_cast<size_t>(len) * (len - 1))           \
+    std::cout << "error";                                    \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define LIST_POOL_TEST(len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|      allocator      |";                    \
+  LIST_POOL_DO_TEST(mystl::allocator, len1);                 \
+  LIST_POOL_DO_TEST(mystl::allocator, len2);                 \
+  LIST_POOL_DO_TEST(mystl::allocator, len3);                 \
+  std::cout << "\n| node_pool_allocator |";                  \
+  LIST_POOL_DO_TEST(mystl::node_pool_allocator, len1);       \
+  LIST_POOL_DO_TEST(mystl::node_pool_allocator, len2);       \
+  LIST_POOL_DO_TEST(mystl::node_pool_allocator, len3);
+
+// 有状态的分配器：每个实例带有编号，并统计经由它分配而尚未归还的字节数
+// 编号不同的实例互不相等，交换容器时分配器随之交换，移动赋值时不传播
+template <class T>
+class counting_allocator
+{
+public:
+  typedef T            value_type;
+  typedef m_true_type  propagate_on_container_swap;
+  typedef m_false_type propagate_on_container_move_assignment;
+
+  int     id;
+  size_t* live;
+
+  counting_allocator(int i, size_t* l) noexcept :id(i), live(l) {}
+  template <class U>
+  counting_allocator(const counting_allocator<U>& rhs) noexcept :id(rhs.id), live(rhs.live) {}
+
+  T* allocate(size_t n)
+  {
+    *live += n * sizeof(T);
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t n)
+  {
+    *live -= n * sizeof(T);
+    ::operator delete(p);
+  }
+};
+
+template <class T, class U>
+bool operator==(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+{ return lhs.id == rhs.id; }
+
+template <class T, class U>
+bool operator!=(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+{ return lhs.id != rhs.id; }
+
+typedef counting_allocator<int>                           int_alloc;
+typedef counting_allocator<char>                          char_alloc;
+typedef counting_allocator<mystl::pair<const int, int>>   pair_alloc;
+typedef mystl::vector<int, int_alloc>                     counted_vector;
+typedef mystl::deque<int, int_alloc>                      counted_deque;
+typedef mystl::list<int, int_alloc>                       counted_list;
+typedef mystl::map<int, int, mystl::less<int>, pair_alloc> counted_map;
+typedef mystl::unordered_set<int, mystl::hash<int>, mystl::equal_to<int>,
+  mystl::ht_prime_policy, int_alloc>                      counted_uset;
+typedef mystl::basic_string<char, mystl::char_traits<char>, char_alloc> counted_string;
+typedef mystl::list<int, mystl::pool_allocator<int>>      pool_list;
+
+// 各容器通过分配器申请与归还内存，容器析构后统计的字节数应归零
+void stateful_alloc_test()
+{
+  size_t live1 = 0, live2 = 0;
+  {
+    counted_vector v1(10, 1, int_alloc(1, &live1));
+    counted_vector v2(5, 2, int_alloc(2, &live2));
+    FUN_VALUE(live1);
+    FUN_VALUE(live2);
+    v1.swap(v2);
+    FUN_VALUE(v1.get_allocator().id);
+    FUN_VALUE(v2.get_allocator().id);
+    counted_vector v3(v1);
+    FUN_VALUE(v3.get_allocator().id);
+    counted_vector v4(int_alloc(1, &live1));
+    v4 = mystl::move(v3);
+    FUN_VALUE(v4.get_allocator().id);
+    FUN_VALUE(v4.size());
+
+    counted_deque d(v2.begin(), v2.end(), int_alloc(1, &live1));
+    counted_list l(v1.begin(), v1.end(), int_alloc(2, &live2));
+    counted_map m(mystl::less<int>(), pair_alloc(1, &live1));
+    for (int i = 0; i < 100; ++i)
+      m.emplace(i, i);
+    counted_uset us(v2.begin(), v2.end(), 10, mystl::hash<int>(),
+                    mystl::equal_to<int>(), int_alloc(2, &live2));
+    counted_string s("mytinystl", char_alloc(1, &live1));
+    s += s;
+    FUN_VALUE(d.size());
+    FUN_VALUE(l.size());
+    FUN_VALUE(m.size());
+    FUN_VALUE(us.size());
+    FUN_VALUE(s);
+    std::cout << std::boolalpha;
+    FUN_VALUE((d.get_allocator() == v2.get_allocator()));
+    std::cout << std::noboolalpha;
+  }
+  FUN_VALUE(live1);
+  FUN_VALUE(live2);
+
+  pool_list pl{ 1,2,3,4,5 };
+  pl.sort(mystl::greater<int>());
+  FUN_VALUE(pl.front());
+  FUN_VALUE(pl.size());
+}
+
+typedef mystl::list<int, mystl::node_pool_allocator<int>>           slab_list;
+typedef mystl::node_pool_allocator<mystl::pair<const int, int>>      slab_pair_alloc;
+typedef mystl::map<int, int, mystl::less<int>, slab_pair_alloc>      slab_map;
+
+// 节点来自容器独占的 slab，平凡析构的元素在 clear 与析构时一次归还全部 slab
+void node_pool_test()
+{
+  slab_list l1;
+  for (int i = 0; i < 2000; ++i)
+    l1.push_back(i);
+  const mystl::node_pool* pool = l1.get_allocator().pool();
+  FUN_VALUE(pool->slab_count());
+  FUN_VALUE(pool->slab_bytes());
+  l1.erase(l1.begin(), l1.end());
+  for (int i = 0; i < 2000; ++i)
+    l1.push_front(i);
+  FUN_VALUE(pool->slab_count());
+  FUN_VALUE(l1.front());
+  l1.clear();
+  FUN_VALUE(pool->slab_count());
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.assign({ 5,3,1,4,2 }));
+  FUN_AFTER(l1, l1.sort());
+
+  // 复制时使用新的 node_pool，移动时 node_pool 随之转移，共用 node_pool 的 list 之间可以 splice
+  slab_list l2(l1);
+  slab_list l3(l1.get_allocator());
+  l3.push_back(6);
+  std::cout << std::boolalpha;
+  FUN_VALUE((l2.get_allocator() == l1.get_allocator()));
+  FUN_VALUE((l3.get_allocator() == l1.get_allocator()));
+  std::cout << std::noboolalpha;
+  FUN_AFTER(l1, l1.splice(l1.end(), l3));
+  l2 = mystl::move(l1);
+  FUN_VALUE(l2.size());
+  FUN_VALUE(l2.back());
+
+  slab_map m1;
+  for (int i = 0; i < 1000; ++i)
+    m1.emplace(i, i * i);
+  FUN_VALUE(m1.get_allocator().pool()->slab_count());
+  m1.erase(m1.begin(), m1.find(990));
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.begin()->second);
+  m1.clear();
+  FUN_VALUE(m1.get_allocator().pool()->slab_count());
+  m1.emplace(1, 1);
+  FUN_VALUE(m1.size());
+}
+
+struct node24 { void* p[3]; };
+struct node48 { void* p[6]; };
+
+void alloc_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------------- Run container test : alloc ------------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int* p1 = mystl::pool_allocator<int>::allocate();
+  mystl::pool_allocator<int>::construct(p1, 5);
+  FUN_VALUE(*p1);
+  mystl::pool_allocator<int>::destroy(p1);
+  mystl::pool_allocator<int>::deallocate(p1);
+  FUN_VALUE(mystl::alloc::thread_stats().allocate_count);
+  FUN_VALUE(mystl::alloc::thread_stats().deallocate_count);
+  FUN_VALUE(mystl::alloc::thread_stats().cached_bytes);
+
+  // 同一等级内 reallocate 不移动，跨等级时保留原内容
+  char* p2 = static_cast<char*>(mystl::alloc::allocate(10));
+  std::memcpy(p2, "mytinystl", 10);
+  std::cout << std::boolalpha;
+  FUN_VALUE((mystl::alloc::reallocate(p2, 10, 14) == p2));
+  std::cout << std::noboolalpha;
+  p2 = static_cast<char*>(mystl::alloc::reallocate(p2, 14, 1000));
+  FUN_VALUE(p2);
+  p2 = static_cast<char*>(mystl::alloc::reallocate(p2, 1000, 10000));
+  FUN_VALUE(p2);
+  FUN_VALUE(mystl::alloc::stats().large_bytes);
+  mystl::alloc::deallocate(p2, 10000);
+  FUN_VALUE(mystl::alloc::stats().large_bytes);
+
+  // 一个线程分配，另一个线程释放，线程退出后区块回到中心池
+  mystl::vector<node24*> v(1000);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = mystl::pool_allocator<node24>::allocate();
+  std::thread t([&v]()
+  {
+    for (size_t i = 0; i < v.size(); ++i)
+      mystl::pool_allocator<node24>::deallocate(v[i]);
+  });
+  t.join();
+  std::cout << std::boolalpha;
+  FUN_VALUE((mystl::alloc::stats().central_free_bytes >= 1000 * sizeof(node24)));
+  std::cout << std::noboolalpha;
+  mystl::alloc::release_thread_cache();
+  FUN_VALUE(mystl::alloc::thread_stats().cached_bytes);
+  FUN_VALUE(mystl::alloc::stats().reserved_bytes);
+  stateful_alloc_test();
+  node_pool_test();
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     24B blocks      |";
+#if LARGER_TEST_DATA_ON
+  ALLOC_TEST(node24, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  ALLOC_TEST(node24, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     48B blocks      |";
+#if LARGER_TEST_DATA_ON
+  ALLOC_TEST(node48, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  ALLOC_TEST(node48, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  list build + walk  |";
+#if LARGER_TEST_DATA_ON
+  LIST_POOL_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  LIST_POOL_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[----------------- End container test : alloc ------------------]" << std::endl;
+}
+
+} // namespace alloc_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_ALLOC_TEST_H_
+
@@ -0,0 +1,303 @@
+﻿#ifndef MYTINYSTL_BTREE_MAP_TEST_H_
+#define MYTINYSTL_BTREE_MAP_TEST_H_
+
+// btree_map test : 测试 btree_map, btree_multimap, btree_set, btree_multiset 的接口，
+// 并与红黑树的 map 比较 emplace, find 与顺序遍历的性能
+
+#include <map>
+
+#include "../MyTinySTL/btree_map.h"
+#include "../MyTinySTL/btree_set.h"
+#include "../MyTinySTL/map.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace btree_map_test
+{
+
+// btree 与红黑树的性能对比，con 为完整的容器类型名
+#define BTREE_EMPLACE_DO_TEST(con, count) do {               \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.emplace(rand(), rand());                               \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 先插入 len 个随机的键，再查找 len 次，约一半命中
+#define BTREE_FIND_DO_TEST(con, len) do {                    \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < len; ++i)                           \
+    c.emplace(static_cast<int>(rand() % (len * 2)), 0);      \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+    hit += c.count(static_cast<int>(rand() % (len * 2)));    \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+  volatile size_t sink = hit;                                \
+  (void)sink;                                                \
+} while(0)
+
+// 以随机顺序插入 len 个键，再从头到尾遍历 10 次
+#define BTREE_SCAN_DO_TEST(con, len) do {                    \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < len; ++i)                           \
+    c.emplace(rand(), static_cast<int>(i));                  \
+  long long sum = 0;                                         \
+  start = clock();                                           \
+  for (int r = 0; r < 10; ++r)                               \
+  {                                                          \
+    for (auto it = c.begin(); it != c.end(); ++it)           \
+      sum += it->second;                                     \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+  volatile long long sink = sum;                             \
+  (void)sink;                                                \
+} while(0)
+
+#define BTREE_TEST(fun, len1, len2, len3)                  \
+  TEST_LEN(len1, len2, len3, WIDE);                        \
+  std::cout << "|         std         |";                  \
+  fun(std_map_type, len1);                                 \
+  fun(std_map_type, len2);                                 \
+  fun(std_map_type, len3);                                 \
+  std::cout << "\n|    mystl rb_tree    |";                \
+  fun(rb_map_type, len1);                                  \
+  fun(rb_map_type, len2);                                  \
+  fun(rb_map_type, len3);                                  \
+  std::cout << "\n|     mystl btree     |";                \
+  fun(btree_map_type, len1);                               \
+  fun(btree_map_type, len2);                               \
+  fun(btree_map_type, len3);
+
+typedef std::map<int, int>          std_map_type;
+typedef mystl::map<int, int>        rb_map_type;
+typedef mystl::btree_map<int, int>  btree_map_type;
+
+void btree_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : btree_map ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<PAIR> v;
+  for (int i = 0; i < 5; ++i)
+    v.push_back(PAIR(i, i));
+  mystl::btree_map<int, int> m1;
+  mystl::btree_map<int, int, mystl::greater<int>> m2;
+  mystl::btree_map<int, int> m3(v.begin(), v.end());
+  mystl::btree_map<int, int> m4(v.begin(), v.end());
+  mystl::btree_map<int, int> m5(m3);
+  mystl::btree_map<int, int> m6(std::move(m3));
+  mystl::btree_map<int, int> m7;
+  m7 = m4;
+  mystl::btree_map<int, int> m8;
+  m8 = std::move(m4);
+  mystl::btree_map<int, int> m9{ PAIR(1,1),PAIR(3,2),PAIR(2,3) };
+  mystl::btree_map<int, int> m10;
+  m10 = { PAIR(1,1),PAIR(3,2),PAIR(2,3) };
+
+  for (int i = 5; i > 0; --i)
+  {
+    MAP_FUN_AFTER(m1, m1.emplace(i, i));
+  }
+  MAP_FUN_AFTER(m1, m1.emplace_hint(m1.begin(), 0, 0));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+  MAP_FUN_AFTER(m1, m1.erase(0));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    MAP_FUN_AFTER(m1, m1.insert(PAIR(i, i)));
+  }
+  MAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
+  MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(5, 5)));
+  FUN_VALUE(m1.count(1));
+  MAP_VALUE(*m1.find(3));
+  MAP_VALUE(*m1.lower_bound(3));
+  MAP_VALUE(*m1.upper_bound(2));
+  auto first = *m1.equal_range(2).first;
+  auto second = *m1.equal_range(2).second;
+  std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
+    << "> to <" << second.first << ", " << second.second << ">" << std::endl;
+  MAP_VALUE(*m1.erase(m1.find(2)));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(4)));
+  MAP_FUN_AFTER(m1, m1.clear());
+  MAP_FUN_AFTER(m1, m1.swap(m9));
+  MAP_VALUE(*m1.begin());
+  MAP_VALUE(*m1.rbegin());
+  FUN_VALUE(m1[1]);
+  MAP_FUN_AFTER(m1, m1[1] = 3);
+  FUN_VALUE(m1.at(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.empty());
+  FUN_VALUE((m5 == m6));
+  FUN_VALUE((m7 < m10));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(m1.size());
+  mystl::btree_map<mystl::string, int, mystl::less<>> m11;
+  m11.emplace("apple", 1);
+  m11.emplace("banana", 2);
+  m11.emplace("cherry", 3);
+  FUN_VALUE(m11.find("banana")->second);
+  FUN_VALUE(m11.count("durian"));
+  FUN_VALUE(m11.lower_bound("b")->second);
+  std::cout << std::boolalpha;
+  FUN_VALUE(m11.contains("apple"));
+  std::cout << std::noboolalpha;
+  // 插入删除会移动元素，边遍历边删除时使用 erase 的返回值
+  mystl::btree_map<int, int> m12;
+  for (int i = 0; i < 10000; ++i)
+    m12.emplace_hint(m12.end(), i, i);
+  for (auto it = m12.begin(); it != m12.end();)
+  {
+    if (it->first % 3 != 0)
+      it = m12.erase(it);
+    else
+      ++it;
+  }
+  FUN_VALUE(m12.size());
+  FUN_VALUE(m12.rbegin()->first);
+  std::cout << std::boolalpha;
+  FUN_VALUE(mystl::is_sorted(m12.begin(), m12.end(), m12.value_comp()));
+  std::cout << std::noboolalpha;
+  mystl::btree_multimap<int, int> mm1{ PAIR(1,1),PAIR(3,2),PAIR(2,3),PAIR(3,4) };
+  MAP_FUN_AFTER(mm1, mm1.emplace(3, 5));
+  MAP_FUN_AFTER(mm1, mm1.emplace_hint(mm1.lower_bound(3), 3, 6));
+  FUN_VALUE(mm1.count(3));
+  MAP_FUN_AFTER(mm1, mm1.erase(3));
+  FUN_VALUE(mm1.size());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       emplace       |";
+#if LARGER_TEST_DATA_ON
+  BTREE_TEST(BTREE_EMPLACE_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  BTREE_TEST(BTREE_EMPLACE_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  BTREE_TEST(BTREE_FIND_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  BTREE_TEST(BTREE_FIND_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        scan         |";
+#if LARGER_TEST_DATA_ON
+  BTREE_TEST(BTREE_SCAN_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  BTREE_TEST(BTREE_SCAN_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : btree_map ----------------]" << std::endl;
+}
+
+void btree_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : btree_set ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  mystl::btree_set<int> s1;
+  mystl::btree_set<int, mystl::greater<int>> s2;
+  mystl::btree_set<int> s3(a, a + 5);
+  mystl::btree_set<int> s4(a, a + 5);
+  mystl::btree_set<int> s5(s3);
+  mystl::btree_set<int> s6(std::move(s3));
+  mystl::btree_set<int> s7;
+  s7 = s4;
+  mystl::btree_set<int> s8;
+  s8 = std::move(s4);
+  mystl::btree_set<int> s9{ 1,2,3,4,5 };
+  mystl::btree_set<int> s10;
+  s10 = { 1,2,3,4,5 };
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(0));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FUN_AFTER(s1, s1.insert(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 5));
+  FUN_AFTER(s1, s1.insert(5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 5));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  auto first = *s1.equal_range(3).first;
+  auto second = *s1.equal_range(3).second;
+  std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+  FUN_AFTER(s1, s1.clear());
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.empty());
+  FUN_VALUE((s9 == s10));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(s1.size());
+  mystl::btree_multiset<int> ms1(a, a + 5);
+  FUN_AFTER(ms1, ms1.insert(a, a + 5));
+  FUN_AFTER(ms1, ms1.emplace(3));
+  FUN_VALUE(ms1.count(3));
+  FUN_AFTER(ms1, ms1.erase(3));
+  FUN_VALUE(ms1.size());
+  PASSED;
+  std::cout << "[--------------- End container test : btree_set ----------------]" << std::endl;
+}
+
+} // namespace btree_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_BTREE_MAP_TEST_H_
+
@@ -0,0 +1,197 @@
+﻿#ifndef MYTINYSTL_CONCURRENT_QUEUE_TEST_H_
+#define MYTINYSTL_CONCURRENT_QUEUE_TEST_H_
+
+// concurrent queue test : 测试 spsc_queue, mpmc_queue 的接口，多线程下元素不丢失不重复，
+// 并与加锁的 mystl::queue 比较多生产者下的吞吐量
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "../MyTinySTL/concurrent_queue.h"
+#include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/vector.h"
+#include "../MyTinySTL/astring.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_queue_test
+{
+
+// 以互斥锁保护的 mystl::queue，作为比较的基准
+template <class T>
+class locked_queue
+{
+public:
+  explicit locked_queue(size_t) {}
+
+  bool try_push(const T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    q_.push(value);
+    return true;
+  }
+
+  bool try_pop(T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (q_.empty())
+      return false;
+    value = q_.front();
+    q_.pop();
+    return true;
+  }
+
+private:
+  std::mutex       mutex_;
+  mystl::queue<T>  q_;
+};
+
+// producers 个线程共放入 len 个整数，consumers 个线程取出，返回取出的元素之和
+template <class Queue>
+long long queue_transfer(Queue& q, size_t producers, size_t consumers, size_t len)
+{
+  std::atomic<size_t>    popped(0);
+  std::atomic<long long> sum(0);
+  mystl::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p)
+  {
+    threads.push_back(std::thread([&q, p, producers, len]()
+    {
+      for (size_t i = p; i < len; i += producers)
+      {
+        while (!q.try_push(static_cast<long long>(i)))
+          std::this_thread::yield();
+      }
+    }));
+  }
+  for (size_t c = 0; c < consumers; ++c)
+  {
+    threads.push_back(std::thread([&q, &popped, &sum, len]()
+    {
+      long long local = 0;
+      long long value = 0;
+      while (popped.load(std::memory_order_relaxed) < len)
+      {
+        if (q.try_pop(value))
+        {
+          local += value;
+          popped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+      sum.fetch_add(local);
+    }));
+  }
+  for (auto& t : threads)
+    t.join();
+  return sum.load();
+}
+
+// 多生产者向队列放入 len 个元素并全部取出所用的时间
+#define CONCURRENT_QUEUE_DO_TEST(queue_type, producers, consumers, len) do {  \
+  char buf[10];                                                                \
+  queue_type<long long> q(1024);                                               \
+  auto start = std::chrono::steady_clock::now();                               \
+  queue_transfer(q, producers, consumers, len);                                \
+  auto end = std::chrono::steady_clock::now();                                 \
+  int n = static_cast<int>(std::chrono::duration_cast<                         \
+      std::chrono::milliseconds>(end - start).count());                        \
+  std::snprintf(buf, sizeof(buf), "%d", n);                                    \
+  std::string t = buf;                                                         \
+  t += "ms    |";                                                              \
+  std::cout << std::setw(WIDE) << t;                                           \
+} while(0)
+
+#define CONCURRENT_QUEUE_TEST(producers, consumers, len1, len2, len3)              \
+  TEST_LEN(len1, len2, len3, WIDE);                                                \
+  std::cout << "|    mutex + queue    |";                                          \
+  CONCURRENT_QUEUE_DO_TEST(locked_queue, producers, consumers, len1);              \
+  CONCURRENT_QUEUE_DO_TEST(locked_queue, producers, consumers, len2);              \
+  CONCURRENT_QUEUE_DO_TEST(locked_queue, producers, consumers, len3);              \
+  std::cout << "\n|     mpmc_queue      |";                                        \
+  CONCURRENT_QUEUE_DO_TEST(mystl::mpmc_queue, producers, consumers, len1);         \
+  CONCURRENT_QUEUE_DO_TEST(mystl::mpmc_queue, producers, consumers, len2);         \
+  CONCURRENT_QUEUE_DO_TEST(mystl::mpmc_queue, producers, consumers, len3);
+
+void concurrent_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : concurrent queue ------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::spsc_queue<mystl::string> s1(5);
+  FUN_VALUE(s1.capacity());
+  for (int i = 0; i < 10; ++i)
+    s1.try_push(mystl::string(1, static_cast<char>('a' + i)));
+  FUN_VALUE(s1.size());
+  mystl::string str;
+  s1.try_pop(str);
+  FUN_VALUE(str);
+  s1.try_emplace(3, 'z');
+  mystl::vector<mystl::string> v1(8);
+  FUN_VALUE(s1.pop_n(v1.begin(), 8));
+  COUT(v1);
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.try_pop(str));
+  FUN_VALUE(s1.empty());
+  std::cout << std::noboolalpha;
+
+  mystl::mpmc_queue<mystl::string> m1(1);
+  FUN_VALUE(m1.capacity());
+  m1.try_push("front");
+  m1.try_emplace(2, 'b');
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.try_push("full"));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(m1.size());
+  mystl::vector<mystl::string> v2(4);
+  FUN_VALUE(m1.pop_n(v2.begin(), 4));
+  COUT(v2);
+  m1.try_push("back");
+
+  // 多个线程同时放入与取出，元素之和不变
+  const size_t len = 100000;
+  const long long expect = static_cast<long long>(len) * (len - 1) / 2;
+  mystl::spsc_queue<long long> s2(64);
+  mystl::mpmc_queue<long long> m2(64);
+  std::cout << std::boolalpha;
+  FUN_VALUE((queue_transfer(s2, 1, 1, len) == expect));
+  FUN_VALUE((queue_transfer(m2, 4, 4, len) == expect));
+  FUN_VALUE(m2.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| 4 producers 1 cons. |";
+#if LARGER_TEST_DATA_ON
+  CONCURRENT_QUEUE_TEST(4, 1, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  CONCURRENT_QUEUE_TEST(4, 1, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| 4 producers 4 cons. |";
+#if LARGER_TEST_DATA_ON
+  CONCURRENT_QUEUE_TEST(4, 4, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  CONCURRENT_QUEUE_TEST(4, 4, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End container test : concurrent queue ------------]" << std::endl;
+}
+
+} // namespace concurrent_queue_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_QUEUE_TEST_H_
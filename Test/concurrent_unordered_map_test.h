@@ -0,0 +1,195 @@
+﻿#ifndef MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+#define MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+
+// concurrent unordered_map test : 测试 concurrent_unordered_map 的接口，多线程下的插入与删除，
+// 并与单个互斥锁保护的 unordered_map 比较读多写少与读写各半时的吞吐量
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "../MyTinySTL/concurrent_unordered_map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "../MyTinySTL/astring.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_unordered_map_test
+{
+
+// 以一个互斥锁保护的 unordered_map，作为比较的基准
+template <class Key, class T>
+class locked_unordered_map
+{
+public:
+  bool find(const Key& key, T& value) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if (it == map_.end())
+      return false;
+    value = it->second;
+    return true;
+  }
+
+  bool insert_or_assign(const Key& key, const T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.insert_or_assign(key, value).second;
+  }
+
+  size_t erase(const Key& key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.erase(key);
+  }
+
+private:
+  mutable std::mutex            mutex_;
+  mystl::unordered_map<Key, T>  map_;
+};
+
+// threads 个线程各执行 len / threads 次操作，每 10 次操作中有 reads 次查找，其余为插入或删除
+template <class Map>
+void map_mixed_ops(Map& m, size_t threads, size_t len, int reads)
+{
+  mystl::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.push_back(std::thread([&m, t, threads, len, reads]()
+    {
+      unsigned long long seed = t * 2654435761u + 1;
+      int value = 0;
+      for (size_t i = t; i < len; i += threads)
+      {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const int key = static_cast<int>((seed >> 33) % 65536);
+        const int op = static_cast<int>(i % 10);
+        if (op < reads)
+          m.find(key, value);
+        else if (op % 2 == 0)
+          m.insert_or_assign(key, static_cast<int>(i));
+        else
+          m.erase(key);
+      }
+    }));
+  }
+  for (auto& w : workers)
+    w.join();
+}
+
+#define CONCURRENT_MAP_DO_TEST(map_type, threads, reads, len) do {   \
+  char buf[10];                                                      \
+  map_type<int, int> m;                                              \
+  auto start = std::chrono::steady_clock::now();                     \
+  map_mixed_ops(m, threads, len, reads);                             \
+  auto end = std::chrono::steady_clock::now();                       \
+  int n = static_cast<int>(std::chrono::duration_cast<               \
+      std::chrono::milliseconds>(end - start).count());              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                          \
+  std::string t = buf;                                               \
+  t += "ms    |";                                                    \
+  std::cout << std::setw(WIDE) << t;                                 \
+} while(0)
+
+#define CONCURRENT_MAP_TEST(threads, reads, len1, len2, len3)                         \
+  TEST_LEN(len1, len2, len3, WIDE);                                                   \
+  std::cout << "|  mutex + u_map      |";                                             \
+  CONCURRENT_MAP_DO_TEST(locked_unordered_map, threads, reads, len1);                 \
+  CONCURRENT_MAP_DO_TEST(locked_unordered_map, threads, reads, len2);                 \
+  CONCURRENT_MAP_DO_TEST(locked_unordered_map, threads, reads, len3);                 \
+  std::cout << "\n| concurrent_u_map    |";                                         \
+  CONCURRENT_MAP_DO_TEST(mystl::concurrent_unordered_map, threads, reads, len1);      \
+  CONCURRENT_MAP_DO_TEST(mystl::concurrent_unordered_map, threads, reads, len2);      \
+  CONCURRENT_MAP_DO_TEST(mystl::concurrent_unordered_map, threads, reads, len3);
+
+void concurrent_unordered_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------- Run container test : concurrent_unordered_map --------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::concurrent_unordered_map<int, mystl::string> m1(100, 3);
+  FUN_VALUE(m1.shard_count());
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.insert(mystl::make_pair(1, mystl::string("one"))));
+  FUN_VALUE(m1.insert(mystl::make_pair(1, mystl::string("uno"))));
+  FUN_VALUE(m1.try_emplace(2, 3, 'b'));
+  FUN_VALUE(m1.insert_or_assign(3, "three"));
+  FUN_VALUE(m1.insert_or_assign(3, "tres"));
+  FUN_VALUE(m1.contains(2));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(m1.size());
+  mystl::string str;
+  m1.find(3, str);
+  FUN_VALUE(str);
+  FUN_VALUE(m1.find_or(4, "none"));
+  m1.visit(1, [](mystl::string& s) { s += "!"; });
+  FUN_VALUE(m1.find_or(1, "none"));
+  size_t total = 0;
+  m1.for_each_shard([&total](const mystl::unordered_map<int, mystl::string>& m) { total += m.size(); });
+  FUN_VALUE(total);
+  FUN_VALUE(m1.erase_if(2, [](const mystl::string& s) { return s.size() > 5; }));
+  FUN_VALUE(m1.erase(2));
+  FUN_VALUE(m1.count(2));
+  m1.clear();
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.empty());
+  bool incremental = true;
+  m1.for_each_shard([&incremental](const mystl::unordered_map<int, mystl::string>& m)
+  { incremental = incremental && m.incremental_rehash(); });
+  FUN_VALUE(incremental);
+  std::cout << std::noboolalpha;
+
+  // 多个线程同时插入不同的键，再同时删除其中一半
+  mystl::concurrent_unordered_map<int, int> m2;
+  mystl::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t)
+  {
+    workers.push_back(std::thread([&m2, t]()
+    {
+      for (int i = t; i < 20000; i += 4)
+        m2.try_emplace(i, i);
+      for (int i = t; i < 20000; i += 8)
+        m2.erase(i);
+    }));
+  }
+  for (auto& w : workers)
+    w.join();
+  FUN_VALUE(m2.size());
+  long long sum = 0;
+  m2.for_each([&sum](const mystl::pair<const int, int>& v) { sum += v.second; });
+  FUN_VALUE(sum);
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  90% read, 4 thr.   |";
+#if LARGER_TEST_DATA_ON
+  CONCURRENT_MAP_TEST(4, 9, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  CONCURRENT_MAP_TEST(4, 9, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  50% read, 4 thr.   |";
+#if LARGER_TEST_DATA_ON
+  CONCURRENT_MAP_TEST(4, 5, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  CONCURRENT_MAP_TEST(4, 5, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------- End container test : concurrent_unordered_map --------]" << std::endl;
+}
+
+} // namespace concurrent_unordered_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
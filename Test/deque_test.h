@@ -6,6 +6,7 @@
 #include <deque>
 
 #include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/astring.h"
 #include "test.h"
 
 namespace mystl
@@ -70,6 +71,37 @@ void deque_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(d1.size());
   FUN_VALUE(d1.max_size());
+
+  // 元素可以按字节搬移时，插入与删除按缓冲区分段搬移较短的一侧
+  mystl::deque<mystl::string> d11;
+  for (size_t i = 0; i < 1000; ++i)
+    d11.emplace_back(1, static_cast<char>('a' + i % 26));
+  d11.emplace(d11.begin() + 300, "front");
+  d11.emplace(d11.begin() + 700, "back");
+  d11.erase(d11.begin() + 100, d11.begin() + 290);
+  d11.erase(d11.begin() + 500, d11.begin() + 800);
+  d11.erase(d11.begin() + 1);
+  FUN_VALUE(d11.size());
+  FUN_VALUE(d11[109]);
+  FUN_VALUE(d11[d11.size() - 1]);
+
+  // 缓冲区大小可以由第三个模板参数指定
+  mystl::deque<int, mystl::allocator<int>, mystl::deque_block_traits<4>> d12;
+  for (int i = 0; i < 20; ++i)
+  {
+    d12.push_back(i);
+    d12.push_front(-i);
+  }
+  d12.erase(d12.begin() + 5, d12.begin() + 15);
+  d12.insert(d12.begin() + 10, 3, 100);
+  FUN_VALUE(d12.size());
+  FUN_VALUE(d12.front());
+  FUN_VALUE(d12[10]);
+  FUN_VALUE(d12.back());
+  mystl::deque<int, mystl::allocator<int>, mystl::deque_bytes_traits<int, 64>> d13(d12.begin(), d12.end());
+  std::cout << std::boolalpha;
+  FUN_VALUE(mystl::equal(d12.begin(), d12.end(), d13.begin()));
+  std::cout << std::noboolalpha;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -0,0 +1,298 @@
+﻿#ifndef MYTINYSTL_FLAT_MAP_TEST_H_
+#define MYTINYSTL_FLAT_MAP_TEST_H_
+
+// flat_map test : 测试 flat_map, flat_multimap, flat_set, flat_multiset 的接口，
+// 并与红黑树的 map 比较批量构建与查找的性能
+
+#include <map>
+#include <vector>
+
+#include "../MyTinySTL/flat_map.h"
+#include "../MyTinySTL/flat_set.h"
+#include "../MyTinySTL/map.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace flat_map_test
+{
+
+// 以 len 个随机的键做范围构造，con 为完整的容器类型名
+#define FLAT_BUILD_DO_TEST(con, len) do {                    \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  std::vector<con::value_type> v;                            \
+  v.reserve(len);                                            \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.emplace_back(rand(), static_cast<int>(i));             \
+  start = clock();                                           \
+  con c(v.data(), v.data() + v.size());                      \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 先构造 len 个随机的键，再查找 len 次，约一半命中
+#define FLAT_FIND_DO_TEST(con, len) do {                     \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  std::vector<con::value_type> v;                            \
+  v.reserve(len);                                            \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.emplace_back(static_cast<int>(rand() % (len * 2)), 0); \
+  con c(v.data(), v.data() + v.size());                      \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+    hit += c.count(static_cast<int>(rand() % (len * 2)));    \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+  volatile size_t sink = hit;                                \
+  (void)sink;                                                \
+} while(0)
+
+#define FLAT_TEST(fun, len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                        \
+  std::cout << "|         std         |";                  \
+  fun(std_map_type, len1);                                 \
+  fun(std_map_type, len2);                                 \
+  fun(std_map_type, len3);                                 \
+  std::cout << "\n|    mystl rb_tree    |";                \
+  fun(rb_map_type, len1);                                  \
+  fun(rb_map_type, len2);                                  \
+  fun(rb_map_type, len3);                                  \
+  std::cout << "\n|   mystl flat_map    |";                \
+  fun(flat_map_type, len1);                                \
+  fun(flat_map_type, len2);                                \
+  fun(flat_map_type, len3);                                \
+  std::cout << "\n|  flat_map eytzinger |";                \
+  fun(eytzinger_map_type, len1);                           \
+  fun(eytzinger_map_type, len2);                           \
+  fun(eytzinger_map_type, len3);
+
+typedef std::map<int, int>          std_map_type;
+typedef mystl::map<int, int>        rb_map_type;
+typedef mystl::flat_map<int, int>   flat_map_type;
+typedef mystl::flat_map<int, int, mystl::less<int>, mystl::allocator<PAIR>,
+                        mystl::flat_eytzinger_search>  eytzinger_map_type;
+
+void flat_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : flat_map ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<PAIR> v;
+  for (int i = 0; i < 5; ++i)
+    v.push_back(PAIR(i, i));
+  mystl::flat_map<int, int> m1;
+  mystl::flat_map<int, int, mystl::greater<int>> m2;
+  mystl::flat_map<int, int> m3(v.begin(), v.end());
+  mystl::flat_map<int, int> m4(v.begin(), v.end());
+  mystl::flat_map<int, int> m5(m3);
+  mystl::flat_map<int, int> m6(std::move(m3));
+  mystl::flat_map<int, int> m7;
+  m7 = m4;
+  mystl::flat_map<int, int> m8;
+  m8 = std::move(m4);
+  mystl::flat_map<int, int> m9{ PAIR(1,1),PAIR(3,2),PAIR(2,3) };
+  mystl::flat_map<int, int> m10;
+  m10 = { PAIR(1,1),PAIR(3,2),PAIR(2,3) };
+
+  for (int i = 5; i > 0; --i)
+  {
+    MAP_FUN_AFTER(m1, m1.emplace(i, i));
+  }
+  MAP_FUN_AFTER(m1, m1.emplace_hint(m1.begin(), 0, 0));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+  MAP_FUN_AFTER(m1, m1.erase(0));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    MAP_FUN_AFTER(m1, m1.insert(PAIR(i, i)));
+  }
+  MAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
+  MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(5, 5)));
+  FUN_VALUE(m1.count(1));
+  MAP_VALUE(*m1.find(3));
+  MAP_VALUE(*m1.lower_bound(3));
+  MAP_VALUE(*m1.upper_bound(2));
+  auto first = *m1.equal_range(2).first;
+  auto second = *m1.equal_range(2).second;
+  std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
+    << "> to <" << second.first << ", " << second.second << ">" << std::endl;
+  MAP_VALUE(*m1.erase(m1.find(2)));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(4)));
+  MAP_FUN_AFTER(m1, m1.clear());
+  MAP_FUN_AFTER(m1, m1.swap(m9));
+  MAP_VALUE(*m1.begin());
+  MAP_VALUE(*m1.rbegin());
+  FUN_VALUE(m1[1]);
+  MAP_FUN_AFTER(m1, m1[1] = 3);
+  FUN_VALUE(m1.at(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.empty());
+  FUN_VALUE((m5 == m6));
+  FUN_VALUE((m7 < m10));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(m1.size());
+  // 批量构建：无序输入只排序去重一次，相同键值保留先出现的元素
+  mystl::flat_map<int, int> m11{ PAIR(3,1),PAIR(1,2),PAIR(3,3),PAIR(2,4),PAIR(1,5) };
+  MAP_FUN_AFTER(m11, m11.reserve(16));
+  FUN_VALUE(m11.capacity());
+  MAP_FUN_AFTER(m11, m11.insert({ PAIR(0,6),PAIR(4,7),PAIR(2,8) }));
+  mystl::flat_map<int, int> m12(mystl::sorted_unique, { PAIR(1,1),PAIR(2,2),PAIR(4,4) });
+  MAP_FUN_AFTER(m12, m12.insert(mystl::sorted_unique, m11.begin(), m11.end()));
+  // 取出与替换底层序列
+  auto seq = m12.extract();
+  FUN_VALUE(seq.size());
+  FUN_VALUE(m12.size());
+  seq.push_back(PAIR(-1, -1));
+  MAP_FUN_AFTER(m12, m12.replace(mystl::move(seq)));
+  mystl::flat_map<int, int> m13(m12.extract());
+  MAP_COUT(m13);
+  // Eytzinger 索引
+  eytzinger_map_type m14(v.begin(), v.end());
+  MAP_FUN_AFTER(m14, m14.emplace(7, 7));
+  MAP_FUN_AFTER(m14, m14.erase(2));
+  MAP_VALUE(*m14.lower_bound(5));
+  MAP_VALUE(*m14.upper_bound(3));
+  FUN_VALUE(m14.count(2));
+  FUN_VALUE(m14.at(7));
+  mystl::flat_map<mystl::string, int, mystl::less<>> m15;
+  m15.emplace("apple", 1);
+  m15.emplace("banana", 2);
+  m15.emplace("cherry", 3);
+  FUN_VALUE(m15.find("banana")->second);
+  FUN_VALUE(m15.count("durian"));
+  FUN_VALUE(m15.lower_bound("b")->second);
+  std::cout << std::boolalpha;
+  FUN_VALUE(m15.contains("apple"));
+  std::cout << std::noboolalpha;
+  mystl::flat_multimap<int, int> mm1{ PAIR(1,1),PAIR(3,2),PAIR(2,3),PAIR(3,4) };
+  MAP_FUN_AFTER(mm1, mm1.emplace(3, 5));
+  MAP_FUN_AFTER(mm1, mm1.emplace_hint(mm1.lower_bound(3), 3, 6));
+  MAP_FUN_AFTER(mm1, mm1.insert(mystl::sorted_equivalent, { PAIR(0,7),PAIR(3,8) }));
+  FUN_VALUE(mm1.count(3));
+  MAP_FUN_AFTER(mm1, mm1.erase(3));
+  FUN_VALUE(mm1.size());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     bulk build      |";
+#if LARGER_TEST_DATA_ON
+  FLAT_TEST(FLAT_BUILD_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  FLAT_TEST(FLAT_BUILD_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  FLAT_TEST(FLAT_FIND_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  FLAT_TEST(FLAT_FIND_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[---------------- End container test : flat_map ----------------]" << std::endl;
+}
+
+void flat_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : flat_set ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  mystl::flat_set<int> s1;
+  mystl::flat_set<int, mystl::greater<int>> s2;
+  mystl::flat_set<int> s3(a, a + 5);
+  mystl::flat_set<int> s4(a, a + 5);
+  mystl::flat_set<int> s5(s3);
+  mystl::flat_set<int> s6(std::move(s3));
+  mystl::flat_set<int> s7;
+  s7 = s4;
+  mystl::flat_set<int> s8;
+  s8 = std::move(s4);
+  mystl::flat_set<int> s9{ 1,2,3,4,5 };
+  mystl::flat_set<int> s10;
+  s10 = { 1,2,3,4,5 };
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(0));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FUN_AFTER(s1, s1.insert(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 5));
+  FUN_AFTER(s1, s1.insert(5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 5));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  auto first = *s1.equal_range(3).first;
+  auto second = *s1.equal_range(3).second;
+  std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+  FUN_AFTER(s1, s1.clear());
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.empty());
+  FUN_VALUE((s9 == s10));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(s1.size());
+  mystl::vector<int> seq{ 3,1,4,1,5,9,2,6 };
+  mystl::flat_set<int> s11(mystl::move(seq));
+  FUN_VALUE(s11.size());
+  FUN_AFTER(s11, s11.shrink_to_fit());
+  mystl::flat_set<int, mystl::less<int>, mystl::allocator<int>,
+                  mystl::flat_eytzinger_search> s12(s11.begin(), s11.end());
+  FUN_VALUE(*s12.lower_bound(7));
+  FUN_VALUE(s12.count(4));
+  FUN_AFTER(s12, s12.insert(7));
+  FUN_VALUE(*s12.upper_bound(6));
+  mystl::flat_multiset<int> ms1(a, a + 5);
+  FUN_AFTER(ms1, ms1.insert(a, a + 5));
+  FUN_AFTER(ms1, ms1.emplace(3));
+  FUN_VALUE(ms1.count(3));
+  FUN_AFTER(ms1, ms1.erase(3));
+  FUN_VALUE(ms1.size());
+  PASSED;
+  std::cout << "[---------------- End container test : flat_set ----------------]" << std::endl;
+}
+
+} // namespace flat_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_MAP_TEST_H_
+
@@ -0,0 +1,233 @@
+﻿#ifndef MYTINYSTL_FLAT_UNORDERED_MAP_TEST_H_
+#define MYTINYSTL_FLAT_UNORDERED_MAP_TEST_H_
+
+// flat_unordered_map test : 测试 flat_unordered_map, flat_unordered_set 的接口，
+// 并与开链法的 unordered_map 比较 emplace 与 find 的性能
+
+#include <unordered_map>
+
+#include "../MyTinySTL/flat_unordered_map.h"
+#include "../MyTinySTL/flat_unordered_set.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace flat_unordered_map_test
+{
+
+// 开放寻址与开链法的性能对比，con 为完整的容器类型名
+#define FLAT_MAP_EMPLACE_DO_TEST(con, count) do {            \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.emplace(rand(), rand());                               \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 先插入 len 个连续的键，再查找 len 次，约一半命中
+#define FLAT_MAP_FIND_DO_TEST(con, len) do {                 \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < len; ++i)                           \
+    c.emplace(static_cast<int>(i), static_cast<int>(i));     \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+    hit += c.count(static_cast<int>(rand() % (len * 2)));    \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+  volatile size_t sink = hit;                                \
+  (void)sink;                                                \
+} while(0)
+
+#define FLAT_MAP_TEST(fun, len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                        \
+  std::cout << "|         std         |";                  \
+  fun(std_map_type, len1);                                 \
+  fun(std_map_type, len2);                                 \
+  fun(std_map_type, len3);                                 \
+  std::cout << "\n|    mystl chained    |";                \
+  fun(chained_map_type, len1);                             \
+  fun(chained_map_type, len2);                             \
+  fun(chained_map_type, len3);                             \
+  std::cout << "\n|     mystl flat      |";                \
+  fun(flat_map_type, len1);                                \
+  fun(flat_map_type, len2);                                \
+  fun(flat_map_type, len3);
+
+typedef std::unordered_map<int, int>         std_map_type;
+typedef mystl::unordered_map<int, int>       chained_map_type;
+typedef mystl::flat_unordered_map<int, int>  flat_map_type;
+
+void flat_unordered_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------- Run container test : flat_unordered_map -----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<PAIR> v;
+  for (int i = 0; i < 5; ++i)
+    v.push_back(PAIR(5 - i, 5 - i));
+  mystl::flat_unordered_map<int, int> um1;
+  mystl::flat_unordered_map<int, int> um2(520);
+  mystl::flat_unordered_map<int, int> um3(520, mystl::hash<int>());
+  mystl::flat_unordered_map<int, int> um4(520, mystl::hash<int>(), mystl::equal_to<int>());
+  mystl::flat_unordered_map<int, int> um5(v.begin(), v.end());
+  mystl::flat_unordered_map<int, int> um6(v.begin(), v.end(), 100);
+  mystl::flat_unordered_map<int, int> um7(v.begin(), v.end(), 100, mystl::hash<int>());
+  mystl::flat_unordered_map<int, int> um8(v.begin(), v.end(), 100, mystl::hash<int>(), mystl::equal_to<int>());
+  mystl::flat_unordered_map<int, int> um9(um5);
+  mystl::flat_unordered_map<int, int> um10(std::move(um5));
+  mystl::flat_unordered_map<int, int> um11;
+  um11 = um6;
+  mystl::flat_unordered_map<int, int> um12;
+  um12 = std::move(um6);
+  mystl::flat_unordered_map<int, int> um13{ PAIR(1,1),PAIR(2,3),PAIR(3,3) };
+  mystl::flat_unordered_map<int, int> um14;
+  um14 = { PAIR(1,1),PAIR(2,3),PAIR(3,3) };
+
+  MAP_FUN_AFTER(um1, um1.emplace(1, 1));
+  MAP_FUN_AFTER(um1, um1.emplace_hint(um1.begin(), 1, 2));
+  MAP_FUN_AFTER(um1, um1.insert(PAIR(2, 2)));
+  MAP_FUN_AFTER(um1, um1.insert(um1.end(), PAIR(3, 3)));
+  MAP_FUN_AFTER(um1, um1.insert(v.begin(), v.end()));
+  MAP_FUN_AFTER(um1, um1.erase(um1.begin()));
+  MAP_FUN_AFTER(um1, um1.erase(um1.find(3)));
+  MAP_FUN_AFTER(um1, um1.erase(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE(um1.empty());
+  FUN_VALUE((um8 == um9));
+  FUN_VALUE((um8 != um13));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(um1.size());
+  FUN_VALUE(um1.bucket_count());
+  FUN_VALUE(um1.max_bucket_count());
+  MAP_FUN_AFTER(um1, um1.clear());
+  MAP_FUN_AFTER(um1, um1.swap(um7));
+  FUN_VALUE(um1.at(1));
+  FUN_VALUE(um1[1]);
+  FUN_VALUE(um1[6]);
+  std::cout << std::boolalpha;
+  FUN_VALUE(um1.empty());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(um1.size());
+  FUN_VALUE(um1.bucket_count());
+  MAP_FUN_AFTER(um1, um1.reserve(1000));
+  FUN_VALUE(um1.size());
+  FUN_VALUE(um1.bucket_count());
+  MAP_FUN_AFTER(um1, um1.rehash(150));
+  FUN_VALUE(um1.bucket_count());
+  FUN_VALUE(um1.count(1));
+  FUN_VALUE(um1.count(7));
+  MAP_VALUE(*um1.find(3));
+  auto first = *um1.equal_range(3).first;
+  std::cout << " um1.equal_range(3) : from <" << first.first << ", " << first.second
+    << "> , size " << mystl::distance(um1.equal_range(3).first, um1.equal_range(3).second) << std::endl;
+  FUN_VALUE(um1.load_factor());
+  FUN_VALUE(um1.max_load_factor());
+  MAP_FUN_AFTER(um1, um1.max_load_factor(0.5f));
+  FUN_VALUE(um1.max_load_factor());
+  FUN_VALUE(um1.bucket_count());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       emplace       |";
+#if LARGER_TEST_DATA_ON
+  FLAT_MAP_TEST(FLAT_MAP_EMPLACE_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  FLAT_MAP_TEST(FLAT_MAP_EMPLACE_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  FLAT_MAP_TEST(FLAT_MAP_FIND_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  FLAT_MAP_TEST(FLAT_MAP_FIND_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[----------- End container test : flat_unordered_map -----------]" << std::endl;
+}
+
+void flat_unordered_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------- Run container test : flat_unordered_set -----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  mystl::flat_unordered_set<int> us1;
+  mystl::flat_unordered_set<int> us2(520);
+  mystl::flat_unordered_set<int> us3(520, mystl::hash<int>());
+  mystl::flat_unordered_set<int> us4(520, mystl::hash<int>(), mystl::equal_to<int>());
+  mystl::flat_unordered_set<int> us5(a, a + 5);
+  mystl::flat_unordered_set<int> us6(a, a + 5, 100);
+  mystl::flat_unordered_set<int> us7(a, a + 5, 100, mystl::hash<int>());
+  mystl::flat_unordered_set<int> us8(a, a + 5, 100, mystl::hash<int>(), mystl::equal_to<int>());
+  mystl::flat_unordered_set<int> us9(us5);
+  mystl::flat_unordered_set<int> us10(std::move(us5));
+  mystl::flat_unordered_set<int> us11;
+  us11 = us6;
+  mystl::flat_unordered_set<int> us12;
+  us12 = std::move(us6);
+  mystl::flat_unordered_set<int> us13{ 1,2,3,4,5 };
+  mystl::flat_unordered_set<int> us14;
+  us14 = { 1,2,3,4,5 };
+
+  FUN_AFTER(us1, us1.emplace(1));
+  FUN_AFTER(us1, us1.emplace_hint(us1.end(), 2));
+  FUN_AFTER(us1, us1.insert(5));
+  FUN_AFTER(us1, us1.insert(us1.begin(), 5));
+  FUN_AFTER(us1, us1.insert(a, a + 5));
+  FUN_AFTER(us1, us1.erase(us1.begin()));
+  FUN_AFTER(us1, us1.erase(us1.find(3)));
+  FUN_AFTER(us1, us1.erase(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE(us1.empty());
+  FUN_VALUE((us8 == us13));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(us1.size());
+  FUN_VALUE(us1.bucket_count());
+  FUN_AFTER(us1, us1.clear());
+  FUN_AFTER(us1, us1.swap(us7));
+  FUN_VALUE(*us1.begin());
+  FUN_VALUE(us1.size());
+  FUN_AFTER(us1, us1.reserve(1000));
+  FUN_VALUE(us1.bucket_count());
+  FUN_AFTER(us1, us1.rehash(150));
+  FUN_VALUE(us1.bucket_count());
+  FUN_VALUE(us1.count(1));
+  FUN_VALUE(*us1.find(3));
+  FUN_VALUE(us1.load_factor());
+  FUN_VALUE(us1.max_load_factor());
+  PASSED;
+  std::cout << "[----------- End container test : flat_unordered_set -----------]" << std::endl;
+}
+
+} // namespace flat_unordered_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_UNORDERED_MAP_TEST_H_
+
@@ -1,11 +1,12 @@
 ﻿#ifndef MYTINYSTL_LIST_TEST_H_
 #define MYTINYSTL_LIST_TEST_H_
 
-// list test : 测试 list 的接口与 insert, sort 的性能
+// list test : 测试 list 的接口与 insert, sort 的性能，以及 intrusive_list 的接口
 
 #include <list>
 
 #include "../MyTinySTL/list.h"
+#include "../MyTinySTL/intrusive.h"
 #include "test.h"
 
 namespace mystl
@@ -111,6 +112,73 @@ void list_test()
   std::cout << "[------------------ End container test : list ------------------]" << std::endl;
 }
 
+// intrusive_list 测试用的元素，可以同时位于两条链表中
+struct list_item
+{
+  int                        id;
+  mystl::intrusive_list_hook all_hook;
+  mystl::intrusive_list_hook ready_hook;
+
+  explicit list_item(int i = 0) :id(i) {}
+};
+
+std::ostream& operator<<(std::ostream& os, const list_item& x)
+{
+  return os << x.id;
+}
+
+void intrusive_list_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : intrusive_list -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  typedef mystl::intrusive_list<list_item, &list_item::all_hook>   all_list;
+  typedef mystl::intrusive_list<list_item, &list_item::ready_hook> ready_list;
+  list_item items[6];
+  for (int i = 0; i < 6; ++i)
+    items[i].id = i;
+  all_list l1(items, items + 6);
+  ready_list l2;
+  all_list l3;
+  FUN_AFTER(l2, l2.push_back(items[1]));
+  FUN_AFTER(l2, l2.push_front(items[3]));
+  FUN_AFTER(l2, l2.insert(l2.end(), items[5]));
+  FUN_VALUE(l1.size());
+  FUN_VALUE(l2.front());
+  FUN_VALUE(l2.back());
+  FUN_AFTER(l1, items[2].all_hook.unlink());
+  FUN_AFTER(l1, l1.remove(items[4]));
+  FUN_AFTER(l1, l1.erase(l1.iterator_to(items[0])));
+  FUN_AFTER(l1, l1.pop_back());
+  FUN_AFTER(l1, l1.reverse());
+  FUN_AFTER(l3, l3.push_back(items[2]));
+  FUN_AFTER(l3, l3.push_back(items[4]));
+  FUN_AFTER(l1, l1.splice(l1.begin(), l3));
+  FUN_AFTER(l1, l1.splice(l1.end(), l1, l1.begin()));
+  std::cout << std::boolalpha;
+  FUN_VALUE(l3.empty());
+  FUN_VALUE(items[0].all_hook.is_linked());
+  FUN_VALUE(items[3].ready_hook.is_linked());
+  std::cout << std::noboolalpha;
+  {
+    list_item tmp(9);
+    l2.push_back(tmp);
+    FUN_VALUE(l2.size());
+  }  // tmp 析构时自动断开
+  FUN_VALUE(l2.size());
+  FUN_AFTER(l2, l2.remove_if([](const list_item& x) { return is_odd(x.id); }));
+  all_list l4(std::move(l1));
+  FUN_VALUE(l1.size());
+  FUN_VALUE(l4.size());
+  FUN_AFTER(l4, l4.swap(l3));
+  FUN_AFTER(l3, l3.clear());
+  std::cout << std::boolalpha;
+  FUN_VALUE(items[1].all_hook.is_linked());
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[------------- End container test : intrusive_list -------------]" << std::endl;
+}
+
 } // namespace list_test
 } // namespace test
 } // namespace mystl
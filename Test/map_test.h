@@ -5,6 +5,7 @@
 
 #include <map>
 
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/map.h"
 #include "../MyTinySTL/vector.h"
 #include "test.h"
@@ -101,6 +102,51 @@ void map_test()
   FUN_VALUE(m1.empty());
   std::cout << std::noboolalpha;
   FUN_VALUE(m1.size());
+  mystl::map<mystl::string, int, mystl::less<>> m11;
+  m11.emplace("apple", 1);
+  m11.emplace("banana", 2);
+  m11.emplace("cherry", 3);
+  FUN_VALUE(m11.find("banana")->second);
+  FUN_VALUE(m11.count("durian"));
+  FUN_VALUE(m11.lower_bound("b")->second);
+  FUN_VALUE(m11.upper_bound("banana")->second);
+  FUN_VALUE(mystl::distance(m11.equal_range("cherry").first, m11.equal_range("cherry").second));
+  std::cout << std::boolalpha;
+  FUN_VALUE(m11.contains("apple"));
+  FUN_VALUE(m11.contains(mystl::string("fig")));
+  std::cout << std::noboolalpha;
+  // 有序的范围直接建成平衡树，相同键值保留第一个
+  mystl::vector<PAIR> v2{ PAIR(1,1),PAIR(2,2),PAIR(2,3),PAIR(4,4),PAIR(5,5),PAIR(5,6),PAIR(7,7) };
+  mystl::map<int, int> m12(v2.begin(), v2.end());
+  MAP_COUT(m12);
+  MAP_FUN_AFTER(m12, m12.emplace_hint(m12.end(), 8, 8));
+  MAP_FUN_AFTER(m12, m12.erase(2));
+  // 节点句柄：取出节点后修改键值再插回，合并时重复的键值留在原容器中
+  auto nh = m12.extract(4);
+  nh.key() = 3;
+  MAP_FUN_AFTER(m12, m12.insert(mystl::move(nh)));
+  std::cout << std::boolalpha;
+  FUN_VALUE(nh.empty());
+  FUN_VALUE(m12.insert(m12.extract(m12.begin())).inserted);
+  FUN_VALUE(m12.insert(m12.begin(), m12.extract(8))->first);
+  mystl::map<int, int, mystl::greater<int>> m13{ PAIR(1, 10), PAIR(6, 6), PAIR(9, 9) };
+  MAP_FUN_AFTER(m12, m12.merge(m13));
+  MAP_COUT(m13);
+  FUN_VALUE(m12.extract(100).empty());
+  // try_emplace 在键值已存在时不会移动参数
+  mystl::map<int, mystl::string> m14;
+  mystl::string s1("one");
+  FUN_VALUE(m14.try_emplace(1, mystl::move(s1)).second);
+  mystl::string s2("uno");
+  FUN_VALUE(m14.try_emplace(1, mystl::move(s2)).second);
+  FUN_VALUE(s2);
+  FUN_VALUE(m14.try_emplace(m14.end(), 3, 3, 'c')->second);
+  FUN_VALUE(m14.insert_or_assign(1, "ein").second);
+  FUN_VALUE(m14.insert_or_assign(m14.begin(), 2, "zwei")->second);
+  FUN_VALUE(m14[1]);
+  FUN_VALUE(m14[4].empty());
+  FUN_VALUE(m14.size());
+  std::cout << std::noboolalpha;
   FUN_VALUE(m1.max_size());
   PASSED;
 #if PERFORMANCE_TEST_ON
@@ -177,6 +223,14 @@ void multimap_test()
   FUN_VALUE(m1.empty());
   std::cout << std::noboolalpha;
   FUN_VALUE(m1.size());
+  mystl::vector<PAIR> v2{ PAIR(1,1),PAIR(2,2),PAIR(2,3),PAIR(4,4) };
+  mystl::multimap<int, int> m11(v2.begin(), v2.end());
+  MAP_COUT(m11);
+  MAP_FUN_AFTER(m11, m11.emplace_hint(m11.end(), 4, 5));
+  mystl::map<int, int> m12{ PAIR(2, 9), PAIR(3, 3) };
+  MAP_FUN_AFTER(m11, m11.merge(m12));
+  MAP_FUN_AFTER(m11, m11.insert(m11.extract(2)));
+  MAP_FUN_AFTER(m11, m11.insert(m11.end(), m11.extract(m11.begin())));
   FUN_VALUE(m1.max_size());
   PASSED;
 #if PERFORMANCE_TEST_ON
@@ -0,0 +1,227 @@
+﻿#ifndef MYTINYSTL_MEMORY_RESOURCE_TEST_H_
+#define MYTINYSTL_MEMORY_RESOURCE_TEST_H_
+
+// memory_resource test : 测试 pmr 内存资源与 polymorphic_allocator 的接口，
+// 并比较模拟请求处理时 mystl::allocator 与各内存资源的性能
+
+#include "../MyTinySTL/memory_resource.h"
+#include "../MyTinySTL/vector.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/astring.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace memory_resource_test
+{
+
+// 统计经由它分配而尚未归还的字节数与分配次数
+class counting_resource :public mystl::pmr::memory_resource
+{
+public:
+  size_t live  = 0;
+  size_t count = 0;
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    live += bytes;
+    ++count;
+    return mystl::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void  do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    live -= bytes;
+    mystl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool  do_is_equal(const mystl::pmr::memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// 模拟一次请求：构造若干短生命周期的 vector, map, string，请求结束时全部析构
+template <class Vec, class Map, class Str, class Alloc>
+size_t handle_request(const Alloc& alloc, size_t len)
+{
+  Vec v(alloc);
+  Map m(mystl::less<int>(), alloc);
+  for (size_t i = 0; i < len; ++i)
+  {
+    v.push_back(static_cast<int>(i));
+    m.emplace(static_cast<int>(i * 7 % len), static_cast<int>(i));
+  }
+  Str s("request:", alloc);
+  for (size_t i = 0; i < len; ++i)
+    s += static_cast<char>('a' + i % 26);
+  return v.size() + m.size() + s.size();
+}
+
+typedef mystl::vector<int>                            std_vec;
+typedef mystl::map<int, int>                          std_map;
+typedef mystl::pmr::vector<int>                       pmr_vec;
+typedef mystl::pmr::map<int, int>                     pmr_map;
+typedef mystl::pmr::polymorphic_allocator<int>        pmr_alloc;
+
+// 每次请求处理 100 个元素，共 count / 100 次请求
+#define REQUEST_DO_TEST(mode, count) do {                      \
+  clock_t start, end;                                          \
+  char buf[10];                                                \
+  size_t sink = 0;                                             \
+  const size_t rounds = count / 100;                           \
+  start = clock();                                             \
+  if (mode == 0)                                               \
+  {                                                            \
+    for (size_t r = 0; r < rounds; ++r)                        \
+      sink += handle_request<std_vec, std_map, mystl::string>( \
+        mystl::allocator<int>(), 100);                         \
+  }                                                            \
+  else if (mode == 1)                                          \
+  {                                                            \
+    char arena[16384];                                         \
+    for (size_t r = 0; r < rounds; ++r)                        \
+    {                                                          \
+      mystl::pmr::monotonic_buffer_resource res(arena, sizeof(arena)); \
+      sink += handle_request<pmr_vec, pmr_map, mystl::pmr::string>( \
+        pmr_alloc(&res), 100);                                 \
+    }                                                          \
+  }                                                            \
+  else                                                         \
+  {                                                            \
+    mystl::pmr::unsynchronized_pool_resource res;              \
+    for (size_t r = 0; r < rounds; ++r)                        \
+      sink += handle_request<pmr_vec, pmr_map, mystl::pmr::string>( \
+        pmr_alloc(&res), 100);                                 \
+  }                                                            \
+  end = clock();                                               \
+  int n = static_cast<int>(static_cast<double>(end - start)    \
+      / CLOCKS_PER_SEC * 1000);                                \
+  std::snprintf(buf, sizeof(buf), "%d", n);                    \
+  std::string t = buf;                                         \
+  t += "ms    |";                                              \
+  std::cout << std::setw(WIDE) << t;                           \
+  volatile size_t keep = sink;                                 \
+  (void)keep;                                                  \
+} while(0)
+
+#define REQUEST_TEST(len1, len2, len3)                         \
+  TEST_LEN(len1, len2, len3, WIDE);                            \
+  std::cout << "|      allocator      |";                      \
+  REQUEST_DO_TEST(0, len1);                                    \
+  REQUEST_DO_TEST(0, len2);                                    \
+  REQUEST_DO_TEST(0, len3);                                    \
+  std::cout << "\n|      monotonic      |";                    \
+  REQUEST_DO_TEST(1, len1);                                    \
+  REQUEST_DO_TEST(1, len2);                                    \
+  REQUEST_DO_TEST(1, len3);                                    \
+  std::cout << "\n| unsynchronized_pool |";                    \
+  REQUEST_DO_TEST(2, len1);                                    \
+  REQUEST_DO_TEST(2, len2);                                    \
+  REQUEST_DO_TEST(2, len3);
+
+void memory_resource_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : memory_resource -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  counting_resource upstream;
+  {
+    // 初始缓冲区用完之后才向 upstream 申请
+    char buf[256];
+    mystl::pmr::monotonic_buffer_resource mono(buf, sizeof(buf), &upstream);
+    pmr_vec v1(&mono);
+    for (int i = 0; i < 10; ++i)
+      v1.push_back(i);
+    FUN_VALUE(upstream.count);
+    for (int i = 0; i < 1000; ++i)
+      v1.push_back(i);
+    FUN_VALUE(v1.size());
+    std::cout << std::boolalpha;
+    FUN_VALUE((upstream.count > 0));
+    FUN_VALUE((v1.get_allocator().resource() == &mono));
+    std::cout << std::noboolalpha;
+    mono.release();
+    FUN_VALUE(upstream.live);
+  }
+  FUN_VALUE(upstream.live);
+  {
+    // 嵌套的容器也从同一内存资源分配
+    mystl::pmr::unsynchronized_pool_resource pool(&upstream);
+    mystl::pmr::vector<mystl::pmr::string> vs(&pool);
+    vs.emplace_back("mytinystl");
+    vs.push_back(mystl::pmr::string("memory_resource"));
+    vs.resize(3);
+    std::cout << std::boolalpha;
+    FUN_VALUE((vs[0].get_allocator().resource() == &pool));
+    FUN_VALUE((vs[1].get_allocator().resource() == &pool));
+    FUN_VALUE((vs[2].get_allocator().resource() == &pool));
+    mystl::pmr::vector<mystl::pmr::string> vs2(vs, &pool);
+    FUN_VALUE((vs2[1].get_allocator().resource() == &pool));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(vs[1]);
+
+    mystl::pmr::map<int, int> m(&pool);
+    mystl::pmr::unordered_map<int, int> um(&pool);
+    for (int i = 0; i < 100; ++i)
+    {
+      m.emplace(i, i);
+      um.emplace(i, i);
+    }
+    FUN_VALUE(m.size());
+    FUN_VALUE(um.size());
+    // 复制容器时使用默认的内存资源
+    mystl::pmr::map<int, int> m2(m);
+    std::cout << std::boolalpha;
+    FUN_VALUE((m2.get_allocator().resource() == mystl::pmr::get_default_resource()));
+    FUN_VALUE((m2 == m));
+    std::cout << std::noboolalpha;
+  }
+  FUN_VALUE(upstream.live);
+  {
+    // 超过 largest_required_pool_block 的请求直接交给 upstream
+    mystl::pmr::synchronized_pool_resource pool(mystl::pmr::pool_options(64, 512), &upstream);
+    FUN_VALUE(pool.options().largest_required_pool_block);
+    void* p1 = pool.allocate(100);
+    void* p2 = pool.allocate(4000, 64);
+    std::cout << std::boolalpha;
+    FUN_VALUE((reinterpret_cast<uintptr_t>(p2) % 64 == 0));
+    std::cout << std::noboolalpha;
+    pool.deallocate(p2, 4000, 64);
+    pool.deallocate(p1, 100);
+    void* p3 = pool.allocate(100);
+    std::cout << std::boolalpha;
+    FUN_VALUE((p3 == p1));
+    std::cout << std::noboolalpha;
+  }
+  FUN_VALUE(upstream.live);
+  try
+  {
+    mystl::pmr::null_memory_resource()->allocate(1);
+  }
+  catch (const std::bad_alloc&)
+  {
+    std::cout << " null_memory_resource()->allocate(1) : bad_alloc\n";
+  }
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       request       |";
+#if LARGER_TEST_DATA_ON
+  REQUEST_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  REQUEST_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End container test : memory_resource -------------]" << std::endl;
+}
+
+} // namespace memory_resource_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_MEMORY_RESOURCE_TEST_H_
+
@@ -0,0 +1,275 @@
+﻿#ifndef MYTINYSTL_PERSISTENT_TEST_H_
+#define MYTINYSTL_PERSISTENT_TEST_H_
+
+// persistent test : 测试 persistent_vector 与 persistent_map 的接口，以及各个版本之间互不影响
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../MyTinySTL/persistent_map.h"
+#include "../MyTinySTL/persistent_vector.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace persistent_test
+{
+
+void persistent_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------- Run container test : persistent_vector -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::persistent_vector<int> v1;
+  mystl::persistent_vector<int> v2(10, 5);
+  mystl::persistent_vector<int> v3(a, a + 5);
+  mystl::persistent_vector<int> v4(v2);
+  mystl::persistent_vector<int> v5(mystl::move(v4));
+  mystl::persistent_vector<int> v6{ 1,2,3,4,5,6,7,8,9 };
+  mystl::persistent_vector<int> v7;
+  v7 = v3;
+  mystl::persistent_vector<int> v8;
+  v8 = mystl::move(v7);
+  mystl::persistent_vector<int> v9;
+  v9 = { 1,2,3,4,5,6,7,8,9 };
+  std::cout << std::boolalpha;
+
+  FUN_AFTER(v1, v1.push_back(6));
+  FUN_AFTER(v1, v1.emplace_back(7));
+  FUN_AFTER(v3, v3.set(2, 0));
+  FUN_AFTER(v3, v3.pop_back());
+  FUN_AFTER(v6, v6.swap(v3));
+  FUN_AFTER(v6, v6.clear());
+  FUN_VALUE(v3.size());
+  FUN_VALUE(v3.empty());
+  FUN_VALUE(v3.front());
+  FUN_VALUE(v3.back());
+  FUN_VALUE(v3[4]);
+  FUN_VALUE(v3.at(8));
+  FUN_VALUE(*(v3.begin() + 3));
+  FUN_VALUE(*v3.rbegin());
+  FUN_VALUE((v8 < v9));
+  FUN_VALUE((v8 == mystl::persistent_vector<int>{ 1,2,3,4,5 }));
+
+  // 修改一个版本不影响复制前后的其它版本
+  mystl::persistent_vector<int> base;
+  for (int i = 0; i < 5000; ++i)
+    base.push_back(i);
+  mystl::persistent_vector<int> next(base);
+  FUN_VALUE(next.shares_with(base));
+  for (int i = 0; i < 5000; i += 3)
+    next.set(i, -i);
+  for (int i = 0; i < 1000; ++i)
+    next.pop_back();
+  for (int i = 0; i < 2000; ++i)
+    next.push_back(i);
+  bool same = base.size() == 5000 && next.size() == 6000;
+  for (int i = 0; same && i < 5000; ++i)
+    same = base[i] == i && (i >= 4000 || next[i] == (i % 3 == 0 ? -i : i));
+  for (int i = 0; same && i < 2000; ++i)
+    same = next[4000 + i] == i;
+  FUN_VALUE(same);
+  FUN_VALUE(next.shares_with(base));
+
+  // 与 std::vector 对照：随机地增删、修改并保留若干历史版本
+  std::vector<mystl::persistent_vector<std::string>> versions;
+  std::vector<std::vector<std::string>> expects;
+  mystl::persistent_vector<std::string> cur;
+  std::vector<std::string> ref;
+  srand(5);
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int op = rand() % 10;
+    if (op < 6 || ref.empty())
+    {
+      cur.push_back(std::to_string(i));
+      ref.push_back(std::to_string(i));
+    }
+    else if (op < 8)
+    {
+      cur.pop_back();
+      ref.pop_back();
+    }
+    else
+    {
+      const size_t k = rand() % ref.size();
+      cur.set(k, std::to_string(-i));
+      ref[k] = std::to_string(-i);
+    }
+    if (i % 1000 == 0)
+    {
+      versions.push_back(cur);
+      expects.push_back(ref);
+    }
+  }
+  versions.push_back(cur);
+  expects.push_back(ref);
+  same = true;
+  for (size_t i = 0; same && i < versions.size(); ++i)
+  {
+    same = versions[i].size() == expects[i].size() &&
+      mystl::equal(versions[i].begin(), versions[i].end(), expects[i].begin());
+  }
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[---------- End container test : persistent_vector -------------]" << std::endl;
+}
+
+void persistent_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : persistent_map ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<PAIR> v;
+  for (int i = 0; i < 5; ++i)
+    v.push_back(PAIR(i, i));
+  mystl::persistent_map<int, int> m1;
+  mystl::persistent_map<int, int, mystl::greater<int>> m2(mystl::greater<int>{});
+  mystl::persistent_map<int, int> m3(v.begin(), v.end());
+  mystl::persistent_map<int, int> m4(m3);
+  mystl::persistent_map<int, int> m5(mystl::move(m4));
+  mystl::persistent_map<int, int> m6{ PAIR(1,1),PAIR(2,2),PAIR(3,3) };
+  mystl::persistent_map<int, int> m7;
+  m7 = m3;
+  mystl::persistent_map<int, int> m8;
+  m8 = mystl::move(m7);
+  mystl::persistent_map<int, int> m9;
+  m9 = { PAIR(1,1),PAIR(2,2),PAIR(3,3) };
+  std::cout << std::boolalpha;
+
+  MAP_FUN_AFTER(m1, m1.insert(PAIR(5, 5)));
+  MAP_FUN_AFTER(m1, m1.try_emplace(1, 1));
+  MAP_FUN_AFTER(m1, m1.insert_or_assign(5, 50));
+  MAP_FUN_AFTER(m1, m1.insert_or_assign(3, 3));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  MAP_FUN_AFTER(m1, m1.erase(4));
+  MAP_FUN_AFTER(m2, m2.insert(PAIR(1, 1)));
+  MAP_FUN_AFTER(m2, m2.insert(PAIR(2, 2)));
+  MAP_FUN_AFTER(m6, m6.swap(m1));
+  MAP_FUN_AFTER(m6, m6.clear());
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.empty());
+  FUN_VALUE(m1.at(2));
+  FUN_VALUE(m1.count(3));
+  FUN_VALUE(m1.contains(4));
+  FUN_VALUE(m1.find(3)->second);
+  FUN_VALUE(m3.lower_bound(2)->first);
+  FUN_VALUE(m3.upper_bound(2)->first);
+  FUN_VALUE((m3.equal_range(5).first == m3.end()));
+  FUN_VALUE((m5 == m8));
+  FUN_VALUE((m9 < m3));
+  bool thrown = false;
+  try
+  {
+    m1.at(100);
+  }
+  catch (const std::out_of_range&)
+  {
+    thrown = true;
+  }
+  FUN_VALUE(thrown);
+
+  // 与 std::map 对照：随机地插入、赋值、删除并保留若干历史版本
+  std::vector<mystl::persistent_map<int, std::string>> versions;
+  std::vector<std::map<int, std::string>> expects;
+  mystl::persistent_map<int, std::string> cur;
+  std::map<int, std::string> ref;
+  srand(7);
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int k = rand() % 3000;
+    const int op = rand() % 10;
+    if (op < 5)
+    {
+      cur.insert(mystl::make_pair(k, std::to_string(i)));
+      ref.emplace(k, std::to_string(i));
+    }
+    else if (op < 7)
+    {
+      cur.insert_or_assign(k, std::to_string(-i));
+      ref[k] = std::to_string(-i);
+    }
+    else
+    {
+      cur.erase(k);
+      ref.erase(k);
+    }
+    if (i % 1000 == 0)
+    {
+      versions.push_back(cur);
+      expects.push_back(ref);
+    }
+  }
+  versions.push_back(cur);
+  expects.push_back(ref);
+  bool same = true;
+  for (size_t i = 0; same && i < versions.size(); ++i)
+  {
+    same = versions[i].size() == expects[i].size();
+    auto it = expects[i].begin();
+    for (auto& kv : versions[i])
+    {
+      same = same && kv.first == it->first && kv.second == it->second;
+      ++it;
+    }
+  }
+  FUN_VALUE(same);
+
+  // 写者在锁内发布新版本，读者复制当前版本后不加锁地遍历
+  std::mutex mutex;
+  mystl::persistent_map<int, int> current;
+  bool consistent = true;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r)
+  {
+    readers.emplace_back([&]
+    {
+      bool ok = true;
+      for (int i = 0; i < 500; ++i)
+      {
+        mystl::persistent_map<int, int> snap;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          snap = current;
+        }
+        for (auto& kv : snap)
+          ok = ok && kv.second == kv.first * 2;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      consistent = consistent && ok;
+    });
+  }
+  for (int i = 0; i < 5000; ++i)
+  {
+    mystl::persistent_map<int, int> next;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      next = current;
+    }
+    next.insert_or_assign(i % 200, i % 200 * 2);
+    if (i % 3 == 0)
+      next.erase(i * 7 % 200);
+    std::lock_guard<std::mutex> lock(mutex);
+    current = next;
+  }
+  for (auto& t : readers)
+    t.join();
+  FUN_VALUE(consistent);
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[------------ End container test : persistent_map ---------------]" << std::endl;
+}
+
+} // namespace persistent_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_PERSISTENT_TEST_H_
+
@@ -1,11 +1,15 @@
 ﻿#ifndef MYTINYSTL_QUEUE_TEST_H_
 #define MYTINYSTL_QUEUE_TEST_H_
 
-// queue test : 测试 queue, priority_queue 的接口和它们 push 的性能
+// queue test : 测试 queue, priority_queue, ring_buffer, indexed_priority_queue, pairing_heap 的接口和它们 push 的性能
 
 #include <queue>
 
 #include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/ring_buffer.h"
+#include "../MyTinySTL/indexed_priority_queue.h"
+#include "../MyTinySTL/pairing_heap.h"
+#include "../MyTinySTL/astring.h"
 #include "test.h"
 
 namespace mystl
@@ -104,6 +108,28 @@ void queue_test()
   }
   QUEUE_FUN_AFTER(q1, q1.swap(q4));
   QUEUE_FUN_AFTER(q1, q1.clear());
+
+  // 以 ring_buffer 作为底层容器，头尾下标越过容量后回绕
+  mystl::queue<int, mystl::ring_buffer<int>> q13;
+  for (int i = 0; i < 100; ++i)
+  {
+    q13.push(i);
+    if (i % 3 == 0)
+      q13.pop();
+  }
+  FUN_VALUE(q13.size());
+  FUN_VALUE(q13.front());
+  FUN_VALUE(q13.back());
+  mystl::queue<int, mystl::fixed_ring_buffer<int, 8>> q14;
+  for (int i = 0; i < 20; ++i)
+  {
+    q14.push(i);
+    if (q14.size() == 8)
+      q14.pop();
+  }
+  FUN_VALUE(q14.size());
+  FUN_VALUE(q14.front());
+  FUN_VALUE(q14.back());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -121,6 +147,108 @@ void queue_test()
   std::cout << "[----------------- End container test : queue ------------------]" << std::endl;
 }
 
+void ring_buffer_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : ring_buffer ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::ring_buffer<int> r1;
+  mystl::ring_buffer<int> r2(5);
+  mystl::ring_buffer<int> r3(5, 1);
+  mystl::ring_buffer<int> r4(a, a + 5);
+  mystl::ring_buffer<int> r5(r2);
+  mystl::ring_buffer<int> r6(std::move(r2));
+  mystl::ring_buffer<int> r7;
+  r7 = r3;
+  mystl::ring_buffer<int> r8;
+  r8 = std::move(r3);
+  mystl::ring_buffer<int> r9{ 1,2,3,4,5,6,7,8,9 };
+  mystl::ring_buffer<int> r10;
+  r10 = { 1,2,3,4,5,6,7,8,9 };
+
+  FUN_AFTER(r1, r1.push_back(1));
+  FUN_AFTER(r1, r1.push_front(2));
+  FUN_AFTER(r1, r1.emplace_back(3));
+  FUN_AFTER(r1, r1.emplace_front(4));
+  FUN_AFTER(r1, r1.pop_back());
+  FUN_AFTER(r1, r1.pop_front());
+  FUN_AFTER(r1, r1.reserve(20));
+  FUN_AFTER(r1, r1.shrink_to_fit());
+  FUN_AFTER(r1, r1.swap(r9));
+  FUN_AFTER(r1, r1.clear());
+  FUN_AFTER(r1, r1.swap(r4));
+  FUN_VALUE(*(r1.begin()));
+  FUN_VALUE(*(r1.end() - 1));
+  FUN_VALUE(*(r1.rbegin()));
+  FUN_VALUE(r1.front());
+  FUN_VALUE(r1.back());
+  FUN_VALUE(r1.at(1));
+  FUN_VALUE(r1[2]);
+  std::cout << std::boolalpha;
+  FUN_VALUE(r1.empty());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(r1.size());
+  FUN_VALUE(r1.capacity());
+
+  // 元素跨越缓冲区末尾时扩容，仍保持原有顺序
+  mystl::ring_buffer<mystl::string> r11;
+  for (int i = 0; i < 6; ++i)
+    r11.emplace_back(1, static_cast<char>('a' + i));
+  r11.pop_front();
+  r11.pop_front();
+  for (int i = 0; i < 8; ++i)
+    r11.emplace_back(1, static_cast<char>('A' + i));
+  r11.emplace_front("front");
+  FUN_VALUE(r11.size());
+  FUN_VALUE(r11.capacity());
+  FUN_VALUE(r11.front());
+  FUN_VALUE(r11[1]);
+  FUN_VALUE(r11.back());
+
+  mystl::fixed_ring_buffer<int, 4> r12{ 1,2,3 };
+  FUN_AFTER(r12, r12.push_front(0));
+  std::cout << std::boolalpha;
+  FUN_VALUE(r12.full());
+  std::cout << std::noboolalpha;
+  FUN_AFTER(r12, r12.pop_front());
+  FUN_AFTER(r12, r12.push_back(4));
+  PASSED;
+  std::cout << "[-------------- End container test : ring_buffer ---------------]" << std::endl;
+}
+
+// 比较不同堆策略下先 push 再全部 pop 的性能
+#define PQ_POLICY_DO_TEST(policy, len) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mystl::priority_queue<int, mystl::vector<int>,             \
+    mystl::less<int>, mystl::policy> c;                      \
+  char buf[10];                                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+    c.push(rand());                                          \
+  while (!c.empty())                                         \
+    c.pop();                                                 \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define PQ_POLICY_TEST(len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|       binary        |";                    \
+  PQ_POLICY_DO_TEST(heap_binary_policy, len1);               \
+  PQ_POLICY_DO_TEST(heap_binary_policy, len2);               \
+  PQ_POLICY_DO_TEST(heap_binary_policy, len3);               \
+  std::cout << "\n|        4-ary        |";                  \
+  PQ_POLICY_DO_TEST(heap_4ary_policy, len1);                 \
+  PQ_POLICY_DO_TEST(heap_4ary_policy, len2);                 \
+  PQ_POLICY_DO_TEST(heap_4ary_policy, len3);
+
 void priority_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -156,12 +284,33 @@ void priority_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(p1.size());
   FUN_VALUE(p1.top());
+  FUN_VALUE(p1.pop_value());
   while (!p1.empty())
   {
     P_QUEUE_FUN_AFTER(p1, p1.pop());
   }
+  // pop_value 把堆顶移动出来
+  mystl::priority_queue<mystl::string> p14;
+  p14.push(mystl::string(40, 'a'));
+  p14.emplace(40, 'c');
+  p14.push(mystl::string(40, 'b'));
+  FUN_VALUE(p14.pop_value());
+  FUN_VALUE(p14.top());
   P_QUEUE_FUN_AFTER(p1, p1.swap(p4));
   P_QUEUE_FUN_AFTER(p1, p1.clear());
+  // 4 叉堆策略与二叉堆的出队顺序相同
+  mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>, mystl::heap_4ary_policy>
+    p13{ 5,1,9,3,7,2,8,6,4,0 };
+  p13.push(11);
+  p13.emplace(10);
+  FUN_VALUE(p13.size());
+  std::cout << " p13 :";
+  while (!p13.empty())
+  {
+    std::cout << " " << p13.top();
+    p13.pop();
+  }
+  std::cout << std::endl;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -171,6 +320,14 @@ void priority_test()
   CON_TEST_P1(priority_queue<int>, push, rand(), SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
 #else
   CON_TEST_P1(priority_queue<int>, push, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   policy push/pop   |";
+#if LARGER_TEST_DATA_ON
+  PQ_POLICY_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  PQ_POLICY_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
@@ -179,6 +336,117 @@ void priority_test()
   std::cout << "[------------- End container test : priority_queue -------------]" << std::endl;
 }
 
+void indexed_priority_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------- Run container test : indexed_priority_queue ---------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::indexed_priority_queue<int> q1{ 5,1,9,3,7 };
+  mystl::indexed_priority_queue<int> q2(q1);
+  mystl::indexed_priority_queue<int> q3(std::move(q2));
+  mystl::indexed_priority_queue<int> q4;
+  q4 = q3;
+  FUN_VALUE(q1.size());
+  FUN_VALUE(q1.top());
+  auto h = q1.push(4);
+  FUN_VALUE(q1[h]);
+  q1.increase_key(h, 10);
+  FUN_VALUE(q1.top());
+  FUN_VALUE((q1.top_handle() == h));
+  q1.decrease_key(h, 0);
+  FUN_VALUE(q1.top());
+  q1.update(h, 6);
+  FUN_VALUE(q1.at(h));
+  q1.erase(0);  // 句柄 0 对应最先插入的 5
+  std::cout << std::boolalpha;
+  FUN_VALUE(q1.contains(0));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(q1.push(8));  // 复用句柄 0
+  std::cout << " q1 :";
+  while (!q1.empty())
+  {
+    std::cout << " " << q1.top();
+    q1.pop();
+  }
+  std::cout << std::endl;
+
+  // 以 mystl::greater 作为比较方式的最短路
+  const int n = 6;
+  const int w[n][n] = {
+    { 0, 7, 9, 0, 0,14 },
+    { 7, 0,10,15, 0, 0 },
+    { 9,10, 0,11, 0, 2 },
+    { 0,15,11, 0, 6, 0 },
+    { 0, 0, 0, 6, 0, 9 },
+    {14, 0, 2, 0, 9, 0 } };
+  mystl::indexed_priority_queue<mystl::pair<int, int>, mystl::greater<mystl::pair<int, int>>> q5;
+  size_t handle[n];
+  int dist[n];
+  for (int i = 0; i < n; ++i)
+  {
+    dist[i] = i == 0 ? 0 : 1000;
+    handle[i] = q5.push(mystl::make_pair(dist[i], i));
+  }
+  while (!q5.empty())
+  {
+    const int u = q5.top().second;
+    q5.pop();
+    for (int v = 0; v < n; ++v)
+    {
+      if (w[u][v] && q5.contains(handle[v]) && dist[u] + w[u][v] < dist[v])
+      {
+        dist[v] = dist[u] + w[u][v];
+        q5.increase_key(handle[v], mystl::make_pair(dist[v], v));
+      }
+    }
+  }
+  std::cout << " dist :";
+  for (int i = 0; i < n; ++i)
+    std::cout << " " << dist[i];
+  std::cout << std::endl;
+  PASSED;
+  std::cout << "[--------- End container test : indexed_priority_queue ---------]" << std::endl;
+}
+
+void pairing_heap_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : pairing_heap --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,1,9,3,7 };
+  mystl::pairing_heap<int> h1(a, a + 5);
+  mystl::pairing_heap<int> h2{ 8,2,6 };
+  mystl::pairing_heap<int> h3(h1);
+  mystl::pairing_heap<int> h4(std::move(h3));
+  mystl::pairing_heap<int> h5;
+  h5 = h4;
+  FUN_VALUE(h1.size());
+  FUN_VALUE(h1.top());
+  auto k = h2.push(4);
+  h1.merge(h2);
+  FUN_VALUE(h1.size());
+  FUN_VALUE(h2.size());
+  h1.increase_key(k, 12);
+  FUN_VALUE(h1.top());
+  h1.decrease_key(k, -1);
+  FUN_VALUE(h1.top());
+  FUN_VALUE(*k);
+  h1.update(k, 4);
+  auto e = h1.push(100);
+  h1.erase(e);
+  std::cout << " h1 :";
+  while (!h1.empty())
+  {
+    std::cout << " " << h1.top();
+    h1.pop();
+  }
+  std::cout << std::endl;
+  FUN_VALUE(h5.size());
+  FUN_VALUE(h5.top());
+  PASSED;
+  std::cout << "[-------------- End container test : pairing_heap --------------]" << std::endl;
+}
+
 } // namespace queue_test
 } // namespace test
 } // namespace mystl
@@ -1,11 +1,16 @@
 ﻿#ifndef MYTINYSTL_SET_TEST_H_
 #define MYTINYSTL_SET_TEST_H_
 
-// set test : 测试 set, multiset 的接口与它们 insert 的性能
+// set test : 测试 set, multiset 的接口与它们 insert 的性能，以及 intrusive_set, intrusive_multiset,
+//            order_statistic_set, order_statistic_multiset, order_statistic_map 的接口
 
 #include <set>
+#include <vector>
 
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/set.h"
+#include "../MyTinySTL/intrusive.h"
+#include "../MyTinySTL/order_statistic.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +20,25 @@ namespace test
 namespace set_test
 {
 
+// 使用紧凑节点的键，节点颜色保存在父节点指针的最低位
+struct compact_key
+{
+  int v;
+  compact_key(int x = 0) :v(x) {}
+  bool operator<(const compact_key& rhs) const { return v < rhs.v; }
+};
+
+} // namespace set_test
+} // namespace test
+
+template <>
+struct rb_tree_compact_node<test::set_test::compact_key> :public m_true_type {};
+
+namespace test
+{
+namespace set_test
+{
+
 void set_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -69,6 +93,18 @@ void set_test()
   FUN_VALUE(s1.empty());
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
+  // 节点句柄
+  mystl::set<int> s12{ 1, 3, 5 };
+  mystl::multiset<int> s13{ 1, 2, 2, 6 };
+  FUN_AFTER(s12, s12.merge(s13));
+  FUN_AFTER(s13, s13.insert(s12.extract(3)));
+  auto nh = s12.extract(s12.begin());
+  nh.value() = 4;
+  std::cout << std::boolalpha;
+  FUN_VALUE(s12.insert(mystl::move(nh)).inserted);
+  FUN_VALUE(s12.insert(s13.extract(2)).inserted);
+  std::cout << std::noboolalpha;
+  FUN_AFTER(s12, s12.insert(s12.end(), s13.extract(2)));
   FUN_VALUE(s1.max_size());
   PASSED;
 #if PERFORMANCE_TEST_ON
@@ -141,7 +177,52 @@ void multiset_test()
   FUN_VALUE(s1.empty());
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
+  mystl::multiset<mystl::string, mystl::less<>> s11{ "b", "a", "b", "c" };
+  FUN_VALUE(s11.count("b"));
+  FUN_VALUE(*s11.lower_bound("b"));
+  FUN_VALUE(mystl::distance(s11.equal_range("b").first, s11.equal_range("b").second));
+  std::cout << std::boolalpha;
+  FUN_VALUE((s11.find("d") == s11.end()));
+  FUN_VALUE(s11.contains("c"));
+  std::cout << std::noboolalpha;
   FUN_VALUE(s1.max_size());
+  // 紧凑节点：与普通节点做同样的随机插入删除，再与 std::multiset 比较
+  FUN_VALUE(sizeof(mystl::rb_tree_node<int>));
+  FUN_VALUE(sizeof(mystl::rb_tree_node<compact_key>));
+  mystl::multiset<compact_key> s12;
+  std::multiset<int> ref;
+  srand(11);
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int x = rand() % 3000;
+    if (rand() % 3 == 0)
+    {
+      s12.erase(x);
+      ref.erase(x);
+    }
+    else
+    {
+      s12.insert(x);
+      ref.insert(x);
+    }
+  }
+  mystl::multiset<compact_key> s13(s12);
+  bool same = s12.size() == ref.size() && s13.size() == ref.size();
+  auto it12 = s12.begin();
+  auto rit13 = s13.rbegin();
+  auto rref = ref.rbegin();
+  for (auto x : ref)
+  {
+    if (!same)
+      break;
+    same = it12->v == x && rit13->v == *rref && s12.count(x) == ref.count(x);
+    ++it12;
+    ++rit13;
+    ++rref;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -159,6 +240,176 @@ void multiset_test()
   std::cout << "[---------------- End container test : multiset ----------------]" << std::endl;
 }
 
+// intrusive_set 测试用的元素，可以同时位于 intrusive_set 与 intrusive_multiset 中
+struct set_item
+{
+  int                       key;
+  int                       group;
+  mystl::intrusive_set_hook key_hook;
+  mystl::intrusive_set_hook group_hook;
+
+  set_item(int k = 0, int g = 0) :key(k), group(g) {}
+};
+
+std::ostream& operator<<(std::ostream& os, const set_item& x)
+{
+  return os << x.key;
+}
+
+// 按 key 比较，也可以直接与 int 比较
+struct item_key_less
+{
+  bool operator()(const set_item& a, const set_item& b) const { return a.key < b.key; }
+  bool operator()(const set_item& a, int b) const { return a.key < b; }
+  bool operator()(int a, const set_item& b) const { return a < b.key; }
+};
+
+struct item_group_less
+{
+  bool operator()(const set_item& a, const set_item& b) const { return a.group < b.group; }
+  bool operator()(const set_item& a, int b) const { return a.group < b; }
+  bool operator()(int a, const set_item& b) const { return a < b.group; }
+};
+
+void intrusive_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : intrusive_set --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  typedef mystl::intrusive_set<set_item, &set_item::key_hook, item_key_less>            key_set;
+  typedef mystl::intrusive_multiset<set_item, &set_item::group_hook, item_group_less> group_set;
+  set_item items[8];
+  for (int i = 0; i < 8; ++i)
+  {
+    items[i].key = (i * 5) % 8;
+    items[i].group = i % 3;
+  }
+  set_item dup(3);
+  key_set s1(items, items + 8);
+  group_set s2(items, items + 8);
+  key_set s3;
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s2.size());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.insert(dup).second);
+  FUN_VALUE(dup.key_hook.is_linked());
+  FUN_VALUE(s1.contains(7));
+  FUN_VALUE((s1.find(8) == s1.end()));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(4));
+  FUN_VALUE(*s1.upper_bound(4));
+  FUN_VALUE(s2.count(1));
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  FUN_AFTER(s1, items[2].key_hook.unlink());
+  FUN_AFTER(s1, s1.remove(items[5]));
+  FUN_AFTER(s1, s1.erase(s1.iterator_to(items[0])));
+  FUN_AFTER(s1, s1.erase(6));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(4)));
+  FUN_AFTER(s2, s2.erase(2));
+  FUN_VALUE(s2.size());
+  {
+    set_item tmp(100, 1);
+    s2.insert(tmp);
+    FUN_VALUE(s2.count(1));
+  }  // tmp 析构时自动断开
+  FUN_VALUE(s2.count(1));
+  FUN_AFTER(s3, s3.insert(items[2]));
+  FUN_AFTER(s3, s3.swap(s1));
+  key_set s4(std::move(s3));
+  FUN_VALUE(s3.size());
+  FUN_VALUE(s4.size());
+  FUN_AFTER(s4, s4.clear());
+  std::cout << std::boolalpha;
+  FUN_VALUE(items[2].key_hook.is_linked());
+  FUN_VALUE(items[2].group_hook.is_linked());
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[------------- End container test : intrusive_set --------------]" << std::endl;
+}
+
+void order_statistic_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------- Run container test : order_statistic_set -----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 50,10,40,20,30 };
+  mystl::order_statistic_set<int> s1(a, a + 5);
+  mystl::order_statistic_set<int, mystl::greater<int>> s2(a, a + 5);
+  FUN_VALUE(*s1.nth(0));
+  FUN_VALUE(*s1.nth(3));
+  FUN_VALUE(*s2.nth(3));
+  FUN_VALUE(s1.rank(30));
+  FUN_VALUE(s1.rank(35));
+  FUN_VALUE(s2.rank(35));
+  FUN_VALUE(s1.index_of(s1.find(40)));
+  FUN_VALUE(s1.index_of(s1.end()));
+  FUN_VALUE(s1.distance(s1.find(20), s1.find(50)));
+  FUN_VALUE(mystl::distance(s1.begin(), s1.end()));
+  std::cout << std::boolalpha;
+  FUN_VALUE((s1.nth(5) == s1.end()));
+  std::cout << std::noboolalpha;
+  FUN_AFTER(s1, s1.erase(20));
+  FUN_AFTER(s1, s1.insert(25));
+  FUN_VALUE(*s1.nth(1));
+  FUN_VALUE(s1.rank(40));
+  mystl::order_statistic_multiset<int> ms1(a, a + 5);
+  FUN_AFTER(ms1, ms1.insert(a, a + 5));
+  FUN_AFTER(ms1, ms1.emplace(30));
+  FUN_VALUE(ms1.count(30));
+  FUN_VALUE(ms1.rank(30));
+  FUN_VALUE(*ms1.nth(6));
+  FUN_AFTER(ms1, ms1.erase(30));
+  FUN_VALUE(ms1.rank(40));
+  mystl::order_statistic_map<int, int> m1;
+  for (int i = 0; i < 5; ++i)
+    m1[a[i]] = i;
+  FUN_VALUE(m1.nth(2)->first);
+  FUN_VALUE(m1.nth(2)->second);
+  FUN_VALUE(m1.rank(45));
+  FUN_VALUE(m1.at(10));
+  // 随机插入删除之后与 std::multiset 逐一比较，包括复制与交换后的树
+  mystl::order_statistic_multiset<int> ms2;
+  std::multiset<int> ref;
+  srand(7);
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int x = rand() % 5000;
+    if (rand() % 3 == 0)
+    {
+      ms2.erase(x);
+      ref.erase(x);
+    }
+    else
+    {
+      ms2.insert(x);
+      ref.insert(x);
+    }
+  }
+  mystl::order_statistic_multiset<int> ms3(ms2);
+  mystl::order_statistic_multiset<int> ms4;
+  ms4.swap(ms2);
+  std::vector<int> sorted(ref.begin(), ref.end());
+  mystl::order_statistic_multiset<int> ms5(sorted.data(), sorted.data() + sorted.size());  // 有序区间直接建树
+  bool same = ms3.size() == ref.size() && ms4.size() == ref.size() && ms5.size() == ref.size();
+  size_t k = 0, lo = 0;  // lo 为当前键值第一次出现的位置
+  for (auto it = ref.begin(); same && it != ref.end(); ++it, ++k)
+  {
+    if (it == ref.begin() || *std::prev(it) != *it)
+      lo = k;
+    same = *ms3.nth(k) == *it && *ms4.nth(k) == *it &&
+      ms3.rank(*it) == lo && ms4.count(*it) == ref.count(*it) &&
+      *ms5.nth(k) == *it && ms5.rank(*it) == lo &&
+      ms3.index_of(ms3.nth(k)) == k;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[----------- End container test : order_statistic_set -----------]" << std::endl;
+}
+
 } // namespace set_test
 } // namespace test
 } // namespace mystl
@@ -0,0 +1,138 @@
+﻿#ifndef MYTINYSTL_SNAPSHOT_TEST_H_
+#define MYTINYSTL_SNAPSHOT_TEST_H_
+
+// snapshot test : 测试 save_snapshot / load_snapshot 与 mapped_* 只读视图
+
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+
+#include "../MyTinySTL/snapshot.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace snapshot_test
+{
+
+void snapshot_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : snapshot -----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  const char* path = "mystl_snapshot_test.bin";
+  std::cout << std::boolalpha;
+
+  // vector 与 string
+  mystl::vector<double> v1;
+  for (int i = 0; i < 1000; ++i)
+    v1.push_back(i * 0.5);
+  mystl::save_snapshot(path, v1);
+  mystl::mapped_vector<double> mv(path);
+  FUN_VALUE(mv.size());
+  FUN_VALUE(mv[999]);
+  mystl::vector<double> v2;
+  mystl::load_snapshot(path, v2);
+  FUN_VALUE((v1 == v2));
+  mystl::string s1("position independent snapshot");
+  mystl::save_snapshot(path, s1);
+  mystl::mapped_string ms(path);
+  FUN_VALUE(ms.c_str());
+  FUN_VALUE((ms.view() == mystl::string_view("position independent snapshot")));
+  mystl::string s2;
+  mystl::load_snapshot(path, s2);
+  FUN_VALUE((s1 == s2));
+
+  // 有序容器：map 写出，mapped_flat_map 查找，读回 flat_multimap
+  mystl::multimap<int, int> m1;
+  srand(11);
+  std::multimap<int, int> ref;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int k = rand() % 8000;
+    m1.emplace(k, i);
+    ref.emplace(k, i);
+  }
+  mystl::save_snapshot(path, m1);
+  mystl::mapped_flat_map<int, int> mf(path);
+  FUN_VALUE(mf.size());
+  bool same = mf.size() == ref.size();
+  for (int k = -1; same && k <= 8000; ++k)
+  {
+    auto r = mf.equal_range(k);
+    auto rr = ref.equal_range(k);
+    same = static_cast<size_t>(r.second - r.first) == static_cast<size_t>(std::distance(rr.first, rr.second)) &&
+      (mf.find(k) == mf.end()) == (rr.first == rr.second) &&
+      static_cast<size_t>(mf.lower_bound(k) - mf.begin()) ==
+        static_cast<size_t>(std::distance(ref.begin(), ref.lower_bound(k))) &&
+      static_cast<size_t>(mf.upper_bound(k) - mf.begin()) ==
+        static_cast<size_t>(std::distance(ref.begin(), ref.upper_bound(k)));
+    for (auto it = r.first; same && it != r.second; ++it, ++rr.first)
+      same = it->first == rr.first->first && it->second == rr.first->second;
+  }
+  FUN_VALUE(same);
+  mystl::flat_multimap<int, int> fm;
+  mystl::load_snapshot(path, fm);
+  same = fm.size() == m1.size();
+  auto mit = m1.begin();
+  for (auto it = fm.begin(); same && it != fm.end(); ++it, ++mit)
+    same = it->first == mit->first && it->second == mit->second;
+  FUN_VALUE(same);
+  mystl::map<int, int> m2;
+  mystl::load_snapshot(path, m2);
+  FUN_VALUE(m2.size());
+
+  // 哈希容器：unordered_map 写出，mapped_unordered_map 查找，读回 unordered_map
+  mystl::unordered_map<long long, int> um1;
+  for (int i = 0; i < 50000; ++i)
+    um1[static_cast<long long>(i) * 7919] = i;
+  mystl::save_snapshot(path, um1);
+  mystl::mapped_unordered_map<long long, int> mu(path);
+  FUN_VALUE(mu.size());
+  FUN_VALUE(mu.bucket_count());
+  FUN_VALUE(mu.at(7919 * 100LL));
+  same = true;
+  for (long long k = 0; same && k < 50000LL * 7919; k += 1000)
+    same = mu.count(k) == um1.count(k) && (k % 7919 != 0 || mu.find(k)->second == k / 7919);
+  FUN_VALUE(same);
+  mystl::unordered_map<long long, int> um2;
+  mystl::load_snapshot(path, um2);
+  same = um2.size() == um1.size();
+  for (auto it = um1.begin(); same && it != um1.end(); ++it)
+    same = um2.find(it->first) != um2.end() && um2.find(it->first)->second == it->second;
+  FUN_VALUE(same);
+  mystl::unordered_multimap<int, int> umm1;
+  for (int i = 0; i < 3000; ++i)
+    umm1.emplace(i % 100, i);
+  mystl::save_snapshot(path, umm1);
+  mystl::mapped_unordered_map<int, int> mum(path);
+  FUN_VALUE(mum.count(42));
+  mystl::unordered_multimap<int, int> umm2;
+  mystl::load_snapshot(path, umm2);
+  FUN_VALUE(umm2.count(42));
+
+  // 视图移动之后仍然有效，类型不符时抛出异常
+  mystl::mapped_unordered_map<long long, int> mu2(mystl::move(mu));
+  FUN_VALUE(mu2.at(7919 * 200LL));
+  bool thrown = false;
+  try
+  {
+    mystl::mapped_flat_map<int, int> bad(path);
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  FUN_VALUE(thrown);
+  std::remove(path);
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[--------------- End container test : snapshot -----------------]" << std::endl;
+}
+
+} // namespace snapshot_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_SNAPSHOT_TEST_H_
@@ -0,0 +1,118 @@
+﻿#ifndef MYTINYSTL_STATIC_MAP_TEST_H_
+#define MYTINYSTL_STATIC_MAP_TEST_H_
+
+// static_map test : 测试 static_map, static_sorted_map 的编译期构建与查找，需要 C++14
+
+#include "../MyTinySTL/type_traits.h"
+
+#if MYSTL_HAS_CONSTEXPR14
+
+#include <stdexcept>
+
+#include "../MyTinySTL/static_map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace static_map_test
+{
+
+enum class method { get, head, post, put, del, options, patch };
+
+constexpr auto methods = mystl::make_static_map<mystl::string_view, method>({
+  { "GET", method::get }, { "HEAD", method::head }, { "POST", method::post },
+  { "PUT", method::put }, { "DELETE", method::del }, { "OPTIONS", method::options },
+  { "PATCH", method::patch } });
+
+constexpr auto method_names = mystl::make_static_map<method, mystl::string_view>({
+  { method::get, "GET" }, { method::head, "HEAD" }, { method::post, "POST" },
+  { method::put, "PUT" }, { method::del, "DELETE" }, { method::options, "OPTIONS" },
+  { method::patch, "PATCH" } });
+
+constexpr auto keywords = mystl::make_static_sorted_map<mystl::string_view, int>({
+  { "while", 7 }, { "if", 1 }, { "else", 2 }, { "for", 3 }, { "return", 6 },
+  { "do", 4 }, { "break", 5 }, { "continue", 8 } });
+
+// 在编译期完成构建与查找
+static_assert(methods.at("DELETE") == method::del, "static_map lookup");
+static_assert(!methods.contains("TRACE") && !methods.contains("get"), "static_map miss");
+static_assert(method_names.at(method::patch).size() == 5, "static_map enum key");
+static_assert(keywords.begin()->second == 5 && (keywords.end() - 1)->second == 7,
+              "static_sorted_map order");
+static_assert(keywords.lower_bound("e")->second == 2 && keywords.count("goto") == 0,
+              "static_sorted_map lookup");
+
+void static_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : static_map ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  std::cout << std::boolalpha;
+  FUN_VALUE(methods.size());
+  FUN_VALUE(static_cast<int>(methods.at(mystl::string_view("POST"))));
+  FUN_VALUE(methods.count(mystl::string_view("POS")));
+  FUN_VALUE(method_names.at(method::options).data());
+  FUN_VALUE(keywords.find(mystl::string_view("return"))->second);
+  FUN_VALUE(keywords.upper_bound(mystl::string_view("do"))->first.data());
+  FUN_VALUE((keywords.equal_range(mystl::string_view("for")).second -
+             keywords.equal_range(mystl::string_view("for")).first));
+  bool thrown = false;
+  try
+  {
+    (void)methods.at(mystl::string_view("TRACE"));
+  }
+  catch (const std::out_of_range&)
+  {
+    thrown = true;
+  }
+  FUN_VALUE(thrown);
+
+  // 运行期构建的大表，与 unordered_map 逐一比较
+  static mystl::pair<int, int> items[3000];
+  mystl::unordered_map<int, int> ref;
+  srand(5);
+  for (int i = 0; i < 3000; ++i)
+  {
+    int k = rand() % 1000000 * 7 + i;
+    while (ref.count(k))
+      ++k;
+    items[i] = mystl::pair<int, int>(k, i);
+    ref[k] = i;
+  }
+  static const mystl::static_map<int, int, 3000> big(items);
+  static const mystl::static_sorted_map<int, int, 3000> big_sorted(items);
+  bool same = true;
+  for (int i = 0; same && i < 3000; ++i)
+  {
+    same = big.at(items[i].first) == i && big_sorted.at(items[i].first) == i &&
+      big.count(items[i].first + 1) == ref.count(items[i].first + 1) &&
+      big_sorted.count(items[i].first + 1) == ref.count(items[i].first + 1);
+  }
+  for (auto it = big_sorted.begin(); same && it + 1 != big_sorted.end(); ++it)
+    same = it->first < (it + 1)->first;
+  FUN_VALUE(same);
+  mystl::pair<int, int> dup[] = { { 1, 1 }, { 2, 2 }, { 1, 3 } };
+  thrown = false;
+  try
+  {
+    mystl::static_map<int, int, 3> bad(dup);
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  FUN_VALUE(thrown);
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[-------------- End container test : static_map ----------------]" << std::endl;
+}
+
+} // namespace static_map_test
+} // namespace test
+} // namespace mystl
+
+#endif // MYSTL_HAS_CONSTEXPR14
+#endif // !MYTINYSTL_STATIC_MAP_TEST_H_
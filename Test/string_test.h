@@ -1,11 +1,12 @@
 ﻿#ifndef MYTINYSTL_STRING_TEST_H_
 #define MYTINYSTL_STRING_TEST_H_
 
-// string test : 测试 string 的接口和 insert 的性能
+// string test : 测试 string、string_view 的接口、insert 与短字符串操作的性能、拼接、切分、查找函数以及字符串哈希的吞吐量
 
 #include <string>
 
 #include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/vector.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +16,273 @@ namespace test
 namespace string_test
 {
 
+// 在 64KB 的键池中依次取长度为 len 的不同键计算哈希，总共处理约 256MB 数据，输出耗时
+// 计时循环中不写键，避免刚写入的字节被随后的读取覆盖而产生存储转发停顿
+#define HASH_BYTES_DO_TEST(fun, len) do {                    \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  const size_t keys = (size_t(64) << 10) / len;             \
+  mystl::vector<unsigned char> pool(keys * len);             \
+  for (size_t i = 0; i < pool.size(); ++i)                   \
+    pool[i] = static_cast<unsigned char>(i * 131 + i / len); \
+  const size_t count = (size_t(256) << 20) / len;          \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    sum += fun(pool.data() + (i & (keys - 1)) * len, len);   \
+  end = clock();                                             \
+  volatile size_t sink = sum;                                \
+  (void)sink;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define HASH_BYTES_TEST(fun)                                 \
+  HASH_BYTES_DO_TEST(fun, 8);                                \
+  HASH_BYTES_DO_TEST(fun, 64);                               \
+  HASH_BYTES_DO_TEST(fun, 512);                              \
+  HASH_BYTES_DO_TEST(fun, 4096);
+
+// 模拟日志与协议解析中的短字符串：mode 0 从字面量构造，mode 1 复制，mode 2 逐段 += 拼出一个短字符串
+#define STRING_SSO_DO_TEST(con, mode, len) do {              \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  const con src("GET /idx");                                 \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+  {                                                          \
+    if (mode == 0)                                           \
+    {                                                        \
+      con s("token");                                        \
+      sum += s.size();                                       \
+    }                                                        \
+    else if (mode == 1)                                      \
+    {                                                        \
+      con s(src);                                            \
+      sum += s.size();                                       \
+    }                                                        \
+    else                                                     \
+    {                                                        \
+      con s;                                                 \
+      s += "key";                                            \
+      s += '=';                                              \
+      s += src;                                              \
+      sum += s.size();                                       \
+    }                                                        \
+  }                                                          \
+  end = clock();                                             \
+  volatile size_t sink = sum;                                \
+  (void)sink;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define STRING_SSO_TEST(mode, len1, len2, len3)              \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  STRING_SSO_DO_TEST(std::string, mode, len1);               \
+  STRING_SSO_DO_TEST(std::string, mode, len2);               \
+  STRING_SSO_DO_TEST(std::string, mode, len3);               \
+  std::cout << "\n|        mystl        |";                  \
+  STRING_SSO_DO_TEST(mystl::string, mode, len1);             \
+  STRING_SSO_DO_TEST(mystl::string, mode, len2);             \
+  STRING_SSO_DO_TEST(mystl::string, mode, len3);
+
+// 模拟日志行的拼接，cat 为用 a、b、c、d 拼出一行的表达式
+#define STRING_CAT_DO_TEST(con, cat, len) do {               \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  const con a("2024-01-01 12:00:00.000 ");                   \
+  const con b("[worker-17] ");                               \
+  const con c("request handled in ");                        \
+  const con d("42 microseconds");                            \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+  {                                                          \
+    con s = cat;                                             \
+    sum += s.size();                                         \
+  }                                                          \
+  end = clock();                                             \
+  volatile size_t sink = sum;                                \
+  (void)sink;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define STRING_CAT_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|     std  a+b+c+d    |";                    \
+  STRING_CAT_DO_TEST(std::string, a + b + c + d, len1);      \
+  STRING_CAT_DO_TEST(std::string, a + b + c + d, len2);      \
+  STRING_CAT_DO_TEST(std::string, a + b + c + d, len3);      \
+  std::cout << "\n|    mystl a+b+c+d    |";                  \
+  STRING_CAT_DO_TEST(mystl::string, a + b + c + d, len1);    \
+  STRING_CAT_DO_TEST(mystl::string, a + b + c + d, len2);    \
+  STRING_CAT_DO_TEST(mystl::string, a + b + c + d, len3);    \
+  std::cout << "\n|    mystl str_cat    |";                  \
+  STRING_CAT_DO_TEST(mystl::string, mystl::str_cat(a, b, c, d), len1); \
+  STRING_CAT_DO_TEST(mystl::string, mystl::str_cat(a, b, c, d), len2); \
+  STRING_CAT_DO_TEST(mystl::string, mystl::str_cat(a, b, c, d), len3);
+
+// 把长度为 len 的文本按分隔符切成字段，总共扫描约 64MB 数据，输出耗时
+// field 为由 text 的 [pos, next) 得到字段的表达式
+#define STRING_SPLIT_DO_TEST(con, field, len) do {           \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  const con text(make_text(len, 0).c_str());                 \
+  const size_t rounds = (size_t(64) << 20) / len;            \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (size_t r = 0; r < rounds; ++r)                        \
+  {                                                          \
+    size_t pos = 0;                                          \
+    while (pos < text.size())                                \
+    {                                                        \
+      size_t next = text.find_first_of(" ,.;\n", pos);       \
+      if (next == con::npos)                                 \
+        next = text.size();                                  \
+      sum += (field).size();                                 \
+      pos = next + 1;                                        \
+    }                                                        \
+  }                                                          \
+  end = clock();                                             \
+  volatile size_t sink = sum;                                \
+  (void)sink;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define STRING_SPLIT_TEST(len1, len2, len3)                  \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|     std  substr     |";                    \
+  STRING_SPLIT_DO_TEST(std::string, text.substr(pos, next - pos), len1); \
+  STRING_SPLIT_DO_TEST(std::string, text.substr(pos, next - pos), len2); \
+  STRING_SPLIT_DO_TEST(std::string, text.substr(pos, next - pos), len3); \
+  std::cout << "\n|    mystl substr     |";                  \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr(pos, next - pos), len1); \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr(pos, next - pos), len2); \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr(pos, next - pos), len3); \
+  std::cout << "\n|  mystl substr_view  |";                  \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr_view(pos, next - pos), len1); \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr_view(pos, next - pos), len2); \
+  STRING_SPLIT_DO_TEST(mystl::string, text.substr_view(pos, next - pos), len3);
+
+// 生成长度为 len 的查找文本：mode 0 为由小写单词与分隔符组成的文本，mode 1 全部为 'a'
+inline std::string make_text(size_t len, int mode)
+{
+  std::string text(len, 'a');
+  if (mode == 1)
+    return text;
+  const char sep[] = "  ,.;\n";
+  uint32_t seed = 2463534242u;
+  for (size_t i = 0; i < len; ++i)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    text[i] = seed % 8 == 0 ? sep[(seed >> 8) % 6] : static_cast<char>('a' + (seed >> 8) % 26);
+  }
+  return text;
+}
+
+// 生成长度为 len 的模式串，mode 1 为 "aa...ab"，用于测试最坏情况
+inline std::string make_needle(size_t len, int mode)
+{
+  std::string needle(len, 'a');
+  if (mode == 1)
+  {
+    needle[len - 1] = 'b';
+    return needle;
+  }
+  for (size_t i = 0; i < len; ++i)
+    needle[i] = static_cast<char>('a' + (i * 7 + 3) % 26);
+  return needle;
+}
+
+// 在长度为 len 的文本中反复查找全部匹配位置，总共扫描约 64MB 数据，输出耗时
+// kind 0 查找字符，1~3 查找 4B / 16B / 64B 的子串，4 为周期性模式串，5 为 find_first_of，6 为 rfind
+#define STRING_FIND_DO_TEST(con, kind, len) do {             \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  const con text(make_text(len, kind == 4).c_str(), len);    \
+  const size_t nlen = kind == 1 ? 4 : kind == 2 || kind == 6 ? 16 : 64; \
+  const std::string nstr = make_needle(nlen, kind == 4);     \
+  const con needle(nstr.c_str(), nlen);                      \
+  const size_t rounds = (size_t(64) << 20) / len;            \
+  size_t hits = 0;                                           \
+  start = clock();                                           \
+  for (size_t r = 0; r < rounds; ++r)                        \
+  {                                                          \
+    size_t p = 0;                                            \
+    if (kind == 0)                                           \
+    {                                                        \
+      for (p = text.find('\n'); p != con::npos; p = text.find('\n', p + 1)) \
+        ++hits;                                              \
+    }                                                        \
+    else if (kind == 5)                                      \
+    {                                                        \
+      for (p = text.find_first_of(" ,.;\n"); p != con::npos; \
+           p = text.find_first_of(" ,.;\n", p + 1))          \
+        ++hits;                                              \
+    }                                                        \
+    else if (kind == 6)                                      \
+    {                                                        \
+      for (p = text.rfind(needle); p != con::npos && p != 0; \
+           p = text.rfind(needle, p - 1))                    \
+        ++hits;                                              \
+    }                                                        \
+    else                                                     \
+    {                                                        \
+      for (p = text.find(needle); p != con::npos; p = text.find(needle, p + 1)) \
+        ++hits;                                              \
+    }                                                        \
+  }                                                          \
+  end = clock();                                             \
+  volatile size_t sink = hits;                               \
+  (void)sink;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define STRING_FIND_TEST(kind, name)                         \
+  std::cout << "| std   " << name << "|";                    \
+  STRING_FIND_DO_TEST(std::string, kind, 1024);              \
+  STRING_FIND_DO_TEST(std::string, kind, 65536);             \
+  STRING_FIND_DO_TEST(std::string, kind, 1048576);           \
+  std::cout << "\n| mystl " << name << "|";                  \
+  STRING_FIND_DO_TEST(mystl::string, kind, 1024);            \
+  STRING_FIND_DO_TEST(mystl::string, kind, 65536);           \
+  STRING_FIND_DO_TEST(mystl::string, kind, 1048576);         \
+  std::cout << std::endl;
+
+inline size_t fnv1a_bytes(const unsigned char* p, size_t len)
+{ return mystl::bitwise_hash(p, len); }
+
+inline size_t word_bytes(const unsigned char* p, size_t len)
+{ return mystl::hash_bytes(p, len); }
+
 void string_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -184,6 +452,77 @@ void string_test()
   std::cout << " str3 + \" success\" : " << str3 + " success" << std::endl;
   std::cout << " \"My \" + str3 : " << "My " + str3 << std::endl;
   std::cout << " str3 + str4 : " << str3 + str4 << std::endl;
+  FUN_VALUE(mystl::hash<mystl::string>()(str3));
+  FUN_VALUE(mystl::hash_bytes(str3.data(), str3.size()));
+  FUN_VALUE(mystl::bitwise_hash((const unsigned char*)str3.data(), str3.size()));
+
+  // 短字符串存放在对象内部，超过 15 个字符才分配堆空间
+  mystl::string str14("token");
+  FUN_VALUE(str14.capacity());
+  STR_FUN_AFTER(str14, str14 += "-0123456789");
+  FUN_VALUE(str14.capacity());
+  STR_FUN_AFTER(str14, str14.erase(str14.begin() + 5, str14.end()));
+  STR_FUN_AFTER(str14, str14.shrink_to_fit());
+  FUN_VALUE(str14.capacity());
+  mystl::string str15(mystl::move(str14));
+  FUN_VALUE(str15);
+  FUN_VALUE(str14.size());
+  mystl::string str16(100, 'a');
+  str16 += "needle-in-a-haystack-with-a-long-tail!";
+  FUN_VALUE(str16.find("needle-in-a-haystack-with-a-long-tail"));
+  FUN_VALUE(str16.find("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaan"));
+  FUN_VALUE(str16.rfind("aaan"));
+  FUN_VALUE(str16.rfind("-a-"));
+  FUN_VALUE(str16.find_first_not_of('a'));
+  FUN_VALUE(str16.find_first_not_of("aen"));
+  FUN_VALUE(str16.find_first_of("!-", 100));
+  FUN_VALUE(str16.find_last_not_of("!lia"));
+  FUN_VALUE(str16.find_last_of('z'));
+  FUN_VALUE(str16.count('a'));
+  FUN_VALUE(mystl::string().rfind('a'));
+
+  // 拼接：右值的 operator+ 复用左侧的空间，str_cat / str_append 先求出总长度再一次分配
+  mystl::string str17 = str16.substr(100) + str3 + str4;
+  FUN_VALUE(str17);
+  FUN_VALUE(str17.capacity());
+  mystl::string str18 = mystl::str_cat("GET ", str3, ' ', 200, ' ', -15, ' ', 18446744073709551615ull);
+  FUN_VALUE(str18);
+  FUN_VALUE(str18.capacity());
+  STR_FUN_AFTER(str18, mystl::str_append(str18, " len=", str18.size(), ' ', str18));
+  STR_FUN_AFTER(str18, str18.resize_and_overwrite(8, [](char* p, size_t n)
+  {
+    for (size_t i = 4; i < n; ++i)
+      p[i] = 'x';
+    return n - 2;
+  }));
+  FUN_VALUE(mystl::str_cat<wchar_t>(L"id=", 42).size());
+
+  // string_view：不拥有字符，substr 与查找都不分配内存
+  mystl::string str19("GET /index.html HTTP/1.1");
+  mystl::string_view sv1 = str19;
+  mystl::string_view sv2 = sv1.substr(4, 11);
+  FUN_VALUE(sv2);
+  FUN_VALUE(sv2.size());
+  FUN_VALUE(str19.substr_view(16));
+  FUN_VALUE(sv1.find(' '));
+  FUN_VALUE(sv1.rfind("HTTP"));
+  FUN_VALUE(sv1.find_first_of("/."));
+  FUN_VALUE(str19.find(sv2));
+  FUN_VALUE(str19.compare(sv1));
+  std::cout << std::boolalpha;
+  FUN_VALUE((sv2 == "/index.html"));
+  FUN_VALUE((str19 == sv1));
+  FUN_VALUE(sv1.starts_with("GET"));
+  FUN_VALUE(sv1.ends_with('1'));
+  FUN_VALUE((mystl::hash<mystl::string_view>()(sv1) == mystl::hash<mystl::string>()(str19)));
+  std::cout << std::noboolalpha;
+  sv2.remove_prefix(1);
+  sv2.remove_suffix(5);
+  FUN_VALUE(sv2);
+  mystl::string str20(sv2);
+  STR_FUN_AFTER(str20, str20 += sv1.substr(15, 5));
+  STR_FUN_AFTER(str20, str20.append(mystl::string_view("/2")));
+  STR_FUN_AFTER(str20, str20 = sv1.substr(0, 3));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -196,6 +535,58 @@ void string_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|    sso construct    |";
+#if LARGER_TEST_DATA_ON
+  STRING_SSO_TEST(0, SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  STRING_SSO_TEST(0, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|      sso copy       |";
+#if LARGER_TEST_DATA_ON
+  STRING_SSO_TEST(1, SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  STRING_SSO_TEST(1, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   sso operator+=    |";
+#if LARGER_TEST_DATA_ON
+  STRING_SSO_TEST(2, SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  STRING_SSO_TEST(2, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|      concatenate    |";
+#if LARGER_TEST_DATA_ON
+  STRING_CAT_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  STRING_CAT_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     split (64MB)    |";
+  STRING_SPLIT_TEST(1024, 65536, 1048576);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     find (64MB)     |     1KB     |     64KB    |     1MB     |" << std::endl;
+  STRING_FIND_TEST(0, "find char     ");
+  STRING_FIND_TEST(1, "find 4B       ");
+  STRING_FIND_TEST(2, "find 16B      ");
+  STRING_FIND_TEST(3, "find 64B      ");
+  STRING_FIND_TEST(4, "find periodic ");
+  STRING_FIND_TEST(5, "find_first_of ");
+  STRING_FIND_TEST(6, "rfind 16B     ");
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     hash (256MB)    |      8B     |     64B     |    512B     |     4KB     |" << std::endl;
+  std::cout << "|    bitwise_hash     |";
+  HASH_BYTES_TEST(fnv1a_bytes);
+  std::cout << "\n|     hash_bytes      |";
+  HASH_BYTES_TEST(word_bytes);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
   std::cout << "[----------------- End container test : string -----------------]" << std::endl;
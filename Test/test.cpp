@@ -10,15 +10,25 @@
 
 #include "algorithm_performance_test.h"
 #include "algorithm_test.h"
+#include "alloc_test.h"
+#include "memory_resource_test.h"
 #include "vector_test.h"
 #include "list_test.h"
 #include "deque_test.h"
 #include "queue_test.h"
+#include "concurrent_queue_test.h"
 #include "stack_test.h"
 #include "map_test.h"
 #include "set_test.h"
 #include "unordered_map_test.h"
 #include "unordered_set_test.h"
+#include "concurrent_unordered_map_test.h"
+#include "flat_unordered_map_test.h"
+#include "btree_map_test.h"
+#include "flat_map_test.h"
+#include "persistent_test.h"
+#include "snapshot_test.h"
+#include "static_map_test.h"
 #include "string_test.h"
 
 int main()
@@ -29,20 +39,43 @@ int main()
 
   RUN_ALL_TESTS();
   algorithm_performance_test::algorithm_performance_test();
+  alloc_test::alloc_test();
+  memory_resource_test::memory_resource_test();
   vector_test::vector_test();
+  vector_test::small_vector_test();
   list_test::list_test();
+  list_test::intrusive_list_test();
   deque_test::deque_test();
   queue_test::queue_test();
   queue_test::priority_test();
+  queue_test::ring_buffer_test();
+  queue_test::indexed_priority_test();
+  queue_test::pairing_heap_test();
+  concurrent_queue_test::concurrent_queue_test();
   stack_test::stack_test();
   map_test::map_test();
   map_test::multimap_test();
   set_test::set_test();
   set_test::multiset_test();
+  set_test::intrusive_set_test();
+  set_test::order_statistic_test();
   unordered_map_test::unordered_map_test();
   unordered_map_test::unordered_multimap_test();
   unordered_set_test::unordered_set_test();
   unordered_set_test::unordered_multiset_test();
+  concurrent_unordered_map_test::concurrent_unordered_map_test();
+  flat_unordered_map_test::flat_unordered_map_test();
+  flat_unordered_map_test::flat_unordered_set_test();
+  btree_map_test::btree_map_test();
+  btree_map_test::btree_set_test();
+  flat_map_test::flat_map_test();
+  flat_map_test::flat_set_test();
+  persistent_test::persistent_vector_test();
+  persistent_test::persistent_map_test();
+  snapshot_test::snapshot_test();
+#if MYSTL_HAS_CONSTEXPR14
+  static_map_test::static_map_test();
+#endif
   string_test::string_test();
 
 #if defined(_MSC_VER) && defined(_DEBUG)
@@ -3,6 +3,7 @@
 
 // unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们 insert 的性能
 
+#include <chrono>
 #include <unordered_map>
 
 #include "../MyTinySTL/unordered_map.h"
@@ -16,6 +17,85 @@ namespace test
 namespace unordered_map_test
 {
 
+// 统计调用次数的字符串哈希函数
+struct counting_hash
+{
+  static size_t calls;
+  size_t operator()(const mystl::string& s) const
+  {
+    ++calls;
+    return mystl::hash<mystl::string>()(s);
+  }
+};
+size_t counting_hash::calls = 0;
+
+// 比较不同桶策略下 emplace 的性能
+#define UM_POLICY_EMPLACE_DO_TEST(policy, count) do {        \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mystl::unordered_map<int, int, mystl::hash<int>,           \
+    mystl::equal_to<int>, mystl::policy> c;                  \
+  char buf[10];                                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.emplace(rand(), rand());                               \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define UM_POLICY_EMPLACE_TEST(len1, len2, len3)             \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|        prime        |";                    \
+  UM_POLICY_EMPLACE_DO_TEST(ht_prime_policy, len1);          \
+  UM_POLICY_EMPLACE_DO_TEST(ht_prime_policy, len2);          \
+  UM_POLICY_EMPLACE_DO_TEST(ht_prime_policy, len3);          \
+  std::cout << "\n|       power2        |";                  \
+  UM_POLICY_EMPLACE_DO_TEST(ht_power2_policy, len1);         \
+  UM_POLICY_EMPLACE_DO_TEST(ht_power2_policy, len2);         \
+  UM_POLICY_EMPLACE_DO_TEST(ht_power2_policy, len3);         \
+  std::cout << "\n|      fastrange      |";                  \
+  UM_POLICY_EMPLACE_DO_TEST(ht_fastrange_policy, len1);      \
+  UM_POLICY_EMPLACE_DO_TEST(ht_fastrange_policy, len2);      \
+  UM_POLICY_EMPLACE_DO_TEST(ht_fastrange_policy, len3);
+
+// 单次 emplace 的最长耗时，比较一次性 rehash 与渐进式 rehash
+#define UM_INCREMENTAL_DO_TEST(on, len) do {               \
+  srand((int)time(0));                                       \
+  mystl::unordered_map<int, int> c;                          \
+  c.incremental_rehash(on);                                  \
+  char buf[10];                                              \
+  long long worst = 0;                                       \
+  for (size_t i = 0; i < len; ++i)                         \
+  {                                                          \
+    auto start = std::chrono::steady_clock::now();           \
+    c.emplace(rand(), rand());                               \
+    auto end = std::chrono::steady_clock::now();             \
+    auto us = std::chrono::duration_cast<                    \
+      std::chrono::microseconds>(end - start).count();       \
+    worst = worst < us ? us : worst;                         \
+  }                                                          \
+  std::snprintf(buf, sizeof(buf), "%d", static_cast<int>(worst)); \
+  std::string t = buf;                                       \
+  t += "us    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define UM_INCREMENTAL_TEST(len1, len2, len3)                \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|       rehash        |";                    \
+  UM_INCREMENTAL_DO_TEST(false, len1);                       \
+  UM_INCREMENTAL_DO_TEST(false, len2);                       \
+  UM_INCREMENTAL_DO_TEST(false, len3);                       \
+  std::cout << "\n| incremental rehash  |";                  \
+  UM_INCREMENTAL_DO_TEST(true, len1);                        \
+  UM_INCREMENTAL_DO_TEST(true, len2);                        \
+  UM_INCREMENTAL_DO_TEST(true, len3);
+
 void unordered_map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -90,6 +170,88 @@ void unordered_map_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, mystl::ht_power2_policy> um15(v.begin(), v.end());
+  mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, mystl::ht_fastrange_policy> um16(v.begin(), v.end());
+  MAP_FUN_AFTER(um15, um15.insert(PAIR(6, 6)));
+  FUN_VALUE(um15.bucket_count());
+  FUN_VALUE(um15.bucket(6));
+  MAP_FUN_AFTER(um15, um15.rehash(1000));
+  FUN_VALUE(um15.bucket_count());
+  MAP_VALUE(*um15.find(6));
+  MAP_FUN_AFTER(um16, um16.insert(PAIR(6, 6)));
+  FUN_VALUE(um16.bucket_count());
+  FUN_VALUE(um16.bucket(6));
+  MAP_VALUE(*um16.find(6));
+  // 桶分布：键都是桶数的倍数时全部落在同一个桶中
+  auto hs1 = um1.stats();
+  FUN_VALUE(hs1.max_chain);
+  FUN_VALUE(hs1.empty_buckets);
+  FUN_VALUE(hs1.total_bytes());
+  mystl::unordered_map<int, int> um_skew;
+  um_skew.reserve(100);
+  const int stride = static_cast<int>(um_skew.bucket_count());
+  for (int i = 0; i < 50; ++i)
+    um_skew.emplace(i * stride, i);
+  auto hs_skew = um_skew.stats();
+  FUN_VALUE(hs_skew.max_chain);
+  FUN_VALUE(hs_skew.histogram[HT_STATS_HISTOGRAM - 1]);
+  FUN_VALUE(hs_skew.expected_probes);
+  FUN_VALUE(hs_skew.actual_probes);
+  FUN_VALUE(hs_skew.probe_ratio());
+  mystl::unordered_map<mystl::string, int, mystl::string_hash, mystl::equal_to<>> um17;
+  um17.emplace("apple", 1);
+  um17.emplace("banana", 2);
+  FUN_VALUE(um17.find("banana")->second);
+  FUN_VALUE(um17.count("cherry"));
+  std::cout << std::boolalpha;
+  FUN_VALUE(um17.contains("apple"));
+  FUN_VALUE((um17.equal_range("durian").first == um17.end()));
+  // 节点句柄
+  auto nh = um17.extract("apple");
+  nh.key() = "cherry";
+  FUN_VALUE(um17.insert(mystl::move(nh)).inserted);
+  FUN_VALUE(um17.insert(um17.extract("banana")).position->second);
+  mystl::unordered_multimap<mystl::string, int, mystl::string_hash, mystl::equal_to<>> um18;
+  um18.emplace("banana", 4);
+  um18.emplace("fig", 5);
+  um17.merge(um18);
+  FUN_VALUE(um17.size());
+  FUN_VALUE(um18.size());
+  FUN_VALUE(um18.begin()->second);
+  FUN_VALUE(um17.extract("durian").empty());
+  // try_emplace 在键值已存在时不会移动参数
+  mystl::string s1("apple");
+  FUN_VALUE(um17.try_emplace("banana", 5).second);
+  FUN_VALUE(um17.try_emplace(mystl::move(s1), 6).second);
+  FUN_VALUE(um17.try_emplace(mystl::string("banana"), 7).second);
+  FUN_VALUE(um17.insert_or_assign("banana", 8).second);
+  FUN_VALUE(um17.insert_or_assign(um17.end(), "grape", 9)->second);
+  FUN_VALUE(um17["banana"]);
+  FUN_VALUE(um17["kiwi"]);
+  FUN_VALUE(um17.size());
+  // 渐进式 rehash：迁移期间查找、遍历、删除都要看到所有元素
+  mystl::unordered_map<int, int> um19;
+  um19.incremental_rehash(true);
+  for (int i = 0; i < 1000; ++i)
+    um19.emplace(i, i);
+  FUN_VALUE(um19.rehashing());
+  int found = 0;
+  for (int i = 0; i < 1000; ++i)
+    found += um19.count(i) ? 1 : 0;
+  FUN_VALUE(found);
+  FUN_VALUE(mystl::distance(um19.begin(), um19.end()));
+  for (int i = 0; i < 1000; i += 2)
+    um19.erase(i);
+  FUN_VALUE(um19.size());
+  FUN_VALUE(um19.find(1)->second);
+  FUN_VALUE((um19.find(2) == um19.end()));
+  while (um19.rehash_step(16)) {}
+  FUN_VALUE(um19.rehashing());
+  FUN_VALUE(mystl::distance(um19.begin(), um19.end()));
+  auto um20 = um19;
+  FUN_VALUE(um20.size());
+  FUN_VALUE(um20.count(999));
+  std::cout << std::noboolalpha;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -99,6 +261,22 @@ void unordered_map_test()
   MAP_EMPLACE_TEST(unordered_map, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
 #else
   MAP_EMPLACE_TEST(unordered_map, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   policy emplace    |";
+#if LARGER_TEST_DATA_ON
+  UM_POLICY_EMPLACE_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  UM_POLICY_EMPLACE_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| worst emplace time  |";
+#if LARGER_TEST_DATA_ON
+  UM_INCREMENTAL_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  UM_INCREMENTAL_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
@@ -179,6 +357,37 @@ void unordered_multimap_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  // 渐进式 rehash 时相同键值的元素仍然相邻
+  mystl::unordered_multimap<int, int> um15;
+  um15.incremental_rehash(true);
+  for (int i = 0; i < 3000; ++i)
+    um15.emplace(i % 500, i);
+  std::cout << std::boolalpha;
+  FUN_VALUE(um15.rehashing());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(um15.count(7));
+  FUN_VALUE(mystl::distance(um15.equal_range(7).first, um15.equal_range(7).second));
+  FUN_VALUE(um15.erase(7));
+  FUN_VALUE(um15.size());
+  um15.incremental_rehash(false);
+  FUN_VALUE(um15.count(8));
+  // 字符串键的节点保存哈希值：rehash 与遍历不再调用哈希函数，相同键值的元素仍然相邻
+  FUN_VALUE(sizeof(mystl::hashtable_node<mystl::pair<const int, int>>));
+  FUN_VALUE(sizeof(mystl::hashtable_node<mystl::pair<const mystl::string, int>>));
+  mystl::unordered_multimap<mystl::string, int, counting_hash> um16;
+  for (int i = 0; i < 300; ++i)
+    um16.emplace(mystl::string(static_cast<size_t>(i % 50 + 1), 'k'), i);
+  counting_hash::calls = 0;
+  um16.rehash(1000);
+  FUN_VALUE(mystl::distance(um16.begin(), um16.end()));
+  FUN_VALUE(counting_hash::calls);
+  FUN_VALUE(um16.count(mystl::string(7, 'k')));
+  FUN_VALUE(mystl::distance(um16.equal_range(mystl::string(7, 'k')).first,
+                            um16.equal_range(mystl::string(7, 'k')).second));
+  FUN_VALUE(um16.erase(mystl::string(7, 'k')));
+  auto um17 = um16;
+  FUN_VALUE(um17.count(mystl::string(8, 'k')));
+  FUN_VALUE(um17.size());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -167,6 +167,14 @@ void unordered_multiset_test()
   FUN_VALUE(us1.max_load_factor());
   FUN_AFTER(us1, us1.max_load_factor(1.5f));
   FUN_VALUE(us1.max_load_factor());
+  // 节点句柄
+  mystl::unordered_set<int> us16{ 3, 7, 8 };
+  FUN_AFTER(us1, us1.merge(us16));
+  FUN_VALUE(us16.size());
+  FUN_VALUE(us1.count(3));
+  FUN_AFTER(us16, us16.insert(us1.extract(3)));
+  FUN_AFTER(us16, us16.insert(us16.end(), us16.extract(7)));
+  FUN_VALUE(us1.count(3));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -1,11 +1,15 @@
 ﻿#ifndef MYTINYSTL_VECTOR_TEST_H_
 #define MYTINYSTL_VECTOR_TEST_H_
 
-// vector test : 测试 vector 的接口与 push_back 的性能
+// vector test : 测试 vector 的接口与 push_back 的性能，以及元素按字节搬移时扩容的性能
+// small_vector test : 测试 small_vector、static_vector 的接口，以及大量短向量的构造性能
 
+#include <string>
 #include <vector>
 
 #include "../MyTinySTL/vector.h"
+#include "../MyTinySTL/small_vector.h"
+#include "../MyTinySTL/astring.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +19,34 @@ namespace test
 namespace vector_test
 {
 
+// 不预留空间地放入 len 个字符串，扩容时需要搬移已有的全部字符串
+#define VECTOR_RELOCATE_DO_TEST(mode, len) do {              \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  start = clock();                                           \
+  mode::vector<mode::string> v;                              \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.emplace_back(32, static_cast<char>('a' + i % 26));     \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define VECTOR_RELOCATE_TEST(len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  VECTOR_RELOCATE_DO_TEST(std, len1);                        \
+  VECTOR_RELOCATE_DO_TEST(std, len2);                        \
+  VECTOR_RELOCATE_DO_TEST(std, len3);                        \
+  std::cout << "\n|        mystl        |";                  \
+  VECTOR_RELOCATE_DO_TEST(mystl, len1);                      \
+  VECTOR_RELOCATE_DO_TEST(mystl, len2);                      \
+  VECTOR_RELOCATE_DO_TEST(mystl, len3);
+
 void vector_test()
 {
   std::cout << "[===============================================================]\n";
@@ -90,6 +122,51 @@ void vector_test()
   FUN_AFTER(v1, v1.shrink_to_fit());
   FUN_VALUE(v1.size());
   FUN_VALUE(v1.capacity());
+
+  // string 与 vector 可以按字节搬移，扩容、插入与删除时直接复制内存
+  std::cout << std::boolalpha;
+  FUN_VALUE(mystl::is_trivially_relocatable<mystl::string>::value);
+  FUN_VALUE(mystl::is_trivially_relocatable<mystl::vector<int>>::value);
+  std::cout << std::noboolalpha;
+  mystl::vector<mystl::string> v11;
+  for (size_t i = 1; i <= 5; ++i)
+    v11.emplace_back(i, 'a');
+  FUN_AFTER(v11, v11.emplace(v11.begin() + 1, "tiny"));
+  FUN_AFTER(v11, v11.insert(v11.begin(), v11.back()));
+  FUN_AFTER(v11, v11.insert(v11.begin() + 2, 2, mystl::string("stl")));
+  FUN_AFTER(v11, v11.erase(v11.begin() + 1, v11.begin() + 3));
+  FUN_AFTER(v11, v11.erase(v11.begin()));
+  FUN_AFTER(v11, v11.reserve(100));
+  FUN_AFTER(v11, v11.shrink_to_fit());
+  mystl::vector<mystl::vector<int>> v12(3, v7);
+  mystl::vector<mystl::vector<int>> v13(20, v4);
+  v12.insert(v12.begin() + 1, v13.begin(), v13.end());
+  FUN_VALUE(v12.size());
+  FUN_VALUE(v12[1].size());
+  FUN_VALUE(v12[21].size());
+
+  // 增长策略：缺省按大小构造时恰好分配，从空开始增长时最小容量为 16，vector_exact_growth 不留备用空间
+  mystl::vector<int> v17(1, 1);
+  mystl::vector<int> v18;
+  FUN_VALUE(v17.capacity());
+  FUN_VALUE(v18.capacity());
+  FUN_AFTER(v18, v18.push_back(1));
+  FUN_VALUE(v18.capacity());
+  mystl::vector<int, mystl::allocator<int>, mystl::vector_exact_growth> v14(1, 1);
+  mystl::vector<int, mystl::allocator<int>, mystl::vector_factor_growth<2, 1>> v15;
+  mystl::vector<char, mystl::allocator<char>, mystl::vector_page_growth<>> v16(70000);
+  FUN_VALUE(v14.capacity());
+  FUN_AFTER(v14, v14.push_back(2));
+  FUN_VALUE(v14.capacity());
+  FUN_AFTER(v15, v15.push_back(1));
+  FUN_VALUE(v15.capacity());
+  FUN_AFTER(v15, v15.insert(v15.end(), a, a + 4));
+  FUN_VALUE(v15.capacity());
+  FUN_AFTER(v15, v15.push_back(6));
+  FUN_VALUE(v15.capacity());
+  FUN_VALUE(v16.capacity());
+  FUN_VALUE(v4.capacity_bytes());
+  FUN_VALUE(v4.slack_bytes());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]\n";
@@ -99,6 +176,14 @@ void vector_test()
   CON_TEST_P1(vector<int>, push_back, rand(), SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
 #else
   CON_TEST_P1(vector<int>, push_back, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << "\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|  emplace_back str   |";
+#if LARGER_TEST_DATA_ON
+  VECTOR_RELOCATE_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  VECTOR_RELOCATE_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
 #endif
   std::cout << "\n";
   std::cout << "|---------------------|-------------|-------------|-------------|\n";
@@ -107,6 +192,142 @@ void vector_test()
   std::cout << "[----------------- End container test : vector -----------------]\n";
 }
 
+// 构造 len 个只有 4 个元素的短向量，比较 vector 与 small_vector
+#define SMALL_VECTOR_DO_TEST(con, len) do {                  \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+  {                                                          \
+    con v;                                                   \
+    for (size_t j = 0; j < 4; ++j)                           \
+      v.push_back(static_cast<int>(i + j));                  \
+    sum += v.size();                                         \
+  }                                                          \
+  end = clock();                                             \
+  if (sum != len * 4)                                        \
+    std::cout << "error";                                    \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define SMALL_VECTOR_TEST(len1, len2, len3)                  \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|       vector        |";                    \
+  SMALL_VECTOR_DO_TEST(mystl::vector<int>, len1);            \
+  SMALL_VECTOR_DO_TEST(mystl::vector<int>, len2);            \
+  SMALL_VECTOR_DO_TEST(mystl::vector<int>, len3);            \
+  std::cout << "\n|    small_vector     |";                  \
+  SMALL_VECTOR_DO_TEST(small_int_vector, len1);             \
+  SMALL_VECTOR_DO_TEST(small_int_vector, len2);             \
+  SMALL_VECTOR_DO_TEST(small_int_vector, len3);
+
+void small_vector_test()
+{
+  std::cout << "[===============================================================]\n";
+  std::cout << "[-------------- Run container test : small_vector --------------]\n";
+  std::cout << "[-------------------------- API test ---------------------------]\n";
+  int a[] = { 1,2,3,4,5 };
+  mystl::small_vector<int, 4> s1;
+  mystl::small_vector<int, 4> s2(10);
+  mystl::small_vector<int, 4> s3(3, 1);
+  mystl::small_vector<int, 4> s4(a, a + 5);
+  mystl::small_vector<int, 4> s5(s2);
+  mystl::small_vector<int, 4> s6(std::move(s2));
+  mystl::small_vector<int, 4> s7{ 1,2,3,4,5,6,7,8,9 };
+  mystl::small_vector<int, 4> s8, s9, s10;
+  s8 = s3;
+  s9 = std::move(s3);
+  s10 = { 1,2,3,4,5,6,7,8,9 };
+
+  std::cout << std::boolalpha;
+  FUN_AFTER(s1, s1.assign(3, 8));
+  FUN_VALUE(s1.is_inline());
+  FUN_AFTER(s1, s1.emplace(s1.begin(), 0));
+  FUN_VALUE(s1.is_inline());
+  FUN_AFTER(s1, s1.emplace_back(6));
+  FUN_VALUE(s1.is_inline());
+  FUN_VALUE(s1.capacity());
+  FUN_AFTER(s1, s1.push_back(7));
+  FUN_AFTER(s1, s1.insert(s1.begin() + 3, 2, 3));
+  FUN_AFTER(s1, s1.insert(s1.begin(), a, a + 5));
+  FUN_AFTER(s1, s1.pop_back());
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.begin() + 6));
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.capacity());
+  FUN_AFTER(s1, s1.shrink_to_fit());
+  FUN_VALUE(s1.is_inline());
+  FUN_VALUE(s1.capacity());
+  FUN_AFTER(s1, s1.swap(s7));
+  FUN_AFTER(s1, s1.swap(s4));
+  FUN_VALUE(s1.front());
+  FUN_VALUE(s1.back());
+  FUN_VALUE(s1.at(1));
+  FUN_VALUE(s1[2]);
+  FUN_AFTER(s1, s1.resize(2));
+  FUN_AFTER(s1, s1.resize(6, 6));
+  FUN_VALUE(s1.empty());
+  FUN_VALUE((s1 == s10));
+  FUN_VALUE((s4 < s7));
+  std::cout << std::noboolalpha;
+
+  // 元素在内置缓冲区与堆之间转移，元素不能按字节搬移时逐个移动
+  mystl::small_vector<std::string, 2> s11;
+  for (int i = 0; i < 5; ++i)
+    s11.emplace_back(static_cast<size_t>(i + 1), static_cast<char>('a' + i));
+  FUN_AFTER(s11, s11.emplace(s11.begin() + 1, "tiny"));
+  FUN_AFTER(s11, s11.insert(s11.begin(), s11.back()));
+  FUN_AFTER(s11, s11.erase(s11.begin() + 1, s11.end() - 1));
+  FUN_AFTER(s11, s11.shrink_to_fit());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s11.is_inline());
+  std::cout << std::noboolalpha;
+
+  // static_vector 从不分配内存，超过容量时抛出 length_error
+  mystl::static_vector<int, 8> s12{ 1,2,3 };
+  mystl::static_vector<int, 8> s13(s12);
+  FUN_AFTER(s12, s12.insert(s12.begin() + 1, 3, 0));
+  FUN_AFTER(s12, s12.emplace(s12.begin(), 9));
+  FUN_AFTER(s12, s12.push_back(4));
+  std::cout << std::boolalpha;
+  FUN_VALUE(s12.full());
+  std::cout << std::noboolalpha;
+  try
+  {
+    s12.push_back(5);
+  }
+  catch (const std::length_error&)
+  {
+    std::cout << " push_back on a full static_vector throws length_error\n";
+  }
+  FUN_AFTER(s12, s12.erase(s12.begin(), s12.begin() + 4));
+  FUN_AFTER(s12, s12.swap(s13));
+  FUN_VALUE(s12.size());
+  FUN_VALUE(s12.capacity());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|    short vectors    |";
+  typedef mystl::small_vector<int, 8> small_int_vector;
+#if LARGER_TEST_DATA_ON
+  SMALL_VECTOR_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  SMALL_VECTOR_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << "\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : small_vector --------------]\n";
+}
+
 } // namespace vector_test
 } // namespace test
 } // namespace mystl